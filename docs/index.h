@@ -58,16 +58,28 @@
  * \cond pico_aon_timer \defgroup pico_aon_timer pico_aon_timer \endcond
  * \cond pico_async_context \defgroup pico_async_context pico_async_context \endcond
  * \cond pico_bootsel_via_double_reset \defgroup pico_bootsel_via_double_reset pico_bootsel_via_double_reset \endcond
+ * \cond pico_clock_governor \defgroup pico_clock_governor pico_clock_governor \endcond
+ * \cond pico_dma_memcpy \defgroup pico_dma_memcpy pico_dma_memcpy \endcond
+ * \cond pico_dma_sg \defgroup pico_dma_sg pico_dma_sg \endcond
+ * \cond pico_dsp \defgroup pico_dsp pico_dsp \endcond
  * \cond pico_fix \defgroup pico_fix pico_fix \endcond
  * \cond pico_flash \defgroup pico_flash pico_flash \endcond
  * \cond pico_i2c_slave \defgroup pico_i2c_slave pico_i2c_slave \endcond
+ * \cond pico_interp_kernels \defgroup pico_interp_kernels pico_interp_kernels \endcond
+ * \cond pico_lz4 \defgroup pico_lz4 pico_lz4 \endcond
  * \cond pico_multicore \defgroup pico_multicore pico_multicore \endcond
+ * \cond pico_ota \defgroup pico_ota pico_ota \endcond
+ * \cond pico_pc_sampler \defgroup pico_pc_sampler pico_pc_sampler \endcond
+ * \cond pico_pio_stream \defgroup pico_pio_stream pico_pio_stream \endcond
+ * \cond pico_pll_solver \defgroup pico_pll_solver pico_pll_solver \endcond
+ * \cond pico_pool \defgroup pico_pool pico_pool \endcond
  * \cond pico_rand \defgroup pico_rand pico_rand \endcond
  * \cond pico_sha256 \defgroup pico_sha256 pico_sha256 \endcond
  * \cond pico_status_led \defgroup pico_status_led pico_status_led \endcond
  * \cond pico_stdlib \defgroup pico_stdlib pico_stdlib \endcond
  * \cond pico_sync \defgroup pico_sync pico_sync \endcond
  * \cond pico_time \defgroup pico_time pico_time \endcond
+ * \cond pico_tlsf \defgroup pico_tlsf pico_tlsf \endcond
  * \cond pico_unique_id \defgroup pico_unique_id pico_unique_id \endcond
  * \cond pico_util \defgroup pico_util pico_util \endcond
  * @}
@@ -100,6 +112,8 @@
  * \cond pico_atomic \defgroup pico_atomic pico_atomic \endcond
  * \cond pico_base_headers \defgroup pico_base pico_base \endcond
  * \cond pico_binary_info \defgroup pico_binary_info pico_binary_info \endcond
+ * \cond pico_binary_info_compact \defgroup pico_binary_info_compact pico_binary_info_compact \endcond
+ * \cond pico_boot_profile \defgroup pico_boot_profile pico_boot_profile \endcond
  * \cond pico_bootrom \defgroup pico_bootrom pico_bootrom \endcond
  * \cond pico_bit_ops \defgroup pico_bit_ops pico_bit_ops \endcond
  * \cond pico_cxx_options \defgroup pico_cxx_options pico_cxx_options \endcond
@@ -18,9 +18,14 @@ pico_add_subdirectory(common/pico_usb_reset_interface_headers)
 if (NOT PICO_BARE_METAL)
     pico_add_subdirectory(common/pico_bit_ops_headers)
     pico_add_subdirectory(common/pico_binary_info)
+    pico_add_subdirectory(common/pico_binary_info_compact)
     pico_add_subdirectory(common/pico_divider_headers)
+    pico_add_subdirectory(common/pico_lz4)
+    pico_add_subdirectory(common/pico_pll_solver)
+    pico_add_subdirectory(common/pico_pool)
     pico_add_subdirectory(common/pico_sync)
     pico_add_subdirectory(common/pico_time)
+    pico_add_subdirectory(common/pico_tlsf)
     pico_add_subdirectory(common/pico_util)
     pico_add_subdirectory(common/pico_stdlib_headers)
 endif()
@@ -98,18 +103,27 @@ if (NOT PICO_BARE_METAL)
 
     pico_add_subdirectory(rp2_common/pico_atomic)
     pico_add_subdirectory(rp2_common/pico_bit_ops)
+    pico_add_subdirectory(rp2_common/pico_boot_profile)
+    pico_add_subdirectory(rp2_common/pico_clock_governor)
     pico_add_subdirectory(rp2_common/pico_divider)
+    pico_add_subdirectory(rp2_common/pico_dma_memcpy)
+    pico_add_subdirectory(rp2_common/pico_dma_sg)
+    pico_add_subdirectory(rp2_common/pico_dsp)
     pico_add_subdirectory(rp2_common/pico_double)
     pico_add_subdirectory(rp2_common/pico_int64_ops)
+    pico_add_subdirectory(rp2_common/pico_interp_kernels)
     pico_add_subdirectory(rp2_common/pico_flash)
     pico_add_subdirectory(rp2_common/pico_float)
     pico_add_subdirectory(rp2_common/pico_mem_ops)
     pico_add_subdirectory(rp2_common/pico_malloc)
+    pico_add_subdirectory(rp2_common/pico_pc_sampler)
+    pico_add_subdirectory(rp2_common/pico_pio_stream)
     pico_add_subdirectory(rp2_common/pico_printf)
     pico_add_subdirectory(rp2_common/pico_rand)
 
     if (PICO_COMBINED_DOCS OR NOT PICO_RP2040)
         pico_add_subdirectory(rp2_common/pico_sha256)
+        pico_add_subdirectory(rp2_common/pico_ota)
     endif()
 
     pico_add_subdirectory(rp2_common/pico_stdio_semihosting)
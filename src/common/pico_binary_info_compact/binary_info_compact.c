@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+
+#ifndef NO_PICO_PLATFORM
+#include "pico.h"
+#endif
+#include "pico/binary_info_compact.h"
+
+#define OFFSET_VERSION 4
+#define OFFSET_COUNT 6
+#define OFFSET_KEY_COUNT 8
+#define OFFSET_STRINGS 10
+#define OFFSET_SIZE 12
+
+static uint16_t read_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void write_u16(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return (int32_t)((value >> 1) ^ -(value & 1));
+}
+
+static bool type_is_encodable(uint16_t type) {
+    switch (type) {
+        case BINARY_INFO_TYPE_ID_AND_INT:
+        case BINARY_INFO_TYPE_ID_AND_STRING:
+        case BINARY_INFO_TYPE_BLOCK_DEVICE:
+        case BINARY_INFO_TYPE_PINS_WITH_FUNC:
+        case BINARY_INFO_TYPE_PINS_WITH_NAME:
+        case BINARY_INFO_TYPE_PINS64_WITH_FUNC:
+        case BINARY_INFO_TYPE_PINS64_WITH_NAME:
+        case BINARY_INFO_TYPE_NAMED_GROUP:
+        case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME:
+        case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------------------------
+// Encoding
+
+typedef struct {
+    bi_compact_source_fn source;
+    void *context;
+    uint8_t *out;
+    size_t limit;
+    size_t pos;
+    size_t strings;
+    size_t strings_end;
+    bool overflow;
+} encoder_t;
+
+static void put_varint(encoder_t *enc, uint64_t value) {
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        if (value) byte |= 0x80;
+        if (enc->pos < enc->limit) {
+            enc->out[enc->pos++] = byte;
+        } else {
+            enc->overflow = true;
+        }
+    } while (value);
+}
+
+// Returns one more than the offset of s in the strings up to end (possibly as the tail of a longer string), or 0
+static size_t find_string(const encoder_t *enc, const char *s, size_t len, size_t end) {
+    for (size_t offset = enc->strings; offset + len < end; offset++) {
+        if (!memcmp(enc->out + offset, s, len + 1)) return offset - enc->strings + 1;
+    }
+    return 0;
+}
+
+static void add_string(encoder_t *enc, const char *s) {
+    if (!s) return;
+    size_t len = strlen(s);
+    if (find_string(enc, s, len, enc->pos)) return;
+    if (enc->pos + len + 1 > enc->limit) {
+        enc->overflow = true;
+        return;
+    }
+    memcpy(enc->out + enc->pos, s, len + 1);
+    enc->pos += len + 1;
+}
+
+static void put_string(encoder_t *enc, const char *s) {
+    put_varint(enc, s ? find_string(enc, s, strlen(s), enc->strings_end) : 0);
+}
+
+static int compare_keys(const bi_compact_entry_t *a, const bi_compact_entry_t *b) {
+    if (a->tag != b->tag) return a->tag < b->tag ? -1 : 1;
+    if (a->id != b->id) return a->id < b->id ? -1 : 1;
+    return 0;
+}
+
+static void get_entry(const encoder_t *enc, unsigned int index, bi_compact_entry_t *entry) {
+    memset(entry, 0, sizeof(*entry));
+    enc->source(enc->context, index, entry);
+}
+
+static void put_entry(encoder_t *enc, const bi_compact_entry_t *entry) {
+    put_varint(enc, entry->type);
+    switch (entry->type) {
+        case BINARY_INFO_TYPE_ID_AND_INT:
+            put_varint(enc, zigzag(entry->int_value));
+            break;
+        case BINARY_INFO_TYPE_ID_AND_STRING:
+            put_string(enc, entry->string);
+            break;
+        case BINARY_INFO_TYPE_BLOCK_DEVICE:
+            put_string(enc, entry->label);
+            put_varint(enc, entry->address);
+            put_varint(enc, entry->size);
+            put_varint(enc, entry->flags);
+            break;
+        case BINARY_INFO_TYPE_PINS_WITH_FUNC:
+        case BINARY_INFO_TYPE_PINS64_WITH_FUNC:
+            put_varint(enc, entry->pins);
+            break;
+        case BINARY_INFO_TYPE_PINS_WITH_NAME:
+        case BINARY_INFO_TYPE_PINS64_WITH_NAME:
+            put_varint(enc, entry->pins);
+            put_string(enc, entry->label);
+            break;
+        case BINARY_INFO_TYPE_NAMED_GROUP:
+            put_varint(enc, entry->flags);
+            put_varint(enc, entry->group_tag);
+            put_varint(enc, entry->group_id);
+            put_string(enc, entry->label);
+            break;
+        case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME:
+            put_varint(enc, zigzag(entry->int_value));
+            put_string(enc, entry->label);
+            break;
+        case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME:
+            put_string(enc, entry->string);
+            put_string(enc, entry->label);
+            break;
+    }
+}
+
+int bi_compact_encode(bi_compact_source_fn source, void *context, unsigned int count, uint8_t *out, size_t out_size) {
+    encoder_t enc = {
+            .source = source,
+            .context = context,
+            .out = out,
+            .limit = out_size < BI_COMPACT_MAX_SIZE ? out_size : BI_COMPACT_MAX_SIZE,
+    };
+    if (count > UINT16_MAX || enc.limit < BI_COMPACT_HEADER_SIZE) return PICO_ERROR_BUFFER_TOO_SMALL;
+    // The entry index is first filled with the numbers of the entries to encode, sorted by a (stable) binary
+    // insertion sort
+    uint8_t *index = out + BI_COMPACT_HEADER_SIZE;
+    unsigned int n = 0;
+    bi_compact_entry_t entry, other;
+    for (unsigned int i = 0; i < count; i++) {
+        memset(&entry, 0, sizeof(entry));
+        if (!source(context, i, &entry)) continue;
+        if (!type_is_encodable(entry.type)) return PICO_ERROR_INVALID_ARG;
+        if (BI_COMPACT_HEADER_SIZE + (n + 1) * 2 > enc.limit) return PICO_ERROR_BUFFER_TOO_SMALL;
+        unsigned int lo = 0, hi = n;
+        while (lo < hi) {
+            unsigned int mid = (lo + hi) / 2;
+            get_entry(&enc, read_u16(index + mid * 2), &other);
+            if (compare_keys(&entry, &other) < 0) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        memmove(index + lo * 2 + 2, index + lo * 2, (n - lo) * 2);
+        write_u16(index + lo * 2, i);
+        n++;
+    }
+    unsigned int keys = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        get_entry(&enc, read_u16(index + i * 2), &entry);
+        if (!i || compare_keys(&entry, &other)) keys++;
+        other = entry;
+    }
+    uint8_t *key_index = index + n * 2;
+    enc.strings = enc.pos = BI_COMPACT_HEADER_SIZE + (n + keys) * 2;
+    if (enc.pos > enc.limit) return PICO_ERROR_BUFFER_TOO_SMALL;
+    for (unsigned int i = 0; i < n; i++) {
+        get_entry(&enc, read_u16(index + i * 2), &entry);
+        add_string(&enc, entry.string);
+        add_string(&enc, entry.label);
+    }
+    enc.strings_end = enc.pos;
+    keys = 0;
+    for (unsigned int i = 0; i < n && !enc.overflow; i++) {
+        get_entry(&enc, read_u16(index + i * 2), &entry);
+        if (!i || compare_keys(&entry, &other)) {
+            write_u16(key_index + keys++ * 2, enc.pos);
+            put_varint(&enc, entry.tag);
+            put_varint(&enc, entry.id);
+            put_varint(&enc, i);
+        }
+        write_u16(index + i * 2, enc.pos);
+        put_entry(&enc, &entry);
+        other = entry;
+    }
+    if (enc.overflow) return PICO_ERROR_BUFFER_TOO_SMALL;
+    out[0] = (uint8_t)BI_COMPACT_MAGIC;
+    out[1] = (uint8_t)(BI_COMPACT_MAGIC >> 8);
+    out[2] = (uint8_t)(BI_COMPACT_MAGIC >> 16);
+    out[3] = (uint8_t)(BI_COMPACT_MAGIC >> 24);
+    write_u16(out + OFFSET_VERSION, BI_COMPACT_VERSION);
+    write_u16(out + OFFSET_COUNT, n);
+    write_u16(out + OFFSET_KEY_COUNT, keys);
+    write_u16(out + OFFSET_STRINGS, enc.strings);
+    write_u16(out + OFFSET_SIZE, enc.pos);
+    return (int)enc.pos;
+}
+
+static bool array_source(void *context, unsigned int index, bi_compact_entry_t *entry) {
+    *entry = ((const bi_compact_entry_t *)context)[index];
+    return true;
+}
+
+int bi_compact_encode_entries(const bi_compact_entry_t *entries, unsigned int count, uint8_t *out, size_t out_size) {
+    return bi_compact_encode(array_source, (void *)entries, count, out, out_size);
+}
+
+#if PICO_ON_DEVICE
+extern binary_info_t *__binary_info_start[];
+extern binary_info_t *__binary_info_end[];
+
+static bool self_source(__unused void *context, unsigned int index, bi_compact_entry_t *entry) {
+    const binary_info_t *core = __binary_info_start[index];
+    entry->type = core->type;
+    entry->tag = core->tag;
+    switch (core->type) {
+        case BINARY_INFO_TYPE_ID_AND_INT: {
+            const binary_info_id_and_int_t *bi = (const binary_info_id_and_int_t *)core;
+            entry->id = bi->id;
+            entry->int_value = bi->value;
+            return true;
+        }
+        case BINARY_INFO_TYPE_ID_AND_STRING: {
+            const binary_info_id_and_string_t *bi = (const binary_info_id_and_string_t *)core;
+            entry->id = bi->id;
+            entry->string = bi->value;
+            return true;
+        }
+        case BINARY_INFO_TYPE_BLOCK_DEVICE: {
+            const binary_info_block_device_t *bi = (const binary_info_block_device_t *)core;
+            entry->label = bi->name;
+            entry->address = bi->address;
+            entry->size = bi->size;
+            entry->flags = bi->flags;
+            return true;
+        }
+        case BINARY_INFO_TYPE_PINS_WITH_FUNC:
+            entry->pins = ((const binary_info_pins_with_func_t *)core)->pin_encoding;
+            return true;
+        case BINARY_INFO_TYPE_PINS64_WITH_FUNC:
+            entry->pins = ((const binary_info_pins64_with_func_t *)core)->pin_encoding;
+            return true;
+        case BINARY_INFO_TYPE_PINS_WITH_NAME: {
+            const binary_info_pins_with_name_t *bi = (const binary_info_pins_with_name_t *)core;
+            entry->pins = bi->pin_mask;
+            entry->label = bi->label;
+            return true;
+        }
+        case BINARY_INFO_TYPE_PINS64_WITH_NAME: {
+            const binary_info_pins64_with_name_t *bi = (const binary_info_pins64_with_name_t *)core;
+            entry->pins = bi->pin_mask;
+            entry->label = bi->label;
+            return true;
+        }
+        case BINARY_INFO_TYPE_NAMED_GROUP: {
+            const binary_info_named_group_t *bi = (const binary_info_named_group_t *)core;
+            entry->id = bi->parent_id;
+            entry->flags = bi->flags;
+            entry->group_tag = bi->group_tag;
+            entry->group_id = bi->group_id;
+            entry->label = bi->label;
+            return true;
+        }
+        case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME: {
+            const binary_info_ptr_int32_with_name_t *bi = (const binary_info_ptr_int32_with_name_t *)core;
+            entry->id = (uint32_t)bi->id;
+            entry->int_value = *bi->value;
+            entry->label = bi->label;
+            return true;
+        }
+        case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME: {
+            const binary_info_ptr_string_with_name_t *bi = (const binary_info_ptr_string_with_name_t *)core;
+            entry->id = (uint32_t)bi->id;
+            entry->string = bi->value;
+            entry->label = bi->label;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+int bi_compact_encode_self(uint8_t *out, size_t out_size) {
+    return bi_compact_encode(self_source, NULL, (unsigned int)(__binary_info_end - __binary_info_start), out, out_size);
+}
+#endif
+
+// ----------------------------------------------------------------------------------------------------------------
+// Decoding
+
+typedef struct {
+    const uint8_t *blob;
+    uint32_t pos;
+    uint32_t size;
+} decoder_t;
+
+static void start_decode(decoder_t *dec, const void *blob, uint32_t pos) {
+    dec->blob = (const uint8_t *)blob;
+    dec->size = read_u16(dec->blob + OFFSET_SIZE);
+    dec->pos = pos;
+}
+
+static uint64_t get_varint(decoder_t *dec) {
+    uint64_t value = 0;
+    for (unsigned int shift = 0; dec->pos < dec->size && shift < 64; shift += 7) {
+        uint8_t byte = dec->blob[dec->pos++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return value;
+}
+
+static const char *get_string(decoder_t *dec) {
+    uint32_t ref = (uint32_t)get_varint(dec);
+    uint32_t strings = read_u16(dec->blob + OFFSET_STRINGS);
+    if (!ref || strings + ref - 1 >= dec->size) return NULL;
+    return (const char *)dec->blob + strings + ref - 1;
+}
+
+static unsigned int get_key_count(const void *blob) {
+    return read_u16((const uint8_t *)blob + OFFSET_KEY_COUNT);
+}
+
+// Decodes key number k, returning the index of its first entry
+static unsigned int get_key(const void *blob, unsigned int k, uint16_t *tag, uint32_t *id) {
+    const uint8_t *p = (const uint8_t *)blob;
+    unsigned int key_index = BI_COMPACT_HEADER_SIZE + bi_compact_get_count(blob) * 2;
+    decoder_t dec;
+    start_decode(&dec, blob, read_u16(p + key_index + k * 2));
+    *tag = (uint16_t)get_varint(&dec);
+    *id = (uint32_t)get_varint(&dec);
+    return (unsigned int)get_varint(&dec);
+}
+
+static bool check_offsets(const uint8_t *table, uint32_t count, uint32_t min, uint32_t size) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t offset = read_u16(table + i * 2);
+        if (offset < min || offset >= size) return false;
+        min = offset;
+    }
+    return true;
+}
+
+bool bi_compact_is_valid(const void *blob, size_t size) {
+    const uint8_t *p = (const uint8_t *)blob;
+    if (size < BI_COMPACT_HEADER_SIZE) return false;
+    uint32_t magic = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    if (magic != BI_COMPACT_MAGIC || read_u16(p + OFFSET_VERSION) != BI_COMPACT_VERSION) return false;
+    uint32_t count = read_u16(p + OFFSET_COUNT);
+    uint32_t keys = read_u16(p + OFFSET_KEY_COUNT);
+    uint32_t strings = read_u16(p + OFFSET_STRINGS);
+    uint32_t encoded_size = read_u16(p + OFFSET_SIZE);
+    if (encoded_size > size || strings != BI_COMPACT_HEADER_SIZE + (count + keys) * 2 || strings > encoded_size ||
+        keys > count || !keys != !count) {
+        return false;
+    }
+    if (!check_offsets(p + BI_COMPACT_HEADER_SIZE, count, strings, encoded_size) ||
+        !check_offsets(p + BI_COMPACT_HEADER_SIZE + count * 2, keys, strings, encoded_size)) {
+        return false;
+    }
+    if (count) {
+        // the first key follows the strings, so the byte before it must end the last one
+        uint32_t first = read_u16(p + BI_COMPACT_HEADER_SIZE + count * 2);
+        if (first > strings && p[first - 1]) return false;
+        uint16_t tag;
+        uint32_t id;
+        if (get_key(blob, 0, &tag, &id)) return false;
+    }
+    return true;
+}
+
+unsigned int bi_compact_get_count(const void *blob) {
+    return read_u16((const uint8_t *)blob + OFFSET_COUNT);
+}
+
+// Decodes the type and value of an entry (but not its key)
+static void get_value(const void *blob, unsigned int index, bi_compact_entry_t *entry) {
+    decoder_t dec;
+    start_decode(&dec, blob, read_u16((const uint8_t *)blob + BI_COMPACT_HEADER_SIZE + index * 2));
+    entry->type = (uint16_t)get_varint(&dec);
+    switch (entry->type) {
+        case BINARY_INFO_TYPE_ID_AND_INT:
+            entry->int_value = unzigzag((uint32_t)get_varint(&dec));
+            break;
+        case BINARY_INFO_TYPE_ID_AND_STRING:
+            entry->string = get_string(&dec);
+            break;
+        case BINARY_INFO_TYPE_BLOCK_DEVICE:
+            entry->label = get_string(&dec);
+            entry->address = (uint32_t)get_varint(&dec);
+            entry->size = (uint32_t)get_varint(&dec);
+            entry->flags = (uint16_t)get_varint(&dec);
+            break;
+        case BINARY_INFO_TYPE_PINS_WITH_FUNC:
+        case BINARY_INFO_TYPE_PINS64_WITH_FUNC:
+            entry->pins = get_varint(&dec);
+            break;
+        case BINARY_INFO_TYPE_PINS_WITH_NAME:
+        case BINARY_INFO_TYPE_PINS64_WITH_NAME:
+            entry->pins = get_varint(&dec);
+            entry->label = get_string(&dec);
+            break;
+        case BINARY_INFO_TYPE_NAMED_GROUP:
+            entry->flags = (uint16_t)get_varint(&dec);
+            entry->group_tag = (uint16_t)get_varint(&dec);
+            entry->group_id = (uint32_t)get_varint(&dec);
+            entry->label = get_string(&dec);
+            break;
+        case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME:
+            entry->int_value = unzigzag((uint32_t)get_varint(&dec));
+            entry->label = get_string(&dec);
+            break;
+        case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME:
+            entry->string = get_string(&dec);
+            entry->label = get_string(&dec);
+            break;
+    }
+}
+
+bool bi_compact_get_entry(const void *blob, unsigned int index, bi_compact_entry_t *entry) {
+    if (index >= bi_compact_get_count(blob)) return false;
+    memset(entry, 0, sizeof(*entry));
+    // the entry's key is the last one whose first entry is at or before it
+    unsigned int lo = 0, hi = get_key_count(blob);
+    while (hi - lo > 1) {
+        unsigned int mid = (lo + hi) / 2;
+        if (get_key(blob, mid, &entry->tag, &entry->id) <= index) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    get_key(blob, lo, &entry->tag, &entry->id);
+    get_value(blob, index, entry);
+    return true;
+}
+
+// Finds the key, returning the index of its first entry and setting end to one past its last, or returns -1
+static int find_key(const void *blob, uint16_t tag, uint32_t id, unsigned int *end) {
+    unsigned int keys = get_key_count(blob);
+    unsigned int lo = 0, hi = keys;
+    while (lo < hi) {
+        unsigned int mid = (lo + hi) / 2;
+        uint16_t mid_tag;
+        uint32_t mid_id;
+        unsigned int first = get_key(blob, mid, &mid_tag, &mid_id);
+        if (mid_tag == tag && mid_id == id) {
+            *end = mid + 1 < keys ? get_key(blob, mid + 1, &mid_tag, &mid_id) : bi_compact_get_count(blob);
+            return (int)first;
+        }
+        if (mid_tag < tag || (mid_tag == tag && mid_id < id)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+int bi_compact_find(const void *blob, uint16_t tag, uint32_t id) {
+    unsigned int end;
+    int first = find_key(blob, tag, id, &end);
+    return first < 0 ? PICO_ERROR_NOT_FOUND : first;
+}
+
+// The value of the first entry with the key which is of either type; only that entry's value is decoded
+static bool find_value(const void *blob, uint16_t tag, uint32_t id, uint16_t type1, uint16_t type2, bi_compact_entry_t *entry) {
+    unsigned int end;
+    int first = find_key(blob, tag, id, &end);
+    for (unsigned int i = (unsigned int)first; first >= 0 && i < end; i++) {
+        get_value(blob, i, entry);
+        if (entry->type == type1 || entry->type == type2) return true;
+    }
+    return false;
+}
+
+const char *bi_compact_find_string(const void *blob, uint16_t tag, uint32_t id) {
+    bi_compact_entry_t entry;
+    if (!find_value(blob, tag, id, BINARY_INFO_TYPE_ID_AND_STRING, BINARY_INFO_TYPE_PTR_STRING_WITH_NAME, &entry)) {
+        return NULL;
+    }
+    return entry.string;
+}
+
+bool bi_compact_find_int(const void *blob, uint16_t tag, uint32_t id, int32_t *value) {
+    bi_compact_entry_t entry;
+    if (!find_value(blob, tag, id, BINARY_INFO_TYPE_ID_AND_INT, BINARY_INFO_TYPE_PTR_INT32_WITH_NAME, &entry)) {
+        return false;
+    }
+    *value = entry.int_value;
+    return true;
+}
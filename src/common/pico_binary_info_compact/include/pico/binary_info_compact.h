@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_BINARY_INFO_COMPACT_H
+#define _PICO_BINARY_INFO_COMPACT_H
+
+// NOTE: This file may be included by non SDK code (e.g. host tools), so does not use SDK includes other than those
+// which are themselves standalone
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/error.h"
+#include "pico/binary_info/structure.h"
+
+/** \file pico/binary_info_compact.h
+ *  \defgroup pico_binary_info_compact pico_binary_info_compact
+ *
+ * \brief A compact, searchable encoding of binary info
+ *
+ * Regular binary info is a list of pointers to packed structs, which in turn point at separate strings, and the
+ * only way to find an entry is to walk the whole list. The compact encoding holds the same information in a single
+ * self-contained blob:
+ *
+ * - every string is stored once, however many entries refer to it, and a string which is the tail of another is not
+ *   stored separately
+ * - entries are sorted by (tag, ID), and each distinct tag and ID is stored once, however many entries share it
+ * - tags, IDs and values are stored as variable length integers (varints), so the common small values take a byte
+ *   or two
+ * - there are tables of 16 bit offsets to the entries and to the keys, so an entry can be found with a binary search
+ *   which only decodes the keys it visits
+ *
+ * A blob may be built on the host from a linked binary (`picobin_info --compact`), or at runtime from the binary's
+ * own binary info (\ref bi_compact_encode_self). Blobs may be at any alignment, and are limited to 64K.
+ *
+ * The layout (all multi-byte values little endian) is:
+ *
+ * | Contents                                                                                               |
+ * |--------------------------------------------------------------------------------------------------------|
+ * | \ref BI_COMPACT_MAGIC (32 bits)                                                                        |
+ * | version, entry count, key count, strings offset and size (16 bits each)                                |
+ * | entry count 16 bit offsets to the entries, in (tag, ID) order                                          |
+ * | key count 16 bit offsets to the keys, in (tag, ID) order                                               |
+ * | the NUL terminated strings, starting at the strings offset                                             |
+ * | each key followed by its entries                                                                       |
+ *
+ * A key is the varints tag, ID and the index of its first entry. An entry is the varint type followed by a type
+ * specific list of varints; strings are referred to by one more than their offset from the start of the strings (0
+ * being no string).
+ *
+ * RAW_DATA, SIZED_DATA, BSON and list entries are not encoded.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BI_COMPACT_MAGIC 0x43494221 // "!BIC"
+#define BI_COMPACT_VERSION 1
+#define BI_COMPACT_HEADER_SIZE 14
+#define BI_COMPACT_MAX_SIZE 0xffffu
+
+/*! \brief A decoded (or to be encoded) binary info entry
+ *  \ingroup pico_binary_info_compact
+ *
+ * Which fields are meaningful depends on the type:
+ *
+ * | Type                   | Fields                                         |
+ * |------------------------|------------------------------------------------|
+ * | ID_AND_INT             | id, int_value                                  |
+ * | ID_AND_STRING          | id, string                                     |
+ * | BLOCK_DEVICE           | label, address, size, flags                    |
+ * | PINS(64)_WITH_FUNC     | pins (the pin encoding)                        |
+ * | PINS(64)_WITH_NAME     | pins (the pin mask), label                     |
+ * | NAMED_GROUP            | id (the parent ID), flags, group_tag, group_id, label |
+ * | PTR_INT32_WITH_NAME    | id, int_value, label                           |
+ * | PTR_STRING_WITH_NAME   | id, string, label                              |
+ *
+ * Entries without an ID (pins and block devices) are found with an ID of 0.
+ */
+typedef struct bi_compact_entry {
+    uint16_t type;          ///< BINARY_INFO_TYPE_...
+    uint16_t tag;           ///< the entry's tag, e.g. BINARY_INFO_TAG_RASPBERRY_PI
+    uint32_t id;
+    int32_t int_value;
+    uint16_t flags;
+    uint16_t group_tag;
+    uint32_t group_id;
+    uint32_t address;
+    uint32_t size;
+    uint64_t pins;
+    const char *string;     ///< NUL terminated, or NULL
+    const char *label;      ///< NUL terminated, or NULL
+} bi_compact_entry_t;
+
+/*! \brief Callback supplying the entries to be encoded
+ *  \ingroup pico_binary_info_compact
+ *
+ * \param context the context passed to \ref bi_compact_encode
+ * \param index the index of the entry to supply; each is asked for several times, and must be the same each time
+ * \param entry filled in with the entry
+ * \return false if the entry should not be encoded
+ */
+typedef bool (*bi_compact_source_fn)(void *context, unsigned int index, bi_compact_entry_t *entry);
+
+/*! \brief Encode binary info entries supplied by a callback
+ *  \ingroup pico_binary_info_compact
+ *
+ * Entries with the same tag and ID are kept in the order they are supplied.
+ *
+ * \param source called for each of the count entries
+ * \param context passed to source
+ * \param count the number of entries
+ * \param out buffer for the encoding
+ * \param out_size the size of out
+ * \return the size of the encoding, PICO_ERROR_BUFFER_TOO_SMALL if it does not fit in out (or in \ref BI_COMPACT_MAX_SIZE),
+ *         or PICO_ERROR_INVALID_ARG if an entry is of a type which cannot be encoded
+ */
+int bi_compact_encode(bi_compact_source_fn source, void *context, unsigned int count, uint8_t *out, size_t out_size);
+
+/*! \brief Encode an array of binary info entries
+ *  \ingroup pico_binary_info_compact
+ *
+ * \see bi_compact_encode
+ */
+int bi_compact_encode_entries(const bi_compact_entry_t *entries, unsigned int count, uint8_t *out, size_t out_size);
+
+#if PICO_ON_DEVICE
+/*! \brief Encode the running binary's own binary info
+ *  \ingroup pico_binary_info_compact
+ *
+ * Entries whose type cannot be encoded are skipped. The current value of each PTR_INT32_WITH_NAME and
+ * PTR_STRING_WITH_NAME entry is encoded, so this can be called again to pick up later changes.
+ *
+ * \see bi_compact_encode
+ */
+int bi_compact_encode_self(uint8_t *out, size_t out_size);
+#endif
+
+/*! \brief Check that a blob holds a valid encoding
+ *  \ingroup pico_binary_info_compact
+ *
+ * This checks the header and that every entry and key offset lies within the blob; the other functions assume a
+ * blob that passes it.
+ *
+ * \param blob the encoding
+ * \param size the number of bytes available at blob
+ * \return true if the blob is valid
+ */
+bool bi_compact_is_valid(const void *blob, size_t size);
+
+/*! \brief The number of entries in an encoding
+ *  \ingroup pico_binary_info_compact
+ */
+unsigned int bi_compact_get_count(const void *blob);
+
+/*! \brief Decode an entry
+ *  \ingroup pico_binary_info_compact
+ *
+ * The string and label of the entry point into the blob.
+ *
+ * \param blob the encoding
+ * \param index the entry's position in (tag, ID) order
+ * \param entry filled in with the entry
+ * \return true if index is in range
+ */
+bool bi_compact_get_entry(const void *blob, unsigned int index, bi_compact_entry_t *entry);
+
+/*! \brief Find the first entry with a given tag and ID
+ *  \ingroup pico_binary_info_compact
+ *
+ * Other entries with the same tag and ID (e.g. several BINARY_INFO_ID_RP_PROGRAM_FEATURE strings) follow it; pass
+ * increasing indexes to \ref bi_compact_get_entry until the tag or ID changes.
+ *
+ * \param blob the encoding
+ * \param tag the tag to look for
+ * \param id the ID to look for
+ * \return the index of the entry, or PICO_ERROR_NOT_FOUND
+ */
+int bi_compact_find(const void *blob, uint16_t tag, uint32_t id);
+
+/*! \brief Find the string value of an ID_AND_STRING or PTR_STRING_WITH_NAME entry
+ *  \ingroup pico_binary_info_compact
+ *
+ * \param blob the encoding
+ * \param tag the tag to look for
+ * \param id the ID to look for
+ * \return the string, or NULL if there is no such entry
+ */
+const char *bi_compact_find_string(const void *blob, uint16_t tag, uint32_t id);
+
+/*! \brief Find the integer value of an ID_AND_INT or PTR_INT32_WITH_NAME entry
+ *  \ingroup pico_binary_info_compact
+ *
+ * \param blob the encoding
+ * \param tag the tag to look for
+ * \param id the ID to look for
+ * \param value set to the value if found
+ * \return true if found
+ */
+bool bi_compact_find_int(const void *blob, uint16_t tag, uint32_t id, int32_t *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_LZ4_H
+#define _PICO_LZ4_H
+
+#include "pico.h"
+#include "pico/error.h"
+
+/** \file pico/lz4.h
+ *  \defgroup pico_lz4 pico_lz4
+ *
+ * \brief LZ4 block compression, with a decompressor small and fast enough to unpack RAM sections at boot
+ *
+ * The data is in the standard LZ4 block format (no frame header or checksum), as a list of sequences, each of which
+ * is:
+ *
+ * - a token byte; the high 4 bits are the number of literals, and the low 4 bits the match length minus 4
+ * - if the number of literals is 15, further bytes to add to it, up to and including the first which is not 255
+ * - the literals
+ * - the match offset (16 bits little endian, 1 to 65535) back from the current output position
+ * - if the match length nibble is 15, further bytes to add to it, as for the number of literals
+ *
+ * The last sequence has literals only. The compressor follows the rules of the reference implementation (the last
+ * 5 bytes are always literals, and no match starts in the last 12 bytes), so its output can be decompressed by any
+ * LZ4 block decompressor, and \ref lz4_decompress accepts the output of any LZ4 block compressor.
+ *
+ * The compressor is a single pass greedy one, with a hash table of the positions of recently seen 4 byte sequences.
+ * `tools/compress_ram_sections.py` contains an exact Python port of it, so the same input gives the same output
+ * on the host and on the device.
+ *
+ * \ref lz4_decompress_fast does no checking of its input, so must only be used on data known to be good. It is used
+ * by crt0 to unpack the RAM sections of a binary compressed with `pico_compress_ram_sections()` (see
+ * \ref PICO_CRT0_DECOMPRESS_RAM_SECTIONS), so it calls no other functions, and uses no static data.
+ */
+
+// PICO_CONFIG: PICO_LZ4_HASH_BITS, Log2 of the number of entries in the compressor's hash table; each entry is 4 bytes, type=int, min=8, max=16, default=12, group=pico_lz4
+#ifndef PICO_LZ4_HASH_BITS
+#define PICO_LZ4_HASH_BITS 12
+#endif
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_MAX_OFFSET 65535
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief Working memory for \ref lz4_compress
+ *  \ingroup pico_lz4
+ *
+ * This is (4 << \ref PICO_LZ4_HASH_BITS) bytes, so is usually best not placed on the stack.
+ */
+typedef struct {
+    uint32_t table[1u << PICO_LZ4_HASH_BITS];
+} lz4_compress_state_t;
+
+/*! \brief The largest size of the compressed form of some data
+ *  \ingroup pico_lz4
+ *
+ * \param src_len the size of the data
+ * \return the size of the buffer needed by \ref lz4_compress to be sure of compressing it
+ */
+static inline size_t lz4_compress_bound(size_t src_len) {
+    return src_len + src_len / 255 + 16;
+}
+
+/*! \brief Compress data
+ *  \ingroup pico_lz4
+ *
+ * \param state working memory; its contents need not be initialized
+ * \param src the data
+ * \param src_len the size of the data
+ * \param dst the buffer for the compressed data
+ * \param dst_capacity the size of the buffer; \ref lz4_compress_bound(src_len) is always enough
+ * \return the size of the compressed data, or PICO_ERROR_BUFFER_TOO_SMALL
+ */
+int lz4_compress(lz4_compress_state_t *state, const void *src, size_t src_len, void *dst, size_t dst_capacity);
+
+/*! \brief Decompress data, checking that it is valid
+ *  \ingroup pico_lz4
+ *
+ * No read or write is made outside the given buffers, whatever the data.
+ *
+ * \param src the compressed data
+ * \param src_len the size of the compressed data
+ * \param dst the buffer for the decompressed data
+ * \param dst_capacity the size of the buffer
+ * \return the size of the decompressed data, PICO_ERROR_BUFFER_TOO_SMALL if it does not fit in the buffer, or
+ * PICO_ERROR_INVALID_DATA if the compressed data is invalid or truncated
+ */
+int lz4_decompress(const void *src, size_t src_len, void *dst, size_t dst_capacity);
+
+/*! \brief Decompress data known to be valid, as fast as possible
+ *  \ingroup pico_lz4
+ *
+ * There are no checks on the compressed data, which must decompress to exactly dst_len bytes.
+ *
+ * \param src the compressed data
+ * \param dst the buffer for the decompressed data
+ * \param dst_len the size of the decompressed data
+ */
+void lz4_decompress_fast(const void *src, void *dst, size_t dst_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
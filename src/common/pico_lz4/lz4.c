@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/lz4.h"
+
+// The last 5 bytes are always literals, and no match starts in the last 12 bytes
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MATCH_FIND_LIMIT 12
+// After 2^LZ4_SKIP_TRIGGER positions without a match, the compressor starts skipping ahead faster
+#define LZ4_SKIP_TRIGGER 6
+
+#if PICO_CRT0_DECOMPRESS_RAM_SECTIONS && !PICO_NO_FLASH
+// crt0 calls lz4_decompress_fast before the RAM sections (which for a copy_to_ram binary include the rest of the
+// code) have been filled in, so it must be in flash along with crt0
+#define LZ4_FAST_SECTION __attribute__((section(".reset")))
+#else
+#define LZ4_FAST_SECTION
+#endif
+
+// Hides the pointer from the optimizer for each iteration of a copy loop, so that the loop is not replaced with a call
+// to memcpy() or memmove(); these aren't available to lz4_decompress_fast when it is called by crt0
+#define lz4_opaque(p) __asm__ ("" : "+r" (p))
+
+typedef uint32_t __attribute__((may_alias)) lz4_word_t;
+
+// Copy forwards, a word at a time where possible. Overlapping copies where dst is after src must be byte by byte
+// (to repeat the pattern) until the two are at least a word apart
+static __force_inline uint8_t *copy_forward(uint8_t *dst, const uint8_t *src, size_t len) {
+    uint8_t *end = dst + len;
+    if (len >= 8 && !(((uintptr_t)dst ^ (uintptr_t)src) & 3) && (uintptr_t)dst - (uintptr_t)src >= 4) {
+        while ((uintptr_t)dst & 3) {
+            lz4_opaque(dst);
+            *dst++ = *src++;
+        }
+        lz4_word_t *dst_word = (lz4_word_t *)dst;
+        const lz4_word_t *src_word = (const lz4_word_t *)src;
+        lz4_word_t *dst_word_end = (lz4_word_t *)((uintptr_t)end & ~(uintptr_t)3);
+        while (dst_word < dst_word_end) {
+            lz4_opaque(dst_word);
+            *dst_word++ = *src_word++;
+        }
+        dst = (uint8_t *)dst_word;
+        src = (const uint8_t *)src_word;
+    }
+    while (dst < end) {
+        lz4_opaque(dst);
+        *dst++ = *src++;
+    }
+    return dst;
+}
+
+static __force_inline uint8_t *copy_match(uint8_t *dst, size_t offset, size_t len) {
+    if ((offset != 1 && offset != 2) || len < 12) {
+        return copy_forward(dst, dst - offset, len);
+    }
+    // A run with a period of 1 or 2 bytes (e.g. zeros), which is common in initialized data. Once at least 4 bytes have
+    // been written, the last 4 repeat
+    uint8_t *end = dst + len;
+    uint8_t *aligned = (uint8_t *)(((uintptr_t)dst + 7) & ~(uintptr_t)3);
+    while (dst < aligned) {
+        lz4_opaque(dst);
+        *dst = *(dst - offset);
+        dst++;
+    }
+    lz4_word_t pattern = *(lz4_word_t *)(dst - 4);
+    lz4_word_t *dst_word = (lz4_word_t *)dst;
+    lz4_word_t *dst_word_end = (lz4_word_t *)((uintptr_t)end & ~(uintptr_t)3);
+    while (dst_word < dst_word_end) {
+        lz4_opaque(dst_word);
+        *dst_word++ = pattern;
+    }
+    dst = (uint8_t *)dst_word;
+    while (dst < end) {
+        lz4_opaque(dst);
+        *dst = *(dst - offset);
+        dst++;
+    }
+    return dst;
+}
+
+LZ4_FAST_SECTION void lz4_decompress_fast(const void *src, void *dst, size_t dst_len) {
+    const uint8_t *ip = (const uint8_t *)src;
+    uint8_t *op = (uint8_t *)dst;
+    uint8_t *op_end = op + dst_len;
+    while (op < op_end) {
+        uint token = *ip++;
+        size_t len = token >> 4;
+        if (len == 15) {
+            uint b;
+            do {
+                b = *ip++;
+                len += b;
+            } while (b == 255);
+        }
+        op = copy_forward(op, ip, len);
+        ip += len;
+        if (op >= op_end) break;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        len = (token & 15) + LZ4_MIN_MATCH;
+        if (len == 15 + LZ4_MIN_MATCH) {
+            uint b;
+            do {
+                b = *ip++;
+                len += b;
+            } while (b == 255);
+        }
+        op = copy_match(op, offset, len);
+    }
+}
+
+static bool read_length(const uint8_t **ip, const uint8_t *ip_end, size_t *len) {
+    const uint8_t *p = *ip;
+    uint b;
+    do {
+        if (p == ip_end) return false;
+        b = *p++;
+        *len += b;
+    } while (b == 255);
+    *ip = p;
+    return true;
+}
+
+int lz4_decompress(const void *src, size_t src_len, void *dst, size_t dst_capacity) {
+    const uint8_t *ip = (const uint8_t *)src;
+    const uint8_t *ip_end = ip + src_len;
+    uint8_t *op_start = (uint8_t *)dst;
+    uint8_t *op = op_start;
+    uint8_t *op_end = op + dst_capacity;
+    while (true) {
+        if (ip == ip_end) return PICO_ERROR_INVALID_DATA;
+        uint token = *ip++;
+        size_t len = token >> 4;
+        if (len == 15 && !read_length(&ip, ip_end, &len)) return PICO_ERROR_INVALID_DATA;
+        if (len > (size_t)(ip_end - ip)) return PICO_ERROR_INVALID_DATA;
+        if (len > (size_t)(op_end - op)) return PICO_ERROR_BUFFER_TOO_SMALL;
+        op = copy_forward(op, ip, len);
+        ip += len;
+        // the last sequence has no match
+        if (ip == ip_end) return (int)(op - op_start);
+        if (ip_end - ip < 2) return PICO_ERROR_INVALID_DATA;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (!offset || offset > (size_t)(op - op_start)) return PICO_ERROR_INVALID_DATA;
+        len = (token & 15) + LZ4_MIN_MATCH;
+        if (len == 15 + LZ4_MIN_MATCH && !read_length(&ip, ip_end, &len)) return PICO_ERROR_INVALID_DATA;
+        if (len > (size_t)(op_end - op)) return PICO_ERROR_BUFFER_TOO_SMALL;
+        op = copy_match(op, offset, len);
+    }
+}
+
+static inline uint32_t read_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint hash_u32(uint32_t value) {
+    return (value * 2654435761u) >> (32 - PICO_LZ4_HASH_BITS);
+}
+
+static size_t length_size(size_t len) {
+    return len < 15 ? 0 : (len - 15) / 255 + 1;
+}
+
+static uint8_t *write_length(uint8_t *op, size_t len) {
+    for (len -= 15; len >= 255; len -= 255) {
+        *op++ = 255;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+// Write a sequence, or just literals if match_len is 0. Returns NULL if it doesn't fit
+static uint8_t *write_sequence(uint8_t *op, const uint8_t *op_end, const uint8_t *literals, size_t literal_len,
+                               size_t offset, size_t match_len) {
+    size_t needed = 1 + length_size(literal_len) + literal_len;
+    if (match_len) needed += 2 + length_size(match_len - LZ4_MIN_MATCH);
+    if (needed > (size_t)(op_end - op)) return NULL;
+    uint8_t *token = op++;
+    *token = (uint8_t)((literal_len < 15 ? literal_len : 15) << 4);
+    if (literal_len >= 15) op = write_length(op, literal_len);
+    memcpy(op, literals, literal_len);
+    op += literal_len;
+    if (match_len) {
+        *op++ = (uint8_t)offset;
+        *op++ = (uint8_t)(offset >> 8);
+        match_len -= LZ4_MIN_MATCH;
+        *token |= (uint8_t)(match_len < 15 ? match_len : 15);
+        if (match_len >= 15) op = write_length(op, match_len);
+    }
+    return op;
+}
+
+int lz4_compress(lz4_compress_state_t *state, const void *src, size_t src_len, void *dst, size_t dst_capacity) {
+    const uint8_t *base = (const uint8_t *)src;
+    uint8_t *op = (uint8_t *)dst;
+    const uint8_t *op_end = op + dst_capacity;
+    size_t anchor = 0;
+    if (src_len > LZ4_MATCH_FIND_LIMIT) {
+        // table entries are one more than the position, so that 0 is empty
+        memset(state->table, 0, sizeof(state->table));
+        size_t match_limit = src_len - LZ4_MATCH_FIND_LIMIT;
+        size_t extend_limit = src_len - LZ4_LAST_LITERALS;
+        size_t pos = 0;
+        uint32_t misses = 1u << LZ4_SKIP_TRIGGER;
+        while (pos < match_limit) {
+            uint32_t value = read_u32(base + pos);
+            uint h = hash_u32(value);
+            size_t candidate = state->table[h];
+            state->table[h] = (uint32_t)pos + 1;
+            if (!candidate || pos - (candidate - 1) > LZ4_MAX_OFFSET || read_u32(base + candidate - 1) != value) {
+                pos += misses++ >> LZ4_SKIP_TRIGGER;
+                continue;
+            }
+            size_t match = candidate - 1;
+            while (pos > anchor && match > 0 && base[pos - 1] == base[match - 1]) {
+                pos--;
+                match--;
+            }
+            size_t len = LZ4_MIN_MATCH;
+            while (pos + len < extend_limit && base[pos + len] == base[match + len]) {
+                len++;
+            }
+            op = write_sequence(op, op_end, base + anchor, pos - anchor, pos - match, len);
+            if (!op) return PICO_ERROR_BUFFER_TOO_SMALL;
+            pos += len;
+            anchor = pos;
+            misses = 1u << LZ4_SKIP_TRIGGER;
+            // so that later data can match the end of this match
+            state->table[hash_u32(read_u32(base + pos - 2))] = (uint32_t)(pos - 2) + 1;
+        }
+    }
+    op = write_sequence(op, op_end, base + anchor, src_len - anchor, 0, 0);
+    if (!op) return PICO_ERROR_BUFFER_TOO_SMALL;
+    return (int)(op - (uint8_t *)dst);
+}
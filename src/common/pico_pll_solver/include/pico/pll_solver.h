@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_PLL_SOLVER_H
+#define _PICO_PLL_SOLVER_H
+
+#include "pico.h"
+
+/** \file pico/pll_solver.h
+ *  \defgroup pico_pll_solver pico_pll_solver
+ *
+ * \brief Find PLL parameters for an arbitrary output frequency at runtime
+ *
+ * This is the search done by the vcocalc.py script in hardware_clocks, for use on the device (e.g. to choose a
+ * system clock frequency at runtime) or on the host. Every REFDIV, FBDIV, POSTDIV1 and POSTDIV2 combination whose VCO
+ * frequency is in range is tried, and the one whose output is nearest to the requested frequency is chosen; of those
+ * equally near, the one with the highest VCO frequency (i.e. the least jitter) is preferred, or the lowest (i.e. the
+ * least power) if pll_solver_config::low_vco is set. For the same parameters it gives the same answer as the script.
+ *
+ * Like the script, only outputs which are a whole number of kHz are considered, and the frequency chosen need not be
+ * exactly the one asked for; check pll_solution_t::out_hz. The script does its arithmetic in floating point, so for an
+ * input frequency which isn't a whole number of MHz it may miss some exact solutions which this finds.
+ *
+ * A search takes up to a few milliseconds on the device, so should be done once (e.g. at startup) rather than every
+ * time the clock is changed.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PLL_SOLVER_FBDIV_MIN 16
+#define PLL_SOLVER_FBDIV_MAX 320
+#define PLL_SOLVER_POSTDIV_MAX 7
+#define PLL_SOLVER_REFDIV_MAX 63
+
+/*! \brief Constraints on the PLL parameters searched by \ref pll_solve
+ *  \ingroup pico_pll_solver
+ */
+typedef struct pll_solver_config {
+    uint32_t input_hz;   ///< frequency of the PLL reference input, e.g. XOSC_HZ
+    uint32_t ref_min_hz; ///< minimum frequency after REFDIV; this limits the REFDIV values tried
+    uint32_t vco_min_hz; ///< minimum VCO frequency
+    uint32_t vco_max_hz; ///< maximum VCO frequency
+    uint8_t lock_refdiv; ///< if non zero, the only REFDIV value to try
+    bool low_vco;        ///< prefer a lower VCO frequency, rather than a higher one, when outputs are equally near
+} pll_solver_config_t;
+
+/*! \brief PLL parameters chosen by \ref pll_solve
+ *  \ingroup pico_pll_solver
+ */
+typedef struct {
+    uint32_t out_hz;  ///< the output frequency, which is the nearest possible to the one asked for
+    uint32_t vco_hz;  ///< the VCO frequency
+    uint16_t fbdiv;   ///< the feedback divider
+    uint8_t refdiv;   ///< the reference divider
+    uint8_t postdiv1; ///< the first post divider
+    uint8_t postdiv2; ///< the second post divider
+} pll_solution_t;
+
+/*! \brief Get the default constraints, which are those of the vcocalc.py script
+ *  \ingroup pico_pll_solver
+ *
+ * i.e. a minimum reference frequency of 5MHz, and VCO frequencies from 750MHz to 1600MHz
+ *
+ * \param input_hz the frequency of the PLL reference input
+ * \return the configuration
+ */
+static inline pll_solver_config_t pll_solver_get_default_config(uint32_t input_hz) {
+    pll_solver_config_t config = {
+        .input_hz = input_hz,
+        .ref_min_hz = 5000000,
+        .vco_min_hz = 750000000,
+        .vco_max_hz = 1600000000,
+        .lock_refdiv = 0,
+        .low_vco = false,
+    };
+    return config;
+}
+
+/*! \brief Find the PLL parameters which give the nearest output to a frequency
+ *  \ingroup pico_pll_solver
+ *
+ * \param config the constraints on the parameters
+ * \param freq_hz the frequency wanted
+ * \param solution filled in with the parameters found
+ * \return true if parameters were found; false if no output was within freq_hz of the frequency (i.e. nothing was
+ * between 0 and twice it)
+ */
+bool pll_solve(const pll_solver_config_t *config, uint32_t freq_hz, pll_solution_t *solution);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
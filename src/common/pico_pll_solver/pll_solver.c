@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/pll_solver.h"
+
+bool pll_solve(const pll_solver_config_t *config, uint32_t freq_hz, pll_solution_t *solution) {
+    uint refdiv_min = 1;
+    uint refdiv_max = config->ref_min_hz ? config->input_hz / config->ref_min_hz : PLL_SOLVER_REFDIV_MAX;
+    refdiv_max = MAX(1u, MIN(PLL_SOLVER_REFDIV_MAX, refdiv_max));
+    if (config->lock_refdiv) {
+        refdiv_min = refdiv_max = config->lock_refdiv;
+    }
+    // as in vcocalc.py, only an output nearer than freq_hz (i.e. not 0) will do, bar one at exactly twice freq_hz
+    // (which the tie break lets through)
+    uint32_t best_margin = freq_hz;
+    uint32_t best_vco_hz = 0;
+    bool found = false;
+    for (uint refdiv = refdiv_min; refdiv <= refdiv_max; refdiv++) {
+        for (uint fbdiv = PLL_SOLVER_FBDIV_MIN; fbdiv <= PLL_SOLVER_FBDIV_MAX; fbdiv++) {
+            // the VCO frequency is input_hz * fbdiv / refdiv, so compare without dividing
+            uint64_t vco_scaled = (uint64_t)config->input_hz * fbdiv;
+            if (vco_scaled < (uint64_t)config->vco_min_hz * refdiv ||
+                vco_scaled > (uint64_t)config->vco_max_hz * refdiv) {
+                continue;
+            }
+            // only outputs of a whole number of kHz are considered, so the VCO frequency must be a whole number of kHz
+            if (vco_scaled % (refdiv * 1000u)) continue;
+            uint32_t vco_khz = (uint32_t)(vco_scaled / (refdiv * 1000u));
+            uint32_t vco_hz = vco_khz * 1000u;
+            // pd1 is the inner loop so that higher ratios of pd1:pd2 are preferred
+            for (uint pd2 = 1; pd2 <= PLL_SOLVER_POSTDIV_MAX; pd2++) {
+                for (uint pd1 = 1; pd1 <= PLL_SOLVER_POSTDIV_MAX; pd1++) {
+                    if (vco_khz % (pd1 * pd2)) continue;
+                    uint32_t out_hz = (vco_khz / (pd1 * pd2)) * 1000u;
+                    uint32_t margin = out_hz > freq_hz ? out_hz - freq_hz : freq_hz - out_hz;
+                    bool vco_is_better = config->low_vco ? vco_hz < best_vco_hz : vco_hz > best_vco_hz;
+                    if (margin < best_margin || (margin == best_margin && vco_is_better)) {
+                        solution->out_hz = out_hz;
+                        solution->vco_hz = vco_hz;
+                        solution->fbdiv = (uint16_t)fbdiv;
+                        solution->refdiv = (uint8_t)refdiv;
+                        solution->postdiv1 = (uint8_t)pd1;
+                        solution->postdiv2 = (uint8_t)pd2;
+                        best_margin = margin;
+                        best_vco_hz = vco_hz;
+                        found = true;
+                    }
+                }
+            }
+        }
+    }
+    return found;
+}
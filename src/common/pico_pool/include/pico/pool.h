@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_POOL_H
+#define _PICO_POOL_H
+
+#include "pico.h"
+#include "hardware/sync.h"
+
+/** \file pico/pool.h
+ *  \defgroup pico_pool pico_pool
+ *
+ * \brief Multi-core and IRQ safe fixed size block allocator
+ *
+ * A pool hands out blocks of one size from storage given to it (\ref pool_init_with_storage) or allocated from the
+ * heap once when it is created (\ref pool_init). Allocating and freeing a block takes a constant time, never touches
+ * the heap, and doesn't fragment it, so pools are suited to buffers which are allocated and freed often, e.g. for
+ * packets or messages.
+ *
+ * Free blocks are kept on a list protected by a spin lock, which is held (with interrupts disabled) only for a few
+ * instructions, so \ref pool_alloc and \ref pool_free may be called from either core and from IRQ handlers. RP2040
+ * has no exclusive access instructions, so a spin lock is the only safe way to share the list between the cores.
+ *
+ * To take the spin lock less often, each core can also cache up to \ref PICO_POOL_MAGAZINE_SIZE free blocks in its own
+ * "magazine" (see \ref pool_set_magazine_size), which only that core uses, with just interrupts disabled. Blocks move
+ * between a magazine and the shared list half a magazine at a time. Blocks cached in one core's magazine are not
+ * available to the other core, so a pool using magazines should have up to `NUM_CORES` * the magazine size blocks
+ * more than are ever in use at once.
+ *
+ * A block of unused memory is needed per block of the pool only; there is no per block header, but each block is at
+ * least the size of a pointer, and is rounded up to a multiple of the pointer size (which is also its alignment).
+ */
+
+// PICO_CONFIG: PARAM_ASSERTIONS_ENABLED_PICO_POOL, Enable/disable assertions in the pico_pool module, type=bool, default=0, group=pico_pool
+#ifndef PARAM_ASSERTIONS_ENABLED_PICO_POOL
+#define PARAM_ASSERTIONS_ENABLED_PICO_POOL 0
+#endif
+
+// PICO_CONFIG: PICO_POOL_MAGAZINE_SIZE, Maximum number of free blocks each core can cache in its magazine for a pool; 0 removes magazine support, type=int, min=0, max=255, default=8, group=pico_pool
+#ifndef PICO_POOL_MAGAZINE_SIZE
+#define PICO_POOL_MAGAZINE_SIZE 8
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief The size of each block of a pool, for a requested block size
+ *  \ingroup pico_pool
+ */
+#define POOL_BLOCK_STRIDE(block_size) (((block_size) + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *))
+
+/*! \brief The size of the storage needed by \ref pool_init_with_storage
+ *  \ingroup pico_pool
+ */
+#define POOL_STORAGE_SIZE(block_size, block_count) (POOL_BLOCK_STRIDE(block_size) * (block_count))
+
+#if PICO_POOL_MAGAZINE_SIZE
+typedef struct {
+    void *blocks[PICO_POOL_MAGAZINE_SIZE];
+    uint8_t count;
+} pool_magazine_t;
+#endif
+
+typedef struct {
+    spin_lock_t *spin_lock;
+    uint8_t *storage;
+    uint8_t *storage_end;
+    // free blocks which have been freed; blocks from next_unused to storage_end have never been allocated
+    void *free_list;
+    uint8_t *next_unused;
+    uint block_size;
+    uint block_count;
+    // blocks not on the free list (allocated, or cached in a magazine), and its peak
+    uint taken;
+    uint high_water;
+    uint failed;
+    bool owns_storage;
+#if PICO_POOL_MAGAZINE_SIZE
+    uint8_t magazine_size;
+    pool_magazine_t magazines[NUM_CORES];
+#endif
+} pool_t;
+
+/*! \brief Statistics for a pool
+ *  \ingroup pico_pool
+ *  \sa pool_get_stats
+ */
+typedef struct {
+    uint block_size;  ///< size of each block in bytes
+    uint block_count; ///< number of blocks in the pool
+    uint in_use;      ///< number of blocks allocated and not yet freed
+    uint cached;      ///< number of free blocks cached in the cores' magazines
+    /*! most blocks ever in use or cached at once; if this reaches block_count, allocations may have failed */
+    uint high_water;
+    uint failed;      ///< number of calls to \ref pool_alloc which returned NULL
+} pool_stats_t;
+
+/*! \brief Initialise a pool using the given storage and spin lock
+ *  \ingroup pico_pool
+ *
+ * \param pool the pool
+ * \param storage the blocks; \ref POOL_STORAGE_SIZE(block_size, block_count) bytes, aligned to the size of a pointer
+ * \param block_size the size of each block
+ * \param block_count the number of blocks
+ * \param spinlock_num the spin lock used to protect the pool
+ */
+void pool_init_with_storage(pool_t *pool, void *storage, uint block_size, uint block_count, uint spinlock_num);
+
+/*! \brief Initialise a pool, allocating its storage from the heap and a (possibly shared) spin lock
+ *  \ingroup pico_pool
+ *
+ * \param pool the pool
+ * \param block_size the size of each block
+ * \param block_count the number of blocks
+ * \return true if the storage was allocated, false otherwise
+ */
+bool pool_init(pool_t *pool, uint block_size, uint block_count);
+
+/*! \brief Finish with a pool, freeing its storage if it was allocated by \ref pool_init
+ *  \ingroup pico_pool
+ *
+ * Does not deallocate the pool_t structure itself. Any blocks still allocated from the pool must no longer be used.
+ *
+ * \param pool the pool
+ */
+void pool_deinit(pool_t *pool);
+
+/*! \brief Set the number of free blocks each core may cache for a pool
+ *  \ingroup pico_pool
+ *
+ * This must be called before the pool is first used, and not again. The default is 0, so each allocation and free
+ * takes the pool's spin lock.
+ *
+ * \param pool the pool
+ * \param magazine_size the number of blocks, up to \ref PICO_POOL_MAGAZINE_SIZE
+ */
+void pool_set_magazine_size(pool_t *pool, uint magazine_size);
+
+/*! \brief Allocate a block
+ *  \ingroup pico_pool
+ *
+ * \param pool the pool
+ * \return the block, or NULL if the pool has no free blocks
+ */
+void *pool_alloc(pool_t *pool);
+
+/*! \brief Free a block
+ *  \ingroup pico_pool
+ *
+ * The block may be freed on either core, whichever allocated it.
+ *
+ * \param pool the pool
+ * \param block a block allocated from the pool, or NULL
+ */
+void pool_free(pool_t *pool, void *block);
+
+/*! \brief Return the calling core's cached free blocks to the pool's shared list
+ *  \ingroup pico_pool
+ *
+ * This makes them available to the other core, e.g. when this core will not be using the pool for a while.
+ *
+ * \param pool the pool
+ */
+void pool_flush_magazine(pool_t *pool);
+
+/*! \brief Get the statistics for a pool
+ *  \ingroup pico_pool
+ *
+ * \param pool the pool
+ * \param stats filled in with the statistics; these are a snapshot, so may be out of date if the other core or an IRQ
+ * is using the pool
+ */
+void pool_get_stats(pool_t *pool, pool_stats_t *stats);
+
+/*! \brief Check whether a pointer is to a block of a pool
+ *  \ingroup pico_pool
+ *
+ * \param pool the pool
+ * \param ptr the pointer
+ * \return true if ptr points to the start of one of the pool's blocks
+ */
+static inline bool pool_owns(const pool_t *pool, const void *ptr) {
+    const uint8_t *p = (const uint8_t *)ptr;
+    return p >= pool->storage && p < pool->storage_end && !((uint)(p - pool->storage) % pool->block_size);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
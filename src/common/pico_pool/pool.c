@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdlib.h>
+#include "pico/pool.h"
+
+void pool_init_with_storage(pool_t *pool, void *storage, uint block_size, uint block_count, uint spinlock_num) {
+    invalid_params_if(PICO_POOL, ((uintptr_t)storage) & (sizeof(void *) - 1));
+    pool->spin_lock = spin_lock_instance(spinlock_num);
+    pool->block_size = POOL_BLOCK_STRIDE(block_size ? block_size : 1);
+    pool->block_count = block_count;
+    pool->storage = (uint8_t *)storage;
+    pool->storage_end = pool->storage + pool->block_size * block_count;
+    // blocks are handed out from next_unused until they have all been used once, so initialization doesn't have to
+    // touch every block
+    pool->free_list = NULL;
+    pool->next_unused = pool->storage;
+    pool->taken = 0;
+    pool->high_water = 0;
+    pool->failed = 0;
+    pool->owns_storage = false;
+#if PICO_POOL_MAGAZINE_SIZE
+    pool->magazine_size = 0;
+    for (uint i = 0; i < NUM_CORES; i++) {
+        pool->magazines[i].count = 0;
+    }
+#endif
+}
+
+bool pool_init(pool_t *pool, uint block_size, uint block_count) {
+    void *storage = malloc(POOL_STORAGE_SIZE(block_size ? block_size : 1, block_count));
+    if (!storage) return false;
+    pool_init_with_storage(pool, storage, block_size, block_count, next_striped_spin_lock_num());
+    pool->owns_storage = true;
+    return true;
+}
+
+void pool_deinit(pool_t *pool) {
+    if (pool->owns_storage) {
+        free(pool->storage);
+    }
+    pool->storage = pool->storage_end = pool->next_unused = NULL;
+    pool->free_list = NULL;
+    pool->block_count = 0;
+    pool->owns_storage = false;
+}
+
+void pool_set_magazine_size(pool_t *pool, uint magazine_size) {
+#if PICO_POOL_MAGAZINE_SIZE
+    invalid_params_if(PICO_POOL, magazine_size > PICO_POOL_MAGAZINE_SIZE);
+    pool->magazine_size = (uint8_t)MIN(magazine_size, PICO_POOL_MAGAZINE_SIZE);
+#else
+    invalid_params_if(PICO_POOL, magazine_size);
+    (void)pool;
+#endif
+}
+
+// The following must be called with the spin lock held
+
+static inline void *take_block_locked(pool_t *pool) {
+    void *block = pool->free_list;
+    if (block) {
+        pool->free_list = *(void **)block;
+    } else if (pool->next_unused != pool->storage_end) {
+        block = pool->next_unused;
+        pool->next_unused += pool->block_size;
+    } else {
+        return NULL;
+    }
+    if (++pool->taken > pool->high_water) pool->high_water = pool->taken;
+    return block;
+}
+
+static inline void put_block_locked(pool_t *pool, void *block) {
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->taken--;
+}
+
+#if PICO_POOL_MAGAZINE_SIZE
+// Blocks are moved between a magazine and the shared list half a magazine at a time, so that a core alternately
+// allocating and freeing doesn't take the spin lock every time
+static inline uint magazine_batch(const pool_t *pool) {
+    return (pool->magazine_size + 1u) / 2u;
+}
+
+static void *pool_alloc_magazine(pool_t *pool) {
+    uint32_t save = save_and_disable_interrupts();
+    pool_magazine_t *magazine = &pool->magazines[get_core_num()];
+    if (!magazine->count) {
+        spin_lock_unsafe_blocking(pool->spin_lock);
+        for (uint n = magazine_batch(pool); n; n--) {
+            void *block = take_block_locked(pool);
+            if (!block) break;
+            magazine->blocks[magazine->count++] = block;
+        }
+        if (!magazine->count) pool->failed++;
+        spin_unlock_unsafe(pool->spin_lock);
+    }
+    void *block = magazine->count ? magazine->blocks[--magazine->count] : NULL;
+    restore_interrupts_from_disabled(save);
+    return block;
+}
+
+static void pool_free_magazine(pool_t *pool, void *block) {
+    uint32_t save = save_and_disable_interrupts();
+    pool_magazine_t *magazine = &pool->magazines[get_core_num()];
+    if (magazine->count == pool->magazine_size) {
+        spin_lock_unsafe_blocking(pool->spin_lock);
+        for (uint n = magazine_batch(pool); n; n--) {
+            put_block_locked(pool, magazine->blocks[--magazine->count]);
+        }
+        spin_unlock_unsafe(pool->spin_lock);
+    }
+    magazine->blocks[magazine->count++] = block;
+    restore_interrupts_from_disabled(save);
+}
+#endif
+
+void *pool_alloc(pool_t *pool) {
+#if PICO_POOL_MAGAZINE_SIZE
+    if (pool->magazine_size) return pool_alloc_magazine(pool);
+#endif
+    uint32_t save = spin_lock_blocking(pool->spin_lock);
+    void *block = take_block_locked(pool);
+    if (!block) pool->failed++;
+    spin_unlock(pool->spin_lock, save);
+    return block;
+}
+
+void pool_free(pool_t *pool, void *block) {
+    if (!block) return;
+    invalid_params_if(PICO_POOL, !pool_owns(pool, block));
+#if PICO_POOL_MAGAZINE_SIZE
+    if (pool->magazine_size) {
+        pool_free_magazine(pool, block);
+        return;
+    }
+#endif
+    uint32_t save = spin_lock_blocking(pool->spin_lock);
+    put_block_locked(pool, block);
+    spin_unlock(pool->spin_lock, save);
+}
+
+void pool_flush_magazine(pool_t *pool) {
+#if PICO_POOL_MAGAZINE_SIZE
+    uint32_t save = spin_lock_blocking(pool->spin_lock);
+    pool_magazine_t *magazine = &pool->magazines[get_core_num()];
+    while (magazine->count) {
+        put_block_locked(pool, magazine->blocks[--magazine->count]);
+    }
+    spin_unlock(pool->spin_lock, save);
+#else
+    (void)pool;
+#endif
+}
+
+void pool_get_stats(pool_t *pool, pool_stats_t *stats) {
+    uint32_t save = spin_lock_blocking(pool->spin_lock);
+    uint cached = 0;
+#if PICO_POOL_MAGAZINE_SIZE
+    // the other core's magazine may be changing; the count is read once so is at least self consistent
+    for (uint i = 0; i < NUM_CORES; i++) {
+        cached += *(volatile uint8_t *)&pool->magazines[i].count;
+    }
+#endif
+    stats->block_size = pool->block_size;
+    stats->block_count = pool->block_count;
+    stats->in_use = pool->taken > cached ? pool->taken - cached : 0;
+    stats->cached = cached;
+    stats->high_water = pool->high_water;
+    stats->failed = pool->failed;
+    spin_unlock(pool->spin_lock, save);
+}
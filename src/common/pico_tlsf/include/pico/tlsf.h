@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_TLSF_H
+#define _PICO_TLSF_H
+
+#include "pico.h"
+
+/** \file pico/tlsf.h
+ *  \defgroup pico_tlsf pico_tlsf
+ *
+ * \brief A "two level segregated fit" heap, whose allocate and free take a bounded time
+ *
+ * Free blocks are kept on lists by size: a first level of power of two size ranges, each split into
+ * 2^\ref PICO_TLSF_SL_INDEX_COUNT_LOG2 second level ranges, with a bitmap of which lists are non empty. Allocation
+ * rounds the size up to the next list boundary, so that any block on the first non empty list at or above it fits,
+ * and finds that list with two bit scans; freeing merges the block with its physical neighbours if they are free.
+ * Neither ever walks a list, so both take a constant time whatever the state of the heap, unlike the C library
+ * allocators, whose worst case time grows with the number of free blocks.
+ *
+ * A heap may be made of several separate regions of memory (e.g. SRAM banks, or PSRAM on RP2350). Blocks are
+ * 8 byte aligned and have 8 bytes of overhead.
+ *
+ * A tlsf_t is not thread safe; see pico_malloc (with pico_malloc_tlsf) for a multi-core safe heap used by malloc()
+ * etc.
+ */
+
+// PICO_CONFIG: PICO_TLSF_SL_INDEX_COUNT_LOG2, Log2 of the number of second level free lists per power of two size range; more lists waste less memory when rounding sizes up but make tlsf_t bigger, type=int, min=2, max=5, default=4, group=pico_tlsf
+#ifndef PICO_TLSF_SL_INDEX_COUNT_LOG2
+#define PICO_TLSF_SL_INDEX_COUNT_LOG2 4
+#endif
+
+// PICO_CONFIG: PICO_TLSF_FL_INDEX_MAX, Log2 of the limit on the size of a region or block, type=int, min=16, max=30, default=25, group=pico_tlsf
+#ifndef PICO_TLSF_FL_INDEX_MAX
+#define PICO_TLSF_FL_INDEX_MAX 25
+#endif
+
+// PICO_CONFIG: PICO_TLSF_MAX_REGIONS, Maximum number of memory regions in a heap, type=int, min=1, default=4, group=pico_tlsf
+#ifndef PICO_TLSF_MAX_REGIONS
+#define PICO_TLSF_MAX_REGIONS 4
+#endif
+
+#define TLSF_ALIGN_SIZE_LOG2 3
+#define TLSF_ALIGN_SIZE (1u << TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_SL_INDEX_COUNT (1u << PICO_TLSF_SL_INDEX_COUNT_LOG2)
+#define TLSF_FL_INDEX_SHIFT (PICO_TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2)
+#define TLSF_FL_INDEX_COUNT (PICO_TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tlsf_block {
+    // the previous block in memory; only valid if it is free, as this is the last word of its payload
+    struct tlsf_block *prev_phys;
+#if __SIZEOF_POINTER__ == 4
+    // keeps payloads 8 byte aligned
+    uint32_t reserved;
+#endif
+    // payload size; bit 0 is set if this block is free, bit 1 if the previous one is
+    size_t size;
+    // only valid if this block is free, as these are the start of its payload
+    struct tlsf_block *next_free;
+    struct tlsf_block *prev_free;
+} tlsf_block_t;
+
+typedef struct {
+    // the free lists end with (and empty ones are) this
+    tlsf_block_t block_null;
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];
+    tlsf_block_t *blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+    tlsf_block_t *regions[PICO_TLSF_MAX_REGIONS];
+    uint region_count;
+    size_t total_size;
+    size_t free_size;
+    size_t used_size;
+    size_t high_water;
+    uint free_blocks;
+    uint used_blocks;
+    uint failed;
+} tlsf_t;
+
+/*! \brief Statistics for a heap
+ *  \ingroup pico_tlsf
+ *  \sa tlsf_get_stats
+ */
+typedef struct {
+    size_t total_size;         ///< bytes in all the heap's blocks, excluding their overhead
+    size_t free_size;          ///< bytes in free blocks
+    size_t used_size;          ///< bytes in allocated blocks (which may be more than was asked for)
+    size_t largest_free_block; ///< size of the largest free block, i.e. the largest allocation which will succeed
+    size_t high_water;         ///< the most bytes allocated at once
+    uint free_blocks;          ///< number of free blocks
+    uint used_blocks;          ///< number of allocated blocks
+    uint failed;               ///< number of allocations which failed
+    /*! percentage of the free memory not in the largest free block; 0 if all the free memory is in one block, and
+     *  near 100 if it is in many small ones */
+    uint fragmentation;
+} tlsf_stats_t;
+
+/*! \brief Initialise an empty heap
+ *  \ingroup pico_tlsf
+ *
+ * \param tlsf the heap
+ */
+void tlsf_init(tlsf_t *tlsf);
+
+/*! \brief Add a region of memory to a heap
+ *  \ingroup pico_tlsf
+ *
+ * \param tlsf the heap
+ * \param mem the start of the memory
+ * \param size the size of the memory in bytes
+ * \return true if the region was added; false if it is too small to hold a block, too big (2^\ref PICO_TLSF_FL_INDEX_MAX
+ * bytes or more), or the heap already has \ref PICO_TLSF_MAX_REGIONS regions
+ */
+bool tlsf_add_region(tlsf_t *tlsf, void *mem, size_t size);
+
+/*! \brief Allocate memory, in a bounded time
+ *  \ingroup pico_tlsf
+ *
+ * \param tlsf the heap
+ * \param size the number of bytes; a request for 0 bytes returns a minimum size block
+ * \return the memory (8 byte aligned), or NULL if there is no free block big enough
+ */
+void *tlsf_malloc(tlsf_t *tlsf, size_t size);
+
+/*! \brief Allocate memory with a given alignment, in a bounded time
+ *  \ingroup pico_tlsf
+ *
+ * \param tlsf the heap
+ * \param align the alignment; a power of 2
+ * \param size the number of bytes
+ * \return the memory, or NULL if there is no free block big enough
+ */
+void *tlsf_memalign(tlsf_t *tlsf, size_t align, size_t size);
+
+/*! \brief Change the size of an allocation
+ *  \ingroup pico_tlsf
+ *
+ * This takes a bounded time if the block can be resized in place; otherwise the contents are copied to a new block.
+ *
+ * \param tlsf the heap
+ * \param ptr the allocation, or NULL to allocate new memory
+ * \param size the new size, or 0 to free the allocation
+ * \return the resized allocation, or NULL if it can't be resized (in which case ptr is unchanged) or size is 0
+ */
+void *tlsf_realloc(tlsf_t *tlsf, void *ptr, size_t size);
+
+/*! \brief Free memory, in a bounded time
+ *  \ingroup pico_tlsf
+ *
+ * \param tlsf the heap
+ * \param ptr memory from \ref tlsf_malloc, \ref tlsf_memalign or \ref tlsf_realloc, or NULL
+ */
+void tlsf_free(tlsf_t *tlsf, void *ptr);
+
+/*! \brief Return the usable size of an allocation
+ *  \ingroup pico_tlsf
+ *
+ * \param ptr the allocation
+ * \return its size, which is at least the size which was asked for
+ */
+size_t tlsf_block_size(const void *ptr);
+
+/*! \brief Get the statistics for a heap
+ *  \ingroup pico_tlsf
+ *
+ * Unlike the other functions, this takes a time which depends on the number of free blocks of about the size of the
+ * largest one.
+ *
+ * \param tlsf the heap
+ * \param stats filled in with the statistics
+ */
+void tlsf_get_stats(const tlsf_t *tlsf, tlsf_stats_t *stats);
+
+/*! \brief Check the consistency of a heap
+ *  \ingroup pico_tlsf
+ *
+ * Walks every block, so takes a time proportional to the number of blocks; this is for debugging heap corruption.
+ *
+ * \param tlsf the heap
+ * \return true if the heap is consistent
+ */
+bool tlsf_check(const tlsf_t *tlsf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
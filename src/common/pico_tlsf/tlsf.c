@@ -0,0 +1,498 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "pico/tlsf.h"
+
+// Each block is laid out as:
+//
+//   prev_phys   the last word of the previous block's payload; only valid if that block is free
+//   (reserved)  32 bit only, so that payloads are 8 byte aligned
+//   size        the payload size and the free/prev free flags
+//   payload     starting with next_free and prev_free if the block is free
+//
+// so a block's payload is followed directly by the next block's header, less the prev_phys word which overlaps it.
+
+#define BLOCK_FREE_BIT 1u
+#define BLOCK_PREV_FREE_BIT 2u
+#define BLOCK_FLAG_BITS (BLOCK_FREE_BIT | BLOCK_PREV_FREE_BIT)
+
+// offset of the payload from the start of the block
+#define BLOCK_START_OFFSET offsetof(tlsf_block_t, next_free)
+// bytes used by a block which aren't payload
+#define BLOCK_OVERHEAD (BLOCK_START_OFFSET - sizeof(tlsf_block_t *))
+// a free block's payload must hold next_free and prev_free, and the next block's prev_phys
+#define BLOCK_SIZE_MIN align_up(3 * sizeof(tlsf_block_t *), TLSF_ALIGN_SIZE)
+// sizes must map to a first level index below TLSF_FL_INDEX_COUNT, even once rounded up for a search
+#define BLOCK_SIZE_MAX ((size_t)1 << PICO_TLSF_FL_INDEX_MAX)
+#define SMALL_BLOCK_SIZE ((size_t)1 << TLSF_FL_INDEX_SHIFT)
+
+static_assert(TLSF_SL_INDEX_COUNT <= 32, "");
+static_assert(TLSF_FL_INDEX_COUNT <= 32, "");
+// consecutive payloads are a multiple of the alignment apart
+static_assert(!(BLOCK_OVERHEAD % TLSF_ALIGN_SIZE), "");
+
+static inline size_t align_up(size_t x, size_t align) {
+    return (x + align - 1) & ~(align - 1);
+}
+
+static inline size_t align_down(size_t x, size_t align) {
+    return x & ~(align - 1);
+}
+
+static inline uint fls_sizet(size_t x) {
+#if __SIZEOF_SIZE_T__ == 8
+    return 63u - (uint)__builtin_clzll(x);
+#else
+    return 31u - (uint)__builtin_clz(x);
+#endif
+}
+
+static inline uint ffs_u32(uint32_t x) {
+    return (uint)__builtin_ctz(x);
+}
+
+static inline size_t block_size(const tlsf_block_t *block) {
+    return block->size & ~(size_t)BLOCK_FLAG_BITS;
+}
+
+static inline void block_set_size(tlsf_block_t *block, size_t size) {
+    block->size = size | (block->size & BLOCK_FLAG_BITS);
+}
+
+static inline bool block_is_last(const tlsf_block_t *block) {
+    return !block_size(block);
+}
+
+static inline bool block_is_free(const tlsf_block_t *block) {
+    return block->size & BLOCK_FREE_BIT;
+}
+
+static inline void block_set_free(tlsf_block_t *block) {
+    block->size |= BLOCK_FREE_BIT;
+}
+
+static inline void block_set_used(tlsf_block_t *block) {
+    block->size &= ~(size_t)BLOCK_FREE_BIT;
+}
+
+static inline bool block_is_prev_free(const tlsf_block_t *block) {
+    return block->size & BLOCK_PREV_FREE_BIT;
+}
+
+static inline void block_set_prev_free(tlsf_block_t *block) {
+    block->size |= BLOCK_PREV_FREE_BIT;
+}
+
+static inline void block_set_prev_used(tlsf_block_t *block) {
+    block->size &= ~(size_t)BLOCK_PREV_FREE_BIT;
+}
+
+static inline void *block_to_ptr(const tlsf_block_t *block) {
+    return (uint8_t *)block + BLOCK_START_OFFSET;
+}
+
+static inline tlsf_block_t *block_from_ptr(const void *ptr) {
+    return (tlsf_block_t *)((uintptr_t)ptr - BLOCK_START_OFFSET);
+}
+
+static inline tlsf_block_t *offset_to_block(const void *ptr, size_t offset) {
+    return (tlsf_block_t *)((uintptr_t)ptr + offset);
+}
+
+static inline tlsf_block_t *block_next(const tlsf_block_t *block) {
+    return offset_to_block(block_to_ptr(block), block_size(block) - sizeof(tlsf_block_t *));
+}
+
+static inline tlsf_block_t *block_link_next(tlsf_block_t *block) {
+    tlsf_block_t *next = block_next(block);
+    next->prev_phys = block;
+    return next;
+}
+
+static inline void block_mark_as_free(tlsf_block_t *block) {
+    tlsf_block_t *next = block_link_next(block);
+    block_set_prev_free(next);
+    block_set_free(block);
+}
+
+static inline void block_mark_as_used(tlsf_block_t *block) {
+    tlsf_block_t *next = block_next(block);
+    block_set_prev_used(next);
+    block_set_used(block);
+}
+
+static void mapping_insert(size_t size, uint *fl, uint *sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+        *fl = 0;
+        *sl = (uint)(size / (SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT));
+    } else {
+        uint f = fls_sizet(size);
+        *sl = (uint)(size >> (f - PICO_TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+        *fl = f - (TLSF_FL_INDEX_SHIFT - 1);
+    }
+}
+
+// Map a size to the first list all of whose blocks are at least that big
+static void mapping_search(size_t size, uint *fl, uint *sl) {
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += ((size_t)1 << (fls_sizet(size) - PICO_TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static tlsf_block_t *search_suitable_block(tlsf_t *tlsf, uint *fl, uint *sl) {
+    uint32_t sl_map = tlsf->sl_bitmap[*fl] & (~0u << *sl);
+    if (!sl_map) {
+        uint32_t fl_map = *fl + 1 < 32 ? tlsf->fl_bitmap & (~0u << (*fl + 1)) : 0;
+        if (!fl_map) return NULL;
+        *fl = ffs_u32(fl_map);
+        sl_map = tlsf->sl_bitmap[*fl];
+    }
+    *sl = ffs_u32(sl_map);
+    return tlsf->blocks[*fl][*sl];
+}
+
+static void remove_free_block(tlsf_t *tlsf, tlsf_block_t *block, uint fl, uint sl) {
+    tlsf_block_t *prev = block->prev_free;
+    tlsf_block_t *next = block->next_free;
+    next->prev_free = prev;
+    prev->next_free = next;
+    if (tlsf->blocks[fl][sl] == block) {
+        tlsf->blocks[fl][sl] = next;
+        if (next == &tlsf->block_null) {
+            tlsf->sl_bitmap[fl] &= ~(1u << sl);
+            if (!tlsf->sl_bitmap[fl]) {
+                tlsf->fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+    tlsf->free_size -= block_size(block);
+    tlsf->free_blocks--;
+}
+
+static void insert_free_block(tlsf_t *tlsf, tlsf_block_t *block, uint fl, uint sl) {
+    tlsf_block_t *current = tlsf->blocks[fl][sl];
+    block->next_free = current;
+    block->prev_free = &tlsf->block_null;
+    current->prev_free = block;
+    tlsf->blocks[fl][sl] = block;
+    tlsf->fl_bitmap |= 1u << fl;
+    tlsf->sl_bitmap[fl] |= 1u << sl;
+    tlsf->free_size += block_size(block);
+    tlsf->free_blocks++;
+}
+
+static void block_remove(tlsf_t *tlsf, tlsf_block_t *block) {
+    uint fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free_block(tlsf, block, fl, sl);
+}
+
+static void block_insert(tlsf_t *tlsf, tlsf_block_t *block) {
+    uint fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    insert_free_block(tlsf, block, fl, sl);
+}
+
+static inline bool block_can_split(const tlsf_block_t *block, size_t size) {
+    return block_size(block) >= size + BLOCK_OVERHEAD + BLOCK_SIZE_MIN;
+}
+
+// Split off the end of a block, leaving it with size bytes; the remainder is marked free
+static tlsf_block_t *block_split(tlsf_block_t *block, size_t size) {
+    tlsf_block_t *remaining = offset_to_block(block_to_ptr(block), size - sizeof(tlsf_block_t *));
+    size_t remaining_size = block_size(block) - (size + BLOCK_OVERHEAD);
+    remaining->size = remaining_size;
+    block_set_size(block, size);
+    block_mark_as_free(remaining);
+    return remaining;
+}
+
+static tlsf_block_t *block_absorb(tlsf_block_t *prev, tlsf_block_t *block) {
+    prev->size += block_size(block) + BLOCK_OVERHEAD;
+    block_link_next(prev);
+    return prev;
+}
+
+static tlsf_block_t *block_merge_prev(tlsf_t *tlsf, tlsf_block_t *block) {
+    if (block_is_prev_free(block)) {
+        tlsf_block_t *prev = block->prev_phys;
+        block_remove(tlsf, prev);
+        block = block_absorb(prev, block);
+    }
+    return block;
+}
+
+static tlsf_block_t *block_merge_next(tlsf_t *tlsf, tlsf_block_t *block) {
+    tlsf_block_t *next = block_next(block);
+    if (block_is_free(next)) {
+        block_remove(tlsf, next);
+        block = block_absorb(block, next);
+    }
+    return block;
+}
+
+// Return any space beyond size in a free block (not on a list) to the heap
+static void block_trim_free(tlsf_t *tlsf, tlsf_block_t *block, size_t size) {
+    if (block_can_split(block, size)) {
+        tlsf_block_t *remaining = block_split(block, size);
+        block_link_next(block);
+        block_set_prev_free(remaining);
+        block_insert(tlsf, remaining);
+    }
+}
+
+// Return any space beyond size in a used block to the heap
+static void block_trim_used(tlsf_t *tlsf, tlsf_block_t *block, size_t size) {
+    if (block_can_split(block, size)) {
+        tlsf_block_t *remaining = block_split(block, size);
+        block_set_prev_used(remaining);
+        remaining = block_merge_next(tlsf, remaining);
+        block_insert(tlsf, remaining);
+    }
+}
+
+// Return the first gap bytes (payload to payload) of a free block (not on a list) to the heap, returning the rest
+static tlsf_block_t *block_trim_free_leading(tlsf_t *tlsf, tlsf_block_t *block, size_t gap) {
+    tlsf_block_t *remaining = block;
+    if (block_can_split(block, gap - BLOCK_OVERHEAD)) {
+        remaining = block_split(block, gap - BLOCK_OVERHEAD);
+        block_set_prev_free(remaining);
+        block_link_next(block);
+        block_insert(tlsf, block);
+    }
+    return remaining;
+}
+
+static tlsf_block_t *block_locate_free(tlsf_t *tlsf, size_t size) {
+    uint fl, sl;
+    mapping_search(size, &fl, &sl);
+    if (fl >= TLSF_FL_INDEX_COUNT) return NULL;
+    tlsf_block_t *block = search_suitable_block(tlsf, &fl, &sl);
+    if (block) {
+        remove_free_block(tlsf, block, fl, sl);
+    }
+    return block;
+}
+
+static void *block_prepare_used(tlsf_t *tlsf, tlsf_block_t *block, size_t size) {
+    if (!block) {
+        tlsf->failed++;
+        return NULL;
+    }
+    block_trim_free(tlsf, block, size);
+    block_mark_as_used(block);
+    tlsf->used_size += block_size(block);
+    tlsf->used_blocks++;
+    if (tlsf->used_size > tlsf->high_water) tlsf->high_water = tlsf->used_size;
+    return block_to_ptr(block);
+}
+
+// The payload size for a request, or 0 if it is too big
+static size_t adjust_request_size(size_t size, size_t align) {
+    if (size >= BLOCK_SIZE_MAX) return 0;
+    size_t aligned = align_up(size, align);
+    if (aligned >= BLOCK_SIZE_MAX) return 0;
+    return aligned > BLOCK_SIZE_MIN ? aligned : BLOCK_SIZE_MIN;
+}
+
+void tlsf_init(tlsf_t *tlsf) {
+    memset(tlsf, 0, sizeof(*tlsf));
+    tlsf->block_null.next_free = &tlsf->block_null;
+    tlsf->block_null.prev_free = &tlsf->block_null;
+    for (uint i = 0; i < TLSF_FL_INDEX_COUNT; i++) {
+        for (uint j = 0; j < TLSF_SL_INDEX_COUNT; j++) {
+            tlsf->blocks[i][j] = &tlsf->block_null;
+        }
+    }
+}
+
+bool tlsf_add_region(tlsf_t *tlsf, void *mem, size_t size) {
+    if (tlsf->region_count == PICO_TLSF_MAX_REGIONS) return false;
+    uintptr_t start = align_up((uintptr_t)mem, TLSF_ALIGN_SIZE);
+    size_t adjust = (size_t)(start - (uintptr_t)mem);
+    // room for the first block's header (less prev_phys, which is never used) and the last block's
+    if (size < adjust + 2 * BLOCK_OVERHEAD + BLOCK_SIZE_MIN) return false;
+    size_t region_size = align_down(size - adjust - 2 * BLOCK_OVERHEAD, TLSF_ALIGN_SIZE);
+    if (region_size < BLOCK_SIZE_MIN || region_size >= BLOCK_SIZE_MAX) return false;
+
+    // the first block's prev_phys is before the start of the region
+    tlsf_block_t *block = (tlsf_block_t *)(start + BLOCK_OVERHEAD - BLOCK_START_OFFSET);
+    block->size = region_size;
+    block_set_free(block);
+    block_set_prev_used(block);
+    block_insert(tlsf, block);
+
+    // a zero size used block marks the end of the region
+    tlsf_block_t *last = block_link_next(block);
+    last->size = 0;
+    block_set_used(last);
+    block_set_prev_free(last);
+
+    tlsf->regions[tlsf->region_count++] = block;
+    tlsf->total_size += region_size;
+    return true;
+}
+
+void *tlsf_malloc(tlsf_t *tlsf, size_t size) {
+    size_t adjust = adjust_request_size(size, TLSF_ALIGN_SIZE);
+    tlsf_block_t *block = adjust ? block_locate_free(tlsf, adjust) : NULL;
+    return block_prepare_used(tlsf, block, adjust);
+}
+
+void *tlsf_memalign(tlsf_t *tlsf, size_t align, size_t size) {
+    if (align <= TLSF_ALIGN_SIZE) return tlsf_malloc(tlsf, size);
+    size_t adjust = adjust_request_size(size, TLSF_ALIGN_SIZE);
+    // a gap before the aligned payload must be big enough to be a free block itself
+    const size_t gap_minimum = BLOCK_OVERHEAD + BLOCK_SIZE_MIN;
+    size_t aligned_size = adjust ? adjust_request_size(adjust + align + gap_minimum, align) : 0;
+    tlsf_block_t *block = aligned_size ? block_locate_free(tlsf, aligned_size) : NULL;
+    if (block) {
+        uintptr_t ptr = (uintptr_t)block_to_ptr(block);
+        uintptr_t aligned = align_up(ptr, align);
+        size_t gap = (size_t)(aligned - ptr);
+        if (gap && gap < gap_minimum) {
+            aligned = align_up(aligned + MAX(gap_minimum - gap, align), align);
+            gap = (size_t)(aligned - ptr);
+        }
+        if (gap) {
+            block = block_trim_free_leading(tlsf, block, gap);
+        }
+    }
+    return block_prepare_used(tlsf, block, adjust);
+}
+
+void tlsf_free(tlsf_t *tlsf, void *ptr) {
+    if (!ptr) return;
+    tlsf_block_t *block = block_from_ptr(ptr);
+    tlsf->used_size -= block_size(block);
+    tlsf->used_blocks--;
+    block_mark_as_free(block);
+    block = block_merge_prev(tlsf, block);
+    block = block_merge_next(tlsf, block);
+    block_insert(tlsf, block);
+}
+
+void *tlsf_realloc(tlsf_t *tlsf, void *ptr, size_t size) {
+    if (!ptr) return tlsf_malloc(tlsf, size);
+    if (!size) {
+        tlsf_free(tlsf, ptr);
+        return NULL;
+    }
+    tlsf_block_t *block = block_from_ptr(ptr);
+    tlsf_block_t *next = block_next(block);
+    size_t current_size = block_size(block);
+    size_t combined_size = current_size + block_size(next) + BLOCK_OVERHEAD;
+    size_t adjust = adjust_request_size(size, TLSF_ALIGN_SIZE);
+    if (!adjust) {
+        tlsf->failed++;
+        return NULL;
+    }
+    if (adjust > current_size && (!block_is_free(next) || adjust > combined_size)) {
+        // can't grow in place
+        void *new_ptr = tlsf_malloc(tlsf, size);
+        if (new_ptr) {
+            memcpy(new_ptr, ptr, MIN(current_size, size));
+            tlsf_free(tlsf, ptr);
+        }
+        return new_ptr;
+    }
+    tlsf->used_size -= current_size;
+    if (adjust > current_size) {
+        block_merge_next(tlsf, block);
+        block_mark_as_used(block);
+    }
+    block_trim_used(tlsf, block, adjust);
+    tlsf->used_size += block_size(block);
+    if (tlsf->used_size > tlsf->high_water) tlsf->high_water = tlsf->used_size;
+    return ptr;
+}
+
+size_t tlsf_block_size(const void *ptr) {
+    return block_size(block_from_ptr(ptr));
+}
+
+static size_t largest_free_block(const tlsf_t *tlsf) {
+    if (!tlsf->fl_bitmap) return 0;
+    // the largest block is on the highest non empty list, but blocks on a list are only roughly the same size
+    uint fl = fls_sizet(tlsf->fl_bitmap);
+    uint sl = fls_sizet(tlsf->sl_bitmap[fl]);
+    size_t largest = 0;
+    for (const tlsf_block_t *block = tlsf->blocks[fl][sl]; block != &tlsf->block_null; block = block->next_free) {
+        largest = MAX(largest, block_size(block));
+    }
+    return largest;
+}
+
+void tlsf_get_stats(const tlsf_t *tlsf, tlsf_stats_t *stats) {
+    stats->total_size = tlsf->total_size;
+    stats->free_size = tlsf->free_size;
+    stats->used_size = tlsf->used_size;
+    stats->largest_free_block = largest_free_block(tlsf);
+    stats->high_water = tlsf->high_water;
+    stats->free_blocks = tlsf->free_blocks;
+    stats->used_blocks = tlsf->used_blocks;
+    stats->failed = tlsf->failed;
+    stats->fragmentation = tlsf->free_size ?
+            (uint)(100 - (uint64_t)stats->largest_free_block * 100 / tlsf->free_size) : 0;
+}
+
+bool tlsf_check(const tlsf_t *tlsf) {
+    // every block in memory order
+    size_t free_size = 0, used_size = 0, total_size = 0;
+    uint free_blocks = 0, used_blocks = 0;
+    for (uint i = 0; i < tlsf->region_count; i++) {
+        bool prev_free = false;
+        const tlsf_block_t *block = tlsf->regions[i];
+        while (!block_is_last(block)) {
+            size_t size = block_size(block);
+            if (size % TLSF_ALIGN_SIZE || size < BLOCK_SIZE_MIN) return false;
+            if (block_is_prev_free(block) != prev_free) return false;
+            if (prev_free && block_is_free(block)) return false; // should have been merged
+            const tlsf_block_t *next = block_next(block);
+            if (block_is_free(block)) {
+                if (next->prev_phys != block) return false;
+                uint fl, sl;
+                mapping_insert(size, &fl, &sl);
+                const tlsf_block_t *free_block = tlsf->blocks[fl][sl];
+                while (free_block != block && free_block != &tlsf->block_null) free_block = free_block->next_free;
+                if (free_block != block) return false; // not on the right list
+                free_size += size;
+                free_blocks++;
+            } else {
+                used_size += size;
+                used_blocks++;
+            }
+            total_size += size + BLOCK_OVERHEAD;
+            prev_free = block_is_free(block);
+            block = next;
+        }
+        if (block_is_prev_free(block) != prev_free) return false;
+        total_size -= BLOCK_OVERHEAD;
+    }
+    if (free_size != tlsf->free_size || used_size != tlsf->used_size || total_size != tlsf->total_size ||
+        free_blocks != tlsf->free_blocks || used_blocks != tlsf->used_blocks) {
+        return false;
+    }
+    // every free list, against the bitmaps
+    for (uint fl = 0; fl < TLSF_FL_INDEX_COUNT; fl++) {
+        if (!(tlsf->fl_bitmap & (1u << fl)) != !tlsf->sl_bitmap[fl]) return false;
+        for (uint sl = 0; sl < TLSF_SL_INDEX_COUNT; sl++) {
+            const tlsf_block_t *block = tlsf->blocks[fl][sl];
+            if (!(tlsf->sl_bitmap[fl] & (1u << sl)) != (block == &tlsf->block_null)) return false;
+            for (; block != &tlsf->block_null; block = block->next_free) {
+                uint block_fl, block_sl;
+                if (!block_is_free(block)) return false;
+                mapping_insert(block_size(block), &block_fl, &block_sl);
+                if (block_fl != fl || block_sl != sl) return false;
+                if (block->next_free->prev_free != block && block->next_free != &tlsf->block_null) return false;
+            }
+        }
+    }
+    return true;
+}
@@ -14,25 +14,41 @@ include (${CMAKE_DIR}/no_hardware.cmake)
  pico_add_subdirectory(${COMMON_DIR}/pico_usb_reset_interface_headers)
  pico_add_subdirectory(${COMMON_DIR}/pico_bit_ops_headers)
  pico_add_subdirectory(${COMMON_DIR}/pico_binary_info)
+ pico_add_subdirectory(${COMMON_DIR}/pico_binary_info_compact)
  pico_add_subdirectory(${COMMON_DIR}/pico_divider_headers)
+ pico_add_subdirectory(${COMMON_DIR}/pico_lz4)
+ pico_add_subdirectory(${COMMON_DIR}/pico_pll_solver)
+ pico_add_subdirectory(${COMMON_DIR}/pico_pool)
  pico_add_subdirectory(${COMMON_DIR}/pico_sync)
  pico_add_subdirectory(${COMMON_DIR}/pico_time)
+ pico_add_subdirectory(${COMMON_DIR}/pico_tlsf)
  pico_add_subdirectory(${COMMON_DIR}/pico_util)
  pico_add_subdirectory(${COMMON_DIR}/pico_stdlib_headers)
 
 # host-specific
  pico_add_subdirectory(${HOST_DIR}/hardware_divider)
  pico_add_subdirectory(${HOST_DIR}/hardware_gpio)
+ pico_add_subdirectory(${HOST_DIR}/hardware_interp)
  pico_add_subdirectory(${HOST_DIR}/hardware_irq)
  pico_add_subdirectory(${HOST_DIR}/hardware_sync)
  pico_add_subdirectory(${HOST_DIR}/hardware_timer)
  pico_add_subdirectory(${HOST_DIR}/hardware_uart)
+ pico_add_subdirectory(${HOST_DIR}/pico_async_context)
+ pico_add_subdirectory(${HOST_DIR}/pico_atomic)
  pico_add_subdirectory(${HOST_DIR}/pico_bit_ops)
+ pico_add_subdirectory(${HOST_DIR}/pico_btstack_flash_bank_cache)
+ pico_add_subdirectory(${HOST_DIR}/pico_cyw43_spi_queue)
  pico_add_subdirectory(${HOST_DIR}/pico_divider)
+ pico_add_subdirectory(${HOST_DIR}/pico_dma_memcpy)
+ pico_add_subdirectory(${HOST_DIR}/pico_dma_sg)
+ pico_add_subdirectory(${HOST_DIR}/pico_dsp)
+ pico_add_subdirectory(${HOST_DIR}/pico_interp_kernels)
  pico_add_subdirectory(${HOST_DIR}/pico_multicore)
+ pico_add_subdirectory(${HOST_DIR}/pico_ota)
  pico_add_subdirectory(${HOST_DIR}/pico_platform)
  pico_add_subdirectory(${HOST_DIR}/pico_rand)
  pico_add_subdirectory(${HOST_DIR}/pico_runtime)
+ pico_add_subdirectory(${HOST_DIR}/pico_sha256)
  pico_add_subdirectory(${HOST_DIR}/pico_printf)
  pico_add_subdirectory(${HOST_DIR}/pico_status_led)
  pico_add_subdirectory(${HOST_DIR}/pico_stdio)
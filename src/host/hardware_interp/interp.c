@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "hardware/interp.h"
+#include "hardware/claim.h"
+
+interp_hw_t interp_hw_array[2];
+
+static uint64_t access_count;
+
+static uint8_t _claimed;
+
+void interp_model_count_access(void) {
+    access_count++;
+}
+
+uint64_t interp_model_get_access_count(void) {
+    return access_count;
+}
+
+void interp_model_reset_access_count(void) {
+    access_count = 0;
+}
+
+static inline bool ctrl_flag(uint32_t ctrl, uint32_t bits) {
+    return (ctrl & bits) != 0;
+}
+
+static inline uint ctrl_shift(uint32_t ctrl) {
+    return (ctrl & SIO_INTERP0_CTRL_LANE0_SHIFT_BITS) >> SIO_INTERP0_CTRL_LANE0_SHIFT_LSB;
+}
+
+static inline uint ctrl_mask_lsb(uint32_t ctrl) {
+    return (ctrl & SIO_INTERP0_CTRL_LANE0_MASK_LSB_BITS) >> SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB;
+}
+
+static inline uint ctrl_mask_msb(uint32_t ctrl) {
+    return (ctrl & SIO_INTERP0_CTRL_LANE0_MASK_MSB_BITS) >> SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB;
+}
+
+// bits 0 to msb inclusive
+static inline uint32_t bits_to(uint msb) {
+    return msb >= 31 ? 0xffffffffu : (2u << msb) - 1;
+}
+
+static inline uint32_t lane_input(interp_hw_t *interp, uint lane) {
+    return interp->accum[ctrl_flag(interp->ctrl[lane], SIO_INTERP0_CTRL_LANE0_CROSS_INPUT_BITS) ? lane ^ 1 : lane];
+}
+
+// the lane's shift and mask value, sign extended from MASK_MSB if the lane is SIGNED
+static uint32_t lane_shift_mask(interp_hw_t *interp, uint lane) {
+    uint32_t ctrl = interp->ctrl[lane];
+    uint msb = ctrl_mask_msb(ctrl);
+    uint32_t mask = bits_to(msb) & ~((1u << ctrl_mask_lsb(ctrl)) - 1);
+    uint32_t value = (lane_input(interp, lane) >> ctrl_shift(ctrl)) & mask;
+    if (ctrl_flag(ctrl, SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) && (value & (1u << msb))) {
+        value |= ~bits_to(msb);
+    }
+    return value;
+}
+
+static bool lane_overflow(interp_hw_t *interp, uint lane) {
+    uint32_t ctrl = interp->ctrl[lane];
+    return ((lane_input(interp, lane) >> ctrl_shift(ctrl)) & ~bits_to(ctrl_mask_msb(ctrl))) != 0;
+}
+
+static inline bool blend_mode(interp_hw_t *interp) {
+    return interp == interp0 && ctrl_flag(interp->ctrl[0], SIO_INTERP0_CTRL_LANE0_BLEND_BITS);
+}
+
+static inline bool clamp_mode(interp_hw_t *interp) {
+    return interp == interp1 && ctrl_flag(interp->ctrl[0], SIO_INTERP1_CTRL_LANE0_CLAMP_BITS);
+}
+
+static uint32_t lane_result(interp_hw_t *interp, uint lane, uint32_t sm0, uint32_t sm1) {
+    uint32_t ctrl = interp->ctrl[lane];
+    if (blend_mode(interp)) {
+        uint32_t alpha = sm1 & 0xffu;
+        if (!lane) return alpha;
+        int64_t from, to;
+        if (ctrl_flag(interp->ctrl[1], SIO_INTERP0_CTRL_LANE0_SIGNED_BITS)) {
+            from = (int32_t)interp->base[0];
+            to = (int32_t)interp->base[1];
+        } else {
+            from = interp->base[0];
+            to = interp->base[1];
+        }
+        // divided by 256 rounding towards minus infinity, as an arithmetic shift would
+        int64_t step = (int64_t)alpha * (to - from);
+        return (uint32_t)(from + (step >= 0 ? step / 256 : -((255 - step) / 256)));
+    }
+    if (!lane && clamp_mode(interp)) {
+        if (ctrl_flag(ctrl, SIO_INTERP0_CTRL_LANE0_SIGNED_BITS)) {
+            if ((int32_t)sm0 < (int32_t)interp->base[0]) return interp->base[0];
+            if ((int32_t)sm0 > (int32_t)interp->base[1]) return interp->base[1];
+        } else {
+            if (sm0 < interp->base[0]) return interp->base[0];
+            if (sm0 > interp->base[1]) return interp->base[1];
+        }
+        return sm0;
+    }
+    uint32_t value = ctrl_flag(ctrl, SIO_INTERP0_CTRL_LANE0_ADD_RAW_BITS) ? lane_input(interp, lane) : (lane ? sm1 : sm0);
+    return interp->base[lane] + value;
+}
+
+uint32_t interp_model_read_result(interp_hw_t *interp, uint index, bool pop) {
+    valid_params_if(HARDWARE_INTERP, index < 3);
+    interp_model_count_access();
+    uint32_t sm0 = lane_shift_mask(interp, 0);
+    uint32_t sm1 = lane_shift_mask(interp, 1);
+    uint32_t result[2] = {
+        lane_result(interp, 0, sm0, sm1),
+        lane_result(interp, 1, sm0, sm1),
+    };
+    uint32_t value;
+    if (index == 2) {
+        value = interp->base[2] + sm0 + (blend_mode(interp) ? 0 : sm1);
+    } else {
+        // FORCE_MSB only affects the value seen on the bus, not the datapath
+        value = result[index] | ((interp->ctrl[index] & SIO_INTERP0_CTRL_LANE0_FORCE_MSB_BITS) << (28 - SIO_INTERP0_CTRL_LANE0_FORCE_MSB_LSB));
+    }
+    if (pop) {
+        interp->accum[0] = result[ctrl_flag(interp->ctrl[0], SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS) ? 1 : 0];
+        interp->accum[1] = result[ctrl_flag(interp->ctrl[1], SIO_INTERP0_CTRL_LANE0_CROSS_RESULT_BITS) ? 0 : 1];
+    }
+    return value;
+}
+
+uint32_t interp_model_read_raw(interp_hw_t *interp, uint lane) {
+    valid_params_if(HARDWARE_INTERP, lane < 2);
+    interp_model_count_access();
+    return lane_shift_mask(interp, lane);
+}
+
+uint32_t interp_model_read_ctrl(interp_hw_t *interp, uint lane) {
+    valid_params_if(HARDWARE_INTERP, lane < 2);
+    interp_model_count_access();
+    uint32_t ctrl = interp->ctrl[lane];
+    if (!lane) {
+        bool overf0 = lane_overflow(interp, 0);
+        bool overf1 = lane_overflow(interp, 1);
+        if (overf0) ctrl |= SIO_INTERP0_CTRL_LANE0_OVERF0_BITS;
+        if (overf1) ctrl |= SIO_INTERP0_CTRL_LANE0_OVERF1_BITS;
+        if (overf0 || overf1) ctrl |= SIO_INTERP0_CTRL_LANE0_OVERF_BITS;
+    }
+    return ctrl;
+}
+
+void interp_model_write_ctrl(interp_hw_t *interp, uint lane, uint32_t val) {
+    valid_params_if(HARDWARE_INTERP, lane < 2);
+    interp_model_count_access();
+    uint32_t writable;
+    if (lane) {
+        writable = SIO_INTERP0_CTRL_LANE1_BITS;
+    } else {
+        writable = (interp == interp1 ? SIO_INTERP1_CTRL_LANE0_BITS : SIO_INTERP0_CTRL_LANE0_BITS) &
+                   ~(SIO_INTERP0_CTRL_LANE0_OVERF_BITS | SIO_INTERP0_CTRL_LANE0_OVERF1_BITS |
+                     SIO_INTERP0_CTRL_LANE0_OVERF0_BITS);
+    }
+    interp->ctrl[lane] = val & writable;
+}
+
+void interp_model_write_base01(interp_hw_t *interp, uint32_t val) {
+    interp_model_count_access();
+    uint32_t lo = val & 0xffffu;
+    uint32_t hi = val >> 16;
+    interp->base[0] = ctrl_flag(interp->ctrl[0], SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) ? (uint32_t)(int16_t)lo : lo;
+    interp->base[1] = ctrl_flag(interp->ctrl[1], SIO_INTERP0_CTRL_LANE0_SIGNED_BITS) ? (uint32_t)(int16_t)hi : hi;
+}
+
+static inline uint interp_lane_bit(interp_hw_t * interp, uint lane) {
+    return (interp_index(interp) << 1u) | lane;
+}
+
+void interp_claim_lane(interp_hw_t *interp, uint lane) {
+    valid_params_if(HARDWARE_INTERP, lane < 2);
+    hw_claim_or_assert((uint8_t *) &_claimed, interp_lane_bit(interp, lane), "Lane is already claimed");
+}
+
+void interp_claim_lane_mask(interp_hw_t *interp, uint lane_mask) {
+    valid_params_if(HARDWARE_INTERP, lane_mask && lane_mask <= 0x3);
+    if (lane_mask & 1u) interp_claim_lane(interp, 0);
+    if (lane_mask & 2u) interp_claim_lane(interp, 1);
+}
+
+void interp_unclaim_lane(interp_hw_t *interp, uint lane) {
+    valid_params_if(HARDWARE_INTERP, lane < 2);
+    hw_claim_clear((uint8_t *) &_claimed, interp_lane_bit(interp, lane));
+}
+
+bool interp_lane_is_claimed(interp_hw_t *interp, uint lane) {
+    valid_params_if(HARDWARE_INTERP, lane < 2);
+    return hw_is_claimed((uint8_t *) &_claimed, interp_lane_bit(interp, lane));
+}
+
+void interp_unclaim_lane_mask(interp_hw_t *interp, uint lane_mask) {
+    valid_params_if(HARDWARE_INTERP, lane_mask <= 0x3);
+    if (lane_mask & 1u) interp_unclaim_lane(interp, 0);
+    if (lane_mask & 2u) interp_unclaim_lane(interp, 1);
+}
+
+void interp_save(interp_hw_t *interp, interp_hw_save_t *saver) {
+    saver->accum[0] = interp_get_accumulator(interp, 0);
+    saver->accum[1] = interp_get_accumulator(interp, 1);
+    saver->base[0] = interp_get_base(interp, 0);
+    saver->base[1] = interp_get_base(interp, 1);
+    saver->base[2] = interp_get_base(interp, 2);
+    saver->ctrl[0] = interp_model_read_ctrl(interp, 0);
+    saver->ctrl[1] = interp_model_read_ctrl(interp, 1);
+}
+
+void interp_restore(interp_hw_t *interp, interp_hw_save_t *saver) {
+    interp_set_accumulator(interp, 0, saver->accum[0]);
+    interp_set_accumulator(interp, 1, saver->accum[1]);
+    interp_set_base(interp, 0, saver->base[0]);
+    interp_set_base(interp, 1, saver->base[1]);
+    interp_set_base(interp, 2, saver->base[2]);
+    interp_model_write_ctrl(interp, 0, saver->ctrl[0]);
+    interp_model_write_ctrl(interp, 1, saver->ctrl[1]);
+}
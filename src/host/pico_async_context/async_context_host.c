@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "pico/async_context_host.h"
+#include "pico/async_context_base.h"
+
+static const async_context_type_t template;
+
+static void async_context_host_acquire_lock_blocking(async_context_t *self_base);
+static void async_context_host_release_lock(async_context_t *self_base);
+static void async_context_host_lock_check(async_context_t *self_base);
+
+// the context whose thread we are running on, if any
+static __thread async_context_host_t *current_context;
+
+static bool is_context_thread(const async_context_host_t *self) {
+    return current_context == self;
+}
+
+static void signal_fd(int fd) {
+    uint64_t one = 1;
+    // the only failure is counter overflow, in which case the fd is already readable
+    __unused ssize_t rc = write(fd, &one, sizeof(one));
+}
+
+static void drain_fd(int fd) {
+    uint64_t value;
+    __unused ssize_t rc = read(fd, &value, sizeof(value));
+}
+
+static struct timespec timespec_from_us(uint64_t us) {
+    struct timespec ts = {
+            .tv_sec = (time_t)(us / 1000000),
+            .tv_nsec = (long)((us % 1000000) * 1000),
+    };
+    return ts;
+}
+
+static void update_timer(async_context_host_t *self, absolute_time_t next_time) {
+    // timerfd_settime is a system call, so skip it when the deadline has not moved
+    if (to_us_since_boot(next_time) == to_us_since_boot(self->timer_time)) return;
+    struct itimerspec spec = { 0 };
+    if (!is_at_the_end_of_time(next_time)) {
+        // an all zero it_value would disarm the timer
+        uint64_t us = to_us_since_boot(next_time);
+        spec.it_value = timespec_from_us(us ? us : 1);
+    }
+    timerfd_settime(self->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+    self->timer_time = next_time;
+}
+
+static void process_under_lock(async_context_host_t *self) {
+#ifndef NDEBUG
+    async_context_host_lock_check(&self->core);
+#endif
+    absolute_time_t next_time = async_context_base_execute_once(&self->core);
+    if (self->core.work_deferred) {
+        // out of execution budget; go round the thread loop (releasing the lock) before carrying on
+        signal_fd(self->wake_fd);
+    } else {
+        update_timer(self, next_time);
+    }
+}
+
+static void *async_context_thread(void *vself) {
+    async_context_host_t *self = (async_context_host_t *)vself;
+    struct epoll_event events[2];
+    current_context = self;
+    while (!self->thread_should_exit) {
+        int n = epoll_wait(self->epoll_fd, events, count_of(events), -1);
+        if (n < 0 && errno != EINTR) break;
+        for (int i = 0; i < n; i++) {
+            drain_fd(events[i].data.fd);
+            if (events[i].data.fd == self->timer_fd) {
+                // the timer is now disarmed
+                self->timer_time = at_the_end_of_time;
+            }
+        }
+        if (self->thread_should_exit) break;
+        // releasing the (outermost) lock on this thread does the processing
+        async_context_host_acquire_lock_blocking(&self->core);
+        async_context_host_release_lock(&self->core);
+    }
+    return NULL;
+}
+
+static void async_context_host_wake_up(async_context_t *self_base) {
+    async_context_host_t *self = (async_context_host_t *)self_base;
+    // unlike async_context_freertos we signal even from the context thread itself; we may be in a signal
+    // handler which interrupted the thread after it last looked at the workers, and the cost is only a
+    // spurious pass through the loop
+    if (self->thread_started) {
+        signal_fd(self->wake_fd);
+        signal_fd(self->work_needed_fd);
+    }
+}
+
+static bool add_fd_to_epoll(async_context_host_t *self, int fd) {
+    struct epoll_event event = {
+            .events = EPOLLIN,
+            .data.fd = fd,
+    };
+    return !epoll_ctl(self->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+}
+
+bool async_context_host_init(async_context_host_t *self, async_context_host_config_t *config) {
+    memset(self, 0, sizeof(*self));
+    self->core.type = &template;
+    self->core.flags = ASYNC_CONTEXT_FLAG_CALLBACK_FROM_NON_IRQ;
+    self->core.core_num = get_core_num();
+    self->timer_time = at_the_end_of_time;
+    self->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    self->wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    self->work_needed_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    self->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&self->lock_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    pthread_attr_t thread_attr;
+    pthread_attr_init(&thread_attr);
+    if (config->thread_stack_size) {
+        pthread_attr_setstacksize(&thread_attr, config->thread_stack_size);
+    }
+    if (self->epoll_fd < 0 || self->wake_fd < 0 || self->work_needed_fd < 0 || self->timer_fd < 0 ||
+        !add_fd_to_epoll(self, self->wake_fd) ||
+        !add_fd_to_epoll(self, self->timer_fd) ||
+        pthread_create(&self->thread, &thread_attr, async_context_thread, self)) {
+        pthread_attr_destroy(&thread_attr);
+        async_context_deinit(&self->core);
+        return false;
+    }
+    pthread_attr_destroy(&thread_attr);
+    self->thread_started = true;
+    return true;
+}
+
+static uint32_t end_thread_func(void *param) {
+    async_context_host_t *self = (async_context_host_t *)param;
+    // we will immediately exit
+    self->thread_should_exit = true;
+    return 0;
+}
+
+static void async_context_host_deinit(async_context_t *self_base) {
+    async_context_host_t *self = (async_context_host_t *)self_base;
+    if (self->thread_started) {
+        async_context_execute_sync(self_base, end_thread_func, self);
+        pthread_join(self->thread, NULL);
+    }
+    int fds[] = { self->epoll_fd, self->wake_fd, self->work_needed_fd, self->timer_fd };
+    for (uint i = 0; i < count_of(fds); i++) {
+        if (fds[i] >= 0) close(fds[i]);
+    }
+    pthread_mutex_destroy(&self->lock_mutex);
+    memset(self, 0, sizeof(*self));
+}
+
+static void async_context_host_acquire_lock_blocking(async_context_t *self_base) {
+    async_context_host_t *self = (async_context_host_t *)self_base;
+    pthread_mutex_lock(&self->lock_mutex);
+    self->lock_owner = pthread_self();
+    self->nesting++;
+}
+
+static void async_context_host_lock_check(__unused async_context_t *self_base) {
+#ifndef NDEBUG
+    async_context_host_t *self = (async_context_host_t *)self_base;
+    assert(self->nesting && pthread_equal(self->lock_owner, pthread_self()));
+#endif
+}
+
+typedef struct sync_func_call {
+    async_when_pending_worker_t worker;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool done;
+    uint32_t (*func)(void *param);
+    void *param;
+    uint32_t rc;
+} sync_func_call_t;
+
+static void handle_sync_func_call(__unused async_context_t *context, async_when_pending_worker_t *worker) {
+    sync_func_call_t *call = (sync_func_call_t *)worker;
+    call->rc = call->func(call->param);
+    pthread_mutex_lock(&call->mutex);
+    call->done = true;
+    pthread_cond_signal(&call->cond);
+    pthread_mutex_unlock(&call->mutex);
+}
+
+static uint32_t async_context_host_execute_sync(async_context_t *self_base, uint32_t (*func)(void *param), void *param) {
+    async_context_host_t *self = (async_context_host_t *)self_base;
+    hard_assert(!self->nesting || !pthread_equal(self->lock_owner, pthread_self()));
+    if (is_context_thread(self)) {
+        // already on the right thread, so just take the lock
+        async_context_host_acquire_lock_blocking(self_base);
+        uint32_t rc = func(param);
+        async_context_host_release_lock(self_base);
+        return rc;
+    }
+    sync_func_call_t call = { 0 };
+    call.worker.do_work = handle_sync_func_call;
+    call.func = func;
+    call.param = param;
+    pthread_mutex_init(&call.mutex, NULL);
+    pthread_cond_init(&call.cond, NULL);
+    async_context_add_when_pending_worker(self_base, &call.worker);
+    async_context_set_work_pending(self_base, &call.worker);
+    pthread_mutex_lock(&call.mutex);
+    while (!call.done) {
+        pthread_cond_wait(&call.cond, &call.mutex);
+    }
+    pthread_mutex_unlock(&call.mutex);
+    async_context_remove_when_pending_worker(self_base, &call.worker);
+    pthread_cond_destroy(&call.cond);
+    pthread_mutex_destroy(&call.mutex);
+    return call.rc;
+}
+
+static void async_context_host_release_lock(async_context_t *self_base) {
+    async_context_host_t *self = (async_context_host_t *)self_base;
+    bool do_wakeup = false;
+    if (self->nesting == 1) {
+        // as with async_context_freertos, always process on outermost lock exit, since (e.g.) lwIP gives
+        // no notification when its timers are added. this must be done from the context thread
+        if (!is_context_thread(self)) {
+            // defer the wakeup until after we release the lock, so the thread doesn't immediately block on us
+            do_wakeup = true;
+        } else {
+            process_under_lock(self);
+        }
+    }
+    --self->nesting;
+    pthread_mutex_unlock(&self->lock_mutex);
+    if (do_wakeup) {
+        async_context_host_wake_up(self_base);
+    }
+}
+
+static bool async_context_host_add_at_time_worker(async_context_t *self_base, async_at_time_worker_t *worker) {
+    async_context_host_acquire_lock_blocking(self_base);
+    bool rc = async_context_base_add_at_time_worker(self_base, worker);
+    async_context_host_release_lock(self_base);
+    return rc;
+}
+
+static bool async_context_host_remove_at_time_worker(async_context_t *self_base, async_at_time_worker_t *worker) {
+    async_context_host_acquire_lock_blocking(self_base);
+    bool rc = async_context_base_remove_at_time_worker(self_base, worker);
+    async_context_host_release_lock(self_base);
+    return rc;
+}
+
+static bool async_context_host_add_when_pending_worker(async_context_t *self_base, async_when_pending_worker_t *worker) {
+    async_context_host_acquire_lock_blocking(self_base);
+    bool rc = async_context_base_add_when_pending_worker(self_base, worker);
+    async_context_host_release_lock(self_base);
+    return rc;
+}
+
+static bool async_context_host_remove_when_pending_worker(async_context_t *self_base, async_when_pending_worker_t *worker) {
+    async_context_host_acquire_lock_blocking(self_base);
+    bool rc = async_context_base_remove_when_pending_worker(self_base, worker);
+    async_context_host_release_lock(self_base);
+    return rc;
+}
+
+static void async_context_host_set_work_pending(async_context_t *self_base, async_when_pending_worker_t *worker) {
+    worker->work_pending = true;
+    async_context_host_wake_up(self_base);
+}
+
+static void async_context_host_wait_until(__unused async_context_t *self_base, absolute_time_t until) {
+    sleep_until(until);
+}
+
+static void async_context_host_wait_for_work_until(async_context_t *self_base, absolute_time_t until) {
+    async_context_host_t *self = (async_context_host_t *)self_base;
+    struct pollfd pfd = {
+            .fd = self->work_needed_fd,
+            .events = POLLIN,
+    };
+    while (!time_reached(until)) {
+        struct timespec timeout;
+        const struct timespec *timeout_ptr = NULL;
+        if (!is_at_the_end_of_time(until)) {
+            int64_t delay_us = absolute_time_diff_us(get_absolute_time(), until);
+            timeout = timespec_from_us(delay_us > 0 ? (uint64_t)delay_us : 0);
+            timeout_ptr = &timeout;
+        }
+        if (ppoll(&pfd, 1, timeout_ptr, NULL) > 0) {
+            drain_fd(self->work_needed_fd);
+            return;
+        }
+    }
+}
+
+static const async_context_type_t template = {
+        .type = ASYNC_CONTEXT_HOST,
+        .acquire_lock_blocking = async_context_host_acquire_lock_blocking,
+        .release_lock = async_context_host_release_lock,
+        .lock_check = async_context_host_lock_check,
+        .execute_sync = async_context_host_execute_sync,
+        .add_at_time_worker = async_context_host_add_at_time_worker,
+        .remove_at_time_worker = async_context_host_remove_at_time_worker,
+        .add_when_pending_worker = async_context_host_add_when_pending_worker,
+        .remove_when_pending_worker = async_context_host_remove_when_pending_worker,
+        .set_work_pending = async_context_host_set_work_pending,
+        .poll = 0,
+        .wait_until = async_context_host_wait_until,
+        .wait_for_work_until = async_context_host_wait_for_work_until,
+        .deinit = async_context_host_deinit,
+};
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_ASYNC_CONTEXT_HOST_H
+#define _PICO_ASYNC_CONTEXT_HOST_H
+
+/** \file pico/async_context_host.h
+ *  \defgroup async_context_host async_context_host
+ *  \ingroup pico_async_context
+ *
+ * \brief async_context_host provides an implementation of \ref async_context for Linux host builds, which handles
+ * asynchronous work in a separate thread.
+ *
+ * The thread sleeps in epoll_wait() on an eventfd, which is signalled when work is set pending (or the lock is
+ * released by another thread), and a timerfd, which is armed for the earliest "at time" worker. Since the timerfd
+ * uses CLOCK_MONOTONIC, as does \ref get_absolute_time() on the host, worker times are used without conversion.
+ *
+ * As with async_context_freertos, the context is safe to use from any thread, and \ref async_context_set_work_pending
+ * only writes to an eventfd, so it may also be called from a signal handler (the host analogue of an IRQ).
+ * Calling \ref async_context_poll() is not required, and is a no-op.
+ */
+#include <pthread.h>
+#include "pico/async_context.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Configuration object for async_context_host instances.
+ */
+typedef struct async_context_host_config {
+    /**
+     * \brief Stack size for the async_context thread, or 0 for the system default
+     */
+    size_t thread_stack_size;
+} async_context_host_config_t;
+
+typedef struct async_context_host {
+    async_context_t core;
+    pthread_mutex_t lock_mutex;
+    pthread_t thread;
+    pthread_t lock_owner;
+    int epoll_fd;
+    int wake_fd;
+    int timer_fd;
+    int work_needed_fd;
+    absolute_time_t timer_time;
+    uint32_t nesting;
+    bool thread_started;
+    volatile bool thread_should_exit;
+} async_context_host_t;
+
+/*!
+ * \brief Initialize an async_context_host instance using the specified configuration
+ * \ingroup async_context_host
+ *
+ * If this method succeeds (returns true), then the async_context is available for use
+ * and can be de-initialized by calling async_context_deinit().
+ *
+ * \param self a pointer to async_context_host structure to initialize
+ * \param config the configuration object specifying characteristics for the async_context
+ * \return true if initialization is successful, false otherwise
+ */
+bool async_context_host_init(async_context_host_t *self, async_context_host_config_t *config);
+
+/*!
+ * \brief Return a copy of the default configuration object used by \ref async_context_host_init_with_defaults()
+ * \ingroup async_context_host
+ *
+ * The caller can then modify just the settings it cares about, and call \ref async_context_host_init()
+ * \return the default configuration object
+ */
+static inline async_context_host_config_t async_context_host_default_config(void) {
+    async_context_host_config_t config = {
+            .thread_stack_size = 0,
+    };
+    return config;
+}
+
+/*!
+ * \brief Initialize an async_context_host instance with default values
+ * \ingroup async_context_host
+ *
+ * If this method succeeds (returns true), then the async_context is available for use
+ * and can be de-initialized by calling async_context_deinit().
+ *
+ * \param self a pointer to async_context_host structure to initialize
+ * \return true if initialization is successful, false otherwise
+ */
+static inline bool async_context_host_init_with_defaults(async_context_host_t *self) {
+    async_context_host_config_t config = async_context_host_default_config();
+    return async_context_host_init(self, &config);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include "pico/dma_memcpy_backend.h"
+
+// Each channel is emulated by a worker thread, which does the transfers of a block one at a time (at the block's
+// transfer size, as the DMA would), then calls dma_memcpy_block_done() as the DMA interrupt handler would
+
+typedef struct {
+    pthread_t thread;
+    pthread_cond_t start_cond;
+    uint8_t *dst;
+    const uint8_t *src;
+    uint32_t count;
+    uint8_t transfer_size_log2;
+    bool read_increment;
+    bool started;
+} host_channel_t;
+
+static host_channel_t channels[PICO_DMA_MEMCPY_MAX_CHANNELS];
+static uint host_channel_count;
+static bool should_exit;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+
+static void run_block(const host_channel_t *channel) {
+    uint size = 1u << channel->transfer_size_log2;
+    uint8_t *dst = channel->dst;
+    const uint8_t *src = channel->src;
+    for (uint32_t i = 0; i < channel->count; i++) {
+        switch (size) {
+            case 1:
+                *dst = *src;
+                break;
+            case 2:
+                *(uint16_t *)dst = *(const uint16_t *)src;
+                break;
+            default:
+                *(uint32_t *)dst = *(const uint32_t *)src;
+                break;
+        }
+        dst += size;
+        if (channel->read_increment) src += size;
+    }
+}
+
+static void *channel_thread(void *arg) {
+    uint index = (uint)(uintptr_t)arg;
+    host_channel_t *channel = &channels[index];
+    pthread_mutex_lock(&mutex);
+    while (true) {
+        while (!channel->started && !should_exit) {
+            pthread_cond_wait(&channel->start_cond, &mutex);
+        }
+        if (!channel->started) break;
+        host_channel_t block = *channel;
+        pthread_mutex_unlock(&mutex);
+        run_block(&block);
+        pthread_mutex_lock(&mutex);
+        channel->started = false;
+        pthread_mutex_unlock(&mutex);
+        dma_memcpy_block_done(index);
+        pthread_mutex_lock(&mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+    return NULL;
+}
+
+bool dma_memcpy_backend_init(uint channel_count) {
+    should_exit = false;
+    for (uint i = 0; i < channel_count; i++) {
+        channels[i].started = false;
+        pthread_cond_init(&channels[i].start_cond, NULL);
+        if (pthread_create(&channels[i].thread, NULL, channel_thread, (void *)(uintptr_t)i)) {
+            host_channel_count = i;
+            dma_memcpy_backend_deinit();
+            return false;
+        }
+    }
+    host_channel_count = channel_count;
+    return true;
+}
+
+void dma_memcpy_backend_deinit(void) {
+    pthread_mutex_lock(&mutex);
+    should_exit = true;
+    for (uint i = 0; i < host_channel_count; i++) {
+        pthread_cond_signal(&channels[i].start_cond);
+    }
+    pthread_mutex_unlock(&mutex);
+    for (uint i = 0; i < host_channel_count; i++) {
+        pthread_join(channels[i].thread, NULL);
+        pthread_cond_destroy(&channels[i].start_cond);
+    }
+    host_channel_count = 0;
+}
+
+void dma_memcpy_backend_start(uint index, void *dst, const void *src, uint transfer_size_log2, bool read_increment,
+                              uint32_t count) {
+    // called with the mutex held
+    host_channel_t *channel = &channels[index];
+    channel->dst = (uint8_t *)dst;
+    channel->src = (const uint8_t *)src;
+    channel->count = count;
+    channel->transfer_size_log2 = (uint8_t)transfer_size_log2;
+    channel->read_increment = read_increment;
+    channel->started = true;
+    pthread_cond_signal(&channel->start_cond);
+}
+
+uint32_t dma_memcpy_backend_lock(void) {
+    pthread_mutex_lock(&mutex);
+    return 0;
+}
+
+void dma_memcpy_backend_unlock(__unused uint32_t save) {
+    pthread_mutex_unlock(&mutex);
+}
+
+void dma_memcpy_backend_wait(bool (*condition)(const void *arg), const void *arg) {
+    pthread_mutex_lock(&mutex);
+    while (!condition(arg)) {
+        pthread_cond_wait(&done_cond, &mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void dma_memcpy_backend_notify(void) {
+    // taking the mutex means a waiter can't miss this between checking its condition and waiting
+    pthread_mutex_lock(&mutex);
+    pthread_cond_broadcast(&done_cond);
+    pthread_mutex_unlock(&mutex);
+}
@@ -21,6 +21,11 @@
 extern "C" {
 #endif
 
+// there is no vector table on the host, but hardware_irq checks IRQ numbers against its size
+#ifndef PICO_NUM_VTABLE_IRQS
+#define PICO_NUM_VTABLE_IRQS NUM_IRQS
+#endif
+
 #define __not_in_flash(group)
 #define __not_in_flash_func(func) func
 #define __no_inline_not_in_flash_func(func) func
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_SHA256_H
+#define _PICO_SHA256_H
+
+#include "pico.h"
+#include "pico/time.h"
+
+// Host version of pico/sha256.h, with the same API, implemented in software. Only SHA256_BIG_ENDIAN (i.e. the
+// standard byte order for both data and result) is supported
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHA256_RESULT_BYTES 32
+
+enum sha256_endianness {
+    SHA256_LITTLE_ENDIAN,
+    SHA256_BIG_ENDIAN,
+};
+
+typedef union {
+    uint32_t words[SHA256_RESULT_BYTES/4];
+    uint8_t  bytes[SHA256_RESULT_BYTES];
+} sha256_result_t;
+
+typedef struct pico_sha256_state {
+    enum sha256_endianness endianness;
+    bool locked;
+    uint32_t h[8];
+    uint8_t block[64];
+    uint8_t block_used;
+    size_t total_data_size;
+} pico_sha256_state_t;
+
+void pico_sha256_cleanup(pico_sha256_state_t *state);
+
+int pico_sha256_try_start(pico_sha256_state_t *state, enum sha256_endianness endianness, bool use_dma);
+
+int pico_sha256_start_blocking_until(pico_sha256_state_t *state, enum sha256_endianness endianness, bool use_dma, absolute_time_t until);
+
+static inline int pico_sha256_start_blocking(pico_sha256_state_t *state, enum sha256_endianness endianness, bool use_dma) {
+    return pico_sha256_start_blocking_until(state, endianness, use_dma, at_the_end_of_time);
+}
+
+void pico_sha256_update(pico_sha256_state_t *state, const uint8_t *data, size_t data_size_bytes);
+
+void pico_sha256_update_blocking(pico_sha256_state_t *state, const uint8_t *data, size_t data_size_bytes);
+
+void pico_sha256_finish(pico_sha256_state_t *state, sha256_result_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/sha256.h"
+
+// As on the device, only one calculation can be in progress at a time
+static bool sha256_in_use;
+
+static const uint32_t k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t ror32(uint32_t x, uint n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static void sha256_block(uint32_t h[8], const uint8_t *p) {
+    uint32_t w[64];
+    for (uint i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)p[4 * i] << 24) | ((uint32_t)p[4 * i + 1] << 16) | ((uint32_t)p[4 * i + 2] << 8) | p[4 * i + 3];
+    }
+    for (uint i = 16; i < 64; i++) {
+        uint32_t s0 = ror32(w[i - 15], 7) ^ ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ror32(w[i - 2], 17) ^ ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+    for (uint i = 0; i < 64; i++) {
+        uint32_t t1 = hh + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+        uint32_t t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        hh = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+}
+
+void pico_sha256_cleanup(pico_sha256_state_t *state) {
+    if (state->locked) {
+        sha256_in_use = false;
+        state->locked = false;
+    }
+}
+
+int pico_sha256_try_start(pico_sha256_state_t *state, enum sha256_endianness endianness, __unused bool use_dma) {
+    static const uint32_t h0[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    memset(state, 0, sizeof(*state));
+    if (endianness != SHA256_BIG_ENDIAN) return PICO_ERROR_INVALID_ARG;
+    if (sha256_in_use) return PICO_ERROR_RESOURCE_IN_USE;
+    sha256_in_use = true;
+    state->locked = true;
+    state->endianness = endianness;
+    memcpy(state->h, h0, sizeof(h0));
+    return PICO_OK;
+}
+
+int pico_sha256_start_blocking_until(pico_sha256_state_t *state, enum sha256_endianness endianness, bool use_dma, absolute_time_t until) {
+    int rc;
+    do {
+        rc = pico_sha256_try_start(state, endianness, use_dma);
+        if (rc != PICO_ERROR_RESOURCE_IN_USE) break;
+        if (time_reached(until)) {
+            rc = PICO_ERROR_TIMEOUT;
+            break;
+        }
+    } while (true);
+    return rc;
+}
+
+void pico_sha256_update(pico_sha256_state_t *state, const uint8_t *data, size_t data_size_bytes) {
+    assert(state->locked);
+    state->total_data_size += data_size_bytes;
+    while (data_size_bytes) {
+        if (!state->block_used && data_size_bytes >= sizeof(state->block)) {
+            sha256_block(state->h, data);
+            data += sizeof(state->block);
+            data_size_bytes -= sizeof(state->block);
+            continue;
+        }
+        size_t len = MIN(data_size_bytes, sizeof(state->block) - state->block_used);
+        memcpy(state->block + state->block_used, data, len);
+        state->block_used = (uint8_t)(state->block_used + len);
+        data += len;
+        data_size_bytes -= len;
+        if (state->block_used == sizeof(state->block)) {
+            sha256_block(state->h, state->block);
+            state->block_used = 0;
+        }
+    }
+}
+
+void pico_sha256_update_blocking(pico_sha256_state_t *state, const uint8_t *data, size_t data_size_bytes) {
+    pico_sha256_update(state, data, data_size_bytes);
+}
+
+void pico_sha256_finish(pico_sha256_state_t *state, sha256_result_t *out) {
+    assert(state->locked);
+    uint64_t bits = (uint64_t)state->total_data_size * 8;
+    state->block[state->block_used++] = 0x80;
+    if (state->block_used > sizeof(state->block) - 8) {
+        memset(state->block + state->block_used, 0, sizeof(state->block) - state->block_used);
+        sha256_block(state->h, state->block);
+        state->block_used = 0;
+    }
+    memset(state->block + state->block_used, 0, sizeof(state->block) - 8 - state->block_used);
+    for (uint i = 0; i < 8; i++) {
+        state->block[56 + i] = (uint8_t)(bits >> (56 - 8 * i));
+    }
+    sha256_block(state->h, state->block);
+    for (uint i = 0; i < 8; i++) {
+        out->bytes[4 * i] = (uint8_t)(state->h[i] >> 24);
+        out->bytes[4 * i + 1] = (uint8_t)(state->h[i] >> 16);
+        out->bytes[4 * i + 2] = (uint8_t)(state->h[i] >> 8);
+        out->bytes[4 * i + 3] = (uint8_t)state->h[i];
+    }
+    pico_sha256_cleanup(state);
+}
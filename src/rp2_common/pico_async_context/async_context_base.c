@@ -32,15 +32,21 @@ bool async_context_base_remove_at_time_worker(async_context_t *self, async_at_ti
 }
 
 bool async_context_base_add_when_pending_worker(async_context_t *self, async_when_pending_worker_t *worker) {
+    // the list is kept in descending priority order; within a priority, workers are in the order they were added
+    async_when_pending_worker_t **insert = NULL;
     async_when_pending_worker_t **prev = &self->when_pending_list;
     while (*prev) {
         if (worker == *prev) {
             return false;
         }
+        if (!insert && (*prev)->priority < worker->priority) {
+            insert = prev;
+        }
         prev = &(*prev)->next;
     }
-    *prev = worker;
-    worker->next = NULL;
+    if (!insert) insert = prev;
+    worker->next = *insert;
+    *insert = worker;
     return true;
 }
 
@@ -49,6 +55,9 @@ bool async_context_base_remove_when_pending_worker(async_context_t *self, async_
     while (*prev) {
         if (worker == *prev) {
             *prev = worker->next;
+            if (self->resume_worker == worker) {
+                self->resume_worker = NULL;
+            }
             return true;
         }
         prev = &(*prev)->next;
@@ -90,17 +99,121 @@ void async_context_base_refresh_next_timeout(async_context_t *self) {
     self->next_time = earliest;
 }
 
+// latency_us is negative if it is not known
+static void record_worker_run(async_worker_stats_t *stats, int64_t latency_us, absolute_time_t start) {
+    uint32_t run_time_us = (uint32_t)absolute_time_diff_us(start, get_absolute_time());
+    stats->run_count++;
+    stats->total_run_time_us += run_time_us;
+    if (run_time_us > stats->max_run_time_us) stats->max_run_time_us = run_time_us;
+    if (latency_us > 0) {
+        if (latency_us > UINT32_MAX) latency_us = UINT32_MAX;
+        stats->total_latency_us += (uint64_t)latency_us;
+        if (latency_us > stats->max_latency_us) stats->max_latency_us = (uint32_t)latency_us;
+    }
+}
+
+static void run_at_time_worker(async_context_t *self, async_at_time_worker_t *worker) {
+    async_worker_stats_t *stats = worker->stats;
+    if (!stats) {
+        worker->do_work(self, worker);
+        return;
+    }
+    // do_work may re-add the worker with a new time
+    absolute_time_t due = worker->next_time;
+    absolute_time_t start = get_absolute_time();
+    worker->do_work(self, worker);
+    record_worker_run(stats, absolute_time_diff_us(due, start), start);
+}
+
+static void run_when_pending_worker(async_context_t *self, async_when_pending_worker_t *worker) {
+    async_worker_stats_t *stats = worker->stats;
+    if (!stats) {
+        worker->work_pending = false;
+        worker->do_work(self, worker);
+        return;
+    }
+    // async_context_set_work_pending only records the time (without the lock) when work_pending is clear, so take
+    // the time before clearing work_pending; a time recorded after that is for the next run
+    uint32_t pending_since_us = stats->pending_since_us;
+    stats->pending_since_us = 0;
+    __compiler_memory_barrier();
+    worker->work_pending = false;
+    absolute_time_t start = get_absolute_time();
+    int64_t latency_us = pending_since_us ? (int64_t)(uint32_t)((uint32_t)to_us_since_boot(start) - pending_since_us) : -1;
+    worker->do_work(self, worker);
+    record_worker_run(stats, latency_us, start);
+}
+
+static bool budget_used_up(async_context_t *self) {
+    return self->execution_budget_us && time_reached(self->budget_end_time);
+}
+
+static void count_deferred_workers(async_context_t *self) {
+    for (async_when_pending_worker_t *worker = self->when_pending_list; worker; worker = worker->next) {
+        if (worker->work_pending && worker->stats) {
+            worker->stats->deferred_count++;
+        }
+    }
+    for (async_at_time_worker_t *worker = self->at_time_list; worker; worker = worker->next) {
+        if (worker->stats && time_reached(worker->next_time)) {
+            worker->stats->deferred_count++;
+        }
+    }
+}
+
+// Runs pending "when pending" workers, one priority band at a time; returns false if the budget ran out
+static bool run_when_pending_workers(async_context_t *self) {
+    async_when_pending_worker_t *band = self->when_pending_list;
+    while (band) {
+        // find the size of the band, and where in it to start (after the last worker run, if the budget ran out in this band)
+        uint8_t priority = band->priority;
+        async_when_pending_worker_t *start = band;
+        async_when_pending_worker_t *worker = band;
+        uint count = 0;
+        for (; worker && worker->priority == priority; worker = worker->next) {
+            if (worker == self->resume_worker) start = worker;
+            count++;
+        }
+        async_when_pending_worker_t *next_band = worker;
+        // note that a worker may remove itself, so the loop is bounded by count, and does not rely on reaching start again
+        worker = start;
+        for (uint i = 0; i < count; i++) {
+            async_when_pending_worker_t *next = worker->next;
+            if (!next || next->priority != priority) next = band;
+            if (worker->work_pending) {
+                run_when_pending_worker(self, worker);
+                if (budget_used_up(self)) {
+                    self->resume_worker = next;
+                    return false;
+                }
+            }
+            worker = next;
+        }
+        band = next_band;
+    }
+    self->resume_worker = NULL;
+    return true;
+}
+
 absolute_time_t async_context_base_execute_once(async_context_t *self) {
+    self->work_deferred = false;
+    if (self->execution_budget_us) {
+        self->budget_end_time = make_timeout_time_us(self->execution_budget_us);
+    }
     async_at_time_worker_t *at_time_worker;
     while (NULL != (at_time_worker = async_context_base_remove_ready_at_time_worker(self))) {
-        at_time_worker->do_work(self, at_time_worker);
-    }
-    for(async_when_pending_worker_t *when_pending_worker = self->when_pending_list; when_pending_worker; when_pending_worker = when_pending_worker->next) {
-        if (when_pending_worker->work_pending) {
-            when_pending_worker->work_pending = false;
-            when_pending_worker->do_work(self, when_pending_worker);
+        run_at_time_worker(self, at_time_worker);
+        if (budget_used_up(self)) {
+            self->work_deferred = true;
+            break;
         }
     }
+    if (!self->work_deferred) {
+        self->work_deferred = !run_when_pending_workers(self);
+    }
+    if (self->work_deferred) {
+        count_deferred_workers(self);
+    }
     async_context_base_refresh_next_timeout(self);
     return self->next_time;
 }
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/async_context_dual_core.h"
+#include "pico/async_context_base.h"
+#include "pico/sync.h"
+
+static const async_context_type_t template;
+
+static inline uint home_core(const async_context_dual_core_t *self) {
+    return self->core.core_num;
+}
+
+static inline uint other_core(const async_context_dual_core_t *self) {
+    return home_core(self) ^ 1u;
+}
+
+static inline async_context_t *half(async_context_dual_core_t *self, uint core_num) {
+    return &self->halves[core_num].core;
+}
+
+static inline bool caller_holds(async_context_threadsafe_background_t *half_context) {
+    return half_context->lock_mutex.enter_count && half_context->lock_mutex.owner == lock_get_caller_owner_id();
+}
+
+static uint worker_core(const async_context_dual_core_t *self, const async_when_pending_worker_t *worker) {
+    if (worker->core_affinity == ASYNC_CONTEXT_CORE_AFFINITY_DEFAULT) return home_core(self);
+    uint core_num = worker->core_affinity - 1u;
+    assert(core_num < NUM_CORES);
+    return core_num;
+}
+
+bool async_context_dual_core_init(async_context_dual_core_t *self, async_context_threadsafe_background_config_t *config) {
+    memset(self, 0, sizeof(*self));
+    self->core.type = &template;
+    self->core.flags = ASYNC_CONTEXT_FLAG_CALLBACK_FROM_IRQ | ASYNC_CONTEXT_FLAG_CALLBACK_FROM_NON_IRQ;
+    self->core.core_num = get_core_num();
+    self->home_owner = lock_get_caller_owner_id();
+    self->home_half_wanted_by = LOCK_INVALID_OWNER_ID;
+    self->config = *config;
+    // the halves wake each other with doorbells where available
+    self->config.use_doorbell = true;
+    if (!async_context_threadsafe_background_init(&self->halves[home_core(self)], &self->config)) {
+        return false;
+    }
+    self->half_ready[home_core(self)] = true;
+    return true;
+}
+
+bool async_context_dual_core_init_other_core(async_context_dual_core_t *self) {
+    uint core_num = get_core_num();
+    assert(core_num != home_core(self) && !self->half_ready[core_num]);
+    async_context_threadsafe_background_config_t config = self->config;
+    // a custom alarm pool is for the home core's half; this half gets one of its own
+    config.custom_alarm_pool = NULL;
+    if (!async_context_threadsafe_background_init(&self->halves[core_num], &config)) {
+        return false;
+    }
+    // make the half's state visible before it is used from the home core
+    __mem_fence_release();
+    self->half_ready[core_num] = true;
+    return true;
+}
+
+void async_context_dual_core_deinit_other_core(async_context_dual_core_t *self) {
+    uint core_num = get_core_num();
+    assert(core_num != home_core(self));
+    if (!self->half_ready[core_num]) return;
+    // take the home core's half lock, so that nobody is part way through a dual lock or routing a worker here
+    async_context_acquire_lock_blocking(half(self, home_core(self)));
+    self->half_ready[core_num] = false;
+    async_context_release_lock(half(self, home_core(self)));
+    async_context_deinit(half(self, core_num));
+}
+
+// A half is never let go of by a caller part way through, as that caller may be a worker in the middle of a pass over
+// that half's workers. Instead, a caller holding a half while it waits for the other core may lend the half to that
+// core, by making it the owner of the half's mutex without changing the enter count; whatever the borrower does
+// with the half then happens during the lender's call, just as if the lender had done it itself.
+static void set_half_owner(async_context_threadsafe_background_t *half_context, lock_owner_id_t owner) {
+    recursive_mutex_t *mtx = &half_context->lock_mutex;
+    uint32_t save = spin_lock_blocking(mtx->core.spin_lock);
+    mtx->owner = owner;
+    spin_unlock(mtx->core.spin_lock, save);
+}
+
+// Take back a lent half, once the borrower has left any enters it made while it was lent
+static void take_back_half(async_context_threadsafe_background_t *half_context, uint depth, lock_owner_id_t owner) {
+    recursive_mutex_t *mtx = &half_context->lock_mutex;
+    while (true) {
+        uint32_t save = spin_lock_blocking(mtx->core.spin_lock);
+        bool done = mtx->enter_count == depth;
+        if (done) mtx->owner = owner;
+        spin_unlock(mtx->core.spin_lock, save);
+        if (done) return;
+        tight_loop_contents();
+    }
+}
+
+// Called holding the home core's half. The other core may hold its half while it waits for ours (a worker there
+// taking the dual-core lock), in which case it borrows ours until it releases it, rather than both cores waiting
+static void acquire_other_half(async_context_dual_core_t *self) {
+    async_context_threadsafe_background_t *home = &self->halves[home_core(self)];
+    async_context_threadsafe_background_t *other = &self->halves[other_core(self)];
+    while (!recursive_mutex_try_enter(&other->lock_mutex, NULL)) {
+        lock_owner_id_t borrower = self->home_half_wanted_by;
+        if (lock_is_owner_id_valid(borrower)) {
+            self->home_half_lent_depth = home->lock_mutex.enter_count;
+            self->home_half_lender = lock_get_caller_owner_id();
+            self->home_half_lent = true;
+            set_half_owner(home, borrower);
+            while (self->home_half_lent) {
+                tight_loop_contents();
+            }
+            __mem_fence_acquire();
+        } else {
+            tight_loop_contents();
+        }
+    }
+}
+
+// Called by a caller on the other core holding only that core's half (e.g. a worker running there). The home core's
+// half is either free, or will be lent to us by the home core once it is waiting for our half
+static void acquire_home_half_from_other(async_context_dual_core_t *self) {
+    async_context_threadsafe_background_t *home = &self->halves[home_core(self)];
+    self->home_half_wanted_by = lock_get_caller_owner_id();
+    __mem_fence_release();
+    while (!recursive_mutex_try_enter(&home->lock_mutex, NULL)) {
+        tight_loop_contents();
+    }
+    self->home_half_wanted_by = LOCK_INVALID_OWNER_ID;
+}
+
+static void return_home_half_if_borrowed(async_context_dual_core_t *self) {
+    async_context_threadsafe_background_t *home = &self->halves[home_core(self)];
+    if (self->home_half_lent && home->lock_mutex.owner == lock_get_caller_owner_id() &&
+        home->lock_mutex.enter_count == self->home_half_lent_depth) {
+        set_half_owner(home, self->home_half_lender);
+        __mem_fence_release();
+        self->home_half_lent = false;
+    }
+}
+
+// The home core's half is always locked first, and the other core's half is only locked at the outermost level;
+// whether it was locked is remembered (under the home core's half lock) so that release matches acquire even if
+// the other core's half is initialized in between.
+static void async_context_dual_core_acquire_lock_blocking(async_context_t *self_base) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    async_context_threadsafe_background_t *home = &self->halves[home_core(self)];
+    async_context_threadsafe_background_t *other = &self->halves[other_core(self)];
+    if (get_core_num() != home_core(self) && !caller_holds(home) && caller_holds(other)) {
+        acquire_home_half_from_other(self);
+    } else {
+        async_context_acquire_lock_blocking(&home->core);
+    }
+    if (!self->lock_nesting++) {
+        self->other_half_locked = self->half_ready[other_core(self)];
+        if (self->other_half_locked) acquire_other_half(self);
+    }
+}
+
+static void async_context_dual_core_release_lock(async_context_t *self_base) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    assert(self->lock_nesting);
+    if (!--self->lock_nesting && self->other_half_locked) {
+        self->other_half_locked = false;
+        async_context_release_lock(half(self, other_core(self)));
+    }
+    async_context_release_lock(half(self, home_core(self)));
+    return_home_half_if_borrowed(self);
+}
+
+// Code running in a worker on the home core is "in" the context, as it is with a single core context; so is code
+// running in a worker on the other core, as far as that core's half goes
+static void async_context_dual_core_lock_check(async_context_t *self_base) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    uint core_num = get_core_num();
+    if (core_num != home_core(self) && caller_holds(&self->halves[core_num])) return;
+    async_context_lock_check(half(self, home_core(self)));
+}
+
+typedef struct {
+    async_context_dual_core_t *self;
+    uint32_t (*func)(void *param);
+    void *param;
+} dual_core_sync_call_t;
+
+static uint32_t dual_core_sync_call(void *param) {
+    dual_core_sync_call_t *call = (dual_core_sync_call_t *)param;
+    // we are on the home core holding its half's lock; add the other half to make it a full dual lock
+    async_context_dual_core_acquire_lock_blocking(&call->self->core);
+    uint32_t rc = call->func(call->param);
+    async_context_dual_core_release_lock(&call->self->core);
+    return rc;
+}
+
+static uint32_t async_context_dual_core_execute_sync(async_context_t *self_base, uint32_t (*func)(void *param), void *param) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    dual_core_sync_call_t call = {
+            .self = self,
+            .func = func,
+            .param = param,
+    };
+    async_context_threadsafe_background_t *other = &self->halves[other_core(self)];
+    if (get_core_num() == home_core(self) || !caller_holds(other)) {
+        return async_context_execute_sync(half(self, home_core(self)), dual_core_sync_call, &call);
+    }
+    if (caller_holds(&self->halves[home_core(self)])) {
+        // we already hold the dual-core lock
+        return func(param);
+    }
+    // a worker on the other core; lend its half to the home core while we wait for it, as the home core may need
+    // that half to run the call
+    uint depth = other->lock_mutex.enter_count;
+    set_half_owner(other, self->home_owner);
+    uint32_t rc = async_context_execute_sync(half(self, home_core(self)), dual_core_sync_call, &call);
+    take_back_half(other, depth, lock_get_caller_owner_id());
+    return rc;
+}
+
+static bool async_context_dual_core_add_when_pending_worker(async_context_t *self_base, async_when_pending_worker_t *worker) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    uint core_num = worker_core(self, worker);
+    if (!self->half_ready[core_num]) return false;
+    async_context_t *target = half(self, core_num);
+    return target->type->add_when_pending_worker(target, worker);
+}
+
+static bool async_context_dual_core_remove_when_pending_worker(async_context_t *self_base, async_when_pending_worker_t *worker) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    uint core_num = worker_core(self, worker);
+    if (!self->half_ready[core_num]) return false;
+    async_context_t *target = half(self, core_num);
+    return target->type->remove_when_pending_worker(target, worker);
+}
+
+static void async_context_dual_core_set_work_pending(async_context_t *self_base, async_when_pending_worker_t *worker) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    uint core_num = worker_core(self, worker);
+    if (!self->half_ready[core_num]) {
+        // the worker cannot have been added; just remember the work for when it is
+        worker->work_pending = true;
+        return;
+    }
+    // call the half's method directly; the stats have already been updated by async_context_set_work_pending
+    async_context_t *target = half(self, core_num);
+    target->type->set_work_pending(target, worker);
+}
+
+static bool async_context_dual_core_add_at_time_worker(async_context_t *self_base, async_at_time_worker_t *worker) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    return async_context_add_at_time_worker(half(self, home_core(self)), worker);
+}
+
+static bool async_context_dual_core_remove_at_time_worker(async_context_t *self_base, async_at_time_worker_t *worker) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    for (uint i = 0; i < NUM_CORES; i++) {
+        if (self->half_ready[i] && async_context_remove_at_time_worker(half(self, i), worker)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool async_context_dual_core_add_at_time_worker_on_core(async_context_dual_core_t *self, async_at_time_worker_t *worker, uint core_num) {
+    assert(core_num < NUM_CORES);
+    if (!self->half_ready[core_num]) return false;
+    return async_context_add_at_time_worker(half(self, core_num), worker);
+}
+
+bool async_context_dual_core_set_worker_core(async_context_dual_core_t *self, async_when_pending_worker_t *worker, uint8_t core_affinity) {
+    bool moved = false;
+    async_context_dual_core_acquire_lock_blocking(&self->core);
+    async_context_t *from = half(self, worker_core(self, worker));
+    bool pending = worker->work_pending;
+    bool present = from->type->remove_when_pending_worker(from, worker);
+    worker->core_affinity = core_affinity;
+    if (present) {
+        uint core_num = worker_core(self, worker);
+        if (!self->half_ready[core_num]) {
+            // put it back where it was
+            worker->core_affinity = (uint8_t)ASYNC_CONTEXT_CORE_AFFINITY(from->core_num);
+            core_num = from->core_num;
+        } else {
+            moved = true;
+        }
+        async_context_t *to = half(self, core_num);
+        to->type->add_when_pending_worker(to, worker);
+        if (pending) to->type->set_work_pending(to, worker);
+    }
+    async_context_dual_core_release_lock(&self->core);
+    return moved;
+}
+
+static void async_context_dual_core_wait_until(async_context_t *self_base, absolute_time_t until) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    async_context_wait_until(half(self, home_core(self)), until);
+}
+
+static void async_context_dual_core_wait_for_work_until(async_context_t *self_base, absolute_time_t until) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    async_context_wait_for_work_until(half(self, home_core(self)), until);
+}
+
+static void async_context_dual_core_deinit(async_context_t *self_base) {
+    async_context_dual_core_t *self = (async_context_dual_core_t *)self_base;
+    assert(get_core_num() == home_core(self));
+    // the other core must have called async_context_dual_core_deinit_other_core first
+    assert(!self->half_ready[other_core(self)]);
+    if (self->half_ready[home_core(self)]) {
+        async_context_deinit(half(self, home_core(self)));
+    }
+    memset(self, 0, sizeof(*self));
+}
+
+static const async_context_type_t template = {
+        .type = ASYNC_CONTEXT_DUAL_CORE,
+        .acquire_lock_blocking = async_context_dual_core_acquire_lock_blocking,
+        .release_lock = async_context_dual_core_release_lock,
+        .lock_check = async_context_dual_core_lock_check,
+        .execute_sync = async_context_dual_core_execute_sync,
+        .add_at_time_worker = async_context_dual_core_add_at_time_worker,
+        .remove_at_time_worker = async_context_dual_core_remove_at_time_worker,
+        .add_when_pending_worker = async_context_dual_core_add_when_pending_worker,
+        .remove_when_pending_worker = async_context_dual_core_remove_when_pending_worker,
+        .set_work_pending = async_context_dual_core_set_work_pending,
+        .poll = 0,
+        .wait_until = async_context_dual_core_wait_until,
+        .wait_for_work_until = async_context_dual_core_wait_for_work_until,
+        .deinit = async_context_dual_core_deinit,
+};
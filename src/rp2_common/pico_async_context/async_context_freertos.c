@@ -47,6 +47,12 @@ static void process_under_lock(async_context_freertos_t *self) {
     do {
         repeat = false;
         absolute_time_t next_time = async_context_base_execute_once(&self->core);
+        if (self->core.work_deferred) {
+            // out of execution budget; go round the task loop (releasing the lock) before carrying on. the timer
+            // will be dealt with on the next pass
+            xTaskNotifyGive(self->task_handle);
+            break;
+        }
         TickType_t ticks;
         if (is_at_the_end_of_time(next_time)) {
             ticks = portMAX_DELAY;
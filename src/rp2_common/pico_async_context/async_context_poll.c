@@ -33,6 +33,10 @@ static void async_context_poll_requires_update(async_context_t *self_base, async
 
 static void async_context_poll_poll(async_context_t *self_base) {
     async_context_base_execute_once(self_base);
+    if (self_base->work_deferred) {
+        // out of execution budget; make sure the next wait returns immediately so the work is picked up
+        async_context_poll_wake_up(self_base);
+    }
 }
 
 static void async_context_poll_wait_until(__unused async_context_t *self_base, absolute_time_t until) {
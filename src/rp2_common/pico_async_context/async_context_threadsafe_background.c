@@ -9,9 +9,16 @@
 #include "pico/async_context_base.h"
 #include "pico/sync.h"
 #include "hardware/irq.h"
+#if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED
+#include "pico/multicore.h"
+#endif
 
 static const async_context_type_t template;
-static async_context_threadsafe_background_t *async_contexts_by_user_irq[NUM_USER_IRQS];
+// user IRQs are per core, so contexts on different cores may have the same low priority IRQ number
+static async_context_threadsafe_background_t *async_contexts_by_user_irq[NUM_CORES][NUM_USER_IRQS];
+#if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED
+static uint8_t doorbell_handler_users[NUM_CORES];
+#endif
 
 static void low_priority_irq_handler(void);
 static void process_under_lock(async_context_threadsafe_background_t *self);
@@ -29,6 +36,7 @@ async_context_threadsafe_background_config_t async_context_threadsafe_background
     async_context_threadsafe_background_config_t config = {
             .low_priority_irq_handler_priority = ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DEFAULT_LOW_PRIORITY_IRQ_HANDLER_PRIORITY,
             .custom_alarm_pool = NULL,
+            .use_doorbell = ASYNC_CONTEXT_THREADSAFE_BACKGROUND_USE_DOORBELL,
     };
     return config;
 }
@@ -47,6 +55,11 @@ static void async_context_threadsafe_background_wake_up(async_context_t *self_ba
     if (self_base->core_num == get_core_num()) {
         // on same core, can dispatch directly
         irq_set_pending(self->low_priority_irq_num);
+#if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED
+    } else if (self->doorbell_num >= 0) {
+        // the doorbell IRQ handler on the other core pends the low priority IRQ there
+        multicore_doorbell_set_other_core((uint)self->doorbell_num);
+#endif
     } else {
         // remove the existing alarm (it may have already fired) so we don't overflow the pool with repeats
         //
@@ -164,14 +177,50 @@ uint32_t async_context_threadsafe_background_execute_sync(async_context_t *self_
     return rc;
 }
 
+#if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED
+static void doorbell_irq_handler(void) {
+    uint core_num = get_core_num();
+    for (uint i = 0; i < NUM_USER_IRQS; i++) {
+        async_context_threadsafe_background_t *self = async_contexts_by_user_irq[core_num][i];
+        if (self && self->doorbell_num >= 0 && multicore_doorbell_is_set_current_core((uint)self->doorbell_num)) {
+            multicore_doorbell_clear_current_core((uint)self->doorbell_num);
+            irq_set_pending(self->low_priority_irq_num);
+        }
+    }
+}
+
+static void doorbell_init(async_context_threadsafe_background_t *self) {
+    // failing to get a doorbell is not fatal; we fall back to the alarm pool
+    self->doorbell_num = (int8_t)multicore_doorbell_claim_unused(1u << self->core.core_num, false);
+    if (self->doorbell_num < 0) return;
+    uint irq_num = multicore_doorbell_irq_num((uint)self->doorbell_num);
+    if (!doorbell_handler_users[self->core.core_num]++) {
+        irq_add_shared_handler(irq_num, doorbell_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(irq_num, true);
+    }
+}
+
+static void doorbell_deinit(async_context_threadsafe_background_t *self) {
+    if (self->doorbell_num < 0) return;
+    uint irq_num = multicore_doorbell_irq_num((uint)self->doorbell_num);
+    if (!--doorbell_handler_users[self->core.core_num]) {
+        irq_set_enabled(irq_num, false);
+        irq_remove_handler(irq_num, doorbell_irq_handler);
+    }
+    multicore_doorbell_clear_current_core((uint)self->doorbell_num);
+    multicore_doorbell_unclaim((uint)self->doorbell_num, 1u << self->core.core_num);
+    self->doorbell_num = -1;
+}
+#endif
+
 static bool low_prio_irq_init(async_context_threadsafe_background_t  *self, uint8_t priority) {
     assert(get_core_num() == self->core.core_num);
     int irq = user_irq_claim_unused(false);
     if (irq < 0) return false;
     self->low_priority_irq_num = (uint8_t) irq;
     uint index = irq - FIRST_USER_IRQ;
-    assert(index < count_of(async_contexts_by_user_irq));
-    async_contexts_by_user_irq[index] = self;
+    assert(index < NUM_USER_IRQS);
+    async_contexts_by_user_irq[self->core.core_num][index] = self;
     irq_set_exclusive_handler(self->low_priority_irq_num, low_priority_irq_handler);
     irq_set_enabled(self->low_priority_irq_num, true);
     irq_set_priority(self->low_priority_irq_num, priority);
@@ -183,6 +232,7 @@ static void low_prio_irq_deinit(async_context_threadsafe_background_t *self) {
         assert(get_core_num() == self->core.core_num);
         irq_set_enabled(self->low_priority_irq_num, false);
         irq_remove_handler(self->low_priority_irq_num, low_priority_irq_handler);
+        async_contexts_by_user_irq[self->core.core_num][self->low_priority_irq_num - FIRST_USER_IRQ] = NULL;
         user_irq_unclaim(self->low_priority_irq_num);
         self->low_priority_irq_num = 0;
     }
@@ -223,6 +273,13 @@ bool async_context_threadsafe_background_init(async_context_threadsafe_backgroun
     sem_init(&self->work_needed_sem, 1, 1);
     recursive_mutex_init(&self->lock_mutex);
     bool ok = low_prio_irq_init(self, config->low_priority_irq_handler_priority);
+#if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED
+    if (ok && config->use_doorbell) {
+        doorbell_init(self);
+    } else {
+        self->doorbell_num = -1;
+    }
+#endif
     return ok;
 }
 
@@ -235,6 +292,9 @@ static void async_context_threadsafe_background_deinit(async_context_t *self_bas
     async_context_threadsafe_background_t *self = (async_context_threadsafe_background_t *)self_base;
     // todo we do not currently handle this correctly; we could, but seems like a rare case
     assert(get_core_num() == self_base->core_num);
+#if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED
+    doorbell_deinit(self);
+#endif
     low_prio_irq_deinit(self);
     if (self->alarm_id > 0) alarm_pool_cancel_alarm(self->alarm_pool, self->alarm_id);
 #if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_MULTI_CORE
@@ -255,6 +315,12 @@ static void process_under_lock(async_context_threadsafe_background_t *self) {
 #endif
     do {
         absolute_time_t next_time = async_context_base_execute_once(&self->core);
+        if (self->core.work_deferred) {
+            // out of execution budget; leave the IRQ (and release the lock) before carrying on. the alarm
+            // will be dealt with on the next pass
+            irq_set_pending(self->low_priority_irq_num);
+            break;
+        }
         // if the next wakeup time is in the past then loop
         if (absolute_time_diff_us(get_absolute_time(), next_time) <= 0) continue;
         // if there is no next wakeup time, we're done
@@ -288,8 +354,8 @@ static void process_under_lock(async_context_threadsafe_background_t *self) {
 // Low priority interrupt handler to perform background processing
 static void low_priority_irq_handler(void) {
     uint index = __get_current_exception() - VTABLE_FIRST_IRQ - FIRST_USER_IRQ;
-    assert(index < count_of(async_contexts_by_user_irq));
-    async_context_threadsafe_background_t *self = async_contexts_by_user_irq[index];
+    assert(index < NUM_USER_IRQS);
+    async_context_threadsafe_background_t *self = async_contexts_by_user_irq[get_core_num()][index];
     if (!self) return;
     assert(self->core.core_num == get_core_num());
     if (recursive_mutex_try_enter(&self->lock_mutex, NULL)) {
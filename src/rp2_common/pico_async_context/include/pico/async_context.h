@@ -30,6 +30,18 @@
  *
  * Note: "when pending" workers with work pending are executed before "at time" workers.
  *
+ * "When pending" workers have a \ref async_when_pending_worker::priority; workers with a higher priority are run first
+ * in each pass, and workers of equal priority are run in the order they were added. An execution budget may be set with
+ * \ref async_context_set_execution_budget_us, in which case a pass stops once the budget is used up, and the
+ * remaining work is picked up in a later pass, after the context has given up the lock (and, for
+ * async_context_threadsafe_background, left the IRQ). Workers of equal priority are resumed round-robin, so a single
+ * long-running worker cannot starve its peers; such a worker may also check \ref async_context_should_yield and set
+ * itself pending again to continue later. Workers are never pre-empted, so the budget is a bound on the time at which
+ * the context stops starting new work, not on the length of any one worker.
+ *
+ * Per-worker run-time and latency statistics may be gathered by pointing a worker's \c stats field at an
+ * \ref async_worker_stats_t.
+ *
  * The async_context provides locking mechanisms, see \ref async_context_acquire_lock_blocking,
  * \ref async_context_release_lock and \ref async_context_lock_check which can be used by
  * external code to ensure execution of external code does not happen concurrently with worker code.
@@ -53,6 +65,14 @@
  * \ref async_context_poll() is not required, and is a no-op. This context implements async_context locking and is thus
  * safe to call from any task, and from either core, according to the specific notes on each API.
  *
+ * async_context_host - (host builds on Linux only) Work is performed from a separate thread, which sleeps on an
+ * epoll set until work is pending or an "at time" worker is due. As with async_context_freertos, calling
+ * \ref async_context_poll() is not required, and the context is safe to call from any thread.
+ *
+ * async_context_dual_core - A pair of async_context_threadsafe_background instances, one on each core, behind a single
+ * async_context. Workers run on the core given by their affinity, so (unlike the other types) workers with different
+ * affinities may run concurrently; the async_context lock and \ref async_context_execute_sync still exclude all workers.
+ *
  * Each async_context provides bespoke methods of instantiation which are provided in the corresponding headers (e.g.
  * async_context_poll.h, async_context_threadsafe_background.h, asycn_context_freertos.h).
  * async_contexts are de-initialized by the common async_context_deint() method.
@@ -74,10 +94,42 @@ enum {
     ASYNC_CONTEXT_POLL = 1,
     ASYNC_CONTEXT_THREADSAFE_BACKGROUND = 2,
     ASYNC_CONTEXT_FREERTOS = 3,
+    ASYNC_CONTEXT_HOST = 4,
+    ASYNC_CONTEXT_DUAL_CORE = 5,
 };
 
+/*! \brief Value for \ref async_when_pending_worker::core_affinity meaning the async_context's own core
+ *  \ingroup pico_async_context
+ */
+#define ASYNC_CONTEXT_CORE_AFFINITY_DEFAULT 0
+
+/*! \brief Value for \ref async_when_pending_worker::core_affinity requesting a specific core
+ *  \ingroup pico_async_context
+ */
+#define ASYNC_CONTEXT_CORE_AFFINITY(core_num) ((uint8_t)((core_num) + 1))
+
 typedef struct async_context async_context_t;
 
+/*! \brief Run-time and latency statistics for an async_context worker
+ *  \ingroup pico_async_context
+ *
+ * Statistics are gathered for a worker whose \c stats field points to one of these (which should be zero-initialized),
+ * and are updated by the async_context under lock (apart from the time a "when pending" worker was set pending, which
+ * \ref async_context_set_work_pending records with a single 32-bit store, as it may be called from an IRQ).
+ *
+ * For an "at time" worker the latency is measured from the time it was due; for a "when pending" worker it is measured
+ * from the first call to \ref async_context_set_work_pending since it last ran.
+ */
+typedef struct async_worker_stats {
+    uint32_t run_count;          ///< number of times the worker has been run
+    uint32_t deferred_count;     ///< number of passes which ran out of execution budget while the worker was waiting to run
+    uint32_t max_run_time_us;    ///< longest single run
+    uint32_t max_latency_us;     ///< longest latency
+    uint64_t total_run_time_us;  ///< total time spent in the worker
+    uint64_t total_latency_us;   ///< total latency over all runs
+    uint32_t pending_since_us;   ///< private; time_us_32() when the worker was set pending, or 0 if it is not
+} async_worker_stats_t;
+
 /*! \brief A "timeout" instance used by an async_context
  *  \ingroup pico_async_context
  *
@@ -110,6 +162,10 @@ typedef struct async_work_on_timeout {
      * \brief User data associated with the timeout instance
      */
     void *user_data;
+    /*!
+     * \brief Optional statistics for this worker, or NULL
+     */
+    async_worker_stats_t *stats;
 } async_at_time_worker_t;
 
 /*! \brief A "worker" instance used by an async_context
@@ -142,6 +198,24 @@ typedef struct async_when_pending_worker {
      * \brief User data associated with the worker instance
      */
     void *user_data;
+    /*!
+     * \brief Optional statistics for this worker, or NULL
+     */
+    async_worker_stats_t *stats;
+    /*!
+     * \brief Priority of the worker relative to other "when pending" workers; higher values run first
+     *
+     * This must not be changed while the worker is added to an async_context
+     */
+    uint8_t priority;
+    /*!
+     * \brief The core the worker should be run on, for async_contexts which run workers on more than one core
+     * (see \ref async_context_dual_core); either \ref ASYNC_CONTEXT_CORE_AFFINITY_DEFAULT or \ref ASYNC_CONTEXT_CORE_AFFINITY(core_num).
+     * Other async_context types ignore it.
+     *
+     * This must not be changed while the worker is added to an async_context
+     */
+    uint8_t core_affinity;
 } async_when_pending_worker_t;
 
 #define ASYNC_CONTEXT_FLAG_CALLBACK_FROM_NON_IRQ 0x1
@@ -183,6 +257,10 @@ struct async_context {
     absolute_time_t next_time;
     uint16_t flags;
     uint8_t  core_num;
+    bool work_deferred;
+    uint32_t execution_budget_us;
+    absolute_time_t budget_end_time;
+    async_when_pending_worker_t *resume_worker;
 };
 
 /*!
@@ -379,9 +457,41 @@ static inline bool async_context_remove_when_pending_worker(async_context_t *con
  * \param worker the "when pending" worker to mark as pending.
  */
 static inline void async_context_set_work_pending(async_context_t *context, async_when_pending_worker_t *worker) {
+    if (worker->stats && !worker->work_pending) {
+        uint32_t now = time_us_32();
+        worker->stats->pending_since_us = now ? now : 1;
+    }
     context->type->set_work_pending(context, worker);
 }
 
+/*!
+ * \brief Set the execution budget for each pass of the async_context over its workers
+ * \ingroup pico_async_context
+ *
+ * Once a worker finishes after the budget has been used up, no further workers are started in that pass; the
+ * remaining work is deferred to the next pass. The default of 0 means no limit.
+ *
+ * \param context the async_context
+ * \param budget_us the budget in microseconds, or 0 for no limit
+ */
+static inline void async_context_set_execution_budget_us(async_context_t *context, uint32_t budget_us) {
+    context->execution_budget_us = budget_us;
+}
+
+/*!
+ * \brief Determine whether the current pass has used up its execution budget
+ * \ingroup pico_async_context
+ *
+ * This is intended to be called from a worker which has a large amount of work to do; if it returns true, the
+ * worker should stop, and set itself pending again (see \ref async_context_set_work_pending) to continue in a later pass.
+ *
+ * \param context the async_context
+ * \return true if an execution budget is set and it has been used up
+ */
+static inline bool async_context_should_yield(const async_context_t *context) {
+    return context->execution_budget_us && time_reached(context->budget_end_time);
+}
+
 /*!
  * \brief Perform any pending work for polling style async_context
  * \ingroup pico_async_context
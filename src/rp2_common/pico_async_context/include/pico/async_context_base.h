@@ -23,6 +23,8 @@ bool async_context_base_remove_when_pending_worker(async_context_t *self, async_
 async_at_time_worker_t *async_context_base_remove_ready_at_time_worker(async_context_t *self);
 void async_context_base_refresh_next_timeout(async_context_t *self);
 
+// runs one pass over the workers; if self->work_deferred is then set, the pass ran out of execution budget, and the
+// caller should arrange for another pass (after releasing the lock) rather than waiting for the returned time
 absolute_time_t async_context_base_execute_once(async_context_t *self);
 bool async_context_base_needs_servicing(async_context_t *self);
 
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_ASYNC_CONTEXT_DUAL_CORE_H
+#define _PICO_ASYNC_CONTEXT_DUAL_CORE_H
+
+/** \file pico/async_context_dual_core.h
+ *  \defgroup async_context_dual_core async_context_dual_core
+ *  \ingroup pico_async_context
+ *
+ * \brief async_context_dual_core provides an implementation of \ref async_context which runs workers on both cores
+ *
+ * The context is made up of two \ref async_context_threadsafe_background instances ("halves"), one on each core, behind a
+ * single \ref async_context_t. The core that calls \ref async_context_dual_core_init is the context's own core
+ * (see \ref async_context_core_num); the other core must call \ref async_context_dual_core_init_other_core before
+ * workers can be added to it.
+ *
+ * "When pending" workers run on the core given by \ref async_when_pending_worker::core_affinity, which defaults to the
+ * context's own core, and may be changed with \ref async_context_dual_core_set_worker_core. "At time" workers run on
+ * the context's own core, unless added with \ref async_context_dual_core_add_at_time_worker_on_core.
+ *
+ * Workers with the same affinity never run concurrently, and are passed the async_context of their half, whose lock
+ * excludes just that half's workers. Workers with different affinities DO run concurrently, so should only share
+ * state via their own synchronization, or by taking the lock of the dual-core context itself, which (like
+ * \ref async_context_execute_sync) excludes the workers on both cores.
+ *
+ * The halves are always locked in the same order (the context's own core's half first), and a half is never let go
+ * of while it is held, so the lock of the dual-core context may be taken from a worker running on the other core, and
+ * such a worker may call \ref async_context_execute_sync. Where one core holds a half while waiting for the other
+ * core, it lends that half to the other core for the duration, so anything done there (including removing the
+ * running worker) happens as if done by the waiting call itself. \ref async_context_lock_check on the dual-core
+ * context accepts code running in a worker on the other core, as it only holds the lock of its own half.
+ *
+ * Cross-core wakeups use an inter-core doorbell where available (RP2350), as the halves are initialized with
+ * \ref async_context_threadsafe_background_config::use_doorbell set; on RP2040 the inter-core FIFO is reserved
+ * for \ref multicore_lockout, so a forced alarm on the other core's alarm pool is used as before.
+ */
+
+#include "pico/async_context_threadsafe_background.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct async_context_dual_core {
+    async_context_t core;
+    async_context_threadsafe_background_t halves[NUM_CORES];
+    async_context_threadsafe_background_config_t config;
+    volatile bool half_ready[NUM_CORES];
+    bool other_half_locked;
+    uint32_t lock_nesting;
+    lock_owner_id_t home_owner;
+    volatile lock_owner_id_t home_half_wanted_by;
+    volatile bool home_half_lent;
+    uint8_t home_half_lent_depth;
+    lock_owner_id_t home_half_lender;
+} async_context_dual_core_t;
+
+/*!
+ * \brief Initialize an async_context_dual_core instance, and its half on the calling core
+ * \ingroup async_context_dual_core
+ *
+ * If this method succeeds (returns true), then the async_context is available for use with workers on the calling
+ * core, and can be de-initialized by calling async_context_deinit() (after \ref async_context_dual_core_deinit_other_core,
+ * if the other core was initialized).
+ *
+ * \param self a pointer to async_context_dual_core structure to initialize
+ * \param config the configuration for both halves; \p config->custom_alarm_pool is only used for this core's half, and
+ * \p config->use_doorbell is ignored, as the halves always use doorbells where available
+ * \return true if initialization is successful, false otherwise
+ */
+bool async_context_dual_core_init(async_context_dual_core_t *self, async_context_threadsafe_background_config_t *config);
+
+/*!
+ * \brief Initialize an async_context_dual_core instance with default values
+ * \ingroup async_context_dual_core
+ *
+ * \param self a pointer to async_context_dual_core structure to initialize
+ * \return true if initialization is successful, false otherwise
+ */
+static inline bool async_context_dual_core_init_with_defaults(async_context_dual_core_t *self) {
+    async_context_threadsafe_background_config_t config = async_context_threadsafe_background_default_config();
+    return async_context_dual_core_init(self, &config);
+}
+
+/*!
+ * \brief Initialize the half of an async_context_dual_core instance on the other core
+ * \ingroup async_context_dual_core
+ *
+ * This must be called on the core which did NOT call \ref async_context_dual_core_init, after that call has returned.
+ * Workers for this core run in a low priority IRQ, so the core need do nothing more than idle afterwards.
+ *
+ * \param self the async_context_dual_core instance
+ * \return true if initialization is successful, false otherwise
+ */
+bool async_context_dual_core_init_other_core(async_context_dual_core_t *self);
+
+/*!
+ * \brief De-initialize the half of an async_context_dual_core instance on the other core
+ * \ingroup async_context_dual_core
+ *
+ * This must be called on the same core as \ref async_context_dual_core_init_other_core, once no workers remain on it,
+ * and before async_context_deinit() is called on the context's own core.
+ *
+ * \param self the async_context_dual_core instance
+ */
+void async_context_dual_core_deinit_other_core(async_context_dual_core_t *self);
+
+/*!
+ * \brief Determine if both halves of an async_context_dual_core instance have been initialized
+ * \ingroup async_context_dual_core
+ *
+ * \param self the async_context_dual_core instance
+ * \return true if workers can be run on either core
+ */
+static inline bool async_context_dual_core_is_ready(const async_context_dual_core_t *self) {
+    for (uint i = 0; i < NUM_CORES; i++) {
+        if (!self->half_ready[i]) return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Return the async_context for the workers on one core
+ * \ingroup async_context_dual_core
+ *
+ * This is the context passed to the workers running on that core. It may be given to code which should run all of
+ * its work on the one core; its lock excludes only that core's workers.
+ *
+ * \param self the async_context_dual_core instance
+ * \param core_num the core
+ * \return the async_context for that core
+ */
+static inline async_context_t *async_context_dual_core_get_core_context(async_context_dual_core_t *self, uint core_num) {
+    return &self->halves[core_num].core;
+}
+
+/*!
+ * \brief Add an "at time" worker to run on a particular core
+ * \ingroup async_context_dual_core
+ *
+ * \param self the async_context_dual_core instance
+ * \param worker the "at time" worker to add
+ * \param core_num the core to run the worker on
+ * \return true if the worker was added, false if the worker was already present, or the core's half is not initialized
+ */
+bool async_context_dual_core_add_at_time_worker_on_core(async_context_dual_core_t *self, async_at_time_worker_t *worker, uint core_num);
+
+/*!
+ * \brief Move a "when pending" worker to a different core
+ * \ingroup async_context_dual_core
+ *
+ * The worker's \ref async_when_pending_worker::core_affinity is updated, and if the worker is present, it is moved
+ * (along with any pending work) under the lock of the dual-core context, so it is not running while it is moved.
+ *
+ * \param self the async_context_dual_core instance
+ * \param worker the worker
+ * \param core_affinity the new affinity; \ref ASYNC_CONTEXT_CORE_AFFINITY_DEFAULT or \ref ASYNC_CONTEXT_CORE_AFFINITY(core_num)
+ * \return true if the worker was present and was moved, false if it was not present, or the new core's half is not initialized
+ */
+bool async_context_dual_core_set_worker_core(async_context_dual_core_t *self, async_when_pending_worker_t *worker, uint8_t core_affinity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,6 +30,18 @@ extern "C" {
 #define ASYNC_CONTEXT_THREADSAFE_BACKGROUND_MULTI_CORE LIB_PICO_MULTICORE
 #endif
 
+// PICO_CONFIG: ASYNC_CONTEXT_THREADSAFE_BACKGROUND_USE_DOORBELL, Default for async_context_threadsafe_background_config::use_doorbell as returned by async_context_threadsafe_background_default_config(), type=bool, default=0, group=pico_async_context
+#ifndef ASYNC_CONTEXT_THREADSAFE_BACKGROUND_USE_DOORBELL
+#define ASYNC_CONTEXT_THREADSAFE_BACKGROUND_USE_DOORBELL 0
+#endif
+
+// doorbells can only be used on multicore builds for platforms which have them
+#if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_MULTI_CORE && NUM_DOORBELLS
+#define ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED 1
+#else
+#define ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED 0
+#endif
+
 typedef struct async_context_threadsafe_background async_context_threadsafe_background_t;
 
 /**
@@ -51,6 +63,14 @@ typedef struct async_context_threadsafe_background_config {
      * initialization.
      */
     alarm_pool_t *custom_alarm_pool;
+    /**
+     * \brief true to wake the async_context from the other core with an inter-core doorbell (where available), rather
+     * than with a forced alarm on its alarm pool
+     *
+     * This claims a doorbell (if one is free), and adds a shared handler for the doorbell IRQ on the async_context's
+     * core. It is set for the halves of an \ref async_context_dual_core.
+     */
+    bool use_doorbell;
 } async_context_threadsafe_background_config_t;
 
 struct async_context_threadsafe_background {
@@ -63,6 +83,9 @@ struct async_context_threadsafe_background {
 #if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_MULTI_CORE
     volatile alarm_id_t force_alarm_id;
     bool alarm_pool_owned;
+#endif
+#if ASYNC_CONTEXT_THREADSAFE_BACKGROUND_DOORBELL_SUPPORTED
+    int8_t doorbell_num; // -1 if no doorbell could be claimed
 #endif
     uint8_t low_priority_irq_num;
     volatile bool alarm_pending;
@@ -6,17 +6,20 @@
 
 #include <stdatomic.h>
 #include "pico/sync.h"
+#include "pico/atomic.h"
 
 // We use __builtin_mem* to avoid libc dependency.
 #define memcpy __builtin_memcpy
 #define memcmp __builtin_memcmp
 
-static inline uint32_t atomic_lock(__unused const volatile void *ptr) {
-    return spin_lock_blocking(spin_lock_instance(PICO_SPINLOCK_ID_ATOMIC));
+// ptr must be the address of the start of the atomic object, so that with PICO_ATOMIC_STRIPED_SPIN_LOCKS every
+// operation on it uses the same spin lock
+static inline uint32_t atomic_lock(const volatile void *ptr) {
+    return spin_lock_blocking(spin_lock_instance(atomic_spin_lock_num(ptr)));
 }
 
-static inline void atomic_unlock(__unused const volatile void *ptr, uint32_t save) {
-    spin_unlock(spin_lock_instance(PICO_SPINLOCK_ID_ATOMIC), save);
+static inline void atomic_unlock(const volatile void *ptr, uint32_t save) {
+    spin_unlock(spin_lock_instance(atomic_spin_lock_num(ptr)), save);
 }
 
 #if PICO_C_COMPILER_IS_GNU
@@ -66,9 +69,9 @@ void __atomic_load_c(uint size, const volatile void *src, void *dest, __unused i
 // An atomic store operation.  This is atomic with respect to the destination
 // pointer only.
 void __atomic_store_c(uint size, volatile void *dest, void *src, __unused int model) {
-    uint32_t save = atomic_lock(src);
+    uint32_t save = atomic_lock(dest);
     memcpy(remove_volatile_cast_no_barrier(void *, dest), src, size);
-    atomic_unlock(src, save);
+    atomic_unlock(dest, save);
 }
 
 // Atomic compare and exchange operation.  If the value at *ptr is identical
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_ATOMIC_H
+#define _PICO_ATOMIC_H
+
+#include "pico.h"
+#include "hardware/sync.h"
+
+/** \file pico/atomic.h
+ *  \ingroup pico_atomic
+ *
+ * \brief Selection of the spin lock which protects an atomic object which is not lock free
+ *
+ * By default every atomic operation which is not lock free (every one on RP2040, and those on objects larger than
+ * 4 bytes on RP2350) is protected by the single spin lock \ref PICO_SPINLOCK_ID_ATOMIC, so operations on unrelated
+ * objects from the two cores wait for each other.
+ *
+ * If \ref PICO_ATOMIC_STRIPED_SPIN_LOCKS is 1, the object's address is instead hashed onto one of
+ * \ref PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT spin locks starting at \ref PICO_SPINLOCK_ID_STRIPED_FIRST. Every
+ * operation on an object (of any size) is passed the address of its start, so always uses the same spin lock, and
+ * operations on the whole of a multi-word object remain atomic.
+ *
+ * The striped spin locks are shared with other users (see \ref next_striped_spin_lock_num), so in this mode code
+ * which holds a striped spin lock must not perform atomic operations which are not lock free, as it may deadlock
+ * trying to take the same spin lock again.
+ */
+
+// PICO_CONFIG: PICO_ATOMIC_STRIPED_SPIN_LOCKS, Whether to hash the address of an atomic object onto one of several striped spin locks rather than using PICO_SPINLOCK_ID_ATOMIC for all atomic objects, type=bool, default=0, group=pico_atomic
+#ifndef PICO_ATOMIC_STRIPED_SPIN_LOCKS
+#define PICO_ATOMIC_STRIPED_SPIN_LOCKS 0
+#endif
+
+// PICO_CONFIG: PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT, Number of spin locks from PICO_SPINLOCK_ID_STRIPED_FIRST onwards used when PICO_ATOMIC_STRIPED_SPIN_LOCKS is 1, type=int, min=1, default=the size of the striped range, group=pico_atomic
+#ifndef PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT
+#define PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT (PICO_SPINLOCK_ID_STRIPED_LAST + 1 - PICO_SPINLOCK_ID_STRIPED_FIRST)
+#endif
+
+#if PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT < 1 || PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT > PICO_SPINLOCK_ID_STRIPED_LAST + 1 - PICO_SPINLOCK_ID_STRIPED_FIRST
+#error PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT must be between 1 and the number of spin locks in the striped range
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief Return the striped spin lock number for an atomic object
+ *  \ingroup pico_atomic
+ *
+ * The address is hashed so that both consecutive words, and objects at a regular stride (e.g. the same member of
+ * each element of an array of structs), spread across the spin locks.
+ *
+ * \param ptr the address of the start of the atomic object
+ * \return a spin lock number from \ref PICO_SPINLOCK_ID_STRIPED_FIRST to
+ * \ref PICO_SPINLOCK_ID_STRIPED_FIRST + \ref PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT - 1
+ */
+static inline uint atomic_striped_spin_lock_num(const volatile void *ptr) {
+    uint32_t hash = ((uint32_t)(uintptr_t)ptr >> 2) * 0x9e3779b1u;
+    // scale the top 16 bits of the hash to the number of spin locks, avoiding a division
+    return PICO_SPINLOCK_ID_STRIPED_FIRST + (((hash >> 16) * PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT) >> 16);
+}
+
+/*! \brief Return the number of the spin lock which protects an atomic object
+ *  \ingroup pico_atomic
+ *
+ * \param ptr the address of the start of the atomic object
+ * \return \ref atomic_striped_spin_lock_num(ptr) if \ref PICO_ATOMIC_STRIPED_SPIN_LOCKS is 1, otherwise
+ * \ref PICO_SPINLOCK_ID_ATOMIC
+ */
+static inline uint atomic_spin_lock_num(__unused const volatile void *ptr) {
+#if PICO_ATOMIC_STRIPED_SPIN_LOCKS
+    return atomic_striped_spin_lock_num(ptr);
+#else
+    return PICO_SPINLOCK_ID_ATOMIC;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -21,6 +21,9 @@ extern "C" {
  * On RP2040 a spin lock is used as protection for all atomic operations, since there is no C library support.
  * \endif
  *
+ * By default this is the single spin lock \ref PICO_SPINLOCK_ID_ATOMIC; see pico/atomic.h for spreading atomic objects
+ * across several spin locks instead.
+ *
  * \if rp2350_specific
  * On RP2350 the C-library provides implementations for all 1-byte, 2-byte and 4-byte atomics using processor
  * exclusive operations. This library provides a spin-lock protected version for arbitrary-sized atomics (including 64-bit).
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include "pico/boot_profile.h"
+#include "pico/binary_info.h"
+#include "hardware/clocks.h"
+#ifdef __riscv
+#include "hardware/riscv.h"
+#else
+#include "pico/platform/cpu_regs.h"
+#include "hardware/structs/systick.h"
+#endif
+
+typedef struct {
+    const char *label;          // for crt0 steps
+    const uintptr_t *slot;      // for initializers; the label is looked up when asked for
+    uint32_t cycles;
+    uint32_t sys_hz;
+} boot_profile_entry_t;
+
+// Written by crt0 before .bss is cleared: the cycle counts at the start of the .data copy, the end of the .data copy,
+// and the end of the .bss clear, followed by BOOT_PROFILE_CRT0_MARKS_VALID
+uint32_t __uninitialized_ram(boot_profile_crt0_marks)[4];
+
+static boot_profile_entry_t boot_profile_entries[PICO_BOOT_PROFILE_MAX_RECORDS];
+
+static struct {
+    uint32_t last_cycles;
+    uint count;
+    uint dropped;
+    bool running;
+    bool done;
+} boot_profile;
+
+static inline uint32_t read_cycles(void) {
+#ifdef __riscv
+    return riscv_read_csr(mcycle);
+#else
+    return systick_hw->cvr;
+#endif
+}
+
+static inline uint32_t cycles_between(uint32_t from, uint32_t to) {
+#ifdef __riscv
+    return to - from;
+#else
+    // SysTick counts down, over 24 bits
+    return (from - to) & ARM_CPU_PREFIXED(SYST_CVR_BITS);
+#endif
+}
+
+static void start_cycle_counter(void) {
+#ifdef __riscv
+    riscv_clear_csr(mcountinhibit, RVCSR_MCOUNTINHIBIT_CY_BITS);
+#else
+    systick_hw->rvr = ARM_CPU_PREFIXED(SYST_RVR_RELOAD_BITS);
+    systick_hw->cvr = 0;
+    systick_hw->csr = ARM_CPU_PREFIXED(SYST_CSR_CLKSOURCE_BITS) | ARM_CPU_PREFIXED(SYST_CSR_ENABLE_BITS);
+#endif
+}
+
+static void stop_cycle_counter(void) {
+#ifdef __riscv
+    riscv_set_csr(mcountinhibit, RVCSR_MCOUNTINHIBIT_CY_BITS);
+#else
+    systick_hw->csr = 0;
+#endif
+}
+
+static void add_entry(const char *label, const uintptr_t *slot, uint32_t cycles) {
+    if (boot_profile.count == PICO_BOOT_PROFILE_MAX_RECORDS) {
+        boot_profile.dropped++;
+        return;
+    }
+    boot_profile_entry_t *entry = &boot_profile_entries[boot_profile.count++];
+    entry->label = label;
+    entry->slot = slot;
+    entry->cycles = cycles;
+    entry->sys_hz = clock_get_hz(clk_sys);
+}
+
+void boot_profile_initializers_starting(void) {
+    // only profile the first run, not e.g. a call to runtime_init() after a watchdog reboot via scratch vector
+    if (boot_profile.done) return;
+    uint32_t now;
+    if (boot_profile_crt0_marks[3] == BOOT_PROFILE_CRT0_MARKS_VALID) {
+        boot_profile_crt0_marks[3] = 0;
+        now = read_cycles();
+        add_entry("crt0 copy_data", NULL, cycles_between(boot_profile_crt0_marks[0], boot_profile_crt0_marks[1]));
+        add_entry("crt0 clear_bss", NULL, cycles_between(boot_profile_crt0_marks[1], boot_profile_crt0_marks[2]));
+        add_entry("crt0 runtime_init", NULL, cycles_between(boot_profile_crt0_marks[2], now));
+    } else {
+        // the crt0 in use doesn't support profiling, so start from here
+        start_cycle_counter();
+    }
+    boot_profile.running = true;
+    boot_profile.last_cycles = read_cycles();
+}
+
+void boot_profile_initializer_done(const uintptr_t *slot) {
+    if (!boot_profile.running) return;
+    add_entry(NULL, slot, cycles_between(boot_profile.last_cycles, read_cycles()));
+    // don't count the time taken to record the entry against the next initializer
+    boot_profile.last_cycles = read_cycles();
+}
+
+void boot_profile_initializers_done(void) {
+    if (!boot_profile.running) return;
+    boot_profile.running = false;
+    boot_profile.done = true;
+    stop_cycle_counter();
+}
+
+#if !PICO_NO_BINARY_INFO
+extern binary_info_t *__binary_info_start[];
+extern binary_info_t *__binary_info_end[];
+#endif
+
+static const char *initializer_label(const uintptr_t *slot) {
+#if !PICO_NO_BINARY_INFO
+    for (binary_info_t **bi = __binary_info_start; bi < __binary_info_end; bi++) {
+        const binary_info_ptr_int32_with_name_t *entry = (const binary_info_ptr_int32_with_name_t *)*bi;
+        if (entry->core.type == BINARY_INFO_TYPE_PTR_INT32_WITH_NAME &&
+            entry->core.tag == BINARY_INFO_TAG_RASPBERRY_PI &&
+            entry->id == BINARY_INFO_ID_RP_RUNTIME_INITIALIZER &&
+            (const void *)entry->value == (const void *)slot) {
+            return entry->label;
+        }
+    }
+#else
+    (void)slot;
+#endif
+    return NULL;
+}
+
+uint boot_profile_get_count(void) {
+    return boot_profile.count;
+}
+
+uint boot_profile_get_dropped_count(void) {
+    return boot_profile.dropped;
+}
+
+bool boot_profile_get_record(uint index, boot_profile_record_t *record) {
+    if (index >= boot_profile.count) return false;
+    const boot_profile_entry_t *entry = &boot_profile_entries[index];
+    if (entry->slot) {
+        record->label = initializer_label(entry->slot);
+        record->func = *entry->slot;
+    } else {
+        record->label = entry->label;
+        record->func = 0;
+    }
+    record->cycles = entry->cycles;
+    record->sys_hz = entry->sys_hz;
+    return true;
+}
+
+void boot_profile_print(void) {
+    printf("boot_profile: begin %u %u\n", boot_profile.count, boot_profile.dropped);
+    for (uint i = 0; i < boot_profile.count; i++) {
+        boot_profile_record_t record;
+        boot_profile_get_record(i, &record);
+        printf("boot_profile: %u 0x%08x %u %u %s\n", i, (uint)record.func, (uint)record.cycles, (uint)record.sys_hz,
+               record.label ? record.label : "-");
+    }
+    printf("boot_profile: end\n");
+}
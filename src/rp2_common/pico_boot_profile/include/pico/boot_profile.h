@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_BOOT_PROFILE_H
+#define _PICO_BOOT_PROFILE_H
+
+#include "pico.h"
+
+/** \file pico/boot_profile.h
+ *  \defgroup pico_boot_profile pico_boot_profile
+ *
+ * \brief Measure how long each step of the C runtime startup takes
+ *
+ * Linking this library into a binary makes the startup code time:
+ *
+ * - the crt0 copy of .data (and other RAM sections) from flash, and the clearing of .bss
+ * - the entry to `runtime_init` up to its first initializer (e.g. installing the stack guard)
+ * - each initializer in the `__preinit_array` (i.e. those registered with \ref PICO_RUNTIME_INIT_FUNC), in priority
+ *   order
+ *
+ * The times are recorded in a table in RAM, which can be read with \ref boot_profile_get_record, or printed with
+ * \ref boot_profile_print for `tools/boot_profile.py` to turn into a report. The bootrom and boot2, and the
+ * `__init_array` (C++ static constructors) which runs after the initializers, are not timed.
+ *
+ * Each initializer is named by its priority string and function name (e.g. "00051 runtime_init_per_core_bootrom_reset").
+ * These are added as binary info when this library is linked, so they are also visible to picotool; initializers
+ * registered from assembly, or in binaries built with PICO_NO_BINARY_INFO=1, are only identified by their address.
+ *
+ * Times are measured in core clock cycles, using SysTick on Arm and `mcycle` on RISC-V, and each record also notes the
+ * clk_sys frequency at the end of the step, if it was known by then (i.e. after `runtime_init_clocks`). On Arm, SysTick
+ * is 24 bits, so each step must take less than 2^24 cycles for its time to be correct. SysTick is stopped again once
+ * the initializers have run.
+ *
+ * This library has no effect on a binary which does not link it.
+ */
+
+// PICO_CONFIG: PICO_BOOT_PROFILE_MAX_RECORDS, Maximum number of steps recorded by the boot profiler; later steps are counted but not recorded, type=int, min=4, default=48, group=pico_boot_profile
+#ifndef PICO_BOOT_PROFILE_MAX_RECORDS
+#define PICO_BOOT_PROFILE_MAX_RECORDS 48
+#endif
+
+// Stored by crt0 after its cycle counts in boot_profile_crt0_marks[], to say they are valid
+#define BOOT_PROFILE_CRT0_MARKS_VALID 0xb007f11e
+
+#ifndef __ASSEMBLER__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief A timed step of the startup
+ *  \ingroup pico_boot_profile
+ */
+typedef struct boot_profile_record {
+    const char *label;  ///< "<priority> <name>" for an initializer, "crt0 <step>" for the startup code, or NULL for an unnamed initializer
+    uintptr_t func;     ///< the initializer's address, or 0 if this is not an initializer
+    uint32_t cycles;    ///< how many core clock cycles the step took
+    uint32_t sys_hz;    ///< the clk_sys frequency at the end of the step, or 0 if it was not known
+} boot_profile_record_t;
+
+/*! \brief The number of steps recorded
+ *  \ingroup pico_boot_profile
+ */
+uint boot_profile_get_count(void);
+
+/*! \brief The number of steps which took place but could not be recorded, as the table was full
+ *  \ingroup pico_boot_profile
+ *
+ * \sa PICO_BOOT_PROFILE_MAX_RECORDS
+ */
+uint boot_profile_get_dropped_count(void);
+
+/*! \brief Get a recorded step
+ *  \ingroup pico_boot_profile
+ *
+ * \param index the step's index, in the order the steps ran
+ * \param record filled in with the step
+ * \return true if index is less than \ref boot_profile_get_count
+ */
+bool boot_profile_get_record(uint index, boot_profile_record_t *record);
+
+/*! \brief The time a step took in microseconds
+ *  \ingroup pico_boot_profile
+ *
+ * \param record the step
+ * \return the time, or 0 if the clk_sys frequency was not known at the end of the step
+ */
+static inline uint32_t boot_profile_record_us(const boot_profile_record_t *record) {
+    return record->sys_hz ? (uint32_t)(((uint64_t)record->cycles * 1000000u) / record->sys_hz) : 0;
+}
+
+/*! \brief Print the recorded steps with printf
+ *  \ingroup pico_boot_profile
+ *
+ * Each line of the output starts with "boot_profile:", so the output can be captured along with any other output,
+ * and passed to `tools/boot_profile.py` to produce a report.
+ */
+void boot_profile_print(void);
+
+// Called by the runtime; not for use by the application
+void boot_profile_initializers_starting(void);
+void boot_profile_initializer_done(const uintptr_t *slot);
+void boot_profile_initializers_done(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ASSEMBLER__
+
+#endif
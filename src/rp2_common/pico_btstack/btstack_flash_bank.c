@@ -8,12 +8,15 @@
 #include "pico/flash.h"
 #include "hardware/sync.h"
 #include "hardware/flash.h"
+#include "btstack_run_loop.h"
 #include <string.h>
 
 // Check sizes
 static_assert(PICO_FLASH_BANK_TOTAL_SIZE % (FLASH_SECTOR_SIZE * 2) == 0, "PICO_FLASH_BANK_TOTAL_SIZE invalid");
 static_assert(PICO_FLASH_BANK_TOTAL_SIZE <= PICO_FLASH_SIZE_BYTES, "PICO_FLASH_BANK_TOTAL_SIZE too big");
 
+static_assert(FLASH_PAGE_SIZE == PICO_FLASH_BANK_CACHE_PAGE_SIZE, "PICO_FLASH_BANK_CACHE_PAGE_SIZE mismatch");
+
 // Size of one bank
 #define PICO_FLASH_BANK_SIZE (PICO_FLASH_BANK_TOTAL_SIZE / 2)
 
@@ -37,17 +40,74 @@ typedef struct {
     bool op_is_erase;
     uintptr_t p0;
     uintptr_t p1;
+    uint count;
 } mutation_operation_t;
 
 static void pico_flash_bank_perform_flash_mutation_operation(void *param) {
     const mutation_operation_t *mop = (const mutation_operation_t *)param;
     if (mop->op_is_erase) {
-        flash_range_erase(mop->p0, PICO_FLASH_BANK_SIZE);
+        flash_range_erase(mop->p0, mop->p1);
     } else {
-        flash_range_program(mop->p0, (const uint8_t *)mop->p1, FLASH_PAGE_SIZE);
+        // all the cached pages are programmed in the one lockout
+        const pico_flash_bank_cache_page_t *pages = (const pico_flash_bank_cache_page_t *)mop->p1;
+        for (uint i = 0; i < mop->count; i++) {
+            flash_range_program(pages[i].offset, pages[i].data, FLASH_PAGE_SIZE);
+        }
+    }
+}
+
+static void pico_flash_bank_cache_read_flash(__unused void *context, uint32_t offset, uint8_t *buffer, uint32_t size) {
+    // Flash is xip
+    memcpy(buffer, (void *)(XIP_BASE + offset), size);
+}
+
+static void pico_flash_bank_cache_program_flash(__unused void *context, const pico_flash_bank_cache_page_t *pages, uint count) {
+    mutation_operation_t mop = {
+            .op_is_erase = false,
+            .p1 = (uintptr_t)pages,
+            .count = count,
+    };
+    // todo choice of timeout and check return code... currently we have no way to return an error
+    //      to the caller anyway. flash_safe_execute asserts by default on problem other than timeout,
+    //      so that's fine for now, and UINT32_MAX is a timeout of 49 days which seems long enough
+    flash_safe_execute(pico_flash_bank_perform_flash_mutation_operation, &mop, UINT32_MAX);
+}
+
+static void pico_flash_bank_cache_erase_flash(__unused void *context, uint32_t offset, uint32_t size) {
+    mutation_operation_t mop = {
+            .op_is_erase = true,
+            .p0 = offset,
+            .p1 = size,
+    };
+    // todo as above
+    flash_safe_execute(pico_flash_bank_perform_flash_mutation_operation, &mop, UINT32_MAX);
+}
+
+static const pico_flash_bank_cache_ops_t pico_flash_bank_cache_ops = {
+    .read = pico_flash_bank_cache_read_flash,
+    .program = pico_flash_bank_cache_program_flash,
+    .erase = pico_flash_bank_cache_erase_flash,
+};
+
+static pico_flash_bank_cache_t pico_flash_bank_cache;
+static bool pico_flash_bank_flush_scheduled;
+
+static pico_flash_bank_cache_t *get_cache(void) {
+    if (!pico_flash_bank_cache.ops) {
+        pico_flash_bank_cache_init(&pico_flash_bank_cache, &pico_flash_bank_cache_ops, NULL);
     }
+    return &pico_flash_bank_cache;
+}
+
+static void pico_flash_bank_flush_callback(__unused void *context) {
+    pico_flash_bank_flush_scheduled = false;
+    pico_flash_bank_flush();
 }
 
+static btstack_context_callback_registration_t pico_flash_bank_flush_registration = {
+    .callback = pico_flash_bank_flush_callback,
+};
+
 #ifndef pico_flash_bank_get_storage_offset_func
 static inline uint32_t pico_flash_bank_get_fixed_storage_offset(void) {
     static_assert(PICO_FLASH_BANK_STORAGE_OFFSET + PICO_FLASH_BANK_TOTAL_SIZE <= PICO_FLASH_SIZE_BYTES, "PICO_FLASH_BANK_TOTAL_SIZE too big");
@@ -66,14 +126,8 @@ extern uint32_t pico_flash_bank_get_storage_offset_func(void);
 static void pico_flash_bank_erase(void * context, int bank) {
     (void)(context);
     DEBUG_PRINT("erase: bank %d\n", bank);
-    mutation_operation_t mop = {
-            .op_is_erase = true,
-            .p0 = pico_flash_bank_get_storage_offset_func() + (PICO_FLASH_BANK_SIZE * bank),
-    };
-    // todo choice of timeout and check return code... currently we have no way to return an error
-    //      to the caller anyway. flash_safe_execute asserts by default on problem other than timeout,
-    //      so that's fine for now, and UINT32_MAX is a timeout of 49 days which seems long enough
-    flash_safe_execute(pico_flash_bank_perform_flash_mutation_operation, &mop, UINT32_MAX);
+    pico_flash_bank_cache_erase(get_cache(), pico_flash_bank_get_storage_offset_func() + (PICO_FLASH_BANK_SIZE * bank),
+                                PICO_FLASH_BANK_SIZE);
 }
 
 static void pico_flash_bank_read(void *context, int bank, uint32_t offset, uint8_t *buffer, uint32_t size) {
@@ -89,8 +143,8 @@ static void pico_flash_bank_read(void *context, int bank, uint32_t offset, uint8
     assert((offset + size) <= PICO_FLASH_BANK_SIZE);
     if ((offset + size) > PICO_FLASH_BANK_SIZE) return;
 
-    // Flash is xip
-    memcpy(buffer, (void *)(XIP_BASE + pico_flash_bank_get_storage_offset_func() + (PICO_FLASH_BANK_SIZE * bank) + offset), size);
+    pico_flash_bank_cache_read(get_cache(), pico_flash_bank_get_storage_offset_func() + (PICO_FLASH_BANK_SIZE * bank) + offset,
+                               buffer, size);
 }
 
 static void pico_flash_bank_write(void * context, int bank, uint32_t offset, const uint8_t *data, uint32_t size) {
@@ -108,60 +162,14 @@ static void pico_flash_bank_write(void * context, int bank, uint32_t offset, con
 
     if (size == 0) return;
 
-    // calc bank start position
-    const uint32_t bank_start_pos = pico_flash_bank_get_storage_offset_func() + (PICO_FLASH_BANK_SIZE * bank);
-
-    // Calculate first and last page in the bank
-    const uint32_t first_page = offset / FLASH_PAGE_SIZE;
-    const uint32_t last_page = (offset + size + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE;
-
-    // Now we only care about the offset in the first page
-    offset %= FLASH_PAGE_SIZE;
+    pico_flash_bank_cache_write(get_cache(), pico_flash_bank_get_storage_offset_func() + (PICO_FLASH_BANK_SIZE * bank) + offset,
+                                data, size);
 
-    // Amount of data we've copied
-    uint32_t data_pos = 0;
-    uint32_t size_left = size;
-
-    // Write all the pages required
-    for(uint32_t page = first_page; page < last_page; page++) {
-        uint8_t page_data[FLASH_PAGE_SIZE];
-
-        assert(data_pos < size && size_left <= size);
-
-        // Copy data we're not going to overwrite in the first page
-        if (page == first_page && offset > 0) {
-            memcpy(page_data,
-                (void *)(XIP_BASE + bank_start_pos + (page * FLASH_PAGE_SIZE)),
-                offset);
-        }
-
-        // Copy the data we're not going to overwrite in the last page
-        if (page == last_page - 1 && (offset + size_left) < FLASH_PAGE_SIZE) {
-            memcpy(page_data + offset + size_left,
-                (void *)(XIP_BASE + bank_start_pos + (page * FLASH_PAGE_SIZE) + offset + size_left),
-                FLASH_PAGE_SIZE - offset - size_left);
-        }
-
-        // Now copy the new data into the page
-        const uint32_t size_to_copy = MIN(size_left, FLASH_PAGE_SIZE - offset);
-        memcpy(page_data + offset, data + data_pos, size_to_copy);
-
-        data_pos += size_to_copy;
-        size_left -= size_to_copy;
-
-        // zero offset for the following pages
-        offset = 0;
-
-        // Now program the entire page
-        mutation_operation_t mop = {
-                .op_is_erase = false,
-                .p0 = bank_start_pos + (page * FLASH_PAGE_SIZE),
-                .p1 = (uintptr_t)page_data
-        };
-        // todo choice of timeout and check return code... currently we have no way to return an error
-        //      to the caller anyway. flash_safe_execute asserts by default on problem other than timeout,
-        //      so that's fine for now, and UINT32_MAX is a timeout of 49 days which seems long enough
-        flash_safe_execute(pico_flash_bank_perform_flash_mutation_operation, &mop, UINT32_MAX);
+    // A TLV update is made up of several writes, so rather than programming each of them, commit them together once
+    // control returns to the run loop
+    if (pico_flash_bank_cache_is_dirty(&pico_flash_bank_cache) && !pico_flash_bank_flush_scheduled) {
+        pico_flash_bank_flush_scheduled = true;
+        btstack_run_loop_execute_on_main_thread(&pico_flash_bank_flush_registration);
     }
 }
 
@@ -176,3 +184,15 @@ static const hal_flash_bank_t pico_flash_bank_instance_obj = {
 const hal_flash_bank_t *pico_flash_bank_instance(void) {
     return &pico_flash_bank_instance_obj;
 }
+
+void pico_flash_bank_flush(void) {
+    pico_flash_bank_cache_flush(get_cache());
+}
+
+void pico_flash_bank_get_stats(pico_flash_bank_cache_stats_t *stats) {
+    pico_flash_bank_cache_get_stats(get_cache(), stats);
+}
+
+void pico_flash_bank_reset_stats(void) {
+    pico_flash_bank_cache_reset_stats(get_cache());
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/btstack_flash_bank_cache.h"
+#include "pico/time.h"
+
+#define CACHE_CAPACITY (PICO_FLASH_BANK_CACHE_PAGES ? PICO_FLASH_BANK_CACHE_PAGES : 1)
+
+void pico_flash_bank_cache_init(pico_flash_bank_cache_t *cache, const pico_flash_bank_cache_ops_t *ops, void *context) {
+    memset(cache, 0, sizeof(*cache));
+    cache->ops = ops;
+    cache->context = context;
+}
+
+static void record_lockout(pico_flash_bank_cache_t *cache, absolute_time_t start) {
+    int64_t us = absolute_time_diff_us(start, get_absolute_time());
+    cache->stats.lockout_us += (uint64_t)us;
+    if (us > (int64_t)cache->stats.max_lockout_us) cache->stats.max_lockout_us = (uint32_t)us;
+}
+
+void pico_flash_bank_cache_flush(pico_flash_bank_cache_t *cache) {
+    if (!cache->count) return;
+    absolute_time_t start = get_absolute_time();
+    cache->ops->program(cache->context, cache->pages, cache->count);
+    record_lockout(cache, start);
+    cache->stats.commits++;
+    cache->stats.pages_programmed += cache->count;
+    cache->count = 0;
+}
+
+static int find_page(const pico_flash_bank_cache_t *cache, uint32_t page_offset) {
+    for (uint i = 0; i < cache->count; i++) {
+        if (cache->pages[i].offset == page_offset) return (int)i;
+    }
+    return -1;
+}
+
+void pico_flash_bank_cache_read(pico_flash_bank_cache_t *cache, uint32_t offset, uint8_t *buffer, uint32_t size) {
+    cache->ops->read(cache->context, offset, buffer, size);
+    // overlay anything not yet programmed
+    for (uint i = 0; i < cache->count; i++) {
+        const pico_flash_bank_cache_page_t *page = &cache->pages[i];
+        uint32_t start = MAX(offset, page->offset);
+        uint32_t end = MIN(offset + size, page->offset + PICO_FLASH_BANK_CACHE_PAGE_SIZE);
+        if (start < end) {
+            memcpy(buffer + (start - offset), page->data + (start - page->offset), end - start);
+        }
+    }
+}
+
+void pico_flash_bank_cache_write(pico_flash_bank_cache_t *cache, uint32_t offset, const uint8_t *data, uint32_t size) {
+    cache->stats.writes++;
+    while (size) {
+        uint32_t page_offset = offset & ~(PICO_FLASH_BANK_CACHE_PAGE_SIZE - 1);
+        uint32_t in_page = offset - page_offset;
+        uint32_t len = MIN(size, PICO_FLASH_BANK_CACHE_PAGE_SIZE - in_page);
+        int index = find_page(cache, page_offset);
+        if (index >= 0 && (uint)index != cache->count - 1) {
+            // this page was dirtied before the last one, so programming the pages in order would make this write
+            // durable before an earlier one; commit what we have first
+            pico_flash_bank_cache_flush(cache);
+            index = -1;
+        }
+        if (index < 0) {
+            if (cache->count == CACHE_CAPACITY) {
+                pico_flash_bank_cache_flush(cache);
+            }
+            index = (int)cache->count++;
+            pico_flash_bank_cache_page_t *page = &cache->pages[index];
+            page->offset = page_offset;
+            // the rest of the page is programmed with what is already there
+            cache->ops->read(cache->context, page_offset, page->data, PICO_FLASH_BANK_CACHE_PAGE_SIZE);
+        }
+        memcpy(cache->pages[index].data + in_page, data, len);
+        cache->stats.pages_written++;
+        offset += len;
+        data += len;
+        size -= len;
+    }
+    if (!PICO_FLASH_BANK_CACHE_PAGES) {
+        pico_flash_bank_cache_flush(cache);
+    }
+}
+
+void pico_flash_bank_cache_erase(pico_flash_bank_cache_t *cache, uint32_t offset, uint32_t size) {
+    pico_flash_bank_cache_flush(cache);
+    absolute_time_t start = get_absolute_time();
+    cache->ops->erase(cache->context, offset, size);
+    record_lockout(cache, start);
+    cache->stats.erases++;
+}
+
+void pico_flash_bank_cache_get_stats(const pico_flash_bank_cache_t *cache, pico_flash_bank_cache_stats_t *stats) {
+    *stats = cache->stats;
+}
+
+void pico_flash_bank_cache_reset_stats(pico_flash_bank_cache_t *cache) {
+    memset(&cache->stats, 0, sizeof(cache->stats));
+}
@@ -10,6 +10,7 @@
 #include "pico.h"
 #include "hardware/flash.h"
 #include "hal_flash_bank.h"
+#include "pico/btstack_flash_bank_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,6 +42,31 @@ extern "C" {
  */
 const hal_flash_bank_t *pico_flash_bank_instance(void);
 
+/**
+ * \brief Program any writes held in the flash bank's write-back cache
+ * \ingroup pico_btstack
+ *
+ * Writes to the flash bank are held in RAM (see \ref btstack_flash_bank_cache and \c PICO_FLASH_BANK_CACHE_PAGES), so
+ * that the several writes making up a TLV update are programmed in one \ref flash_safe_execute call. They are
+ * committed automatically when control returns to the BTstack run loop; call this to make them durable sooner,
+ * e.g. before a reset or power down.
+ */
+void pico_flash_bank_flush(void);
+
+/**
+ * \brief Get statistics for the flash bank, including the pages programmed and the time spent with flash locked out
+ * \ingroup pico_btstack
+ *
+ * \param stats receives the statistics
+ */
+void pico_flash_bank_get_stats(pico_flash_bank_cache_stats_t *stats);
+
+/**
+ * \brief Reset the flash bank statistics to zero
+ * \ingroup pico_btstack
+ */
+void pico_flash_bank_reset_stats(void);
+
 #ifdef __cplusplus
 }
 #endif
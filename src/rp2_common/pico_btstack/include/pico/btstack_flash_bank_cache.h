@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_BTSTACK_FLASH_BANK_CACHE_H
+#define _PICO_BTSTACK_FLASH_BANK_CACHE_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/btstack_flash_bank_cache.h
+ *  \defgroup btstack_flash_bank_cache btstack_flash_bank_cache
+ *  \ingroup pico_btstack
+ *
+ * \brief RAM write-back cache of flash pages for the BTstack flash bank
+ *
+ * Writes are merged into RAM copies of the flash pages they touch, and the dirty pages are later programmed
+ * together by a single call to the backend's \c program function (i.e. in one flash lockout window), rather than
+ * one page at a time.
+ *
+ * To keep the flash in a state that a sequence of writes could have left it in had power been lost part way
+ * through, dirty pages are programmed in the order they were first written, and the cache is committed first
+ * whenever a write touches a dirty page other than the most recently dirtied one. The cache is also committed when
+ * it is full, before an erase, and on \ref pico_flash_bank_cache_flush. Reads see the cached data.
+ *
+ * The cache is portable, and talks to the flash through \ref pico_flash_bank_cache_ops_t, so it can be tested
+ * against a RAM model of the flash in host builds (as the pico_btstack_flash_bank_cache library).
+ */
+
+// PICO_CONFIG: PICO_FLASH_BANK_CACHE_PAGES, Number of flash pages the BTstack flash bank can hold in its RAM write-back cache; 0 programs every write immediately, type=int, min=0, default=4, group=pico_btstack
+#ifndef PICO_FLASH_BANK_CACHE_PAGES
+#define PICO_FLASH_BANK_CACHE_PAGES 4
+#endif
+
+/*! \brief Size of a flash page as seen by the cache, i.e. FLASH_PAGE_SIZE
+ *  \ingroup btstack_flash_bank_cache
+ */
+#define PICO_FLASH_BANK_CACHE_PAGE_SIZE 256u
+
+/*! \brief A cached flash page
+ *  \ingroup btstack_flash_bank_cache
+ */
+typedef struct pico_flash_bank_cache_page {
+    uint32_t offset;                                  ///< offset in flash of the page
+    uint8_t data[PICO_FLASH_BANK_CACHE_PAGE_SIZE];
+} pico_flash_bank_cache_page_t;
+
+/*! \brief Flash access functions used by the cache
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * Offsets are flash offsets, as passed to the cache functions.
+ */
+typedef struct pico_flash_bank_cache_ops {
+    /*! read \p size bytes of flash at \p offset into \p buffer */
+    void (*read)(void *context, uint32_t offset, uint8_t *buffer, uint32_t size);
+    /*! program \p count pages, in order; this is the flash lockout window the cache is trying to share */
+    void (*program)(void *context, const pico_flash_bank_cache_page_t *pages, uint count);
+    /*! erase \p size bytes of flash at \p offset (which are whole sectors) */
+    void (*erase)(void *context, uint32_t offset, uint32_t size);
+} pico_flash_bank_cache_ops_t;
+
+/*! \brief Statistics for a flash bank cache
+ *  \ingroup btstack_flash_bank_cache
+ */
+typedef struct pico_flash_bank_cache_stats {
+    uint32_t writes;           ///< write calls
+    uint32_t pages_written;    ///< pages touched by writes, i.e. what programming each write straight away would have programmed
+    uint32_t pages_programmed; ///< pages actually programmed
+    uint32_t commits;          ///< calls to the backend's program function
+    uint32_t erases;           ///< calls to the backend's erase function
+    uint32_t max_lockout_us;   ///< longest single program or erase call
+    uint64_t lockout_us;       ///< total time spent in program and erase calls
+} pico_flash_bank_cache_stats_t;
+
+/*! \brief Flash bank cache state
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * Treat as opaque; the fields may change between releases.
+ */
+typedef struct pico_flash_bank_cache {
+    const pico_flash_bank_cache_ops_t *ops;
+    void *context;
+    uint count;
+    pico_flash_bank_cache_page_t pages[PICO_FLASH_BANK_CACHE_PAGES ? PICO_FLASH_BANK_CACHE_PAGES : 1];
+    pico_flash_bank_cache_stats_t stats;
+} pico_flash_bank_cache_t;
+
+/*! \brief Initialize a cache
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * \param cache the cache
+ * \param ops the flash access functions
+ * \param context the context passed to the flash access functions
+ */
+void pico_flash_bank_cache_init(pico_flash_bank_cache_t *cache, const pico_flash_bank_cache_ops_t *ops, void *context);
+
+/*! \brief Read from flash, including any data still in the cache
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * \param cache the cache
+ * \param offset the flash offset to read from
+ * \param buffer receives the data
+ * \param size the number of bytes to read
+ */
+void pico_flash_bank_cache_read(pico_flash_bank_cache_t *cache, uint32_t offset, uint8_t *buffer, uint32_t size);
+
+/*! \brief Write to flash through the cache
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * As with programming the flash directly, the area should have been erased since it was last written.
+ *
+ * \param cache the cache
+ * \param offset the flash offset to write to
+ * \param data the data
+ * \param size the number of bytes to write
+ */
+void pico_flash_bank_cache_write(pico_flash_bank_cache_t *cache, uint32_t offset, const uint8_t *data, uint32_t size);
+
+/*! \brief Erase flash, first committing any cached writes
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * \param cache the cache
+ * \param offset the flash offset of the first sector to erase
+ * \param size the number of bytes to erase
+ */
+void pico_flash_bank_cache_erase(pico_flash_bank_cache_t *cache, uint32_t offset, uint32_t size);
+
+/*! \brief Program any cached writes to flash
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * \param cache the cache
+ */
+void pico_flash_bank_cache_flush(pico_flash_bank_cache_t *cache);
+
+/*! \brief Check whether the cache holds writes which have not been programmed
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * \param cache the cache
+ * \return true if \ref pico_flash_bank_cache_flush has anything to do
+ */
+static inline bool pico_flash_bank_cache_is_dirty(const pico_flash_bank_cache_t *cache) {
+    return cache->count != 0;
+}
+
+/*! \brief Get the cache's statistics
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * \param cache the cache
+ * \param stats receives the statistics
+ */
+void pico_flash_bank_cache_get_stats(const pico_flash_bank_cache_t *cache, pico_flash_bank_cache_stats_t *stats);
+
+/*! \brief Reset the cache's statistics to zero
+ *  \ingroup btstack_flash_bank_cache
+ *
+ * \param cache the cache
+ */
+void pico_flash_bank_cache_reset_stats(pico_flash_bank_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/clock_governor.h"
+#include "pico/pll_solver.h"
+#include "pico/time.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/spi.h"
+#include "hardware/sync.h"
+#include "hardware/uart.h"
+
+typedef struct {
+    uint32_t out_hz;
+    uint32_t vco_hz;
+    uint8_t postdiv1;
+    uint8_t postdiv2;
+    enum vreg_voltage voltage;
+} governor_level_t;
+
+typedef struct {
+    clock_governor_callback_t callback;
+    void *user_data;
+} governor_callback_t;
+
+// the baud rate of a peripheral, and the divisor which was programmed for it, so that adjusting the divisor back and
+// forth doesn't make the rate drift by rounding
+typedef struct {
+    uint32_t baud;
+    uint32_t divisor;
+} peripheral_rate_t;
+
+static governor_level_t levels[PICO_CLOCK_GOVERNOR_MAX_LEVELS];
+static uint level_count;
+static uint current_level;
+
+static governor_callback_t callbacks[PICO_CLOCK_GOVERNOR_MAX_CALLBACKS];
+
+static spin_lock_t *idle_lock;
+static uint32_t idle_us[NUM_CORES];
+static uint8_t idle_cores;
+static uint64_t last_update_us;
+static uint last_utilisation = 100;
+
+static repeating_timer_t update_timer;
+static bool started;
+
+static peripheral_rate_t uart_rates[NUM_UARTS];
+static peripheral_rate_t spi_rates[NUM_SPIS];
+
+bool clock_governor_init(const clock_governor_level_t *new_levels, uint new_level_count) {
+    if (!new_level_count || new_level_count > PICO_CLOCK_GOVERNOR_MAX_LEVELS) return false;
+    pll_solver_config_t config = pll_solver_get_default_config(XOSC_HZ);
+    config.vco_min_hz = PICO_PLL_VCO_MIN_FREQ_HZ;
+    config.vco_max_hz = PICO_PLL_VCO_MAX_FREQ_HZ;
+    // set_sys_clock_pll() always uses this REFDIV
+    config.lock_refdiv = PLL_SYS_REFDIV;
+    config.low_vco = PICO_CLOCK_GOVERNOR_LOW_VCO;
+    governor_level_t solved[PICO_CLOCK_GOVERNOR_MAX_LEVELS];
+    for (uint i = 0; i < new_level_count; i++) {
+        pll_solution_t solution;
+        if (!pll_solve(&config, new_levels[i].freq_hz, &solution)) return false;
+        if (i && solution.out_hz <= solved[i - 1].out_hz) return false;
+        solved[i].out_hz = solution.out_hz;
+        solved[i].vco_hz = solution.vco_hz;
+        solved[i].postdiv1 = solution.postdiv1;
+        solved[i].postdiv2 = solution.postdiv2;
+        solved[i].voltage = new_levels[i].voltage;
+    }
+    if (!idle_lock) idle_lock = spin_lock_init(next_striped_spin_lock_num());
+    for (uint i = 0; i < new_level_count; i++) levels[i] = solved[i];
+    level_count = new_level_count;
+    // make sure the clock is set, whatever it was before
+    current_level = level_count;
+    clock_governor_set_level(level_count - 1);
+    uint32_t save = spin_lock_blocking(idle_lock);
+    for (uint i = 0; i < NUM_CORES; i++) idle_us[i] = 0;
+    last_update_us = time_us_64();
+    spin_unlock(idle_lock, save);
+    return true;
+}
+
+uint clock_governor_get_level_count(void) {
+    return level_count;
+}
+
+uint32_t clock_governor_get_level_freq_hz(uint level) {
+    invalid_params_if(PICO_CLOCK_GOVERNOR, level >= level_count);
+    return levels[level].out_hz;
+}
+
+uint clock_governor_get_level(void) {
+    return current_level;
+}
+
+static void notify(clock_governor_event_t event, uint32_t old_hz, uint32_t new_hz) {
+    for (uint i = 0; i < PICO_CLOCK_GOVERNOR_MAX_CALLBACKS; i++) {
+        if (callbacks[i].callback) callbacks[i].callback(event, old_hz, new_hz, callbacks[i].user_data);
+    }
+}
+
+static uint32_t uart_divisor(uart_inst_t *uart) {
+    return (uart_get_hw(uart)->ibrd << 6) | uart_get_hw(uart)->fbrd;
+}
+
+static uint32_t spi_divisor(spi_inst_t *spi) {
+    return (spi_get_hw(spi)->cpsr << 8) | ((spi_get_hw(spi)->cr0 & SPI_SSPCR0_SCR_BITS) >> SPI_SSPCR0_SCR_LSB);
+}
+
+// Records the baud rate of each enabled UART and SPI, before the peripheral clock changes
+static void save_peripheral_rates(uint32_t peri_hz) {
+    for (uint i = 0; i < NUM_UARTS; i++) {
+        uart_inst_t *uart = UART_INSTANCE(i);
+        uint32_t divisor = uart_divisor(uart);
+        if (!uart_is_enabled(uart) || !divisor) {
+            uart_rates[i].baud = 0;
+        } else if (!uart_rates[i].baud || divisor != uart_rates[i].divisor) {
+            // see uart_set_baudrate()
+            uart_rates[i].baud = (uint32_t)((4ull * peri_hz) / divisor);
+        }
+    }
+    for (uint i = 0; i < NUM_SPIS; i++) {
+        spi_inst_t *spi = SPI_INSTANCE(i);
+        uint32_t divisor = spi_divisor(spi);
+        if (!(spi_get_hw(spi)->cr1 & SPI_SSPCR1_SSE_BITS) || !spi_get_hw(spi)->cpsr) {
+            spi_rates[i].baud = 0;
+        } else if (!spi_rates[i].baud || divisor != spi_rates[i].divisor) {
+            spi_rates[i].baud = spi_get_baudrate(spi);
+        }
+    }
+}
+
+// Re-derives the dividers of the UARTs and SPIs recorded by save_peripheral_rates() for the new peripheral clock
+static void restore_peripheral_rates(void) {
+    for (uint i = 0; i < NUM_UARTS; i++) {
+        if (!uart_rates[i].baud) continue;
+        uart_inst_t *uart = UART_INSTANCE(i);
+        uart_set_baudrate(uart, uart_rates[i].baud);
+        uart_rates[i].divisor = uart_divisor(uart);
+    }
+    for (uint i = 0; i < NUM_SPIS; i++) {
+        if (!spi_rates[i].baud) continue;
+        spi_inst_t *spi = SPI_INSTANCE(i);
+        spi_set_baudrate(spi, spi_rates[i].baud);
+        spi_rates[i].divisor = spi_divisor(spi);
+    }
+}
+
+void clock_governor_set_level(uint level) {
+    invalid_params_if(PICO_CLOCK_GOVERNOR, level >= level_count);
+    if (level == current_level) return;
+    const governor_level_t *to = &levels[level];
+    uint32_t old_hz = clock_get_hz(clk_sys);
+    notify(CLOCK_GOVERNOR_PRE_CHANGE, old_hz, to->out_hz);
+    uint32_t old_peri_hz = clock_get_hz(clk_peri);
+    save_peripheral_rates(old_peri_hz);
+    if (to->voltage > vreg_get_voltage()) {
+        vreg_set_voltage(to->voltage);
+        busy_wait_us_32(PICO_CLOCK_GOVERNOR_VREG_SETTLE_US);
+    }
+    set_sys_clock_pll(to->vco_hz, to->postdiv1, to->postdiv2);
+    if (to->voltage < vreg_get_voltage()) {
+        vreg_set_voltage(to->voltage);
+    }
+    // the peripheral clock only changes with the system clock if it is configured to
+    if (clock_get_hz(clk_peri) != old_peri_hz) {
+        restore_peripheral_rates();
+    }
+    current_level = level;
+    notify(CLOCK_GOVERNOR_POST_CHANGE, old_hz, to->out_hz);
+}
+
+void clock_governor_idle(void) {
+    // with interrupts disabled, the interrupt which ends the wait isn't handled until it has been timed
+    uint32_t save = save_and_disable_interrupts();
+    uint64_t start = time_us_64();
+    __wfi();
+    uint32_t elapsed = (uint32_t)(time_us_64() - start);
+    uint core_num = get_core_num();
+    spin_lock_unsafe_blocking(idle_lock);
+    idle_us[core_num] += elapsed;
+    idle_cores |= (uint8_t)(1u << core_num);
+    spin_unlock_unsafe(idle_lock);
+    restore_interrupts_from_disabled(save);
+}
+
+static uint choose_level(uint utilisation) {
+    if (utilisation > PICO_CLOCK_GOVERNOR_UP_THRESHOLD) return level_count - 1;
+    // the frequency at which the same work would have kept the busiest core busy for PICO_CLOCK_GOVERNOR_TARGET_LOAD
+    // percent of the time
+    uint64_t needed_hz = ((uint64_t)levels[current_level].out_hz * utilisation) / PICO_CLOCK_GOVERNOR_TARGET_LOAD;
+    uint level = 0;
+    while (level < current_level && levels[level].out_hz < needed_hz) level++;
+    return level;
+}
+
+uint clock_governor_update(void) {
+    invalid_params_if(PICO_CLOCK_GOVERNOR, !level_count);
+    uint32_t save = spin_lock_blocking(idle_lock);
+    uint64_t now = time_us_64();
+    uint32_t elapsed = (uint32_t)MIN(now - last_update_us, UINT32_MAX);
+    last_update_us = now;
+    uint utilisation = idle_cores ? 0 : 100;
+    for (uint i = 0; i < NUM_CORES; i++) {
+        if (idle_cores & (1u << i)) {
+            uint32_t busy = elapsed - MIN(idle_us[i], elapsed);
+            uint core_utilisation = elapsed ? (uint)(((uint64_t)busy * 100) / elapsed) : 100;
+            utilisation = MAX(utilisation, core_utilisation);
+        }
+        idle_us[i] = 0;
+    }
+    spin_unlock(idle_lock, save);
+    last_utilisation = utilisation;
+    clock_governor_set_level(choose_level(utilisation));
+    return current_level;
+}
+
+uint clock_governor_get_utilisation(void) {
+    return last_utilisation;
+}
+
+static bool update_timer_callback(__unused repeating_timer_t *rt) {
+    clock_governor_update();
+    return true;
+}
+
+bool clock_governor_start(uint32_t interval_ms) {
+    invalid_params_if(PICO_CLOCK_GOVERNOR, !level_count);
+    if (started) return false;
+    started = add_repeating_timer_ms((int32_t)interval_ms, update_timer_callback, NULL, &update_timer);
+    return started;
+}
+
+void clock_governor_stop(void) {
+    if (started) {
+        cancel_repeating_timer(&update_timer);
+        started = false;
+    }
+}
+
+bool clock_governor_add_callback(clock_governor_callback_t callback, void *user_data) {
+    for (uint i = 0; i < PICO_CLOCK_GOVERNOR_MAX_CALLBACKS; i++) {
+        if (!callbacks[i].callback) {
+            callbacks[i].user_data = user_data;
+            callbacks[i].callback = callback;
+            return true;
+        }
+    }
+    return false;
+}
+
+void clock_governor_remove_callback(clock_governor_callback_t callback, void *user_data) {
+    for (uint i = 0; i < PICO_CLOCK_GOVERNOR_MAX_CALLBACKS; i++) {
+        if (callbacks[i].callback == callback && callbacks[i].user_data == user_data) {
+            callbacks[i].callback = NULL;
+        }
+    }
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_CLOCK_GOVERNOR_H
+#define _PICO_CLOCK_GOVERNOR_H
+
+#include "pico.h"
+#include "hardware/vreg.h"
+
+/** \file pico/clock_governor.h
+ *  \defgroup pico_clock_governor pico_clock_governor
+ *
+ * \brief Dynamic frequency and voltage scaling of the system clock according to how busy the cores are
+ *
+ * The governor is given a table of operating levels, each a system clock frequency and the core voltage it needs,
+ * in increasing order of frequency. The PLL parameters for each are found once, by \ref pico_pll_solver, when the
+ * governor is initialised. Thereafter \ref clock_governor_update (called periodically, either by the application or
+ * from a repeating timer started by \ref clock_governor_start) measures the fraction of the time since the last update
+ * that the cores were busy, and changes level:
+ *
+ * * If the busiest core was busy for more than \ref PICO_CLOCK_GOVERNOR_UP_THRESHOLD percent of the time, the
+ *   highest level is chosen, so that a burst of work is finished as soon as possible.
+ * * Otherwise the lowest level at which the load would have kept the busiest core busy for no more than
+ *   \ref PICO_CLOCK_GOVERNOR_TARGET_LOAD percent of the time is chosen, if that is lower than the current one.
+ *
+ * A core's idle time is only measured while it is in \ref clock_governor_idle, which should be called by its idle
+ * loop in place of `__wfi()`. Cores which never call it are not counted; if neither does, the highest level is kept.
+ *
+ * When the level changes, the voltage is raised before the clock frequency is raised, and lowered after it is
+ * lowered. If the peripheral clock changed too (see PICO_CLOCK_ADJUST_PERI_CLOCK_WITH_SYS_CLOCK in hardware_clocks),
+ * the dividers of the enabled UARTs and SPIs are re-derived so that their baud rates are unchanged. Anything else which
+ * depends on the system clock (e.g. PIO or PWM dividers) can be adjusted by a callback registered with
+ * \ref clock_governor_add_callback.
+ *
+ * \note The levels must all be within what the flash interface (as configured at boot) supports, as with
+ * \ref set_sys_clock_hz. The UART and SPI baud rates are adjusted with the peripherals running, so a character
+ * being sent or received at that moment may be corrupted; use a callback to pause them if that matters.
+ */
+
+// PICO_CONFIG: PARAM_ASSERTIONS_ENABLED_PICO_CLOCK_GOVERNOR, Enable/disable assertions in the pico_clock_governor module, type=bool, default=0, group=pico_clock_governor
+#ifndef PARAM_ASSERTIONS_ENABLED_PICO_CLOCK_GOVERNOR
+#define PARAM_ASSERTIONS_ENABLED_PICO_CLOCK_GOVERNOR 0
+#endif
+
+// PICO_CONFIG: PICO_CLOCK_GOVERNOR_MAX_LEVELS, Maximum number of operating levels the clock governor can be given, type=int, min=1, default=8, group=pico_clock_governor
+#ifndef PICO_CLOCK_GOVERNOR_MAX_LEVELS
+#define PICO_CLOCK_GOVERNOR_MAX_LEVELS 8
+#endif
+
+// PICO_CONFIG: PICO_CLOCK_GOVERNOR_MAX_CALLBACKS, Maximum number of clock change callbacks which may be registered with the clock governor, type=int, min=0, default=4, group=pico_clock_governor
+#ifndef PICO_CLOCK_GOVERNOR_MAX_CALLBACKS
+#define PICO_CLOCK_GOVERNOR_MAX_CALLBACKS 4
+#endif
+
+// PICO_CONFIG: PICO_CLOCK_GOVERNOR_UP_THRESHOLD, Percentage of the time the busiest core must be busy for the clock governor to switch to the highest level, type=int, min=1, max=100, default=80, group=pico_clock_governor
+#ifndef PICO_CLOCK_GOVERNOR_UP_THRESHOLD
+#define PICO_CLOCK_GOVERNOR_UP_THRESHOLD 80
+#endif
+
+// PICO_CONFIG: PICO_CLOCK_GOVERNOR_TARGET_LOAD, Percentage of the time the clock governor aims to keep the busiest core busy when it lowers the level, type=int, min=1, max=100, default=70, group=pico_clock_governor
+#ifndef PICO_CLOCK_GOVERNOR_TARGET_LOAD
+#define PICO_CLOCK_GOVERNOR_TARGET_LOAD 70
+#endif
+
+// PICO_CONFIG: PICO_CLOCK_GOVERNOR_VREG_SETTLE_US, Number of microseconds to wait after raising the core voltage before raising the clock frequency, type=int, min=0, default=1000, group=pico_clock_governor
+#ifndef PICO_CLOCK_GOVERNOR_VREG_SETTLE_US
+#define PICO_CLOCK_GOVERNOR_VREG_SETTLE_US 1000
+#endif
+
+// PICO_CONFIG: PICO_CLOCK_GOVERNOR_LOW_VCO, Prefer PLL parameters with a lower VCO frequency (less power but more jitter) for the clock governor's levels, type=bool, default=0, group=pico_clock_governor
+#ifndef PICO_CLOCK_GOVERNOR_LOW_VCO
+#define PICO_CLOCK_GOVERNOR_LOW_VCO 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief An operating level of the clock governor
+ *  \ingroup pico_clock_governor
+ */
+typedef struct {
+    uint32_t freq_hz;          ///< the system clock frequency; the nearest the PLL can make is used
+    enum vreg_voltage voltage; ///< the core voltage needed to run at that frequency
+} clock_governor_level_t;
+
+/*! \brief When a clock change callback is called
+ *  \ingroup pico_clock_governor
+ */
+typedef enum {
+    CLOCK_GOVERNOR_PRE_CHANGE,  ///< the system clock is about to change
+    CLOCK_GOVERNOR_POST_CHANGE, ///< the system clock has changed, and the UART and SPI baud rates have been adjusted
+} clock_governor_event_t;
+
+/*! \brief Callback called before and after the system clock frequency is changed
+ *  \ingroup pico_clock_governor
+ *
+ * This is called from whichever context changed the level; from a timer interrupt if the governor was started by
+ * \ref clock_governor_start.
+ *
+ * \param event whether the clock is about to change or has changed
+ * \param old_hz the system clock frequency before the change
+ * \param new_hz the system clock frequency after the change
+ * \param user_data the value given to \ref clock_governor_add_callback
+ */
+typedef void (*clock_governor_callback_t)(clock_governor_event_t event, uint32_t old_hz, uint32_t new_hz,
+                                          void *user_data);
+
+/*! \brief Initialise the clock governor, and switch to the highest level
+ *  \ingroup pico_clock_governor
+ *
+ * The PLL parameters for each level are found with \ref pll_solve, using the system PLL's REFDIV.
+ *
+ * \param levels the operating levels, in increasing order of frequency; the table is copied
+ * \param level_count the number of levels; at most \ref PICO_CLOCK_GOVERNOR_MAX_LEVELS
+ * \return true if the governor was initialised; false if there are too many levels, they are not in increasing
+ * order of frequency, or a frequency can't be made by the PLL
+ */
+bool clock_governor_init(const clock_governor_level_t *levels, uint level_count);
+
+/*! \brief Get the number of levels the governor was initialised with
+ *  \ingroup pico_clock_governor
+ */
+uint clock_governor_get_level_count(void);
+
+/*! \brief Get the system clock frequency of a level
+ *  \ingroup pico_clock_governor
+ *
+ * \param level the level
+ * \return the frequency, which is the nearest the PLL can make to the one asked for
+ */
+uint32_t clock_governor_get_level_freq_hz(uint level);
+
+/*! \brief Get the current level
+ *  \ingroup pico_clock_governor
+ */
+uint clock_governor_get_level(void);
+
+/*! \brief Switch to a level
+ *  \ingroup pico_clock_governor
+ *
+ * This is done by \ref clock_governor_update, but may also be called directly (e.g. to fix the frequency for a
+ * while, having stopped the governor with \ref clock_governor_stop). It must not be called at the same time as itself
+ * or \ref clock_governor_update on the other core.
+ *
+ * \param level the level
+ */
+void clock_governor_set_level(uint level);
+
+/*! \brief Wait for an interrupt, counting the time waiting as idle
+ *  \ingroup pico_clock_governor
+ *
+ * This should be called by the calling core's idle loop in place of `__wfi()`. Interrupts are disabled while the
+ * time is measured, so the interrupt which ends the wait is handled before this returns, but isn't counted as idle
+ * time.
+ */
+void clock_governor_idle(void);
+
+/*! \brief Measure how busy the cores have been since the last update, and change level if need be
+ *  \ingroup pico_clock_governor
+ *
+ * \return the level, which may be unchanged
+ */
+uint clock_governor_update(void);
+
+/*! \brief Get the utilisation measured by the last \ref clock_governor_update
+ *  \ingroup pico_clock_governor
+ *
+ * \return the percentage of the time the busiest core was busy
+ */
+uint clock_governor_get_utilisation(void);
+
+/*! \brief Call \ref clock_governor_update periodically from a repeating timer on the default alarm pool
+ *  \ingroup pico_clock_governor
+ *
+ * \param interval_ms the interval between updates in milliseconds
+ * \return true if the timer was started; false if the governor is already started, or no alarm slot is free
+ */
+bool clock_governor_start(uint32_t interval_ms);
+
+/*! \brief Stop the repeating timer started by \ref clock_governor_start
+ *  \ingroup pico_clock_governor
+ *
+ * The current level is kept.
+ */
+void clock_governor_stop(void);
+
+/*! \brief Register a callback to be called before and after every change of the system clock frequency
+ *  \ingroup pico_clock_governor
+ *
+ * \param callback the callback
+ * \param user_data a value passed to the callback
+ * \return true if the callback was registered; false if \ref PICO_CLOCK_GOVERNOR_MAX_CALLBACKS are already registered
+ */
+bool clock_governor_add_callback(clock_governor_callback_t callback, void *user_data);
+
+/*! \brief Unregister a callback registered with \ref clock_governor_add_callback
+ *  \ingroup pico_clock_governor
+ *
+ * \param callback the callback
+ * \param user_data the value it was registered with
+ */
+void clock_governor_remove_callback(clock_governor_callback_t callback, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -13,12 +13,15 @@
 #include "hardware/clocks.h"
 #include "hardware/sync.h"
 #include "hardware/dma.h"
+#include "hardware/irq.h"
 #include "cyw43_bus_pio_spi.pio.h"
 #include "cyw43.h"
 #include "cyw43_internal.h"
 #include "cyw43_spi.h"
 #include "cyw43_debug_pins.h"
 #include "pico/cyw43_driver.h"
+#include "pico/cyw43_spi_queue.h"
+#include "pico/cyw43_spi_buf.h"
 
 #if CYW43_SPI_PIO
 
@@ -99,10 +102,23 @@ typedef struct {
     uint pio_sm;
     int8_t dma_out;
     int8_t dma_in;
+    int8_t spin_lock_num;
+    bool irq_handler_added;
+    bool rx_in_flight; // the transfer in flight has a receive phase
+    uint32_t transfer_seq; // incremented as each transfer starts
+    dma_channel_config out_config;
+    dma_channel_config in_config;
+    cyw43_spi_queue_t queue;
+    cyw43_spi_copy_stats_t copy_stats;
 } bus_data_t;
 
 static bus_data_t bus_data_instance;
 
+static void bus_start_transfer(cyw43_spi_queue_t *queue, const cyw43_spi_op_t *op);
+#if CYW43_SPI_DMA_IRQ_INDEX >= 0
+static void bus_dma_irq_handler(void);
+#endif
+
 int cyw43_spi_init(cyw43_int_t *self) {
     // Only does something if CYW43_LOGIC_DEBUG=1
     logic_debug_init();
@@ -113,6 +129,10 @@ int cyw43_spi_init(cyw43_int_t *self) {
     bus_data->pio = NULL;
     bus_data->dma_in = -1;
     bus_data->dma_out = -1;
+    bus_data->spin_lock_num = -1;
+    bus_data->irq_handler_added = false;
+    memset(&bus_data->copy_stats, 0, sizeof(bus_data->copy_stats));
+    cyw43_spi_queue_init(&bus_data->queue, bus_start_transfer, bus_data);
 
     const uint min_gpio = MIN(CYW43_PIN_WL_CLOCK, MIN(CYW43_PIN_WL_DATA_IN, CYW43_PIN_WL_DATA_OUT));
     const uint max_gpio = MAX(CYW43_PIN_WL_CLOCK, MAX(CYW43_PIN_WL_DATA_IN, CYW43_PIN_WL_DATA_OUT));
@@ -152,16 +172,49 @@ int cyw43_spi_init(cyw43_int_t *self) {
 
     bus_data->dma_out = (int8_t) dma_claim_unused_channel(false);
     bus_data->dma_in = (int8_t) dma_claim_unused_channel(false);
-    if (bus_data->dma_out < 0 || bus_data->dma_in < 0) {
+    bus_data->spin_lock_num = (int8_t) spin_lock_claim_unused(false);
+    if (bus_data->dma_out < 0 || bus_data->dma_in < 0 || bus_data->spin_lock_num < 0) {
         cyw43_spi_deinit(self);
         return CYW43_FAIL_FAST_CHECK(-CYW43_EIO);
     }
+
+    // The channel configurations are the same for every transfer
+    bus_data->out_config = dma_channel_get_default_config(bus_data->dma_out);
+    channel_config_set_bswap(&bus_data->out_config, true);
+    channel_config_set_dreq(&bus_data->out_config, pio_get_dreq(bus_data->pio, bus_data->pio_sm, true));
+
+    bus_data->in_config = dma_channel_get_default_config(bus_data->dma_in);
+    channel_config_set_bswap(&bus_data->in_config, true);
+    channel_config_set_dreq(&bus_data->in_config, pio_get_dreq(bus_data->pio, bus_data->pio_sm, false));
+    channel_config_set_write_increment(&bus_data->in_config, true);
+    channel_config_set_read_increment(&bus_data->in_config, false);
+
+#if CYW43_SPI_DMA_IRQ_INDEX >= 0
+    static_assert(CYW43_SPI_DMA_IRQ_INDEX < NUM_DMA_IRQS, "");
+    irq_add_shared_handler(DMA_IRQ_NUM(CYW43_SPI_DMA_IRQ_INDEX), bus_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_NUM(CYW43_SPI_DMA_IRQ_INDEX), true);
+    bus_data->irq_handler_added = true;
+    dma_irqn_set_channel_enabled(CYW43_SPI_DMA_IRQ_INDEX, (uint)bus_data->dma_out, true);
+    dma_irqn_set_channel_enabled(CYW43_SPI_DMA_IRQ_INDEX, (uint)bus_data->dma_in, true);
+#endif
     return 0;
 }
 
 void cyw43_spi_deinit(cyw43_int_t *self) {
     if (self->bus_data) {
         bus_data_t *bus_data = (bus_data_t *)self->bus_data;
+        if (bus_data->spin_lock_num >= 0) {
+            // let any queued transfers finish
+            cyw43_spi_transfer_wait(self);
+        }
+#if CYW43_SPI_DMA_IRQ_INDEX >= 0
+        if (bus_data->irq_handler_added) {
+            dma_irqn_set_channel_enabled(CYW43_SPI_DMA_IRQ_INDEX, (uint)bus_data->dma_out, false);
+            dma_irqn_set_channel_enabled(CYW43_SPI_DMA_IRQ_INDEX, (uint)bus_data->dma_in, false);
+            irq_remove_handler(DMA_IRQ_NUM(CYW43_SPI_DMA_IRQ_INDEX), bus_dma_irq_handler);
+            bus_data->irq_handler_added = false;
+        }
+#endif
         if (bus_data->pio) {
             pio_remove_program_and_unclaim_sm(&SPI_PROGRAM_FUNC, bus_data->pio, bus_data->pio_sm, bus_data->pio_offset);
             bus_data->pio = NULL;
@@ -176,6 +229,10 @@ void cyw43_spi_deinit(cyw43_int_t *self) {
             dma_channel_unclaim(bus_data->dma_in);
             bus_data->dma_in = -1;
         }
+        if (bus_data->spin_lock_num >= 0) {
+            spin_lock_unclaim(bus_data->spin_lock_num);
+            bus_data->spin_lock_num = -1;
+        }
         self->bus_data = NULL;
     }
 }
@@ -190,8 +247,7 @@ static __noinline void ns_delay(uint32_t ns) {
     busy_wait_at_least_cycles(cycles);
 }
 
-static void start_spi_comms(cyw43_int_t *self) {
-    bus_data_t *bus_data = (bus_data_t *)self->bus_data;
+static void start_spi_comms(bus_data_t *bus_data) {
     gpio_set_function(CYW43_PIN_WL_DATA_OUT, pio_get_funcsel(bus_data->pio));
     gpio_set_function(CYW43_PIN_WL_CLOCK, pio_get_funcsel(bus_data->pio));
     gpio_pull_down(CYW43_PIN_WL_CLOCK);
@@ -224,120 +280,236 @@ static void dump_bytes(const uint8_t *bptr, uint32_t len) {
 }
 #endif
 
-int cyw43_spi_transfer(cyw43_int_t *self, const uint8_t *tx, size_t tx_length, uint8_t *rx,
-                       size_t rx_length) {
-
-    if ((tx == NULL) && (rx == NULL)) {
-        return CYW43_FAIL_FAST_CHECK(-CYW43_EINVAL);
-    }
-
-    bus_data_t *bus_data = (bus_data_t *)self->bus_data;
-    start_spi_comms(self);
+// Program the state machine and start the DMA for a transfer; called with the bus spin lock held
+static void bus_start_transfer(cyw43_spi_queue_t *queue, const cyw43_spi_op_t *op) {
+    bus_data_t *bus_data = (bus_data_t *)queue->bus;
+    const uint8_t *tx = op->tx;
+    uint8_t *rx = op->rx;
+    size_t tx_length = op->tx_length;
+    size_t rx_length = op->rx_length;
+
+    start_spi_comms(bus_data);
+    bus_data->rx_in_flight = rx != NULL;
+    bus_data->transfer_seq++;
+    pio_sm_set_enabled(bus_data->pio, bus_data->pio_sm, false);
     if (rx != NULL) {
-        if (tx == NULL) {
+        if (tx == NULL && !op->header_length) {
             tx = rx;
             assert(tx_length && tx_length < rx_length);
         }
-        DUMP_SPI_TRANSACTIONS(
-                printf("[%lu] bus TX/RX %u bytes rx %u:", counter++, tx_length, rx_length);
-                dump_bytes(tx, tx_length);
-        )
-        assert(!(tx_length & 3));
-        assert(!(((uintptr_t)tx) & 3));
-        assert(!(((uintptr_t)rx) & 3));
-        assert(!(rx_length & 3));
-
-        pio_sm_set_enabled(bus_data->pio, bus_data->pio_sm, false);
         pio_sm_set_wrap(bus_data->pio, bus_data->pio_sm, bus_data->pio_offset, bus_data->pio_offset + SPI_OFFSET_END - 1);
-        pio_sm_clear_fifos(bus_data->pio, bus_data->pio_sm);
-        pio_sm_set_pindirs_with_mask64(bus_data->pio, bus_data->pio_sm, 1ull << CYW43_PIN_WL_DATA_OUT, 1ull << CYW43_PIN_WL_DATA_OUT);
-        pio_sm_restart(bus_data->pio, bus_data->pio_sm);
-        pio_sm_clkdiv_restart(bus_data->pio, bus_data->pio_sm);
-        pio_sm_put(bus_data->pio, bus_data->pio_sm, tx_length * 8 - 1);
-        pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_out(pio_x, 32));
-        pio_sm_put(bus_data->pio, bus_data->pio_sm, (rx_length - tx_length) * 8 - 1);
-        pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_out(pio_y, 32));
-        pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_jmp(bus_data->pio_offset));
-        dma_channel_abort(bus_data->dma_out);
+    } else {
+        pio_sm_set_wrap(bus_data->pio, bus_data->pio_sm, bus_data->pio_offset, bus_data->pio_offset + SPI_OFFSET_LP1_END - 1);
+    }
+    pio_sm_clear_fifos(bus_data->pio, bus_data->pio_sm);
+    pio_sm_set_pindirs_with_mask64(bus_data->pio, bus_data->pio_sm, 1ull << CYW43_PIN_WL_DATA_OUT, 1ull << CYW43_PIN_WL_DATA_OUT);
+    pio_sm_restart(bus_data->pio, bus_data->pio_sm);
+    pio_sm_clkdiv_restart(bus_data->pio, bus_data->pio_sm);
+    pio_sm_put(bus_data->pio, bus_data->pio_sm, (op->header_length + tx_length) * 8 - 1);
+    pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_out(pio_x, 32));
+    pio_sm_put(bus_data->pio, bus_data->pio_sm, rx != NULL ? (rx_length - tx_length) * 8 - 1 : 0);
+    pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_out(pio_y, 32));
+    pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_jmp(bus_data->pio_offset));
+    if (op->header_length) {
+        // ahead of the DMA in the FIFO, and byte swapped the same way the DMA swaps
+        pio_sm_put(bus_data->pio, bus_data->pio_sm, __builtin_bswap32(op->header));
+    }
+
+    dma_channel_abort(bus_data->dma_out);
+    if (tx_length) {
+        dma_channel_configure(bus_data->dma_out, &bus_data->out_config, &bus_data->pio->txf[bus_data->pio_sm], tx, tx_length / 4, true);
+    }
+    if (rx != NULL) {
         dma_channel_abort(bus_data->dma_in);
+        dma_channel_configure(bus_data->dma_in, &bus_data->in_config, rx + tx_length, &bus_data->pio->rxf[bus_data->pio_sm], rx_length / 4 - tx_length / 4, true);
+    }
 
-        dma_channel_config out_config = dma_channel_get_default_config(bus_data->dma_out);
-        channel_config_set_bswap(&out_config, true);
-        channel_config_set_dreq(&out_config, pio_get_dreq(bus_data->pio, bus_data->pio_sm, true));
-
-        dma_channel_configure(bus_data->dma_out, &out_config, &bus_data->pio->txf[bus_data->pio_sm], tx, tx_length / 4, true);
-
-        dma_channel_config in_config = dma_channel_get_default_config(bus_data->dma_in);
-        channel_config_set_bswap(&in_config, true);
-        channel_config_set_dreq(&in_config, pio_get_dreq(bus_data->pio, bus_data->pio_sm, false));
-        channel_config_set_write_increment(&in_config, true);
-        channel_config_set_read_increment(&in_config, false);
-        dma_channel_configure(bus_data->dma_in, &in_config, rx + tx_length, &bus_data->pio->rxf[bus_data->pio_sm], rx_length / 4 - tx_length / 4, true);
-
-        pio_sm_set_enabled(bus_data->pio, bus_data->pio_sm, true);
-        __compiler_memory_barrier();
-
-        dma_channel_wait_for_finish_blocking(bus_data->dma_out);
-        dma_channel_wait_for_finish_blocking(bus_data->dma_in);
-
-        __compiler_memory_barrier();
-        memset(rx, 0, tx_length); // make sure we don't have garbage in what would have been returned data if using real SPI
-    } else if (tx != NULL) {
-        DUMP_SPI_TRANSACTIONS(
-                printf("[%lu] bus TX only %u bytes:", counter++, tx_length);
-                dump_bytes(tx, tx_length);
-        )
-        assert(!(((uintptr_t)tx) & 3));
-        assert(!(tx_length & 3));
-        pio_sm_set_enabled(bus_data->pio, bus_data->pio_sm, false);
-        pio_sm_set_wrap(bus_data->pio, bus_data->pio_sm, bus_data->pio_offset, bus_data->pio_offset + SPI_OFFSET_LP1_END - 1);
-        pio_sm_clear_fifos(bus_data->pio, bus_data->pio_sm);
-        pio_sm_set_pindirs_with_mask64(bus_data->pio, bus_data->pio_sm, 1ull << CYW43_PIN_WL_DATA_OUT, 1ull << CYW43_PIN_WL_DATA_OUT);
-        pio_sm_restart(bus_data->pio, bus_data->pio_sm);
-        pio_sm_clkdiv_restart(bus_data->pio, bus_data->pio_sm);
-        pio_sm_put(bus_data->pio, bus_data->pio_sm, tx_length * 8 - 1);
-        pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_out(pio_x, 32));
-        pio_sm_put(bus_data->pio, bus_data->pio_sm, 0);
-        pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_out(pio_y, 32));
-        pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_jmp(bus_data->pio_offset));
-        dma_channel_abort(bus_data->dma_out);
-
-        dma_channel_config out_config = dma_channel_get_default_config(bus_data->dma_out);
-        channel_config_set_bswap(&out_config, true);
-        channel_config_set_dreq(&out_config, pio_get_dreq(bus_data->pio, bus_data->pio_sm, true));
-
-        dma_channel_configure(bus_data->dma_out, &out_config, &bus_data->pio->txf[bus_data->pio_sm], tx, tx_length / 4, true);
-
-        pio_sm_set_enabled(bus_data->pio, bus_data->pio_sm, true);
-        dma_channel_wait_for_finish_blocking(bus_data->dma_out);
-
-        uint32_t fdebug_tx_stall = 1u << (PIO_FDEBUG_TXSTALL_LSB + bus_data->pio_sm);
-        bus_data->pio->fdebug = fdebug_tx_stall;
-        while (!(bus_data->pio->fdebug & fdebug_tx_stall)) {
-            tight_loop_contents();
-        }
-        __compiler_memory_barrier();
+    pio_sm_set_enabled(bus_data->pio, bus_data->pio_sm, true);
+    __compiler_memory_barrier();
+}
+
+// Returns true once the DMA for the transfer in flight has finished; called with the bus spin lock held
+static bool bus_dma_finished(bus_data_t *bus_data) {
+    if (dma_channel_is_busy(bus_data->dma_out)) return false;
+    return !bus_data->rx_in_flight || !dma_channel_is_busy(bus_data->dma_in);
+}
+
+// For a transmit, the data must also have left the FIFO once the DMA has finished, which takes at most a few
+// microseconds. Called without the bus spin lock held; stops waiting if transfer seq is retired meanwhile
+static void bus_wait_tx_drained(bus_data_t *bus_data, uint32_t seq) {
+    uint32_t fdebug_tx_stall = 1u << (PIO_FDEBUG_TXSTALL_LSB + bus_data->pio_sm);
+    bus_data->pio->fdebug = fdebug_tx_stall;
+    while (!(bus_data->pio->fdebug & fdebug_tx_stall) && *(volatile uint32_t *)&bus_data->transfer_seq == seq) {
+        tight_loop_contents();
+    }
+}
+
+// Release the bus after a transfer; called with the bus spin lock held
+static void bus_finish_transfer(bus_data_t *bus_data) {
+    __compiler_memory_barrier();
+    if (!bus_data->rx_in_flight) {
         pio_sm_set_enabled(bus_data->pio, bus_data->pio_sm, false);
         pio_sm_set_consecutive_pindirs(bus_data->pio, bus_data->pio_sm, CYW43_PIN_WL_DATA_IN, 1, false);
-    } else if (rx != NULL) { /* currently do one at a time */
-        DUMP_SPI_TRANSACTIONS(
-                printf("[%lu] bus TX %u bytes:", counter++, rx_length);
-                dump_bytes(rx, rx_length);
-        )
-        panic_unsupported();
     }
     pio_sm_exec(bus_data->pio, bus_data->pio_sm, pio_encode_mov(pio_pins, pio_null)); // for next time we turn output on
-
     stop_spi_comms();
+}
+
+// Retire the transfer in flight if it has finished, starting the next one. Called both from the DMA IRQ handler
+// and by anyone waiting for a transfer, so that completion does not depend on the IRQ being serviced
+static bool bus_service(bus_data_t *bus_data) {
+    spin_lock_t *lock = spin_lock_instance((uint)bus_data->spin_lock_num);
+    cyw43_spi_op_t done;
+    bool retired = false;
+    uint32_t save = spin_lock_blocking(lock);
+    bool finished = !cyw43_spi_queue_is_idle(&bus_data->queue) && bus_dma_finished(bus_data);
+    if (finished && !bus_data->rx_in_flight) {
+        // wait for the FIFO to drain with the lock released, then check nobody else retired the transfer meanwhile
+        uint32_t seq = bus_data->transfer_seq;
+        spin_unlock(lock, save);
+        bus_wait_tx_drained(bus_data, seq);
+        save = spin_lock_blocking(lock);
+        finished = !cyw43_spi_queue_is_idle(&bus_data->queue) && bus_data->transfer_seq == seq;
+    }
+    if (finished) {
+        bus_finish_transfer(bus_data);
+        const cyw43_spi_op_t *op = &bus_data->queue.ops[bus_data->queue.head];
+        if (op->rx != NULL) {
+            // make sure we don't have garbage in what would have been returned data if using real SPI. This is done
+            // before the next transfer starts, in case that uses the same buffer
+            memset(op->rx, 0, op->tx_length);
+        }
+        retired = cyw43_spi_queue_complete(&bus_data->queue, &done);
+    }
+    spin_unlock(lock, save);
+    if (retired && done.callback) {
+        done.callback(done.user_data, 0);
+    }
+    return retired;
+}
+
+#if CYW43_SPI_DMA_IRQ_INDEX >= 0
+static void __isr bus_dma_irq_handler(void) {
+    bus_data_t *bus_data = &bus_data_instance;
+    bool ours = false;
+    if (dma_irqn_get_channel_status(CYW43_SPI_DMA_IRQ_INDEX, (uint)bus_data->dma_out)) {
+        dma_irqn_acknowledge_channel(CYW43_SPI_DMA_IRQ_INDEX, (uint)bus_data->dma_out);
+        ours = true;
+    }
+    if (dma_irqn_get_channel_status(CYW43_SPI_DMA_IRQ_INDEX, (uint)bus_data->dma_in)) {
+        dma_irqn_acknowledge_channel(CYW43_SPI_DMA_IRQ_INDEX, (uint)bus_data->dma_in);
+        ours = true;
+    }
+    if (ours) {
+        bus_service(bus_data);
+    }
+}
+#endif
+
+// Queue a transfer, waiting for room if need be
+static void bus_submit(bus_data_t *bus_data, const cyw43_spi_op_t *op) {
+    spin_lock_t *lock = spin_lock_instance((uint)bus_data->spin_lock_num);
+    while (true) {
+        uint32_t save = spin_lock_blocking(lock);
+        bool queued = cyw43_spi_queue_submit(&bus_data->queue, op);
+        spin_unlock(lock, save);
+        if (queued) return;
+        bus_service(bus_data);
+    }
+}
+
+static void sync_transfer_done(void *user_data, __unused int status) {
+    *(volatile bool *)user_data = true;
+}
+
+// Queue a transfer, and if it has no callback of its own, wait for it to complete
+static void bus_transfer(bus_data_t *bus_data, cyw43_spi_op_t *op) {
+    volatile bool done = false;
+    bool sync = !op->callback;
+    if (sync) {
+        op->callback = sync_transfer_done;
+        op->user_data = (void *)&done;
+    }
+    bus_submit(bus_data, op);
+    while (sync && !done) {
+        bus_service(bus_data);
+    }
+}
+
+// Check and set up a transfer made through the public API
+static int bus_op_init(cyw43_spi_op_t *op, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length,
+                       cyw43_spi_transfer_callback_t callback, void *user_data) {
+    if ((tx == NULL) && (rx == NULL)) {
+        return CYW43_FAIL_FAST_CHECK(-CYW43_EINVAL);
+    }
+    assert(!(((uintptr_t)(tx ? tx : rx)) & 3));
+    assert(!(tx_length & 3));
+    assert(rx == NULL || (!(((uintptr_t)rx) & 3) && !(rx_length & 3)));
+    DUMP_SPI_TRANSACTIONS(
+            printf("[%lu] bus TX %u bytes rx %u:", counter++, tx_length, rx ? rx_length : 0);
+            dump_bytes(tx ? tx : rx, tx_length);
+    )
+    *op = (cyw43_spi_op_t) {
+            .tx = tx,
+            .tx_length = tx_length,
+            .rx = rx,
+            .rx_length = rx_length,
+            .callback = callback,
+            .user_data = user_data,
+    };
+    return 0;
+}
+
+int cyw43_spi_transfer_async(cyw43_int_t *self, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length,
+                             cyw43_spi_transfer_callback_t callback, void *user_data) {
+    cyw43_spi_op_t op;
+    int ret = bus_op_init(&op, tx, tx_length, rx, rx_length, callback, user_data);
+    if (ret == 0) {
+        bus_submit((bus_data_t *)self->bus_data, &op);
+    }
+    return ret;
+}
+
+void cyw43_spi_transfer_wait(cyw43_int_t *self) {
+    bus_data_t *bus_data = (bus_data_t *)self->bus_data;
+    while (!cyw43_spi_queue_is_idle(&bus_data->queue)) {
+        bus_service(bus_data);
+    }
+}
+
+void cyw43_spi_get_queue_stats(cyw43_int_t *self, cyw43_spi_queue_stats_t *stats) {
+    bus_data_t *bus_data = (bus_data_t *)self->bus_data;
+    spin_lock_t *lock = spin_lock_instance((uint)bus_data->spin_lock_num);
+    uint32_t save = spin_lock_blocking(lock);
+    *stats = bus_data->queue.stats;
+    spin_unlock(lock, save);
+}
+
+int cyw43_spi_transfer(cyw43_int_t *self, const uint8_t *tx, size_t tx_length, uint8_t *rx,
+                       size_t rx_length) {
+    cyw43_spi_op_t op;
+    int ret = bus_op_init(&op, tx, tx_length, rx, rx_length, NULL, NULL);
+    if (ret != 0) {
+        return ret;
+    }
+    // with no callback, this waits for the transfer to complete
+    bus_transfer((bus_data_t *)self->bus_data, &op);
     DUMP_SPI_TRANSACTIONS(
             printf("RXed:");
             dump_bytes(rx, rx_length);
             printf("\n");
     )
-
     return 0;
 }
 
+void cyw43_spi_get_copy_stats(cyw43_int_t *self, cyw43_spi_copy_stats_t *stats) {
+    *stats = ((bus_data_t *)self->bus_data)->copy_stats;
+}
+
+void cyw43_spi_reset_copy_stats(cyw43_int_t *self) {
+    memset(&((bus_data_t *)self->bus_data)->copy_stats, 0, sizeof(cyw43_spi_copy_stats_t));
+}
+
 // Initialise our gpios
 void cyw43_spi_gpio_setup(void) {
     // Setup CYW43_PIN_WL_REG_ON (23)
@@ -482,67 +654,114 @@ int cyw43_write_reg_u8(cyw43_int_t *self, uint32_t fn, uint32_t reg, uint32_t va
 #error Block size is wrong for SPI
 #endif
 
-int cyw43_read_bytes(cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, uint8_t *buf) {
-    assert(fn != BACKPLANE_FUNCTION || (len <= CYW43_BUS_MAX_BLOCK_SIZE));
+// Read len bytes into buf, of which size bytes may be accessed. Backplane reads start with a response delay,
+// which is received into the header words in front of spid_buf, so they always go through spid_buf.
+static int bus_read_bytes(cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, uint8_t *buf, size_t size,
+                          cyw43_spi_transfer_callback_t callback, void *user_data) {
+    bus_data_t *bus_data = (bus_data_t *)self->bus_data;
     const uint32_t padding = (fn == BACKPLANE_FUNCTION) ? CYW43_BACKPLANE_READ_PAD_LEN_BYTES : 0; // Add response delay
-    size_t aligned_len = (len + 3) & ~3;
-    assert(aligned_len > 0 && aligned_len <= 0x7f8);
-    assert(buf == self->spid_buf || buf < self->spid_buf || buf >= (self->spid_buf + sizeof(self->spid_buf)));
-    self->spi_header[padding > 0 ? 0 : (CYW43_BACKPLANE_READ_PAD_LEN_BYTES / 4)] = make_cmd(false, true, fn, addr, len);
+    uint8_t *rx = padding ? self->spid_buf : cyw43_spi_buf_rx_prepare(buf, len, size, self->spid_buf);
+    assert(rx - padding >= (uint8_t *)self->spi_header || rx == buf);
+    cyw43_spi_op_t op;
+    cyw43_spi_op_init_read(&op, make_cmd(false, true, fn, addr, len), rx - padding, len + padding);
+    op.callback = callback;
+    op.user_data = user_data;
     if (fn == WLAN_FUNCTION) {
         logic_debug_set(pin_WIFI_RX, 1);
     }
-    int ret = cyw43_spi_transfer(self, NULL, 4, (uint8_t *)&self->spi_header[padding > 0 ? 0 : (CYW43_BACKPLANE_READ_PAD_LEN_BYTES / 4)], aligned_len + 4 + padding);
+    bus_transfer(bus_data, &op);
     if (fn == WLAN_FUNCTION) {
         logic_debug_set(pin_WIFI_RX, 0);
     }
-    if (ret != 0) {
-        CYW43_PRINTF("cyw43_read_bytes error %d", ret);
-        return ret;
-    }
-    if (buf != self->spid_buf) { // avoid a copy in the usual case just to add the header
-        memcpy(buf, self->spid_buf, len);
+    if (!callback) {
+        cyw43_spi_buf_rx_finish(&bus_data->copy_stats, fn == WLAN_FUNCTION, buf, rx, len);
     }
     return 0;
 }
 
-// See whd_bus_spi_transfer_bytes
-// Note, uses spid_buf if src isn't using it already
-// Apart from firmware download this appears to only be used for wlan functions?
-int cyw43_write_bytes(cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, const uint8_t *src) {
+int cyw43_read_bytes(cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, uint8_t *buf) {
     assert(fn != BACKPLANE_FUNCTION || (len <= CYW43_BUS_MAX_BLOCK_SIZE));
-    const size_t aligned_len = (len + 3) & ~3u;
-    assert(aligned_len > 0 && aligned_len <= 0x7f8);
-    if (fn == WLAN_FUNCTION) {
-        // Wait for FIFO to be ready to accept data
-        int f2_ready_attempts = 1000;
-        while (f2_ready_attempts-- > 0) {
-            uint32_t bus_status = cyw43_read_reg_u32(self, BUS_FUNCTION, SPI_STATUS_REGISTER);
-            if (bus_status & STATUS_F2_RX_READY) {
-                logic_debug_set(pin_F2_RX_READY_WAIT, 0);
-                break;
-            } else {
-                logic_debug_set(pin_F2_RX_READY_WAIT, 1);
-            }
+    assert(len > 0 && CYW43_SPI_BUFFER_SIZE(len) <= 0x7f8);
+    assert(buf == self->spid_buf || buf < self->spid_buf || buf >= (self->spid_buf + sizeof(self->spid_buf)));
+    // only spid_buf is known to extend to a whole number of words
+    size_t size = buf == self->spid_buf ? sizeof(self->spid_buf) : len;
+    return bus_read_bytes(self, fn, addr, len, buf, size, NULL, NULL);
+}
+
+static int wait_for_f2_ready(cyw43_int_t *self) {
+    // Wait for FIFO to be ready to accept data
+    int f2_ready_attempts = 1000;
+    while (f2_ready_attempts-- > 0) {
+        uint32_t bus_status = cyw43_read_reg_u32(self, BUS_FUNCTION, SPI_STATUS_REGISTER);
+        if (bus_status & STATUS_F2_RX_READY) {
+            logic_debug_set(pin_F2_RX_READY_WAIT, 0);
+            return 0;
+        } else {
+            logic_debug_set(pin_F2_RX_READY_WAIT, 1);
         }
-        if (f2_ready_attempts <= 0) {
-            CYW43_PRINTF("F2 not ready\n");
-            return CYW43_FAIL_FAST_CHECK(-CYW43_EIO);
+    }
+    CYW43_PRINTF("F2 not ready\n");
+    return CYW43_FAIL_FAST_CHECK(-CYW43_EIO);
+}
+
+// Write len bytes from src, of which size bytes may be accessed. The command word is sent ahead of the data by
+// the CPU, so src only needs copying to spid_buf if the DMA can't read it in place.
+static int bus_write_bytes(cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, const uint8_t *src, size_t size,
+                           cyw43_spi_transfer_callback_t callback, void *user_data) {
+    bus_data_t *bus_data = (bus_data_t *)self->bus_data;
+    if (fn == WLAN_FUNCTION) {
+        int ret = wait_for_f2_ready(self);
+        if (ret != 0) {
+            return ret;
         }
     }
-    if (src == self->spid_buf) { // avoid a copy in the usual case just to add the header
-        self->spi_header[(CYW43_BACKPLANE_READ_PAD_LEN_BYTES / 4)] = make_cmd(true, true, fn, addr, len);
+    const uint8_t *tx = cyw43_spi_buf_tx_prepare(&bus_data->copy_stats, fn == WLAN_FUNCTION, src, len, size, self->spid_buf);
+    cyw43_spi_op_t op;
+    cyw43_spi_op_init_write(&op, make_cmd(true, true, fn, addr, len), tx, len);
+    op.callback = callback;
+    op.user_data = user_data;
+    if (fn == WLAN_FUNCTION) {
         logic_debug_set(pin_WIFI_TX, 1);
-        int res = cyw43_spi_transfer(self, (uint8_t *)&self->spi_header[(CYW43_BACKPLANE_READ_PAD_LEN_BYTES / 4)], aligned_len + 4, NULL, 0);
+    }
+    bus_transfer(bus_data, &op);
+    if (fn == WLAN_FUNCTION) {
         logic_debug_set(pin_WIFI_TX, 0);
-        return res;
-    } else {
-        // todo: would be nice to get rid of this. Only used for firmware download?
-        assert(src < self->spid_buf || src >= (self->spid_buf + sizeof(self->spid_buf)));
-        self->spi_header[(CYW43_BACKPLANE_READ_PAD_LEN_BYTES / 4)] = make_cmd(true, true, fn, addr, len);
-        memcpy(self->spid_buf, src, len);
-        return cyw43_spi_transfer(self, (uint8_t *)&self->spi_header[(CYW43_BACKPLANE_READ_PAD_LEN_BYTES / 4)], aligned_len + 4, NULL, 0);
     }
+    return 0;
+}
+
+// See whd_bus_spi_transfer_bytes
+// Note, uses spid_buf if src isn't using it already, and can't be sent in place
+// Apart from firmware download this appears to only be used for wlan functions?
+int cyw43_write_bytes(cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, const uint8_t *src) {
+    assert(fn != BACKPLANE_FUNCTION || (len <= CYW43_BUS_MAX_BLOCK_SIZE));
+    assert(len > 0 && CYW43_SPI_BUFFER_SIZE(len) <= 0x7f8);
+    assert(src == self->spid_buf || src < self->spid_buf || src >= (self->spid_buf + sizeof(self->spid_buf)));
+    size_t size = src == self->spid_buf ? sizeof(self->spid_buf) : len;
+    return bus_write_bytes(self, fn, addr, len, src, size, NULL, NULL);
+}
+
+int cyw43_spi_write_bytes_in_place(cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, const uint8_t *buf,
+                                   cyw43_spi_transfer_callback_t callback, void *user_data) {
+    if (!len || CYW43_SPI_BUFFER_SIZE(len) > 0x7f8 || (fn == BACKPLANE_FUNCTION && len > CYW43_BUS_MAX_BLOCK_SIZE) ||
+        !cyw43_spi_buf_is_dma_capable(buf, len, CYW43_SPI_BUFFER_SIZE(len))) {
+        return CYW43_FAIL_FAST_CHECK(-CYW43_EINVAL);
+    }
+    return bus_write_bytes(self, fn, addr, len, buf, CYW43_SPI_BUFFER_SIZE(len), callback, user_data);
+}
+
+int cyw43_spi_read_bytes_in_place(cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, uint8_t *buf,
+                                  cyw43_spi_transfer_callback_t callback, void *user_data) {
+    if (!len || CYW43_SPI_BUFFER_SIZE(len) > 0x7f8 || fn == BACKPLANE_FUNCTION ||
+        !cyw43_spi_buf_is_dma_capable(buf, len, CYW43_SPI_BUFFER_SIZE(len))) {
+        return CYW43_FAIL_FAST_CHECK(-CYW43_EINVAL);
+    }
+    if (callback && fn == WLAN_FUNCTION) {
+        // there is no copy to make once the transfer completes, so the frame can be counted now
+        bus_data_t *bus_data = (bus_data_t *)self->bus_data;
+        cyw43_spi_buf_rx_finish(&bus_data->copy_stats, true, buf, buf, len);
+    }
+    return bus_read_bytes(self, fn, addr, len, buf, CYW43_SPI_BUFFER_SIZE(len), callback, user_data);
 }
 #endif
 
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/cyw43_spi_buf.h"
+
+const uint8_t *cyw43_spi_buf_tx_prepare(cyw43_spi_copy_stats_t *stats, bool frame, const uint8_t *src, size_t len,
+                                        size_t size, uint8_t *bounce) {
+    if (frame) stats->tx_frames++;
+    if (src == bounce || cyw43_spi_buf_is_dma_capable(src, len, size)) {
+        return src;
+    }
+    memcpy(bounce, src, len);
+    if (frame) {
+        stats->tx_copies++;
+        stats->tx_copy_bytes += len;
+    }
+    return bounce;
+}
+
+uint8_t *cyw43_spi_buf_rx_prepare(uint8_t *dst, size_t len, size_t size, uint8_t *bounce) {
+    return cyw43_spi_buf_is_dma_capable(dst, len, size) ? dst : bounce;
+}
+
+void cyw43_spi_buf_rx_finish(cyw43_spi_copy_stats_t *stats, bool frame, uint8_t *dst, const uint8_t *rx, size_t len) {
+    if (frame) stats->rx_frames++;
+    if (rx == dst) return;
+    memcpy(dst, rx, len);
+    if (frame) {
+        stats->rx_copies++;
+        stats->rx_copy_bytes += len;
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/cyw43_spi_queue.h"
+
+static_assert(CYW43_SPI_QUEUE_LENGTH >= 1 && CYW43_SPI_QUEUE_LENGTH <= 255, "");
+
+void cyw43_spi_queue_init(cyw43_spi_queue_t *queue, cyw43_spi_queue_start_func_t start, void *bus) {
+    memset(queue, 0, sizeof(*queue));
+    queue->start = start;
+    queue->bus = bus;
+}
+
+bool cyw43_spi_queue_submit(cyw43_spi_queue_t *queue, const cyw43_spi_op_t *op) {
+    if (cyw43_spi_queue_is_full(queue)) {
+        queue->stats.full++;
+        return false;
+    }
+    uint index = (queue->head + queue->count) % CYW43_SPI_QUEUE_LENGTH;
+    queue->ops[index] = *op;
+    queue->count++;
+    queue->stats.submitted++;
+    if (queue->count > queue->stats.max_depth) queue->stats.max_depth = queue->count;
+    if (queue->count == 1) {
+        queue->start(queue, &queue->ops[index]);
+    }
+    return true;
+}
+
+bool cyw43_spi_queue_complete(cyw43_spi_queue_t *queue, cyw43_spi_op_t *done) {
+    if (!queue->count) return false;
+    *done = queue->ops[queue->head];
+    queue->head = (uint8_t)((queue->head + 1) % CYW43_SPI_QUEUE_LENGTH);
+    queue->count--;
+    queue->stats.completed++;
+    if (queue->count) {
+        queue->stats.back_to_back++;
+        queue->start(queue, &queue->ops[queue->head]);
+    }
+    return true;
+}
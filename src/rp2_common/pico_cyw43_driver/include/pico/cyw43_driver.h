@@ -15,6 +15,8 @@
  */
 
 #include "pico.h"
+#include "pico/cyw43_spi_queue.h"
+#include "pico/cyw43_spi_buf.h"
 
 #if CYW43_PIN_WL_DYNAMIC
 #include "cyw43_configport.h"
@@ -33,6 +35,7 @@ extern "C" {
 #endif
 
 struct async_context;
+struct _cyw43_int_t;
 
 /*! \brief Initializes the lower level cyw43_driver and integrates it with the provided async_context
  *  \ingroup pico_cyw43_driver
@@ -89,6 +92,110 @@ void cyw43_driver_deinit(struct async_context *context);
 
 // PICO_CONFIG: CYW43_DEFAULT_PIN_WL_CS, gpio pin for the spi chip select to the cyw43 chip, type=int, min=0, max=47 on RP2350B, 29 otherwise, advanced=true, group=pico_cyw43_driver
 
+// PICO_CONFIG: CYW43_SPI_DMA_IRQ_INDEX, DMA IRQ index on which a shared handler completes queued transfers to the wireless chip as soon as the DMA finishes or -1 to complete them only when they are waited for, type=int, min=-1, max=3, default=-1, group=pico_cyw43_driver
+#ifndef CYW43_SPI_DMA_IRQ_INDEX
+#define CYW43_SPI_DMA_IRQ_INDEX -1
+#endif
+
+/*! \brief Queue a transfer on the bus to the cyw43 device
+ *  \ingroup pico_cyw43_driver
+ *
+ * This is the non-blocking form of cyw43_spi_transfer(): the transfer is added to a queue of up to
+ * \ref CYW43_SPI_QUEUE_LENGTH transfers which are carried out in order, each one starting as soon as the previous
+ * one finishes, so the caller can prepare the next transfer while the bus is busy. If the queue is full this
+ * function waits for room.
+ *
+ * The callback is called when the transfer has finished, either from the DMA IRQ handler if one is enabled (see
+ * \ref CYW43_SPI_DMA_IRQ_INDEX) or from within a call which is waiting on the bus; it should be short, and may
+ * queue further transfers. Synchronous transfers made by the cyw43 driver are queued behind any pending
+ * asynchronous ones.
+ *
+ * \param self the cyw43 driver state
+ * \param tx the data to send, or NULL to send the first \p tx_length bytes of \p rx
+ * \param tx_length the number of bytes to send; a multiple of 4
+ * \param rx the buffer to receive into (after the \p tx_length bytes sent), or NULL for a transmit only transfer
+ * \param rx_length the total length of the transfer including the bytes sent; a multiple of 4
+ * \param callback the function to call on completion, or NULL
+ * \param user_data user data passed to \p callback
+ * \return 0 if the transfer was queued, or a negative error code
+ */
+int cyw43_spi_transfer_async(struct _cyw43_int_t *self, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length,
+                             cyw43_spi_transfer_callback_t callback, void *user_data);
+
+/*! \brief Wait for all queued transfers to the cyw43 device to finish
+ *  \ingroup pico_cyw43_driver
+ *
+ * \param self the cyw43 driver state
+ */
+void cyw43_spi_transfer_wait(struct _cyw43_int_t *self);
+
+/*! \brief Get the statistics of the bus transfer queue
+ *  \ingroup pico_cyw43_driver
+ *
+ * \param self the cyw43 driver state
+ * \param stats receives the statistics
+ */
+void cyw43_spi_get_queue_stats(struct _cyw43_int_t *self, cyw43_spi_queue_stats_t *stats);
+
+/*! \brief Write to the cyw43 device directly from a caller's buffer
+ *  \ingroup pico_cyw43_driver
+ *
+ * Unlike cyw43_write_bytes(), the data is never copied to the driver's own buffer: the bus DMA reads it in place.
+ * \p buf must be word aligned, and \ref CYW43_SPI_BUFFER_SIZE(len) bytes at \p buf must be readable. For a WLAN
+ * write, this function first waits for the device to be ready for the frame.
+ *
+ * If \p callback is NULL the write is complete when this function returns. Otherwise the write is queued, and the
+ * buffer belongs to the bus until the callback is called (see \ref cyw43_spi_transfer_async).
+ *
+ * \param self the cyw43 driver state
+ * \param fn the gSPI function
+ * \param addr the address
+ * \param len the number of bytes to write
+ * \param buf the data
+ * \param callback the function to call on completion, or NULL to wait for completion
+ * \param user_data user data passed to \p callback
+ * \return 0 on success, or a negative error code (e.g. if \p buf is not suitable)
+ */
+int cyw43_spi_write_bytes_in_place(struct _cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, const uint8_t *buf,
+                                   cyw43_spi_transfer_callback_t callback, void *user_data);
+
+/*! \brief Read from the cyw43 device directly into a caller's buffer
+ *  \ingroup pico_cyw43_driver
+ *
+ * Unlike cyw43_read_bytes(), the data is never copied from the driver's own buffer: the bus DMA writes it in
+ * place. \p buf must be word aligned, and \ref CYW43_SPI_BUFFER_SIZE(len) bytes at \p buf must be writable.
+ * Backplane reads, which start with a response delay, are not supported.
+ *
+ * If \p callback is NULL the read is complete when this function returns. Otherwise the read is queued, and the
+ * buffer belongs to the bus until the callback is called (see \ref cyw43_spi_transfer_async).
+ *
+ * \param self the cyw43 driver state
+ * \param fn the gSPI function
+ * \param addr the address
+ * \param len the number of bytes to read
+ * \param buf the buffer
+ * \param callback the function to call on completion, or NULL to wait for completion
+ * \param user_data user data passed to \p callback
+ * \return 0 on success, or a negative error code (e.g. if \p buf is not suitable)
+ */
+int cyw43_spi_read_bytes_in_place(struct _cyw43_int_t *self, uint32_t fn, uint32_t addr, size_t len, uint8_t *buf,
+                                  cyw43_spi_transfer_callback_t callback, void *user_data);
+
+/*! \brief Get the counts of WLAN frames transferred and copied
+ *  \ingroup pico_cyw43_driver
+ *
+ * \param self the cyw43 driver state
+ * \param stats receives the counts
+ */
+void cyw43_spi_get_copy_stats(struct _cyw43_int_t *self, cyw43_spi_copy_stats_t *stats);
+
+/*! \brief Reset the counts of WLAN frames transferred and copied
+ *  \ingroup pico_cyw43_driver
+ *
+ * \param self the cyw43 driver state
+ */
+void cyw43_spi_reset_copy_stats(struct _cyw43_int_t *self);
+
 #if CYW43_PIO_CLOCK_DIV_DYNAMIC
 /*! \brief Set the clock divisor for the cyw43 pio clock
  *  \ingroup pico_cyw43_driver
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_CYW43_SPI_BUF_H
+#define _PICO_CYW43_SPI_BUF_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/cyw43_spi_buf.h
+ *  \defgroup cyw43_spi_buf cyw43_spi_buf
+ *  \ingroup pico_cyw43_driver
+ *
+ * \brief Choice between transferring a caller's buffer in place and copying it through the bus bounce buffer
+ *
+ * The bus DMA transfers whole words, so a buffer can only be handed to it directly if it is word aligned and the
+ * length rounded up to a whole number of words may be accessed (see \ref CYW43_SPI_BUFFER_SIZE). Other buffers are
+ * copied through the driver's own buffer (spid_buf). The copies made for WLAN frames are counted, so the effect of
+ * providing suitable buffers can be measured.
+ *
+ * For example, a pbuf allocated with pbuf_alloc(PBUF_RAW, CYW43_SPI_BUFFER_SIZE(len), PBUF_RAM) meets these
+ * requirements as long as lwIP's MEM_ALIGNMENT is at least 4.
+ *
+ * These functions are portable; they are used by the bus implementation, and may be used by a host test bus.
+ */
+
+/*! \brief Size of a buffer needed to transfer \p len bytes in place
+ *  \ingroup cyw43_spi_buf
+ */
+#define CYW43_SPI_BUFFER_SIZE(len) (((len) + 3u) & ~3u)
+
+/*! \brief Counts of the WLAN frames transferred, and of the copies made for them
+ *  \ingroup cyw43_spi_buf
+ */
+typedef struct cyw43_spi_copy_stats {
+    uint32_t tx_frames;      ///< WLAN frames written
+    uint32_t tx_copies;      ///< WLAN frames copied to the bounce buffer before being written
+    uint64_t tx_copy_bytes;  ///< bytes copied for those frames
+    uint32_t rx_frames;      ///< WLAN frames read
+    uint32_t rx_copies;      ///< WLAN frames copied out of the bounce buffer after being read
+    uint64_t rx_copy_bytes;  ///< bytes copied for those frames
+} cyw43_spi_copy_stats_t;
+
+/*! \brief Determine if the bus DMA can use a buffer in place
+ *  \ingroup cyw43_spi_buf
+ *
+ * \param buf the buffer
+ * \param len the number of bytes to transfer
+ * \param size the number of bytes which may be accessed at \p buf
+ * \return true if \p buf is word aligned and \p size is at least \ref CYW43_SPI_BUFFER_SIZE(len)
+ */
+static inline bool cyw43_spi_buf_is_dma_capable(const void *buf, size_t len, size_t size) {
+    return !((uintptr_t)buf & 3u) && size >= CYW43_SPI_BUFFER_SIZE(len);
+}
+
+/*! \brief Choose the buffer to write from, copying the data to the bounce buffer if it can't be used in place
+ *  \ingroup cyw43_spi_buf
+ *
+ * \param stats the statistics to update
+ * \param frame true if this is a WLAN frame, which is counted
+ * \param src the data
+ * \param len the number of bytes to write
+ * \param size the number of bytes which may be accessed at \p src
+ * \param bounce the bounce buffer, which must be big enough
+ * \return \p src or \p bounce
+ */
+const uint8_t *cyw43_spi_buf_tx_prepare(cyw43_spi_copy_stats_t *stats, bool frame, const uint8_t *src, size_t len,
+                                        size_t size, uint8_t *bounce);
+
+/*! \brief Choose the buffer to read into
+ *  \ingroup cyw43_spi_buf
+ *
+ * \param dst the caller's buffer
+ * \param len the number of bytes to read
+ * \param size the number of bytes which may be accessed at \p dst
+ * \param bounce the bounce buffer, which must be big enough
+ * \return \p dst or \p bounce
+ */
+uint8_t *cyw43_spi_buf_rx_prepare(uint8_t *dst, size_t len, size_t size, uint8_t *bounce);
+
+/*! \brief Finish a read, copying the data to the caller's buffer if it was read into the bounce buffer
+ *  \ingroup cyw43_spi_buf
+ *
+ * \param stats the statistics to update
+ * \param frame true if this is a WLAN frame, which is counted
+ * \param dst the caller's buffer
+ * \param rx the buffer returned by \ref cyw43_spi_buf_rx_prepare
+ * \param len the number of bytes read
+ */
+void cyw43_spi_buf_rx_finish(cyw43_spi_copy_stats_t *stats, bool frame, uint8_t *dst, const uint8_t *rx, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_CYW43_SPI_QUEUE_H
+#define _PICO_CYW43_SPI_QUEUE_H
+
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/cyw43_spi_queue.h
+ *  \defgroup cyw43_spi_queue cyw43_spi_queue
+ *  \ingroup pico_cyw43_driver
+ *
+ * \brief Queue of pending CYW43 gSPI bus transfers
+ *
+ * Bus transfers are started in order, one at a time; when the bus backend reports that the transfer in flight has
+ * finished, the next queued transfer is started straight away, so the caller can prepare further transfers while the
+ * bus is busy. The queue itself is portable and does no locking; the bus backend must serialize calls to
+ * \ref cyw43_spi_queue_submit and \ref cyw43_spi_queue_complete (e.g. by holding a spin lock).
+ */
+
+// PICO_CONFIG: CYW43_SPI_QUEUE_LENGTH, Maximum number of CYW43 bus transfers that can be queued (including the one in flight), type=int, min=1, max=255, default=4, group=pico_cyw43_driver
+#ifndef CYW43_SPI_QUEUE_LENGTH
+#define CYW43_SPI_QUEUE_LENGTH 4
+#endif
+
+/*! \brief Completion callback for a queued bus transfer
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param user_data the user data passed with the transfer
+ * \param status 0 on success, or a negative error code
+ */
+typedef void (*cyw43_spi_transfer_callback_t)(void *user_data, int status);
+
+/*! \brief A bus transfer
+ *  \ingroup cyw43_spi_queue
+ *
+ * As for cyw43_spi_transfer(), if \p rx is not NULL then \p tx_length bytes are sent from \p tx (or from \p rx if \p tx is
+ * NULL) and the remainder of the \p rx_length bytes are received into \p rx after them; otherwise \p tx_length bytes are
+ * sent from \p tx. The buffers must remain valid until the callback is called.
+ *
+ * If \p header_length is 4, \p header is sent before any of the above. The command word can then be kept apart from the
+ * data, so that the data can be sent from, or received into, a buffer with no room in front of it.
+ */
+typedef struct cyw43_spi_op {
+    uint32_t header;
+    uint8_t header_length;
+    const uint8_t *tx;
+    size_t tx_length;
+    uint8_t *rx;
+    size_t rx_length;
+    cyw43_spi_transfer_callback_t callback;
+    void *user_data;
+} cyw43_spi_op_t;
+
+/*! \brief Statistics for a transfer queue
+ *  \ingroup cyw43_spi_queue
+ */
+typedef struct cyw43_spi_queue_stats {
+    uint32_t submitted;       ///< transfers accepted
+    uint32_t completed;       ///< transfers completed
+    uint32_t back_to_back;    ///< transfers started directly on completion of the previous one
+    uint32_t full;            ///< submissions rejected because the queue was full
+    uint8_t max_depth;        ///< greatest number of transfers queued at once
+} cyw43_spi_queue_stats_t;
+
+/*! \brief Set up a transfer which sends a command word followed by \p len bytes from \p data
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param op the transfer to set up; the callback and user data are cleared
+ * \param cmd the command word
+ * \param data the data, which must be word aligned; the length is rounded up to a whole number of words
+ * \param len the number of bytes to write
+ */
+static inline void cyw43_spi_op_init_write(cyw43_spi_op_t *op, uint32_t cmd, const uint8_t *data, size_t len) {
+    *op = (cyw43_spi_op_t) {
+            .header = cmd,
+            .header_length = 4,
+            .tx = data,
+            .tx_length = (len + 3) & ~(size_t)3,
+    };
+}
+
+/*! \brief Set up a transfer which sends a command word then receives \p len bytes into \p data
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param op the transfer to set up; the callback and user data are cleared
+ * \param cmd the command word
+ * \param data the buffer, which must be word aligned; the length is rounded up to a whole number of words
+ * \param len the number of bytes to read, including any response delay bytes
+ */
+static inline void cyw43_spi_op_init_read(cyw43_spi_op_t *op, uint32_t cmd, uint8_t *data, size_t len) {
+    *op = (cyw43_spi_op_t) {
+            .header = cmd,
+            .header_length = 4,
+            .rx = data,
+            .rx_length = (len + 3) & ~(size_t)3,
+    };
+}
+
+typedef struct cyw43_spi_queue cyw43_spi_queue_t;
+
+/*! \brief Function called by the queue to start a transfer on the bus
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param queue the queue
+ * \param op the transfer to start; the pointer is valid until the transfer is completed
+ */
+typedef void (*cyw43_spi_queue_start_func_t)(cyw43_spi_queue_t *queue, const cyw43_spi_op_t *op);
+
+/*! \brief Transfer queue state
+ *  \ingroup cyw43_spi_queue
+ */
+struct cyw43_spi_queue {
+    cyw43_spi_op_t ops[CYW43_SPI_QUEUE_LENGTH];
+    uint8_t head;  ///< index of the transfer in flight
+    uint8_t count; ///< number of transfers queued, including the one in flight
+    cyw43_spi_queue_start_func_t start;
+    void *bus;
+    cyw43_spi_queue_stats_t stats;
+};
+
+/*! \brief Initialize a transfer queue
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param queue the queue
+ * \param start the function which starts a transfer on the bus
+ * \param bus bus specific data for use by \p start
+ */
+void cyw43_spi_queue_init(cyw43_spi_queue_t *queue, cyw43_spi_queue_start_func_t start, void *bus);
+
+/*! \brief Add a transfer to the queue, starting it if the bus is idle
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param queue the queue
+ * \param op the transfer; it is copied
+ * \return true if the transfer was queued, false if the queue is full
+ */
+bool cyw43_spi_queue_submit(cyw43_spi_queue_t *queue, const cyw43_spi_op_t *op);
+
+/*! \brief Retire the transfer in flight, and start the next queued transfer if there is one
+ *  \ingroup cyw43_spi_queue
+ *
+ * The callback of the retired transfer is NOT called; it is copied to \p done so that the caller can call it once
+ * it has released any lock it holds (the callback may then submit further transfers).
+ *
+ * \param queue the queue
+ * \param done receives the retired transfer
+ * \return true if a transfer was retired, false if none was in flight
+ */
+bool cyw43_spi_queue_complete(cyw43_spi_queue_t *queue, cyw43_spi_op_t *done);
+
+/*! \brief Determine if the queue is empty, i.e. no transfer is in flight
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param queue the queue
+ * \return true if the queue is empty
+ */
+static inline bool cyw43_spi_queue_is_idle(const cyw43_spi_queue_t *queue) {
+    return !queue->count;
+}
+
+/*! \brief Determine if the queue has no room for another transfer
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param queue the queue
+ * \return true if the queue is full
+ */
+static inline bool cyw43_spi_queue_is_full(const cyw43_spi_queue_t *queue) {
+    return queue->count == CYW43_SPI_QUEUE_LENGTH;
+}
+
+/*! \brief Return the transfer in flight
+ *  \ingroup cyw43_spi_queue
+ *
+ * \param queue the queue
+ * \return the transfer in flight, or NULL if the queue is idle
+ */
+static inline const cyw43_spi_op_t *cyw43_spi_queue_in_flight(const cyw43_spi_queue_t *queue) {
+    return queue->count ? &queue->ops[queue->head] : NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
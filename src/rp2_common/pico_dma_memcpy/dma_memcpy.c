@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/dma_memcpy_backend.h"
+
+// the operation running on each channel, or NULL if it is idle
+static dma_memcpy_op_t *channel_ops[PICO_DMA_MEMCPY_MAX_CHANNELS];
+// the bytes transferred by the block running on each channel
+static size_t channel_block_bytes[PICO_DMA_MEMCPY_MAX_CHANNELS];
+static uint channel_count;
+// operations waiting for a channel, oldest first
+static dma_memcpy_op_t *queue_head;
+static dma_memcpy_op_t *queue_tail;
+// operations started on or queued for a channel whose callbacks haven't returned yet
+static volatile uint pending_count;
+static size_t min_size = PICO_DMA_MEMCPY_MIN_SIZE;
+
+bool dma_memcpy_init(uint new_channel_count) {
+    invalid_params_if(PICO_DMA_MEMCPY, !new_channel_count || new_channel_count > PICO_DMA_MEMCPY_MAX_CHANNELS);
+    if (channel_count || !new_channel_count || new_channel_count > PICO_DMA_MEMCPY_MAX_CHANNELS) return false;
+    if (!dma_memcpy_backend_init(new_channel_count)) return false;
+    for (uint i = 0; i < new_channel_count; i++) channel_ops[i] = NULL;
+    queue_head = queue_tail = NULL;
+    pending_count = 0;
+    channel_count = new_channel_count;
+    return true;
+}
+
+void dma_memcpy_deinit(void) {
+    if (!channel_count) return;
+    dma_memcpy_wait_all();
+    dma_memcpy_backend_deinit();
+    channel_count = 0;
+}
+
+void dma_memcpy_set_min_size(size_t new_min_size) {
+    min_size = new_min_size;
+}
+
+// Starts the next block of an operation on a channel; called with the lock held
+static void start_block(uint channel, dma_memcpy_op_t *op) {
+    uint32_t count = (uint32_t)MIN(op->remaining >> op->transfer_size_log2, PICO_DMA_MEMCPY_MAX_BLOCK_TRANSFERS);
+    channel_ops[channel] = op;
+    channel_block_bytes[channel] = (size_t)count << op->transfer_size_log2;
+    dma_memcpy_backend_start(channel, op->dst, op->src ? op->src : (const uint8_t *)&op->pattern,
+                             op->transfer_size_log2, op->src != NULL, count);
+}
+
+// Runs an operation whose DMA part is op->remaining bytes at op->dst (and op->src) of op->transfer_size_log2 aligned
+// transfers, or finishes it straight away if that is empty
+static void submit(dma_memcpy_op_t *op) {
+    if (!op->remaining) {
+        op->done = true;
+        if (op->callback) op->callback(op, op->user_data);
+        return;
+    }
+    invalid_params_if(PICO_DMA_MEMCPY, !channel_count);
+    op->next = NULL;
+    uint32_t save = dma_memcpy_backend_lock();
+    pending_count++;
+    uint channel;
+    for (channel = 0; channel < channel_count; channel++) {
+        if (!channel_ops[channel]) break;
+    }
+    if (channel < channel_count) {
+        start_block(channel, op);
+    } else if (queue_tail) {
+        queue_tail->next = op;
+        queue_tail = op;
+    } else {
+        queue_head = queue_tail = op;
+    }
+    dma_memcpy_backend_unlock(save);
+}
+
+static void init_op(dma_memcpy_op_t *op, void *dst, const void *src, dma_memcpy_callback_t callback,
+                    void *user_data) {
+    op->dst = (uint8_t *)dst;
+    op->src = (const uint8_t *)src;
+    op->callback = callback;
+    op->user_data = user_data;
+    op->done = false;
+}
+
+void dma_memcpy_async(dma_memcpy_op_t *op, void *dst, const void *src, size_t len, dma_memcpy_callback_t callback,
+                      void *user_data) {
+    init_op(op, dst, src, callback, user_data);
+    if (len < min_size || !len) {
+        memcpy(dst, src, len);
+        op->remaining = 0;
+    } else {
+        // the widest transfer for which the source and destination are equally aligned
+        uintptr_t misalignment = (uintptr_t)dst ^ (uintptr_t)src;
+        uint size_log2 = (misalignment & 1) ? 0 : (misalignment & 2) ? 1 : 2;
+        size_t head = MIN((size_t)(-(uintptr_t)dst & ((1u << size_log2) - 1)), len);
+        size_t tail = (len - head) & ((1u << size_log2) - 1);
+        // the bytes the DMA can't do are copied now
+        memcpy(op->dst, src, head);
+        memcpy(op->dst + len - tail, op->src + len - tail, tail);
+        op->dst += head;
+        op->src += head;
+        op->remaining = len - head - tail;
+        op->transfer_size_log2 = (uint8_t)size_log2;
+    }
+    submit(op);
+}
+
+void dma_memset_async(dma_memcpy_op_t *op, void *dst, int c, size_t len, dma_memcpy_callback_t callback,
+                      void *user_data) {
+    init_op(op, dst, NULL, callback, user_data);
+    if (len < min_size || !len) {
+        memset(dst, c, len);
+        op->remaining = 0;
+    } else {
+        op->pattern = (uint8_t)c * 0x01010101u;
+        size_t head = MIN((size_t)(-(uintptr_t)dst & 3), len);
+        size_t tail = (len - head) & 3;
+        memset(op->dst, c, head);
+        memset(op->dst + len - tail, c, tail);
+        op->dst += head;
+        op->remaining = len - head - tail;
+        op->transfer_size_log2 = 2;
+    }
+    submit(op);
+}
+
+void dma_memcpy_block_done(uint channel) {
+    uint32_t save = dma_memcpy_backend_lock();
+    dma_memcpy_op_t *op = channel_ops[channel];
+    size_t block_bytes = channel_block_bytes[channel];
+    op->dst += block_bytes;
+    if (op->src) op->src += block_bytes;
+    op->remaining -= block_bytes;
+    if (op->remaining) {
+        start_block(channel, op);
+        dma_memcpy_backend_unlock(save);
+        return;
+    }
+    // keep the channel busy with the next queued operation, if there is one
+    dma_memcpy_op_t *next = queue_head;
+    if (next) {
+        queue_head = next->next;
+        if (!queue_head) queue_tail = NULL;
+        start_block(channel, next);
+    } else {
+        channel_ops[channel] = NULL;
+    }
+    // the op may be reused as soon as it is done, so read the callback first
+    dma_memcpy_callback_t callback = op->callback;
+    void *user_data = op->user_data;
+    op->done = true;
+    dma_memcpy_backend_unlock(save);
+    if (callback) callback(op, user_data);
+    save = dma_memcpy_backend_lock();
+    pending_count--;
+    dma_memcpy_backend_unlock(save);
+    dma_memcpy_backend_notify();
+}
+
+static bool op_is_done(const void *arg) {
+    return ((const dma_memcpy_op_t *)arg)->done;
+}
+
+void dma_memcpy_op_wait(dma_memcpy_op_t *op) {
+    dma_memcpy_backend_wait(op_is_done, op);
+}
+
+static bool all_idle(__unused const void *arg) {
+    return !pending_count;
+}
+
+void dma_memcpy_wait_all(void) {
+    dma_memcpy_backend_wait(all_idle, NULL);
+}
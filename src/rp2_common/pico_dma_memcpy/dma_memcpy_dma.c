@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/dma_memcpy_backend.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// PICO_CONFIG: PICO_DMA_MEMCPY_IRQ_INDEX, Index of the DMA IRQ (0 to NUM_DMA_IRQS - 1) used by pico_dma_memcpy, type=int, min=0, max=3, default=0, group=pico_dma_memcpy
+#ifndef PICO_DMA_MEMCPY_IRQ_INDEX
+#define PICO_DMA_MEMCPY_IRQ_INDEX 0
+#endif
+
+static uint8_t dma_channels[PICO_DMA_MEMCPY_MAX_CHANNELS];
+static uint dma_channel_count;
+static spin_lock_t *lock;
+
+static void dma_memcpy_irq_handler(void) {
+    for (uint i = 0; i < dma_channel_count; i++) {
+        if (dma_irqn_get_channel_status(PICO_DMA_MEMCPY_IRQ_INDEX, dma_channels[i])) {
+            dma_irqn_acknowledge_channel(PICO_DMA_MEMCPY_IRQ_INDEX, dma_channels[i]);
+            dma_memcpy_block_done(i);
+        }
+    }
+}
+
+bool dma_memcpy_backend_init(uint channel_count) {
+    for (uint i = 0; i < channel_count; i++) {
+        int channel = dma_claim_unused_channel(false);
+        if (channel < 0) {
+            while (i--) dma_channel_unclaim(dma_channels[i]);
+            return false;
+        }
+        dma_channels[i] = (uint8_t)channel;
+    }
+    if (!lock) lock = spin_lock_init(next_striped_spin_lock_num());
+    dma_channel_count = channel_count;
+    irq_add_shared_handler(DMA_IRQ_NUM(PICO_DMA_MEMCPY_IRQ_INDEX), dma_memcpy_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_NUM(PICO_DMA_MEMCPY_IRQ_INDEX), true);
+    for (uint i = 0; i < channel_count; i++) {
+        dma_irqn_acknowledge_channel(PICO_DMA_MEMCPY_IRQ_INDEX, dma_channels[i]);
+        dma_irqn_set_channel_enabled(PICO_DMA_MEMCPY_IRQ_INDEX, dma_channels[i], true);
+    }
+    return true;
+}
+
+void dma_memcpy_backend_deinit(void) {
+    for (uint i = 0; i < dma_channel_count; i++) {
+        dma_irqn_set_channel_enabled(PICO_DMA_MEMCPY_IRQ_INDEX, dma_channels[i], false);
+        dma_channel_cleanup(dma_channels[i]);
+        dma_channel_unclaim(dma_channels[i]);
+    }
+    irq_remove_handler(DMA_IRQ_NUM(PICO_DMA_MEMCPY_IRQ_INDEX), dma_memcpy_irq_handler);
+    dma_channel_count = 0;
+}
+
+void dma_memcpy_backend_start(uint channel, void *dst, const void *src, uint transfer_size_log2, bool read_increment,
+                              uint32_t count) {
+    uint dma_channel = dma_channels[channel];
+    dma_channel_config c = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&c, (enum dma_channel_transfer_size)transfer_size_log2);
+    channel_config_set_read_increment(&c, read_increment);
+    channel_config_set_write_increment(&c, true);
+    dma_channel_configure(dma_channel, &c, dst, src, dma_encode_transfer_count(count), true);
+}
+
+uint32_t dma_memcpy_backend_lock(void) {
+    return spin_lock_blocking(lock);
+}
+
+void dma_memcpy_backend_unlock(uint32_t save) {
+    spin_unlock(lock, save);
+}
+
+void dma_memcpy_backend_wait(bool (*condition)(const void *arg), const void *arg) {
+    // a block finishing on this core interrupts the wait, and one finishing on the other core sends an event
+    while (!condition(arg)) {
+        __wfe();
+    }
+}
+
+void dma_memcpy_backend_notify(void) {
+    __sev();
+}
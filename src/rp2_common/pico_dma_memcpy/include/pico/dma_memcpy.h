@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_DMA_MEMCPY_H
+#define _PICO_DMA_MEMCPY_H
+
+#include "pico.h"
+
+/** \file pico/dma_memcpy.h
+ *  \defgroup pico_dma_memcpy pico_dma_memcpy
+ *
+ * \brief Asynchronous memcpy and memset done by DMA, so the CPU can get on with something else
+ *
+ * \ref dma_memcpy_init claims a number of DMA channels, each of which runs one operation at a time; operations
+ * started while all the channels are busy are queued, and started in order as channels become free. When an operation
+ * finishes, its \ref dma_memcpy_op_t is marked done (see \ref dma_memcpy_op_is_done and \ref dma_memcpy_op_wait), and
+ * its callback, if any, is called from the DMA interrupt handler.
+ *
+ * Each operation uses the widest transfer size the alignment of its buffers allows: if the source and destination
+ * are equally aligned (to 4 or 2 bytes), the CPU copies the few bytes before the first and after the last aligned
+ * word (or halfword) when the operation is started, and the DMA channel the rest. Operations longer than a channel
+ * can transfer at once are split into blocks, each started by the interrupt handler when the previous one finishes.
+ *
+ * Operations shorter than \ref dma_memcpy_set_min_size bytes (\ref PICO_DMA_MEMCPY_MIN_SIZE by default) are done by
+ * the CPU straight away, as starting the DMA and handling its interrupt would take longer; in that case the callback
+ * is called before \ref dma_memcpy_async or \ref dma_memset_async returns.
+ *
+ * Operations on different channels run at the same time, so mustn't depend on each other's results; nor may the
+ * source and destination of a copy overlap.
+ *
+ * On the host, the DMA channels are emulated by worker threads, so that the API (and the queueing of operations) can be
+ * tested; callbacks are called from the worker threads.
+ */
+
+// PICO_CONFIG: PARAM_ASSERTIONS_ENABLED_PICO_DMA_MEMCPY, Enable/disable assertions in the pico_dma_memcpy module, type=bool, default=0, group=pico_dma_memcpy
+#ifndef PARAM_ASSERTIONS_ENABLED_PICO_DMA_MEMCPY
+#define PARAM_ASSERTIONS_ENABLED_PICO_DMA_MEMCPY 0
+#endif
+
+// PICO_CONFIG: PICO_DMA_MEMCPY_MAX_CHANNELS, Maximum number of DMA channels pico_dma_memcpy can use, type=int, min=1, default=4, group=pico_dma_memcpy
+#ifndef PICO_DMA_MEMCPY_MAX_CHANNELS
+#define PICO_DMA_MEMCPY_MAX_CHANNELS 4
+#endif
+
+// PICO_CONFIG: PICO_DMA_MEMCPY_MIN_SIZE, Default size in bytes below which copies and fills are done by the CPU rather than DMA, type=int, min=0, default=256, group=pico_dma_memcpy
+#ifndef PICO_DMA_MEMCPY_MIN_SIZE
+#define PICO_DMA_MEMCPY_MIN_SIZE 256
+#endif
+
+// PICO_CONFIG: PICO_DMA_MEMCPY_MAX_BLOCK_TRANSFERS, Maximum number of transfers in one DMA block; longer operations are split into several blocks, type=int, min=1, default=0x0fffffff, group=pico_dma_memcpy
+#ifndef PICO_DMA_MEMCPY_MAX_BLOCK_TRANSFERS
+#define PICO_DMA_MEMCPY_MAX_BLOCK_TRANSFERS 0x0fffffff
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct dma_memcpy_op dma_memcpy_op_t;
+
+/*! \brief Callback called when an operation has finished
+ *  \ingroup pico_dma_memcpy
+ *
+ * The operation is already marked done, so may be reused (e.g. to start the next operation) by the callback.
+ *
+ * \param op the operation
+ * \param user_data the value given when the operation was started
+ */
+typedef void (*dma_memcpy_callback_t)(dma_memcpy_op_t *op, void *user_data);
+
+/*! \brief An asynchronous copy or fill
+ *  \ingroup pico_dma_memcpy
+ *
+ * This is provided by the caller, and must remain valid until the operation is done. The fields are private.
+ */
+struct dma_memcpy_op {
+    dma_memcpy_op_t *next;
+    uint8_t *dst;
+    const uint8_t *src;
+    size_t remaining;
+    dma_memcpy_callback_t callback;
+    void *user_data;
+    // the byte value of a fill, repeated in each byte; the DMA reads it from here
+    uint32_t pattern;
+    uint8_t transfer_size_log2;
+    volatile bool done;
+};
+
+/*! \brief Claim DMA channels for pico_dma_memcpy to use
+ *  \ingroup pico_dma_memcpy
+ *
+ * \param channel_count the number of channels, which is the number of operations which may run at once; at most
+ * \ref PICO_DMA_MEMCPY_MAX_CHANNELS
+ * \return true if the channels were claimed; false if there aren't enough free channels, or pico_dma_memcpy is already
+ * initialised
+ */
+bool dma_memcpy_init(uint channel_count);
+
+/*! \brief Wait for all operations to finish, and release the DMA channels
+ *  \ingroup pico_dma_memcpy
+ */
+void dma_memcpy_deinit(void);
+
+/*! \brief Set the size below which operations are done by the CPU
+ *  \ingroup pico_dma_memcpy
+ *
+ * The best value depends on the buffers' alignment and memory, and how long the CPU would rather not be busy for.
+ *
+ * \param min_size the size in bytes; 0 to use DMA for everything
+ */
+void dma_memcpy_set_min_size(size_t min_size);
+
+/*! \brief Start copying memory
+ *  \ingroup pico_dma_memcpy
+ *
+ * \param op the operation, which must not already be in progress
+ * \param dst the destination
+ * \param src the source, which must not overlap the destination
+ * \param len the number of bytes
+ * \param callback the function to call when the copy has finished, or NULL
+ * \param user_data a value passed to the callback
+ */
+void dma_memcpy_async(dma_memcpy_op_t *op, void *dst, const void *src, size_t len, dma_memcpy_callback_t callback,
+                      void *user_data);
+
+/*! \brief Start filling memory with a byte value
+ *  \ingroup pico_dma_memcpy
+ *
+ * \param op the operation, which must not already be in progress
+ * \param dst the destination
+ * \param c the byte value (converted to an unsigned char, as with memset())
+ * \param len the number of bytes
+ * \param callback the function to call when the fill has finished, or NULL
+ * \param user_data a value passed to the callback
+ */
+void dma_memset_async(dma_memcpy_op_t *op, void *dst, int c, size_t len, dma_memcpy_callback_t callback,
+                      void *user_data);
+
+/*! \brief Check whether an operation has finished
+ *  \ingroup pico_dma_memcpy
+ *
+ * \param op the operation
+ * \return true if it has finished
+ */
+static inline bool dma_memcpy_op_is_done(const dma_memcpy_op_t *op) {
+    return op->done;
+}
+
+/*! \brief Wait for an operation to finish
+ *  \ingroup pico_dma_memcpy
+ *
+ * This returns once the operation is done, which may be before its callback has returned.
+ *
+ * \param op the operation
+ */
+void dma_memcpy_op_wait(dma_memcpy_op_t *op);
+
+/*! \brief Wait for all the operations started (including queued ones) to finish, and their callbacks to return
+ *  \ingroup pico_dma_memcpy
+ *
+ * This must not be called from a callback.
+ */
+void dma_memcpy_wait_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_DMA_MEMCPY_BACKEND_H
+#define _PICO_DMA_MEMCPY_BACKEND_H
+
+#include "pico/dma_memcpy.h"
+
+/** \file pico/dma_memcpy_backend.h
+ *  \ingroup pico_dma_memcpy
+ *
+ * \brief The interface between the portable part of pico_dma_memcpy (which splits operations into blocks, and queues
+ * them) and the backend which runs the blocks; the DMA hardware on the device, or worker threads on the host
+ *
+ * The channels used by the backend are numbered from 0 to one less than the number claimed.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief Claim the channels
+ *  \ingroup pico_dma_memcpy
+ *
+ * \param channel_count the number of channels
+ * \return true if they were claimed
+ */
+bool dma_memcpy_backend_init(uint channel_count);
+
+/*! \brief Release the channels, which are all idle
+ *  \ingroup pico_dma_memcpy
+ */
+void dma_memcpy_backend_deinit(void);
+
+/*! \brief Start a block on an idle channel
+ *  \ingroup pico_dma_memcpy
+ *
+ * This is called with the lock held. When the block has finished, the backend must call \ref dma_memcpy_block_done
+ * (without the lock held).
+ *
+ * \param channel the channel
+ * \param dst the destination, aligned to the transfer size
+ * \param src the source, aligned to the transfer size
+ * \param transfer_size_log2 log2 of the transfer size in bytes (0, 1 or 2)
+ * \param read_increment false if the source is a single value to write to every destination address
+ * \param count the number of transfers
+ */
+void dma_memcpy_backend_start(uint channel, void *dst, const void *src, uint transfer_size_log2, bool read_increment,
+                              uint32_t count);
+
+/*! \brief Take the lock which protects the queue of operations from the backend's completion context
+ *  \ingroup pico_dma_memcpy
+ *
+ * \return a value to pass to \ref dma_memcpy_backend_unlock
+ */
+uint32_t dma_memcpy_backend_lock(void);
+
+/*! \brief Release the lock taken by \ref dma_memcpy_backend_lock
+ *  \ingroup pico_dma_memcpy
+ *
+ * \param save the value returned by \ref dma_memcpy_backend_lock
+ */
+void dma_memcpy_backend_unlock(uint32_t save);
+
+/*! \brief Wait until a condition, which only changes when a block finishes, is true
+ *  \ingroup pico_dma_memcpy
+ *
+ * \param condition the condition, which is checked with the lock held
+ * \param arg the argument to pass to the condition
+ */
+void dma_memcpy_backend_wait(bool (*condition)(const void *arg), const void *arg);
+
+/*! \brief Wake anything waiting in \ref dma_memcpy_backend_wait to check its condition again
+ *  \ingroup pico_dma_memcpy
+ */
+void dma_memcpy_backend_notify(void);
+
+/*! \brief Called by the backend when the block started on a channel has finished
+ *  \ingroup pico_dma_memcpy
+ *
+ * \param channel the channel
+ */
+void dma_memcpy_block_done(uint channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
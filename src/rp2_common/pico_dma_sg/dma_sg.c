@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/dma_sg.h"
+#include "hardware/irq.h"
+
+static dma_sg_t *dma_sg_by_data_chan[NUM_DMA_CHANNELS];
+static uint8_t dma_sg_irq_users[NUM_DMA_IRQS];
+
+// The null descriptor leaves a zero read address behind, which no real transfer can have
+static bool dma_sg_reached_end(const dma_sg_t *sg) {
+    return !dma_channel_is_busy(sg->data_chan) && !dma_hw->ch[sg->data_chan].read_addr;
+}
+
+static void dma_sg_irq_handler(uint irq_index) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        dma_sg_t *sg = dma_sg_by_data_chan[ch];
+        if (sg && sg->irq_index == (int8_t)irq_index && dma_irqn_get_channel_status(irq_index, ch)) {
+            dma_irqn_acknowledge_channel(irq_index, ch);
+            if (sg->callback) sg->callback(sg, dma_sg_reached_end(sg));
+        }
+    }
+}
+
+static void dma_sg_irq0_handler(void) {
+    dma_sg_irq_handler(0);
+}
+
+static void dma_sg_irq1_handler(void) {
+    dma_sg_irq_handler(1);
+}
+
+#if NUM_DMA_IRQS > 2
+static void dma_sg_irq2_handler(void) {
+    dma_sg_irq_handler(2);
+}
+
+static void dma_sg_irq3_handler(void) {
+    dma_sg_irq_handler(3);
+}
+#endif
+
+static const irq_handler_t dma_sg_irq_handlers[NUM_DMA_IRQS] = {
+    dma_sg_irq0_handler,
+    dma_sg_irq1_handler,
+#if NUM_DMA_IRQS > 2
+    dma_sg_irq2_handler,
+    dma_sg_irq3_handler,
+#endif
+};
+
+void dma_sg_init(dma_sg_t *sg, uint ctrl_chan, uint data_chan) {
+    invalid_params_if(PICO_DMA_SG, ctrl_chan == data_chan);
+    sg->ctrl_chan = (uint8_t)ctrl_chan;
+    sg->data_chan = (uint8_t)data_chan;
+    sg->irq_index = -1;
+    sg->list = NULL;
+    sg->callback = NULL;
+    sg->user_data = NULL;
+
+    // The control channel copies one descriptor (4 words) to the data channel's alias 1 registers; the write
+    // ring wraps the write address back to AL1_CTRL after each descriptor, and the read address walks the list.
+    dma_channel_config c = dma_channel_get_default_config(ctrl_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, 4);
+    channel_config_set_irq_quiet(&c, true);
+    dma_channel_configure(ctrl_chan, &c, &dma_hw->ch[data_chan].al1_ctrl, NULL,
+                          dma_encode_transfer_count(sizeof(dma_sg_desc_t) / 4), false);
+}
+
+void dma_sg_deinit(dma_sg_t *sg) {
+    dma_sg_set_irq_callback(sg, 0, NULL, NULL);
+    dma_sg_abort(sg);
+    dma_channel_cleanup(sg->ctrl_chan);
+    dma_channel_cleanup(sg->data_chan);
+}
+
+void dma_sg_start(dma_sg_t *sg, const dma_sg_list_t *list) {
+    invalid_params_if(PICO_DMA_SG, !list->terminated);
+    invalid_params_if(PICO_DMA_SG, list->ctrl_chan != sg->ctrl_chan || list->data_chan != sg->data_chan);
+    sg->list = list;
+    dma_channel_set_read_addr(sg->ctrl_chan, list->descs, true);
+}
+
+void dma_sg_abort(dma_sg_t *sg) {
+    // stop the control channel first, otherwise a completing data transfer could chain to it
+    dma_channel_abort(sg->ctrl_chan);
+    dma_channel_abort(sg->data_chan);
+    // the control channel may have been mid-way through loading a descriptor; leave the write ring aligned
+    dma_channel_set_write_addr(sg->ctrl_chan, &dma_hw->ch[sg->data_chan].al1_ctrl, false);
+    if (sg->irq_index >= 0) {
+        dma_irqn_acknowledge_channel((uint)sg->irq_index, sg->data_chan);
+    }
+}
+
+void dma_sg_wait_for_finish_blocking(const dma_sg_t *sg) {
+    invalid_params_if(PICO_DMA_SG, sg->list && sg->list->loops);
+    while (dma_sg_is_busy(sg)) {
+        tight_loop_contents();
+    }
+}
+
+int dma_sg_get_position(const dma_sg_t *sg) {
+    if (!sg->list) return -1;
+    uintptr_t next = dma_hw->ch[sg->ctrl_chan].read_addr;
+    return (int)((next - (uintptr_t)sg->list->descs) / sizeof(dma_sg_desc_t)) - 1;
+}
+
+void dma_sg_set_irq_callback(dma_sg_t *sg, uint irq_index, dma_sg_callback_t callback, void *user_data) {
+    check_dma_channel_param(sg->data_chan);
+    if (sg->irq_index >= 0) {
+        uint old_index = (uint)sg->irq_index;
+        dma_irqn_set_channel_enabled(old_index, sg->data_chan, false);
+        dma_sg_by_data_chan[sg->data_chan] = NULL;
+        sg->irq_index = -1;
+        if (!--dma_sg_irq_users[old_index]) {
+            irq_remove_handler(DMA_IRQ_NUM(old_index), dma_sg_irq_handlers[old_index]);
+        }
+    }
+    sg->callback = callback;
+    sg->user_data = user_data;
+    if (callback) {
+        invalid_params_if(PICO_DMA_SG, irq_index >= NUM_DMA_IRQS);
+        sg->irq_index = (int8_t)irq_index;
+        dma_sg_by_data_chan[sg->data_chan] = sg;
+        if (!dma_sg_irq_users[irq_index]++) {
+            irq_add_shared_handler(DMA_IRQ_NUM(irq_index), dma_sg_irq_handlers[irq_index],
+                                   PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+            irq_set_enabled(DMA_IRQ_NUM(irq_index), true);
+        }
+        dma_irqn_acknowledge_channel(irq_index, sg->data_chan);
+        dma_irqn_set_channel_enabled(irq_index, sg->data_chan, true);
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/dma_sg_list.h"
+
+#define DMA_SG_CTRL_MANAGED_BITS (DMA_CH0_CTRL_TRIG_EN_BITS | DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS | DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS)
+
+void dma_sg_list_init(dma_sg_list_t *list, dma_sg_desc_t *descs, uint capacity, uint ctrl_chan, uint data_chan) {
+    invalid_params_if(PICO_DMA_SG, capacity < 2);
+    invalid_params_if(PICO_DMA_SG, ctrl_chan == data_chan);
+    invalid_params_if(PICO_DMA_SG, ctrl_chan >= NUM_DMA_CHANNELS || data_chan >= NUM_DMA_CHANNELS);
+    list->descs = descs;
+    list->capacity = capacity;
+    list->ctrl_chan = (uint8_t)ctrl_chan;
+    list->data_chan = (uint8_t)data_chan;
+    dma_sg_list_reset(list);
+}
+
+void dma_sg_list_reset(dma_sg_list_t *list) {
+    list->count = 0;
+    list->terminated = false;
+    list->loops = false;
+    list->loop_addr = 0;
+}
+
+static dma_sg_desc_t *dma_sg_list_append(dma_sg_list_t *list, uint32_t ctrl, uintptr_t read_addr, uintptr_t write_addr, uint32_t transfer_count) {
+    dma_sg_desc_t *desc = &list->descs[list->count++];
+    desc->ctrl = ctrl;
+    desc->read_addr = read_addr;
+    desc->write_addr = write_addr;
+    desc->transfer_count = transfer_count;
+    return desc;
+}
+
+int dma_sg_list_add(dma_sg_list_t *list, volatile void *write_addr, const volatile void *read_addr,
+                    uint32_t transfer_count, uint32_t ctrl, bool irq) {
+    invalid_params_if(PICO_DMA_SG, list->terminated);
+    invalid_params_if(PICO_DMA_SG, !transfer_count);
+    // always leave room for the terminating descriptor
+    if (list->count + 1 >= list->capacity) return -1;
+    ctrl &= ~DMA_SG_CTRL_MANAGED_BITS;
+    ctrl |= DMA_CH0_CTRL_TRIG_EN_BITS | ((uint32_t)list->ctrl_chan << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+    if (!irq) ctrl |= DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS;
+    int index = (int)list->count;
+    dma_sg_list_append(list, ctrl, (uintptr_t)read_addr, (uintptr_t)write_addr, transfer_count);
+    return index;
+}
+
+// CTRL value for descriptors the chain uses for its own bookkeeping: 32 bit, unpaced and chained to
+// itself (i.e. not chained), with the IRQ_QUIET bit left for the caller to choose.
+static uint32_t dma_sg_internal_ctrl(const dma_sg_list_t *list) {
+    return DMA_CH0_CTRL_TRIG_EN_BITS |
+           (2u << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB) |
+           ((uint32_t)DMA_CH0_CTRL_TRIG_TREQ_SEL_VALUE_PERMANENT << DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB) |
+           ((uint32_t)list->data_chan << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+}
+
+void dma_sg_list_end(dma_sg_list_t *list, bool irq) {
+    invalid_params_if(PICO_DMA_SG, list->terminated);
+    // a zero write to TRANS_COUNT_TRIG is a null trigger; in IRQ_QUIET mode that raises the channel's IRQ
+    uint32_t ctrl = dma_sg_internal_ctrl(list);
+    if (irq) ctrl |= DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS;
+    dma_sg_list_append(list, ctrl, 0, 0, 0);
+    list->terminated = true;
+}
+
+void dma_sg_list_loop(dma_sg_list_t *list, uint to_index) {
+    invalid_params_if(PICO_DMA_SG, list->terminated);
+    invalid_params_if(PICO_DMA_SG, to_index >= list->count);
+    list->loop_addr = (uintptr_t)&list->descs[to_index];
+    dma_sg_list_append(list, dma_sg_internal_ctrl(list) | DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS,
+                       (uintptr_t)&list->loop_addr,
+                       DMA_SG_CHANNEL_REG_ADDR(list->ctrl_chan, DMA_CH0_AL3_READ_ADDR_TRIG_OFFSET), 1);
+    list->terminated = true;
+    list->loops = true;
+}
+
+uint32_t dma_sg_list_get_byte_count(const dma_sg_list_t *list) {
+    uint32_t bytes = 0;
+    uint n = list->loops ? list->count - 1 : list->count;
+    for (uint i = 0; i < n; i++) {
+        const dma_sg_desc_t *desc = &list->descs[i];
+        uint size_log2 = (desc->ctrl & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB;
+        uint32_t count = desc->transfer_count;
+#ifdef DMA_CH0_TRANS_COUNT_COUNT_BITS
+        count &= DMA_CH0_TRANS_COUNT_COUNT_BITS;
+#endif
+        bytes += count << size_log2;
+    }
+    return bytes;
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/dma_sg_sim.h"
+
+#define DMA_SG_SIM_DEFAULT_MAX_DESCRIPTORS 65536u
+#define DMA_SG_SIM_TREQ_PERMANENT DMA_CH0_CTRL_TRIG_TREQ_SEL_VALUE_PERMANENT
+
+typedef struct {
+    const dma_sg_list_t *list;
+    const dma_sg_sim_config_t *config;
+    dma_sg_sim_result_t *result;
+} dma_sg_sim_state_t;
+
+dma_sg_sim_config_t dma_sg_sim_get_default_config(void) {
+    dma_sg_sim_config_t config = {
+        .execute = true,
+        .max_descriptors = DMA_SG_SIM_DEFAULT_MAX_DESCRIPTORS,
+        .cycles_per_transfer = 1,
+        .cycles_per_descriptor = 6,
+    };
+    return config;
+}
+
+static bool dma_sg_sim_is_dma_register(uintptr_t addr) {
+    return addr >= DMA_BASE && addr < DMA_BASE + NUM_DMA_CHANNELS * DMA_SG_CHANNEL_STRIDE;
+}
+
+static uintptr_t dma_sg_sim_step_addr(uintptr_t addr, uint size, bool incr, bool rev, uint ring_bits) {
+    if (!incr) return addr;
+    uintptr_t next = rev ? addr - size : addr + size;
+    if (ring_bits) {
+        uintptr_t mask = (((uintptr_t)1) << ring_bits) - 1;
+        next = (addr & ~mask) | (next & mask);
+    }
+    return next;
+}
+
+static void dma_sg_sim_transfer_word(uintptr_t write_addr, uintptr_t read_addr, uint size, bool bswap) {
+    switch (size) {
+        case 1:
+            *(volatile uint8_t *)write_addr = *(const volatile uint8_t *)read_addr;
+            break;
+        case 2: {
+            uint16_t v = *(const volatile uint16_t *)read_addr;
+            if (bswap) v = (uint16_t)((v >> 8) | (v << 8));
+            *(volatile uint16_t *)write_addr = v;
+            break;
+        }
+        default: {
+            uint32_t v = *(const volatile uint32_t *)read_addr;
+            if (bswap) v = __builtin_bswap32(v);
+            *(volatile uint32_t *)write_addr = v;
+            break;
+        }
+    }
+}
+
+// Records an error and returns -1, i.e. "stop the chain"
+static int dma_sg_sim_fail(dma_sg_sim_result_t *result, uint index, dma_sg_sim_status_t status) {
+    result->error_index = index;
+    result->status = status;
+    return -1;
+}
+
+static void dma_sg_sim_irq(dma_sg_sim_state_t *state, uint index, bool finished) {
+    state->result->irqs++;
+    if (state->config->irq_handler) {
+        state->config->irq_handler(index, state->result->cycles, finished, state->config->user_data);
+    }
+}
+
+// Returns the index of the next descriptor to load, or -1 once the chain stops (result->status is then set)
+static int dma_sg_sim_step(dma_sg_sim_state_t *state, uint index) {
+    const dma_sg_list_t *list = state->list;
+    const dma_sg_sim_config_t *config = state->config;
+    dma_sg_sim_result_t *result = state->result;
+    const dma_sg_desc_t *desc = &list->descs[index];
+    uint32_t ctrl = desc->ctrl;
+    uint32_t count = desc->transfer_count;
+
+    result->descriptors++;
+    result->cycles += config->cycles_per_descriptor;
+
+#ifdef DMA_CH0_TRANS_COUNT_MODE_BITS
+    if (count & DMA_CH0_TRANS_COUNT_MODE_BITS) {
+        return dma_sg_sim_fail(result, index, DMA_SG_SIM_ERR_BAD_COUNT_MODE);
+    }
+#endif
+    if (!count) {
+        // null trigger: in IRQ_QUIET mode this raises the channel IRQ
+        if (ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS) dma_sg_sim_irq(state, index, true);
+        result->status = DMA_SG_SIM_OK;
+        return -1;
+    }
+    if (!(ctrl & DMA_CH0_CTRL_TRIG_EN_BITS)) {
+        return dma_sg_sim_fail(result, index, DMA_SG_SIM_ERR_BAD_CHAIN);
+    }
+    uint size_log2 = (ctrl & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB;
+    if (size_log2 > 2) {
+        return dma_sg_sim_fail(result, index, DMA_SG_SIM_ERR_BAD_SIZE);
+    }
+    uint size = 1u << size_log2;
+    uintptr_t read_addr = desc->read_addr;
+    uintptr_t write_addr = desc->write_addr;
+    if (!read_addr || !write_addr) {
+        return dma_sg_sim_fail(result, index, DMA_SG_SIM_ERR_NULL_ADDRESS);
+    }
+    if ((read_addr | write_addr) & (size - 1)) {
+        return dma_sg_sim_fail(result, index, DMA_SG_SIM_ERR_MISALIGNED);
+    }
+    uint chain_to = (ctrl & DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) >> DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB;
+
+    if (dma_sg_sim_is_dma_register(write_addr)) {
+        // the only register write a chain may make is the jump, which restarts the control channel
+        if (write_addr != DMA_SG_CHANNEL_REG_ADDR(list->ctrl_chan, DMA_CH0_AL3_READ_ADDR_TRIG_OFFSET) || count != 1) {
+            return dma_sg_sim_fail(result, index, DMA_SG_SIM_ERR_BAD_JUMP);
+        }
+        uintptr_t target = *(const uintptr_t *)read_addr;
+        uintptr_t base = (uintptr_t)list->descs;
+        if (target < base || target >= base + list->count * sizeof(dma_sg_desc_t) ||
+            (target - base) % sizeof(dma_sg_desc_t)) {
+            return dma_sg_sim_fail(result, index, DMA_SG_SIM_ERR_BAD_JUMP);
+        }
+        result->jumps++;
+        result->cycles += config->cycles_per_transfer;
+        return (int)((target - base) / sizeof(dma_sg_desc_t));
+    }
+    if (chain_to != list->ctrl_chan) {
+        return dma_sg_sim_fail(result, index, DMA_SG_SIM_ERR_BAD_CHAIN);
+    }
+
+    bool incr_read = ctrl & DMA_CH0_CTRL_TRIG_INCR_READ_BITS;
+    bool incr_write = ctrl & DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS;
+    bool rev_read = false, rev_write = false;
+#ifdef DMA_CH0_CTRL_TRIG_INCR_READ_REV_BITS
+    rev_read = ctrl & DMA_CH0_CTRL_TRIG_INCR_READ_REV_BITS;
+    rev_write = ctrl & DMA_CH0_CTRL_TRIG_INCR_WRITE_REV_BITS;
+#endif
+    uint ring_bits = (ctrl & DMA_CH0_CTRL_TRIG_RING_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_RING_SIZE_LSB;
+    bool ring_write = ctrl & DMA_CH0_CTRL_TRIG_RING_SEL_BITS;
+    bool bswap = ctrl & DMA_CH0_CTRL_TRIG_BSWAP_BITS;
+    uint treq = (ctrl & DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) >> DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB;
+
+    uint32_t cycles_per = config->cycles_per_transfer;
+    if (treq != DMA_SG_SIM_TREQ_PERMANENT && config->treq_period) {
+        uint32_t period = config->treq_period(treq, config->user_data);
+        if (period > cycles_per) cycles_per = period;
+    }
+
+    if (config->execute) {
+        for (uint32_t i = 0; i < count; i++) {
+            dma_sg_sim_transfer_word(write_addr, read_addr, size, bswap);
+            read_addr = dma_sg_sim_step_addr(read_addr, size, incr_read, rev_read, ring_write ? 0 : ring_bits);
+            write_addr = dma_sg_sim_step_addr(write_addr, size, incr_write, rev_write, ring_write ? ring_bits : 0);
+        }
+    }
+    result->transfers += count;
+    result->bytes += (uint64_t)count * size;
+    result->cycles += (uint64_t)count * cycles_per;
+
+    if (!(ctrl & DMA_CH0_CTRL_TRIG_IRQ_QUIET_BITS)) dma_sg_sim_irq(state, index, false);
+    return (int)index + 1;
+}
+
+dma_sg_sim_status_t dma_sg_sim_run(const dma_sg_list_t *list, const dma_sg_sim_config_t *config, dma_sg_sim_result_t *result) {
+    dma_sg_sim_config_t default_config;
+    if (!config) {
+        default_config = dma_sg_sim_get_default_config();
+        config = &default_config;
+    }
+    memset(result, 0, sizeof(*result));
+    if (!list->terminated) {
+        dma_sg_sim_fail(result, list->count, DMA_SG_SIM_ERR_NOT_TERMINATED);
+        return result->status;
+    }
+    dma_sg_sim_state_t state = {
+        .list = list,
+        .config = config,
+        .result = result,
+    };
+    uint32_t limit = config->max_descriptors ? config->max_descriptors : DMA_SG_SIM_DEFAULT_MAX_DESCRIPTORS;
+    int index = 0;
+    while (index >= 0) {
+        if (result->descriptors == limit) {
+            result->status = DMA_SG_SIM_LIMIT_REACHED;
+            break;
+        }
+        if ((uint)index >= list->count) {
+            // ran off the end of the list without a terminator
+            index = dma_sg_sim_fail(result, (uint)index, DMA_SG_SIM_ERR_NOT_TERMINATED);
+            break;
+        }
+        index = dma_sg_sim_step(&state, (uint)index);
+    }
+    return result->status;
+}
+
+dma_sg_sim_status_t dma_sg_sim_validate(const dma_sg_list_t *list) {
+    dma_sg_sim_config_t config = dma_sg_sim_get_default_config();
+    config.execute = false;
+    // one pass over every descriptor, plus the jump
+    config.max_descriptors = list->count + 1;
+    dma_sg_sim_result_t result;
+    dma_sg_sim_status_t status = dma_sg_sim_run(list, &config, &result);
+    return status == DMA_SG_SIM_LIMIT_REACHED ? DMA_SG_SIM_OK : status;
+}
+
+const char *dma_sg_sim_status_str(dma_sg_sim_status_t status) {
+    switch (status) {
+        case DMA_SG_SIM_OK: return "ok";
+        case DMA_SG_SIM_LIMIT_REACHED: return "descriptor limit reached";
+        case DMA_SG_SIM_ERR_NOT_TERMINATED: return "list not terminated";
+        case DMA_SG_SIM_ERR_BAD_CHAIN: return "descriptor not enabled or not chained to control channel";
+        case DMA_SG_SIM_ERR_BAD_SIZE: return "invalid data size";
+        case DMA_SG_SIM_ERR_MISALIGNED: return "misaligned address";
+        case DMA_SG_SIM_ERR_NULL_ADDRESS: return "null address";
+        case DMA_SG_SIM_ERR_BAD_JUMP: return "invalid register write or jump target";
+        case DMA_SG_SIM_ERR_BAD_COUNT_MODE: return "unsupported transfer count mode";
+        default: return "unknown";
+    }
+}
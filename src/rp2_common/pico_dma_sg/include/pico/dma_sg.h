@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_DMA_SG_H
+#define _PICO_DMA_SG_H
+
+#include "pico.h"
+#include "hardware/dma.h"
+#include "pico/dma_sg_list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/dma_sg.h
+ *  \defgroup pico_dma_sg pico_dma_sg
+ *
+ * \brief Scatter-gather DMA using a control channel and a data channel
+ *
+ * A \ref dma_sg_t pairs two DMA channels. The control channel copies descriptors from a \ref dma_sg_list_t
+ * in RAM into the data channel's registers, and the data channel performs each transfer, chaining back to the
+ * control channel when done. This allows multi-segment buffers, SPI command/data sequences, and endlessly
+ * repeating rings to run with no CPU involvement.
+ *
+ * Example:
+ * \code
+ * dma_sg_t sg;
+ * dma_sg_init(&sg, dma_claim_unused_channel(true), dma_claim_unused_channel(true));
+ *
+ * dma_sg_desc_t descs[3];
+ * dma_sg_list_t list;
+ * dma_sg_list_init_for(&list, descs, count_of(descs), &sg);
+ * dma_channel_config c = dma_channel_get_default_config(sg.data_chan);
+ * channel_config_set_dreq(&c, spi_get_dreq(spi_default, true));
+ * channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+ * channel_config_set_write_increment(&c, false);
+ * dma_sg_list_add(&list, &spi_get_hw(spi_default)->dr, header, sizeof(header), channel_config_get_ctrl_value(&c), false);
+ * dma_sg_list_add(&list, &spi_get_hw(spi_default)->dr, payload, payload_len, channel_config_get_ctrl_value(&c), false);
+ * dma_sg_list_end(&list, true);
+ *
+ * dma_sg_start(&sg, &list);
+ * dma_sg_wait_for_finish_blocking(&sg);
+ * \endcode
+ */
+
+typedef struct dma_sg dma_sg_t;
+
+/*! \brief Callback invoked from the DMA IRQ handler when the data channel raises an interrupt
+ *  \ingroup pico_dma_sg
+ *
+ * \param sg the scatter-gather instance
+ * \param finished true if the chain has completed (i.e. a null descriptor has been reached)
+ */
+typedef void (*dma_sg_callback_t)(dma_sg_t *sg, bool finished);
+
+/*! \brief A scatter-gather DMA instance
+ *  \ingroup pico_dma_sg
+ */
+struct dma_sg {
+    uint8_t ctrl_chan;
+    uint8_t data_chan;
+    int8_t irq_index;
+    const dma_sg_list_t *list;
+    dma_sg_callback_t callback;
+    void *user_data;
+};
+
+/*! \brief Initialize a scatter-gather instance using the given DMA channels
+ *  \ingroup pico_dma_sg
+ *
+ * The channels should already be claimed by the caller. The control channel is configured immediately;
+ * the data channel is configured by each descriptor.
+ *
+ * \param sg the instance to initialize
+ * \param ctrl_chan the channel which loads descriptors
+ * \param data_chan the channel which performs transfers
+ */
+void dma_sg_init(dma_sg_t *sg, uint ctrl_chan, uint data_chan);
+
+/*! \brief Release the resources used by a scatter-gather instance
+ *  \ingroup pico_dma_sg
+ *
+ * Any chain in progress is aborted, and the IRQ callback (if any) is removed. The channels are not unclaimed.
+ *
+ * \param sg the instance
+ */
+void dma_sg_deinit(dma_sg_t *sg);
+
+/*! \brief Initialize a descriptor list for use with a given scatter-gather instance
+ *  \ingroup pico_dma_sg
+ *
+ * \param list the list to initialize
+ * \param descs storage for the descriptors
+ * \param capacity the number of entries in \p descs
+ * \param sg the instance which will run the list
+ */
+static inline void dma_sg_list_init_for(dma_sg_list_t *list, dma_sg_desc_t *descs, uint capacity, const dma_sg_t *sg) {
+    dma_sg_list_init(list, descs, capacity, sg->ctrl_chan, sg->data_chan);
+}
+
+/*! \brief Start running a descriptor list
+ *  \ingroup pico_dma_sg
+ *
+ * \param sg the instance, which must not be busy
+ * \param list a terminated list built for this instance's channels. It must remain valid until the chain completes or is aborted
+ */
+void dma_sg_start(dma_sg_t *sg, const dma_sg_list_t *list);
+
+/*! \brief Abort a running chain
+ *  \ingroup pico_dma_sg
+ *
+ * The control channel is stopped first so that it cannot re-trigger the data channel.
+ *
+ * \param sg the instance
+ */
+void dma_sg_abort(dma_sg_t *sg);
+
+/*! \brief Determine if a chain is still in progress
+ *  \ingroup pico_dma_sg
+ *
+ * \param sg the instance
+ * \return true if either channel is busy
+ */
+static inline bool dma_sg_is_busy(const dma_sg_t *sg) {
+    return dma_channel_is_busy(sg->ctrl_chan) || dma_channel_is_busy(sg->data_chan);
+}
+
+/*! \brief Wait for a (non looping) chain to complete
+ *  \ingroup pico_dma_sg
+ *
+ * \param sg the instance
+ */
+void dma_sg_wait_for_finish_blocking(const dma_sg_t *sg);
+
+/*! \brief Return the index of the descriptor most recently loaded into the data channel
+ *  \ingroup pico_dma_sg
+ *
+ * This is derived from the control channel's read address, and so is a snapshot that may already be stale
+ * for short transfers.
+ *
+ * \param sg the instance
+ * \return the descriptor index, or -1 if no descriptor has been loaded
+ */
+int dma_sg_get_position(const dma_sg_t *sg);
+
+/*! \brief Set (or clear) the callback for data channel interrupts
+ *  \ingroup pico_dma_sg
+ *
+ * The data channel raises an interrupt at the end of each descriptor added with `irq` set, and when a
+ * null descriptor terminated with `irq` set is reached. A shared handler is installed on the given DMA IRQ.
+ *
+ * \param sg the instance
+ * \param irq_index the DMA IRQ index (0 to NUM_DMA_IRQS - 1) to use
+ * \param callback the callback, or NULL to disable interrupts for this instance
+ * \param user_data value stored in \ref dma_sg_t::user_data for the callback's use
+ */
+void dma_sg_set_irq_callback(dma_sg_t *sg, uint irq_index, dma_sg_callback_t callback, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
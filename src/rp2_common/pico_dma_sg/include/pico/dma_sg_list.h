@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_DMA_SG_LIST_H
+#define _PICO_DMA_SG_LIST_H
+
+#include "pico.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/regs/dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/dma_sg_list.h
+ *  \defgroup dma_sg_list dma_sg_list
+ *  \ingroup pico_dma_sg
+ *
+ * \brief Scatter-gather descriptor lists for \ref pico_dma_sg
+ *
+ * A descriptor list is an array of \ref dma_sg_desc_t in RAM. Each descriptor holds the values for the data
+ * channel's alias 1 registers (CTRL, READ_ADDR, WRITE_ADDR, TRANS_COUNT_TRIG), which the control channel copies
+ * in one 4 word burst, triggering the data channel on the final write. The data channel chains back to the control
+ * channel on completion so that the next descriptor is loaded.
+ *
+ * A list ends either with a null descriptor (a zero transfer count, which is a null trigger and stops the chain)
+ * or with a jump descriptor which makes the data channel write the control channel's alias 3 READ_ADDR_TRIG
+ * register, restarting the control channel at an earlier descriptor to form a ring.
+ *
+ * The functions in this header only build lists in memory; they do not touch the DMA hardware, and so may also
+ * be used in host builds along with \ref dma_sg_sim to validate and time descriptor chains.
+ */
+
+// PICO_CONFIG: PARAM_ASSERTIONS_ENABLED_PICO_DMA_SG, Enable/disable assertions in the pico_dma_sg module, type=bool, default=0, group=pico_dma_sg
+#ifndef PARAM_ASSERTIONS_ENABLED_PICO_DMA_SG
+#define PARAM_ASSERTIONS_ENABLED_PICO_DMA_SG 0
+#endif
+
+/** \brief Distance in bytes between the register blocks of consecutive DMA channels
+ *  \ingroup dma_sg_list
+ */
+#define DMA_SG_CHANNEL_STRIDE (DMA_CH1_READ_ADDR_OFFSET - DMA_CH0_READ_ADDR_OFFSET)
+
+/** \brief Bus address of a DMA channel register given its channel 0 offset
+ *  \ingroup dma_sg_list
+ */
+#define DMA_SG_CHANNEL_REG_ADDR(channel, ch0_offset) ((uintptr_t)(DMA_BASE + (ch0_offset) + (channel) * DMA_SG_CHANNEL_STRIDE))
+
+/*! \brief A single scatter-gather descriptor
+ *  \ingroup dma_sg_list
+ *
+ * The field order matches the data channel's alias 1 register layout, so that on device the control channel
+ * can copy a descriptor with a single 4 word transfer.
+ */
+typedef struct dma_sg_desc {
+    uint32_t ctrl;           ///< Value for the data channel's CTRL register
+    uintptr_t read_addr;     ///< Value for the data channel's READ_ADDR register
+    uintptr_t write_addr;    ///< Value for the data channel's WRITE_ADDR register
+    uint32_t transfer_count; ///< Value for the data channel's TRANS_COUNT register; 0 terminates the chain
+} dma_sg_desc_t;
+
+#if PICO_ON_DEVICE
+static_assert(sizeof(dma_sg_desc_t) == 16, "dma_sg_desc_t must match the alias 1 register block");
+#endif
+
+/*! \brief A scatter-gather descriptor list under construction
+ *  \ingroup dma_sg_list
+ *
+ * The list (not just the descriptor array) must remain valid while it is running, as a looping list
+ * reads its jump target from \p loop_addr.
+ */
+typedef struct dma_sg_list {
+    dma_sg_desc_t *descs;
+    uint capacity;
+    uint count;
+    uint8_t ctrl_chan;
+    uint8_t data_chan;
+    bool terminated;
+    bool loops;
+    uintptr_t loop_addr;
+} dma_sg_list_t;
+
+/*! \brief Build a data channel CTRL value suitable for \ref dma_sg_list_add
+ *  \ingroup dma_sg_list
+ *
+ * The enable, chain and IRQ quiet bits are filled in by \ref dma_sg_list_add. On device, the value returned
+ * by \ref channel_config_get_ctrl_value() may be used instead to access all channel options.
+ *
+ * \param size_log2 transfer size; 0 for 8 bit, 1 for 16 bit or 2 for 32 bit
+ * \param incr_read true to increment the read address after each transfer
+ * \param incr_write true to increment the write address after each transfer
+ * \param treq the DREQ or timer to pace the transfer, or DMA_CH0_CTRL_TRIG_TREQ_SEL_VALUE_PERMANENT for unpaced
+ * \return the CTRL register value
+ */
+static inline uint32_t dma_sg_make_ctrl(uint size_log2, bool incr_read, bool incr_write, uint treq) {
+    return (size_log2 << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB) |
+           (incr_read ? DMA_CH0_CTRL_TRIG_INCR_READ_BITS : 0) |
+           (incr_write ? DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS : 0) |
+           (treq << DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB);
+}
+
+/*! \brief Initialize a descriptor list
+ *  \ingroup dma_sg_list
+ *
+ * One entry of \p capacity is always kept for the terminating (null or jump) descriptor.
+ *
+ * \param list the list to initialize
+ * \param descs storage for the descriptors; on device this must be in memory readable by the DMA
+ * \param capacity the number of entries in \p descs, which must be at least 2
+ * \param ctrl_chan the DMA channel that will load the descriptors
+ * \param data_chan the DMA channel that will perform the transfers
+ */
+void dma_sg_list_init(dma_sg_list_t *list, dma_sg_desc_t *descs, uint capacity, uint ctrl_chan, uint data_chan);
+
+/*! \brief Remove all descriptors from a list so that it can be rebuilt
+ *  \ingroup dma_sg_list
+ *
+ * \param list the list
+ */
+void dma_sg_list_reset(dma_sg_list_t *list);
+
+/*! \brief Append a transfer to a descriptor list
+ *  \ingroup dma_sg_list
+ *
+ * \param list the list, which must not yet be terminated
+ * \param write_addr the initial write address
+ * \param read_addr the initial read address
+ * \param transfer_count the number of transfers; must be non zero
+ * \param ctrl the data channel CTRL value (see \ref dma_sg_make_ctrl). The EN, CHAIN_TO and IRQ_QUIET bits are overwritten
+ * \param irq true to raise the data channel's interrupt when this transfer completes
+ * \return the index of the new descriptor, or -1 if the list is full
+ */
+int dma_sg_list_add(dma_sg_list_t *list, volatile void *write_addr, const volatile void *read_addr,
+                    uint32_t transfer_count, uint32_t ctrl, bool irq);
+
+/*! \brief Terminate a descriptor list with a null descriptor
+ *  \ingroup dma_sg_list
+ *
+ * \param list the list, which must not already be terminated
+ * \param irq true to raise the data channel's interrupt when the null descriptor is reached (i.e. on completion of the chain)
+ */
+void dma_sg_list_end(dma_sg_list_t *list, bool irq);
+
+/*! \brief Terminate a descriptor list with a jump back to an earlier descriptor, forming a ring
+ *  \ingroup dma_sg_list
+ *
+ * A looping list never completes on its own; it must be stopped with \ref dma_sg_abort() (or the list rebuilt).
+ * The data channel performs the jump itself by writing the control channel's READ_ADDR_TRIG register.
+ *
+ * \param list the list, which must not already be terminated
+ * \param to_index the index of the descriptor to continue with
+ */
+void dma_sg_list_loop(dma_sg_list_t *list, uint to_index);
+
+/*! \brief Return the total number of bytes transferred by one pass over a terminated list
+ *  \ingroup dma_sg_list
+ *
+ * \param list the list
+ * \return the number of bytes transferred by the data descriptors (excluding the jump descriptor of a looping list)
+ */
+uint32_t dma_sg_list_get_byte_count(const dma_sg_list_t *list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
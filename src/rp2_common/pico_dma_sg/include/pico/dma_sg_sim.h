@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_DMA_SG_SIM_H
+#define _PICO_DMA_SG_SIM_H
+
+#include "pico/dma_sg_list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/dma_sg_sim.h
+ *  \defgroup dma_sg_sim dma_sg_sim
+ *  \ingroup pico_dma_sg
+ *
+ * \brief Software interpreter for scatter-gather descriptor lists
+ *
+ * The interpreter follows a \ref dma_sg_list_t the same way the control and data channels do: it loads each
+ * descriptor, checks it, optionally performs the transfer against memory (honouring data size, address increment,
+ * byte swap and address wrapping), raises simulated interrupts, and follows jump descriptors and null triggers.
+ *
+ * It also keeps a simple bus-cycle count, so that the cost of descriptor loads relative to data transfers can be
+ * estimated. Each unpaced transfer is counted as \ref dma_sg_sim_config_t::cycles_per_transfer cycles, and each
+ * descriptor load as \ref dma_sg_sim_config_t::cycles_per_descriptor; paced transfers are counted at the period
+ * returned by \ref dma_sg_sim_config_t::treq_period if it is provided.
+ *
+ * The interpreter is portable C and is available in host builds as the pico_dma_sg_sim library.
+ */
+
+/*! \brief Outcome of interpreting a descriptor list
+ *  \ingroup dma_sg_sim
+ */
+typedef enum dma_sg_sim_status {
+    DMA_SG_SIM_OK = 0,                   ///< A null descriptor was reached
+    DMA_SG_SIM_LIMIT_REACHED,            ///< The descriptor limit was reached first (expected for looping lists)
+    DMA_SG_SIM_ERR_NOT_TERMINATED,       ///< The list has no terminating descriptor
+    DMA_SG_SIM_ERR_BAD_CHAIN,            ///< A data descriptor does not chain back to the control channel, or is not enabled
+    DMA_SG_SIM_ERR_BAD_SIZE,             ///< The DATA_SIZE field is invalid
+    DMA_SG_SIM_ERR_MISALIGNED,           ///< A read or write address is not aligned to the transfer size
+    DMA_SG_SIM_ERR_NULL_ADDRESS,         ///< A data descriptor has a zero read or write address
+    DMA_SG_SIM_ERR_BAD_JUMP,             ///< A write to the DMA registers other than the control channel's READ_ADDR_TRIG, or a jump outside the list
+    DMA_SG_SIM_ERR_BAD_COUNT_MODE,       ///< The transfer count uses a mode other than normal (RP2350)
+} dma_sg_sim_status_t;
+
+/*! \brief Configuration for \ref dma_sg_sim_run
+ *  \ingroup dma_sg_sim
+ */
+typedef struct dma_sg_sim_config {
+    bool execute;                  ///< true to perform the transfers on memory; false to only validate and time the chain
+    uint32_t max_descriptors;      ///< stop after this many descriptor loads (0 for the default of 65536)
+    uint32_t cycles_per_transfer;  ///< bus cycles for each unpaced transfer
+    uint32_t cycles_per_descriptor;///< bus cycles for the control channel to load a descriptor and re-trigger the data channel
+    /*! optional function giving the period in bus cycles of a TREQ source, or 0 if it is always ready */
+    uint32_t (*treq_period)(uint treq, void *user_data);
+    /*! optional function called for each simulated data channel interrupt */
+    void (*irq_handler)(uint desc_index, uint64_t cycle, bool finished, void *user_data);
+    void *user_data;
+} dma_sg_sim_config_t;
+
+/*! \brief Statistics gathered by \ref dma_sg_sim_run
+ *  \ingroup dma_sg_sim
+ */
+typedef struct dma_sg_sim_result {
+    dma_sg_sim_status_t status;
+    uint32_t descriptors;    ///< descriptors loaded, including terminating and jump descriptors
+    uint32_t jumps;          ///< jump descriptors followed
+    uint32_t irqs;           ///< interrupts raised
+    uint32_t error_index;    ///< index of the offending descriptor when status is an error
+    uint64_t transfers;      ///< data transfers performed
+    uint64_t bytes;          ///< data bytes transferred
+    uint64_t cycles;         ///< estimated bus cycles
+} dma_sg_sim_result_t;
+
+/*! \brief Get the default interpreter configuration
+ *  \ingroup dma_sg_sim
+ *
+ * The defaults execute transfers, with one cycle per transfer and 6 cycles per descriptor load (4 control channel
+ * transfers plus the chain hand-offs in each direction).
+ *
+ * \return the default configuration
+ */
+dma_sg_sim_config_t dma_sg_sim_get_default_config(void);
+
+/*! \brief Interpret a descriptor list
+ *  \ingroup dma_sg_sim
+ *
+ * \param list the list to interpret
+ * \param config the configuration, or NULL for the defaults
+ * \param result receives the statistics; must not be NULL
+ * \return result->status
+ */
+dma_sg_sim_status_t dma_sg_sim_run(const dma_sg_list_t *list, const dma_sg_sim_config_t *config, dma_sg_sim_result_t *result);
+
+/*! \brief Validate a descriptor list without touching memory
+ *  \ingroup dma_sg_sim
+ *
+ * Every descriptor loaded during one pass (or until the limit for looping lists) is checked.
+ *
+ * \param list the list to validate
+ * \return DMA_SG_SIM_OK if the list is valid (DMA_SG_SIM_LIMIT_REACHED is also returned as DMA_SG_SIM_OK), or an error status
+ */
+dma_sg_sim_status_t dma_sg_sim_validate(const dma_sg_list_t *list);
+
+/*! \brief Return a short description of a status
+ *  \ingroup dma_sg_sim
+ *
+ * \param status the status
+ * \return a constant string
+ */
+const char *dma_sg_sim_status_str(dma_sg_sim_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/dsp.h"
+#include "hardware/divider.h"
+#include "dsp_ops.h"
+
+int64_t dsp_dot_q15(const q15_t *a, const q15_t *b, uint count) {
+    int64_t acc = 0;
+    uint i = 0;
+#if PICO_DSP_USE_SIMD
+    for (; i + 4 <= count; i += 4) {
+        acc = dsp_smlald(dsp_read_q15x2(a + i), dsp_read_q15x2(b + i), acc);
+        acc = dsp_smlald(dsp_read_q15x2(a + i + 2), dsp_read_q15x2(b + i + 2), acc);
+    }
+#else
+    // unrolled, as the loop overhead is significant on the M0+. Each product is added to the 64 bit sum separately,
+    // as the sum of two products of -1.0 * -1.0 would overflow 32 bits
+    for (; i + 4 <= count; i += 4) {
+        acc += a[i] * b[i];
+        acc += a[i + 1] * b[i + 1];
+        acc += a[i + 2] * b[i + 2];
+        acc += a[i + 3] * b[i + 3];
+    }
+#endif
+    for (; i < count; i++) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+int64_t dsp_dot_q31(const q31_t *a, const q31_t *b, uint count) {
+    int64_t acc = 0;
+    for (uint i = 0; i < count; i++) {
+        acc += dsp_mul_s32(a[i], b[i]) >> 14;
+    }
+    return acc;
+}
+
+void dsp_scale_q15(q15_t *dst, const q15_t *src, uint count, q15_t scale, uint shift) {
+    invalid_params_if(PICO_DSP, shift > 15);
+    uint right_shift = 15 - shift;
+    uint i = 0;
+#if PICO_DSP_USE_SIMD
+    // two values per load and store
+    for (; i + 2 <= count; i += 2) {
+        uint32_t x = dsp_read_q15x2(src + i);
+        dsp_write_q15x2(dst + i, dsp_pack_q15x2(dsp_ssat16((dsp_lo(x) * scale) >> right_shift),
+                                                dsp_ssat16((dsp_hi(x) * scale) >> right_shift)));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = dsp_sat_q15((src[i] * scale) >> right_shift);
+    }
+}
+
+void dsp_scale_q31(q31_t *dst, const q31_t *src, uint count, q31_t scale, uint shift) {
+    invalid_params_if(PICO_DSP, shift > 31);
+    uint right_shift = 31 - shift;
+    for (uint i = 0; i < count; i++) {
+        dst[i] = dsp_sat_q31(dsp_mul_s32(src[i], scale) >> right_shift);
+    }
+}
+
+q15_t dsp_div_q15(q15_t num, q15_t den) {
+    if (!den) return num > 0 ? INT16_MAX : (num < 0 ? INT16_MIN : 0);
+    // the dividend fits in 32 bits, so this is a single use of the hardware divider on RP2040
+    return dsp_sat_q15(hw_divider_s32_quotient_inlined(num * 32768, den));
+}
+
+q31_t dsp_div_q31(q31_t num, q31_t den) {
+    if (!den) return num > 0 ? INT32_MAX : (num < 0 ? INT32_MIN : 0);
+    return dsp_sat_q31(((int64_t)num * 2147483648ll) / den);
+}
@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/dsp.h"
+#include "dsp_ops.h"
+
+// Twiddle factors are looked up in a quarter wave table of sin(2 pi k / SINE_PERIOD) in Q31, shared by all FFT
+// lengths (and by the Q15 FFT, which rounds the values)
+#define SINE_PERIOD 4096
+static_assert(SINE_PERIOD % DSP_FFT_MAX_LENGTH == 0, "");
+
+static const int32_t quarter_sine[SINE_PERIOD / 4 + 1] = {
+        0x00000000, 0x003243f5, 0x006487e3, 0x0096cbc1, 0x00c90f88, 0x00fb5330, 0x012d96b1, 0x015fda03,
+        0x01921d20, 0x01c45ffe, 0x01f6a297, 0x0228e4e2, 0x025b26d7, 0x028d6870, 0x02bfa9a4, 0x02f1ea6c,
+        0x03242abf, 0x03566a96, 0x0388a9ea, 0x03bae8b2, 0x03ed26e6, 0x041f6480, 0x0451a177, 0x0483ddc3,
+        0x04b6195d, 0x04e8543e, 0x051a8e5c, 0x054cc7b1, 0x057f0035, 0x05b137df, 0x05e36ea9, 0x0615a48b,
+        0x0647d97c, 0x067a0d76, 0x06ac406f, 0x06de7262, 0x0710a345, 0x0742d311, 0x077501be, 0x07a72f45,
+        0x07d95b9e, 0x080b86c2, 0x083db0a7, 0x086fd947, 0x08a2009a, 0x08d42699, 0x09064b3a, 0x09386e78,
+        0x096a9049, 0x099cb0a7, 0x09cecf89, 0x0a00ece8, 0x0a3308bd, 0x0a6522fe, 0x0a973ba5, 0x0ac952aa,
+        0x0afb6805, 0x0b2d7baf, 0x0b5f8d9f, 0x0b919dcf, 0x0bc3ac35, 0x0bf5b8cb, 0x0c27c389, 0x0c59cc68,
+        0x0c8bd35e, 0x0cbdd865, 0x0cefdb76, 0x0d21dc87, 0x0d53db92, 0x0d85d88f, 0x0db7d376, 0x0de9cc40,
+        0x0e1bc2e4, 0x0e4db75b, 0x0e7fa99e, 0x0eb199a4, 0x0ee38766, 0x0f1572dc, 0x0f475bff, 0x0f7942c7,
+        0x0fab272b, 0x0fdd0926, 0x100ee8ad, 0x1040c5bb, 0x1072a048, 0x10a4784b, 0x10d64dbd, 0x11082096,
+        0x1139f0cf, 0x116bbe60, 0x119d8941, 0x11cf516a, 0x120116d5, 0x1232d979, 0x1264994e, 0x1296564d,
+        0x12c8106f, 0x12f9c7aa, 0x132b7bf9, 0x135d2d53, 0x138edbb1, 0x13c0870a, 0x13f22f58, 0x1423d492,
+        0x145576b1, 0x148715ae, 0x14b8b17f, 0x14ea4a1f, 0x151bdf86, 0x154d71aa, 0x157f0086, 0x15b08c12,
+        0x15e21445, 0x16139918, 0x16451a83, 0x1676987f, 0x16a81305, 0x16d98a0c, 0x170afd8d, 0x173c6d80,
+        0x176dd9de, 0x179f429f, 0x17d0a7bc, 0x1802092c, 0x183366e9, 0x1864c0ea, 0x18961728, 0x18c7699b,
+        0x18f8b83c, 0x192a0304, 0x195b49ea, 0x198c8ce7, 0x19bdcbf3, 0x19ef0707, 0x1a203e1b, 0x1a517128,
+        0x1a82a026, 0x1ab3cb0d, 0x1ae4f1d6, 0x1b161479, 0x1b4732ef, 0x1b784d30, 0x1ba96335, 0x1bda74f6,
+        0x1c0b826a, 0x1c3c8b8c, 0x1c6d9053, 0x1c9e90b8, 0x1ccf8cb3, 0x1d00843d, 0x1d31774d, 0x1d6265dd,
+        0x1d934fe5, 0x1dc4355e, 0x1df5163f, 0x1e25f282, 0x1e56ca1e, 0x1e879d0d, 0x1eb86b46, 0x1ee934c3,
+        0x1f19f97b, 0x1f4ab968, 0x1f7b7481, 0x1fac2abf, 0x1fdcdc1b, 0x200d888d, 0x203e300d, 0x206ed295,
+        0x209f701c, 0x20d0089c, 0x21009c0c, 0x21312a65, 0x2161b3a0, 0x219237b5, 0x21c2b69c, 0x21f3304f,
+        0x2223a4c5, 0x225413f8, 0x22847de0, 0x22b4e274, 0x22e541af, 0x23159b88, 0x2345eff8, 0x23763ef7,
+        0x23a6887f, 0x23d6cc87, 0x24070b08, 0x243743fa, 0x24677758, 0x2497a517, 0x24c7cd33, 0x24f7efa2,
+        0x25280c5e, 0x2558235f, 0x2588349d, 0x25b84012, 0x25e845b6, 0x26184581, 0x26483f6c, 0x26783370,
+        0x26a82186, 0x26d809a5, 0x2707ebc7, 0x2737c7e3, 0x27679df4, 0x27976df1, 0x27c737d3, 0x27f6fb92,
+        0x2826b928, 0x2856708d, 0x288621b9, 0x28b5cca5, 0x28e5714b, 0x29150fa1, 0x2944a7a2, 0x29743946,
+        0x29a3c485, 0x29d34958, 0x2a02c7b8, 0x2a323f9e, 0x2a61b101, 0x2a911bdc, 0x2ac08026, 0x2aefddd8,
+        0x2b1f34eb, 0x2b4e8558, 0x2b7dcf17, 0x2bad1221, 0x2bdc4e6f, 0x2c0b83fa, 0x2c3ab2b9, 0x2c69daa6,
+        0x2c98fbba, 0x2cc815ee, 0x2cf72939, 0x2d263596, 0x2d553afc, 0x2d843964, 0x2db330c7, 0x2de2211e,
+        0x2e110a62, 0x2e3fec8b, 0x2e6ec792, 0x2e9d9b70, 0x2ecc681e, 0x2efb2d95, 0x2f29ebcc, 0x2f58a2be,
+        0x2f875262, 0x2fb5fab2, 0x2fe49ba7, 0x30133539, 0x3041c761, 0x30705217, 0x309ed556, 0x30cd5115,
+        0x30fbc54d, 0x312a31f8, 0x3158970e, 0x3186f487, 0x31b54a5e, 0x31e39889, 0x3211df04, 0x32401dc6,
+        0x326e54c7, 0x329c8402, 0x32caab6f, 0x32f8cb07, 0x3326e2c3, 0x3354f29b, 0x3382fa88, 0x33b0fa84,
+        0x33def287, 0x340ce28b, 0x343aca87, 0x3468aa76, 0x34968250, 0x34c4520d, 0x34f219a8, 0x351fd918,
+        0x354d9057, 0x357b3f5d, 0x35a8e625, 0x35d684a6, 0x36041ad9, 0x3631a8b8, 0x365f2e3b, 0x368cab5c,
+        0x36ba2014, 0x36e78c5b, 0x3714f02a, 0x37424b7b, 0x376f9e46, 0x379ce885, 0x37ca2a30, 0x37f76341,
+        0x382493b0, 0x3851bb77, 0x387eda8e, 0x38abf0ef, 0x38d8fe93, 0x39060373, 0x3932ff87, 0x395ff2c9,
+        0x398cdd32, 0x39b9bebc, 0x39e6975e, 0x3a136712, 0x3a402dd2, 0x3a6ceb96, 0x3a99a057, 0x3ac64c0f,
+        0x3af2eeb7, 0x3b1f8848, 0x3b4c18ba, 0x3b78a007, 0x3ba51e29, 0x3bd19318, 0x3bfdfecd, 0x3c2a6142,
+        0x3c56ba70, 0x3c830a50, 0x3caf50da, 0x3cdb8e09, 0x3d07c1d6, 0x3d33ec39, 0x3d600d2c, 0x3d8c24a8,
+        0x3db832a6, 0x3de4371f, 0x3e10320d, 0x3e3c2369, 0x3e680b2c, 0x3e93e950, 0x3ebfbdcd, 0x3eeb889c,
+        0x3f1749b8, 0x3f430119, 0x3f6eaeb8, 0x3f9a5290, 0x3fc5ec98, 0x3ff17cca, 0x401d0321, 0x40487f94,
+        0x4073f21d, 0x409f5ab6, 0x40cab958, 0x40f60dfb, 0x4121589b, 0x414c992f, 0x4177cfb1, 0x41a2fc1a,
+        0x41ce1e65, 0x41f93689, 0x42244481, 0x424f4845, 0x427a41d0, 0x42a5311b, 0x42d0161e, 0x42faf0d4,
+        0x4325c135, 0x4350873c, 0x437b42e1, 0x43a5f41e, 0x43d09aed, 0x43fb3746, 0x4425c923, 0x4450507e,
+        0x447acd50, 0x44a53f93, 0x44cfa740, 0x44fa0450, 0x452456bd, 0x454e9e80, 0x4578db93, 0x45a30df0,
+        0x45cd358f, 0x45f7526b, 0x4621647d, 0x464b6bbe, 0x46756828, 0x469f59b4, 0x46c9405c, 0x46f31c1a,
+        0x471cece7, 0x4746b2bc, 0x47706d93, 0x479a1d67, 0x47c3c22f, 0x47ed5be6, 0x4816ea86, 0x48406e08,
+        0x4869e665, 0x48935397, 0x48bcb599, 0x48e60c62, 0x490f57ee, 0x49389836, 0x4961cd33, 0x498af6df,
+        0x49b41533, 0x49dd282a, 0x4a062fbd, 0x4a2f2be6, 0x4a581c9e, 0x4a8101de, 0x4aa9dba2, 0x4ad2a9e2,
+        0x4afb6c98, 0x4b2423be, 0x4b4ccf4d, 0x4b756f40, 0x4b9e0390, 0x4bc68c36, 0x4bef092d, 0x4c177a6e,
+        0x4c3fdff4, 0x4c6839b7, 0x4c9087b1, 0x4cb8c9dd, 0x4ce10034, 0x4d092ab0, 0x4d31494b, 0x4d595bfe,
+        0x4d8162c4, 0x4da95d96, 0x4dd14c6e, 0x4df92f46, 0x4e210617, 0x4e48d0dd, 0x4e708f8f, 0x4e984229,
+        0x4ebfe8a5, 0x4ee782fb, 0x4f0f1126, 0x4f369320, 0x4f5e08e3, 0x4f857269, 0x4faccfab, 0x4fd420a4,
+        0x4ffb654d, 0x50229da1, 0x5049c999, 0x5070e92f, 0x5097fc5e, 0x50bf031f, 0x50e5fd6d, 0x510ceb40,
+        0x5133cc94, 0x515aa162, 0x518169a5, 0x51a82555, 0x51ced46e, 0x51f576ea, 0x521c0cc2, 0x524295f0,
+        0x5269126e, 0x528f8238, 0x52b5e546, 0x52dc3b92, 0x53028518, 0x5328c1d0, 0x534ef1b5, 0x537514c2,
+        0x539b2af0, 0x53c13439, 0x53e73097, 0x540d2005, 0x5433027d, 0x5458d7f9, 0x547ea073, 0x54a45be6,
+        0x54ca0a4b, 0x54efab9c, 0x55153fd4, 0x553ac6ee, 0x556040e2, 0x5585adad, 0x55ab0d46, 0x55d05faa,
+        0x55f5a4d2, 0x561adcb9, 0x56400758, 0x566524aa, 0x568a34a9, 0x56af3750, 0x56d42c99, 0x56f9147e,
+        0x571deefa, 0x5742bc06, 0x57677b9d, 0x578c2dba, 0x57b0d256, 0x57d5696d, 0x57f9f2f8, 0x581e6ef1,
+        0x5842dd54, 0x58673e1b, 0x588b9140, 0x58afd6bd, 0x58d40e8c, 0x58f838a9, 0x591c550e, 0x594063b5,
+        0x59646498, 0x598857b2, 0x59ac3cfd, 0x59d01475, 0x59f3de12, 0x5a1799d1, 0x5a3b47ab, 0x5a5ee79a,
+        0x5a82799a, 0x5aa5fda5, 0x5ac973b5, 0x5aecdbc5, 0x5b1035cf, 0x5b3381ce, 0x5b56bfbd, 0x5b79ef96,
+        0x5b9d1154, 0x5bc024f0, 0x5be32a67, 0x5c0621b2, 0x5c290acc, 0x5c4be5b0, 0x5c6eb258, 0x5c9170bf,
+        0x5cb420e0, 0x5cd6c2b5, 0x5cf95638, 0x5d1bdb65, 0x5d3e5237, 0x5d60baa7, 0x5d8314b1, 0x5da5604f,
+        0x5dc79d7c, 0x5de9cc33, 0x5e0bec6e, 0x5e2dfe29, 0x5e50015d, 0x5e71f606, 0x5e93dc1f, 0x5eb5b3a2,
+        0x5ed77c8a, 0x5ef936d1, 0x5f1ae274, 0x5f3c7f6b, 0x5f5e0db3, 0x5f7f8d46, 0x5fa0fe1f, 0x5fc26038,
+        0x5fe3b38d, 0x6004f819, 0x60262dd6, 0x604754bf, 0x60686ccf, 0x60897601, 0x60aa7050, 0x60cb5bb7,
+        0x60ec3830, 0x610d05b7, 0x612dc447, 0x614e73da, 0x616f146c, 0x618fa5f7, 0x61b02876, 0x61d09be5,
+        0x61f1003f, 0x6211557e, 0x62319b9d, 0x6251d298, 0x6271fa69, 0x6292130c, 0x62b21c7b, 0x62d216b3,
+        0x62f201ac, 0x6311dd64, 0x6331a9d4, 0x635166f9, 0x637114cc, 0x6390b34a, 0x63b0426d, 0x63cfc231,
+        0x63ef3290, 0x640e9386, 0x642de50d, 0x644d2722, 0x646c59bf, 0x648b7ce0, 0x64aa907f, 0x64c99498,
+        0x64e88926, 0x65076e25, 0x6526438f, 0x6545095f, 0x6563bf92, 0x65826622, 0x65a0fd0b, 0x65bf8447,
+        0x65ddfbd3, 0x65fc63a9, 0x661abbc5, 0x66390422, 0x66573cbb, 0x6675658c, 0x66937e91, 0x66b187c3,
+        0x66cf8120, 0x66ed6aa1, 0x670b4444, 0x67290e02, 0x6746c7d8, 0x676471c0, 0x67820bb7, 0x679f95b7,
+        0x67bd0fbd, 0x67da79c3, 0x67f7d3c5, 0x68151dbe, 0x683257ab, 0x684f8186, 0x686c9b4b, 0x6889a4f6,
+        0x68a69e81, 0x68c387e9, 0x68e06129, 0x68fd2a3d, 0x6919e320, 0x69368bce, 0x69532442, 0x696fac78,
+        0x698c246c, 0x69a88c19, 0x69c4e37a, 0x69e12a8c, 0x69fd614a, 0x6a1987b0, 0x6a359db9, 0x6a51a361,
+        0x6a6d98a4, 0x6a897d7d, 0x6aa551e9, 0x6ac115e2, 0x6adcc964, 0x6af86c6c, 0x6b13fef5, 0x6b2f80fb,
+        0x6b4af279, 0x6b66536b, 0x6b81a3cd, 0x6b9ce39b, 0x6bb812d1, 0x6bd3316a, 0x6bee3f62, 0x6c093cb6,
+        0x6c242960, 0x6c3f055d, 0x6c59d0a9, 0x6c748b3f, 0x6c8f351c, 0x6ca9ce3b, 0x6cc45698, 0x6cdece2f,
+        0x6cf934fc, 0x6d138afb, 0x6d2dd027, 0x6d48047e, 0x6d6227fa, 0x6d7c3a98, 0x6d963c54, 0x6db02d29,
+        0x6dca0d14, 0x6de3dc11, 0x6dfd9a1c, 0x6e174730, 0x6e30e34a, 0x6e4a6e66, 0x6e63e87f, 0x6e7d5193,
+        0x6e96a99d, 0x6eaff099, 0x6ec92683, 0x6ee24b57, 0x6efb5f12, 0x6f1461b0, 0x6f2d532c, 0x6f463383,
+        0x6f5f02b2, 0x6f77c0b3, 0x6f906d84, 0x6fa90921, 0x6fc19385, 0x6fda0cae, 0x6ff27497, 0x700acb3c,
+        0x7023109a, 0x703b44ad, 0x70536771, 0x706b78e3, 0x708378ff, 0x709b67c0, 0x70b34525, 0x70cb1128,
+        0x70e2cbc6, 0x70fa74fc, 0x71120cc5, 0x7129931f, 0x71410805, 0x71586b74, 0x716fbd68, 0x7186fdde,
+        0x719e2cd2, 0x71b54a41, 0x71cc5626, 0x71e35080, 0x71fa3949, 0x7211107e, 0x7227d61c, 0x723e8a20,
+        0x72552c85, 0x726bbd48, 0x72823c67, 0x7298a9dd, 0x72af05a7, 0x72c54fc1, 0x72db8828, 0x72f1aed9,
+        0x7307c3d0, 0x731dc70a, 0x7333b883, 0x73499838, 0x735f6626, 0x73752249, 0x738acc9e, 0x73a06522,
+        0x73b5ebd1, 0x73cb60a8, 0x73e0c3a3, 0x73f614c0, 0x740b53fb, 0x74208150, 0x74359cbd, 0x744aa63f,
+        0x745f9dd1, 0x74748371, 0x7489571c, 0x749e18cd, 0x74b2c884, 0x74c7663a, 0x74dbf1ef, 0x74f06b9e,
+        0x7504d345, 0x751928e0, 0x752d6c6c, 0x75419de7, 0x7555bd4c, 0x7569ca99, 0x757dc5ca, 0x7591aedd,
+        0x75a585cf, 0x75b94a9c, 0x75ccfd42, 0x75e09dbd, 0x75f42c0b, 0x7607a828, 0x761b1211, 0x762e69c4,
+        0x7641af3d, 0x7654e279, 0x76680376, 0x767b1231, 0x768e0ea6, 0x76a0f8d2, 0x76b3d0b4, 0x76c69647,
+        0x76d94989, 0x76ebea77, 0x76fe790e, 0x7710f54c, 0x77235f2d, 0x7735b6af, 0x7747fbce, 0x775a2e89,
+        0x776c4edb, 0x777e5cc3, 0x7790583e, 0x77a24148, 0x77b417df, 0x77c5dc01, 0x77d78daa, 0x77e92cd9,
+        0x77fab989, 0x780c33b8, 0x781d9b65, 0x782ef08b, 0x78403329, 0x7851633b, 0x786280bf, 0x78738bb3,
+        0x78848414, 0x789569df, 0x78a63d11, 0x78b6fda8, 0x78c7aba2, 0x78d846fb, 0x78e8cfb2, 0x78f945c3,
+        0x7909a92d, 0x7919f9ec, 0x792a37fe, 0x793a6361, 0x794a7c12, 0x795a820e, 0x796a7554, 0x797a55e0,
+        0x798a23b1, 0x7999dec4, 0x79a98715, 0x79b91ca4, 0x79c89f6e, 0x79d80f6f, 0x79e76ca7, 0x79f6b711,
+        0x7a05eead, 0x7a151378, 0x7a24256f, 0x7a332490, 0x7a4210d8, 0x7a50ea47, 0x7a5fb0d8, 0x7a6e648a,
+        0x7a7d055b, 0x7a8b9348, 0x7a9a0e50, 0x7aa8766f, 0x7ab6cba4, 0x7ac50dec, 0x7ad33d45, 0x7ae159ae,
+        0x7aef6323, 0x7afd59a4, 0x7b0b3d2c, 0x7b190dbc, 0x7b26cb4f, 0x7b3475e5, 0x7b420d7a, 0x7b4f920e,
+        0x7b5d039e, 0x7b6a6227, 0x7b77ada8, 0x7b84e61f, 0x7b920b89, 0x7b9f1de6, 0x7bac1d31, 0x7bb9096b,
+        0x7bc5e290, 0x7bd2a89e, 0x7bdf5b94, 0x7bebfb70, 0x7bf88830, 0x7c0501d2, 0x7c116853, 0x7c1dbbb3,
+        0x7c29fbee, 0x7c362904, 0x7c4242f2, 0x7c4e49b7, 0x7c5a3d50, 0x7c661dbc, 0x7c71eaf9, 0x7c7da505,
+        0x7c894bde, 0x7c94df83, 0x7ca05ff1, 0x7cabcd28, 0x7cb72724, 0x7cc26de5, 0x7ccda169, 0x7cd8c1ae,
+        0x7ce3ceb2, 0x7ceec873, 0x7cf9aef0, 0x7d048228, 0x7d0f4218, 0x7d19eebf, 0x7d24881b, 0x7d2f0e2b,
+        0x7d3980ec, 0x7d43e05e, 0x7d4e2c7f, 0x7d58654d, 0x7d628ac6, 0x7d6c9ce9, 0x7d769bb5, 0x7d808728,
+        0x7d8a5f40, 0x7d9423fc, 0x7d9dd55a, 0x7da77359, 0x7db0fdf8, 0x7dba7534, 0x7dc3d90d, 0x7dcd2981,
+        0x7dd6668f, 0x7ddf9034, 0x7de8a670, 0x7df1a942, 0x7dfa98a8, 0x7e0374a0, 0x7e0c3d29, 0x7e14f242,
+        0x7e1d93ea, 0x7e26221f, 0x7e2e9cdf, 0x7e37042a, 0x7e3f57ff, 0x7e47985b, 0x7e4fc53e, 0x7e57dea7,
+        0x7e5fe493, 0x7e67d703, 0x7e6fb5f4, 0x7e778166, 0x7e7f3957, 0x7e86ddc6, 0x7e8e6eb2, 0x7e95ec1a,
+        0x7e9d55fc, 0x7ea4ac58, 0x7eabef2c, 0x7eb31e78, 0x7eba3a39, 0x7ec14270, 0x7ec8371a, 0x7ecf1837,
+        0x7ed5e5c6, 0x7edc9fc6, 0x7ee34636, 0x7ee9d914, 0x7ef05860, 0x7ef6c418, 0x7efd1c3c, 0x7f0360cb,
+        0x7f0991c4, 0x7f0faf25, 0x7f15b8ee, 0x7f1baf1e, 0x7f2191b4, 0x7f2760af, 0x7f2d1c0e, 0x7f32c3d1,
+        0x7f3857f6, 0x7f3dd87c, 0x7f434563, 0x7f489eaa, 0x7f4de451, 0x7f531655, 0x7f5834b7, 0x7f5d3f75,
+        0x7f62368f, 0x7f671a05, 0x7f6be9d4, 0x7f70a5fe, 0x7f754e80, 0x7f79e35a, 0x7f7e648c, 0x7f82d214,
+        0x7f872bf3, 0x7f8b7227, 0x7f8fa4b0, 0x7f93c38c, 0x7f97cebd, 0x7f9bc640, 0x7f9faa15, 0x7fa37a3c,
+        0x7fa736b4, 0x7faadf7c, 0x7fae7495, 0x7fb1f5fc, 0x7fb563b3, 0x7fb8bdb8, 0x7fbc040a, 0x7fbf36aa,
+        0x7fc25596, 0x7fc560cf, 0x7fc85854, 0x7fcb3c23, 0x7fce0c3e, 0x7fd0c8a3, 0x7fd37153, 0x7fd6064c,
+        0x7fd8878e, 0x7fdaf519, 0x7fdd4eec, 0x7fdf9508, 0x7fe1c76b, 0x7fe3e616, 0x7fe5f108, 0x7fe7e841,
+        0x7fe9cbc0, 0x7feb9b85, 0x7fed5791, 0x7feeffe1, 0x7ff09478, 0x7ff21553, 0x7ff38274, 0x7ff4dbd9,
+        0x7ff62182, 0x7ff75370, 0x7ff871a2, 0x7ff97c18, 0x7ffa72d1, 0x7ffb55ce, 0x7ffc250f, 0x7ffce093,
+        0x7ffd885a, 0x7ffe1c65, 0x7ffe9cb2, 0x7fff0943, 0x7fff6216, 0x7fffa72c, 0x7fffd886, 0x7ffff621,
+        0x7fffffff
+};
+
+// idx is an angle in units of 2 pi / SINE_PERIOD
+static int32_t sin_q31(uint idx) {
+    uint r = idx & (SINE_PERIOD / 4 - 1);
+    int32_t v = (idx & (SINE_PERIOD / 4)) ? quarter_sine[SINE_PERIOD / 4 - r] : quarter_sine[r];
+    return (idx & (SINE_PERIOD / 2)) ? -v : v;
+}
+
+static int32_t cos_q31(uint idx) {
+    return sin_q31((idx + SINE_PERIOD / 4) & (SINE_PERIOD - 1));
+}
+
+static int32_t round_q31_to_q15(int32_t v) {
+    // values close to 1.0 or -1.0 round to it, so saturate; symmetrically, so that negating the result can't overflow
+    return MAX(dsp_sat_q15(((v >> 15) + 1) >> 1), -INT16_MAX);
+}
+
+static void check_fft_length(uint length) {
+    // a power of 4 in range
+    invalid_params_if(PICO_DSP, length < 4 || length > DSP_FFT_MAX_LENGTH || (length & (length - 1)) ||
+                                !(length & 0x55555555u));
+    (void)length;
+}
+
+// Reverse the order of the base 4 digits of index
+static uint digit_reverse(uint index, uint length) {
+    uint r = 0;
+    for (uint n = length; n > 1; n >>= 2) {
+        r = (r << 2) | (index & 3);
+        index >>= 2;
+    }
+    return r;
+}
+
+// The transforms are decimation in frequency: each stage splits every sub-transform of length n1 into four of
+// length n1 / 4, each butterfly taking values n1 / 4 apart and computing (with x0..x3 halved twice on the way)
+//
+//   y0 = (x0 + x2) + (x1 + x3)
+//   y1 = ((x0 - x2) - i (x1 - x3)) * w^j
+//   y2 = ((x0 + x2) - (x1 + x3)) * w^2j
+//   y3 = ((x0 - x2) + i (x1 - x3)) * w^3j
+//
+// where w = e^(-2 pi i / n1) (or its conjugate, and with the signs of i swapped, for the inverse). That leaves the
+// output in base 4 digit reversed order, which is then undone.
+//
+// A twiddle factor is held as (cos, sin), with the sin negated for the inverse transform, and the multiplication by
+// it is (re, im) * (cos - i sin)
+
+#if PICO_DSP_USE_SIMD
+
+static __force_inline uint32_t mul_twiddle_q15(uint32_t x, uint32_t w) {
+    return dsp_pack_q15x2(dsp_ssat16(dsp_smuad(x, w) >> 15), dsp_ssat16(dsp_smusdx(w, x) >> 15));
+}
+
+static void fft_stages_q15(q15_t *data, uint length, bool inverse) {
+    for (uint n1 = length; n1 > 1; n1 >>= 2) {
+        uint n2 = n1 >> 2;
+        uint step = SINE_PERIOD / n1;
+        for (uint j = 0; j < n2; j++) {
+            uint32_t w[3];
+            for (uint k = 0; k < 3; k++) {
+                uint idx = (k + 1) * j * step;
+                int32_t s = round_q31_to_q15(sin_q31(idx));
+                w[k] = dsp_pack_q15x2(round_q31_to_q15(cos_q31(idx)), inverse ? -s : s);
+            }
+            for (uint i0 = j; i0 < length; i0 += n1) {
+                q15_t *p0 = data + 2 * i0, *p1 = p0 + 2 * n2, *p2 = p1 + 2 * n2, *p3 = p2 + 2 * n2;
+                uint32_t x0 = dsp_read_q15x2(p0), x1 = dsp_read_q15x2(p1);
+                uint32_t x2 = dsp_read_q15x2(p2), x3 = dsp_read_q15x2(p3);
+                uint32_t a = dsp_shadd16(x0, x2), b = dsp_shsub16(x0, x2);
+                uint32_t c = dsp_shadd16(x1, x3), d = dsp_shsub16(x1, x3);
+                uint32_t y0 = dsp_shadd16(a, c), y2 = dsp_shsub16(a, c);
+                // b - i d is ((b.re + d.im) / 2, (b.im - d.re) / 2)
+                uint32_t y1 = inverse ? dsp_shasx(b, d) : dsp_shsax(b, d);
+                uint32_t y3 = inverse ? dsp_shsax(b, d) : dsp_shasx(b, d);
+                if (j) {
+                    y1 = mul_twiddle_q15(y1, w[0]);
+                    y2 = mul_twiddle_q15(y2, w[1]);
+                    y3 = mul_twiddle_q15(y3, w[2]);
+                }
+                dsp_write_q15x2(p0, y0);
+                dsp_write_q15x2(p1, y1);
+                dsp_write_q15x2(p2, y2);
+                dsp_write_q15x2(p3, y3);
+            }
+        }
+    }
+}
+
+#else
+
+// Plain C with the same results as the SIMD version above; the real and imaginary parts are kept in separate
+// variables, which suits the M0+ better than packing and unpacking them
+
+static __force_inline void mul_twiddle_q15(int32_t *re, int32_t *im, int32_t c, int32_t s) {
+    // the sums can't overflow as c and s are at most 32767 in magnitude
+    int32_t r = dsp_sat_q15((*re * c + *im * s) >> 15);
+    *im = dsp_sat_q15((*im * c - *re * s) >> 15);
+    *re = r;
+}
+
+static void fft_stages_q15(q15_t *data, uint length, bool inverse) {
+    for (uint n1 = length; n1 > 1; n1 >>= 2) {
+        uint n2 = n1 >> 2;
+        uint step = SINE_PERIOD / n1;
+        for (uint j = 0; j < n2; j++) {
+            int32_t wc[3], ws[3];
+            for (uint k = 0; k < 3; k++) {
+                uint idx = (k + 1) * j * step;
+                int32_t s = round_q31_to_q15(sin_q31(idx));
+                wc[k] = round_q31_to_q15(cos_q31(idx));
+                ws[k] = inverse ? -s : s;
+            }
+            for (uint i0 = j; i0 < length; i0 += n1) {
+                q15_t *p0 = data + 2 * i0, *p1 = p0 + 2 * n2, *p2 = p1 + 2 * n2, *p3 = p2 + 2 * n2;
+                int32_t ar = (p0[0] + p2[0]) >> 1, ai = (p0[1] + p2[1]) >> 1;
+                int32_t br = (p0[0] - p2[0]) >> 1, bi = (p0[1] - p2[1]) >> 1;
+                int32_t cr = (p1[0] + p3[0]) >> 1, ci = (p1[1] + p3[1]) >> 1;
+                int32_t dr = (p1[0] - p3[0]) >> 1, di = (p1[1] - p3[1]) >> 1;
+                if (inverse) {
+                    dr = -dr;
+                    di = -di;
+                }
+                int32_t y1r = (br + di) >> 1, y1i = (bi - dr) >> 1;
+                int32_t y2r = (ar - cr) >> 1, y2i = (ai - ci) >> 1;
+                int32_t y3r = (br - di) >> 1, y3i = (bi + dr) >> 1;
+                p0[0] = (q15_t)((ar + cr) >> 1);
+                p0[1] = (q15_t)((ai + ci) >> 1);
+                if (j) {
+                    mul_twiddle_q15(&y1r, &y1i, wc[0], ws[0]);
+                    mul_twiddle_q15(&y2r, &y2i, wc[1], ws[1]);
+                    mul_twiddle_q15(&y3r, &y3i, wc[2], ws[2]);
+                }
+                p1[0] = (q15_t)y1r;
+                p1[1] = (q15_t)y1i;
+                p2[0] = (q15_t)y2r;
+                p2[1] = (q15_t)y2i;
+                p3[0] = (q15_t)y3r;
+                p3[1] = (q15_t)y3i;
+            }
+        }
+    }
+}
+
+#endif
+
+void dsp_fft_q15(q15_t *data, uint length, bool inverse) {
+    check_fft_length(length);
+    fft_stages_q15(data, length, inverse);
+    for (uint i = 1; i < length - 1; i++) {
+        uint r = digit_reverse(i, length);
+        if (i < r) {
+            uint32_t t = dsp_read_q15x2(data + 2 * i);
+            dsp_write_q15x2(data + 2 * i, dsp_read_q15x2(data + 2 * r));
+            dsp_write_q15x2(data + 2 * r, t);
+        }
+    }
+}
+
+// floor((p + q) / 2) and floor((p - q) / 2) without needing 33 bits
+static __force_inline int32_t hadd_q31(int32_t p, int32_t q) {
+    return (p >> 1) + (q >> 1) + (p & q & 1);
+}
+
+static __force_inline int32_t hsub_q31(int32_t p, int32_t q) {
+    return (p >> 1) - (q >> 1) - (~p & q & 1);
+}
+
+static __force_inline void mul_twiddle_q31(int32_t *re, int32_t *im, int32_t c, int32_t s) {
+    int32_t r = dsp_sat_q31((dsp_mul_s32(*re, c) + dsp_mul_s32(*im, s)) >> 31);
+    *im = dsp_sat_q31((dsp_mul_s32(*im, c) - dsp_mul_s32(*re, s)) >> 31);
+    *re = r;
+}
+
+void dsp_fft_q31(q31_t *data, uint length, bool inverse) {
+    check_fft_length(length);
+    for (uint n1 = length; n1 > 1; n1 >>= 2) {
+        uint n2 = n1 >> 2;
+        uint step = SINE_PERIOD / n1;
+        for (uint j = 0; j < n2; j++) {
+            int32_t wc[3], ws[3];
+            for (uint k = 0; k < 3; k++) {
+                uint idx = (k + 1) * j * step;
+                int32_t s = sin_q31(idx);
+                wc[k] = cos_q31(idx);
+                // sin is never -1.0, so this can't overflow
+                ws[k] = inverse ? -s : s;
+            }
+            for (uint i0 = j; i0 < length; i0 += n1) {
+                q31_t *p0 = data + 2 * i0, *p1 = p0 + 2 * n2, *p2 = p1 + 2 * n2, *p3 = p2 + 2 * n2;
+                int32_t ar = hadd_q31(p0[0], p2[0]), ai = hadd_q31(p0[1], p2[1]);
+                int32_t br = hsub_q31(p0[0], p2[0]), bi = hsub_q31(p0[1], p2[1]);
+                int32_t cr = hadd_q31(p1[0], p3[0]), ci = hadd_q31(p1[1], p3[1]);
+                int32_t dr = hsub_q31(p1[0], p3[0]), di = hsub_q31(p1[1], p3[1]);
+                int32_t y1r, y1i, y3r, y3i;
+                if (inverse) {
+                    y1r = hsub_q31(br, di);
+                    y1i = hadd_q31(bi, dr);
+                    y3r = hadd_q31(br, di);
+                    y3i = hsub_q31(bi, dr);
+                } else {
+                    y1r = hadd_q31(br, di);
+                    y1i = hsub_q31(bi, dr);
+                    y3r = hsub_q31(br, di);
+                    y3i = hadd_q31(bi, dr);
+                }
+                int32_t y2r = hsub_q31(ar, cr), y2i = hsub_q31(ai, ci);
+                p0[0] = hadd_q31(ar, cr);
+                p0[1] = hadd_q31(ai, ci);
+                if (j) {
+                    mul_twiddle_q31(&y1r, &y1i, wc[0], ws[0]);
+                    mul_twiddle_q31(&y2r, &y2i, wc[1], ws[1]);
+                    mul_twiddle_q31(&y3r, &y3i, wc[2], ws[2]);
+                }
+                p1[0] = y1r;
+                p1[1] = y1i;
+                p2[0] = y2r;
+                p2[1] = y2i;
+                p3[0] = y3r;
+                p3[1] = y3i;
+            }
+        }
+    }
+    for (uint i = 1; i < length - 1; i++) {
+        uint r = digit_reverse(i, length);
+        if (i < r) {
+            q31_t t0 = data[2 * i], t1 = data[2 * i + 1];
+            data[2 * i] = data[2 * r];
+            data[2 * i + 1] = data[2 * r + 1];
+            data[2 * r] = t0;
+            data[2 * r + 1] = t1;
+        }
+    }
+}
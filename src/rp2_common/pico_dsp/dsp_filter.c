@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/dsp.h"
+#include "dsp_ops.h"
+
+// The FIR state buffer holds the previous num_taps - 1 samples, oldest first, followed by room for a block of new
+// samples, so that each output is the dot product of a contiguous run of the buffer with the coefficients (in
+// reverse order)
+
+void dsp_fir_q15_init(dsp_fir_q15_t *fir, const q15_t *coeffs, uint num_taps, q15_t *state, uint max_block_size) {
+    invalid_params_if(PICO_DSP, !num_taps);
+    fir->coeffs = coeffs;
+    fir->state = state;
+    fir->num_taps = num_taps;
+    fir->max_block_size = max_block_size;
+    memset(state, 0, (num_taps - 1) * sizeof(q15_t));
+}
+
+static int64_t fir_q15_sum(const q15_t *x, const q15_t *coeffs, uint num_taps) {
+    // x[k] is multiplied by coeffs[num_taps - 1 - k]
+    const q15_t *c = coeffs + num_taps - 1;
+    int64_t acc = 0;
+    uint k = 0;
+#if PICO_DSP_USE_SIMD
+    // the exchanging multiply pairs x[k], x[k + 1] with c[-k], c[-k - 1]
+    for (; k + 2 <= num_taps; k += 2) {
+        acc = dsp_smlaldx(dsp_read_q15x2(x + k), dsp_read_q15x2(c - k - 1), acc);
+    }
+#else
+    for (; k + 4 <= num_taps; k += 4) {
+        acc += x[k] * c[-(int)k];
+        acc += x[k + 1] * c[-(int)k - 1];
+        acc += x[k + 2] * c[-(int)k - 2];
+        acc += x[k + 3] * c[-(int)k - 3];
+    }
+#endif
+    for (; k < num_taps; k++) {
+        acc += x[k] * c[-(int)k];
+    }
+    return acc;
+}
+
+void dsp_fir_q15(dsp_fir_q15_t *fir, q15_t *dst, const q15_t *src, uint count) {
+    invalid_params_if(PICO_DSP, count > fir->max_block_size);
+    uint history = fir->num_taps - 1;
+    memcpy(fir->state + history, src, count * sizeof(q15_t));
+    for (uint n = 0; n < count; n++) {
+        dst[n] = dsp_sat_q15((int32_t)(fir_q15_sum(fir->state + n, fir->coeffs, fir->num_taps) >> 15));
+    }
+    memmove(fir->state, fir->state + count, history * sizeof(q15_t));
+}
+
+void dsp_fir_q31_init(dsp_fir_q31_t *fir, const q31_t *coeffs, uint num_taps, q31_t *state, uint max_block_size) {
+    invalid_params_if(PICO_DSP, !num_taps);
+    fir->coeffs = coeffs;
+    fir->state = state;
+    fir->num_taps = num_taps;
+    fir->max_block_size = max_block_size;
+    memset(state, 0, (num_taps - 1) * sizeof(q31_t));
+}
+
+void dsp_fir_q31(dsp_fir_q31_t *fir, q31_t *dst, const q31_t *src, uint count) {
+    invalid_params_if(PICO_DSP, count > fir->max_block_size);
+    uint num_taps = fir->num_taps;
+    uint history = num_taps - 1;
+    const q31_t *c = fir->coeffs + history;
+    memcpy(fir->state + history, src, count * sizeof(q31_t));
+    for (uint n = 0; n < count; n++) {
+        const q31_t *x = fir->state + n;
+        // summed unsigned so that it wraps (rather than being undefined) if it overflows
+        uint64_t acc = 0;
+        for (uint k = 0; k < num_taps; k++) {
+            acc += (uint64_t)dsp_mul_s32(x[k], c[-(int)k]);
+        }
+        dst[n] = dsp_sat_q31((int64_t)acc >> 31);
+    }
+    memmove(fir->state, fir->state + count, history * sizeof(q31_t));
+}
+
+void dsp_biquad_q15_init(dsp_biquad_q15_t *biquad, uint num_stages, const q15_t *coeffs, q15_t *state,
+                         uint post_shift) {
+    invalid_params_if(PICO_DSP, post_shift > 15);
+    biquad->coeffs = coeffs;
+    biquad->state = state;
+    biquad->num_stages = num_stages;
+    biquad->post_shift = post_shift;
+    memset(state, 0, num_stages * DSP_BIQUAD_STATE_PER_STAGE * sizeof(q15_t));
+}
+
+void dsp_biquad_q15(dsp_biquad_q15_t *biquad, q15_t *dst, const q15_t *src, uint count) {
+    uint right_shift = 15 - biquad->post_shift;
+    const q15_t *in = src;
+    for (uint s = 0; s < biquad->num_stages; s++) {
+        const q15_t *c = biquad->coeffs + s * DSP_BIQUAD_COEFFS_PER_STAGE;
+        q15_t *state = biquad->state + s * DSP_BIQUAD_STATE_PER_STAGE;
+        int32_t x1 = state[0], x2 = state[1], y1 = state[2], y2 = state[3];
+#if PICO_DSP_USE_SIMD
+        uint32_t b0_b1 = dsp_pack_q15x2(c[0], c[1]);
+        uint32_t b2_a1 = dsp_pack_q15x2(c[2], c[3]);
+        int32_t a2 = c[4];
+        for (uint n = 0; n < count; n++) {
+            int32_t x = in[n];
+            int64_t acc = dsp_smlald(dsp_pack_q15x2(x, x1), b0_b1, a2 * y2);
+            acc = dsp_smlald(dsp_pack_q15x2(x2, y1), b2_a1, acc);
+            int32_t y = dsp_ssat16((int32_t)(acc >> right_shift));
+#else
+        int32_t b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        for (uint n = 0; n < count; n++) {
+            int32_t x = in[n];
+            // as many as five products of -1.0 * -1.0 may be summed, so this needs 64 bits
+            int64_t acc = (int64_t)(b0 * x) + b1 * x1;
+            acc += b2 * x2;
+            acc += a1 * y1;
+            acc += a2 * y2;
+            int32_t y = dsp_sat_q15((int32_t)(acc >> right_shift));
+#endif
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            dst[n] = (q15_t)y;
+        }
+        state[0] = (q15_t)x1;
+        state[1] = (q15_t)x2;
+        state[2] = (q15_t)y1;
+        state[3] = (q15_t)y2;
+        // later stages filter the output of the previous one in place
+        in = dst;
+    }
+    if (!biquad->num_stages && dst != src) {
+        memcpy(dst, src, count * sizeof(q15_t));
+    }
+}
+
+void dsp_biquad_q31_init(dsp_biquad_q31_t *biquad, uint num_stages, const q31_t *coeffs, q31_t *state,
+                         uint post_shift) {
+    invalid_params_if(PICO_DSP, post_shift > 31);
+    biquad->coeffs = coeffs;
+    biquad->state = state;
+    biquad->num_stages = num_stages;
+    biquad->post_shift = post_shift;
+    memset(state, 0, num_stages * DSP_BIQUAD_STATE_PER_STAGE * sizeof(q31_t));
+}
+
+void dsp_biquad_q31(dsp_biquad_q31_t *biquad, q31_t *dst, const q31_t *src, uint count) {
+    uint right_shift = 31 - biquad->post_shift;
+    const q31_t *in = src;
+    for (uint s = 0; s < biquad->num_stages; s++) {
+        const q31_t *c = biquad->coeffs + s * DSP_BIQUAD_COEFFS_PER_STAGE;
+        q31_t *state = biquad->state + s * DSP_BIQUAD_STATE_PER_STAGE;
+        int32_t b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+        int32_t x1 = state[0], x2 = state[1], y1 = state[2], y2 = state[3];
+        for (uint n = 0; n < count; n++) {
+            int32_t x = in[n];
+            // summed unsigned so that it wraps (rather than being undefined) if it overflows
+            uint64_t acc = (uint64_t)dsp_mul_s32(b0, x);
+            acc += (uint64_t)dsp_mul_s32(b1, x1);
+            acc += (uint64_t)dsp_mul_s32(b2, x2);
+            acc += (uint64_t)dsp_mul_s32(a1, y1);
+            acc += (uint64_t)dsp_mul_s32(a2, y2);
+            int32_t y = dsp_sat_q31((int64_t)acc >> right_shift);
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            dst[n] = y;
+        }
+        state[0] = x1;
+        state[1] = x2;
+        state[2] = y1;
+        state[3] = y2;
+        in = dst;
+    }
+    if (!biquad->num_stages && dst != src) {
+        memcpy(dst, src, count * sizeof(q31_t));
+    }
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_DSP_OPS_H
+#define _PICO_DSP_OPS_H
+
+#include <string.h>
+#include "pico/dsp.h"
+
+// PICO_CONFIG: PICO_DSP_USE_SIMD, Whether the Q15 kernels operate on two values at once with the Arm DSP extension's SIMD instructions (emulated in C where the instructions are not available) - defaults to 1 where they are available i.e. on RP2350 Arm, type=bool, group=pico_dsp
+#ifndef PICO_DSP_USE_SIMD
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32 && defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#define PICO_DSP_USE_SIMD 1
+#else
+#define PICO_DSP_USE_SIMD 0
+#endif
+#endif
+
+// PICO_CONFIG: PICO_DSP_SPLIT_MULTIPLY, Whether 32 x 32 -> 64 bit multiplies are done as four 16 x 16 -> 32 bit multiplies rather than by the compiler - defaults to 1 on Armv6-M i.e. RP2040 which has no instruction for them, type=bool, group=pico_dsp
+#ifndef PICO_DSP_SPLIT_MULTIPLY
+#if defined(__ARM_ARCH_6M__) && __ARM_ARCH_6M__
+#define PICO_DSP_SPLIT_MULTIPLY 1
+#else
+#define PICO_DSP_SPLIT_MULTIPLY 0
+#endif
+#endif
+
+#if PICO_DSP_USE_SIMD && defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#define DSP_ACLE 1
+#else
+#define DSP_ACLE 0
+#endif
+
+// Exact 32 x 32 -> 64 bit signed multiply
+static __force_inline int64_t dsp_mul_s32(int32_t a, int32_t b) {
+#if PICO_DSP_SPLIT_MULTIPLY
+    // a = ah * 2^16 + al, with al unsigned; likewise b. The cross terms fit in 32 bits as one factor is unsigned
+    // 16 bit and the other signed 16 bit
+    int32_t ah = a >> 16, bh = b >> 16;
+    int32_t al = a & 0xffff, bl = b & 0xffff;
+    int64_t cross = (int64_t)(ah * bl) + al * bh;
+    uint64_t result = (uint64_t)(int64_t)(ah * bh) << 32;
+    result += (uint64_t)cross << 16;
+    return (int64_t)(result + (uint32_t)al * (uint32_t)bl);
+#else
+    return (int64_t)a * b;
+#endif
+}
+
+// Pairs of Q15 values packed in a word, the first (lower address) in the low half, as the SIMD instructions use them
+
+static __force_inline uint32_t dsp_read_q15x2(const q15_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static __force_inline void dsp_write_q15x2(q15_t *p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static __force_inline uint32_t dsp_pack_q15x2(int32_t lo, int32_t hi) {
+    return ((uint32_t)lo & 0xffffu) | ((uint32_t)hi << 16);
+}
+
+static __force_inline int32_t dsp_lo(uint32_t x) {
+    return (int16_t)x;
+}
+
+static __force_inline int32_t dsp_hi(uint32_t x) {
+    return (int16_t)(x >> 16);
+}
+
+#if PICO_DSP_USE_SIMD
+
+// The DSP extension instructions, or C with the same results where they are not available (so that this code can be
+// tested on the host)
+
+// acc + x.lo * y.lo + x.hi * y.hi
+static __force_inline int64_t dsp_smlald(uint32_t x, uint32_t y, int64_t acc) {
+#if DSP_ACLE
+    return __smlald((int16x2_t)x, (int16x2_t)y, acc);
+#else
+    return acc + dsp_lo(x) * dsp_lo(y) + dsp_hi(x) * dsp_hi(y);
+#endif
+}
+
+// acc + x.lo * y.hi + x.hi * y.lo
+static __force_inline int64_t dsp_smlaldx(uint32_t x, uint32_t y, int64_t acc) {
+#if DSP_ACLE
+    return __smlaldx((int16x2_t)x, (int16x2_t)y, acc);
+#else
+    return acc + dsp_lo(x) * dsp_hi(y) + dsp_hi(x) * dsp_lo(y);
+#endif
+}
+
+// x.lo * y.lo + x.hi * y.hi (wrapping, which the callers avoid)
+static __force_inline int32_t dsp_smuad(uint32_t x, uint32_t y) {
+#if DSP_ACLE
+    return __smuad((int16x2_t)x, (int16x2_t)y);
+#else
+    return (int32_t)((uint32_t)(dsp_lo(x) * dsp_lo(y)) + (uint32_t)(dsp_hi(x) * dsp_hi(y)));
+#endif
+}
+
+// x.lo * y.lo - x.hi * y.hi
+static __force_inline int32_t dsp_smusd(uint32_t x, uint32_t y) {
+#if DSP_ACLE
+    return __smusd((int16x2_t)x, (int16x2_t)y);
+#else
+    return (int32_t)((uint32_t)(dsp_lo(x) * dsp_lo(y)) - (uint32_t)(dsp_hi(x) * dsp_hi(y)));
+#endif
+}
+
+// x.lo * y.hi + x.hi * y.lo
+static __force_inline int32_t dsp_smuadx(uint32_t x, uint32_t y) {
+#if DSP_ACLE
+    return __smuadx((int16x2_t)x, (int16x2_t)y);
+#else
+    return (int32_t)((uint32_t)(dsp_lo(x) * dsp_hi(y)) + (uint32_t)(dsp_hi(x) * dsp_lo(y)));
+#endif
+}
+
+// x.lo * y.hi - x.hi * y.lo
+static __force_inline int32_t dsp_smusdx(uint32_t x, uint32_t y) {
+#if DSP_ACLE
+    return __smusdx((int16x2_t)x, (int16x2_t)y);
+#else
+    return (int32_t)((uint32_t)(dsp_lo(x) * dsp_hi(y)) - (uint32_t)(dsp_hi(x) * dsp_lo(y)));
+#endif
+}
+
+// ((x.lo + y.lo) >> 1, (x.hi + y.hi) >> 1)
+static __force_inline uint32_t dsp_shadd16(uint32_t x, uint32_t y) {
+#if DSP_ACLE
+    return (uint32_t)__shadd16((int16x2_t)x, (int16x2_t)y);
+#else
+    return dsp_pack_q15x2((dsp_lo(x) + dsp_lo(y)) >> 1, (dsp_hi(x) + dsp_hi(y)) >> 1);
+#endif
+}
+
+// ((x.lo - y.lo) >> 1, (x.hi - y.hi) >> 1)
+static __force_inline uint32_t dsp_shsub16(uint32_t x, uint32_t y) {
+#if DSP_ACLE
+    return (uint32_t)__shsub16((int16x2_t)x, (int16x2_t)y);
+#else
+    return dsp_pack_q15x2((dsp_lo(x) - dsp_lo(y)) >> 1, (dsp_hi(x) - dsp_hi(y)) >> 1);
+#endif
+}
+
+// ((x.lo - y.hi) >> 1, (x.hi + y.lo) >> 1)
+static __force_inline uint32_t dsp_shasx(uint32_t x, uint32_t y) {
+#if DSP_ACLE
+    return (uint32_t)__shasx((int16x2_t)x, (int16x2_t)y);
+#else
+    return dsp_pack_q15x2((dsp_lo(x) - dsp_hi(y)) >> 1, (dsp_hi(x) + dsp_lo(y)) >> 1);
+#endif
+}
+
+// ((x.lo + y.hi) >> 1, (x.hi - y.lo) >> 1)
+static __force_inline uint32_t dsp_shsax(uint32_t x, uint32_t y) {
+#if DSP_ACLE
+    return (uint32_t)__shsax((int16x2_t)x, (int16x2_t)y);
+#else
+    return dsp_pack_q15x2((dsp_lo(x) + dsp_hi(y)) >> 1, (dsp_hi(x) - dsp_lo(y)) >> 1);
+#endif
+}
+
+// x saturated to a signed 16 bit value
+static __force_inline int32_t dsp_ssat16(int32_t x) {
+#if DSP_ACLE
+    return __ssat(x, 16);
+#else
+    return dsp_sat_q15(x);
+#endif
+}
+
+#endif // PICO_DSP_USE_SIMD
+
+#endif
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_DSP_H
+#define _PICO_DSP_H
+
+#include "pico.h"
+
+/** \file pico/dsp.h
+ *  \defgroup pico_dsp pico_dsp
+ *
+ * \brief Fixed point signal processing: dot product, vector scale, FIR and biquad filters, and FFT
+ *
+ * The kernels work on Q15 (\ref q15_t, a 16 bit value representing -1.0 to just under 1.0) and Q31 (\ref q31_t, the
+ * same in 32 bits) data, so avoid the cost of floating point, which is implemented in software on RP2040.
+ *
+ * Products are accumulated at full precision, and results are saturated (clamped to the range of the output type)
+ * rather than wrapping, except where noted. The results are the same on every platform, whichever implementation is
+ * used:
+ *
+ * - On RP2350 (Arm), the Q15 kernels use the Cortex-M33 DSP extension's SIMD instructions, which operate on two 16 bit
+ *   values at once (see \ref PICO_DSP_USE_SIMD)
+ * - On RP2040, the kernels are written for the Cortex-M0+, which has no 32 x 32 -> 64 bit multiply instruction; Q31
+ *   products are formed from 16 bit partial products, rather than by calling the compiler's 64 bit multiply (see
+ *   \ref PICO_DSP_SPLIT_MULTIPLY)
+ * - Elsewhere (e.g. RISC-V, or the host) they are portable C
+ *
+ * Where a division is needed, \ref dsp_div_q15 uses the hardware divider (see \ref hardware_divider) where there is
+ * one.
+ */
+
+// PICO_CONFIG: PARAM_ASSERTIONS_ENABLED_PICO_DSP, Enable/disable assertions in the pico_dsp module, type=bool, default=0, group=pico_dsp
+#ifndef PARAM_ASSERTIONS_ENABLED_PICO_DSP
+#define PARAM_ASSERTIONS_ENABLED_PICO_DSP 0
+#endif
+
+/*! \brief The largest length of FFT supported by \ref dsp_fft_q15 and \ref dsp_fft_q31
+ *  \ingroup pico_dsp
+ */
+#define DSP_FFT_MAX_LENGTH 4096
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief A Q15 fixed point value; 1 sign bit and 15 fractional bits
+ *  \ingroup pico_dsp
+ */
+typedef int16_t q15_t;
+
+/*! \brief A Q31 fixed point value; 1 sign bit and 31 fractional bits
+ *  \ingroup pico_dsp
+ */
+typedef int32_t q31_t;
+
+/*! \brief Saturate a value to the range of a \ref q15_t
+ *  \ingroup pico_dsp
+ */
+static inline q15_t dsp_sat_q15(int32_t x) {
+    return (q15_t)(x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x));
+}
+
+/*! \brief Saturate a value to the range of a \ref q31_t
+ *  \ingroup pico_dsp
+ */
+static inline q31_t dsp_sat_q31(int64_t x) {
+    return (q31_t)(x > INT32_MAX ? INT32_MAX : (x < INT32_MIN ? INT32_MIN : x));
+}
+
+/*! \brief Dot product of two Q15 vectors
+ *  \ingroup pico_dsp
+ *
+ * \param a the first vector
+ * \param b the second vector
+ * \param count the number of elements
+ * \return the exact sum of the products, with 30 fractional bits
+ */
+int64_t dsp_dot_q15(const q15_t *a, const q15_t *b, uint count);
+
+/*! \brief Dot product of two Q31 vectors
+ *  \ingroup pico_dsp
+ *
+ * \param a the first vector
+ * \param b the second vector
+ * \param count the number of elements
+ * \return the sum of the products, each truncated to 48 fractional bits, so that as many as 2^16 can be summed
+ * without overflow
+ */
+int64_t dsp_dot_q31(const q31_t *a, const q31_t *b, uint count);
+
+/*! \brief Multiply a Q15 vector by a scale factor
+ *  \ingroup pico_dsp
+ *
+ * Sets dst[i] = src[i] * scale * 2^shift, rounded down and saturated; the shift allows factors of 1.0 or more.
+ *
+ * \param dst the result; may be the same as src
+ * \param src the vector
+ * \param count the number of elements
+ * \param scale the scale factor
+ * \param shift the number of bits to shift the result left by; 0 to 15
+ */
+void dsp_scale_q15(q15_t *dst, const q15_t *src, uint count, q15_t scale, uint shift);
+
+/*! \brief Multiply a Q31 vector by a scale factor
+ *  \ingroup pico_dsp
+ *
+ * Sets dst[i] = src[i] * scale * 2^shift, rounded down and saturated; the shift allows factors of 1.0 or more.
+ *
+ * \param dst the result; may be the same as src
+ * \param src the vector
+ * \param count the number of elements
+ * \param scale the scale factor
+ * \param shift the number of bits to shift the result left by; 0 to 31
+ */
+void dsp_scale_q31(q31_t *dst, const q31_t *src, uint count, q31_t scale, uint shift);
+
+/*! \brief Divide two Q15 values
+ *  \ingroup pico_dsp
+ *
+ * Uses the hardware divider where there is one, so like the other hardware_divider functions, must not be called
+ * from an interrupt handler unless code it may interrupt saves the divider state.
+ *
+ * \param num the numerator
+ * \param den the denominator
+ * \return num / den, rounded towards zero and saturated; a division by zero saturates to the sign of num, or gives 0
+ * if num is 0
+ */
+q15_t dsp_div_q15(q15_t num, q15_t den);
+
+/*! \brief Divide two Q31 values
+ *  \ingroup pico_dsp
+ *
+ * This needs a 64 bit division, which on RP2040 uses the hardware divider via pico_divider.
+ *
+ * \param num the numerator
+ * \param den the denominator
+ * \return num / den, rounded towards zero and saturated; a division by zero saturates to the sign of num, or gives 0
+ * if num is 0
+ */
+q31_t dsp_div_q31(q31_t num, q31_t den);
+
+/*! \brief The number of elements needed in the state buffer of an FIR filter
+ *  \ingroup pico_dsp
+ */
+#define DSP_FIR_STATE_SIZE(num_taps, max_block_size) ((num_taps) + (max_block_size) - 1)
+
+/*! \brief A Q15 FIR filter
+ *  \ingroup pico_dsp
+ */
+typedef struct {
+    const q15_t *coeffs;
+    q15_t *state;
+    uint num_taps;
+    uint max_block_size;
+} dsp_fir_q15_t;
+
+/*! \brief A Q31 FIR filter
+ *  \ingroup pico_dsp
+ */
+typedef struct {
+    const q31_t *coeffs;
+    q31_t *state;
+    uint num_taps;
+    uint max_block_size;
+} dsp_fir_q31_t;
+
+/*! \brief Initialise a Q15 FIR filter
+ *  \ingroup pico_dsp
+ *
+ * The filter computes y[n] = sum of coeffs[k] * x[n - k] for k = 0 to num_taps - 1, with the previous samples
+ * initially zero. The coefficients and state buffer are used in place, so must remain valid while the filter is used.
+ *
+ * \param fir the filter
+ * \param coeffs the coefficients
+ * \param num_taps the number of coefficients; at least 1
+ * \param state a buffer of \ref DSP_FIR_STATE_SIZE(num_taps, max_block_size) elements
+ * \param max_block_size the largest number of samples which will be passed to \ref dsp_fir_q15 at once
+ */
+void dsp_fir_q15_init(dsp_fir_q15_t *fir, const q15_t *coeffs, uint num_taps, q15_t *state, uint max_block_size);
+
+/*! \brief Filter a block of samples with a Q15 FIR filter
+ *  \ingroup pico_dsp
+ *
+ * The sum of the products for each output is exact, and is then shifted down to Q15 (rounding down) and saturated.
+ *
+ * \param fir the filter
+ * \param dst the output samples; may be the same as src
+ * \param src the input samples, which follow those from the previous call
+ * \param count the number of samples; at most max_block_size
+ */
+void dsp_fir_q15(dsp_fir_q15_t *fir, q15_t *dst, const q15_t *src, uint count);
+
+/*! \brief Initialise a Q31 FIR filter
+ *  \ingroup pico_dsp
+ *
+ * As \ref dsp_fir_q15_init
+ */
+void dsp_fir_q31_init(dsp_fir_q31_t *fir, const q31_t *coeffs, uint num_taps, q31_t *state, uint max_block_size);
+
+/*! \brief Filter a block of samples with a Q31 FIR filter
+ *  \ingroup pico_dsp
+ *
+ * The products are summed with 62 fractional bits, leaving only one bit of headroom (which wraps if exceeded), before
+ * being shifted down to Q31 (rounding down) and saturated; to avoid any possibility of wrapping, the input must be
+ * scaled down by log2(num_taps) bits.
+ *
+ * \param fir the filter
+ * \param dst the output samples; may be the same as src
+ * \param src the input samples, which follow those from the previous call
+ * \param count the number of samples; at most max_block_size
+ */
+void dsp_fir_q31(dsp_fir_q31_t *fir, q31_t *dst, const q31_t *src, uint count);
+
+/*! \brief The number of coefficients per stage of a biquad filter: b0, b1, b2, a1, a2
+ *  \ingroup pico_dsp
+ */
+#define DSP_BIQUAD_COEFFS_PER_STAGE 5
+
+/*! \brief The number of elements of state per stage of a biquad filter: x[n-1], x[n-2], y[n-1], y[n-2]
+ *  \ingroup pico_dsp
+ */
+#define DSP_BIQUAD_STATE_PER_STAGE 4
+
+/*! \brief A cascade of Q15 biquad filters
+ *  \ingroup pico_dsp
+ */
+typedef struct {
+    const q15_t *coeffs;
+    q15_t *state;
+    uint num_stages;
+    uint post_shift;
+} dsp_biquad_q15_t;
+
+/*! \brief A cascade of Q31 biquad filters
+ *  \ingroup pico_dsp
+ */
+typedef struct {
+    const q31_t *coeffs;
+    q31_t *state;
+    uint num_stages;
+    uint post_shift;
+} dsp_biquad_q31_t;
+
+/*! \brief Initialise a cascade of Q15 biquad filters
+ *  \ingroup pico_dsp
+ *
+ * Each stage is a direct form I biquad:
+ *
+ *     y[n] = (b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] + a1 * y[n-1] + a2 * y[n-2]) * 2^post_shift
+ *
+ * and its output is the input to the next stage. Note that the feedback coefficients a1 and a2 are added, so are the
+ * negatives of those in the usual form of the transfer function (as in CMSIS-DSP). Coefficients of 1.0 or more are
+ * represented by scaling them all down by 2^post_shift. The state is initially zero.
+ *
+ * \param biquad the filter
+ * \param num_stages the number of stages
+ * \param coeffs the coefficients, \ref DSP_BIQUAD_COEFFS_PER_STAGE per stage: b0, b1, b2, a1, a2; used in place
+ * \param state a buffer of \ref DSP_BIQUAD_STATE_PER_STAGE elements per stage
+ * \param post_shift the scaling of the coefficients; 0 to 15
+ */
+void dsp_biquad_q15_init(dsp_biquad_q15_t *biquad, uint num_stages, const q15_t *coeffs, q15_t *state,
+                         uint post_shift);
+
+/*! \brief Filter a block of samples with a cascade of Q15 biquad filters
+ *  \ingroup pico_dsp
+ *
+ * The sum of the products for each stage's output is exact, and is then shifted down to Q15 (rounding down) and
+ * saturated.
+ *
+ * \param biquad the filter
+ * \param dst the output samples; may be the same as src
+ * \param src the input samples
+ * \param count the number of samples
+ */
+void dsp_biquad_q15(dsp_biquad_q15_t *biquad, q15_t *dst, const q15_t *src, uint count);
+
+/*! \brief Initialise a cascade of Q31 biquad filters
+ *  \ingroup pico_dsp
+ *
+ * As \ref dsp_biquad_q15_init, with post_shift 0 to 31
+ */
+void dsp_biquad_q31_init(dsp_biquad_q31_t *biquad, uint num_stages, const q31_t *coeffs, q31_t *state,
+                         uint post_shift);
+
+/*! \brief Filter a block of samples with a cascade of Q31 biquad filters
+ *  \ingroup pico_dsp
+ *
+ * The products for each stage's output are summed with 62 fractional bits, leaving only one bit of headroom (which
+ * wraps if exceeded), before being shifted down to Q31 (rounding down) and saturated.
+ *
+ * \param biquad the filter
+ * \param dst the output samples; may be the same as src
+ * \param src the input samples
+ * \param count the number of samples
+ */
+void dsp_biquad_q31(dsp_biquad_q31_t *biquad, q31_t *dst, const q31_t *src, uint count);
+
+/*! \brief In place radix-4 FFT of Q15 complex data
+ *  \ingroup pico_dsp
+ *
+ * Each stage halves the values twice as it adds them, so the result is the transform divided by length (for both
+ * the forward and the inverse transform), and can't overflow. Twiddle factor products are rounded down, and
+ * saturated in the unlikely case that a value is outside the unit circle.
+ *
+ * \param data length complex values, each a real part followed by an imaginary part; must be 4 byte aligned. Replaced
+ * by the transform, in natural order
+ * \param length the number of complex values; a power of 4 from 4 to \ref DSP_FFT_MAX_LENGTH
+ * \param inverse false for the forward transform (with twiddle factors e^(-2 pi i k / length)), true for the inverse
+ */
+void dsp_fft_q15(q15_t *data, uint length, bool inverse);
+
+/*! \brief In place radix-4 FFT of Q31 complex data
+ *  \ingroup pico_dsp
+ *
+ * As \ref dsp_fft_q15
+ *
+ * \param data length complex values, each a real part followed by an imaginary part. Replaced by the transform, in
+ * natural order
+ * \param length the number of complex values; a power of 4 from 4 to \ref DSP_FFT_MAX_LENGTH
+ * \param inverse false for the forward transform, true for the inverse
+ */
+void dsp_fft_q31(q31_t *data, uint length, bool inverse);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -10,6 +10,7 @@
 #include "pico/multicore.h"
 #endif
 #include "pico/time.h"
+#include "hardware/flash.h"
 #if PICO_FLASH_SAFE_EXECUTE_SUPPORT_FREERTOS_SMP
 #include "FreeRTOS.h"
 #include "task.h"
@@ -83,6 +84,90 @@ int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_ti
     return rc;
 }
 
+void flash_safe_session_init(flash_safe_session_t *session, flash_safe_op_t *ops, uint capacity) {
+    *session = (flash_safe_session_t){
+        .ops = ops,
+        .capacity = capacity,
+        .estimate_us = {
+            [FLASH_SAFE_OP_ERASE] = PICO_FLASH_SAFE_SESSION_ERASE_ESTIMATE_US,
+            [FLASH_SAFE_OP_PROGRAM] = PICO_FLASH_SAFE_SESSION_PROGRAM_ESTIMATE_US,
+        },
+    };
+}
+
+static bool flash_safe_session_add(flash_safe_session_t *session, uint8_t type, uint32_t flash_offs, const uint8_t *data, size_t count) {
+    if (session->count == session->capacity) return false;
+    session->ops[session->count++] = (flash_safe_op_t){
+        .type = type,
+        .flash_offs = flash_offs,
+        .count = count,
+        .data = data,
+    };
+    return true;
+}
+
+bool flash_safe_session_add_erase(flash_safe_session_t *session, uint32_t flash_offs, size_t count) {
+    hard_assert(!(flash_offs & (FLASH_SECTOR_SIZE - 1)) && !(count & (FLASH_SECTOR_SIZE - 1)));
+    return flash_safe_session_add(session, FLASH_SAFE_OP_ERASE, flash_offs, NULL, count);
+}
+
+bool flash_safe_session_add_program(flash_safe_session_t *session, uint32_t flash_offs, const uint8_t *data, size_t count) {
+    hard_assert(!(flash_offs & (FLASH_PAGE_SIZE - 1)) && !(count & (FLASH_PAGE_SIZE - 1)));
+    return flash_safe_session_add(session, FLASH_SAFE_OP_PROGRAM, flash_offs, data, count);
+}
+
+int flash_safe_session_run(flash_safe_session_t *session, uint32_t max_lockout_us, uint32_t enter_exit_timeout_ms) {
+    flash_safety_helper_t *helper = get_flash_safety_helper();
+    int rc = helper ? PICO_OK : PICO_ERROR_NOT_PERMITTED;
+    uint index = 0;
+    size_t done = 0; // bytes of ops[index] already done
+    while (!rc && index < session->count) {
+        absolute_time_t start = get_absolute_time();
+        rc = helper->enter_safe_zone_timeout_ms(enter_exit_timeout_ms);
+        if (rc) break;
+        uint32_t elapsed_us = 0;
+        bool first = true;
+        do {
+            const flash_safe_op_t *op = &session->ops[index];
+            // do at most a sector at a time, so the lockout can end between sectors of a large operation
+            size_t len = MIN(op->count - done, FLASH_SECTOR_SIZE);
+            if (!first && max_lockout_us && elapsed_us + session->estimate_us[op->type] > max_lockout_us) break;
+            first = false;
+            absolute_time_t chunk_start = get_absolute_time();
+            if (op->type == FLASH_SAFE_OP_ERASE) {
+                flash_range_erase(op->flash_offs + done, len);
+            } else {
+                flash_range_program(op->flash_offs + done, op->data + done, len);
+            }
+            absolute_time_t now = get_absolute_time();
+            // a short final program is scaled up, so the estimate stays per sector
+            session->estimate_us[op->type] = (uint32_t)(absolute_time_diff_us(chunk_start, now) * FLASH_SECTOR_SIZE / len);
+            elapsed_us = (uint32_t)absolute_time_diff_us(start, now);
+            session->stats.chunks++;
+            done += len;
+            if (done == op->count) {
+                index++;
+                done = 0;
+            }
+        } while (index < session->count);
+        rc = helper->exit_safe_zone_timeout_ms(enter_exit_timeout_ms);
+        uint32_t lockout_us = (uint32_t)absolute_time_diff_us(start, get_absolute_time());
+        session->stats.lockouts++;
+        session->stats.total_lockout_us += lockout_us;
+        if (lockout_us > session->stats.max_lockout_us) session->stats.max_lockout_us = lockout_us;
+    }
+    session->count = 0;
+    return rc;
+}
+
+void flash_safe_session_get_stats(const flash_safe_session_t *session, flash_safe_session_stats_t *stats) {
+    *stats = session->stats;
+}
+
+void flash_safe_session_reset_stats(flash_safe_session_t *session) {
+    session->stats = (flash_safe_session_stats_t){0};
+}
+
 static bool default_core_init_deinit(__unused bool init) {
 #if PICO_FLASH_ASSUME_CORE0_SAFE
     if (!get_core_num()) return true;
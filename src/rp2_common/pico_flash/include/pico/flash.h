@@ -115,6 +115,139 @@ int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_ti
 #endif
 #endif
 
+// PICO_CONFIG: PICO_FLASH_SAFE_SESSION_ERASE_ESTIMATE_US, Initial estimate of the time to erase one sector used by flash_safe_session_run to decide whether an erase fits in the current lockout; it is replaced by measured times as the session runs, type=int, default=50000, group=pico_flash
+#ifndef PICO_FLASH_SAFE_SESSION_ERASE_ESTIMATE_US
+#define PICO_FLASH_SAFE_SESSION_ERASE_ESTIMATE_US 50000
+#endif
+
+// PICO_CONFIG: PICO_FLASH_SAFE_SESSION_PROGRAM_ESTIMATE_US, Initial estimate of the time to program one sector's worth of pages used by flash_safe_session_run to decide whether a program fits in the current lockout; it is replaced by measured times as the session runs, type=int, default=10000, group=pico_flash
+#ifndef PICO_FLASH_SAFE_SESSION_PROGRAM_ESTIMATE_US
+#define PICO_FLASH_SAFE_SESSION_PROGRAM_ESTIMATE_US 10000
+#endif
+
+/*! \brief Type of a queued flash operation
+ *  \ingroup pico_flash
+ */
+enum flash_safe_op_type {
+    FLASH_SAFE_OP_ERASE,    ///< flash_range_erase()
+    FLASH_SAFE_OP_PROGRAM,  ///< flash_range_program()
+};
+
+/*! \brief A queued flash operation
+ *  \ingroup pico_flash
+ */
+typedef struct flash_safe_op {
+    uint8_t type;           ///< an \ref flash_safe_op_type
+    uint32_t flash_offs;    ///< flash offset; a multiple of FLASH_SECTOR_SIZE for an erase, or FLASH_PAGE_SIZE for a program
+    size_t count;           ///< number of bytes; a multiple of FLASH_SECTOR_SIZE for an erase, or FLASH_PAGE_SIZE for a program
+    const uint8_t *data;    ///< data to program, which must remain valid until the session has run
+} flash_safe_op_t;
+
+/*! \brief Lockout statistics for a flash session
+ *  \ingroup pico_flash
+ *
+ * A lockout is the time from starting to enter the safe zone to having left it again, which is approximately how long
+ * the other core (and interrupts) are held off.
+ */
+typedef struct flash_safe_session_stats {
+    uint32_t lockouts;          ///< number of times the safe zone was entered
+    uint32_t chunks;            ///< number of flash_range_erase() and flash_range_program() calls made
+    uint32_t max_lockout_us;    ///< longest lockout
+    uint64_t total_lockout_us;  ///< sum of all the lockouts
+} flash_safe_session_stats_t;
+
+/*! \brief A queue of flash operations to be run with as few safe zone entries as possible
+ *  \ingroup pico_flash
+ *
+ * Treat as opaque; the fields may change between releases.
+ */
+typedef struct flash_safe_session {
+    flash_safe_op_t *ops;
+    uint capacity;
+    uint count;
+    uint32_t estimate_us[2];
+    flash_safe_session_stats_t stats;
+} flash_safe_session_t;
+
+/*! \brief Initialize a flash session
+ *  \ingroup pico_flash
+ *
+ * Code which erases and programs many sectors can queue the operations in a session, and then run them together with
+ * \ref flash_safe_session_run, rather than paying for the handshake with the other core in \ref flash_safe_execute
+ * for each sector.
+ *
+ * \param session the session
+ * \param ops storage for the queued operations
+ * \param capacity the number of operations \p ops can hold
+ */
+void flash_safe_session_init(flash_safe_session_t *session, flash_safe_op_t *ops, uint capacity);
+
+/*! \brief Queue an erase in a flash session
+ *  \ingroup pico_flash
+ *
+ * \param session the session
+ * \param flash_offs offset into flash of the first sector to erase; must be a multiple of FLASH_SECTOR_SIZE
+ * \param count number of bytes to erase; must be a multiple of FLASH_SECTOR_SIZE
+ * \return true if the erase was queued, false if the session is full
+ */
+bool flash_safe_session_add_erase(flash_safe_session_t *session, uint32_t flash_offs, size_t count);
+
+/*! \brief Queue a program in a flash session
+ *  \ingroup pico_flash
+ *
+ * \param session the session
+ * \param flash_offs offset into flash of the first page to program; must be a multiple of FLASH_PAGE_SIZE
+ * \param data the data, which must remain valid until the session has run; as for flash_range_program() it must not be in flash
+ * \param count number of bytes to program; must be a multiple of FLASH_PAGE_SIZE
+ * \return true if the program was queued, false if the session is full
+ */
+bool flash_safe_session_add_program(flash_safe_session_t *session, uint32_t flash_offs, const uint8_t *data, size_t count);
+
+/*! \brief Return the number of operations queued in a flash session
+ *  \ingroup pico_flash
+ *
+ * \param session the session
+ * \return the number of operations that \ref flash_safe_session_run would perform
+ */
+static inline uint flash_safe_session_get_count(const flash_safe_session_t *session) {
+    return session->count;
+}
+
+/*! \brief Run the operations queued in a flash session, in order, and empty the queue
+ *  \ingroup pico_flash
+ *
+ * The safe zone is entered (as by \ref flash_safe_execute) and operations are run, a sector at a time, until either the
+ * queue is empty or the next sector would take the lockout past \p max_lockout_us; the safe zone is then left (letting
+ * the other core and interrupts run) and entered again for the rest. Whether a sector fits is judged from the last
+ * measured time for that kind of operation, starting from \ref PICO_FLASH_SAFE_SESSION_ERASE_ESTIMATE_US or
+ * \ref PICO_FLASH_SAFE_SESSION_PROGRAM_ESTIMATE_US. At least one sector is always done per lockout, so a bound shorter
+ * than a single operation still makes progress.
+ *
+ * \param session the session
+ * \param max_lockout_us the longest the safe zone should be held for, or 0 to run everything in one lockout
+ * \param enter_exit_timeout_ms the timeout for each of the enter/exit phases when coordinating with the other core
+ * \return PICO_OK on success, or an error as for \ref flash_safe_execute, in which case the operations not yet run
+ *         are discarded
+ */
+int flash_safe_session_run(flash_safe_session_t *session, uint32_t max_lockout_us, uint32_t enter_exit_timeout_ms);
+
+/*! \brief Get the lockout statistics for a flash session
+ *  \ingroup pico_flash
+ *
+ * The statistics accumulate over all runs of the session until reset.
+ *
+ * \param session the session
+ * \param stats receives the statistics
+ */
+void flash_safe_session_get_stats(const flash_safe_session_t *session, flash_safe_session_stats_t *stats);
+
+/*! \brief Reset the lockout statistics for a flash session to zero
+ *  \ingroup pico_flash
+ *
+ * \param session the session
+ */
+void flash_safe_session_reset_stats(flash_safe_session_t *session);
+
 typedef struct {
     bool (*core_init_deinit)(bool init);
     int (*enter_safe_zone_timeout_ms)(uint32_t timeout_ms);
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_INTERP_KERNELS_H
+#define _PICO_INTERP_KERNELS_H
+
+#include "pico.h"
+
+/** \file pico/interp_kernels.h
+ *  \defgroup pico_interp_kernels pico_interp_kernels
+ *
+ * \brief Ready made loops using the interpolators (see \ref hardware_interp)
+ *
+ * Each kernel configures an interpolator of the calling core for the job, so that the address or value calculation
+ * for each element is done by one interpolator access rather than several instructions:
+ *
+ * - \ref interp_table_lookup maps 8 bit indices through a table, using interp0 to scale the indices by the table's
+ *   entry size and add the table's address
+ * - \ref interp_affine_sample samples a texture along a line (e.g. a span of a rotated or scaled image), using interp0
+ *   to step the texture coordinates and form the texel's address
+ * - \ref interp_blend_u8 and \ref interp_blend_alpha_u8 blend two arrays of 8 bit values (e.g. colour channels),
+ *   using interp0's blend mode
+ * - \ref interp_accumulate_clamped_s16 adds scaled samples to a buffer with saturation (e.g. mixing audio), using
+ *   interp1's clamp mode
+ *
+ * Each has a plain C version with the suffix _ref, which gives exactly the same results, for comparison and for
+ * testing. On the host, hardware_interp is a bit exact software model of the interpolators, so the kernels can be
+ * tested there too.
+ *
+ * By default each kernel saves the state of the interpolator it uses and restores it when it is done (see
+ * \ref PICO_INTERP_KERNELS_SAVE_STATE), so may be called by code which is itself using that interpolator. As with
+ * any other use of the interpolators, an interrupt handler which uses them must save and restore their state itself.
+ */
+
+// PICO_CONFIG: PARAM_ASSERTIONS_ENABLED_PICO_INTERP_KERNELS, Enable/disable assertions in the pico_interp_kernels module, type=bool, default=0, group=pico_interp_kernels
+#ifndef PARAM_ASSERTIONS_ENABLED_PICO_INTERP_KERNELS
+#define PARAM_ASSERTIONS_ENABLED_PICO_INTERP_KERNELS 0
+#endif
+
+// PICO_CONFIG: PICO_INTERP_KERNELS_SAVE_STATE, Whether the kernels save and restore the state of the interpolator they use; may be set to 0 if the interpolators are used by nothing else, type=bool, default=1, group=pico_interp_kernels
+#ifndef PICO_INTERP_KERNELS_SAVE_STATE
+#define PICO_INTERP_KERNELS_SAVE_STATE 1
+#endif
+
+/*! \brief The number of fractional bits in the texture coordinates passed to \ref interp_affine_sample
+ *  \ingroup pico_interp_kernels
+ */
+#define INTERP_AFFINE_FRAC_BITS 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief Map 8 bit indices through a table, using interp0
+ *  \ingroup pico_interp_kernels
+ *
+ * Sets dst[i] = table[indices[i]] for each of the count indices; e.g. to convert an 8 bit palettised image to
+ * RGB565 with a table of 256 uint16_t colours. Four indices are read at a time.
+ *
+ * \param dst the destination, an array of count entries of the table's entry size
+ * \param indices the indices
+ * \param count the number of indices
+ * \param table the table, with (at least) as many entries as the largest index + 1
+ * \param entry_size_log2 log2 of the size of a table entry in bytes; 0, 1 or 2
+ */
+void interp_table_lookup(void *dst, const uint8_t *indices, uint count, const void *table, uint entry_size_log2);
+
+/*! \brief Plain C version of \ref interp_table_lookup
+ *  \ingroup pico_interp_kernels
+ */
+void interp_table_lookup_ref(void *dst, const uint8_t *indices, uint count, const void *table, uint entry_size_log2);
+
+/*! \brief Sample a texture along a line, using interp0
+ *  \ingroup pico_interp_kernels
+ *
+ * The texture coordinates (u, v) are fixed point with \ref INTERP_AFFINE_FRAC_BITS fractional bits, and the texture
+ * repeats in both directions (i.e. the integer parts of the coordinates are taken modulo the texture's width and
+ * height). For each of the count texels, the texel at (u, v) is copied to dst, then du and dv are added to u and v.
+ *
+ * \param dst the destination, an array of count texels
+ * \param count the number of texels
+ * \param texture the texture, stored row by row
+ * \param texel_size_log2 log2 of the size of a texel in bytes; 0, 1 or 2
+ * \param width_log2 log2 of the texture's width in texels; at least 1, and at most
+ * \ref INTERP_AFFINE_FRAC_BITS - texel_size_log2
+ * \param height_log2 log2 of the texture's height in texels; at least 1, and at most 32 - width_log2 - texel_size_log2
+ * \param u the first texel's u (x) coordinate
+ * \param v the first texel's v (y) coordinate
+ * \param du the change in u from one texel to the next
+ * \param dv the change in v from one texel to the next
+ */
+void interp_affine_sample(void *dst, uint count, const void *texture, uint texel_size_log2, uint width_log2,
+                          uint height_log2, uint32_t u, uint32_t v, int32_t du, int32_t dv);
+
+/*! \brief Plain C version of \ref interp_affine_sample
+ *  \ingroup pico_interp_kernels
+ */
+void interp_affine_sample_ref(void *dst, uint count, const void *texture, uint texel_size_log2, uint width_log2,
+                              uint height_log2, uint32_t u, uint32_t v, int32_t du, int32_t dv);
+
+/*! \brief Blend two arrays of 8 bit values with a constant alpha, using interp0
+ *  \ingroup pico_interp_kernels
+ *
+ * Sets dst[i] = a[i] + alpha * (b[i] - a[i]) / 256, rounded down, for each of the count values; so an alpha of 0
+ * gives a, and 255 gives nearly b. dst may be the same array as a or b.
+ *
+ * \param dst the destination
+ * \param a the values for alpha 0
+ * \param b the values blended towards as alpha increases
+ * \param count the number of values
+ * \param alpha the weight of b, in 256ths
+ */
+void interp_blend_u8(uint8_t *dst, const uint8_t *a, const uint8_t *b, uint count, uint8_t alpha);
+
+/*! \brief Plain C version of \ref interp_blend_u8
+ *  \ingroup pico_interp_kernels
+ */
+void interp_blend_u8_ref(uint8_t *dst, const uint8_t *a, const uint8_t *b, uint count, uint8_t alpha);
+
+/*! \brief Blend two arrays of 8 bit values with an alpha per value, using interp0
+ *  \ingroup pico_interp_kernels
+ *
+ * As \ref interp_blend_u8, but with alpha[i] the weight of b[i]
+ *
+ * \param dst the destination
+ * \param a the values for alpha 0
+ * \param b the values blended towards as alpha increases
+ * \param alpha the weights of the values of b, in 256ths
+ * \param count the number of values
+ */
+void interp_blend_alpha_u8(uint8_t *dst, const uint8_t *a, const uint8_t *b, const uint8_t *alpha, uint count);
+
+/*! \brief Plain C version of \ref interp_blend_alpha_u8
+ *  \ingroup pico_interp_kernels
+ */
+void interp_blend_alpha_u8_ref(uint8_t *dst, const uint8_t *a, const uint8_t *b, const uint8_t *alpha, uint count);
+
+/*! \brief Add scaled 16 bit samples to a buffer, with saturation, using interp1
+ *  \ingroup pico_interp_kernels
+ *
+ * Sets acc[i] to acc[i] + src[i] * gain / 32768 (rounded down), clamped to the range of an int16_t, for each of the
+ * count samples; e.g. to mix a voice into an audio buffer.
+ *
+ * \param acc the buffer added to
+ * \param src the samples to add
+ * \param count the number of samples
+ * \param gain the scale applied to src, as a Q15 fixed point value (-1.0 to just under 1.0)
+ */
+void interp_accumulate_clamped_s16(int16_t *acc, const int16_t *src, uint count, int16_t gain);
+
+/*! \brief Plain C version of \ref interp_accumulate_clamped_s16
+ *  \ingroup pico_interp_kernels
+ */
+void interp_accumulate_clamped_s16_ref(int16_t *acc, const int16_t *src, uint count, int16_t gain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
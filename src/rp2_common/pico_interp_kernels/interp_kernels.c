@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/interp_kernels.h"
+#include "hardware/interp.h"
+
+#if PICO_INTERP_KERNELS_SAVE_STATE
+#define INTERP_KERNEL_SAVE(interp, saver) interp_hw_save_t saver; interp_save(interp, &saver)
+#define INTERP_KERNEL_RESTORE(interp, saver) interp_restore(interp, &saver)
+#else
+#define INTERP_KERNEL_SAVE(interp, saver) ((void)0)
+#define INTERP_KERNEL_RESTORE(interp, saver) ((void)0)
+#endif
+
+// The interpolators are 32 bits wide; where pointers are wider (i.e. on the host) the address is rebuilt from the
+// offset of the interpolator's result from the low 32 bits of the base address it was given
+static __force_inline const void *result_address(uint32_t result, const void *base) {
+#if __SIZEOF_POINTER__ > 4
+    return (const uint8_t *)base + (uint32_t)(result - (uint32_t)(uintptr_t)base);
+#else
+    (void)base;
+    return (const void *)result;
+#endif
+}
+
+static __force_inline void store_entry(void *dst, uint i, const void *entry, uint size_log2) {
+    switch (size_log2) {
+        case 0:
+            ((uint8_t *)dst)[i] = *(const uint8_t *)entry;
+            break;
+        case 1:
+            ((uint16_t *)dst)[i] = *(const uint16_t *)entry;
+            break;
+        default:
+            ((uint32_t *)dst)[i] = *(const uint32_t *)entry;
+            break;
+    }
+}
+
+static __force_inline void table_lookup_words(void *dst, uint i, const uint8_t *indices, uint count, const void *table,
+                                               uint size_log2) {
+    // each word of indices is written to ACCUM0 twice: shifted left by the entry size, so that lanes 0 and 1 give
+    // the addresses of the entries for the first two indices, then shifted right so that they give the other two
+    for (; i + 4 <= count; i += 4) {
+        uint32_t word = *(const uint32_t *)(indices + i);
+        interp_set_accumulator(interp0, 0, word << size_log2);
+        store_entry(dst, i, result_address(interp_peek_lane_result(interp0, 0), table), size_log2);
+        store_entry(dst, i + 1, result_address(interp_peek_lane_result(interp0, 1), table), size_log2);
+        interp_set_accumulator(interp0, 0, word >> (16 - size_log2));
+        store_entry(dst, i + 2, result_address(interp_peek_lane_result(interp0, 0), table), size_log2);
+        store_entry(dst, i + 3, result_address(interp_peek_lane_result(interp0, 1), table), size_log2);
+    }
+}
+
+void interp_table_lookup(void *dst, const uint8_t *indices, uint count, const void *table, uint entry_size_log2) {
+    invalid_params_if(PICO_INTERP_KERNELS, entry_size_log2 > 2);
+    // the indices before the first whole word, and after the last, are looked up in C
+    uint head = MIN(count, (uint)(-(uintptr_t)indices & 3u));
+    interp_table_lookup_ref(dst, indices, head, table, entry_size_log2);
+    if (count - head >= 4) {
+        INTERP_KERNEL_SAVE(interp0, saver);
+        interp_config cfg = interp_default_config();
+        interp_config_set_mask(&cfg, entry_size_log2, entry_size_log2 + 7);
+        interp_set_config(interp0, 0, &cfg);
+        interp_config_set_cross_input(&cfg, true);
+        interp_config_set_shift(&cfg, 8);
+        interp_set_config(interp0, 1, &cfg);
+        interp_set_base(interp0, 0, (uint32_t)(uintptr_t)table);
+        interp_set_base(interp0, 1, (uint32_t)(uintptr_t)table);
+        switch (entry_size_log2) {
+            case 0:
+                table_lookup_words(dst, head, indices, count, table, 0);
+                break;
+            case 1:
+                table_lookup_words(dst, head, indices, count, table, 1);
+                break;
+            default:
+                table_lookup_words(dst, head, indices, count, table, 2);
+                break;
+        }
+        INTERP_KERNEL_RESTORE(interp0, saver);
+    }
+    uint tail = head + ((count - head) & ~3u);
+    interp_table_lookup_ref((uint8_t *)dst + (tail << entry_size_log2), indices + tail, count - tail, table,
+                            entry_size_log2);
+}
+
+void interp_table_lookup_ref(void *dst, const uint8_t *indices, uint count, const void *table, uint entry_size_log2) {
+    invalid_params_if(PICO_INTERP_KERNELS, entry_size_log2 > 2);
+    for (uint i = 0; i < count; i++) {
+        store_entry(dst, i, (const uint8_t *)table + (indices[i] << entry_size_log2), entry_size_log2);
+    }
+}
+
+static void check_affine_params(uint texel_size_log2, uint width_log2, uint height_log2) {
+    invalid_params_if(PICO_INTERP_KERNELS, texel_size_log2 > 2);
+    invalid_params_if(PICO_INTERP_KERNELS, !width_log2 || width_log2 + texel_size_log2 > INTERP_AFFINE_FRAC_BITS);
+    invalid_params_if(PICO_INTERP_KERNELS, !height_log2 || texel_size_log2 + width_log2 + height_log2 > 32);
+    (void)texel_size_log2;
+    (void)width_log2;
+    (void)height_log2;
+}
+
+void interp_affine_sample(void *dst, uint count, const void *texture, uint texel_size_log2, uint width_log2,
+                          uint height_log2, uint32_t u, uint32_t v, int32_t du, int32_t dv) {
+    check_affine_params(texel_size_log2, width_log2, height_log2);
+    if (!count) return;
+    INTERP_KERNEL_SAVE(interp0, saver);
+    // the lanes' results are u + du and v + dv, which a pop writes back to the accumulators; the FULL result is the
+    // texture address plus the shifted and masked u and v, i.e. the texel's offset in bytes
+    uint row_shift = texel_size_log2 + width_log2;
+    interp_config cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_config_set_shift(&cfg, INTERP_AFFINE_FRAC_BITS - texel_size_log2);
+    interp_config_set_mask(&cfg, texel_size_log2, row_shift - 1);
+    interp_set_config(interp0, 0, &cfg);
+    interp_config_set_shift(&cfg, INTERP_AFFINE_FRAC_BITS - row_shift);
+    interp_config_set_mask(&cfg, row_shift, row_shift + height_log2 - 1);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_base(interp0, 0, (uint32_t)du);
+    interp_set_base(interp0, 1, (uint32_t)dv);
+    interp_set_base(interp0, 2, (uint32_t)(uintptr_t)texture);
+    interp_set_accumulator(interp0, 0, u);
+    interp_set_accumulator(interp0, 1, v);
+    switch (texel_size_log2) {
+        case 0:
+            for (uint i = 0; i < count; i++) {
+                ((uint8_t *)dst)[i] = *(const uint8_t *)result_address(interp_pop_full_result(interp0), texture);
+            }
+            break;
+        case 1:
+            for (uint i = 0; i < count; i++) {
+                ((uint16_t *)dst)[i] = *(const uint16_t *)result_address(interp_pop_full_result(interp0), texture);
+            }
+            break;
+        default:
+            for (uint i = 0; i < count; i++) {
+                ((uint32_t *)dst)[i] = *(const uint32_t *)result_address(interp_pop_full_result(interp0), texture);
+            }
+            break;
+    }
+    INTERP_KERNEL_RESTORE(interp0, saver);
+}
+
+void interp_affine_sample_ref(void *dst, uint count, const void *texture, uint texel_size_log2, uint width_log2,
+                              uint height_log2, uint32_t u, uint32_t v, int32_t du, int32_t dv) {
+    check_affine_params(texel_size_log2, width_log2, height_log2);
+    uint32_t x_mask = (1u << width_log2) - 1;
+    uint32_t y_mask = (1u << height_log2) - 1;
+    for (uint i = 0; i < count; i++) {
+        uint32_t x = (u >> INTERP_AFFINE_FRAC_BITS) & x_mask;
+        uint32_t y = (v >> INTERP_AFFINE_FRAC_BITS) & y_mask;
+        store_entry(dst, i, (const uint8_t *)texture + (((y << width_log2) + x) << texel_size_log2), texel_size_log2);
+        u += (uint32_t)du;
+        v += (uint32_t)dv;
+    }
+}
+
+static void blend_setup(void) {
+    // lane 1's shift and mask value (its accumulator, unchanged) is alpha, and its result is the blend of BASE0 and
+    // BASE1, which are set together from a value and its counterpart by a write to BASE_1AND0
+    interp_config cfg = interp_default_config();
+    interp_config_set_blend(&cfg, true);
+    interp_set_config(interp0, 0, &cfg);
+    cfg = interp_default_config();
+    interp_set_config(interp0, 1, &cfg);
+}
+
+void interp_blend_u8(uint8_t *dst, const uint8_t *a, const uint8_t *b, uint count, uint8_t alpha) {
+    if (!count) return;
+    INTERP_KERNEL_SAVE(interp0, saver);
+    blend_setup();
+    interp_set_accumulator(interp0, 1, alpha);
+    for (uint i = 0; i < count; i++) {
+        interp_set_base_both(interp0, a[i] | ((uint32_t)b[i] << 16));
+        dst[i] = (uint8_t)interp_peek_lane_result(interp0, 1);
+    }
+    INTERP_KERNEL_RESTORE(interp0, saver);
+}
+
+static inline uint8_t blend_u8(uint8_t a, uint8_t b, uint8_t alpha) {
+    return (uint8_t)(a + ((alpha * (b - a)) >> 8));
+}
+
+void interp_blend_u8_ref(uint8_t *dst, const uint8_t *a, const uint8_t *b, uint count, uint8_t alpha) {
+    for (uint i = 0; i < count; i++) {
+        dst[i] = blend_u8(a[i], b[i], alpha);
+    }
+}
+
+void interp_blend_alpha_u8(uint8_t *dst, const uint8_t *a, const uint8_t *b, const uint8_t *alpha, uint count) {
+    if (!count) return;
+    INTERP_KERNEL_SAVE(interp0, saver);
+    blend_setup();
+    for (uint i = 0; i < count; i++) {
+        interp_set_accumulator(interp0, 1, alpha[i]);
+        interp_set_base_both(interp0, a[i] | ((uint32_t)b[i] << 16));
+        dst[i] = (uint8_t)interp_peek_lane_result(interp0, 1);
+    }
+    INTERP_KERNEL_RESTORE(interp0, saver);
+}
+
+void interp_blend_alpha_u8_ref(uint8_t *dst, const uint8_t *a, const uint8_t *b, const uint8_t *alpha, uint count) {
+    for (uint i = 0; i < count; i++) {
+        dst[i] = blend_u8(a[i], b[i], alpha[i]);
+    }
+}
+
+void interp_accumulate_clamped_s16(int16_t *acc, const int16_t *src, uint count, int16_t gain) {
+    if (!count) return;
+    INTERP_KERNEL_SAVE(interp1, saver);
+    // ACCUM0 is the sum in Q15, which can't overflow: |acc << 15| <= 2^30 and |src * gain| <= 2^30. Lane 0 shifts
+    // it down to a 17 bit signed value, and clamps that to the range of an int16_t
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, 15);
+    interp_config_set_mask(&cfg, 0, 16);
+    interp_config_set_signed(&cfg, true);
+    interp_config_set_clamp(&cfg, true);
+    interp_set_config(interp1, 0, &cfg);
+    interp_set_base(interp1, 0, (uint32_t)INT16_MIN);
+    interp_set_base(interp1, 1, INT16_MAX);
+    for (uint i = 0; i < count; i++) {
+        interp_set_accumulator(interp1, 0, ((uint32_t)(int32_t)acc[i] << 15) + (uint32_t)(src[i] * gain));
+        acc[i] = (int16_t)interp_peek_lane_result(interp1, 0);
+    }
+    INTERP_KERNEL_RESTORE(interp1, saver);
+}
+
+void interp_accumulate_clamped_s16_ref(int16_t *acc, const int16_t *src, uint count, int16_t gain) {
+    for (uint i = 0; i < count; i++) {
+        int32_t sum = acc[i] + ((src[i] * gain) >> 15);
+        acc[i] = (int16_t)MAX(INT16_MIN, MIN(INT16_MAX, sum));
+    }
+}
@@ -20,8 +20,14 @@ static async_at_time_worker_t lwip_timeout_worker = {
         .do_work = lwip_timeout_reached,
 };
 
+// lwIP deadline (in sys_now() milliseconds) that lwip_timeout_worker is currently in the at-time list for
+static uint32_t armed_deadline_ms;
+static bool lwip_timeout_worker_armed;
+
 static void lwip_timeout_reached(__unused async_context_t *context, __unused async_at_time_worker_t *worker) {
     assert(worker == &lwip_timeout_worker);
+    // the worker was removed from the at-time list to run it
+    lwip_timeout_worker_armed = false;
     sys_check_timeouts();
 }
 
@@ -32,12 +38,40 @@ static void update_next_timeout(async_context_t *context, async_when_pending_wor
     // (note that worker will be called on every outermost exit of the async_context
     // lock, and lwIP timers should not be modified whilst not holding the lock.
     worker->work_pending = true;
+    // lwIP keeps its timeouts in absolute sys_now() time, so the deadline only moves when a timeout is added,
+    // removed or run, whereas the sleep time counts down on every call. The deadline is recovered from a clock
+    // read just before sys_timeouts_sleeptime() reads it, so it may be a millisecond early if the clock ticked in
+    // between; that does no harm if the deadline looks unchanged (at worst the worker runs a millisecond early and
+    // is re-armed), but a new deadline is only used once read without a tick in between
+    uint32_t now_ms = sys_now();
     uint32_t sleep_ms = sys_timeouts_sleeptime();
     if (sleep_ms == SYS_TIMEOUTS_SLEEPTIME_INFINITE) {
-        lwip_timeout_worker.next_time = at_the_end_of_time;
-    } else {
-        lwip_timeout_worker.next_time = make_timeout_time_ms(sleep_ms);
+        if (lwip_timeout_worker_armed) {
+            async_context_remove_at_time_worker(context, &lwip_timeout_worker);
+            lwip_timeout_worker_armed = false;
+        }
+        return;
+    }
+    // re-adding the worker has a cost on every lock release, so only do it when the deadline has actually moved
+    uint32_t deadline_ms = now_ms + sleep_ms;
+    if (lwip_timeout_worker_armed && deadline_ms == armed_deadline_ms) return;
+    while (sys_now() != now_ms) {
+        now_ms = sys_now();
+        sleep_ms = sys_timeouts_sleeptime();
+        deadline_ms = now_ms + sleep_ms;
+    }
+    if (lwip_timeout_worker_armed) {
+        if (deadline_ms == armed_deadline_ms) return;
+        // an overdue timeout has a sleep time of zero, so its apparent deadline follows now; the worker
+        // is already due in that case
+        if (!sleep_ms && (int32_t)(armed_deadline_ms - now_ms) <= 0) return;
     }
+    armed_deadline_ms = deadline_ms;
+    lwip_timeout_worker_armed = true;
+    // wake at the start of the deadline millisecond, which is when lwIP considers the timeout due
+    uint64_t ms_since_boot = to_us_since_boot(get_absolute_time()) / 1000;
+    ms_since_boot += (int32_t)(deadline_ms - (uint32_t)ms_since_boot);
+    lwip_timeout_worker.next_time = from_us_since_boot(ms_since_boot * 1000);
     async_context_add_at_time_worker(context, &lwip_timeout_worker);
 }
 
@@ -55,6 +89,7 @@ bool lwip_nosys_init(async_context_t *context) {
 
 void lwip_nosys_deinit(async_context_t *context) {
     async_context_remove_at_time_worker(context, &lwip_timeout_worker);
+    lwip_timeout_worker_armed = false;
     async_context_remove_when_pending_worker(context, &always_pending_update_timeout_worker);
 }
 
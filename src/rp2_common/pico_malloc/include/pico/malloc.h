@@ -12,7 +12,13 @@
 *
 * \brief Multi-core safety for malloc, calloc and free
 *
-* This library does not provide any additional functions
+* This library does not provide any additional functions, unless the pico_malloc_tlsf library is also linked.
+*
+* pico_malloc_tlsf replaces the C library's allocator with a TLSF heap (see \ref pico_tlsf), whose malloc and free take
+* a bounded time however fragmented the heap is, which suits real-time code. The heap starts out as the memory the C
+* library's allocator would have used (from the end of .bss to the stack limit), and more regions, e.g. an unused
+* SRAM bank or PSRAM, may be added with \ref malloc_add_heap_region. memalign and aligned_alloc are provided by the
+* TLSF heap too.
 */
 
 // PICO_CONFIG: PICO_USE_MALLOC_MUTEX, Whether to protect malloc etc with a mutex, type=bool, default=1 with pico_multicore, 0 otherwise, group=pico_malloc
@@ -35,4 +41,36 @@
 #define PICO_DEBUG_MALLOC_LOW_WATER 0
 #endif
 
+#if LIB_PICO_MALLOC_TLSF
+#include "pico/tlsf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief Add a region of memory to the heap used by malloc
+ *  \ingroup pico_malloc
+ *
+ * Only available with pico_malloc_tlsf. The memory must not be used for anything else afterwards.
+ *
+ * \param mem the start of the memory
+ * \param size the size of the memory in bytes
+ * \return true if the region was added, false otherwise (see \ref tlsf_add_region)
+ */
+bool malloc_add_heap_region(void *mem, size_t size);
+
+/*! \brief Get the statistics for the heap used by malloc
+ *  \ingroup pico_malloc
+ *
+ * Only available with pico_malloc_tlsf.
+ *
+ * \param stats filled in with the statistics
+ */
+void malloc_get_heap_stats(tlsf_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 #endif
\ No newline at end of file
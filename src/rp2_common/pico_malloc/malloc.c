@@ -17,12 +17,51 @@ auto_init_mutex(malloc_mutex);
 #include <stdio.h>
 #endif
 
+extern char __StackLimit; /* Set by linker.  */
+
+#if LIB_PICO_MALLOC_TLSF
+#include <errno.h>
+#include <string.h>
+
+extern char end; /* Set by linker.  */
+
+static tlsf_t heap;
+static bool heap_initialized;
+
+// called with the mutex held; the heap starts out as the memory the C library's allocator would have used
+static tlsf_t *get_heap(void) {
+    if (!heap_initialized) {
+        tlsf_init(&heap);
+        tlsf_add_region(&heap, &end, (size_t)(&__StackLimit - &end));
+        heap_initialized = true;
+    }
+    return &heap;
+}
+
+static void *heap_calloc(size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void *rc = tlsf_malloc(get_heap(), count * size);
+    if (rc) memset(rc, 0, count * size);
+    return rc;
+}
+
+#define HEAP_MALLOC(size) tlsf_malloc(get_heap(), size)
+#define HEAP_CALLOC(count, size) heap_calloc(count, size)
+// realloc(mem, 0) returns a minimum size block (as malloc(0) does) rather than NULL, which PICO_MALLOC_PANIC would
+// treat as out of memory
+#define HEAP_REALLOC(mem, size) tlsf_realloc(get_heap(), mem, (size) ? (size) : 1)
+#define HEAP_FREE(mem) tlsf_free(get_heap(), mem)
+#else
 extern void *REAL_FUNC(malloc)(size_t size);
 extern void *REAL_FUNC(calloc)(size_t count, size_t size);
 extern void *REAL_FUNC(realloc)(void *mem, size_t size);
 extern void REAL_FUNC(free)(void *mem);
 
-extern char __StackLimit; /* Set by linker.  */
+#define HEAP_MALLOC(size) REAL_FUNC(malloc)(size)
+#define HEAP_CALLOC(count, size) REAL_FUNC(calloc)(count, size)
+#define HEAP_REALLOC(mem, size) REAL_FUNC(realloc)(mem, size)
+#define HEAP_FREE(mem) REAL_FUNC(free)(mem)
+#endif
 
 #if !PICO_USE_MALLOC_MUTEX
 #define MALLOC_ENTER(outer) ((void)0);
@@ -58,7 +97,12 @@ static uint8_t mutex_exception_level_plus_one[NUM_CORES];
 #endif
 
 static inline void check_alloc(__unused void *mem, __unused uint size) {
-#if PICO_MALLOC_PANIC
+#if PICO_MALLOC_PANIC && LIB_PICO_MALLOC_TLSF
+    // heap regions may have been added anywhere in memory, but the TLSF heap never returns memory it doesn't own
+    if (!mem) {
+        panic("Out of memory");
+    }
+#elif PICO_MALLOC_PANIC
     if (!mem || (((char *)mem) + size) > &__StackLimit) {
         panic("Out of memory");
     }
@@ -67,7 +111,7 @@ static inline void check_alloc(__unused void *mem, __unused uint size) {
 
 void *WRAPPER_FUNC(malloc)(size_t size) {
     MALLOC_ENTER(false)
-    void *rc = REAL_FUNC(malloc)(size);
+    void *rc = HEAP_MALLOC(size);
     MALLOC_EXIT(false)
 #if PICO_DEBUG_MALLOC
     if (!rc) {
@@ -82,7 +126,7 @@ void *WRAPPER_FUNC(malloc)(size_t size) {
 
 void *WRAPPER_FUNC(calloc)(size_t count, size_t size) {
     MALLOC_ENTER(true)
-    void *rc = REAL_FUNC(calloc)(count, size);
+    void *rc = HEAP_CALLOC(count, size);
     MALLOC_EXIT(true)
 #if PICO_DEBUG_MALLOC
     if (!rc) {
@@ -97,7 +141,7 @@ void *WRAPPER_FUNC(calloc)(size_t count, size_t size) {
 
 void *WRAPPER_FUNC(realloc)(void *mem, size_t size) {
     MALLOC_ENTER(true)
-    void *rc = REAL_FUNC(realloc)(mem, size);
+    void *rc = HEAP_REALLOC(mem, size);
     MALLOC_EXIT(true)
 #if PICO_DEBUG_MALLOC
     if (!rc) {
@@ -112,6 +156,73 @@ void *WRAPPER_FUNC(realloc)(void *mem, size_t size) {
 
 void WRAPPER_FUNC(free)(void *mem) {
     MALLOC_ENTER(false)
-    REAL_FUNC(free)(mem);
+    HEAP_FREE(mem);
     MALLOC_EXIT(false)
 }
+
+#if LIB_PICO_MALLOC_TLSF
+void *WRAPPER_FUNC(memalign)(size_t align, size_t size) {
+    MALLOC_ENTER(false)
+    void *rc = tlsf_memalign(get_heap(), align, size);
+    MALLOC_EXIT(false)
+#if PICO_DEBUG_MALLOC
+    if (!rc) {
+        printf("memalign %d failed to allocate memory\n", (uint) size);
+    } else if (((uint8_t *)rc) + size > (uint8_t*)PICO_DEBUG_MALLOC_LOW_WATER) {
+        printf("memalign %d %p->%p\n", (uint) size, rc, ((uint8_t *) rc) + size);
+    }
+#endif
+    check_alloc(rc, size);
+    return rc;
+}
+
+void *WRAPPER_FUNC(aligned_alloc)(size_t align, size_t size) {
+    return WRAPPER_FUNC(memalign)(align, size);
+}
+
+#if !__PICOLIBC__
+// newlib's own functions (e.g. stdio) call the reentrant versions directly, which would otherwise go to newlib's
+// allocator
+struct _reent;
+
+void *WRAPPER_FUNC(_malloc_r)(__unused struct _reent *r, size_t size) {
+    return WRAPPER_FUNC(malloc)(size);
+}
+
+void *WRAPPER_FUNC(_calloc_r)(__unused struct _reent *r, size_t count, size_t size) {
+    return WRAPPER_FUNC(calloc)(count, size);
+}
+
+void *WRAPPER_FUNC(_realloc_r)(__unused struct _reent *r, void *mem, size_t size) {
+    return WRAPPER_FUNC(realloc)(mem, size);
+}
+
+void WRAPPER_FUNC(_free_r)(__unused struct _reent *r, void *mem) {
+    WRAPPER_FUNC(free)(mem);
+}
+
+void *WRAPPER_FUNC(_memalign_r)(__unused struct _reent *r, size_t align, size_t size) {
+    return WRAPPER_FUNC(memalign)(align, size);
+}
+
+// the TLSF heap owns the memory sbrk would hand out, so nothing else may take it (this overrides the weak
+// definition in pico_clib_interface)
+void *_sbrk(__unused int incr) {
+    errno = ENOMEM;
+    return (void *)-1;
+}
+#endif
+
+bool malloc_add_heap_region(void *mem, size_t size) {
+    MALLOC_ENTER(false)
+    bool rc = tlsf_add_region(get_heap(), mem, size);
+    MALLOC_EXIT(false)
+    return rc;
+}
+
+void malloc_get_heap_stats(tlsf_stats_t *stats) {
+    MALLOC_ENTER(false)
+    tlsf_get_stats(get_heap(), stats);
+    MALLOC_EXIT(false)
+}
+#endif
@@ -18,6 +18,7 @@
  * - memset, memcpy
  * - __aeabi_memset, __aeabi_memset4, __aeabi_memset8, __aeabi_memcpy, __aeabi_memcpy4, __aeabi_memcpy8
  *
- * This library does not provide any additional functions
+ * This library does not provide any additional functions; for copies and fills which don't keep the CPU busy, see
+ * \ref pico_dma_memcpy
  */
 #endif
\ No newline at end of file
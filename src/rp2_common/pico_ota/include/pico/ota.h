@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_OTA_H
+#define _PICO_OTA_H
+
+#include "pico.h"
+#include "pico/time.h"
+#include "pico/sha256.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/ota.h
+ *  \defgroup pico_ota pico_ota
+ *
+ * \brief Streaming writer for over-the-air image updates
+ *
+ * An OTA writer accepts an image as a stream of chunks of any size (as they arrive from the network, say), collects
+ * them into a sector sized buffer, and erases and programs the target region a buffer at a time. The image is hashed
+ * with \ref pico_sha256 as it streams past, so its SHA-256 is available as soon as the last chunk has been written,
+ * and can be checked against a digest from elsewhere (e.g. an update manifest) with \ref pico_ota_verify_sha256.
+ *
+ * Once written, \ref pico_ota_verify_picobin reads the image back from flash, finds its IMAGE_DEF block (see
+ * boot/picobin.h) and, if the block carries a HASH_VALUE, checks that the programmed image matches it. The hash
+ * covers the storage ranges of the block's LOAD_MAP (or, without a load map, the image before the block), followed
+ * by the number of block words given by the HASH_DEF item, counted from the block's start marker. A SIGNATURE item
+ * is reported, but not checked; that needs the key fingerprint in OTP, and is done by the boot ROM when the image is
+ * launched.
+ *
+ * The writer talks to the flash through \ref pico_ota_flash_ops_t, so the same code can be run against a file in
+ * host builds; see pico/ota_flash.h for the implementation which programs the device's flash using batched
+ * \ref flash_safe_session_run sessions.
+ *
+ * Note that the SHA-256 hardware (which has a single user at a time) is held from \ref pico_ota_begin until
+ * \ref pico_ota_finish or \ref pico_ota_abort.
+ */
+
+// PICO_CONFIG: PICO_OTA_BUFFER_SIZE, Size of the buffer in which an OTA writer collects image data before programming it; must be a multiple of PICO_OTA_SECTOR_SIZE, type=int, min=4096, default=4096, group=pico_ota
+#ifndef PICO_OTA_BUFFER_SIZE
+#define PICO_OTA_BUFFER_SIZE 4096
+#endif
+
+// PICO_CONFIG: PICO_OTA_SHA256_USE_DMA, Whether an OTA writer feeds the SHA-256 hardware using DMA (which claims a DMA channel from pico_ota_begin until pico_ota_finish), type=bool, default=1, group=pico_ota
+#ifndef PICO_OTA_SHA256_USE_DMA
+#define PICO_OTA_SHA256_USE_DMA 1
+#endif
+
+/*! \brief Size of the flash pages that an OTA writer programs, i.e. FLASH_PAGE_SIZE
+ *  \ingroup pico_ota
+ */
+#define PICO_OTA_PAGE_SIZE 256u
+
+/*! \brief Size of the flash sectors that an OTA writer erases, i.e. FLASH_SECTOR_SIZE
+ *  \ingroup pico_ota
+ */
+#define PICO_OTA_SECTOR_SIZE 4096u
+
+/*! \brief Flash access functions used by an OTA writer
+ *  \ingroup pico_ota
+ *
+ * Offsets are relative to the start of the region the image is being written to.
+ */
+typedef struct pico_ota_flash_ops {
+    /*! erase the sectors containing \p count bytes at \p offset (which is a multiple of \ref PICO_OTA_SECTOR_SIZE),
+     *  then program them with \p data; \p count is a multiple of \ref PICO_OTA_PAGE_SIZE. Returns PICO_OK or an error */
+    int (*write)(void *context, uint32_t offset, const uint8_t *data, size_t count);
+    /*! read \p count bytes at \p offset into \p buffer. Returns PICO_OK or an error */
+    int (*read)(void *context, uint32_t offset, uint8_t *buffer, size_t count);
+} pico_ota_flash_ops_t;
+
+/*! \brief Progress of an OTA write
+ *  \ingroup pico_ota
+ */
+typedef struct pico_ota_progress {
+    uint32_t image_size;       ///< the image size passed to \ref pico_ota_begin, or 0 if it was not known
+    uint32_t bytes_received;   ///< bytes passed to \ref pico_ota_write
+    uint32_t bytes_programmed; ///< bytes programmed to flash
+    uint32_t flash_writes;     ///< calls to the flash \c write function
+    uint32_t elapsed_us;       ///< time since \ref pico_ota_begin (up to \ref pico_ota_finish)
+    uint32_t flash_us;         ///< time spent in the flash \c write function
+    uint32_t bytes_per_second; ///< average rate at which the image has been programmed
+} pico_ota_progress_t;
+
+typedef struct pico_ota_writer pico_ota_writer_t;
+
+/*! \brief Progress callback, called after each buffer of the image is programmed
+ *  \ingroup pico_ota
+ *
+ * \param writer the writer
+ * \param progress the progress so far
+ * \param user_data the user data passed to \ref pico_ota_set_progress_callback
+ */
+typedef void (*pico_ota_progress_callback_t)(pico_ota_writer_t *writer, const pico_ota_progress_t *progress, void *user_data);
+
+/*! \brief Information about the picobin IMAGE_DEF block of a written image
+ *  \ingroup pico_ota
+ */
+typedef struct pico_ota_picobin_info {
+    uint32_t block_offset;  ///< offset of the IMAGE_DEF block in the image
+    uint32_t image_type;    ///< the IMAGE_TYPE flags (PICOBIN_IMAGE_TYPE_...)
+    bool has_load_map;      ///< the block has a LOAD_MAP item
+    bool has_hash;          ///< the block has HASH_DEF and HASH_VALUE items, and the hash was checked
+    bool has_signature;     ///< the block has a SIGNATURE item (which is not checked)
+} pico_ota_picobin_info_t;
+
+/*! \brief OTA writer state
+ *  \ingroup pico_ota
+ *
+ * Treat as opaque; the fields may change between releases.
+ */
+struct pico_ota_writer {
+    const pico_ota_flash_ops_t *ops;
+    void *context;
+    uint32_t capacity;
+    uint32_t fill;
+    int error;
+    bool hashing;
+    bool finished;
+    absolute_time_t start_time;
+    pico_ota_progress_t progress;
+    pico_ota_progress_callback_t callback;
+    void *user_data;
+    pico_sha256_state_t sha256;
+    sha256_result_t digest;
+    uint8_t __aligned(4) buffer[PICO_OTA_BUFFER_SIZE];
+};
+
+/*! \brief Start writing an image
+ *  \ingroup pico_ota
+ *
+ * \param writer the writer
+ * \param ops the flash access functions
+ * \param context the context passed to the flash access functions
+ * \param capacity the size of the region the image is written to
+ * \param image_size the size of the image if known (used to report progress, and to fail early if it will not fit),
+ *        or 0
+ * \return PICO_OK on success, PICO_ERROR_BUFFER_TOO_SMALL if the image is bigger than \p capacity, or an error from
+ *         pico_sha256_try_start() if the SHA-256 hardware is unavailable
+ */
+int pico_ota_begin(pico_ota_writer_t *writer, const pico_ota_flash_ops_t *ops, void *context, uint32_t capacity, uint32_t image_size);
+
+/*! \brief Set a function to be called as the image is programmed
+ *  \ingroup pico_ota
+ *
+ * \param writer the writer
+ * \param callback the function, or NULL for none
+ * \param user_data passed to \p callback
+ */
+void pico_ota_set_progress_callback(pico_ota_writer_t *writer, pico_ota_progress_callback_t callback, void *user_data);
+
+/*! \brief Write the next chunk of the image
+ *  \ingroup pico_ota
+ *
+ * The data is copied, so need not remain valid after the call. Flash is only programmed once a whole buffer has been
+ * collected, so many calls will return without touching the flash.
+ *
+ * Errors are sticky: once a write has failed, all further writes (and \ref pico_ota_finish) return the same error.
+ *
+ * \param writer the writer
+ * \param data the data
+ * \param count the number of bytes, which may be anything (including 0)
+ * \return PICO_OK on success, PICO_ERROR_BUFFER_TOO_SMALL if the image does not fit in the region, or an error from
+ *         the flash \c write function
+ */
+int pico_ota_write(pico_ota_writer_t *writer, const uint8_t *data, size_t count);
+
+/*! \brief Program the rest of the image, and finish its SHA-256
+ *  \ingroup pico_ota
+ *
+ * The final partial page is padded with 0xff. The SHA-256 hardware is released whether or not this succeeds.
+ *
+ * \param writer the writer
+ * \return PICO_OK on success, PICO_ERROR_INVALID_DATA if the image was not the size passed to \ref pico_ota_begin, or
+ *         the error from an earlier or final write
+ */
+int pico_ota_finish(pico_ota_writer_t *writer);
+
+/*! \brief Abandon writing an image, releasing the SHA-256 hardware
+ *  \ingroup pico_ota
+ *
+ * Anything already programmed is left as it is.
+ *
+ * \param writer the writer
+ */
+void pico_ota_abort(pico_ota_writer_t *writer);
+
+/*! \brief Get the SHA-256 of the image written
+ *  \ingroup pico_ota
+ *
+ * \param writer the writer, on which \ref pico_ota_finish has succeeded
+ * \return the SHA-256 of the bytes passed to \ref pico_ota_write (i.e. without padding)
+ */
+static inline const sha256_result_t *pico_ota_get_sha256(const pico_ota_writer_t *writer) {
+    return &writer->digest;
+}
+
+/*! \brief Check the SHA-256 of the image written against an expected value
+ *  \ingroup pico_ota
+ *
+ * \param writer the writer, on which \ref pico_ota_finish has succeeded
+ * \param expected the expected SHA-256
+ * \return PICO_OK if they match, PICO_ERROR_INVALID_DATA if not, or PICO_ERROR_PRECONDITION_NOT_MET if the image has
+ *         not been finished
+ */
+int pico_ota_verify_sha256(const pico_ota_writer_t *writer, const sha256_result_t *expected);
+
+/*! \brief Find the picobin IMAGE_DEF block in the image written, and check the image against its hash
+ *  \ingroup pico_ota
+ *
+ * As the boot ROM does, the first block is looked for in the first 4 kB of the image, and the loop of blocks
+ * linked from it is followed; the last IMAGE_DEF in the loop is used. The image is read back from flash, so a
+ * successful hash check also confirms that it was programmed correctly. The SHA-256 hardware is needed for the
+ * check.
+ *
+ * \param writer the writer, on which \ref pico_ota_finish has succeeded
+ * \param info receives information about the block, or NULL
+ * \return PICO_OK if an IMAGE_DEF was found and any hash it carries matched, PICO_ERROR_NOT_FOUND if there is no
+ *         IMAGE_DEF, PICO_ERROR_INVALID_DATA if the blocks are malformed or the hash did not match, or another error
+ *         from reading the flash or starting the SHA-256
+ */
+int pico_ota_verify_picobin(pico_ota_writer_t *writer, pico_ota_picobin_info_t *info);
+
+/*! \brief Get the progress of the write
+ *  \ingroup pico_ota
+ *
+ * \param writer the writer
+ * \param progress receives the progress
+ */
+void pico_ota_get_progress(const pico_ota_writer_t *writer, pico_ota_progress_t *progress);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_OTA_FLASH_H
+#define _PICO_OTA_FLASH_H
+
+#include "pico/ota.h"
+#include "pico/flash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/ota_flash.h
+ *  \ingroup pico_ota
+ *
+ * \brief Flash access functions for writing an OTA image to the device's own flash
+ *
+ * Each buffer from the OTA writer is erased and programmed by a single \ref flash_safe_session_run session, so the
+ * other core and interrupts are only held off (for at most about \ref PICO_OTA_FLASH_MAX_LOCKOUT_US, if set) while
+ * the flash is busy, rather than once per sector or page. The image is read back through the untranslated,
+ * uncached XIP window.
+ */
+
+// PICO_CONFIG: PICO_OTA_FLASH_MAX_LOCKOUT_US, The longest an OTA flash session should lock out the other core and interrupts for (0 to program each buffer in one lockout), type=int, min=0, default=0, group=pico_ota
+#ifndef PICO_OTA_FLASH_MAX_LOCKOUT_US
+#define PICO_OTA_FLASH_MAX_LOCKOUT_US 0
+#endif
+
+// PICO_CONFIG: PICO_OTA_FLASH_ENTER_EXIT_TIMEOUT_MS, Timeout used by the OTA flash functions when coordinating with the other core to enter or exit the flash safe zone, type=int, default=100, group=pico_ota
+#ifndef PICO_OTA_FLASH_ENTER_EXIT_TIMEOUT_MS
+#define PICO_OTA_FLASH_ENTER_EXIT_TIMEOUT_MS 100
+#endif
+
+/*! \brief Context for the OTA flash functions
+ *  \ingroup pico_ota
+ *
+ * Treat as opaque; the fields may change between releases.
+ */
+typedef struct pico_ota_flash {
+    uint32_t flash_offs;
+    flash_safe_session_t session;
+    flash_safe_op_t ops[2];
+} pico_ota_flash_t;
+
+/*! \brief Flash access functions which write to the device's flash
+ *  \ingroup pico_ota
+ *
+ * The context is a \ref pico_ota_flash_t initialized by \ref pico_ota_flash_init.
+ */
+extern const pico_ota_flash_ops_t pico_ota_flash_ops;
+
+/*! \brief Initialize the context for writing an OTA image to flash
+ *  \ingroup pico_ota
+ *
+ * \param flash the context
+ * \param flash_offs the offset in flash of the region the image is written to, which must be a multiple of
+ *        FLASH_SECTOR_SIZE
+ */
+void pico_ota_flash_init(pico_ota_flash_t *flash, uint32_t flash_offs);
+
+/*! \brief Get the lockout statistics of the flash sessions used to write an OTA image
+ *  \ingroup pico_ota
+ *
+ * \param flash the context
+ * \param stats receives the statistics
+ */
+static inline void pico_ota_flash_get_stats(const pico_ota_flash_t *flash, flash_safe_session_stats_t *stats) {
+    flash_safe_session_get_stats(&flash->session, stats);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "pico/ota.h"
+#include "boot/picobin.h"
+
+static_assert(PICO_OTA_BUFFER_SIZE % PICO_OTA_SECTOR_SIZE == 0, "PICO_OTA_BUFFER_SIZE must be a multiple of PICO_OTA_SECTOR_SIZE");
+
+// The boot ROM only looks for the first block in the first 4 kB of an image
+#define PICOBIN_SEARCH_SIZE 4096u
+// Absolute load map storage addresses are in the (translated) XIP window the image runs from
+#define PICOBIN_STORAGE_BASE 0x10000000u
+// Limit on the number of blocks followed round a loop
+#define PICOBIN_MAX_BLOCKS 16u
+
+// When verifying, the start of the buffer holds the block being looked at and the rest is used to read the image
+#define VERIFY_READ_SIZE (PICO_OTA_BUFFER_SIZE - PICOBIN_MAX_BLOCK_SIZE)
+
+static void pico_ota_release_sha256(pico_ota_writer_t *writer) {
+    if (writer->hashing) {
+        pico_sha256_cleanup(&writer->sha256);
+        writer->hashing = false;
+    }
+}
+
+static int pico_ota_fail(pico_ota_writer_t *writer, int rc) {
+    writer->error = rc;
+    pico_ota_release_sha256(writer);
+    return rc;
+}
+
+int pico_ota_begin(pico_ota_writer_t *writer, const pico_ota_flash_ops_t *ops, void *context, uint32_t capacity, uint32_t image_size) {
+    memset(writer, 0, offsetof(pico_ota_writer_t, buffer));
+    writer->ops = ops;
+    writer->context = context;
+    writer->capacity = capacity & ~(PICO_OTA_SECTOR_SIZE - 1);
+    writer->progress.image_size = image_size;
+    if (image_size > writer->capacity) {
+        writer->error = PICO_ERROR_BUFFER_TOO_SMALL;
+        return writer->error;
+    }
+    int rc = pico_sha256_try_start(&writer->sha256, SHA256_BIG_ENDIAN, PICO_OTA_SHA256_USE_DMA);
+    if (rc) {
+        writer->error = rc;
+        return rc;
+    }
+    writer->hashing = true;
+    writer->start_time = get_absolute_time();
+    return PICO_OK;
+}
+
+void pico_ota_set_progress_callback(pico_ota_writer_t *writer, pico_ota_progress_callback_t callback, void *user_data) {
+    writer->callback = callback;
+    writer->user_data = user_data;
+}
+
+static void pico_ota_update_elapsed(pico_ota_writer_t *writer) {
+    pico_ota_progress_t *progress = &writer->progress;
+    progress->elapsed_us = (uint32_t)absolute_time_diff_us(writer->start_time, get_absolute_time());
+    progress->bytes_per_second = progress->elapsed_us ?
+            (uint32_t)(progress->bytes_programmed * 1000000ull / progress->elapsed_us) : 0;
+}
+
+static int pico_ota_program_buffer(pico_ota_writer_t *writer) {
+    uint32_t count = writer->fill;
+    pico_sha256_update_blocking(&writer->sha256, writer->buffer, count);
+    // the flash is programmed a page at a time, so pad the last page with erased bytes
+    uint32_t padded = (count + PICO_OTA_PAGE_SIZE - 1) & ~(PICO_OTA_PAGE_SIZE - 1);
+    memset(writer->buffer + count, 0xff, padded - count);
+    absolute_time_t start = get_absolute_time();
+    int rc = writer->ops->write(writer->context, writer->progress.bytes_programmed, writer->buffer, padded);
+    writer->progress.flash_us += (uint32_t)absolute_time_diff_us(start, get_absolute_time());
+    if (rc) return rc;
+    writer->progress.flash_writes++;
+    writer->progress.bytes_programmed += count;
+    writer->fill = 0;
+    pico_ota_update_elapsed(writer);
+    if (writer->callback) {
+        writer->callback(writer, &writer->progress, writer->user_data);
+    }
+    return PICO_OK;
+}
+
+int pico_ota_write(pico_ota_writer_t *writer, const uint8_t *data, size_t count) {
+    if (writer->error) return writer->error;
+    if (!writer->hashing) return PICO_ERROR_PRECONDITION_NOT_MET;
+    if (count > writer->capacity - writer->progress.bytes_received) {
+        return pico_ota_fail(writer, PICO_ERROR_BUFFER_TOO_SMALL);
+    }
+    writer->progress.bytes_received += count;
+    while (count) {
+        uint32_t len = MIN(count, PICO_OTA_BUFFER_SIZE - writer->fill);
+        memcpy(writer->buffer + writer->fill, data, len);
+        writer->fill += len;
+        data += len;
+        count -= len;
+        if (writer->fill == PICO_OTA_BUFFER_SIZE) {
+            int rc = pico_ota_program_buffer(writer);
+            if (rc) return pico_ota_fail(writer, rc);
+        }
+    }
+    return PICO_OK;
+}
+
+int pico_ota_finish(pico_ota_writer_t *writer) {
+    if (writer->error) return writer->error;
+    if (!writer->hashing) return PICO_ERROR_PRECONDITION_NOT_MET;
+    if (writer->progress.image_size && writer->progress.image_size != writer->progress.bytes_received) {
+        return pico_ota_fail(writer, PICO_ERROR_INVALID_DATA);
+    }
+    if (writer->fill) {
+        int rc = pico_ota_program_buffer(writer);
+        if (rc) return pico_ota_fail(writer, rc);
+    }
+    pico_sha256_finish(&writer->sha256, &writer->digest);
+    writer->hashing = false;
+    writer->finished = true;
+    pico_ota_update_elapsed(writer);
+    return PICO_OK;
+}
+
+void pico_ota_abort(pico_ota_writer_t *writer) {
+    pico_ota_release_sha256(writer);
+    if (!writer->error) writer->error = PICO_ERROR_INVALID_STATE;
+}
+
+int pico_ota_verify_sha256(const pico_ota_writer_t *writer, const sha256_result_t *expected) {
+    if (!writer->finished) return PICO_ERROR_PRECONDITION_NOT_MET;
+    return memcmp(writer->digest.bytes, expected->bytes, SHA256_RESULT_BYTES) ? PICO_ERROR_INVALID_DATA : PICO_OK;
+}
+
+void pico_ota_get_progress(const pico_ota_writer_t *writer, pico_ota_progress_t *progress) {
+    *progress = writer->progress;
+}
+
+// picobin parsing
+
+static uint picobin_item_type(uint32_t word) {
+    return word & 0xffu;
+}
+
+static uint picobin_item_words(uint32_t word) {
+    // items with bit 7 of the type set have a two byte size
+    return (word & 0x80u) ? (word >> 8) & 0xffffu : (word >> 8) & 0xffu;
+}
+
+static uint32_t image_size(const pico_ota_writer_t *writer) {
+    return writer->progress.bytes_programmed;
+}
+
+// Reads the block at offset into words, returning the index of its LAST item (so the other items are words[1] up to
+// that), or 0 if there is no valid block there. *link receives the block's link to the next block
+static uint picobin_read_block(pico_ota_writer_t *writer, uint32_t offset, uint32_t *words, int32_t *link, int *rc) {
+    uint32_t available = image_size(writer) - offset;
+    uint32_t len = MIN(available, PICOBIN_MAX_BLOCK_SIZE) & ~3u;
+    *rc = writer->ops->read(writer->context, offset, (uint8_t *)words, len);
+    if (*rc) return 0;
+    uint max_words = len / 4;
+    if (max_words < 4 || words[0] != PICOBIN_BLOCK_MARKER_START) return 0;
+    uint i = 1;
+    while (i + 2 < max_words) {
+        uint type = picobin_item_type(words[i]);
+        uint size = picobin_item_words(words[i]);
+        if (type == PICOBIN_BLOCK_ITEM_2BS_LAST) {
+            // the last item's size is the total size of the items before it
+            if (size != i - 1 || words[i + 2] != PICOBIN_BLOCK_MARKER_END) return 0;
+            *link = (int32_t)words[i + 1];
+            return i;
+        }
+        if (!size) return 0;
+        i += size;
+    }
+    return 0;
+}
+
+static const uint32_t *picobin_find_item(const uint32_t *words, uint item_words, uint type) {
+    for (uint i = 1; i < item_words; i += picobin_item_words(words[i])) {
+        if (picobin_item_type(words[i]) == type) return &words[i];
+    }
+    return NULL;
+}
+
+// Hashes size bytes of the image at offset into the running SHA-256
+static int picobin_hash_range(pico_ota_writer_t *writer, uint32_t offset, uint32_t size) {
+    if (offset > image_size(writer) || size > image_size(writer) - offset) return PICO_ERROR_INVALID_DATA;
+    uint8_t *scratch = writer->buffer + PICOBIN_MAX_BLOCK_SIZE;
+    while (size) {
+        uint32_t len = MIN(size, VERIFY_READ_SIZE);
+        int rc = writer->ops->read(writer->context, offset, scratch, len);
+        if (rc) return rc;
+        pico_sha256_update_blocking(&writer->sha256, scratch, len);
+        offset += len;
+        size -= len;
+    }
+    return PICO_OK;
+}
+
+static int picobin_check_hash(pico_ota_writer_t *writer, uint32_t block_offset, const uint32_t *words, uint item_words,
+                              pico_ota_picobin_info_t *info) {
+    const uint32_t *hash_def = picobin_find_item(words, item_words, PICOBIN_BLOCK_ITEM_1BS_HASH_DEF);
+    const uint32_t *hash_value = picobin_find_item(words, item_words, PICOBIN_BLOCK_ITEM_HASH_VALUE);
+    if (!hash_def && !hash_value) return PICO_OK;
+    if (!hash_def || !hash_value || picobin_item_words(hash_def[0]) < 2) return PICO_ERROR_INVALID_DATA;
+    uint hash_type = hash_def[0] >> 24;
+    uint block_words_hashed = hash_def[1] & 0xffffu;
+    uint value_words = picobin_item_words(hash_value[0]) - 1;
+    if (hash_type != PICOBIN_HASH_SHA256 || block_words_hashed > item_words + 3 ||
+        !value_words || value_words > SHA256_RESULT_BYTES / 4) {
+        return PICO_ERROR_INVALID_DATA;
+    }
+
+    int rc = pico_sha256_try_start(&writer->sha256, SHA256_BIG_ENDIAN, PICO_OTA_SHA256_USE_DMA);
+    if (rc) return rc;
+    writer->hashing = true;
+    const uint32_t *load_map = picobin_find_item(words, item_words, PICOBIN_BLOCK_ITEM_LOAD_MAP);
+    if (load_map) {
+        const picobin_load_map *lm = (const picobin_load_map *)load_map;
+        uint count = picobin_load_map_entry_count(lm);
+        if (1 + count * 3 > picobin_item_words(load_map[0])) rc = PICO_ERROR_INVALID_DATA;
+        for (uint i = 0; i < count && !rc; i++) {
+            const picobin_load_map_entry *entry = &lm->entries[i];
+            uint32_t offset;
+            if (picobin_load_map_is_relative(lm)) {
+                offset = block_offset + entry->storage_address_rel;
+            } else if (entry->storage_address_rel >= PICOBIN_STORAGE_BASE) {
+                offset = entry->storage_address_rel - PICOBIN_STORAGE_BASE;
+            } else {
+                // not loaded from flash (e.g. a region to be cleared), so there is nothing in the image to hash
+                continue;
+            }
+            rc = picobin_hash_range(writer, offset, entry->size);
+        }
+    } else {
+        rc = picobin_hash_range(writer, 0, block_offset);
+    }
+    // picobin_hash_range reads through the buffer after the block, so the block words are still intact
+    if (!rc) pico_sha256_update_blocking(&writer->sha256, (const uint8_t *)words, block_words_hashed * 4);
+    sha256_result_t result;
+    if (!rc) {
+        pico_sha256_finish(&writer->sha256, &result);
+        writer->hashing = false;
+        if (memcmp(result.bytes, &hash_value[1], value_words * 4)) rc = PICO_ERROR_INVALID_DATA;
+    }
+    pico_ota_release_sha256(writer);
+    if (!rc) info->has_hash = true;
+    return rc;
+}
+
+int pico_ota_verify_picobin(pico_ota_writer_t *writer, pico_ota_picobin_info_t *info) {
+    if (!writer->finished) return PICO_ERROR_PRECONDITION_NOT_MET;
+    pico_ota_picobin_info_t local_info;
+    if (!info) info = &local_info;
+    memset(info, 0, sizeof(*info));
+    uint32_t *words = (uint32_t *)writer->buffer;
+    int rc = PICO_OK;
+    int32_t link = 0;
+
+    // find the first block
+    uint32_t first = 0;
+    uint item_words = 0;
+    uint32_t search_end = MIN(image_size(writer), PICOBIN_SEARCH_SIZE);
+    for (uint32_t offset = 0; offset + 4 <= search_end && !item_words; offset += 4) {
+        uint32_t word;
+        rc = writer->ops->read(writer->context, offset, (uint8_t *)&word, 4);
+        if (rc) return rc;
+        if (word == PICOBIN_BLOCK_MARKER_START) {
+            item_words = picobin_read_block(writer, offset, words, &link, &rc);
+            if (rc) return rc;
+            first = offset;
+        }
+    }
+    if (!item_words) return PICO_ERROR_NOT_FOUND;
+
+    // follow the loop, remembering the last IMAGE_DEF
+    bool found = false;
+    uint32_t offset = first;
+    for (uint n = 0; ; n++) {
+        if (picobin_find_item(words, item_words, PICOBIN_BLOCK_ITEM_1BS_IMAGE_TYPE)) {
+            found = true;
+            info->block_offset = offset;
+        }
+        offset += (uint32_t)link;
+        if (offset == first) break;
+        if (n == PICOBIN_MAX_BLOCKS || offset >= image_size(writer) || (offset & 3)) return PICO_ERROR_INVALID_DATA;
+        item_words = picobin_read_block(writer, offset, words, &link, &rc);
+        if (rc) return rc;
+        if (!item_words) return PICO_ERROR_INVALID_DATA;
+    }
+    if (!found) return PICO_ERROR_NOT_FOUND;
+
+    item_words = picobin_read_block(writer, info->block_offset, words, &link, &rc);
+    if (rc) return rc;
+    const uint32_t *image_type = picobin_find_item(words, item_words, PICOBIN_BLOCK_ITEM_1BS_IMAGE_TYPE);
+    info->image_type = image_type[0] >> 16;
+    info->has_load_map = picobin_find_item(words, item_words, PICOBIN_BLOCK_ITEM_LOAD_MAP) != NULL;
+    info->has_signature = picobin_find_item(words, item_words, PICOBIN_BLOCK_ITEM_SIGNATURE) != NULL;
+    return picobin_check_hash(writer, info->block_offset, words, item_words, info);
+}
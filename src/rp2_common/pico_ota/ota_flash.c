@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/ota_flash.h"
+#include "hardware/flash.h"
+
+static_assert(PICO_OTA_PAGE_SIZE == FLASH_PAGE_SIZE && PICO_OTA_SECTOR_SIZE == FLASH_SECTOR_SIZE, "");
+
+void pico_ota_flash_init(pico_ota_flash_t *flash, uint32_t flash_offs) {
+    hard_assert(!(flash_offs & (FLASH_SECTOR_SIZE - 1)));
+    flash->flash_offs = flash_offs;
+    flash_safe_session_init(&flash->session, flash->ops, count_of(flash->ops));
+}
+
+static int pico_ota_flash_write(void *context, uint32_t offset, const uint8_t *data, size_t count) {
+    pico_ota_flash_t *flash = (pico_ota_flash_t *)context;
+    uint32_t erase_count = (count + FLASH_SECTOR_SIZE - 1) & ~(FLASH_SECTOR_SIZE - 1);
+    flash_safe_session_add_erase(&flash->session, flash->flash_offs + offset, erase_count);
+    flash_safe_session_add_program(&flash->session, flash->flash_offs + offset, data, count);
+    return flash_safe_session_run(&flash->session, PICO_OTA_FLASH_MAX_LOCKOUT_US, PICO_OTA_FLASH_ENTER_EXIT_TIMEOUT_MS);
+}
+
+static int pico_ota_flash_read(void *context, uint32_t offset, uint8_t *buffer, size_t count) {
+    pico_ota_flash_t *flash = (pico_ota_flash_t *)context;
+    // bypass both the cache (which may hold the old contents) and any address translation of the running image
+    memcpy(buffer, (const void *)(XIP_NOCACHE_NOALLOC_NOTRANSLATE_BASE + flash->flash_offs + offset), count);
+    return PICO_OK;
+}
+
+const pico_ota_flash_ops_t pico_ota_flash_ops = {
+    .write = pico_ota_flash_write,
+    .read = pico_ota_flash_read,
+};
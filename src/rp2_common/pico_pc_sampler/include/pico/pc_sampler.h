@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_PC_SAMPLER_H
+#define _PICO_PC_SAMPLER_H
+
+#include "pico.h"
+
+/** \file pico/pc_sampler.h
+ *  \defgroup pico_pc_sampler pico_pc_sampler
+ *
+ * \brief Statistical profiling by sampling the program counter from a timer interrupt
+ *
+ * Once started, a hardware alarm interrupts the calling core every few microseconds, and its handler records the
+ * address of the code it interrupted (including other interrupt handlers, as it runs at the highest priority). The
+ * samples are kept in a RAM buffer of \ref PICO_PC_SAMPLER_BUFFER_SIZE entries, from which they can be read with
+ * \ref pc_sampler_read, or streamed out with \ref pc_sampler_print, which should be called often enough to keep up.
+ *
+ * `tools/pc_sample_placement.py` combines the printed samples with the binary's ELF file to rank functions by the time
+ * spent running them from flash, and generates a linker script fragment which moves the most costly ones that fit
+ * a given size into RAM. Pass the fragment to `pico_set_ram_functions()` to build the binary with them in RAM, so
+ * that they no longer suffer XIP cache misses.
+ *
+ * The interval between samples is varied a little at random, so that the samples don't keep landing on the same
+ * point of code which runs at a regular period. The handler runs from RAM, so doesn't disturb the XIP cache itself.
+ */
+
+// PICO_CONFIG: PARAM_ASSERTIONS_ENABLED_PICO_PC_SAMPLER, Enable/disable assertions in the pico_pc_sampler module, type=bool, default=0, group=pico_pc_sampler
+#ifndef PARAM_ASSERTIONS_ENABLED_PICO_PC_SAMPLER
+#define PARAM_ASSERTIONS_ENABLED_PICO_PC_SAMPLER 0
+#endif
+
+// PICO_CONFIG: PICO_PC_SAMPLER_BUFFER_SIZE, Number of samples the PC sampler buffers until they are read; must be a power of 2, type=int, min=16, default=1024, group=pico_pc_sampler
+#ifndef PICO_PC_SAMPLER_BUFFER_SIZE
+#define PICO_PC_SAMPLER_BUFFER_SIZE 1024
+#endif
+
+// PICO_CONFIG: PICO_PC_SAMPLER_IRQ_PRIORITY, Priority of the PC sampler's timer interrupt, type=int, min=0, max=255, default=PICO_HIGHEST_IRQ_PRIORITY, group=pico_pc_sampler
+#ifndef PICO_PC_SAMPLER_IRQ_PRIORITY
+#define PICO_PC_SAMPLER_IRQ_PRIORITY PICO_HIGHEST_IRQ_PRIORITY
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief Start sampling the program counter of the calling core
+ *  \ingroup pico_pc_sampler
+ *
+ * An unused hardware alarm of the default timer is claimed, and its interrupt handler installed on the calling core.
+ *
+ * \param interval_us the average interval between samples in microseconds; at least 10
+ * \return true if sampling started, false if it is already running or no hardware alarm is free
+ */
+bool pc_sampler_start(uint32_t interval_us);
+
+/*! \brief Stop sampling, and release the hardware alarm
+ *  \ingroup pico_pc_sampler
+ *
+ * This must be called on the core which started sampling. Samples not yet read are kept.
+ */
+void pc_sampler_stop(void);
+
+/*! \brief Read samples from the buffer
+ *  \ingroup pico_pc_sampler
+ *
+ * \param samples filled in with the sampled addresses, oldest first
+ * \param max_samples the size of samples
+ * \return the number of samples read
+ */
+uint pc_sampler_read(uint32_t *samples, uint max_samples);
+
+/*! \brief The number of samples which were lost because the buffer was full
+ *  \ingroup pico_pc_sampler
+ */
+uint pc_sampler_get_dropped_count(void);
+
+/*! \brief Print the samples in the buffer, emptying it
+ *  \ingroup pico_pc_sampler
+ *
+ * The samples are printed as lines starting "pc_sample:", followed by up to 8 hex addresses; a line
+ * "pc_sample: dropped <n>" is also printed if samples have been lost since the last call. The output may be captured
+ * along with any other output, as `tools/pc_sample_placement.py` only looks at these lines.
+ */
+void pc_sampler_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include "pico/pc_sampler.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#if defined(__riscv)
+#include "hardware/riscv.h"
+#endif
+
+static_assert(!(PICO_PC_SAMPLER_BUFFER_SIZE & (PICO_PC_SAMPLER_BUFFER_SIZE - 1)),
+              "PICO_PC_SAMPLER_BUFFER_SIZE must be a power of 2");
+
+static struct {
+    // the handler writes samples at head, and pc_sampler_read() reads them from tail
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+    uint32_t dropped_printed;
+    uint32_t interval_us;
+    uint32_t rand_state;
+    int alarm_num;
+} pc_sampler = { .alarm_num = -1 };
+
+static uint32_t pc_sampler_buffer[PICO_PC_SAMPLER_BUFFER_SIZE];
+
+// The next interval is chosen at random between 7/8 and 9/8 of the average
+static inline uint32_t next_interval(void) {
+    // xorshift32
+    uint32_t x = pc_sampler.rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pc_sampler.rand_state = x;
+    uint32_t spread = pc_sampler.interval_us / 4;
+    return pc_sampler.interval_us - spread / 2 + (spread ? x % spread : 0);
+}
+
+static void __used __not_in_flash_func(pc_sampler_record)(uint32_t pc) {
+    timer_hw_t *timer = PICO_DEFAULT_TIMER_INSTANCE();
+    uint alarm_num = (uint)pc_sampler.alarm_num;
+    timer->intr = 1u << alarm_num;
+    timer->alarm[alarm_num] = timer->timerawl + next_interval();
+    uint32_t head = pc_sampler.head;
+    if (head - pc_sampler.tail < PICO_PC_SAMPLER_BUFFER_SIZE) {
+        pc_sampler_buffer[head & (PICO_PC_SAMPLER_BUFFER_SIZE - 1)] = pc;
+        __mem_fence_release();
+        pc_sampler.head = head + 1;
+    } else {
+        pc_sampler.dropped++;
+    }
+}
+
+#if defined(__riscv)
+static void __not_in_flash_func(pc_sampler_irq_handler)(void) {
+    // mepc is the address of the interrupted code; any higher priority interrupt taken since then has restored it
+    pc_sampler_record(riscv_read_csr(mepc));
+}
+#else
+// The interrupted code's address is in the exception frame it stacked, on the process or main stack according to
+// EXC_RETURN in lr; this handler is entered directly from the vector table, so lr and the stack are as they were
+static void __attribute__((naked)) __not_in_flash_func(pc_sampler_irq_handler)(void) {
+    pico_default_asm_volatile(
+        "movs r0, #4\n"
+        "mov r1, lr\n"
+        "tst r0, r1\n"
+        "beq 1f\n"
+        "mrs r0, psp\n"
+        "b 2f\n"
+        "1:\n"
+        "mrs r0, msp\n"
+        "2:\n"
+        "ldr r0, [r0, #24]\n"
+        // tail call, so pc_sampler_record returns from the exception
+        "ldr r1, =pc_sampler_record\n"
+        "bx r1\n"
+    );
+}
+#endif
+
+bool pc_sampler_start(uint32_t interval_us) {
+    invalid_params_if(PICO_PC_SAMPLER, interval_us < 10);
+    if (pc_sampler.alarm_num >= 0) return false;
+    timer_hw_t *timer = PICO_DEFAULT_TIMER_INSTANCE();
+    int alarm_num = timer_hardware_alarm_claim_unused(timer, false);
+    if (alarm_num < 0) return false;
+    pc_sampler.interval_us = interval_us;
+    pc_sampler.rand_state = timer->timerawl | 1;
+    pc_sampler.alarm_num = alarm_num;
+    uint irq_num = timer_hardware_alarm_get_irq_num(timer, (uint)alarm_num);
+    irq_set_exclusive_handler(irq_num, pc_sampler_irq_handler);
+    irq_set_priority(irq_num, PICO_PC_SAMPLER_IRQ_PRIORITY);
+    hw_set_bits(&timer->inte, 1u << alarm_num);
+    irq_set_enabled(irq_num, true);
+    timer->alarm[alarm_num] = timer->timerawl + interval_us;
+    return true;
+}
+
+void pc_sampler_stop(void) {
+    if (pc_sampler.alarm_num < 0) return;
+    timer_hw_t *timer = PICO_DEFAULT_TIMER_INSTANCE();
+    uint alarm_num = (uint)pc_sampler.alarm_num;
+    uint irq_num = timer_hardware_alarm_get_irq_num(timer, alarm_num);
+    irq_set_enabled(irq_num, false);
+    hw_clear_bits(&timer->inte, 1u << alarm_num);
+    timer->armed = 1u << alarm_num;
+    timer->intr = 1u << alarm_num;
+    irq_remove_handler(irq_num, pc_sampler_irq_handler);
+    timer_hardware_alarm_unclaim(timer, alarm_num);
+    pc_sampler.alarm_num = -1;
+}
+
+uint pc_sampler_read(uint32_t *samples, uint max_samples) {
+    uint32_t tail = pc_sampler.tail;
+    uint32_t available = pc_sampler.head - tail;
+    __mem_fence_acquire();
+    uint count = MIN(available, max_samples);
+    for (uint i = 0; i < count; i++) {
+        samples[i] = pc_sampler_buffer[(tail + i) & (PICO_PC_SAMPLER_BUFFER_SIZE - 1)];
+    }
+    __mem_fence_release();
+    pc_sampler.tail = tail + count;
+    return count;
+}
+
+uint pc_sampler_get_dropped_count(void) {
+    return pc_sampler.dropped;
+}
+
+void pc_sampler_print(void) {
+    uint32_t samples[8];
+    uint count;
+    while ((count = pc_sampler_read(samples, count_of(samples)))) {
+        printf("pc_sample:");
+        for (uint i = 0; i < count; i++) {
+            printf(" %08x", (uint)samples[i]);
+        }
+        printf("\n");
+    }
+    uint32_t dropped = pc_sampler.dropped;
+    if (dropped != pc_sampler.dropped_printed) {
+        printf("pc_sample: dropped %u\n", (uint)(dropped - pc_sampler.dropped_printed));
+        pc_sampler.dropped_printed = dropped;
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICO_PIO_STREAM_H
+#define _PICO_PIO_STREAM_H
+
+#include "pico.h"
+#include "hardware/pio.h"
+#include "pico/dma_sg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \file pico/pio_stream.h
+ *  \defgroup pico_pio_stream pico_pio_stream
+ *
+ * \brief Continuous double-buffered DMA streaming to or from a PIO state machine FIFO
+ *
+ * A pio_stream binds the TX or RX FIFO of a state machine to a pair of buffers. The buffers are transferred
+ * alternately, forever, by a looping \ref pico_dma_sg chain, so the state machine is never starved of DMA
+ * requests while software works on the other buffer.
+ *
+ * Each time the DMA finishes with a buffer the callback is invoked (from the DMA IRQ handler) with that buffer:
+ * for a TX stream the callback must refill it (the producer), and for an RX stream the callback must consume it
+ * (the consumer), before the DMA comes back round to it. If the DMA has already restarted a buffer that has not
+ * yet been handed to the callback, an underrun (TX) or overrun (RX) is counted; the stale buffer is streamed
+ * again (TX) or overwritten (RX).
+ *
+ * The state machine should be configured and its program loaded by the caller; it is not enabled or disabled here.
+ */
+
+// PICO_CONFIG: PARAM_ASSERTIONS_ENABLED_PICO_PIO_STREAM, Enable/disable assertions in the pico_pio_stream module, type=bool, default=0, group=pico_pio_stream
+#ifndef PARAM_ASSERTIONS_ENABLED_PICO_PIO_STREAM
+#define PARAM_ASSERTIONS_ENABLED_PICO_PIO_STREAM 0
+#endif
+
+/*! \brief Direction of a PIO stream
+ *  \ingroup pico_pio_stream
+ */
+typedef enum pio_stream_direction {
+    PIO_STREAM_TX, ///< Memory to the state machine's TX FIFO
+    PIO_STREAM_RX, ///< The state machine's RX FIFO to memory
+} pio_stream_direction_t;
+
+typedef struct pio_stream pio_stream_t;
+
+/*! \brief Producer/consumer callback, called from the DMA IRQ handler
+ *  \ingroup pico_pio_stream
+ *
+ * \param stream the stream
+ * \param buffer the buffer the DMA has just finished with
+ * \param transfer_count the number of transfers (of the configured size) the buffer holds
+ */
+typedef void (*pio_stream_callback_t)(pio_stream_t *stream, void *buffer, uint transfer_count);
+
+/*! \brief Configuration of a PIO stream
+ *  \ingroup pico_pio_stream
+ */
+typedef struct pio_stream_config {
+    pio_stream_direction_t direction;
+    enum dma_channel_transfer_size transfer_size; ///< size of each FIFO access
+    void *buffers[2];                             ///< the two buffers
+    uint transfer_count;                          ///< number of transfers per buffer
+    bool join_fifo;                               ///< join the FIFOs for the stream's direction, giving 8 entries of buffering
+    bool bswap;                                   ///< byte swap each transfer
+    uint irq_index;                               ///< DMA IRQ index to use for the callback
+    pio_stream_callback_t callback;
+    void *user_data;
+} pio_stream_config_t;
+
+/*! \brief Statistics for a PIO stream
+ *  \ingroup pico_pio_stream
+ */
+typedef struct pio_stream_stats {
+    uint32_t buffers;   ///< buffers handed to the callback
+    uint32_t underruns; ///< TX buffers re-streamed before the producer saw them
+    uint32_t overruns;  ///< RX buffers overwritten before the consumer saw them
+} pio_stream_stats_t;
+
+/*! \brief PIO stream state
+ *  \ingroup pico_pio_stream
+ *
+ * Treat as opaque; the fields may change between releases.
+ */
+struct pio_stream {
+    PIO pio;
+    uint8_t sm;
+    uint8_t expected;
+    bool running;
+    pio_stream_config_t config;
+    dma_sg_t sg;
+    dma_sg_list_t list;
+    dma_sg_desc_t descs[3];
+    volatile uint32_t buffers;
+    volatile uint32_t xruns;
+};
+
+/*! \brief Get a default stream configuration
+ *  \ingroup pico_pio_stream
+ *
+ * The default is a 32 bit TX stream on DMA IRQ 0 with unjoined FIFOs; the buffers, count and callback must be set by the caller.
+ *
+ * \return the default configuration
+ */
+pio_stream_config_t pio_stream_get_default_config(void);
+
+/*! \brief Initialize a stream, claiming two DMA channels
+ *  \ingroup pico_pio_stream
+ *
+ * If \p config->join_fifo is set the state machine's FIFOs are joined in the stream's direction, which clears them.
+ *
+ * \param stream the stream to initialize
+ * \param pio the PIO instance
+ * \param sm the state machine
+ * \param config the configuration; it is copied
+ * \return true on success, false if two DMA channels were not available
+ */
+bool pio_stream_init(pio_stream_t *stream, PIO pio, uint sm, const pio_stream_config_t *config);
+
+/*! \brief Stop a stream and release its DMA channels
+ *  \ingroup pico_pio_stream
+ *
+ * \param stream the stream
+ */
+void pio_stream_deinit(pio_stream_t *stream);
+
+/*! \brief Start streaming
+ *  \ingroup pico_pio_stream
+ *
+ * For a TX stream the callback is first called for both buffers (from the calling context) so that they are primed.
+ *
+ * \param stream the stream
+ */
+void pio_stream_start(pio_stream_t *stream);
+
+/*! \brief Stop streaming
+ *  \ingroup pico_pio_stream
+ *
+ * Data already in the FIFO is not discarded.
+ *
+ * \param stream the stream
+ */
+void pio_stream_stop(pio_stream_t *stream);
+
+/*! \brief Return the user data from the stream's configuration
+ *  \ingroup pico_pio_stream
+ *
+ * \param stream the stream
+ * \return the user data
+ */
+static inline void *pio_stream_get_user_data(const pio_stream_t *stream) {
+    return stream->config.user_data;
+}
+
+/*! \brief Get the stream's statistics
+ *  \ingroup pico_pio_stream
+ *
+ * \param stream the stream
+ * \param stats receives the statistics
+ */
+void pio_stream_get_stats(const pio_stream_t *stream, pio_stream_stats_t *stats);
+
+/*! \brief Reset the stream's statistics to zero
+ *  \ingroup pico_pio_stream
+ *
+ * \param stream the stream
+ */
+void pio_stream_reset_stats(pio_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "pico/pio_stream.h"
+
+pio_stream_config_t pio_stream_get_default_config(void) {
+    pio_stream_config_t config = {
+        .direction = PIO_STREAM_TX,
+        .transfer_size = DMA_SIZE_32,
+        .irq_index = 0,
+    };
+    return config;
+}
+
+static void pio_stream_dma_callback(dma_sg_t *sg, __unused bool finished) {
+    pio_stream_t *stream = (pio_stream_t *)sg->user_data;
+    // Work out which buffer the DMA is on now; the jump descriptor means it is about to restart buffer 0.
+    // Entry latency to this handler is longer than the control channel takes to load the next descriptor.
+    int pos = dma_sg_get_position(sg);
+    uint in_flight = pos == 1 ? 1 : 0;
+    uint done = in_flight ^ 1;
+    if (done != stream->expected) {
+        // both buffers completed before we got here, and the DMA has restarted the one we have not yet seen
+        stream->xruns++;
+    }
+    stream->expected = (uint8_t)in_flight;
+    stream->buffers++;
+    stream->config.callback(stream, stream->config.buffers[done], stream->config.transfer_count);
+}
+
+bool pio_stream_init(pio_stream_t *stream, PIO pio, uint sm, const pio_stream_config_t *config) {
+    invalid_params_if(PICO_PIO_STREAM, !config->buffers[0] || !config->buffers[1] || !config->transfer_count);
+    invalid_params_if(PICO_PIO_STREAM, !config->callback);
+    int ctrl_chan = dma_claim_unused_channel(false);
+    if (ctrl_chan < 0) return false;
+    int data_chan = dma_claim_unused_channel(false);
+    if (data_chan < 0) {
+        dma_channel_unclaim((uint)ctrl_chan);
+        return false;
+    }
+    stream->pio = pio;
+    stream->sm = (uint8_t)sm;
+    stream->config = *config;
+    stream->running = false;
+    pio_stream_reset_stats(stream);
+
+    bool is_tx = config->direction == PIO_STREAM_TX;
+    if (config->join_fifo) {
+        // changing the join clears the FIFOs
+        hw_write_masked(&pio->sm[sm].shiftctrl,
+                        is_tx ? PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS : PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS,
+                        PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS | PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS);
+    }
+
+    dma_sg_init(&stream->sg, (uint)ctrl_chan, (uint)data_chan);
+    dma_channel_config c = dma_channel_get_default_config((uint)data_chan);
+    channel_config_set_transfer_data_size(&c, config->transfer_size);
+    channel_config_set_read_increment(&c, is_tx);
+    channel_config_set_write_increment(&c, !is_tx);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, is_tx));
+    channel_config_set_bswap(&c, config->bswap);
+    uint32_t ctrl = channel_config_get_ctrl_value(&c);
+
+    dma_sg_list_init_for(&stream->list, stream->descs, count_of(stream->descs), &stream->sg);
+    for (uint i = 0; i < 2; i++) {
+        if (is_tx) {
+            dma_sg_list_add(&stream->list, &pio->txf[sm], config->buffers[i], config->transfer_count, ctrl, true);
+        } else {
+            dma_sg_list_add(&stream->list, config->buffers[i], &pio->rxf[sm], config->transfer_count, ctrl, true);
+        }
+    }
+    dma_sg_list_loop(&stream->list, 0);
+    return true;
+}
+
+void pio_stream_deinit(pio_stream_t *stream) {
+    pio_stream_stop(stream);
+    uint ctrl_chan = stream->sg.ctrl_chan;
+    uint data_chan = stream->sg.data_chan;
+    dma_sg_deinit(&stream->sg);
+    dma_channel_unclaim(ctrl_chan);
+    dma_channel_unclaim(data_chan);
+}
+
+void pio_stream_start(pio_stream_t *stream) {
+    if (stream->running) return;
+    if (stream->config.direction == PIO_STREAM_TX) {
+        for (uint i = 0; i < 2; i++) {
+            stream->config.callback(stream, stream->config.buffers[i], stream->config.transfer_count);
+        }
+    }
+    stream->expected = 0;
+    dma_sg_set_irq_callback(&stream->sg, stream->config.irq_index, pio_stream_dma_callback, stream);
+    stream->running = true;
+    dma_sg_start(&stream->sg, &stream->list);
+}
+
+void pio_stream_stop(pio_stream_t *stream) {
+    if (!stream->running) return;
+    dma_sg_set_irq_callback(&stream->sg, stream->config.irq_index, NULL, NULL);
+    dma_sg_abort(&stream->sg);
+    stream->running = false;
+}
+
+void pio_stream_get_stats(const pio_stream_t *stream, pio_stream_stats_t *stats) {
+    stats->buffers = stream->buffers;
+    stats->underruns = stream->config.direction == PIO_STREAM_TX ? stream->xruns : 0;
+    stats->overruns = stream->config.direction == PIO_STREAM_RX ? stream->xruns : 0;
+}
+
+void pio_stream_reset_stats(pio_stream_t *stream) {
+    stream->buffers = 0;
+    stream->xruns = 0;
+}
@@ -50,8 +50,27 @@ void runtime_init(void);
 void runtime_run_initializers(void);
 void runtime_run_per_core_initializers(void);
 
+#if LIB_PICO_BOOT_PROFILE && !PICO_NO_BINARY_INFO
+#include "pico/binary_info/code.h"
+// pico_boot_profile names each initializer in the binary info; the value of the entry is the initializer's slot in the
+// __preinit_array, so that the entry can be matched up with the slot being run
+#define __bi_runtime_initializer(func, priority_string) \
+    static const struct _binary_info_ptr_int32_with_name __bi_lineno_var_name = { \
+        .core = { \
+            .type = __bi_enclosure_check(BINARY_INFO_TYPE_PTR_INT32_WITH_NAME), \
+            .tag = BINARY_INFO_TAG_RASPBERRY_PI, \
+        },\
+        .id = BINARY_INFO_ID_RP_RUNTIME_INITIALIZER, \
+        .value = (const int *)&__pre_init_ ## func, \
+        .label = priority_string " " #func, \
+    }
+#define __pico_runtime_init_func_name(func, priority_string) extern uintptr_t __pre_init_ ## func; bi_decl(__bi_runtime_initializer(func, priority_string))
+#else
+#define __pico_runtime_init_func_name(func, priority_string)
+#endif
+
 #ifndef PICO_RUNTIME_INIT_FUNC
-#define PICO_RUNTIME_INIT_FUNC(func, priority_string) uintptr_t __used __attribute__((section(".preinit_array." priority_string))) __pre_init_ ## func = (uintptr_t)(void (*)(void)) (func)
+#define PICO_RUNTIME_INIT_FUNC(func, priority_string) __pico_runtime_init_func_name(func, priority_string) uintptr_t __used __attribute__((section(".preinit_array." priority_string))) __pre_init_ ## func = (uintptr_t)(void (*)(void)) (func)
 #endif
 #else
 #ifndef PICO_RUNTIME_INIT_FUNC
@@ -6,6 +6,9 @@
 
 #include "pico/runtime.h"
 #include "pico/runtime_init.h"
+#if LIB_PICO_BOOT_PROFILE
+#include "pico/boot_profile.h"
+#endif
 
 
 /*! \brief  Handle a hard_assert condition failure
@@ -33,12 +36,21 @@ static void runtime_run_initializers_from(uintptr_t *from) {
     for (uintptr_t *p = from; p < &__preinit_array_end; p++) {
         uintptr_t val = *p;
         ((void (*)(void))val)();
+#if LIB_PICO_BOOT_PROFILE
+        boot_profile_initializer_done(p);
+#endif
     }
 }
 
 void runtime_run_initializers(void) {
     extern uintptr_t __preinit_array_start;
+#if LIB_PICO_BOOT_PROFILE
+    boot_profile_initializers_starting();
+#endif
     runtime_run_initializers_from(&__preinit_array_start);
+#if LIB_PICO_BOOT_PROFILE
+    boot_profile_initializers_done();
+#endif
 }
 
 // We keep the per-core initializers in the standard __preinit_array so a standard C library
@@ -8,17 +8,21 @@ def _generated_pico_flash_region_impl(ctx):
         "FLASH(rx) : ORIGIN = 0x10000000, LENGTH = " + str(ctx.attr.flash_region_size),
     ))
     ctx.actions.write(flash_region_linker_fragment, file_contents)
+
+    # The default linker scripts also INCLUDE this list of functions to move to RAM, which is empty under Bazel.
+    ram_functions_linker_fragment = ctx.actions.declare_file(ctx.label.name + "/ldinclude/pico_ram_functions.ld")
+    ctx.actions.write(ram_functions_linker_fragment, "/* no functions are moved to RAM */\n")
     linking_inputs = cc_common.create_linker_input(
         owner = ctx.label,
         user_link_flags = depset(
             direct = ["-L" + str(link_include_dir)],
         ),
         additional_inputs = depset(
-            direct = [flash_region_linker_fragment],
+            direct = [flash_region_linker_fragment, ram_functions_linker_fragment],
         ),
     )
     return [
-        DefaultInfo(files = depset([flash_region_linker_fragment])),
+        DefaultInfo(files = depset([flash_region_linker_fragment, ram_functions_linker_fragment])),
         CcInfo(linking_context = cc_common.create_linking_context(linker_inputs = depset(direct = [linking_inputs]))),
     ]
 
@@ -0,0 +1,297 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "pico/stdlib.h"
+#include "pico/async_context_dual_core.h"
+#include "pico/test.h"
+#include "threadsafe_background_fake.h"
+
+PICOTEST_MODULE_NAME("ASYNC_CONTEXT_DUAL_CORE", "async_context_dual_core affinity and locking test");
+
+static async_context_dual_core_t context;
+
+static async_context_threadsafe_background_t *half(uint core_num) {
+    return &context.halves[core_num];
+}
+
+static bool holds(uint core_num) {
+    return threadsafe_background_fake_caller_holds(half(core_num));
+}
+
+typedef struct {
+    async_when_pending_worker_t worker;
+    uint run_count;
+    uint ran_on_core;
+    async_context_t *ran_with_context;
+} counting_worker_t;
+
+static void counting_work(async_context_t *ctx, async_when_pending_worker_t *worker) {
+    counting_worker_t *w = (counting_worker_t *)worker;
+    w->run_count++;
+    w->ran_on_core = get_core_num();
+    w->ran_with_context = ctx;
+}
+
+static counting_worker_t home_worker = { .worker = { .do_work = counting_work } };
+static counting_worker_t other_worker = { .worker = { .do_work = counting_work, .core_affinity = ASYNC_CONTEXT_CORE_AFFINITY(1) } };
+
+static void run_both_halves(void) {
+    for (uint i = 0; i < NUM_CORES; i++) {
+        if (context.half_ready[i]) threadsafe_background_fake_run(half(i));
+    }
+}
+
+static uint32_t sync_core;
+static bool sync_held_both;
+
+static uint32_t sync_func(void *param) {
+    sync_core = get_core_num();
+    sync_held_both = holds(0) && holds(1);
+    return (uint32_t)(uintptr_t)param;
+}
+
+// What a worker on the other core (e.g. one calling cyw43_arch_lwip_begin) does with the dual-core context
+static bool other_core_ok;
+
+static void other_core_locking_work(async_context_t *ctx, __unused async_when_pending_worker_t *worker) {
+    bool ok = ctx == &half(1)->core && holds(1) && !holds(0);
+    async_context_lock_check(&context.core);
+    async_context_acquire_lock_blocking(&context.core);
+    ok &= holds(0) && holds(1);
+    async_context_lock_check(&context.core);
+    async_context_acquire_lock_blocking(&context.core);
+    async_context_release_lock(&context.core);
+    ok &= holds(0) && holds(1);
+    async_context_release_lock(&context.core);
+    // back to holding just its own half
+    ok &= holds(1) && !holds(0) && half(1)->lock_mutex.enter_count == 1;
+    sync_core = ~0u;
+    ok &= async_context_execute_sync(&context.core, sync_func, (void *)123) == 123;
+    ok &= sync_core == 0 && sync_held_both;
+    ok &= holds(1) && !holds(0) && get_core_num() == 1;
+    other_core_ok = ok;
+}
+
+static async_when_pending_worker_t other_core_locking_worker = {
+        .do_work = other_core_locking_work,
+        .core_affinity = ASYNC_CONTEXT_CORE_AFFINITY(1),
+};
+
+// A worker on the other core calls execute_sync, and the call (running on the home core) removes that worker while it
+// is still running; the other core's half must stay held for the pass throughout, and the pass must carry on with the
+// next worker
+static volatile bool remove_ok;
+static volatile bool remover_done;
+static uint remover_pass;
+
+static uint32_t remove_running_worker(void *param) {
+    async_when_pending_worker_t *worker = (async_when_pending_worker_t *)param;
+    bool ok = get_core_num() == 0 && holds(0) && holds(1);
+    // taken by the pass on the other core, and again by the dual-core lock
+    ok &= half(1)->lock_mutex.enter_count == 2;
+    ok &= async_context_remove_when_pending_worker(&context.core, worker);
+    remove_ok = ok;
+    return 1;
+}
+
+static void removed_while_running_work(__unused async_context_t *ctx, async_when_pending_worker_t *worker) {
+    remover_pass = fake_pass_count[1];
+    remove_ok = false;
+    uint32_t rc = async_context_execute_sync(&context.core, remove_running_worker, worker);
+    remove_ok &= rc == 1 && holds(1) && !holds(0) && half(1)->lock_mutex.enter_count == 1;
+    remover_done = true;
+}
+
+static async_when_pending_worker_t removed_while_running_worker = {
+        .do_work = removed_while_running_work,
+        .core_affinity = ASYNC_CONTEXT_CORE_AFFINITY(1),
+};
+
+static uint after_remover_pass;
+
+static void after_remover_work(__unused async_context_t *ctx, __unused async_when_pending_worker_t *worker) {
+    after_remover_pass = fake_pass_count[1];
+}
+
+static async_when_pending_worker_t after_remover_worker = {
+        .do_work = after_remover_work,
+        .core_affinity = ASYNC_CONTEXT_CORE_AFFINITY(1),
+};
+
+// A worker on the other core takes the dual-core lock while the home core holds its half, waiting for the other
+// core's half
+static volatile bool borrower_started;
+static volatile bool borrower_done;
+static volatile bool borrower_ok;
+
+static void borrower_work(__unused async_context_t *ctx, async_when_pending_worker_t *worker) {
+    borrower_started = true;
+    while (!half(0)->lock_mutex.enter_count) {
+        sched_yield();
+    }
+    async_context_acquire_lock_blocking(&context.core);
+    bool ok = holds(0) && holds(1);
+    async_context_lock_check(&context.core);
+    ok &= async_context_remove_when_pending_worker(&context.core, worker);
+    async_context_release_lock(&context.core);
+    ok &= holds(1) && !holds(0);
+    borrower_ok = ok;
+    borrower_done = true;
+}
+
+static async_when_pending_worker_t borrower_worker = {
+        .do_work = borrower_work,
+        .core_affinity = ASYNC_CONTEXT_CORE_AFFINITY(1),
+};
+
+static uint at_time_core;
+
+static void at_time_work(__unused async_context_t *ctx, __unused async_at_time_worker_t *worker) {
+    at_time_core = get_core_num();
+}
+
+static async_at_time_worker_t at_time_worker = { .do_work = at_time_work };
+
+int main() {
+    PICOTEST_START();
+
+    fake_core_num = 0;
+    async_context_threadsafe_background_config_t config = async_context_threadsafe_background_default_config();
+    PICOTEST_CHECK(async_context_dual_core_init(&context, &config), "init failed");
+    PICOTEST_CHECK(!async_context_dual_core_is_ready(&context), "ready before the other core was initialized");
+
+    PICOTEST_START_SECTION("affinity before the other core is initialized");
+        PICOTEST_CHECK(async_context_add_when_pending_worker(&context.core, &home_worker.worker), "add failed");
+        PICOTEST_CHECK(!async_context_add_when_pending_worker(&context.core, &other_worker.worker), "add to an uninitialized half succeeded");
+        // must not touch the uninitialized half
+        async_context_set_work_pending(&context.core, &other_worker.worker);
+        PICOTEST_CHECK(other_worker.worker.work_pending, "work was not remembered");
+        PICOTEST_CHECK(!async_context_dual_core_add_at_time_worker_on_core(&context, &at_time_worker, 1), "add to an uninitialized half succeeded");
+        PICOTEST_CHECK(!async_context_dual_core_set_worker_core(&context, &home_worker.worker, ASYNC_CONTEXT_CORE_AFFINITY(1)), "moved to an uninitialized half");
+        PICOTEST_CHECK(home_worker.worker.core_affinity == ASYNC_CONTEXT_CORE_AFFINITY(0), "affinity not restored");
+        async_context_set_work_pending(&context.core, &home_worker.worker);
+        run_both_halves();
+        PICOTEST_CHECK(home_worker.run_count == 1 && home_worker.ran_on_core == 0, "home worker did not run on the home core");
+        PICOTEST_CHECK(home_worker.ran_with_context == &half(0)->core, "home worker was passed the wrong context");
+    PICOTEST_END_SECTION();
+
+    fake_core_num = 1;
+    PICOTEST_CHECK(async_context_dual_core_init_other_core(&context), "init of the other core failed");
+    fake_core_num = 0;
+    PICOTEST_CHECK(async_context_dual_core_is_ready(&context), "not ready");
+
+    PICOTEST_START_SECTION("affinity routing");
+        PICOTEST_CHECK(async_context_add_when_pending_worker(&context.core, &other_worker.worker), "add failed");
+        PICOTEST_CHECK(half(1)->core.when_pending_list == &other_worker.worker, "worker not on the other core's half");
+        // the work set pending before it was added
+        run_both_halves();
+        PICOTEST_CHECK(other_worker.run_count == 1 && other_worker.ran_on_core == 1, "other worker did not run on the other core");
+        PICOTEST_CHECK(other_worker.ran_with_context == &half(1)->core, "other worker was passed the wrong context");
+        async_context_set_work_pending(&context.core, &other_worker.worker);
+        threadsafe_background_fake_run(half(0));
+        PICOTEST_CHECK(other_worker.run_count == 1, "other worker ran on the home core");
+        threadsafe_background_fake_run(half(1));
+        PICOTEST_CHECK(other_worker.run_count == 2, "other worker did not run");
+
+        // moving a pending worker keeps its work
+        async_context_set_work_pending(&context.core, &home_worker.worker);
+        PICOTEST_CHECK(async_context_dual_core_set_worker_core(&context, &home_worker.worker, ASYNC_CONTEXT_CORE_AFFINITY(1)), "move failed");
+        PICOTEST_CHECK(!half(0)->core.when_pending_list, "worker left on the home core's half");
+        threadsafe_background_fake_run(half(0));
+        PICOTEST_CHECK(home_worker.run_count == 1, "moved worker ran on its old core");
+        threadsafe_background_fake_run(half(1));
+        PICOTEST_CHECK(home_worker.run_count == 2 && home_worker.ran_on_core == 1, "moved worker did not run on its new core");
+        PICOTEST_CHECK(async_context_dual_core_set_worker_core(&context, &home_worker.worker, ASYNC_CONTEXT_CORE_AFFINITY_DEFAULT), "move back failed");
+        PICOTEST_CHECK(half(0)->core.when_pending_list == &home_worker.worker, "worker not back on the home core's half");
+
+        PICOTEST_CHECK(async_context_dual_core_add_at_time_worker_on_core(&context, &at_time_worker, 1), "add failed");
+        PICOTEST_CHECK(half(1)->core.at_time_list == &at_time_worker, "at time worker not on the other core's half");
+        PICOTEST_CHECK(async_context_remove_at_time_worker(&context.core, &at_time_worker), "remove failed");
+        PICOTEST_CHECK(async_context_add_at_time_worker_in_ms(&context.core, &at_time_worker, 0), "add failed");
+        PICOTEST_CHECK(half(0)->core.at_time_list == &at_time_worker, "at time worker not on the home core's half");
+        at_time_core = ~0u;
+        run_both_halves();
+        PICOTEST_CHECK(at_time_core == 0, "at time worker did not run on the home core");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("lock from the home core");
+        async_context_acquire_lock_blocking(&context.core);
+        PICOTEST_CHECK(holds(0) && holds(1), "lock does not hold both halves");
+        async_context_lock_check(&context.core);
+        async_context_acquire_lock_blocking(&context.core);
+        PICOTEST_CHECK(half(1)->lock_mutex.enter_count == 1, "other core's half taken more than once");
+        async_context_release_lock(&context.core);
+        PICOTEST_CHECK(holds(0) && holds(1), "nested release let go of a half");
+        async_context_release_lock(&context.core);
+        PICOTEST_CHECK(!holds(0) && !holds(1), "lock not released");
+        sync_core = ~0u;
+        PICOTEST_CHECK(async_context_execute_sync(&context.core, sync_func, (void *)7) == 7, "execute_sync returned the wrong value");
+        PICOTEST_CHECK(sync_core == 0 && sync_held_both, "execute_sync did not run on the home core under the lock");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("lock from a worker on the other core");
+        PICOTEST_CHECK(async_context_add_when_pending_worker(&context.core, &other_core_locking_worker), "add failed");
+        async_context_set_work_pending(&context.core, &other_core_locking_worker);
+        threadsafe_background_fake_run(half(1));
+        PICOTEST_CHECK(other_core_ok, "worker on the other core could not use the dual-core lock");
+        PICOTEST_CHECK(!holds(0) && !holds(1), "lock not released");
+        PICOTEST_CHECK(async_context_remove_when_pending_worker(&context.core, &other_core_locking_worker), "remove failed");
+    PICOTEST_END_SECTION();
+
+    // fail rather than hang if the cores wait for each other
+    alarm(10);
+
+    PICOTEST_START_SECTION("home core removes a running worker on the other core");
+        PICOTEST_CHECK(async_context_add_when_pending_worker(&context.core, &removed_while_running_worker), "add failed");
+        PICOTEST_CHECK(async_context_add_when_pending_worker(&context.core, &after_remover_worker), "add failed");
+        async_context_set_work_pending(&context.core, &removed_while_running_worker);
+        async_context_set_work_pending(&context.core, &after_remover_worker);
+        threadsafe_background_fake_start_core(1);
+        while (!after_remover_pass) {
+            threadsafe_background_fake_run(half(0));
+        }
+        threadsafe_background_fake_stop_core();
+        PICOTEST_CHECK(remover_done && remove_ok, "the other core's half was let go of while its pass was running");
+        PICOTEST_CHECK(after_remover_pass == remover_pass, "the pass did not carry on after the removed worker");
+        PICOTEST_CHECK(!async_context_remove_when_pending_worker(&context.core, &removed_while_running_worker), "worker not removed");
+        PICOTEST_CHECK(async_context_remove_when_pending_worker(&context.core, &after_remover_worker), "remove failed");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("lock from the other core while the home core waits for it");
+        PICOTEST_CHECK(async_context_add_when_pending_worker(&context.core, &borrower_worker), "add failed");
+        async_context_set_work_pending(&context.core, &borrower_worker);
+        threadsafe_background_fake_start_core(1);
+        while (!borrower_started) {
+            sched_yield();
+        }
+        async_context_acquire_lock_blocking(&context.core);
+        // we could only get the other core's half once its pass was over
+        bool after_pass = borrower_done;
+        PICOTEST_CHECK(holds(0) && holds(1), "lock does not hold both halves");
+        async_context_release_lock(&context.core);
+        threadsafe_background_fake_stop_core();
+        PICOTEST_CHECK(after_pass, "the other core's half was let go of while its pass was running");
+        PICOTEST_CHECK(borrower_ok, "worker on the other core could not use the dual-core lock");
+        PICOTEST_CHECK(!async_context_remove_when_pending_worker(&context.core, &borrower_worker), "worker not removed");
+    PICOTEST_END_SECTION();
+
+    alarm(0);
+
+    PICOTEST_CHECK(async_context_remove_when_pending_worker(&context.core, &other_worker.worker), "remove failed");
+    fake_core_num = 1;
+    async_context_dual_core_deinit_other_core(&context);
+    fake_core_num = 0;
+    PICOTEST_CHECK(!context.half_ready[1], "other core's half still ready");
+    PICOTEST_CHECK(!async_context_add_when_pending_worker(&context.core, &other_worker.worker), "add to a deinitialized half succeeded");
+    async_context_deinit(&context.core);
+
+    PICOTEST_END_TEST();
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "pico/async_context_base.h"
+#include "threadsafe_background_fake.h"
+
+__thread uint fake_core_num;
+volatile uint fake_pass_count[NUM_CORES];
+
+static async_context_threadsafe_background_t *halves[NUM_CORES];
+static const async_context_type_t template;
+
+static volatile bool threaded;
+static volatile bool stop_core;
+static pthread_t core_thread;
+static pthread_mutex_t spin_locks_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+uint get_core_num(void) {
+    return fake_core_num;
+}
+
+// With a second thread running, the spin locks guarding the recursive mutexes must really exclude each other; one
+// mutex for all of them is enough, as no spin lock is held while taking another
+uint32_t spin_lock_blocking(__unused spin_lock_t *lock) {
+    pthread_mutex_lock(&spin_locks_mutex);
+    return 0;
+}
+
+void spin_unlock(__unused spin_lock_t *lock, __unused uint32_t saved_irq) {
+    pthread_mutex_unlock(&spin_locks_mutex);
+}
+
+void __wfe(void) {
+    sched_yield();
+}
+
+void __sev(void) {
+}
+
+void tight_loop_contents(void) {
+    sched_yield();
+}
+
+bool async_context_threadsafe_background_init(async_context_threadsafe_background_t *self, __unused async_context_threadsafe_background_config_t *config) {
+    memset(self, 0, sizeof(*self));
+    self->core.type = &template;
+    self->core.flags = ASYNC_CONTEXT_FLAG_CALLBACK_FROM_IRQ | ASYNC_CONTEXT_FLAG_CALLBACK_FROM_NON_IRQ;
+    self->core.core_num = get_core_num();
+    recursive_mutex_init(&self->lock_mutex);
+    halves[self->core.core_num] = self;
+    return true;
+}
+
+async_context_threadsafe_background_config_t async_context_threadsafe_background_default_config(void) {
+    async_context_threadsafe_background_config_t config = { 0 };
+    return config;
+}
+
+static void fake_acquire_lock_blocking(async_context_t *self_base) {
+    async_context_threadsafe_background_t *self = (async_context_threadsafe_background_t *)self_base;
+    uint32_t owner;
+    while (!recursive_mutex_try_enter(&self->lock_mutex, &owner)) {
+        if (!threaded) {
+            panic("core %u would wait for the lock of core %u's half, held by core %u", get_core_num(), self_base->core_num, owner);
+        }
+        sched_yield();
+    }
+}
+
+static void fake_release_lock(async_context_t *self_base) {
+    async_context_threadsafe_background_t *self = (async_context_threadsafe_background_t *)self_base;
+    recursive_mutex_exit(&self->lock_mutex);
+}
+
+static void fake_lock_check(async_context_t *self_base) {
+    if (!threadsafe_background_fake_caller_holds((async_context_threadsafe_background_t *)self_base)) {
+        panic("async_context lock_check failed");
+    }
+}
+
+typedef struct {
+    async_when_pending_worker_t worker;
+    uint32_t (*func)(void *param);
+    void *param;
+    uint32_t rc;
+    volatile bool done;
+} fake_sync_call_t;
+
+static void fake_sync_work(async_context_t *context, async_when_pending_worker_t *worker) {
+    fake_sync_call_t *call = (fake_sync_call_t *)worker;
+    async_context_base_remove_when_pending_worker(context, worker);
+    call->rc = call->func(call->param);
+    call->done = true;
+}
+
+static bool fake_add_when_pending_worker(async_context_t *self_base, async_when_pending_worker_t *worker);
+
+static uint32_t fake_execute_sync(async_context_t *self_base, uint32_t (*func)(void *param), void *param) {
+    if (threaded && self_base->core_num != get_core_num()) {
+        // the call is made in a pass on the half's own core, while we wait
+        fake_sync_call_t call = {
+                .worker = { .do_work = fake_sync_work },
+                .func = func,
+                .param = param,
+        };
+        fake_add_when_pending_worker(self_base, &call.worker);
+        call.worker.work_pending = true;
+        while (!call.done) {
+            sched_yield();
+        }
+        return call.rc;
+    }
+    // the call is made on the half's own core, as a worker would be
+    uint caller_core = fake_core_num;
+    fake_core_num = self_base->core_num;
+    fake_acquire_lock_blocking(self_base);
+    uint32_t rc = func(param);
+    fake_release_lock(self_base);
+    fake_core_num = caller_core;
+    return rc;
+}
+
+static bool fake_add_at_time_worker(async_context_t *self_base, async_at_time_worker_t *worker) {
+    fake_acquire_lock_blocking(self_base);
+    bool rc = async_context_base_add_at_time_worker(self_base, worker);
+    fake_release_lock(self_base);
+    return rc;
+}
+
+static bool fake_remove_at_time_worker(async_context_t *self_base, async_at_time_worker_t *worker) {
+    fake_acquire_lock_blocking(self_base);
+    bool rc = async_context_base_remove_at_time_worker(self_base, worker);
+    fake_release_lock(self_base);
+    return rc;
+}
+
+static bool fake_add_when_pending_worker(async_context_t *self_base, async_when_pending_worker_t *worker) {
+    fake_acquire_lock_blocking(self_base);
+    bool rc = async_context_base_add_when_pending_worker(self_base, worker);
+    fake_release_lock(self_base);
+    return rc;
+}
+
+static bool fake_remove_when_pending_worker(async_context_t *self_base, async_when_pending_worker_t *worker) {
+    fake_acquire_lock_blocking(self_base);
+    bool rc = async_context_base_remove_when_pending_worker(self_base, worker);
+    fake_release_lock(self_base);
+    return rc;
+}
+
+static void fake_set_work_pending(__unused async_context_t *self_base, async_when_pending_worker_t *worker) {
+    worker->work_pending = true;
+}
+
+static void fake_deinit(async_context_t *self_base) {
+    halves[self_base->core_num] = NULL;
+    memset(self_base, 0, sizeof(async_context_threadsafe_background_t));
+}
+
+void threadsafe_background_fake_run(async_context_threadsafe_background_t *half) {
+    uint caller_core = fake_core_num;
+    fake_core_num = half->core.core_num;
+    fake_acquire_lock_blocking(&half->core);
+    fake_pass_count[half->core.core_num]++;
+    async_context_base_execute_once(&half->core);
+    fake_release_lock(&half->core);
+    fake_core_num = caller_core;
+}
+
+static void *core_thread_main(void *param) {
+    fake_core_num = (uint)(uintptr_t)param;
+    while (!stop_core) {
+        threadsafe_background_fake_run(halves[fake_core_num]);
+        sched_yield();
+    }
+    return NULL;
+}
+
+void threadsafe_background_fake_start_core(uint core_num) {
+    assert(!threaded && halves[core_num]);
+    threaded = true;
+    stop_core = false;
+    pthread_create(&core_thread, NULL, core_thread_main, (void *)(uintptr_t)core_num);
+}
+
+void threadsafe_background_fake_stop_core(void) {
+    assert(threaded);
+    stop_core = true;
+    pthread_join(core_thread, NULL);
+    threaded = false;
+}
+
+static const async_context_type_t template = {
+        .type = ASYNC_CONTEXT_THREADSAFE_BACKGROUND,
+        .acquire_lock_blocking = fake_acquire_lock_blocking,
+        .release_lock = fake_release_lock,
+        .lock_check = fake_lock_check,
+        .execute_sync = fake_execute_sync,
+        .add_at_time_worker = fake_add_at_time_worker,
+        .remove_at_time_worker = fake_remove_at_time_worker,
+        .add_when_pending_worker = fake_add_when_pending_worker,
+        .remove_when_pending_worker = fake_remove_when_pending_worker,
+        .set_work_pending = fake_set_work_pending,
+        .poll = 0,
+        .deinit = fake_deinit,
+};
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _THREADSAFE_BACKGROUND_FAKE_H
+#define _THREADSAFE_BACKGROUND_FAKE_H
+
+#include "pico/async_context_threadsafe_background.h"
+
+// A model of async_context_threadsafe_background for async_context_dual_core to be built on. Each half is just its
+// lock and its worker lists; "the calling core" is fake_core_num (get_core_num() is overridden), and workers only run
+// when a half is run by threadsafe_background_fake_run(), or by a thread standing in for its core.
+//
+// Until threadsafe_background_fake_start_core() is called, everything happens on one thread, so a lock which is held
+// by the other core cannot be waited for: trying to take one panics, as it would deadlock on a device. Once a core's
+// thread is running, the spin locks are real, the halves' locks may be waited for, and a call to execute_sync from
+// the other core is queued for that thread (or for the test, when it runs the half of the calling core) to run.
+
+extern __thread uint fake_core_num;
+
+// the number of passes each half has made over its workers
+extern volatile uint fake_pass_count[NUM_CORES];
+
+// run the half's pending work, as its low priority IRQ would, on its own core
+void threadsafe_background_fake_run(async_context_threadsafe_background_t *half);
+
+// start a thread which repeatedly runs the half of the core, as that core
+void threadsafe_background_fake_start_core(uint core_num);
+
+void threadsafe_background_fake_stop_core(void);
+
+static inline bool threadsafe_background_fake_caller_holds(async_context_threadsafe_background_t *half) {
+    return half->lock_mutex.enter_count && half->lock_mutex.owner == lock_get_caller_owner_id();
+}
+
+#endif
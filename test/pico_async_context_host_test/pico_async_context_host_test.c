@@ -0,0 +1,251 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "pico/stdlib.h"
+#include "pico/async_context_host.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("ASYNC_CONTEXT_HOST", "async_context host backend test");
+
+#define LATENCY_ITERATIONS 2000
+#define THROUGHPUT_ITERATIONS 200000
+
+static async_context_host_t context;
+static pthread_t context_thread;
+
+static volatile uint32_t pending_count;
+static volatile uint64_t pending_time;
+static volatile bool pending_on_context_thread;
+
+static void pending_work(__unused async_context_t *ctx, __unused async_when_pending_worker_t *worker) {
+    pending_time = time_us_64();
+    pending_on_context_thread = pthread_equal(pthread_self(), context_thread);
+    pending_count++;
+}
+
+static async_when_pending_worker_t pending_worker = { .do_work = pending_work };
+
+static volatile uint32_t at_time_count;
+static volatile uint64_t at_time_time;
+
+static void at_time_work(__unused async_context_t *ctx, __unused async_at_time_worker_t *worker) {
+    at_time_time = time_us_64();
+    at_time_count++;
+}
+
+static async_at_time_worker_t at_time_worker = { .do_work = at_time_work };
+
+static uint32_t get_thread(void *param) {
+    *(pthread_t *)param = pthread_self();
+    return 123;
+}
+
+static volatile uint32_t self_rescheduling_remaining;
+
+static void self_rescheduling_work(async_context_t *ctx, async_when_pending_worker_t *worker) {
+    if (--self_rescheduling_remaining) {
+        async_context_set_work_pending(ctx, worker);
+    }
+}
+
+static async_when_pending_worker_t self_rescheduling_worker = { .do_work = self_rescheduling_work };
+
+#define MAX_RUN_ORDER 16
+static char run_order[MAX_RUN_ORDER + 1];
+static volatile uint32_t run_order_count;
+static uint32_t heavy_repeats;
+
+static void record_run(async_when_pending_worker_t *worker) {
+    if (run_order_count < MAX_RUN_ORDER) {
+        run_order[run_order_count] = *(const char *)worker->user_data;
+    }
+    run_order_count++;
+}
+
+static void light_work(__unused async_context_t *ctx, async_when_pending_worker_t *worker) {
+    record_run(worker);
+}
+
+// takes longer than the whole budget, and (while heavy_repeats is non zero) always has more work to do
+static void heavy_work(async_context_t *ctx, async_when_pending_worker_t *worker) {
+    record_run(worker);
+    busy_wait_us(3000);
+    if (heavy_repeats) {
+        heavy_repeats--;
+        async_context_set_work_pending(ctx, worker);
+    }
+}
+
+static async_worker_stats_t heavy_stats, light_stats;
+static async_when_pending_worker_t heavy_worker = { .do_work = heavy_work, .user_data = "H", .stats = &heavy_stats };
+static async_when_pending_worker_t light_worker = { .do_work = light_work, .user_data = "L", .stats = &light_stats };
+static async_when_pending_worker_t urgent_worker = { .do_work = light_work, .user_data = "U", .priority = 1 };
+
+static void *set_pending_later(void *param) {
+    sleep_ms(20);
+    async_context_set_work_pending(&context.core, (async_when_pending_worker_t *)param);
+    return NULL;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void wait_for_count(volatile uint32_t *count, uint32_t value) {
+    while (*count != value) {
+        tight_loop_contents();
+    }
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    PICOTEST_CHECK_AND_ABORT(async_context_host_init_with_defaults(&context), "init failed");
+    PICOTEST_CHECK_AND_ABORT(async_context_execute_sync(&context.core, get_thread, &context_thread) == 123, "execute_sync failed");
+
+    PICOTEST_START_SECTION("when pending");
+        PICOTEST_CHECK(!pthread_equal(context_thread, pthread_self()), "execute_sync ran on the calling thread");
+        PICOTEST_CHECK(async_context_add_when_pending_worker(&context.core, &pending_worker), "add failed");
+        PICOTEST_CHECK(!async_context_add_when_pending_worker(&context.core, &pending_worker), "duplicate add succeeded");
+        async_context_set_work_pending(&context.core, &pending_worker);
+        wait_for_count(&pending_count, 1);
+        PICOTEST_CHECK(pending_on_context_thread, "worker ran on the wrong thread");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("at time");
+        uint64_t start = time_us_64();
+        PICOTEST_CHECK(async_context_add_at_time_worker_in_ms(&context.core, &at_time_worker, 30), "add failed");
+        // an earlier worker added afterwards must move the deadline forward
+        static async_at_time_worker_t early_worker = { .do_work = at_time_work };
+        PICOTEST_CHECK(async_context_add_at_time_worker_in_ms(&context.core, &early_worker, 10), "add failed");
+        wait_for_count(&at_time_count, 1);
+        uint64_t early_elapsed = at_time_time - start;
+        wait_for_count(&at_time_count, 2);
+        uint64_t late_elapsed = at_time_time - start;
+        printf("at time workers fired after %"PRIu64"us and %"PRIu64"us\n", early_elapsed, late_elapsed);
+        PICOTEST_CHECK(early_elapsed >= 10000 && early_elapsed < 25000, "early worker fired at the wrong time");
+        PICOTEST_CHECK(late_elapsed >= 30000, "late worker fired early");
+
+        // a removed worker must not fire
+        PICOTEST_CHECK(async_context_add_at_time_worker_in_ms(&context.core, &at_time_worker, 10), "add failed");
+        PICOTEST_CHECK(async_context_remove_at_time_worker(&context.core, &at_time_worker), "remove failed");
+        sleep_ms(30);
+        PICOTEST_CHECK(at_time_count == 2, "removed worker fired");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("wait for work");
+        // consume the wake-up left by the earlier sections; after that nothing is pending, so the wait should
+        // block for the whole timeout
+        async_context_wait_for_work_ms(&context.core, 1);
+        uint64_t start = time_us_64();
+        async_context_wait_for_work_ms(&context.core, 20);
+        uint64_t elapsed = time_us_64() - start;
+        PICOTEST_CHECK(elapsed >= 20000, "wait returned early");
+
+        pthread_t thread;
+        start = time_us_64();
+        pthread_create(&thread, NULL, set_pending_later, &pending_worker);
+        async_context_wait_for_work_ms(&context.core, 1000);
+        elapsed = time_us_64() - start;
+        pthread_join(thread, NULL);
+        printf("woken by work after %"PRIu64"us\n", elapsed);
+        PICOTEST_CHECK(elapsed >= 20000 && elapsed < 500000, "wait not woken by work");
+        wait_for_count(&pending_count, 2);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("priorities and budget");
+        async_context_set_execution_budget_us(&context.core, 1000);
+        async_context_add_when_pending_worker(&context.core, &heavy_worker);
+        async_context_add_when_pending_worker(&context.core, &light_worker);
+        async_context_add_when_pending_worker(&context.core, &urgent_worker);
+        // the urgent worker runs first despite being added last; the heavy worker uses up the budget, so the light
+        // worker is deferred to the next pass
+        async_context_acquire_lock_blocking(&context.core);
+        async_context_set_work_pending(&context.core, &heavy_worker);
+        async_context_set_work_pending(&context.core, &light_worker);
+        async_context_set_work_pending(&context.core, &urgent_worker);
+        async_context_release_lock(&context.core);
+        wait_for_count(&run_order_count, 3);
+        printf("run order: %.3s\n", run_order);
+        PICOTEST_CHECK(!memcmp(run_order, "UHL", 3), "wrong run order");
+        PICOTEST_CHECK(light_stats.run_count == 1 && light_stats.deferred_count == 1, "light worker not deferred");
+        PICOTEST_CHECK(heavy_stats.run_count == 1 && heavy_stats.max_run_time_us >= 3000, "heavy worker stats wrong");
+        PICOTEST_CHECK(light_stats.max_latency_us >= 3000, "light worker latency wrong");
+
+        // a worker which always has more to do must not starve its peers of equal priority
+        run_order_count = 0;
+        async_context_acquire_lock_blocking(&context.core);
+        heavy_repeats = 3;
+        async_context_set_work_pending(&context.core, &heavy_worker);
+        async_context_release_lock(&context.core);
+        sleep_us(500);
+        async_context_set_work_pending(&context.core, &light_worker);
+        wait_for_count(&run_order_count, 5);
+        printf("run order: %.5s\n", run_order);
+        PICOTEST_CHECK(!memcmp(run_order, "HLHHH", 5), "light worker starved");
+        printf("heavy worker: %u runs, %"PRIu64"us total, %uus max; light worker: %u runs, %u deferred, %uus max latency\n",
+               (uint)heavy_stats.run_count, heavy_stats.total_run_time_us, (uint)heavy_stats.max_run_time_us,
+               (uint)light_stats.run_count, (uint)light_stats.deferred_count, (uint)light_stats.max_latency_us);
+
+        async_context_remove_when_pending_worker(&context.core, &heavy_worker);
+        async_context_remove_when_pending_worker(&context.core, &light_worker);
+        async_context_remove_when_pending_worker(&context.core, &urgent_worker);
+        async_context_set_execution_budget_us(&context.core, 0);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("dispatch latency");
+        static uint32_t latencies[LATENCY_ITERATIONS];
+        for (uint i = 0; i < LATENCY_ITERATIONS; i++) {
+            uint32_t expected = pending_count + 1;
+            uint64_t t0 = time_us_64();
+            async_context_set_work_pending(&context.core, &pending_worker);
+            wait_for_count(&pending_count, expected);
+            latencies[i] = (uint32_t)(pending_time - t0);
+        }
+        qsort(latencies, LATENCY_ITERATIONS, sizeof(latencies[0]), compare_u32);
+        printf("set_work_pending -> do_work latency: min %uus, median %uus, p99 %uus, max %uus\n",
+               (uint)latencies[0], (uint)latencies[LATENCY_ITERATIONS / 2],
+               (uint)latencies[LATENCY_ITERATIONS * 99 / 100], (uint)latencies[LATENCY_ITERATIONS - 1]);
+
+        uint64_t t0 = time_us_64();
+        pthread_t thread_id;
+        for (uint i = 0; i < LATENCY_ITERATIONS; i++) {
+            async_context_execute_sync(&context.core, get_thread, &thread_id);
+        }
+        uint64_t sync_us = time_us_64() - t0;
+        printf("execute_sync round trip: %.2fus\n", (double)sync_us / LATENCY_ITERATIONS);
+        PICOTEST_CHECK(pthread_equal(thread_id, context_thread), "execute_sync ran on the wrong thread");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("dispatch throughput");
+        async_context_add_when_pending_worker(&context.core, &self_rescheduling_worker);
+        // hold the lock so that the worker doesn't start until the timer does
+        async_context_acquire_lock_blocking(&context.core);
+        self_rescheduling_remaining = THROUGHPUT_ITERATIONS;
+        async_context_set_work_pending(&context.core, &self_rescheduling_worker);
+        uint64_t t0 = time_us_64();
+        async_context_release_lock(&context.core);
+        while (self_rescheduling_remaining) {
+            sleep_ms(1);
+        }
+        uint64_t us = time_us_64() - t0;
+        printf("self-rescheduling worker: %u dispatches in %"PRIu64"us (%.0f per second)\n",
+               THROUGHPUT_ITERATIONS, us, THROUGHPUT_ITERATIONS * 1e6 / (double)us);
+        PICOTEST_CHECK(async_context_remove_when_pending_worker(&context.core, &self_rescheduling_worker), "remove failed");
+    PICOTEST_END_SECTION();
+
+    async_context_deinit(&context.core);
+    PICOTEST_END_TEST();
+}
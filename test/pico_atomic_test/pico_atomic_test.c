@@ -0,0 +1,243 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "pico/stdlib.h"
+#include "pico/atomic.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("ATOMIC", "pico_atomic spin lock striping test");
+
+// Compares contention between threads for the single PICO_SPINLOCK_ID_ATOMIC spin lock with the striped spin locks,
+// for operations done the same way as the ones in pico_atomic's atomic.c. The host's spin locks are replaced with real
+// ones below, so that the threads do contend
+
+#define THREADS 4
+#define OPS_PER_THREAD 200000
+
+struct _spin_lock_t {
+    atomic_bool locked;
+};
+
+static spin_lock_t host_spin_locks[NUM_SPIN_LOCKS];
+
+spin_lock_t *spin_lock_instance(uint lock_num) {
+    hard_assert(lock_num < NUM_SPIN_LOCKS);
+    return &host_spin_locks[lock_num];
+}
+
+uint spin_lock_get_num(spin_lock_t *lock) {
+    return (uint)(lock - host_spin_locks);
+}
+
+uint spin_lock_num(spin_lock_t *lock) {
+    return spin_lock_get_num(lock);
+}
+
+void spin_lock_unsafe_blocking(spin_lock_t *lock) {
+    while (atomic_exchange_explicit(&lock->locked, true, memory_order_acquire)) {
+        // the holder may not be running if there are fewer CPUs than threads
+        sched_yield();
+    }
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    spin_lock_unsafe_blocking(lock);
+    return 0;
+}
+
+void spin_unlock_unsafe(spin_lock_t *lock) {
+    atomic_store_explicit(&lock->locked, false, memory_order_release);
+}
+
+void spin_unlock(spin_lock_t *lock, __unused uint32_t saved_irq) {
+    spin_unlock_unsafe(lock);
+}
+
+bool is_spin_locked(const spin_lock_t *lock) {
+    return atomic_load_explicit(&lock->locked, memory_order_relaxed);
+}
+
+static uint single_spin_lock_num(__unused const volatile void *ptr) {
+    return PICO_SPINLOCK_ID_ATOMIC;
+}
+
+typedef struct {
+    const char *name;
+    uint (*lock_num)(const volatile void *ptr);
+} lock_mode_t;
+
+static const lock_mode_t modes[] = {
+    { "single", single_spin_lock_num },
+    { "striped", atomic_striped_spin_lock_num },
+};
+
+// as __atomic_fetch_add_8
+static uint64_t fetch_add_u64(const lock_mode_t *mode, volatile uint64_t *ptr, uint64_t val) {
+    spin_lock_t *lock = spin_lock_instance(mode->lock_num(ptr));
+    uint32_t save = spin_lock_blocking(lock);
+    uint64_t tmp = *ptr;
+    *ptr = tmp + val;
+    spin_unlock(lock, save);
+    return tmp;
+}
+
+// a multi-word object, which is only consistent if every access to it uses the same spin lock
+typedef struct {
+    uint64_t a;
+    uint64_t b;
+} pair_t;
+
+// as __atomic_store_c
+static void store_pair(const lock_mode_t *mode, volatile pair_t *ptr, uint64_t value) {
+    spin_lock_t *lock = spin_lock_instance(mode->lock_num(ptr));
+    uint32_t save = spin_lock_blocking(lock);
+    ptr->a = value;
+    ptr->b = value;
+    spin_unlock(lock, save);
+}
+
+// as __atomic_load_c
+static pair_t load_pair(const lock_mode_t *mode, volatile pair_t *ptr) {
+    spin_lock_t *lock = spin_lock_instance(mode->lock_num(ptr));
+    uint32_t save = spin_lock_blocking(lock);
+    pair_t result = { ptr->a, ptr->b };
+    spin_unlock(lock, save);
+    return result;
+}
+
+// one counter per thread, each in its own cache line
+static struct {
+    volatile uint64_t value;
+    uint8_t pad[56];
+} counters[THREADS];
+
+static volatile uint64_t shared_counter;
+static volatile pair_t shared_pair;
+
+typedef struct {
+    const lock_mode_t *mode;
+    uint index;
+    bool shared;
+    uint torn;
+} worker_t;
+
+static void *counter_worker(void *param) {
+    worker_t *worker = (worker_t *)param;
+    volatile uint64_t *counter = worker->shared ? &shared_counter : &counters[worker->index].value;
+    for (uint i = 0; i < OPS_PER_THREAD; i++) {
+        fetch_add_u64(worker->mode, counter, 1);
+    }
+    return NULL;
+}
+
+static void *pair_worker(void *param) {
+    worker_t *worker = (worker_t *)param;
+    for (uint i = 0; i < OPS_PER_THREAD; i++) {
+        if (i & 1) {
+            pair_t value = load_pair(worker->mode, &shared_pair);
+            if (value.a != value.b) worker->torn++;
+        } else {
+            store_pair(worker->mode, &shared_pair, ((uint64_t)worker->index << 32) | i);
+        }
+    }
+    return NULL;
+}
+
+// Run the worker on THREADS threads, returning the time taken in us
+static uint64_t run_threads(void *(*fn)(void *), worker_t *workers) {
+    pthread_t threads[THREADS];
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < THREADS; i++) {
+        pthread_create(&threads[i], NULL, fn, &workers[i]);
+    }
+    for (uint i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return time_us_64() - start;
+}
+
+static void init_workers(worker_t *workers, const lock_mode_t *mode, bool shared) {
+    for (uint i = 0; i < THREADS; i++) {
+        workers[i] = (worker_t) { .mode = mode, .index = i, .shared = shared };
+    }
+}
+
+static void print_rate(const char *mode, const char *what, uint64_t us) {
+    uint64_t ops = (uint64_t)THREADS * OPS_PER_THREAD;
+    printf("%-8s %-22s %6.2f Mops/s\n", mode, what, (double)ops / (double)(us ? us : 1));
+}
+
+// Check that every one of the striped spin locks is used, and none too much, for count objects at a given stride
+static bool check_spread(uint stride, uint count) {
+    static uint8_t __aligned(8) objects[64 * 1024];
+    uint used[PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT] = { 0 };
+    for (uint i = 0; i < count; i++) {
+        uint lock_num = atomic_striped_spin_lock_num(objects + i * stride);
+        if (lock_num < PICO_SPINLOCK_ID_STRIPED_FIRST ||
+            lock_num >= PICO_SPINLOCK_ID_STRIPED_FIRST + PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT) {
+            return false;
+        }
+        used[lock_num - PICO_SPINLOCK_ID_STRIPED_FIRST]++;
+    }
+    uint expected = count / PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT;
+    for (uint i = 0; i < PICO_ATOMIC_STRIPED_SPIN_LOCK_COUNT; i++) {
+        if (used[i] < expected / 2 || used[i] > expected * 2) return false;
+    }
+    return true;
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    PICOTEST_START_SECTION("spread");
+        PICOTEST_CHECK(atomic_spin_lock_num(counters) == (PICO_ATOMIC_STRIPED_SPIN_LOCKS ?
+                       atomic_striped_spin_lock_num(counters) : PICO_SPINLOCK_ID_ATOMIC), "wrong spin lock selected");
+        PICOTEST_CHECK(check_spread(1, 4096), "bytes not spread over the spin locks");
+        PICOTEST_CHECK(check_spread(4, 4096), "words not spread over the spin locks");
+        PICOTEST_CHECK(check_spread(8, 4096), "64 bit values not spread over the spin locks");
+        PICOTEST_CHECK(check_spread(64, 1024), "array of structs not spread over the spin locks");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("contention");
+        worker_t workers[THREADS];
+        for (uint m = 0; m < count_of(modes); m++) {
+            for (uint i = 0; i < THREADS; i++) counters[i].value = 0;
+            init_workers(workers, &modes[m], false);
+            uint64_t us = run_threads(counter_worker, workers);
+            bool ok = true;
+            for (uint i = 0; i < THREADS; i++) ok &= counters[i].value == OPS_PER_THREAD;
+            PICOTEST_CHECK(ok, "separate counters lost an update");
+            print_rate(modes[m].name, "separate counters", us);
+
+            shared_counter = 0;
+            init_workers(workers, &modes[m], true);
+            us = run_threads(counter_worker, workers);
+            PICOTEST_CHECK(shared_counter == (uint64_t)THREADS * OPS_PER_THREAD, "shared counter lost an update");
+            print_rate(modes[m].name, "shared counter", us);
+        }
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("multi-word");
+        worker_t workers[THREADS];
+        for (uint m = 0; m < count_of(modes); m++) {
+            init_workers(workers, &modes[m], true);
+            uint64_t us = run_threads(pair_worker, workers);
+            uint torn = 0;
+            for (uint i = 0; i < THREADS; i++) torn += workers[i].torn;
+            PICOTEST_CHECK(!torn, "torn read of a multi-word object");
+            print_rate(modes[m].name, "shared 16 byte object", us);
+        }
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
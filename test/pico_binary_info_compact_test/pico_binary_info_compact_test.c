@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/binary_info_compact.h"
+#include "pico/binary_info/defs.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("BI_COMPACT", "compact binary info test");
+
+// roughly the binary info of a large application: program details, many features (several repeated), named pin
+// groups, pins and a few values
+#define FEATURE_COUNT 96
+#define PIN_COUNT 48
+#define MAX_ENTRIES (16 + FEATURE_COUNT + 2 * PIN_COUNT)
+#define BLOB_SIZE 8192
+#define LOOKUP_ITERATIONS 20000
+
+#define TAG_APP BINARY_INFO_MAKE_TAG('A', 'P')
+#define ID_GROUP 0x1234u
+
+static bi_compact_entry_t entries[MAX_ENTRIES];
+static uint entry_count;
+static char feature_names[FEATURE_COUNT][32];
+static uint8_t blob[BLOB_SIZE];
+
+static bi_compact_entry_t *add_entry(uint16_t type, uint16_t tag, uint32_t id) {
+    hard_assert(entry_count < MAX_ENTRIES);
+    bi_compact_entry_t *e = &entries[entry_count++];
+    memset(e, 0, sizeof(*e));
+    e->type = type;
+    e->tag = tag;
+    e->id = id;
+    return e;
+}
+
+static void add_string(uint16_t tag, uint32_t id, const char *value) {
+    add_entry(BINARY_INFO_TYPE_ID_AND_STRING, tag, id)->string = value;
+}
+
+static void build_entries(void) {
+    // added out of order, to check the sort
+    add_entry(BINARY_INFO_TYPE_ID_AND_INT, TAG_APP, 7)->int_value = -123456;
+    add_string(BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_NAME, "compact_binary_info_example");
+    add_string(BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_VERSION_STRING, "1.2.3");
+    add_string(BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_BUILD_DATE_STRING, "Jan  1 2025");
+    add_string(BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_SDK_VERSION, "2.2.0");
+    add_string(BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PICO_BOARD, "pico2");
+    add_string(BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_URL, "https://github.com/raspberrypi/pico-sdk");
+    add_string(BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_DESCRIPTION,
+               "An application with a great deal of binary info");
+    for (uint i = 0; i < FEATURE_COUNT; i++) {
+        // every fourth feature repeats an earlier one, as happens when several libraries declare the same thing
+        snprintf(feature_names[i], sizeof(feature_names[i]), "feature %u enabled", i % 4 == 3 ? i - 3 : i);
+        add_string(BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_FEATURE, feature_names[i]);
+    }
+    bi_compact_entry_t *e = add_entry(BINARY_INFO_TYPE_NAMED_GROUP, BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_FEATURE);
+    e->group_tag = TAG_APP;
+    e->group_id = ID_GROUP;
+    e->flags = BI_NAMED_GROUP_SEPARATE_COMMAS;
+    e->label = "application settings";
+    for (uint i = 0; i < PIN_COUNT; i++) {
+        e = add_entry(BINARY_INFO_TYPE_PINS_WITH_FUNC, BINARY_INFO_TAG_RASPBERRY_PI, 0);
+        e->pins = BI_PINS_ENCODING_MULTI | (2u << 3) | ((i % 30) << 7) | (((i + 1) % 30) << 12) | (((i + 1) % 30) << 17);
+        e = add_entry(BINARY_INFO_TYPE_PINS64_WITH_NAME, BINARY_INFO_TAG_RASPBERRY_PI, 0);
+        e->pins = 1ull << (i + 10);
+        e->label = i & 1 ? "SPI0 SCK" : "UART0 TX";
+    }
+    e = add_entry(BINARY_INFO_TYPE_BLOCK_DEVICE, BINARY_INFO_TAG_RASPBERRY_PI, 0);
+    e->label = "filesystem";
+    e->address = 0x10100000;
+    e->size = 0x100000;
+    e->flags = BINARY_INFO_BLOCK_DEV_FLAG_READ | BINARY_INFO_BLOCK_DEV_FLAG_WRITE;
+    e = add_entry(BINARY_INFO_TYPE_PTR_INT32_WITH_NAME, TAG_APP, ID_GROUP);
+    e->int_value = 115200;
+    e->label = "baud rate";
+    e = add_entry(BINARY_INFO_TYPE_PTR_STRING_WITH_NAME, TAG_APP, ID_GROUP + 1);
+    e->string = "enabled";
+    e->label = "UART0 TX";
+}
+
+// The flash used by the same entries as regular binary info: a pointer to each entry, the packed entries, and each
+// distinct string (assuming the linker merges identical ones)
+static uint regular_size(void) {
+    uint size = 0;
+    const char *strings[2 * MAX_ENTRIES];
+    uint string_count = 0;
+    for (uint i = 0; i < entry_count; i++) {
+        size += 4;
+        switch (entries[i].type) {
+            case BINARY_INFO_TYPE_ID_AND_INT: size += sizeof(binary_info_id_and_int_t); break;
+            case BINARY_INFO_TYPE_ID_AND_STRING: size += sizeof(binary_info_id_and_string_t); break;
+            case BINARY_INFO_TYPE_BLOCK_DEVICE: size += sizeof(binary_info_block_device_t); break;
+            case BINARY_INFO_TYPE_PINS_WITH_FUNC: size += sizeof(binary_info_pins_with_func_t); break;
+            case BINARY_INFO_TYPE_PINS64_WITH_NAME: size += sizeof(binary_info_pins64_with_name_t); break;
+            case BINARY_INFO_TYPE_NAMED_GROUP: size += sizeof(binary_info_named_group_t); break;
+            // the value itself is in RAM
+            case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME: size += sizeof(binary_info_ptr_int32_with_name_t); break;
+            case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME: size += sizeof(binary_info_ptr_string_with_name_t); break;
+        }
+        const char *s[2] = { entries[i].string, entries[i].label };
+        for (uint j = 0; j < 2; j++) {
+            if (!s[j]) continue;
+            bool seen = false;
+            for (uint k = 0; k < string_count && !seen; k++) seen = !strcmp(strings[k], s[j]);
+            if (!seen) {
+                strings[string_count++] = s[j];
+                size += strlen(s[j]) + 1;
+            }
+        }
+    }
+    return size;
+}
+
+static bool entries_equal(const bi_compact_entry_t *a, const bi_compact_entry_t *b) {
+    if (a->type != b->type || a->tag != b->tag || a->id != b->id || a->int_value != b->int_value ||
+        a->flags != b->flags || a->group_tag != b->group_tag || a->group_id != b->group_id ||
+        a->address != b->address || a->size != b->size || a->pins != b->pins) {
+        return false;
+    }
+    if (!a->string != !b->string || (a->string && strcmp(a->string, b->string))) return false;
+    return !a->label == !b->label && (!a->label || !strcmp(a->label, b->label));
+}
+
+// what firmware has to do without the index: walk the list of pointers to entries
+static const bi_compact_entry_t *entry_list[MAX_ENTRIES];
+
+static const char *list_find_string(uint16_t tag, uint32_t id) {
+    for (uint i = 0; i < entry_count; i++) {
+        const bi_compact_entry_t *e = entry_list[i];
+        if (e->tag == tag && e->id == id &&
+            (e->type == BINARY_INFO_TYPE_ID_AND_STRING || e->type == BINARY_INFO_TYPE_PTR_STRING_WITH_NAME)) {
+            return e->string;
+        }
+    }
+    return NULL;
+}
+
+static bool skip_pins(__unused void *context, uint index, bi_compact_entry_t *entry) {
+    *entry = entries[index];
+    return entry->type != BINARY_INFO_TYPE_PINS_WITH_FUNC;
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    build_entries();
+    int size = bi_compact_encode_entries(entries, entry_count, blob, sizeof(blob));
+
+    PICOTEST_START_SECTION("encoding");
+        PICOTEST_CHECK_AND_ABORT(size > 0, "encoding failed");
+        PICOTEST_CHECK(bi_compact_is_valid(blob, (uint)size), "encoding not valid");
+        PICOTEST_CHECK(!bi_compact_is_valid(blob, (uint)size - 1), "truncated encoding accepted");
+        PICOTEST_CHECK(bi_compact_get_count(blob) == entry_count, "wrong entry count");
+        uint regular = regular_size();
+        printf("%u entries: %u bytes as regular binary info, %d bytes compact (%u%%)\n", entry_count, regular, size,
+               (uint)size * 100 / regular);
+        PICOTEST_CHECK((uint)size * 3 < regular * 2, "encoding not compact");
+
+        // every entry comes back, in (tag, id) order, and in the original order for equal keys
+        bool sorted = true, found = true;
+        uint last_feature = 0;
+        bi_compact_entry_t e, prev;
+        for (uint i = 0; i < entry_count; i++) {
+            PICOTEST_CHECK_AND_ABORT(bi_compact_get_entry(blob, i, &e), "entry missing");
+            if (i) sorted &= prev.tag < e.tag || (prev.tag == e.tag && prev.id <= e.id);
+            bool match = false;
+            for (uint j = 0; j < entry_count && !match; j++) match = entries_equal(&e, &entries[j]);
+            found &= match;
+            if (e.type == BINARY_INFO_TYPE_ID_AND_STRING && e.id == BINARY_INFO_ID_RP_PROGRAM_FEATURE) {
+                PICOTEST_CHECK(!strcmp(e.string, feature_names[last_feature]), "order of equal keys not kept");
+                last_feature++;
+            }
+            prev = e;
+        }
+        PICOTEST_CHECK(!bi_compact_get_entry(blob, entry_count, &e), "entry past the end");
+        PICOTEST_CHECK(sorted, "entries not sorted");
+        PICOTEST_CHECK(found, "entry changed by encoding");
+        PICOTEST_CHECK(last_feature == FEATURE_COUNT, "features missing");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("lookup");
+        const char *name = bi_compact_find_string(blob, BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_NAME);
+        PICOTEST_CHECK(name && !strcmp(name, "compact_binary_info_example"), "program name not found");
+        // the named group shares the feature ID, but is not a string
+        name = bi_compact_find_string(blob, BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_FEATURE);
+        PICOTEST_CHECK(name && !strcmp(name, feature_names[0]), "first feature not found");
+        name = bi_compact_find_string(blob, TAG_APP, ID_GROUP + 1);
+        PICOTEST_CHECK(name && !strcmp(name, "enabled"), "pointer string not found");
+        int32_t value = 0;
+        PICOTEST_CHECK(bi_compact_find_int(blob, TAG_APP, 7, &value) && value == -123456, "negative int not found");
+        PICOTEST_CHECK(bi_compact_find_int(blob, TAG_APP, ID_GROUP, &value) && value == 115200, "pointer int not found");
+        PICOTEST_CHECK(!bi_compact_find_int(blob, BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_NAME, &value),
+                       "string found as an int");
+        PICOTEST_CHECK(bi_compact_find(blob, TAG_APP, 8) == PICO_ERROR_NOT_FOUND, "missing ID found");
+        PICOTEST_CHECK(bi_compact_find(blob, 0xffff, 0xffffffff) == PICO_ERROR_NOT_FOUND, "missing tag found");
+        int pins = bi_compact_find(blob, BINARY_INFO_TAG_RASPBERRY_PI, 0);
+        bi_compact_entry_t e;
+        PICOTEST_CHECK(pins >= 0 && bi_compact_get_entry(blob, (uint)pins, &e) && e.type == BINARY_INFO_TYPE_PINS_WITH_FUNC,
+                       "pins not found");
+
+        // the program name is near the start of the list, and the pointer string is the worst case at the end of it
+        for (uint i = 0; i < entry_count; i++) entry_list[i] = &entries[i];
+        static const struct { uint16_t tag; uint32_t id; } keys[] = {
+            { BINARY_INFO_TAG_RASPBERRY_PI, BINARY_INFO_ID_RP_PROGRAM_NAME },
+            { TAG_APP, ID_GROUP + 1 },
+        };
+        for (uint i = 0; i < count_of(keys); i++) {
+            // read through a volatile so that the lookups are not hoisted out of the loops
+            volatile uint32_t id = keys[i].id;
+            const char *expected = list_find_string(keys[i].tag, id);
+            uint misses = 0;
+            absolute_time_t start = get_absolute_time();
+            for (uint n = 0; n < LOOKUP_ITERATIONS; n++) {
+                misses += list_find_string(keys[i].tag, id) != expected;
+            }
+            int64_t list_us = absolute_time_diff_us(start, get_absolute_time());
+            start = get_absolute_time();
+            for (uint n = 0; n < LOOKUP_ITERATIONS; n++) {
+                misses += bi_compact_find_string(blob, keys[i].tag, id) == NULL;
+            }
+            int64_t compact_us = absolute_time_diff_us(start, get_absolute_time());
+            const char *found = bi_compact_find_string(blob, keys[i].tag, id);
+            printf("%04x:%08x: %d lookups, list walk %dus, compact %dus\n", keys[i].tag, (uint)keys[i].id,
+                   LOOKUP_ITERATIONS, (int)list_us, (int)compact_us);
+            PICOTEST_CHECK(!misses && found && !strcmp(found, expected), "lookup returned the wrong string");
+        }
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("errors");
+        PICOTEST_CHECK(bi_compact_encode_entries(entries, entry_count, blob, (uint)size - 1) == PICO_ERROR_BUFFER_TOO_SMALL,
+                       "overflow not reported");
+        PICOTEST_CHECK(bi_compact_encode_entries(entries, entry_count, blob, 4) == PICO_ERROR_BUFFER_TOO_SMALL,
+                       "tiny buffer accepted");
+        int skipped = bi_compact_encode(skip_pins, NULL, entry_count, blob, sizeof(blob));
+        PICOTEST_CHECK(skipped > 0 && bi_compact_get_count(blob) == entry_count - PIN_COUNT, "skipped entries encoded");
+        bi_compact_entry_t raw = { .type = BINARY_INFO_TYPE_RAW_DATA };
+        PICOTEST_CHECK(bi_compact_encode_entries(&raw, 1, blob, sizeof(blob)) == PICO_ERROR_INVALID_ARG,
+                       "unencodable entry accepted");
+        PICOTEST_CHECK(bi_compact_encode_entries(entries, 0, blob, sizeof(blob)) == BI_COMPACT_HEADER_SIZE,
+                       "empty encoding has wrong size");
+        PICOTEST_CHECK(bi_compact_is_valid(blob, BI_COMPACT_HEADER_SIZE) &&
+                       bi_compact_find(blob, BINARY_INFO_TAG_RASPBERRY_PI, 0) == PICO_ERROR_NOT_FOUND, "empty encoding broken");
+        blob[0] ^= 1;
+        PICOTEST_CHECK(!bi_compact_is_valid(blob, BI_COMPACT_HEADER_SIZE), "bad magic accepted");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "pico/stdlib.h"
+#include "pico/btstack_flash_bank_cache.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("BTSTACK_FLASH_BANK_CACHE", "BTstack flash bank write-back cache test");
+
+#define FLASH_SIZE 8192
+#define SECTOR_SIZE 4096
+#define PAGE_SIZE PICO_FLASH_BANK_CACHE_PAGE_SIZE
+#define MAX_LOG 64
+
+// Approximate cost of a flash_safe_execute() window (locking out the other core and leaving/re-entering XIP), and of
+// programming one page
+#define WINDOW_US 50
+#define PAGE_PROGRAM_US 400
+
+// A RAM model of NOR flash: erased bytes are 0xff, and programming can only clear bits
+static uint8_t flash[FLASH_SIZE];
+// What the flash should hold after all writes so far
+static uint8_t reference[FLASH_SIZE];
+// Offsets of the pages programmed, in order, with -1 between program calls
+static int32_t program_log[MAX_LOG];
+static uint program_log_count;
+static bool simulate_timing;
+
+static void log_program(int32_t value) {
+    if (program_log_count < MAX_LOG) program_log[program_log_count] = value;
+    program_log_count++;
+}
+
+static void model_read(__unused void *context, uint32_t offset, uint8_t *buffer, uint32_t size) {
+    memcpy(buffer, flash + offset, size);
+}
+
+static void model_program(__unused void *context, const pico_flash_bank_cache_page_t *pages, uint count) {
+    if (simulate_timing) busy_wait_us(WINDOW_US);
+    for (uint i = 0; i < count; i++) {
+        for (uint j = 0; j < PAGE_SIZE; j++) {
+            flash[pages[i].offset + j] &= pages[i].data[j];
+        }
+        log_program((int32_t)pages[i].offset);
+        if (simulate_timing) busy_wait_us(PAGE_PROGRAM_US);
+    }
+    log_program(-1);
+}
+
+static void model_erase(__unused void *context, uint32_t offset, uint32_t size) {
+    memset(flash + offset, 0xff, size);
+}
+
+static const pico_flash_bank_cache_ops_t model_ops = {
+    .read = model_read,
+    .program = model_program,
+    .erase = model_erase,
+};
+
+static pico_flash_bank_cache_t cache;
+
+static void reset(void) {
+    memset(flash, 0xff, sizeof(flash));
+    memset(reference, 0xff, sizeof(reference));
+    program_log_count = 0;
+    pico_flash_bank_cache_init(&cache, &model_ops, NULL);
+}
+
+static void write(uint32_t offset, const void *data, uint32_t size) {
+    memcpy(reference + offset, data, size);
+    pico_flash_bank_cache_write(&cache, offset, data, size);
+}
+
+static void fill_write(uint32_t offset, uint8_t value, uint32_t size) {
+    uint8_t data[3 * PAGE_SIZE];
+    memset(data, value, size);
+    write(offset, data, size);
+}
+
+static bool log_matches(const int32_t *expected, uint count) {
+    return program_log_count == count && !memcmp(program_log, expected, count * sizeof(expected[0]));
+}
+
+// Append a BTstack TLV style entry (an 8 byte tag/length header, then the value, as separate writes) to a bank
+static uint32_t store_tag(uint32_t pos, uint32_t tag, uint32_t len) {
+    uint8_t header[8];
+    memcpy(header, &tag, 4);
+    memcpy(header + 4, &len, 4);
+    write(pos, header, sizeof(header));
+    uint8_t value[128];
+    for (uint i = 0; i < len; i++) value[i] = (uint8_t)(tag + i);
+    write(pos + sizeof(header), value, len);
+    return pos + sizeof(header) + len;
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    PICOTEST_START_SECTION("read and write");
+        reset();
+        fill_write(10, 0x11, 20);
+        fill_write(30, 0x22, 300);
+        uint8_t buffer[400];
+        pico_flash_bank_cache_read(&cache, 0, buffer, sizeof(buffer));
+        PICOTEST_CHECK(!memcmp(buffer, reference, sizeof(buffer)), "read did not see cached writes");
+        PICOTEST_CHECK(flash[10] == 0xff && program_log_count == 0, "writes programmed before a flush");
+        PICOTEST_CHECK(pico_flash_bank_cache_is_dirty(&cache), "cache not dirty");
+        pico_flash_bank_cache_flush(&cache);
+        PICOTEST_CHECK(!memcmp(flash, reference, sizeof(flash)), "flash wrong after flush");
+        static const int32_t expected[] = { 0, 256, -1 };
+        PICOTEST_CHECK(log_matches(expected, count_of(expected)), "wrong pages programmed");
+        PICOTEST_CHECK(!pico_flash_bank_cache_is_dirty(&cache), "cache still dirty");
+
+        // a later write to a programmed page keeps what is already there
+        fill_write(400, 0x33, 8);
+        pico_flash_bank_cache_flush(&cache);
+        PICOTEST_CHECK(!memcmp(flash, reference, sizeof(flash)), "flash wrong after second flush");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("ordering");
+        reset();
+        fill_write(0, 0x01, 16);
+        fill_write(PAGE_SIZE, 0x02, 16);
+        // going back to an earlier dirty page must commit what came before it first
+        fill_write(16, 0x03, 16);
+        static const int32_t expected_commit[] = { 0, 256, -1 };
+        PICOTEST_CHECK(log_matches(expected_commit, count_of(expected_commit)), "out of order write not committed first");
+        // more writes to the last dirty page are coalesced
+        fill_write(32, 0x04, 16);
+        pico_flash_bank_cache_erase(&cache, SECTOR_SIZE, SECTOR_SIZE);
+        memset(reference + SECTOR_SIZE, 0xff, SECTOR_SIZE);
+        static const int32_t expected_erase[] = { 0, 256, -1, 0, -1 };
+        PICOTEST_CHECK(log_matches(expected_erase, count_of(expected_erase)), "erase did not commit first");
+        PICOTEST_CHECK(!memcmp(flash, reference, sizeof(flash)), "flash wrong after erase");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("capacity");
+        reset();
+        for (uint i = 0; i <= PICO_FLASH_BANK_CACHE_PAGES; i++) {
+            fill_write(i * PAGE_SIZE, (uint8_t)i, 4);
+        }
+        pico_flash_bank_cache_stats_t stats;
+        pico_flash_bank_cache_get_stats(&cache, &stats);
+        PICOTEST_CHECK(stats.commits == 1 && stats.pages_programmed == PICO_FLASH_BANK_CACHE_PAGES, "full cache not committed");
+        pico_flash_bank_cache_flush(&cache);
+        PICOTEST_CHECK(!memcmp(flash, reference, sizeof(flash)), "flash wrong");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("bonding updates");
+        reset();
+        simulate_timing = true;
+        uint32_t pos = 8;
+        fill_write(0, 0x42, 8);
+        pico_flash_bank_cache_flush(&cache);
+        pico_flash_bank_cache_reset_stats(&cache);
+        // each bonding stores a few tags (device db entry, link key, etc.), then returns to the run loop
+        static const uint32_t tag_sizes[] = { 88, 24, 16, 40 };
+        uint updates = 0;
+        while (pos + 8 * 128 < SECTOR_SIZE) {
+            for (uint i = 0; i < count_of(tag_sizes); i++) {
+                pos = store_tag(pos, 0x42540000u + updates * 16 + i, tag_sizes[i]);
+            }
+            pico_flash_bank_cache_flush(&cache);
+            updates++;
+        }
+        simulate_timing = false;
+        PICOTEST_CHECK(!memcmp(flash, reference, sizeof(flash)), "flash wrong");
+        pico_flash_bank_cache_stats_t stats;
+        pico_flash_bank_cache_get_stats(&cache, &stats);
+        printf("%u bonding updates: %u writes touching %u pages; %u pages programmed in %u lockouts (%"PRIu64"us, max %uus)\n",
+               updates, (uint)stats.writes, (uint)stats.pages_written, (uint)stats.pages_programmed, (uint)stats.commits,
+               stats.lockout_us, (uint)stats.max_lockout_us);
+        printf("programming each write as it is made: %u lockouts (~%uus)\n", (uint)stats.pages_written,
+               (uint)stats.pages_written * (WINDOW_US + PAGE_PROGRAM_US));
+        PICOTEST_CHECK(stats.commits == updates, "expected one lockout per update");
+        PICOTEST_CHECK(stats.pages_programmed < stats.pages_written / 2, "pages not coalesced");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "gspi_fake.h"
+
+uint32_t gspi_fake_checksum(uint32_t checksum, const uint8_t *data, size_t len) {
+    // FNV-1a
+    for (size_t i = 0; i < len; i++) {
+        checksum = (checksum ^ data[i]) * 16777619u;
+    }
+    return checksum;
+}
+
+static uint32_t read_bus_reg(gspi_fake_t *fake, uint32_t addr) {
+    switch (addr) {
+        case GSPI_REG_STATUS:
+            return fake->now_ns >= fake->f2_ready_at_ns ? GSPI_STATUS_F2_RX_READY : 0;
+        case GSPI_REG_TEST_RO:
+            return GSPI_TEST_PATTERN;
+        default:
+            return 0;
+    }
+}
+
+static void execute(gspi_fake_t *fake, const cyw43_spi_op_t *op) {
+    // the command is either sent separately, or is the first word of the tx data
+    const uint8_t *tx = op->tx ? op->tx : op->rx;
+    uint32_t cmd;
+    size_t cmd_in_tx = op->header_length ? 0 : 4;
+    if (op->header_length) {
+        cmd = op->header;
+    } else if (op->tx_length >= 4) {
+        memcpy(&cmd, tx, 4);
+    } else {
+        fake->errors++;
+        return;
+    }
+    bool write = cmd >> 31;
+    uint32_t fn = (cmd >> 28) & 3;
+    uint32_t addr = (cmd >> 11) & 0x1ffff;
+    uint32_t size = cmd & 0x7ff;
+    if (!size) size = 2048;
+
+    if (write) {
+        if (op->rx || op->tx_length < cmd_in_tx + size) {
+            fake->errors++;
+            return;
+        }
+        const uint8_t *data = tx + cmd_in_tx;
+        switch (fn) {
+            case GSPI_FUNC_WLAN:
+                if (fake->now_ns < fake->f2_ready_at_ns) {
+                    // written without waiting for F2 to be ready; the chip would drop it
+                    fake->errors++;
+                    return;
+                }
+                fake->frames++;
+                fake->frame_bytes += size;
+                fake->frame_checksum = gspi_fake_checksum(fake->frame_checksum, data, size);
+                fake->f2_ready_at_ns = fake->done_at_ns + fake->config.f2_busy_ns;
+                break;
+            case GSPI_FUNC_BACKPLANE:
+                if (addr + size > GSPI_BACKPLANE_SIZE) {
+                    fake->errors++;
+                    return;
+                }
+                memcpy(fake->backplane + addr, data, size);
+                break;
+            default:
+                break;
+        }
+    } else {
+        uint32_t pad = fn == GSPI_FUNC_BACKPLANE ? GSPI_BACKPLANE_READ_PAD_BYTES : 0;
+        if (!op->rx || op->tx_length != cmd_in_tx || op->rx_length < cmd_in_tx + pad + size) {
+            fake->errors++;
+            return;
+        }
+        uint8_t *data = op->rx + cmd_in_tx + pad;
+        memset(op->rx + cmd_in_tx, 0xff, pad);
+        switch (fn) {
+            case GSPI_FUNC_BUS: {
+                uint32_t value = read_bus_reg(fake, addr);
+                memcpy(data, &value, MIN(size, 4));
+                break;
+            }
+            case GSPI_FUNC_BACKPLANE:
+                if (addr + size > GSPI_BACKPLANE_SIZE) {
+                    fake->errors++;
+                    return;
+                }
+                memcpy(data, fake->backplane + addr, size);
+                break;
+            case GSPI_FUNC_WLAN:
+                fake->frames_read++;
+                for (uint32_t i = 0; i < size; i++) {
+                    data[i] = (uint8_t)(fake->frames_read * 31 + i);
+                }
+                fake->frame_read_checksum = gspi_fake_checksum(fake->frame_read_checksum, data, size);
+                break;
+            default:
+                memset(data, 0, size);
+                break;
+        }
+    }
+}
+
+static void start(cyw43_spi_queue_t *queue, const cyw43_spi_op_t *op) {
+    gspi_fake_t *fake = (gspi_fake_t *)queue->bus;
+    size_t bytes = op->rx ? op->rx_length : op->tx_length;
+    uint64_t bus_ns = fake->config.transfer_overhead_ns + (uint64_t)bytes * 8 * 1000000000u / fake->config.bus_clock_hz;
+    fake->done_at_ns = fake->now_ns + bus_ns;
+    fake->bus_busy_ns += bus_ns;
+    execute(fake, op);
+}
+
+void gspi_fake_init(gspi_fake_t *fake, const gspi_fake_config_t *config) {
+    memset(fake, 0, sizeof(*fake));
+    fake->config = *config;
+    fake->frame_checksum = GSPI_FAKE_CHECKSUM_INIT;
+    fake->frame_read_checksum = GSPI_FAKE_CHECKSUM_INIT;
+    cyw43_spi_queue_init(&fake->queue, start, fake);
+}
+
+bool gspi_fake_submit(gspi_fake_t *fake, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length,
+                      cyw43_spi_transfer_callback_t callback, void *user_data) {
+    const cyw43_spi_op_t op = {
+            .tx = tx,
+            .tx_length = tx_length,
+            .rx = rx,
+            .rx_length = rx_length,
+            .callback = callback,
+            .user_data = user_data,
+    };
+    return gspi_fake_submit_op(fake, &op);
+}
+
+bool gspi_fake_submit_op(gspi_fake_t *fake, const cyw43_spi_op_t *op) {
+    return cyw43_spi_queue_submit(&fake->queue, op);
+}
+
+void gspi_fake_transfer_op(gspi_fake_t *fake, const cyw43_spi_op_t *op) {
+    while (!gspi_fake_submit_op(fake, op)) {
+        gspi_fake_advance_to(fake, fake->done_at_ns);
+    }
+    gspi_fake_wait(fake);
+}
+
+void gspi_fake_advance_to(gspi_fake_t *fake, uint64_t time_ns) {
+    while (!cyw43_spi_queue_is_idle(&fake->queue) && fake->done_at_ns <= time_ns) {
+        // each completion starts the next transfer at the time the previous one ended
+        fake->now_ns = fake->done_at_ns;
+        cyw43_spi_op_t done;
+        cyw43_spi_queue_complete(&fake->queue, &done);
+        if (done.callback) done.callback(done.user_data, 0);
+    }
+    if (time_ns > fake->now_ns) fake->now_ns = time_ns;
+}
+
+void gspi_fake_wait(gspi_fake_t *fake) {
+    while (!cyw43_spi_queue_is_idle(&fake->queue)) {
+        gspi_fake_advance_to(fake, fake->done_at_ns);
+    }
+}
+
+void gspi_fake_transfer(gspi_fake_t *fake, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length) {
+    while (!gspi_fake_submit(fake, tx, tx_length, rx, rx_length, NULL, NULL)) {
+        gspi_fake_advance_to(fake, fake->done_at_ns);
+    }
+    gspi_fake_wait(fake);
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _GSPI_FAKE_H
+#define _GSPI_FAKE_H
+
+#include "pico/cyw43_spi_queue.h"
+
+// A model of the CYW43 end of the gSPI bus, driven by a cyw43_spi_queue in place of the PIO/DMA backend. Transfers
+// take effect as soon as they are started; their completion is delivered when simulated time passes the end of
+// the transfer, which is computed from the bus clock and a fixed per-transfer overhead.
+
+#define GSPI_FUNC_BUS 0
+#define GSPI_FUNC_BACKPLANE 1
+#define GSPI_FUNC_WLAN 2
+
+#define GSPI_REG_STATUS 0x8
+#define GSPI_REG_TEST_RO 0x14
+#define GSPI_TEST_PATTERN 0xfeedbeadu
+#define GSPI_STATUS_F2_RX_READY 0x20u
+#define GSPI_BACKPLANE_READ_PAD_BYTES 16
+#define GSPI_BACKPLANE_SIZE 4096
+
+typedef struct gspi_fake_config {
+    uint32_t bus_clock_hz;          // bits per second on the data line
+    uint32_t transfer_overhead_ns;  // chip select, state machine and DMA set-up for each transfer
+    uint32_t f2_busy_ns;            // time after a WLAN frame is written before F2 is ready for another
+} gspi_fake_config_t;
+
+typedef struct gspi_fake {
+    gspi_fake_config_t config;
+    cyw43_spi_queue_t queue;
+    uint64_t now_ns;
+    uint64_t done_at_ns;            // completion time of the transfer in flight
+    uint64_t bus_busy_ns;           // total time the bus was busy
+    uint64_t f2_ready_at_ns;
+    uint32_t frames;                // WLAN frames received
+    uint64_t frame_bytes;
+    uint32_t frame_checksum;
+    uint32_t frames_read;           // WLAN frames sent to the host
+    uint32_t frame_read_checksum;
+    uint32_t errors;                // malformed transfers
+    uint8_t backplane[GSPI_BACKPLANE_SIZE];
+} gspi_fake_t;
+
+static inline uint32_t gspi_fake_make_cmd(bool write, bool inc, uint32_t fn, uint32_t addr, uint32_t sz) {
+    return (uint32_t)write << 31 | (uint32_t)inc << 30 | fn << 28 | (addr & 0x1ffff) << 11 | sz;
+}
+
+#define GSPI_FAKE_CHECKSUM_INIT 2166136261u
+
+uint32_t gspi_fake_checksum(uint32_t checksum, const uint8_t *data, size_t len);
+
+void gspi_fake_init(gspi_fake_t *fake, const gspi_fake_config_t *config);
+
+// Queue a transfer; unlike the device this does not wait for room, and returns false if the queue is full
+bool gspi_fake_submit(gspi_fake_t *fake, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length,
+                      cyw43_spi_transfer_callback_t callback, void *user_data);
+
+// As gspi_fake_submit(), for a transfer which is already set up (e.g. with a separate command word)
+bool gspi_fake_submit_op(gspi_fake_t *fake, const cyw43_spi_op_t *op);
+
+// Queue a transfer and wait for it to complete
+void gspi_fake_transfer_op(gspi_fake_t *fake, const cyw43_spi_op_t *op);
+
+// Advance simulated time, completing transfers which end by then
+void gspi_fake_advance_to(gspi_fake_t *fake, uint64_t time_ns);
+
+// Advance simulated time until the queue is empty
+void gspi_fake_wait(gspi_fake_t *fake);
+
+// As for cyw43_spi_transfer()
+void gspi_fake_transfer(gspi_fake_t *fake, const uint8_t *tx, size_t tx_length, uint8_t *rx, size_t rx_length);
+
+#endif
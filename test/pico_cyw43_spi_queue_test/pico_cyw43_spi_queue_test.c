@@ -0,0 +1,298 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "pico/stdlib.h"
+#include "pico/test.h"
+#include "pico/cyw43_spi_buf.h"
+#include "gspi_fake.h"
+
+PICOTEST_MODULE_NAME("CYW43_SPI_QUEUE", "cyw43 bus transfer queue test");
+
+// Roughly a Pico W at 125MHz: the PIO program clocks one bit every two PIO cycles at a divider of 2
+#define BUS_CLOCK_HZ 31250000u
+#define TRANSFER_OVERHEAD_NS 2000u
+#define F2_BUSY_NS 10000u
+// Time for the stack to produce a frame and copy it into a bus buffer
+#define STAGE_NS 60000u
+
+#define FRAME_COUNT 2000
+#define FRAME_BYTES 1536
+#define FRAME_WORDS (1 + FRAME_BYTES / 4)
+
+static const gspi_fake_config_t fake_config = {
+        .bus_clock_hz = BUS_CLOCK_HZ,
+        .transfer_overhead_ns = TRANSFER_OVERHEAD_NS,
+        .f2_busy_ns = F2_BUSY_NS,
+};
+
+static uint32_t completion_order[CYW43_SPI_QUEUE_LENGTH];
+static uint completion_count;
+
+static void record_completion(void *user_data, __unused int status) {
+    completion_order[completion_count++] = (uint32_t)(uintptr_t)user_data;
+}
+
+// Fill a frame buffer with the WLAN write command and a payload which differs per frame
+static uint32_t stage_frame(uint32_t *buf, uint n, uint32_t checksum) {
+    buf[0] = gspi_fake_make_cmd(true, true, GSPI_FUNC_WLAN, 0, FRAME_BYTES);
+    for (uint i = 1; i < FRAME_WORDS; i++) {
+        buf[i] = (n * 0x9e3779b9u) ^ (i * 0x01000193u);
+    }
+    return gspi_fake_checksum(checksum, (const uint8_t *)(buf + 1), FRAME_BYTES);
+}
+
+static void make_status_read(uint32_t *buf) {
+    buf[0] = gspi_fake_make_cmd(false, true, GSPI_FUNC_BUS, GSPI_REG_STATUS, 4);
+    buf[1] = 0;
+}
+
+// Send frames one after the other, as cyw43_spi_transfer() does: stage, poll F2 ready, write, repeat
+static uint64_t send_sequential(gspi_fake_t *fake, uint32_t *checksum, uint32_t *status_polls) {
+    static uint32_t frame[FRAME_WORDS];
+    uint32_t status[2];
+    for (uint n = 0; n < FRAME_COUNT; n++) {
+        *checksum = stage_frame(frame, n, *checksum);
+        gspi_fake_advance_to(fake, fake->now_ns + STAGE_NS);
+        do {
+            make_status_read(status);
+            gspi_fake_transfer(fake, NULL, 4, (uint8_t *)status, 8);
+            (*status_polls)++;
+        } while (!(status[1] & GSPI_STATUS_F2_RX_READY));
+        gspi_fake_transfer(fake, (const uint8_t *)frame, FRAME_WORDS * 4, NULL, 0);
+    }
+    return fake->now_ns;
+}
+
+// Pipelined sender: frames are staged into two buffers while the bus works on the previous frame, and the F2 poll
+// and the write are chained from completion callbacks, so the bus goes from one transfer straight to the next
+typedef struct {
+    gspi_fake_t *fake;
+    uint32_t frames[2][FRAME_WORDS];
+    uint32_t status[2];
+    uint staged;    // frames ready to send
+    uint started;   // frames whose write has been queued
+    uint written;   // frames whose write has completed
+    bool polling;   // a status read is queued for frame 'started'
+    uint32_t status_polls;
+} sender_t;
+
+static void status_done(void *user_data, int status);
+
+static void sender_kick(sender_t *s) {
+    if (!s->polling && s->started < s->staged) {
+        s->polling = true;
+        make_status_read(s->status);
+        hard_assert(gspi_fake_submit(s->fake, NULL, 4, (uint8_t *)s->status, 8, status_done, s));
+        s->status_polls++;
+    }
+}
+
+static void write_done(void *user_data, __unused int status) {
+    sender_t *s = (sender_t *)user_data;
+    s->written++;
+}
+
+static void status_done(void *user_data, __unused int status) {
+    sender_t *s = (sender_t *)user_data;
+    s->polling = false;
+    if (s->status[1] & GSPI_STATUS_F2_RX_READY) {
+        uint32_t *frame = s->frames[s->started % 2];
+        hard_assert(gspi_fake_submit(s->fake, (const uint8_t *)frame, FRAME_WORDS * 4, NULL, 0, write_done, s));
+        s->started++;
+    }
+    sender_kick(s);
+}
+
+static uint64_t send_pipelined(gspi_fake_t *fake, uint32_t *checksum, uint32_t *status_polls) {
+    static sender_t s;
+    memset(&s, 0, sizeof(s));
+    s.fake = fake;
+    for (uint n = 0; n < FRAME_COUNT; n++) {
+        // wait for the write of the frame which last used this buffer
+        while (s.written + 2 <= n) {
+            gspi_fake_advance_to(fake, fake->done_at_ns);
+        }
+        *checksum = stage_frame(s.frames[n % 2], n, *checksum);
+        gspi_fake_advance_to(fake, fake->now_ns + STAGE_NS);
+        s.staged++;
+        sender_kick(&s);
+    }
+    while (s.written < FRAME_COUNT) {
+        gspi_fake_advance_to(fake, fake->done_at_ns);
+    }
+    *status_polls = s.status_polls;
+    return fake->now_ns;
+}
+
+// Ethernet frames as lwIP hands them over
+#define ETH_FRAME_BYTES 1514
+#define COPY_TEST_FRAMES 100
+
+// The driver's own buffer, as spid_buf
+static uint32_t bounce[FRAME_WORDS];
+static cyw43_spi_copy_stats_t copy_stats;
+
+// The same buffer handling as cyw43_write_bytes()/cyw43_spi_write_bytes_in_place(), on the fake bus
+static void write_frame(gspi_fake_t *fake, const uint8_t *src, size_t len, size_t size) {
+    uint32_t status[2];
+    do {
+        make_status_read(status);
+        gspi_fake_transfer(fake, NULL, 4, (uint8_t *)status, 8);
+    } while (!(status[1] & GSPI_STATUS_F2_RX_READY));
+    const uint8_t *tx = cyw43_spi_buf_tx_prepare(&copy_stats, true, src, len, size, (uint8_t *)bounce);
+    cyw43_spi_op_t op;
+    cyw43_spi_op_init_write(&op, gspi_fake_make_cmd(true, true, GSPI_FUNC_WLAN, 0, len), tx, len);
+    gspi_fake_transfer_op(fake, &op);
+}
+
+// The same buffer handling as cyw43_read_bytes()/cyw43_spi_read_bytes_in_place(), on the fake bus
+static void read_frame(gspi_fake_t *fake, uint8_t *dst, size_t len, size_t size) {
+    uint8_t *rx = cyw43_spi_buf_rx_prepare(dst, len, size, (uint8_t *)bounce);
+    cyw43_spi_op_t op;
+    cyw43_spi_op_init_read(&op, gspi_fake_make_cmd(false, true, GSPI_FUNC_WLAN, 0, len), rx, len);
+    gspi_fake_transfer_op(fake, &op);
+    cyw43_spi_buf_rx_finish(&copy_stats, true, dst, rx, len);
+}
+
+// Send and receive frames using buffers at the given offset into word aligned storage, and of the given size
+static void exchange_frames(gspi_fake_t *fake, uint offset, size_t size, uint32_t *tx_checksum, uint32_t *rx_checksum) {
+    static uint32_t storage[FRAME_WORDS + 1];
+    uint8_t *buf = (uint8_t *)storage + offset;
+    for (uint n = 0; n < COPY_TEST_FRAMES; n++) {
+        for (uint i = 0; i < ETH_FRAME_BYTES; i++) {
+            buf[i] = (uint8_t)(n + i * 7);
+        }
+        *tx_checksum = gspi_fake_checksum(*tx_checksum, buf, ETH_FRAME_BYTES);
+        write_frame(fake, buf, ETH_FRAME_BYTES, size);
+        read_frame(fake, buf, ETH_FRAME_BYTES, size);
+        *rx_checksum = gspi_fake_checksum(*rx_checksum, buf, ETH_FRAME_BYTES);
+    }
+}
+
+int main() {
+    stdio_init_all();
+
+    static gspi_fake_t fake;
+    uint32_t buf[16];
+
+    PICOTEST_START();
+
+    PICOTEST_START_SECTION("register access");
+        gspi_fake_init(&fake, &fake_config);
+        buf[0] = gspi_fake_make_cmd(false, true, GSPI_FUNC_BUS, GSPI_REG_TEST_RO, 4);
+        gspi_fake_transfer(&fake, NULL, 4, (uint8_t *)buf, 8);
+        PICOTEST_CHECK(buf[1] == GSPI_TEST_PATTERN, "wrong test register value");
+
+        // backplane reads have a response delay before the data
+        static const uint32_t pattern[4] = {0x11111111, 0x22222222, 0x33333333, 0x44444444};
+        buf[0] = gspi_fake_make_cmd(true, true, GSPI_FUNC_BACKPLANE, 0x100, sizeof(pattern));
+        memcpy(buf + 1, pattern, sizeof(pattern));
+        gspi_fake_transfer(&fake, (const uint8_t *)buf, 4 + sizeof(pattern), NULL, 0);
+        memset(buf, 0, sizeof(buf));
+        buf[0] = gspi_fake_make_cmd(false, true, GSPI_FUNC_BACKPLANE, 0x100, sizeof(pattern));
+        gspi_fake_transfer(&fake, NULL, 4, (uint8_t *)buf, 4 + GSPI_BACKPLANE_READ_PAD_BYTES + sizeof(pattern));
+        PICOTEST_CHECK(!memcmp(buf + 1 + GSPI_BACKPLANE_READ_PAD_BYTES / 4, pattern, sizeof(pattern)), "backplane mismatch");
+        PICOTEST_CHECK(fake.errors == 0, "protocol errors");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("queue order and full");
+        gspi_fake_init(&fake, &fake_config);
+        static uint32_t reads[CYW43_SPI_QUEUE_LENGTH][2];
+        completion_count = 0;
+        for (uint i = 0; i < CYW43_SPI_QUEUE_LENGTH; i++) {
+            reads[i][0] = gspi_fake_make_cmd(false, true, GSPI_FUNC_BUS, GSPI_REG_TEST_RO, 4);
+            PICOTEST_CHECK(gspi_fake_submit(&fake, NULL, 4, (uint8_t *)reads[i], 8, record_completion, (void *)(uintptr_t)i),
+                           "submit failed");
+        }
+        PICOTEST_CHECK(cyw43_spi_queue_is_full(&fake.queue), "queue should be full");
+        PICOTEST_CHECK(!gspi_fake_submit(&fake, NULL, 4, (uint8_t *)buf, 8, NULL, NULL), "submit to full queue succeeded");
+        PICOTEST_CHECK(completion_count == 0, "completed before time passed");
+        gspi_fake_wait(&fake);
+        PICOTEST_CHECK(completion_count == CYW43_SPI_QUEUE_LENGTH, "wrong completion count");
+        for (uint i = 0; i < completion_count; i++) {
+            PICOTEST_CHECK(completion_order[i] == i, "completed out of order");
+            PICOTEST_CHECK(reads[i][1] == GSPI_TEST_PATTERN, "wrong value read");
+        }
+        PICOTEST_CHECK(fake.queue.stats.full == 1, "full not counted");
+        PICOTEST_CHECK(fake.queue.stats.max_depth == CYW43_SPI_QUEUE_LENGTH, "wrong max depth");
+        PICOTEST_CHECK(fake.queue.stats.back_to_back == CYW43_SPI_QUEUE_LENGTH - 1, "wrong back to back count");
+        // back to back transfers leave no gap on the bus
+        PICOTEST_CHECK(fake.now_ns == fake.bus_busy_ns, "bus idle between queued transfers");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("copy counters");
+        uint32_t tx_checksum = GSPI_FAKE_CHECKSUM_INIT;
+        uint32_t rx_checksum = GSPI_FAKE_CHECKSUM_INIT;
+
+        // a payload two bytes into the buffer, as with an Ethernet header after ETH_PAD_SIZE, can't be used in place
+        gspi_fake_init(&fake, &fake_config);
+        memset(&copy_stats, 0, sizeof(copy_stats));
+        exchange_frames(&fake, 2, ETH_FRAME_BYTES, &tx_checksum, &rx_checksum);
+        PICOTEST_CHECK(fake.errors == 0, "protocol errors");
+        PICOTEST_CHECK(fake.frame_checksum == tx_checksum, "written frames corrupted");
+        PICOTEST_CHECK(fake.frame_read_checksum == rx_checksum, "read frames corrupted");
+        PICOTEST_CHECK(copy_stats.tx_frames == COPY_TEST_FRAMES && copy_stats.tx_copies == COPY_TEST_FRAMES, "tx copies not counted");
+        PICOTEST_CHECK(copy_stats.rx_frames == COPY_TEST_FRAMES && copy_stats.rx_copies == COPY_TEST_FRAMES, "rx copies not counted");
+        printf("unaligned buffers: %" PRIu32 "/%" PRIu32 " frames copied, %" PRIu64 " bytes\n",
+               copy_stats.tx_copies + copy_stats.rx_copies, copy_stats.tx_frames + copy_stats.rx_frames,
+               copy_stats.tx_copy_bytes + copy_stats.rx_copy_bytes);
+
+        // aligned, but without room to round the length up to whole words
+        gspi_fake_init(&fake, &fake_config);
+        memset(&copy_stats, 0, sizeof(copy_stats));
+        tx_checksum = rx_checksum = GSPI_FAKE_CHECKSUM_INIT;
+        exchange_frames(&fake, 0, ETH_FRAME_BYTES, &tx_checksum, &rx_checksum);
+        PICOTEST_CHECK(copy_stats.tx_copies == COPY_TEST_FRAMES && copy_stats.rx_copies == COPY_TEST_FRAMES, "short buffers not copied");
+
+        // buffers allocated as CYW43_SPI_BUFFER_SIZE(len), word aligned
+        gspi_fake_init(&fake, &fake_config);
+        memset(&copy_stats, 0, sizeof(copy_stats));
+        tx_checksum = rx_checksum = GSPI_FAKE_CHECKSUM_INIT;
+        exchange_frames(&fake, 0, CYW43_SPI_BUFFER_SIZE(ETH_FRAME_BYTES), &tx_checksum, &rx_checksum);
+        PICOTEST_CHECK(fake.errors == 0, "protocol errors");
+        PICOTEST_CHECK(fake.frame_checksum == tx_checksum, "written frames corrupted");
+        PICOTEST_CHECK(fake.frame_read_checksum == rx_checksum, "read frames corrupted");
+        PICOTEST_CHECK(copy_stats.tx_frames == COPY_TEST_FRAMES && copy_stats.rx_frames == COPY_TEST_FRAMES, "frames not counted");
+        PICOTEST_CHECK(copy_stats.tx_copies == 0 && copy_stats.rx_copies == 0, "suitable buffers were copied");
+        printf("in place buffers:  %" PRIu32 "/%" PRIu32 " frames copied, %" PRIu64 " bytes\n",
+               copy_stats.tx_copies + copy_stats.rx_copies, copy_stats.tx_frames + copy_stats.rx_frames,
+               copy_stats.tx_copy_bytes + copy_stats.rx_copy_bytes);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("frames per second");
+        uint32_t expected = GSPI_FAKE_CHECKSUM_INIT;
+        uint32_t polls = 0;
+        gspi_fake_init(&fake, &fake_config);
+        uint64_t sequential_ns = send_sequential(&fake, &expected, &polls);
+        PICOTEST_CHECK(fake.frames == FRAME_COUNT, "sequential: frames lost");
+        PICOTEST_CHECK(fake.frame_checksum == expected, "sequential: frame data mismatch");
+        PICOTEST_CHECK(fake.errors == 0, "sequential: protocol errors");
+        double sequential_fps = FRAME_COUNT * 1e9 / (double)sequential_ns;
+        printf("sequential: %d frames of %d bytes in %" PRIu64 "us, %.0f frames/s, bus %.0f%% busy, %" PRIu32 " status polls\n",
+               FRAME_COUNT, FRAME_BYTES, sequential_ns / 1000, sequential_fps, fake.bus_busy_ns * 100.0 / (double)sequential_ns, polls);
+
+        expected = GSPI_FAKE_CHECKSUM_INIT;
+        polls = 0;
+        gspi_fake_init(&fake, &fake_config);
+        uint64_t pipelined_ns = send_pipelined(&fake, &expected, &polls);
+        PICOTEST_CHECK(fake.frames == FRAME_COUNT, "pipelined: frames lost");
+        PICOTEST_CHECK(fake.frame_checksum == expected, "pipelined: frame data mismatch");
+        PICOTEST_CHECK(fake.errors == 0, "pipelined: protocol errors");
+        double pipelined_fps = FRAME_COUNT * 1e9 / (double)pipelined_ns;
+        printf("pipelined:  %d frames of %d bytes in %" PRIu64 "us, %.0f frames/s, bus %.0f%% busy, %" PRIu32 " status polls, max queue depth %d\n",
+               FRAME_COUNT, FRAME_BYTES, pipelined_ns / 1000, pipelined_fps, fake.bus_busy_ns * 100.0 / (double)pipelined_ns, polls,
+               fake.queue.stats.max_depth);
+        // the bus, not the stack, should now be the limit
+        PICOTEST_CHECK(pipelined_fps > sequential_fps * 1.1, "pipelining did not help");
+        PICOTEST_CHECK(fake.bus_busy_ns * 10 > pipelined_ns * 9, "bus less than 90% busy when pipelined");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/dma_memcpy.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("DMA memcpy", "DMA memcpy test");
+
+#define BUFFER_SIZE 5000
+#define GUARD 16
+#define QUEUED_OPS 32
+#define QUEUED_SIZE 1000
+#define CHAINED_PIECES 8
+
+static uint8_t __aligned(4) src_buffer[BUFFER_SIZE];
+static uint8_t __aligned(4) dst_buffer[BUFFER_SIZE + 2 * GUARD];
+static uint8_t __aligned(4) queued_dst[QUEUED_OPS][QUEUED_SIZE];
+
+static const size_t lengths[] = {0, 1, 3, 255, 256, 257, 1000, 4099};
+
+static uint32_t rand_state = 1;
+
+static uint32_t next_rand(void) {
+    // xorshift32
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static volatile uint callback_count;
+
+static void count_callback(dma_memcpy_op_t *op, void *user_data) {
+    // ops are done before their callback is called
+    if (op->done && user_data == op) {
+        __atomic_fetch_add(&callback_count, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+// checks the guard bytes around the destination are untouched
+static bool guards_intact(size_t offset, size_t len) {
+    for (size_t i = 0; i < GUARD + offset; i++) {
+        if (dst_buffer[i] != 0xa5) return false;
+    }
+    for (size_t i = GUARD + offset + len; i < sizeof(dst_buffer); i++) {
+        if (dst_buffer[i] != 0xa5) return false;
+    }
+    return true;
+}
+
+static bool test_copies(void) {
+    for (uint i = 0; i < BUFFER_SIZE; i++) src_buffer[i] = (uint8_t)next_rand();
+    for (uint src_offset = 0; src_offset < 4; src_offset++) {
+        for (uint dst_offset = 0; dst_offset < 4; dst_offset++) {
+            for (uint l = 0; l < count_of(lengths); l++) {
+                size_t len = lengths[l];
+                memset(dst_buffer, 0xa5, sizeof(dst_buffer));
+                dma_memcpy_op_t op;
+                callback_count = 0;
+                dma_memcpy_async(&op, dst_buffer + GUARD + dst_offset, src_buffer + src_offset, len, count_callback,
+                                 &op);
+                dma_memcpy_op_wait(&op);
+                dma_memcpy_wait_all();
+                if (memcmp(dst_buffer + GUARD + dst_offset, src_buffer + src_offset, len) ||
+                    !guards_intact(dst_offset, len) || callback_count != 1) {
+                    printf("copy of %u bytes from offset %u to offset %u failed\n", (uint)len, src_offset, dst_offset);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool test_fills(void) {
+    for (uint dst_offset = 0; dst_offset < 4; dst_offset++) {
+        for (uint l = 0; l < count_of(lengths); l++) {
+            size_t len = lengths[l];
+            memset(dst_buffer, 0xa5, sizeof(dst_buffer));
+            dma_memcpy_op_t op;
+            callback_count = 0;
+            dma_memset_async(&op, dst_buffer + GUARD + dst_offset, 0x15a, len, count_callback, &op);
+            dma_memcpy_op_wait(&op);
+            dma_memcpy_wait_all();
+            bool ok = guards_intact(dst_offset, len) && callback_count == 1;
+            for (size_t i = 0; i < len; i++) ok &= dst_buffer[GUARD + dst_offset + i] == 0x5a;
+            if (!ok) {
+                printf("fill of %u bytes at offset %u failed\n", (uint)len, dst_offset);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+typedef struct {
+    dma_memcpy_op_t op;
+    uint pieces_done;
+} chained_copy_t;
+
+// copies the next piece of src_buffer to dst_buffer with the same op, until all the pieces are done
+static void chain_callback(dma_memcpy_op_t *op, void *user_data) {
+    chained_copy_t *copy = (chained_copy_t *)user_data;
+    uint piece = ++copy->pieces_done;
+    if (piece < CHAINED_PIECES) {
+        size_t piece_size = BUFFER_SIZE / CHAINED_PIECES;
+        dma_memcpy_async(op, dst_buffer + piece * piece_size, src_buffer + piece * piece_size, piece_size,
+                         chain_callback, copy);
+    }
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    PICOTEST_START_SECTION("init");
+        PICOTEST_CHECK(dma_memcpy_init(2), "dma_memcpy_init failed");
+        PICOTEST_CHECK(!dma_memcpy_init(1), "initialised twice");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("copies");
+        PICOTEST_CHECK(test_copies(), "copy failed");
+        dma_memcpy_set_min_size(0);
+        PICOTEST_CHECK(test_copies(), "copy by DMA only failed");
+        dma_memcpy_set_min_size(PICO_DMA_MEMCPY_MIN_SIZE);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("fills");
+        PICOTEST_CHECK(test_fills(), "fill failed");
+        dma_memcpy_set_min_size(0);
+        PICOTEST_CHECK(test_fills(), "fill by DMA only failed");
+        dma_memcpy_set_min_size(PICO_DMA_MEMCPY_MIN_SIZE);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("small operations are done straight away");
+        dma_memcpy_op_t op;
+        callback_count = 0;
+        dma_memcpy_async(&op, dst_buffer, src_buffer, PICO_DMA_MEMCPY_MIN_SIZE - 1, count_callback, &op);
+        PICOTEST_CHECK(dma_memcpy_op_is_done(&op) && callback_count == 1, "small copy not done on return");
+        dma_memset_async(&op, dst_buffer, 0, PICO_DMA_MEMCPY_MIN_SIZE - 1, count_callback, &op);
+        PICOTEST_CHECK(dma_memcpy_op_is_done(&op) && callback_count == 2, "small fill not done on return");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("queued operations");
+        static dma_memcpy_op_t ops[QUEUED_OPS];
+        callback_count = 0;
+        // more operations than channels, which are queued until a channel is free
+        for (uint i = 0; i < QUEUED_OPS; i++) {
+            if (i & 1) {
+                dma_memset_async(&ops[i], queued_dst[i], (int)i, QUEUED_SIZE - i, count_callback, &ops[i]);
+            } else {
+                dma_memcpy_async(&ops[i], queued_dst[i], src_buffer + i, QUEUED_SIZE - i, count_callback, &ops[i]);
+            }
+        }
+        dma_memcpy_wait_all();
+        bool ok = callback_count == QUEUED_OPS;
+        for (uint i = 0; i < QUEUED_OPS; i++) {
+            ok &= dma_memcpy_op_is_done(&ops[i]);
+            if (i & 1) {
+                for (uint j = 0; j < QUEUED_SIZE - i; j++) ok &= queued_dst[i][j] == i;
+            } else {
+                ok &= !memcmp(queued_dst[i], src_buffer + i, QUEUED_SIZE - i);
+            }
+        }
+        PICOTEST_CHECK(ok, "queued operations failed");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("operations started from callbacks");
+        static chained_copy_t copy;
+        size_t piece_size = BUFFER_SIZE / CHAINED_PIECES;
+        memset(dst_buffer, 0, sizeof(dst_buffer));
+        copy.pieces_done = 0;
+        dma_memcpy_async(&copy.op, dst_buffer, src_buffer, piece_size, chain_callback, &copy);
+        // waits for the operations started by the callbacks too
+        dma_memcpy_wait_all();
+        PICOTEST_CHECK(copy.pieces_done == CHAINED_PIECES &&
+                       !memcmp(dst_buffer, src_buffer, piece_size * CHAINED_PIECES), "chained copy failed");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("deinit");
+        dma_memcpy_deinit();
+        PICOTEST_CHECK(dma_memcpy_init(1), "dma_memcpy_init after deinit failed");
+        PICOTEST_CHECK(test_copies(), "copy with one channel failed");
+        dma_memcpy_deinit();
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "pico/stdlib.h"
+#include "pico/dma_sg_sim.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("DMA_SG", "dma scatter-gather descriptor test");
+
+#define CTRL_CHAN 4
+#define DATA_CHAN 5
+#define TREQ_TEST 3
+
+static uint32_t irq_count;
+static uint32_t irq_finished;
+static uint last_irq_index;
+
+static void record_irq(uint desc_index, __unused uint64_t cycle, bool finished, __unused void *user_data) {
+    irq_count++;
+    if (finished) irq_finished++;
+    last_irq_index = desc_index;
+}
+
+static uint32_t treq_period(uint treq, __unused void *user_data) {
+    return treq == TREQ_TEST ? 8 : 0;
+}
+
+int main() {
+    stdio_init_all();
+
+    static uint8_t src_a[13];
+    static uint16_t src_b[7];
+    static uint32_t src_c[5];
+    // segments at offsets 0, 14 and 28 (13, 14 and 20 bytes, with a one byte gap after the first)
+    static uint8_t __aligned(4) dst[28 + 20];
+    static uint32_t ring[4];
+    static dma_sg_desc_t descs[8];
+    dma_sg_list_t list;
+
+    for (uint i = 0; i < count_of(src_a); i++) src_a[i] = (uint8_t)(i + 1);
+    for (uint i = 0; i < count_of(src_b); i++) src_b[i] = (uint16_t)(0x100 * (i + 1) + i);
+    for (uint i = 0; i < count_of(src_c); i++) src_c[i] = 0x01020304u * (i + 1);
+
+    uint32_t ctrl8 = dma_sg_make_ctrl(0, true, true, DMA_CH0_CTRL_TRIG_TREQ_SEL_VALUE_PERMANENT);
+    uint32_t ctrl16 = dma_sg_make_ctrl(1, true, true, DMA_CH0_CTRL_TRIG_TREQ_SEL_VALUE_PERMANENT);
+    uint32_t ctrl32 = dma_sg_make_ctrl(2, true, true, TREQ_TEST);
+
+    PICOTEST_START();
+
+    PICOTEST_START_SECTION("gather");
+        dma_sg_list_init(&list, descs, count_of(descs), CTRL_CHAN, DATA_CHAN);
+        PICOTEST_CHECK(dma_sg_list_add(&list, dst, src_a, count_of(src_a), ctrl8, false) == 0, "bad index");
+        PICOTEST_CHECK(dma_sg_list_add(&list, dst + 14, src_b, count_of(src_b), ctrl16, true) == 1, "bad index");
+        PICOTEST_CHECK(dma_sg_list_add(&list, dst + 28, src_c, count_of(src_c), ctrl32, false) == 2, "bad index");
+        dma_sg_list_end(&list, true);
+        PICOTEST_CHECK(dma_sg_list_get_byte_count(&list) == 13 + 14 + 20, "wrong byte count");
+        PICOTEST_CHECK(dma_sg_sim_validate(&list) == DMA_SG_SIM_OK, "list did not validate");
+
+        dma_sg_sim_config_t config = dma_sg_sim_get_default_config();
+        config.irq_handler = record_irq;
+        config.treq_period = treq_period;
+        dma_sg_sim_result_t result;
+        memset(dst, 0, sizeof(dst));
+        irq_count = irq_finished = 0;
+        PICOTEST_CHECK(dma_sg_sim_run(&list, &config, &result) == DMA_SG_SIM_OK, "chain did not complete");
+        PICOTEST_CHECK(!memcmp(dst, src_a, sizeof(src_a)), "segment 0 mismatch");
+        PICOTEST_CHECK(!memcmp(dst + 14, src_b, sizeof(src_b)), "segment 1 mismatch");
+        PICOTEST_CHECK(!memcmp(dst + 28, src_c, sizeof(src_c)), "segment 2 mismatch");
+        PICOTEST_CHECK(dst[13] == 0, "gap overwritten");
+        PICOTEST_CHECK(result.descriptors == 4, "wrong descriptor count");
+        PICOTEST_CHECK(result.bytes == 13 + 14 + 20, "wrong byte count");
+        PICOTEST_CHECK(irq_count == 2 && irq_finished == 1 && last_irq_index == 3, "wrong irqs");
+        // 13 + 7 unpaced transfers, 5 paced at 8 cycles, 4 descriptor loads at 6 cycles
+        PICOTEST_CHECK(result.cycles == 13 + 7 + 5 * 8 + 4 * 6, "wrong cycle count");
+        printf("  %" PRIu64 " bytes in %" PRIu64 " cycles\n", result.bytes, result.cycles);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("loop");
+        // a four word write ring fed from the same source forever
+        uint32_t ring_ctrl = dma_sg_make_ctrl(2, true, true, DMA_CH0_CTRL_TRIG_TREQ_SEL_VALUE_PERMANENT) |
+                             DMA_CH0_CTRL_TRIG_RING_SEL_BITS | (4u << DMA_CH0_CTRL_TRIG_RING_SIZE_LSB);
+        static uint32_t __aligned(16) ring_dst[4];
+        dma_sg_list_init(&list, descs, count_of(descs), CTRL_CHAN, DATA_CHAN);
+        dma_sg_list_add(&list, ring, src_c, 2, ctrl32, false);
+        dma_sg_list_add(&list, ring_dst, src_c, 5, ring_ctrl, true);
+        dma_sg_list_loop(&list, 1);
+        PICOTEST_CHECK(list.loops, "list should loop");
+        PICOTEST_CHECK(dma_sg_sim_validate(&list) == DMA_SG_SIM_OK, "looping list did not validate");
+
+        dma_sg_sim_config_t config = dma_sg_sim_get_default_config();
+        config.max_descriptors = 9;
+        config.irq_handler = record_irq;
+        dma_sg_sim_result_t result;
+        irq_count = irq_finished = 0;
+        PICOTEST_CHECK(dma_sg_sim_run(&list, &config, &result) == DMA_SG_SIM_LIMIT_REACHED, "loop should hit the limit");
+        // first descriptor, then 4 x (ring segment + jump)
+        PICOTEST_CHECK(result.jumps == 4, "wrong jump count");
+        PICOTEST_CHECK(irq_count == 4 && !irq_finished, "wrong irqs");
+        PICOTEST_CHECK(ring[0] == src_c[0] && ring[1] == src_c[1], "first segment mismatch");
+        // 5 words into a 4 word ring; the 5th wraps back onto the first
+        PICOTEST_CHECK(ring_dst[0] == src_c[4] && ring_dst[3] == src_c[3], "ring wrap mismatch");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("validation");
+        dma_sg_list_init(&list, descs, count_of(descs), CTRL_CHAN, DATA_CHAN);
+        dma_sg_list_add(&list, dst, src_a, 4, ctrl8, false);
+        PICOTEST_CHECK(dma_sg_sim_validate(&list) == DMA_SG_SIM_ERR_NOT_TERMINATED, "unterminated list accepted");
+        dma_sg_list_add(&list, dst + 1, src_c, 1, ctrl32, false);
+        dma_sg_list_end(&list, false);
+        dma_sg_sim_result_t result;
+        dma_sg_sim_config_t config = dma_sg_sim_get_default_config();
+        config.execute = false;
+        PICOTEST_CHECK(dma_sg_sim_run(&list, &config, &result) == DMA_SG_SIM_ERR_MISALIGNED && result.error_index == 1,
+                       "misaligned write accepted");
+        descs[1].write_addr = (uintptr_t)src_c;
+        descs[1].ctrl &= ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS;
+        PICOTEST_CHECK(dma_sg_sim_validate(&list) == DMA_SG_SIM_ERR_BAD_CHAIN, "broken chain accepted");
+
+        dma_sg_list_init(&list, descs, 3, CTRL_CHAN, DATA_CHAN);
+        PICOTEST_CHECK(dma_sg_list_add(&list, dst, src_a, 1, ctrl8, false) == 0, "add failed");
+        PICOTEST_CHECK(dma_sg_list_add(&list, dst, src_a, 1, ctrl8, false) == 1, "add failed");
+        PICOTEST_CHECK(dma_sg_list_add(&list, dst, src_a, 1, ctrl8, false) == -1, "terminator slot used");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
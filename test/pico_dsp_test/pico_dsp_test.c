@@ -0,0 +1,481 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#if !PICO_ON_DEVICE
+#include <time.h>
+#endif
+
+#include "pico/stdlib.h"
+#include "pico/dsp.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("DSP", "DSP kernels test");
+
+#define SIGNAL_LENGTH 500
+#define MAX_TAPS 32
+#define MAX_BLOCK 64
+#define MAX_STAGES 3
+#define DFT_MAX_LENGTH 1024
+#define BENCH_LENGTH 1024
+#define BENCH_ITERATIONS 20
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static q15_t a15[SIGNAL_LENGTH], b15[SIGNAL_LENGTH], out15[SIGNAL_LENGTH], ref15[SIGNAL_LENGTH];
+static q31_t a31[SIGNAL_LENGTH], b31[SIGNAL_LENGTH], out31[SIGNAL_LENGTH], ref31[SIGNAL_LENGTH];
+static q15_t fir_state15[DSP_FIR_STATE_SIZE(MAX_TAPS, MAX_BLOCK)];
+static q31_t fir_state31[DSP_FIR_STATE_SIZE(MAX_TAPS, MAX_BLOCK)];
+static q15_t biquad_state15[MAX_STAGES * DSP_BIQUAD_STATE_PER_STAGE];
+static q31_t biquad_state31[MAX_STAGES * DSP_BIQUAD_STATE_PER_STAGE];
+
+static q15_t fft15[2 * DSP_FFT_MAX_LENGTH] __attribute__((aligned(4)));
+static q31_t fft31[2 * DSP_FFT_MAX_LENGTH];
+static q31_t fft_in31[2 * DSP_FFT_MAX_LENGTH];
+static double dft_cos[DFT_MAX_LENGTH], dft_sin[DFT_MAX_LENGTH];
+
+static float bench_a[BENCH_LENGTH], bench_b[BENCH_LENGTH], bench_out[BENCH_LENGTH];
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+    // xorshift32
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+// a random value of at most max_bits bits (including the sign)
+static int32_t rand_bits(uint max_bits) {
+    return (int32_t)next_rand() >> (32 - max_bits);
+}
+
+static void fill_q15(q15_t *buf, uint count, uint bits) {
+    for (uint i = 0; i < count; i++) buf[i] = (q15_t)rand_bits(bits);
+}
+
+static void fill_q31(q31_t *buf, uint count, uint bits) {
+    for (uint i = 0; i < count; i++) buf[i] = rand_bits(bits);
+}
+
+// a block size from 1 to MAX_BLOCK, but no more than remaining
+static uint random_block_size(uint remaining) {
+    uint count = 1 + next_rand() % MAX_BLOCK;
+    return MIN(count, remaining);
+}
+
+static bool check_dot(void) {
+    for (uint count = 0; count < 40; count++) {
+        fill_q15(a15, count, 16);
+        fill_q15(b15, count, 16);
+        fill_q31(a31, count, 32);
+        fill_q31(b31, count, 32);
+        int64_t ref = 0, ref31 = 0;
+        for (uint i = 0; i < count; i++) {
+            ref += a15[i] * b15[i];
+            ref31 += ((int64_t)a31[i] * b31[i]) >> 14;
+        }
+        if (dsp_dot_q15(a15, b15, count) != ref || dsp_dot_q31(a31, b31, count) != ref31) {
+            printf("dot product wrong for count %u\n", count);
+            return false;
+        }
+    }
+    // the largest products
+    for (uint i = 0; i < SIGNAL_LENGTH; i++) a15[i] = INT16_MIN;
+    return dsp_dot_q15(a15, a15, SIGNAL_LENGTH) == SIGNAL_LENGTH * (int64_t)0x40000000;
+}
+
+static bool check_scale(void) {
+    fill_q15(a15, SIGNAL_LENGTH, 16);
+    fill_q31(a31, SIGNAL_LENGTH, 32);
+    for (uint shift = 0; shift < 16; shift += 3) {
+        q15_t scale = (q15_t)rand_bits(16);
+        q31_t scale31 = rand_bits(32);
+        // odd counts exercise the tails, and in place operation must work. The element after the last one scaled is
+        // checked to be untouched
+        uint count = SIGNAL_LENGTH - 1 - shift;
+        memcpy(out15, a15, sizeof(a15));
+        memcpy(out31, a31, sizeof(a31));
+        dsp_scale_q15(out15, out15, count, scale, shift);
+        dsp_scale_q31(out31, out31, count, scale31, shift);
+        for (uint i = 0; i < count; i++) {
+            if (out15[i] != dsp_sat_q15((a15[i] * scale) >> (15 - shift)) ||
+                out31[i] != dsp_sat_q31(((int64_t)a31[i] * scale31) >> (31 - shift))) {
+                printf("scale wrong for shift %u at %u\n", shift, i);
+                return false;
+            }
+        }
+        if (out15[count] != a15[count] || out31[count] != a31[count]) return false;
+    }
+    return true;
+}
+
+static bool check_div(void) {
+    static const struct {
+        q15_t num, den, result;
+    } cases15[] = {
+        { 0x2000, 0x4000, 0x4000 },
+        { -0x2000, 0x4000, -0x4000 },
+        { 0x1000, -0x3000, -0x2aaa },
+        { 0x4000, 0x2000, INT16_MAX },
+        { -0x4000, 0x2000, INT16_MIN },
+        { INT16_MIN, INT16_MIN, INT16_MAX },
+        { 100, 0, INT16_MAX },
+        { -100, 0, INT16_MIN },
+        { 0, 0, 0 },
+    };
+    for (uint i = 0; i < count_of(cases15); i++) {
+        if (dsp_div_q15(cases15[i].num, cases15[i].den) != cases15[i].result) {
+            printf("dsp_div_q15(%d, %d) = %d\n", cases15[i].num, cases15[i].den,
+                   dsp_div_q15(cases15[i].num, cases15[i].den));
+            return false;
+        }
+    }
+    return dsp_div_q31(0x20000000, 0x40000000) == 0x40000000 &&
+           dsp_div_q31(0x10000000, -0x30000000) == -0x2aaaaaaa &&
+           dsp_div_q31(INT32_MIN, INT32_MIN) == INT32_MAX &&
+           dsp_div_q31(-1, 0) == INT32_MIN;
+}
+
+static bool check_fir(uint num_taps) {
+    q15_t coeffs15[MAX_TAPS];
+    q31_t coeffs31[MAX_TAPS];
+    fill_q15(coeffs15, num_taps, 16);
+    // keep the Q31 sums in range, so that the reference doesn't need to wrap
+    fill_q31(coeffs31, num_taps, 27);
+    fill_q15(a15, SIGNAL_LENGTH, 16);
+    fill_q31(a31, SIGNAL_LENGTH, 32);
+    for (uint n = 0; n < SIGNAL_LENGTH; n++) {
+        int64_t acc = 0, acc31 = 0;
+        for (uint k = 0; k < num_taps && k <= n; k++) {
+            acc += coeffs15[k] * a15[n - k];
+            acc31 += (int64_t)coeffs31[k] * a31[n - k];
+        }
+        ref15[n] = dsp_sat_q15((int32_t)(acc >> 15));
+        ref31[n] = dsp_sat_q31(acc31 >> 31);
+    }
+    dsp_fir_q15_t fir15;
+    dsp_fir_q31_t fir31;
+    dsp_fir_q15_init(&fir15, coeffs15, num_taps, fir_state15, MAX_BLOCK);
+    dsp_fir_q31_init(&fir31, coeffs31, num_taps, fir_state31, MAX_BLOCK);
+    // blocks of varying size, carrying the history from one to the next
+    for (uint n = 0; n < SIGNAL_LENGTH;) {
+        uint count = random_block_size(SIGNAL_LENGTH - n);
+        dsp_fir_q15(&fir15, out15 + n, a15 + n, count);
+        dsp_fir_q31(&fir31, out31 + n, a31 + n, count);
+        n += count;
+    }
+    if (memcmp(out15, ref15, sizeof(ref15)) || memcmp(out31, ref31, sizeof(ref31))) {
+        printf("FIR wrong with %u taps\n", num_taps);
+        return false;
+    }
+    return true;
+}
+
+static bool check_biquad(uint num_stages, uint post_shift) {
+    // second order low pass sections (b0, b1, b2, -a1, -a2), converted to Q14 (so used with post_shift 1); with
+    // post_shift 0 they are effectively halved, which leaves them stable
+    static const double sections[MAX_STAGES][DSP_BIQUAD_COEFFS_PER_STAGE] = {
+        { 0.0675, 0.1349, 0.0675, 1.1430, -0.4128 },
+        { 0.2066, 0.4131, 0.2066, 0.3695, -0.1958 },
+        { 0.0200, 0.0400, 0.0200, 1.5610, -0.6414 },
+    };
+    q15_t coeffs15[MAX_STAGES * DSP_BIQUAD_COEFFS_PER_STAGE];
+    q31_t coeffs31[MAX_STAGES * DSP_BIQUAD_COEFFS_PER_STAGE];
+    for (uint i = 0; i < num_stages * DSP_BIQUAD_COEFFS_PER_STAGE; i++) {
+        double c = sections[i / DSP_BIQUAD_COEFFS_PER_STAGE][i % DSP_BIQUAD_COEFFS_PER_STAGE];
+        coeffs15[i] = (q15_t)lround(c * 16384);
+        coeffs31[i] = coeffs15[i] * 65536;
+    }
+    fill_q15(a15, SIGNAL_LENGTH, 16);
+    fill_q31(a31, SIGNAL_LENGTH, 32);
+    memcpy(ref15, a15, sizeof(ref15));
+    memcpy(ref31, a31, sizeof(ref31));
+    for (uint s = 0; s < num_stages; s++) {
+        const q15_t *c15 = coeffs15 + s * DSP_BIQUAD_COEFFS_PER_STAGE;
+        const q31_t *c31 = coeffs31 + s * DSP_BIQUAD_COEFFS_PER_STAGE;
+        int32_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        int32_t x1_31 = 0, x2_31 = 0, y1_31 = 0, y2_31 = 0;
+        for (uint n = 0; n < SIGNAL_LENGTH; n++) {
+            int32_t x = ref15[n];
+            int64_t acc = (int64_t)c15[0] * x + c15[1] * x1 + c15[2] * x2 + c15[3] * y1 + c15[4] * y2;
+            int32_t y = dsp_sat_q15((int32_t)(acc >> (15 - post_shift)));
+            x2 = x1; x1 = x; y2 = y1; y1 = y;
+            ref15[n] = (q15_t)y;
+
+            x = ref31[n];
+            acc = (int64_t)c31[0] * x + (int64_t)c31[1] * x1_31 + (int64_t)c31[2] * x2_31 +
+                  (int64_t)c31[3] * y1_31 + (int64_t)c31[4] * y2_31;
+            y = dsp_sat_q31(acc >> (31 - post_shift));
+            x2_31 = x1_31; x1_31 = x; y2_31 = y1_31; y1_31 = y;
+            ref31[n] = y;
+        }
+    }
+    dsp_biquad_q15_t biquad15;
+    dsp_biquad_q31_t biquad31;
+    dsp_biquad_q15_init(&biquad15, num_stages, coeffs15, biquad_state15, post_shift);
+    dsp_biquad_q31_init(&biquad31, num_stages, coeffs31, biquad_state31, post_shift);
+    for (uint n = 0; n < SIGNAL_LENGTH;) {
+        uint count = random_block_size(SIGNAL_LENGTH - n);
+        dsp_biquad_q15(&biquad15, out15 + n, a15 + n, count);
+        // in place
+        memcpy(out31 + n, a31 + n, count * sizeof(q31_t));
+        dsp_biquad_q31(&biquad31, out31 + n, out31 + n, count);
+        n += count;
+    }
+    if (memcmp(out15, ref15, sizeof(ref15)) || memcmp(out31, ref31, sizeof(ref31))) {
+        printf("biquad wrong with %u stages, post_shift %u\n", num_stages, post_shift);
+        return false;
+    }
+    return true;
+}
+
+// Largest difference (in units of 2^-31) between the FFT in fft31 (or fft15) and the DFT of fft_in31 divided by length
+static double fft_error(uint length, bool inverse, bool q15) {
+    for (uint k = 0; k < length; k++) {
+        dft_cos[k] = cos(2 * M_PI * k / length);
+        dft_sin[k] = (inverse ? 1 : -1) * sin(2 * M_PI * k / length);
+    }
+    double max_error = 0;
+    for (uint k = 0; k < length; k++) {
+        double re = 0, im = 0;
+        for (uint n = 0; n < length; n++) {
+            uint t = (n * k) % length;
+            double xr = fft_in31[2 * n], xi = fft_in31[2 * n + 1];
+            re += xr * dft_cos[t] - xi * dft_sin[t];
+            im += xr * dft_sin[t] + xi * dft_cos[t];
+        }
+        double out_re = q15 ? fft15[2 * k] * 65536.0 : fft31[2 * k];
+        double out_im = q15 ? fft15[2 * k + 1] * 65536.0 : fft31[2 * k + 1];
+        max_error = MAX(max_error, MAX(fabs(out_re - re / length), fabs(out_im - im / length)));
+    }
+    return max_error;
+}
+
+static bool check_fft(uint length, bool inverse) {
+    // Q15 inputs are the Q31 ones rounded down, so the same reference serves both
+    for (uint i = 0; i < 2 * length; i++) {
+        fft15[i] = (q15_t)rand_bits(16);
+        fft_in31[i] = fft31[i] = fft15[i] * 65536;
+    }
+    dsp_fft_q15(fft15, length, inverse);
+    dsp_fft_q31(fft31, length, inverse);
+    // a stage is rounded down by at most 1.5 units, and has a twiddle error of about half a unit
+    uint stages = 0;
+    for (uint n = length; n > 1; n >>= 2) stages++;
+    double error15 = fft_error(length, inverse, true) / 65536.0;
+    double error31 = fft_error(length, inverse, false);
+    if (error15 > 2.0 * stages || error31 > 2.0 * stages) {
+        printf("FFT of length %u (inverse %d) has error %.2f Q15, %.2f Q31 units\n", length, inverse, error15,
+               error31);
+        return false;
+    }
+    return true;
+}
+
+static bool check_fft_round_trip(void) {
+    // forward then inverse is the input divided by the length
+    for (uint i = 0; i < 2 * DSP_FFT_MAX_LENGTH; i++) {
+        fft_in31[i] = fft31[i] = rand_bits(32);
+    }
+    dsp_fft_q31(fft31, DSP_FFT_MAX_LENGTH, false);
+    dsp_fft_q31(fft31, DSP_FFT_MAX_LENGTH, true);
+    for (uint i = 0; i < 2 * DSP_FFT_MAX_LENGTH; i++) {
+        if (abs(fft31[i] - fft_in31[i] / DSP_FFT_MAX_LENGTH) > 12) {
+            printf("FFT round trip differs at %u: %d %d\n", i, fft31[i], fft_in31[i] / DSP_FFT_MAX_LENGTH);
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t hash(uint32_t h, const void *data, size_t size) {
+    // FNV-1a
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ ((const uint8_t *)data)[i]) * 16777619u;
+    }
+    return h;
+}
+
+static uint32_t fft_hash(void) {
+    // the rounding of every SIMD and portable C path is the same, so this is the same whichever is built
+    rand_state = 0x5eed;
+    uint32_t h = 2166136261u;
+    for (uint length = 4; length <= DSP_FFT_MAX_LENGTH; length *= 4) {
+        for (uint inverse = 0; inverse < 2; inverse++) {
+            fill_q15(fft15, 2 * length, 16);
+            fill_q31(fft31, 2 * length, 32);
+            dsp_fft_q15(fft15, length, inverse);
+            dsp_fft_q31(fft31, length, inverse);
+            h = hash(h, fft15, 2 * length * sizeof(q15_t));
+            h = hash(h, fft31, 2 * length * sizeof(q31_t));
+        }
+    }
+    return h;
+}
+
+static uint64_t time_ns(void) {
+#if PICO_ON_DEVICE
+    return time_us_64() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static volatile int64_t bench_sink;
+static volatile float bench_sink_f;
+
+static void bench_dot_q15(void) {
+    bench_sink = dsp_dot_q15(fft15, fft15 + BENCH_LENGTH, BENCH_LENGTH);
+}
+
+static void bench_dot_float(void) {
+    float acc = 0;
+    for (uint i = 0; i < BENCH_LENGTH; i++) acc += bench_a[i] * bench_b[i];
+    bench_sink_f = acc;
+}
+
+static void bench_fir_q15(void) {
+    static const q15_t coeffs[MAX_TAPS] = { 0x1000 };
+    dsp_fir_q15_t fir;
+    dsp_fir_q15_init(&fir, coeffs, MAX_TAPS, fir_state15, MAX_BLOCK);
+    for (uint n = 0; n < BENCH_LENGTH; n += MAX_BLOCK) {
+        dsp_fir_q15(&fir, fft15 + BENCH_LENGTH + n, fft15 + n, MAX_BLOCK);
+    }
+}
+
+static void bench_fir_q31(void) {
+    static const q31_t coeffs[MAX_TAPS] = { 0x10000000 };
+    dsp_fir_q31_t fir;
+    dsp_fir_q31_init(&fir, coeffs, MAX_TAPS, fir_state31, MAX_BLOCK);
+    for (uint n = 0; n < BENCH_LENGTH; n += MAX_BLOCK) {
+        dsp_fir_q31(&fir, fft31 + BENCH_LENGTH + n, fft31 + n, MAX_BLOCK);
+    }
+}
+
+static void bench_fir_float(void) {
+    static const float coeffs[MAX_TAPS] = { 0.125f };
+    for (uint n = MAX_TAPS - 1; n < BENCH_LENGTH; n++) {
+        float acc = 0;
+        for (uint k = 0; k < MAX_TAPS; k++) acc += coeffs[k] * bench_a[n - k];
+        bench_out[n] = acc;
+    }
+    bench_sink_f = bench_out[BENCH_LENGTH - 1];
+}
+
+static void bench_biquad_q15(void) {
+    static const q15_t coeffs[DSP_BIQUAD_COEFFS_PER_STAGE] = { 0x0452, 0x08a5, 0x0452, 0x4927, -0x1a6b };
+    dsp_biquad_q15_t biquad;
+    dsp_biquad_q15_init(&biquad, 1, coeffs, biquad_state15, 1);
+    dsp_biquad_q15(&biquad, fft15 + BENCH_LENGTH, fft15, BENCH_LENGTH);
+}
+
+static void bench_biquad_float(void) {
+    static const float c[DSP_BIQUAD_COEFFS_PER_STAGE] = { 0.0675f, 0.1349f, 0.0675f, 1.1430f, -0.4128f };
+    float x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    for (uint n = 0; n < BENCH_LENGTH; n++) {
+        float x = bench_a[n];
+        float y = c[0] * x + c[1] * x1 + c[2] * x2 + c[3] * y1 + c[4] * y2;
+        x2 = x1; x1 = x; y2 = y1; y1 = y;
+        bench_out[n] = y;
+    }
+    bench_sink_f = bench_out[BENCH_LENGTH - 1];
+}
+
+static void bench_fft_q15(void) {
+    dsp_fft_q15(fft15, BENCH_LENGTH, false);
+}
+
+static void bench_fft_q31(void) {
+    dsp_fft_q31(fft31, BENCH_LENGTH, false);
+}
+
+typedef struct {
+    const char *name;
+    void (*func)(void);
+} benchmark_t;
+
+static const benchmark_t benchmarks[] = {
+    { "dot q15", bench_dot_q15 },
+    { "dot float", bench_dot_float },
+    { "fir q15", bench_fir_q15 },
+    { "fir q31", bench_fir_q31 },
+    { "fir float", bench_fir_float },
+    { "biquad q15", bench_biquad_q15 },
+    { "biquad float", bench_biquad_float },
+    { "fft q15", bench_fft_q15 },
+    { "fft q31", bench_fft_q31 },
+};
+
+static void run_benchmark(const benchmark_t *benchmark) {
+    uint64_t start = time_ns();
+    for (uint i = 0; i < BENCH_ITERATIONS; i++) {
+        benchmark->func();
+    }
+    printf("%-12s %7.1f ns per sample\n", benchmark->name,
+           (double)(time_ns() - start) / ((double)BENCH_ITERATIONS * BENCH_LENGTH));
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    rand_state = 0x12345678;
+
+    PICOTEST_START_SECTION("dot product");
+        PICOTEST_CHECK(check_dot(), "dot product differs from reference");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("scale");
+        PICOTEST_CHECK(check_scale(), "scale differs from reference");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("divide");
+        PICOTEST_CHECK(check_div(), "division wrong");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("FIR");
+        PICOTEST_CHECK(check_fir(1), "1 tap FIR differs from reference");
+        PICOTEST_CHECK(check_fir(7), "7 tap FIR differs from reference");
+        PICOTEST_CHECK(check_fir(MAX_TAPS), "32 tap FIR differs from reference");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("biquad");
+        PICOTEST_CHECK(check_biquad(1, 0), "1 stage biquad differs from reference");
+        PICOTEST_CHECK(check_biquad(MAX_STAGES, 1), "3 stage biquad differs from reference");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("FFT");
+        for (uint length = 4; length <= DFT_MAX_LENGTH; length *= 4) {
+            PICOTEST_CHECK(check_fft(length, false), "FFT differs from DFT");
+            PICOTEST_CHECK(check_fft(length, true), "inverse FFT differs from DFT");
+        }
+        PICOTEST_CHECK(check_fft_round_trip(), "FFT round trip failed");
+        uint32_t h = fft_hash();
+        PICOTEST_CHECK(h == 0x6353863b, "FFT output changed");
+    PICOTEST_END_SECTION();
+
+    for (uint i = 0; i < 2 * BENCH_LENGTH; i++) fft15[i] = (q15_t)rand_bits(12);
+    for (uint i = 0; i < 2 * BENCH_LENGTH; i++) fft31[i] = rand_bits(28);
+    for (uint i = 0; i < BENCH_LENGTH; i++) {
+        bench_a[i] = (float)rand_bits(16) / 32768.0f;
+        bench_b[i] = (float)rand_bits(16) / 32768.0f;
+    }
+    for (uint b = 0; b < count_of(benchmarks); b++) {
+        run_benchmark(&benchmarks[b]);
+    }
+
+    PICOTEST_END_TEST();
+}
@@ -0,0 +1,395 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#if !PICO_ON_DEVICE
+#include <time.h>
+#endif
+
+#include "pico/stdlib.h"
+#include "pico/interp_kernels.h"
+#include "hardware/interp.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("INTERP_KERNELS", "Interpolator kernels test");
+
+#define MAX_COUNT 600
+#define BENCH_COUNT 4096
+#define BENCH_ITERATIONS 50
+
+static uint8_t indices[MAX_COUNT + 4];
+static uint32_t table32[256];
+static uint8_t texture[64 * 32 * 4];
+static uint8_t a8[MAX_COUNT], b8[MAX_COUNT], alpha8[MAX_COUNT];
+static int16_t acc16[MAX_COUNT], src16[MAX_COUNT];
+static uint32_t out[MAX_COUNT + 4], out_ref[MAX_COUNT + 4];
+static int16_t acc_ref16[MAX_COUNT];
+
+static uint8_t bench_indices[BENCH_COUNT];
+static uint16_t bench_out[BENCH_COUNT];
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+    // xorshift32
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static void fill_random(void *buf, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        ((uint8_t *)buf)[i] = (uint8_t)next_rand();
+    }
+}
+
+static bool check_model(void) {
+    interp_config cfg;
+    bool ok = true;
+
+    // clamp example from the datasheet: ACCUM0 >> 2, clamped to 0..255
+    cfg = interp_default_config();
+    interp_config_set_clamp(&cfg, true);
+    interp_config_set_shift(&cfg, 2);
+    interp_config_set_mask(&cfg, 0, 29);
+    interp_config_set_signed(&cfg, true);
+    interp_set_config(interp1, 0, &cfg);
+    interp_set_base(interp1, 0, 0);
+    interp_set_base(interp1, 1, 255);
+    static const int32_t clamp_in[] = { -1024, -768, -512, -256, 0, 256, 512, 768, 1024 };
+    static const uint32_t clamp_out[] = { 0, 0, 0, 0, 0, 64, 128, 192, 255 };
+    for (uint i = 0; i < count_of(clamp_in); i++) {
+        interp_set_accumulator(interp1, 0, (uint32_t)clamp_in[i]);
+        ok &= interp_peek_lane_result(interp1, 0) == clamp_out[i];
+    }
+    cfg = interp_default_config();
+    interp_set_config(interp1, 0, &cfg);
+
+    // blend example from the datasheet: 500 to 1000 as alpha goes from 0 to 255
+    cfg = interp_default_config();
+    interp_config_set_blend(&cfg, true);
+    interp_set_config(interp0, 0, &cfg);
+    cfg = interp_default_config();
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_base(interp0, 0, 500);
+    interp_set_base(interp0, 1, 1000);
+    static const uint32_t blend_out[] = { 500, 582, 666, 748, 832, 914, 998 };
+    for (uint i = 0; i <= 6; i++) {
+        interp_set_accumulator(interp0, 1, 255 * i / 6);
+        ok &= interp_peek_lane_result(interp0, 1) == blend_out[i];
+        // lane 0 gives alpha, and FULL doesn't add lane 1's value
+        ok &= interp_peek_lane_result(interp0, 0) == 255 * i / 6;
+    }
+    // signed blend, rounding down
+    cfg = interp_default_config();
+    interp_config_set_signed(&cfg, true);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_base(interp0, 0, 100);
+    interp_set_base(interp0, 1, (uint32_t)-100);
+    interp_set_accumulator(interp0, 1, 1);
+    ok &= interp_peek_lane_result(interp0, 1) == 99;
+    interp_set_accumulator(interp0, 1, 128);
+    ok &= interp_peek_lane_result(interp0, 1) == 0;
+    cfg = interp_default_config();
+    interp_set_config(interp0, 0, &cfg);
+    interp_set_config(interp0, 1, &cfg);
+
+    // shift, mask and sign extension
+    cfg = interp_default_config();
+    interp_config_set_shift(&cfg, 4);
+    interp_config_set_mask(&cfg, 2, 9);
+    interp_set_config(interp0, 0, &cfg);
+    interp_config_set_signed(&cfg, true);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_accumulator(interp0, 0, 0x12345678);
+    interp_set_accumulator(interp0, 1, 0x12346a78);
+    interp_set_base(interp0, 0, 1000);
+    interp_set_base(interp0, 1, 0);
+    interp_set_base(interp0, 2, 7);
+    ok &= interp_get_raw(interp0, 0) == 0x164;
+    ok &= interp_get_raw(interp0, 1) == 0xfffffea4;
+    ok &= interp_peek_lane_result(interp0, 0) == 1000 + 0x164;
+    ok &= interp_peek_full_result(interp0) == 7 + 0x164 + 0xfffffea4;
+
+    // pop writes the results back, crossed over if asked
+    cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_set_config(interp0, 0, &cfg);
+    interp_config_set_cross_result(&cfg, true);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_accumulator(interp0, 0, 10);
+    interp_set_accumulator(interp0, 1, 20);
+    interp_set_base(interp0, 0, 1);
+    interp_set_base(interp0, 1, 2);
+    ok &= interp_pop_lane_result(interp0, 0) == 11;
+    ok &= interp_get_accumulator(interp0, 0) == 11 && interp_get_accumulator(interp0, 1) == 11;
+    interp_add_accumulator(interp0, 1, 5);
+    ok &= interp_get_accumulator(interp0, 1) == 16;
+
+    // force bits only change what is read
+    cfg = interp_default_config();
+    interp_config_set_force_bits(&cfg, 2);
+    interp_set_config(interp0, 0, &cfg);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_base(interp0, 0, 4);
+    interp_set_accumulator(interp0, 0, 1);
+    ok &= interp_pop_lane_result(interp0, 0) == 0x20000005;
+    ok &= interp_get_accumulator(interp0, 0) == 5;
+
+    // BASE_1AND0 sign extends each half if the lane is signed
+    cfg = interp_default_config();
+    interp_set_config(interp0, 0, &cfg);
+    interp_config_set_signed(&cfg, true);
+    interp_set_config(interp0, 1, &cfg);
+    interp_set_base_both(interp0, 0x8001fffe);
+    ok &= interp_get_base(interp0, 0) == 0xfffe && interp_get_base(interp0, 1) == 0xffff8001;
+    return ok;
+}
+
+static bool check_lookup(void) {
+    for (uint size_log2 = 0; size_log2 <= 2; size_log2++) {
+        for (uint offset = 0; offset < 4; offset++) {
+            for (uint count = 0; count < MAX_COUNT; count += 1 + count / 8) {
+                memset(out, 0x55, sizeof(out));
+                memset(out_ref, 0x55, sizeof(out_ref));
+                interp_table_lookup(out, indices + offset, count, table32, size_log2);
+                interp_table_lookup_ref(out_ref, indices + offset, count, table32, size_log2);
+                if (memcmp(out, out_ref, sizeof(out))) {
+                    printf("lookup mismatch: size_log2 %u offset %u count %u\n", size_log2, offset, count);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool check_affine(void) {
+    for (uint size_log2 = 0; size_log2 <= 2; size_log2++) {
+        for (uint i = 0; i < 200; i++) {
+            uint width_log2 = 1 + next_rand() % 6;
+            uint height_log2 = 1 + next_rand() % 5;
+            uint32_t u = next_rand(), v = next_rand();
+            int32_t du = (int32_t)next_rand() >> (8 + next_rand() % 16);
+            int32_t dv = (int32_t)next_rand() >> (8 + next_rand() % 16);
+            uint count = next_rand() % MAX_COUNT;
+            memset(out, 0x55, sizeof(out));
+            memset(out_ref, 0x55, sizeof(out_ref));
+            interp_affine_sample(out, count, texture, size_log2, width_log2, height_log2, u, v, du, dv);
+            interp_affine_sample_ref(out_ref, count, texture, size_log2, width_log2, height_log2, u, v, du, dv);
+            if (memcmp(out, out_ref, sizeof(out))) {
+                printf("affine mismatch: size_log2 %u width_log2 %u height_log2 %u\n", size_log2, width_log2,
+                       height_log2);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool check_blend(void) {
+    uint8_t *dst = (uint8_t *)out, *dst_ref = (uint8_t *)out_ref;
+    for (uint alpha = 0; alpha < 256; alpha++) {
+        interp_blend_u8(dst, a8, b8, MAX_COUNT, (uint8_t)alpha);
+        interp_blend_u8_ref(dst_ref, a8, b8, MAX_COUNT, (uint8_t)alpha);
+        if (memcmp(dst, dst_ref, MAX_COUNT)) {
+            printf("blend mismatch: alpha %u\n", alpha);
+            return false;
+        }
+    }
+    interp_blend_alpha_u8(dst, a8, b8, alpha8, MAX_COUNT);
+    interp_blend_alpha_u8_ref(dst_ref, a8, b8, alpha8, MAX_COUNT);
+    if (memcmp(dst, dst_ref, MAX_COUNT)) {
+        printf("blend with alpha per value mismatch\n");
+        return false;
+    }
+    // in place
+    memcpy(dst, a8, MAX_COUNT);
+    interp_blend_u8(dst, dst, b8, MAX_COUNT, 77);
+    interp_blend_u8_ref(dst_ref, a8, b8, MAX_COUNT, 77);
+    return !memcmp(dst, dst_ref, MAX_COUNT);
+}
+
+static bool check_accumulate(void) {
+    static const int16_t gains[] = { INT16_MIN, -16384, -1, 0, 1, 12345, 16384, INT16_MAX };
+    for (uint g = 0; g < count_of(gains); g++) {
+        fill_random(acc16, sizeof(acc16));
+        // include the extremes
+        acc16[0] = INT16_MIN;
+        acc16[1] = INT16_MAX;
+        src16[0] = INT16_MIN;
+        src16[1] = INT16_MAX;
+        memcpy(acc_ref16, acc16, sizeof(acc16));
+        interp_accumulate_clamped_s16(acc16, src16, MAX_COUNT, gains[g]);
+        interp_accumulate_clamped_s16_ref(acc_ref16, src16, MAX_COUNT, gains[g]);
+        if (memcmp(acc16, acc_ref16, sizeof(acc16))) {
+            printf("accumulate mismatch: gain %d\n", gains[g]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void set_state(interp_hw_t *interp, uint32_t seed) {
+    interp_config cfg = interp_default_config();
+    interp_config_set_shift(&cfg, seed & 7);
+    interp_set_config(interp, 0, &cfg);
+    interp_config_set_cross_input(&cfg, true);
+    interp_set_config(interp, 1, &cfg);
+    interp_set_accumulator(interp, 0, seed);
+    interp_set_accumulator(interp, 1, ~seed);
+    interp_set_base(interp, 0, seed * 3);
+    interp_set_base(interp, 1, seed * 5);
+    interp_set_base(interp, 2, seed * 7);
+}
+
+static bool state_is(interp_hw_t *interp, const interp_hw_save_t *expected) {
+    interp_hw_save_t state;
+    interp_save(interp, &state);
+    return !memcmp(&state, expected, sizeof(state));
+}
+
+static uint64_t time_ns(void) {
+#if PICO_ON_DEVICE
+    return time_us_64() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static const uint16_t *bench_table(void) {
+    return (const uint16_t *)table32;
+}
+
+static void bench_lookup(void) {
+    interp_table_lookup(bench_out, bench_indices, BENCH_COUNT, bench_table(), 1);
+}
+
+static void bench_lookup_ref(void) {
+    interp_table_lookup_ref(bench_out, bench_indices, BENCH_COUNT, bench_table(), 1);
+}
+
+static void bench_affine(void) {
+    interp_affine_sample(bench_out, BENCH_COUNT, texture, 1, 6, 5, 0, 0, 0x12345, 0x3456);
+}
+
+static void bench_affine_ref(void) {
+    interp_affine_sample_ref(bench_out, BENCH_COUNT, texture, 1, 6, 5, 0, 0, 0x12345, 0x3456);
+}
+
+static void bench_blend(void) {
+    interp_blend_u8((uint8_t *)bench_out, a8, b8, MAX_COUNT, 100);
+}
+
+static void bench_blend_ref(void) {
+    interp_blend_u8_ref((uint8_t *)bench_out, a8, b8, MAX_COUNT, 100);
+}
+
+static void bench_accumulate(void) {
+    interp_accumulate_clamped_s16(acc16, src16, MAX_COUNT, 12345);
+}
+
+static void bench_accumulate_ref(void) {
+    interp_accumulate_clamped_s16_ref(acc16, src16, MAX_COUNT, 12345);
+}
+
+typedef struct {
+    const char *name;
+    void (*kernel)(void);
+    void (*ref)(void);
+    uint elements;
+} benchmark_t;
+
+static const benchmark_t benchmarks[] = {
+    { "lookup", bench_lookup, bench_lookup_ref, BENCH_COUNT },
+    { "affine", bench_affine, bench_affine_ref, BENCH_COUNT },
+    { "blend", bench_blend, bench_blend_ref, MAX_COUNT },
+    { "accumulate", bench_accumulate, bench_accumulate_ref, MAX_COUNT },
+};
+
+static double time_per_element(void (*func)(void), uint elements) {
+    uint64_t start = time_ns();
+    for (uint i = 0; i < BENCH_ITERATIONS; i++) {
+        func();
+    }
+    return (double)(time_ns() - start) / ((double)BENCH_ITERATIONS * elements);
+}
+
+static void run_benchmark(const benchmark_t *benchmark) {
+#if PICO_ON_DEVICE
+    printf("%-10s kernel %6.1f ns, C %6.1f ns per element\n", benchmark->name,
+           time_per_element(benchmark->kernel, benchmark->elements),
+           time_per_element(benchmark->ref, benchmark->elements));
+#else
+    // on the host, the time is the time taken to run the model, so the number of interpolator accesses is a better
+    // guide to the cost of a kernel
+    interp_model_reset_access_count();
+    double kernel_ns = time_per_element(benchmark->kernel, benchmark->elements);
+    double accesses = (double)interp_model_get_access_count() / ((double)BENCH_ITERATIONS * benchmark->elements);
+    printf("%-10s kernel (model) %6.1f ns, C %6.1f ns per element; %.2f interpolator accesses per element\n",
+           benchmark->name, kernel_ns, time_per_element(benchmark->ref, benchmark->elements), accesses);
+#endif
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    rand_state = 0x1234;
+    fill_random(indices, sizeof(indices));
+    fill_random(table32, sizeof(table32));
+    fill_random(texture, sizeof(texture));
+    fill_random(a8, sizeof(a8));
+    fill_random(b8, sizeof(b8));
+    fill_random(alpha8, sizeof(alpha8));
+    fill_random(src16, sizeof(src16));
+    fill_random(bench_indices, sizeof(bench_indices));
+
+    PICOTEST_START_SECTION("interpolator");
+        PICOTEST_CHECK(check_model(), "interpolator results wrong");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("table lookup");
+        PICOTEST_CHECK(check_lookup(), "interp_table_lookup differs from interp_table_lookup_ref");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("affine sample");
+        PICOTEST_CHECK(check_affine(), "interp_affine_sample differs from interp_affine_sample_ref");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("blend");
+        PICOTEST_CHECK(check_blend(), "interp_blend_u8 differs from interp_blend_u8_ref");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("accumulate clamped");
+        PICOTEST_CHECK(check_accumulate(),
+                       "interp_accumulate_clamped_s16 differs from interp_accumulate_clamped_s16_ref");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("state saved");
+        interp_hw_save_t state0, state1;
+        set_state(interp0, 0x13579bdf);
+        set_state(interp1, 0x2468ace0);
+        interp_save(interp0, &state0);
+        interp_save(interp1, &state1);
+        interp_table_lookup(out, indices, MAX_COUNT, table32, 2);
+        interp_affine_sample(out, MAX_COUNT, texture, 2, 4, 4, 0, 0, 0x10000, 0x8000);
+        interp_blend_alpha_u8((uint8_t *)out, a8, b8, alpha8, MAX_COUNT);
+        interp_accumulate_clamped_s16(acc16, src16, MAX_COUNT, 1000);
+        PICOTEST_CHECK(state_is(interp0, &state0) && state_is(interp1, &state1), "interpolator state not restored");
+    PICOTEST_END_SECTION();
+
+    for (uint b = 0; b < count_of(benchmarks); b++) {
+        run_benchmark(&benchmarks[b]);
+    }
+
+    PICOTEST_END_TEST();
+}
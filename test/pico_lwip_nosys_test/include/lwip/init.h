@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _LWIP_INIT_FAKE_H
+#define _LWIP_INIT_FAKE_H
+
+// Just enough of lwIP's init.h for lwip_nosys.c
+
+void lwip_init(void);
+
+#endif
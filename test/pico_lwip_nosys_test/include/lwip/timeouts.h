@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _LWIP_TIMEOUTS_FAKE_H
+#define _LWIP_TIMEOUTS_FAKE_H
+
+#include <stdint.h>
+
+// Just enough of lwIP's timeouts.h (and the parts of opt.h and sys.h it pulls in) for lwip_nosys.c; the
+// timeout list itself is in lwip_timeouts_fake.c
+
+#define NO_SYS 1
+#define SYS_TIMEOUTS_SLEEPTIME_INFINITE 0xFFFFFFFF
+
+typedef int sys_prot_t;
+typedef void (*sys_timeout_handler)(void *arg);
+
+uint32_t sys_now(void);
+uint32_t sys_jiffies(void);
+sys_prot_t sys_arch_protect(void);
+void sys_arch_unprotect(sys_prot_t pval);
+
+void sys_timeout(uint32_t msecs, sys_timeout_handler handler, void *arg);
+void sys_untimeout(sys_timeout_handler handler, void *arg);
+void sys_check_timeouts(void);
+uint32_t sys_timeouts_sleeptime(void);
+
+#endif
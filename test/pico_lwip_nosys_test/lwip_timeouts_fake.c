@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include "lwip/init.h"
+#include "lwip/timeouts.h"
+
+// The same semantics as lwIP's timeouts.c: a list of absolute sys_now() deadlines sorted earliest first
+
+#define MAX_TIMEOUTS 8
+
+typedef struct {
+    uint32_t time;
+    sys_timeout_handler handler;
+    void *arg;
+} fake_timeout_t;
+
+// called (once) when sys_timeouts_sleeptime() has read the clock, to stand in for something else running then
+void (*fake_sleeptime_interruption)(void);
+
+static fake_timeout_t timeouts[MAX_TIMEOUTS];
+static unsigned int timeout_count;
+
+static int time_less_than(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+void lwip_init(void) {
+    timeout_count = 0;
+}
+
+void sys_timeout(uint32_t msecs, sys_timeout_handler handler, void *arg) {
+    assert(timeout_count < MAX_TIMEOUTS);
+    uint32_t time = sys_now() + msecs;
+    unsigned int i = timeout_count;
+    while (i && time_less_than(time, timeouts[i - 1].time)) {
+        timeouts[i] = timeouts[i - 1];
+        i--;
+    }
+    timeouts[i] = (fake_timeout_t){ .time = time, .handler = handler, .arg = arg };
+    timeout_count++;
+}
+
+void sys_untimeout(sys_timeout_handler handler, void *arg) {
+    for (unsigned int i = 0; i < timeout_count; i++) {
+        if (timeouts[i].handler == handler && timeouts[i].arg == arg) {
+            for (timeout_count--; i < timeout_count; i++) {
+                timeouts[i] = timeouts[i + 1];
+            }
+            return;
+        }
+    }
+}
+
+void sys_check_timeouts(void) {
+    uint32_t now = sys_now();
+    while (timeout_count && !time_less_than(now, timeouts[0].time)) {
+        fake_timeout_t timeout = timeouts[0];
+        sys_untimeout(timeout.handler, timeout.arg);
+        timeout.handler(timeout.arg);
+    }
+}
+
+uint32_t sys_timeouts_sleeptime(void) {
+    if (!timeout_count) return SYS_TIMEOUTS_SLEEPTIME_INFINITE;
+    uint32_t now = sys_now();
+    if (fake_sleeptime_interruption) {
+        void (*interruption)(void) = fake_sleeptime_interruption;
+        fake_sleeptime_interruption = NULL;
+        interruption();
+    }
+    if (time_less_than(timeouts[0].time, now)) return 0;
+    return timeouts[0].time - now;
+}
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "pico/stdlib.h"
+#include "pico/async_context_base.h"
+#include "pico/lwip_nosys.h"
+#include "lwip/init.h"
+#include "lwip/timeouts.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("LWIP_NOSYS", "lwIP NO_SYS async_context integration test");
+
+#define RELEASE_ITERATIONS 200000
+#define OTHER_AT_TIME_WORKERS 4
+
+// A minimal single threaded context, like async_context_poll; async_context_base_execute_once() is exactly the work
+// the other backends do on each outermost lock release. add_at_time_worker is counted so that re-arms can be seen.
+static uint32_t at_time_adds;
+
+static void noop(__unused async_context_t *context) {
+}
+
+static bool counting_add_at_time_worker(async_context_t *context, async_at_time_worker_t *worker) {
+    at_time_adds++;
+    return async_context_base_add_at_time_worker(context, worker);
+}
+
+static void set_work_pending(__unused async_context_t *context, async_when_pending_worker_t *worker) {
+    worker->work_pending = true;
+}
+
+static uint32_t execute_sync(__unused async_context_t *context, uint32_t (*func)(void *param), void *param) {
+    return func(param);
+}
+
+static const async_context_type_t test_context_type = {
+        .acquire_lock_blocking = noop,
+        .release_lock = noop,
+        .lock_check = noop,
+        .execute_sync = execute_sync,
+        .add_at_time_worker = counting_add_at_time_worker,
+        .remove_at_time_worker = async_context_base_remove_at_time_worker,
+        .add_when_pending_worker = async_context_base_add_when_pending_worker,
+        .remove_when_pending_worker = async_context_base_remove_when_pending_worker,
+        .set_work_pending = set_work_pending,
+        .deinit = noop,
+};
+
+static async_context_t context = { .type = &test_context_type };
+
+// The bridge as it was before lwip_nosys.c re-armed only on a deadline change, for comparison
+static void legacy_timeout_reached(__unused async_context_t *ctx, __unused async_at_time_worker_t *worker) {
+    sys_check_timeouts();
+}
+
+static async_at_time_worker_t legacy_timeout_worker = { .do_work = legacy_timeout_reached };
+
+static void legacy_update_next_timeout(async_context_t *ctx, async_when_pending_worker_t *worker) {
+    worker->work_pending = true;
+    uint32_t sleep_ms = sys_timeouts_sleeptime();
+    if (sleep_ms == SYS_TIMEOUTS_SLEEPTIME_INFINITE) {
+        legacy_timeout_worker.next_time = at_the_end_of_time;
+    } else {
+        legacy_timeout_worker.next_time = make_timeout_time_ms(sleep_ms);
+    }
+    async_context_add_at_time_worker(ctx, &legacy_timeout_worker);
+}
+
+static async_when_pending_worker_t legacy_update_worker = { .do_work = legacy_update_next_timeout };
+
+static uint32_t fired_count;
+static uint64_t fired_time;
+
+static void timeout_handler(__unused void *arg) {
+    fired_time = time_us_64();
+    fired_count++;
+}
+
+static void unused_handler(__unused void *arg) {
+}
+
+static void at_time_work(__unused async_context_t *ctx, __unused async_at_time_worker_t *worker) {
+}
+
+static async_at_time_worker_t other_workers[OTHER_AT_TIME_WORKERS];
+
+extern void (*fake_sleeptime_interruption)(void);
+
+// An IRQ (or the other core) reading lwIP's clock a couple of milliseconds after sys_timeouts_sleeptime() did
+static uint32_t interruption_now_ms;
+
+static void clock_reading_interruption(void) {
+    busy_wait_ms(2);
+    interruption_now_ms = sys_now();
+}
+
+// Process (as on lock release) until the handler has run, returning the elapsed time
+static uint64_t run_until_fired(uint32_t count) {
+    uint64_t start = time_us_64();
+    while (fired_count != count && time_us_64() - start < 1000000) {
+        async_context_base_execute_once(&context);
+    }
+    return fired_time - start;
+}
+
+static bool worker_in_at_time_list(const async_at_time_worker_t *worker) {
+    for (const async_at_time_worker_t *w = context.at_time_list; w; w = w->next) {
+        if (w == worker) return true;
+    }
+    return false;
+}
+
+// Time RELEASE_ITERATIONS lock releases with long lwIP timeouts and some other at time workers present, which
+// re-arming the lwIP worker must leave alone
+static double time_releases(uint32_t *adds, bool *others_armed) {
+    lwip_init();
+    sys_timeout(10000, unused_handler, NULL);
+    sys_timeout(20000, unused_handler, &context);
+    sys_timeout(30000, unused_handler, &fired_count);
+    for (uint i = 0; i < OTHER_AT_TIME_WORKERS; i++) {
+        other_workers[i].do_work = at_time_work;
+        async_context_add_at_time_worker_in_ms(&context, &other_workers[i], 60000 + i);
+    }
+    at_time_adds = 0;
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < RELEASE_ITERATIONS; i++) {
+        async_context_base_execute_once(&context);
+    }
+    uint64_t us = time_us_64() - start;
+    *adds = at_time_adds;
+    *others_armed = true;
+    for (uint i = 0; i < OTHER_AT_TIME_WORKERS; i++) {
+        *others_armed &= worker_in_at_time_list(&other_workers[i]);
+        async_context_remove_at_time_worker(&context, &other_workers[i]);
+    }
+    return (double)us * 1000 / RELEASE_ITERATIONS;
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    PICOTEST_CHECK_AND_ABORT(lwip_nosys_init(&context), "init failed");
+
+    PICOTEST_START_SECTION("timeouts fire");
+        lwip_init();
+        async_context_base_execute_once(&context);
+        PICOTEST_CHECK(!context.at_time_list, "worker armed with no lwIP timeouts");
+        sys_timeout(20, timeout_handler, NULL);
+        at_time_adds = 0;
+        uint64_t elapsed = run_until_fired(1);
+        printf("20ms timeout fired after %"PRIu64"us with %u re-arms\n", elapsed, (uint)at_time_adds);
+        PICOTEST_CHECK(fired_count == 1, "timeout did not fire");
+        PICOTEST_CHECK(elapsed >= 18000 && elapsed < 30000, "timeout fired at the wrong time");
+        PICOTEST_CHECK(at_time_adds <= 2, "worker re-armed without a deadline change");
+        async_context_base_execute_once(&context);
+        PICOTEST_CHECK(!context.at_time_list, "worker left armed after the last timeout");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("deadline changes");
+        sys_timeout(100, timeout_handler, NULL);
+        async_context_base_execute_once(&context);
+        at_time_adds = 0;
+        // an earlier timeout must bring the wakeup forward
+        sys_timeout(10, timeout_handler, NULL);
+        uint64_t elapsed = run_until_fired(2);
+        printf("10ms timeout added under a 100ms one fired after %"PRIu64"us\n", elapsed);
+        PICOTEST_CHECK(elapsed >= 9000 && elapsed < 30000, "earlier timeout did not move the wakeup");
+        PICOTEST_CHECK(at_time_adds >= 1, "worker not re-armed");
+
+        // removing the only timeout must disarm the worker
+        sys_untimeout(timeout_handler, NULL);
+        async_context_base_execute_once(&context);
+        PICOTEST_CHECK(!context.at_time_list, "worker left armed after untimeout");
+
+        // the deadline must not follow the clock as read by someone else in the meantime
+        sys_timeout(100, timeout_handler, NULL);
+        async_context_base_execute_once(&context);
+        PICOTEST_CHECK(context.at_time_list && !context.at_time_list->next, "worker not armed");
+        absolute_time_t wakeup = context.at_time_list->next_time;
+        at_time_adds = 0;
+        fake_sleeptime_interruption = clock_reading_interruption;
+        async_context_base_execute_once(&context);
+        PICOTEST_CHECK(interruption_now_ms, "sys_now() was not called in between");
+        PICOTEST_CHECK(!at_time_adds && context.at_time_list->next_time == wakeup, "a sys_now() call elsewhere moved the deadline");
+        sys_untimeout(timeout_handler, NULL);
+        async_context_base_execute_once(&context);
+
+        // an overdue timeout runs straight away
+        sys_timeout(0, timeout_handler, NULL);
+        elapsed = run_until_fired(3);
+        PICOTEST_CHECK(fired_count == 3 && elapsed < 5000, "overdue timeout did not run");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("lock release overhead");
+        uint32_t adds;
+        bool others_armed;
+        double ns = time_releases(&adds, &others_armed);
+        printf("re-arm on change: %.1fns per lock release, %u re-arms in %u releases\n", ns, (uint)adds, RELEASE_ITERATIONS);
+        PICOTEST_CHECK(adds <= 2, "worker re-armed without a deadline change");
+        PICOTEST_CHECK(others_armed, "other at time workers disturbed");
+        lwip_nosys_deinit(&context);
+        PICOTEST_CHECK(!context.at_time_list && !context.when_pending_list, "deinit left workers behind");
+
+        async_context_add_when_pending_worker(&context, &legacy_update_worker);
+        async_context_set_work_pending(&context, &legacy_update_worker);
+        uint32_t legacy_adds;
+        double legacy_ns = time_releases(&legacy_adds, &others_armed);
+        printf("always re-arm:    %.1fns per lock release, %u re-arms in %u releases\n", legacy_ns, (uint)legacy_adds, RELEASE_ITERATIONS);
+        async_context_remove_when_pending_worker(&context, &legacy_update_worker);
+        async_context_remove_at_time_worker(&context, &legacy_timeout_worker);
+        PICOTEST_CHECK(legacy_adds >= RELEASE_ITERATIONS, "legacy bridge did not re-arm every release");
+        PICOTEST_CHECK(others_armed, "other at time workers disturbed");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
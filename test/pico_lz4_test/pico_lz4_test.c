@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/lz4.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("LZ4", "LZ4 compression test");
+
+#define CORPUS_SIZE 16384
+#define GUARD_SIZE 16
+#define GUARD_BYTE 0xa5
+#define SPEED_BYTES (1024 * 1024)
+
+static uint8_t __aligned(4) corpus[CORPUS_SIZE];
+static uint8_t compressed[CORPUS_SIZE + CORPUS_SIZE / 255 + 16];
+static uint8_t decompressed[CORPUS_SIZE + GUARD_SIZE];
+static lz4_compress_state_t state;
+
+// The output of tools/compress_ram_sections.py for golden_input, to check that it and lz4_compress() agree
+static const char golden_input[] = "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog! "
+                                   "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0"
+                                   "\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2\1\2"
+                                   "end of the golden vector";
+static const uint8_t golden_output[] = {
+    0xff, 0x1e, 0x54, 0x68, 0x65, 0x20, 0x71, 0x75, 0x69, 0x63, 0x6b, 0x20, 0x62, 0x72, 0x6f, 0x77, 0x6e, 0x20, 0x66,
+    0x6f, 0x78, 0x20, 0x6a, 0x75, 0x6d, 0x70, 0x73, 0x20, 0x6f, 0x76, 0x65, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6c,
+    0x61, 0x7a, 0x79, 0x20, 0x64, 0x6f, 0x67, 0x2e, 0x20, 0x2d, 0x00, 0x18, 0x3f, 0x21, 0x20, 0x00, 0x01, 0x00, 0x14,
+    0x2f, 0x01, 0x02, 0x02, 0x00, 0x13, 0x61, 0x65, 0x6e, 0x64, 0x20, 0x6f, 0x66, 0x92, 0x00, 0xd0, 0x67, 0x6f, 0x6c,
+    0x64, 0x65, 0x6e, 0x20, 0x76, 0x65, 0x63, 0x74, 0x6f, 0x72,
+};
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+    // xorshift32
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+static void fill_zeros(void) {
+    memset(corpus, 0, sizeof(corpus));
+}
+
+static void fill_random(void) {
+    for (uint i = 0; i < CORPUS_SIZE; i++) corpus[i] = (uint8_t)next_rand();
+}
+
+// words picked at random from a small vocabulary
+static void fill_text(void) {
+    static const char *const words[] = { "the ", "pico ", "sdk ", "flash ", "boot ", "copy ", "data ", "RAM ",
+                                         "section ", "compress ", "\n" };
+    uint pos = 0;
+    while (pos < CORPUS_SIZE) {
+        const char *word = words[next_rand() % count_of(words)];
+        while (*word && pos < CORPUS_SIZE) corpus[pos++] = (uint8_t)*word++;
+    }
+}
+
+// what initialized data tends to look like: tables of structs with small values, pointers and padding, and
+// some zero filled arrays
+static void fill_data(void) {
+    uint32_t *words = (uint32_t *)corpus;
+    uint count = CORPUS_SIZE / 4;
+    for (uint i = 0; i < count;) {
+        if (next_rand() % 8 == 0) {
+            for (uint n = next_rand() % 64; n && i < count; n--) words[i++] = 0;
+        } else {
+            words[i++] = 0x20000000u + (next_rand() % 0x1000) * 4;
+            if (i < count) words[i++] = next_rand() % 16;
+            if (i < count) words[i++] = (next_rand() & 1) ? 0xffffffffu : 0;
+        }
+    }
+}
+
+// runs with periods 1, 2 and 3 at every alignment, which lz4_decompress_fast handles specially
+static void fill_runs(void) {
+    uint pos = 0;
+    while (pos < CORPUS_SIZE) {
+        uint period = 1 + next_rand() % 3;
+        uint len = next_rand() % 100;
+        uint8_t pattern[3] = { (uint8_t)next_rand(), (uint8_t)next_rand(), (uint8_t)next_rand() };
+        for (uint i = 0; i < len && pos < CORPUS_SIZE; i++) corpus[pos++] = pattern[i % period];
+        if (pos < CORPUS_SIZE) corpus[pos++] = (uint8_t)next_rand();
+    }
+}
+
+static bool guard_intact(size_t len) {
+    for (uint i = 0; i < GUARD_SIZE; i++) {
+        if (decompressed[len + i] != GUARD_BYTE) return false;
+    }
+    return true;
+}
+
+// Compress len bytes of the corpus, check that both decompressors give it back exactly, and write nothing past its end
+static int round_trip(size_t len) {
+    int size = lz4_compress(&state, corpus, len, compressed, lz4_compress_bound(len));
+    if (size <= 0) return size ? size : -100;
+    memset(decompressed, GUARD_BYTE, sizeof(decompressed));
+    if (lz4_decompress(compressed, (size_t)size, decompressed, len) != (int)len) return -101;
+    if (memcmp(decompressed, corpus, len) || !guard_intact(len)) return -102;
+    memset(decompressed, GUARD_BYTE, sizeof(decompressed));
+    lz4_decompress_fast(compressed, decompressed, len);
+    if (memcmp(decompressed, corpus, len) || !guard_intact(len)) return -103;
+    return size;
+}
+
+static const struct {
+    const char *name;
+    void (*fill)(void);
+} corpora[] = {
+    { "zeros", fill_zeros },
+    { "text", fill_text },
+    { "data", fill_data },
+    { "runs", fill_runs },
+    { "random", fill_random },
+};
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    int size;
+    PICOTEST_START_SECTION("golden vector");
+        size = lz4_compress(&state, golden_input, sizeof(golden_input) - 1, compressed, sizeof(compressed));
+        PICOTEST_CHECK(size == sizeof(golden_output) && !memcmp(compressed, golden_output, sizeof(golden_output)),
+                       "compressor does not match tools/compress_ram_sections.py");
+        PICOTEST_CHECK(lz4_decompress(golden_output, sizeof(golden_output), decompressed, sizeof(decompressed)) ==
+                       sizeof(golden_input) - 1 && !memcmp(decompressed, golden_input, sizeof(golden_input) - 1),
+                       "golden vector does not decompress");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("corpora");
+        for (uint i = 0; i < count_of(corpora); i++) {
+            rand_state = 0x12345678u + i;
+            corpora[i].fill();
+            size = round_trip(CORPUS_SIZE);
+            PICOTEST_CHECK_AND_ABORT(size > 0, "round trip failed");
+            PICOTEST_CHECK((size_t)size <= lz4_compress_bound(CORPUS_SIZE), "compressed size above bound");
+
+            // time enough decompressions to give a meaningful rate
+            uint iterations = SPEED_BYTES / CORPUS_SIZE;
+            absolute_time_t start = get_absolute_time();
+            for (uint n = 0; n < iterations; n++) {
+                lz4_decompress_fast(compressed, decompressed, CORPUS_SIZE);
+            }
+            int64_t fast_us = absolute_time_diff_us(start, get_absolute_time());
+            start = get_absolute_time();
+            for (uint n = 0; n < iterations; n++) {
+                lz4_decompress(compressed, (size_t)size, decompressed, CORPUS_SIZE);
+            }
+            int64_t checked_us = absolute_time_diff_us(start, get_absolute_time());
+            // called through a volatile pointer, so that the repeated copies are not optimized away
+            void *(*volatile copy)(void *, const void *, size_t) = memcpy;
+            start = get_absolute_time();
+            for (uint n = 0; n < iterations; n++) {
+                copy(decompressed, corpus, CORPUS_SIZE);
+            }
+            int64_t memcpy_us = absolute_time_diff_us(start, get_absolute_time());
+            printf("%-7s %u -> %d bytes (%u%%), decompress %u MB/s (checked %u MB/s, memcpy %u MB/s)\n", corpora[i].name,
+                   CORPUS_SIZE, size, (uint)size * 100 / CORPUS_SIZE,
+                   (uint)(SPEED_BYTES / (fast_us ? fast_us : 1)), (uint)(SPEED_BYTES / (checked_us ? checked_us : 1)),
+                   (uint)(SPEED_BYTES / (memcpy_us ? memcpy_us : 1)));
+        }
+        // compressible data should be, and incompressible data should grow very little
+        rand_state = 1;
+        fill_zeros();
+        PICOTEST_CHECK(round_trip(CORPUS_SIZE) < CORPUS_SIZE / 100, "zeros not compressed");
+        fill_random();
+        PICOTEST_CHECK(round_trip(CORPUS_SIZE) < CORPUS_SIZE + CORPUS_SIZE / 200, "random data grew too much");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("lengths");
+        // every short length (where the rules about the end of the data matter), and unaligned copies
+        rand_state = 42;
+        fill_runs();
+        bool ok = true;
+        for (size_t len = 0; len <= 300 && ok; len++) {
+            ok = round_trip(len) > 0;
+        }
+        PICOTEST_CHECK(ok, "short length round trip failed");
+        fill_text();
+        int unaligned = lz4_compress(&state, corpus + 1, CORPUS_SIZE - 3, compressed, sizeof(compressed));
+        PICOTEST_CHECK(unaligned > 0, "unaligned compress failed");
+        lz4_decompress_fast(compressed, decompressed + 3, CORPUS_SIZE - 3);
+        PICOTEST_CHECK(!memcmp(decompressed + 3, corpus + 1, CORPUS_SIZE - 3), "unaligned decompress failed");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("errors");
+        rand_state = 7;
+        fill_data();
+        size = round_trip(CORPUS_SIZE);
+        PICOTEST_CHECK_AND_ABORT(size > 0, "round trip failed");
+        PICOTEST_CHECK(lz4_decompress(compressed, (size_t)size, decompressed, CORPUS_SIZE - 1) ==
+                       PICO_ERROR_BUFFER_TOO_SMALL, "overflow not reported");
+        bool truncated_ok = true;
+        for (int len = 0; len < size && truncated_ok; len++) {
+            int result = lz4_decompress(compressed, (size_t)len, decompressed, CORPUS_SIZE);
+            // a truncation can only be undetectable if it falls just after a sequence's literals
+            truncated_ok = result == PICO_ERROR_INVALID_DATA || (result >= 0 && result < CORPUS_SIZE);
+        }
+        PICOTEST_CHECK(truncated_ok, "truncated data accepted");
+        static const uint8_t bad_offset[] = { 0x14, 'a', 0x02, 0x00, 0x10, 'b' };
+        PICOTEST_CHECK(lz4_decompress(bad_offset, sizeof(bad_offset), decompressed, CORPUS_SIZE) ==
+                       PICO_ERROR_INVALID_DATA, "offset before the start accepted");
+        static const uint8_t zero_offset[] = { 0x14, 'a', 0x00, 0x00, 0x10, 'b' };
+        PICOTEST_CHECK(lz4_decompress(zero_offset, sizeof(zero_offset), decompressed, CORPUS_SIZE) ==
+                       PICO_ERROR_INVALID_DATA, "zero offset accepted");
+        PICOTEST_CHECK(lz4_compress(&state, corpus, CORPUS_SIZE, compressed, (size_t)size - 1) ==
+                       PICO_ERROR_BUFFER_TOO_SMALL, "compressed overflow not reported");
+        PICOTEST_CHECK(lz4_compress(&state, corpus, 0, compressed, 1) == 1 && compressed[0] == 0, "empty input");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
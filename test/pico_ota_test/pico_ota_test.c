@@ -0,0 +1,248 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "pico/stdlib.h"
+#include "pico/ota.h"
+#include "boot/picobin.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("OTA", "OTA image writer test");
+
+#define REGION_SIZE (16 * PICO_OTA_SECTOR_SIZE)
+// deliberately not a whole number of pages
+#define IMAGE_SIZE (3 * PICO_OTA_SECTOR_SIZE + 1236)
+#define BLOCK_OFFSET 0x100
+#define BLOCK_WORDS 23
+#define BLOCK_END (BLOCK_OFFSET + BLOCK_WORDS * 4)
+#define HASH_DEF_WORD 9
+#define HASH_VALUE_WORD 11
+
+// A file-backed model of the region of NOR flash being written: erased bytes are 0xff, and programming can only
+// clear bits
+static FILE *flash_file;
+static uint flash_write_count;
+static bool flash_write_misaligned;
+
+static int file_read(__unused void *context, uint32_t offset, uint8_t *buffer, size_t count) {
+    if (fseek(flash_file, (long)offset, SEEK_SET) || fread(buffer, 1, count, flash_file) != count) return PICO_ERROR_IO;
+    return PICO_OK;
+}
+
+static int file_write(__unused void *context, uint32_t offset, const uint8_t *data, size_t count) {
+    static uint8_t sector[PICO_OTA_SECTOR_SIZE];
+    if ((offset & (PICO_OTA_SECTOR_SIZE - 1)) || (count & (PICO_OTA_PAGE_SIZE - 1))) flash_write_misaligned = true;
+    flash_write_count++;
+    while (count) {
+        size_t len = MIN(count, PICO_OTA_SECTOR_SIZE);
+        memset(sector, 0xff, sizeof(sector));
+        for (size_t i = 0; i < len; i++) sector[i] &= data[i];
+        if (fseek(flash_file, (long)offset, SEEK_SET) || fwrite(sector, 1, sizeof(sector), flash_file) != sizeof(sector)) {
+            return PICO_ERROR_IO;
+        }
+        offset += PICO_OTA_SECTOR_SIZE;
+        data += len;
+        count -= len;
+    }
+    return PICO_OK;
+}
+
+static const pico_ota_flash_ops_t file_ops = {
+    .write = file_write,
+    .read = file_read,
+};
+
+static void reset_flash(void) {
+    // start from garbage rather than erased flash, so that missing erases show up
+    static uint8_t junk[REGION_SIZE];
+    memset(junk, 0x5a, sizeof(junk));
+    fseek(flash_file, 0, SEEK_SET);
+    fwrite(junk, 1, sizeof(junk), flash_file);
+    flash_write_count = 0;
+    flash_write_misaligned = false;
+}
+
+static void corrupt_flash(uint32_t offset) {
+    uint8_t byte;
+    file_read(NULL, offset, &byte, 1);
+    byte ^= 0x01;
+    fseek(flash_file, (long)offset, SEEK_SET);
+    fwrite(&byte, 1, 1, flash_file);
+}
+
+static void sha256_of(const void *data, size_t count, sha256_result_t *result) {
+    pico_sha256_state_t state;
+    hard_assert(pico_sha256_try_start(&state, SHA256_BIG_ENDIAN, false) == PICO_OK);
+    pico_sha256_update_blocking(&state, data, count);
+    pico_sha256_finish(&state, result);
+}
+
+static uint8_t __aligned(4) image[IMAGE_SIZE];
+
+// Builds an image with an IMAGE_DEF block at BLOCK_OFFSET whose load map covers the rest of the image
+static void build_image(void) {
+    uint32_t seed = 12345;
+    for (uint i = 0; i < IMAGE_SIZE; i++) {
+        seed = seed * 1103515245u + 12345u;
+        image[i] = (uint8_t)(seed >> 16);
+    }
+    uint32_t *block = (uint32_t *)(image + BLOCK_OFFSET);
+    uint i = 0;
+    block[i++] = PICOBIN_BLOCK_MARKER_START;
+    block[i++] = PICOBIN_BLOCK_ITEM_1BS_IMAGE_TYPE | (1u << 8) | ((PICOBIN_IMAGE_TYPE_IMAGE_TYPE_AS_BITS(EXE) |
+            PICOBIN_IMAGE_TYPE_EXE_CHIP_AS_BITS(RP2350) | PICOBIN_IMAGE_TYPE_EXE_SECURITY_AS_BITS(S)) << 16);
+    // relative load map with two entries: the data before the block, and the data after it
+    block[i++] = PICOBIN_BLOCK_ITEM_LOAD_MAP | (7u << 8) | (2u << 24);
+    block[i++] = (uint32_t)-BLOCK_OFFSET;
+    block[i++] = 0x10000000;
+    block[i++] = BLOCK_OFFSET;
+    block[i++] = BLOCK_WORDS * 4;
+    block[i++] = 0x10000000 + BLOCK_END;
+    block[i++] = IMAGE_SIZE - BLOCK_END;
+    hard_assert(i == HASH_DEF_WORD);
+    block[i++] = PICOBIN_BLOCK_ITEM_1BS_HASH_DEF | (2u << 8) | (PICOBIN_HASH_SHA256 << 24);
+    block[i++] = HASH_VALUE_WORD;
+    block[i++] = PICOBIN_BLOCK_ITEM_HASH_VALUE | (9u << 8);
+    i += 8;
+    block[i] = PICOBIN_BLOCK_ITEM_2BS_LAST | ((i - 1) << 8);
+    i++;
+    block[i++] = 0;
+    block[i++] = PICOBIN_BLOCK_MARKER_END;
+    hard_assert(i == BLOCK_WORDS);
+
+    pico_sha256_state_t state;
+    hard_assert(pico_sha256_try_start(&state, SHA256_BIG_ENDIAN, false) == PICO_OK);
+    pico_sha256_update_blocking(&state, image, BLOCK_OFFSET);
+    pico_sha256_update_blocking(&state, image + BLOCK_END, IMAGE_SIZE - BLOCK_END);
+    pico_sha256_update_blocking(&state, (const uint8_t *)block, HASH_VALUE_WORD * 4);
+    sha256_result_t result;
+    pico_sha256_finish(&state, &result);
+    memcpy(&block[HASH_VALUE_WORD + 1], result.bytes, sizeof(result.bytes));
+}
+
+static uint progress_calls;
+static uint32_t last_progress_bytes;
+
+static void progress_callback(__unused pico_ota_writer_t *writer, const pico_ota_progress_t *progress, __unused void *user_data) {
+    progress_calls++;
+    last_progress_bytes = progress->bytes_programmed;
+}
+
+static pico_ota_writer_t writer;
+
+// Streams the image to the region in chunks of varying sizes
+static int write_image(const uint8_t *data, uint32_t size) {
+    reset_flash();
+    int rc = pico_ota_begin(&writer, &file_ops, NULL, REGION_SIZE, size);
+    if (rc) return rc;
+    pico_ota_set_progress_callback(&writer, progress_callback, NULL);
+    progress_calls = 0;
+    uint32_t seed = 1;
+    for (uint32_t pos = 0; pos < size && !rc; ) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t len = MIN(size - pos, 1 + (seed >> 16) % 3000);
+        rc = pico_ota_write(&writer, data + pos, len);
+        pos += len;
+    }
+    return rc ? rc : pico_ota_finish(&writer);
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    flash_file = tmpfile();
+    PICOTEST_CHECK_AND_ABORT(flash_file, "could not create flash file");
+    build_image();
+
+    PICOTEST_START_SECTION("sha256");
+        static const uint8_t abc_sha256[SHA256_RESULT_BYTES] = {
+            0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+            0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+        };
+        sha256_result_t expected;
+        memcpy(expected.bytes, abc_sha256, sizeof(abc_sha256));
+        PICOTEST_CHECK(write_image((const uint8_t *)"abc", 3) == PICO_OK, "write failed");
+        PICOTEST_CHECK(pico_ota_verify_sha256(&writer, &expected) == PICO_OK, "wrong SHA-256");
+        expected.bytes[31] ^= 1;
+        PICOTEST_CHECK(pico_ota_verify_sha256(&writer, &expected) == PICO_ERROR_INVALID_DATA, "SHA-256 mismatch not reported");
+        uint8_t page[PICO_OTA_PAGE_SIZE + 1];
+        file_read(NULL, 0, page, sizeof(page));
+        bool padded = !memcmp(page, "abc", 3);
+        for (uint i = 3; i < PICO_OTA_PAGE_SIZE; i++) padded &= page[i] == 0xff;
+        PICOTEST_CHECK(padded && page[PICO_OTA_PAGE_SIZE] == 0xff, "last page not padded within an erased sector");
+        PICOTEST_CHECK(pico_ota_verify_picobin(&writer, NULL) == PICO_ERROR_NOT_FOUND, "picobin block found in plain data");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("image");
+        PICOTEST_CHECK(write_image(image, IMAGE_SIZE) == PICO_OK, "write failed");
+        static uint8_t readback[IMAGE_SIZE];
+        file_read(NULL, 0, readback, IMAGE_SIZE);
+        PICOTEST_CHECK(!memcmp(readback, image, IMAGE_SIZE), "flash does not hold the image");
+        uint buffers = (IMAGE_SIZE + PICO_OTA_BUFFER_SIZE - 1) / PICO_OTA_BUFFER_SIZE;
+        PICOTEST_CHECK(flash_write_count == buffers && !flash_write_misaligned, "image not written a whole buffer at a time");
+        PICOTEST_CHECK(progress_calls == buffers && last_progress_bytes == IMAGE_SIZE, "wrong progress reported");
+        pico_ota_progress_t progress;
+        pico_ota_get_progress(&writer, &progress);
+        PICOTEST_CHECK(progress.bytes_received == IMAGE_SIZE && progress.bytes_programmed == IMAGE_SIZE &&
+                       progress.flash_writes == buffers, "wrong progress");
+        sha256_result_t expected;
+        sha256_of(image, IMAGE_SIZE, &expected);
+        PICOTEST_CHECK(pico_ota_verify_sha256(&writer, &expected) == PICO_OK, "wrong SHA-256");
+
+        pico_ota_picobin_info_t info;
+        PICOTEST_CHECK(pico_ota_verify_picobin(&writer, &info) == PICO_OK, "picobin verification failed");
+        PICOTEST_CHECK(info.block_offset == BLOCK_OFFSET && info.has_load_map && info.has_hash && !info.has_signature,
+                       "wrong picobin info");
+        PICOTEST_CHECK((info.image_type & PICOBIN_IMAGE_TYPE_IMAGE_TYPE_BITS) == PICOBIN_IMAGE_TYPE_IMAGE_TYPE_EXE,
+                       "wrong image type");
+        printf("%u bytes in %u flash writes, %uus in flash of %uus, %u bytes/s\n", progress.bytes_programmed,
+               progress.flash_writes, progress.flash_us, progress.elapsed_us, progress.bytes_per_second);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("corruption");
+        // a bad byte after the block, then one in the hashed part of the block itself (a load map runtime address)
+        static const uint32_t corrupt_offsets[] = { 3 * PICO_OTA_SECTOR_SIZE + 7, BLOCK_OFFSET + 4 * 4 + 1 };
+        for (uint i = 0; i < count_of(corrupt_offsets); i++) {
+            PICOTEST_CHECK(write_image(image, IMAGE_SIZE) == PICO_OK, "write failed");
+            corrupt_flash(corrupt_offsets[i]);
+            PICOTEST_CHECK(pico_ota_verify_picobin(&writer, NULL) == PICO_ERROR_INVALID_DATA, "corruption not detected");
+        }
+        // a block without its end marker is not a block
+        PICOTEST_CHECK(write_image(image, IMAGE_SIZE) == PICO_OK, "write failed");
+        corrupt_flash(BLOCK_END - 4);
+        PICOTEST_CHECK(pico_ota_verify_picobin(&writer, NULL) == PICO_ERROR_NOT_FOUND, "broken block accepted");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("errors");
+        PICOTEST_CHECK(pico_ota_begin(&writer, &file_ops, NULL, REGION_SIZE, REGION_SIZE + 1) == PICO_ERROR_BUFFER_TOO_SMALL,
+                       "oversized image accepted");
+        reset_flash();
+        PICOTEST_CHECK(pico_ota_begin(&writer, &file_ops, NULL, 2 * PICO_OTA_SECTOR_SIZE, 0) == PICO_OK, "begin failed");
+        PICOTEST_CHECK(pico_ota_write(&writer, image, 2 * PICO_OTA_SECTOR_SIZE) == PICO_OK, "write failed");
+        PICOTEST_CHECK(pico_ota_write(&writer, image, 1) == PICO_ERROR_BUFFER_TOO_SMALL, "overflow not reported");
+        PICOTEST_CHECK(pico_ota_write(&writer, image, 0) == PICO_ERROR_BUFFER_TOO_SMALL, "error not sticky");
+        PICOTEST_CHECK(pico_ota_finish(&writer) == PICO_ERROR_BUFFER_TOO_SMALL, "finish after error succeeded");
+
+        // the short image is caught at the end
+        PICOTEST_CHECK(pico_ota_begin(&writer, &file_ops, NULL, REGION_SIZE, IMAGE_SIZE) == PICO_OK, "begin failed after error");
+        PICOTEST_CHECK(pico_ota_write(&writer, image, IMAGE_SIZE - 1) == PICO_OK, "write failed");
+        PICOTEST_CHECK(pico_ota_finish(&writer) == PICO_ERROR_INVALID_DATA, "short image not reported");
+
+        PICOTEST_CHECK(pico_ota_begin(&writer, &file_ops, NULL, REGION_SIZE, 0) == PICO_OK, "begin failed after error");
+        pico_ota_abort(&writer);
+        PICOTEST_CHECK(pico_ota_write(&writer, image, 1) != PICO_OK, "write after abort succeeded");
+        PICOTEST_CHECK(pico_ota_begin(&writer, &file_ops, NULL, REGION_SIZE, 0) == PICO_OK, "SHA-256 not released by abort");
+        pico_ota_abort(&writer);
+    PICOTEST_END_SECTION();
+
+    fclose(flash_file);
+    PICOTEST_END_TEST();
+}
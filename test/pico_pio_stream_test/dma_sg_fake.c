@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "pico/dma_sg_sim.h"
+#include "dma_sg_fake.h"
+
+#define MAX_IRQS 64
+
+static uint32_t claimed;
+static int position = -1;
+
+typedef struct {
+    uint count;
+    uint desc_index[MAX_IRQS];
+    uint64_t cycle[MAX_IRQS];
+} irq_log_t;
+
+int dma_claim_unused_channel(bool required) {
+    for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (!(claimed & (1u << i))) {
+            claimed |= 1u << i;
+            return (int)i;
+        }
+    }
+    if (required) panic("No DMA channels are available");
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    claimed &= ~(1u << channel);
+}
+
+bool dma_channel_is_busy(__unused uint channel) {
+    return false;
+}
+
+void dma_sg_init(dma_sg_t *sg, uint ctrl_chan, uint data_chan) {
+    memset(sg, 0, sizeof(*sg));
+    sg->ctrl_chan = (uint8_t)ctrl_chan;
+    sg->data_chan = (uint8_t)data_chan;
+    sg->irq_index = -1;
+}
+
+void dma_sg_deinit(dma_sg_t *sg) {
+    dma_sg_abort(sg);
+    sg->callback = NULL;
+}
+
+void dma_sg_start(dma_sg_t *sg, const dma_sg_list_t *list) {
+    sg->list = list;
+    position = -1;
+}
+
+void dma_sg_abort(dma_sg_t *sg) {
+    sg->list = NULL;
+}
+
+int dma_sg_get_position(__unused const dma_sg_t *sg) {
+    return position;
+}
+
+void dma_sg_set_irq_callback(dma_sg_t *sg, uint irq_index, dma_sg_callback_t callback, void *user_data) {
+    sg->irq_index = callback ? (int8_t)irq_index : -1;
+    sg->callback = callback;
+    sg->user_data = user_data;
+}
+
+static uint32_t dreq_period(uint treq, __unused void *user_data) {
+    return treq == DMA_CH0_CTRL_TRIG_TREQ_SEL_VALUE_PERMANENT ? 0 : DMA_SG_FAKE_DREQ_PERIOD;
+}
+
+static void log_irq(uint desc_index, uint64_t cycle, __unused bool finished, void *user_data) {
+    irq_log_t *log = (irq_log_t *)user_data;
+    if (log->count < MAX_IRQS) {
+        log->desc_index[log->count] = desc_index;
+        log->cycle[log->count] = cycle;
+        log->count++;
+    }
+}
+
+uint dma_sg_fake_run(dma_sg_t *sg, uint descriptors, dma_sg_fake_latency_t latency) {
+    static irq_log_t log;
+    memset(&log, 0, sizeof(log));
+    dma_sg_sim_config_t config = dma_sg_sim_get_default_config();
+    config.max_descriptors = descriptors;
+    config.treq_period = dreq_period;
+    config.irq_handler = log_irq;
+    config.user_data = &log;
+    dma_sg_sim_result_t result;
+    dma_sg_sim_status_t status = dma_sg_sim_run(sg->list, &config, &result);
+    hard_assert(status == DMA_SG_SIM_OK || status == DMA_SG_SIM_LIMIT_REACHED);
+
+    uint handled = 0;
+    uint i = 0;
+    while (i < log.count && sg->callback) {
+        uint64_t now = log.cycle[i] + latency(handled);
+        // interrupts raised before the handler runs are merged with this one
+        uint next = i + 1;
+        while (next < log.count && log.cycle[next] <= now) next++;
+        // past the end of the run, where the DMA is cannot be told
+        if (next == log.count) break;
+        // the descriptor which completes next is the one the DMA is on
+        position = (int)log.desc_index[next];
+        sg->callback(sg, false);
+        handled++;
+        i = next;
+    }
+    return handled;
+}
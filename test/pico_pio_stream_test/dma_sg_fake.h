@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _DMA_SG_FAKE_H
+#define _DMA_SG_FAKE_H
+
+#include "pico/dma_sg.h"
+
+// A model of pico_dma_sg for pio_stream.c to be built on. dma_sg_start() only records the list; the test then calls
+// dma_sg_fake_run(), which runs the list through pico_dma_sg_sim and delivers the data channel interrupts to the
+// instance's callback, each after the given latency. Interrupts raised while one is still waiting to be handled are
+// merged with it, as the channel has a single interrupt flag, and dma_sg_get_position() returns the descriptor the
+// DMA is on when the handler runs.
+
+// the bus cycles taken by each transfer paced by a PIO DREQ
+#define DMA_SG_FAKE_DREQ_PERIOD 10
+
+typedef uint32_t (*dma_sg_fake_latency_t)(uint irq_num);
+
+// run the started list for the given number of descriptors, returning the number of handler invocations
+uint dma_sg_fake_run(dma_sg_t *sg, uint descriptors, dma_sg_fake_latency_t latency);
+
+#endif
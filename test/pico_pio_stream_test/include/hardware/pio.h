@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HARDWARE_PIO_H
+#define _HARDWARE_PIO_H
+
+// Just enough of hardware/pio.h for pio_stream.c: a PIO block is plain memory, so the simulated DMA can read and
+// write its FIFO registers
+
+#include "pico.h"
+
+#define PIO_SM0_SHIFTCTRL_FJOIN_RX_BITS 0x80000000u
+#define PIO_SM0_SHIFTCTRL_FJOIN_TX_BITS 0x40000000u
+
+typedef struct {
+    volatile uint32_t txf[4];
+    volatile uint32_t rxf[4];
+    struct {
+        volatile uint32_t shiftctrl;
+    } sm[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+static inline void hw_write_masked(volatile uint32_t *addr, uint32_t values, uint32_t write_mask) {
+    *addr = (*addr & ~write_mask) | (values & write_mask);
+}
+
+static inline uint pio_get_dreq(__unused PIO pio, uint sm, bool is_tx) {
+    // as DREQ_PIO0_TX0 and DREQ_PIO0_RX0
+    return sm + (is_tx ? 0 : 4);
+}
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/pio_stream.h"
+#include "pico/test.h"
+#include "dma_sg_fake.h"
+
+PICOTEST_MODULE_NAME("PIO_STREAM", "pio_stream double buffering test");
+
+#define TRANSFER_COUNT 8
+// each buffer takes TRANSFER_COUNT * DMA_SG_FAKE_DREQ_PERIOD bus cycles, plus a few to load its descriptor
+#define PROMPT_LATENCY 5
+#define LATE_LATENCY (TRANSFER_COUNT * DMA_SG_FAKE_DREQ_PERIOD * 3 / 2)
+#define LATE_IRQ 2
+// two buffers and the jump back per pass
+#define PASSES 6
+#define DESCRIPTORS (PASSES * 3)
+
+static pio_hw_t pio_block;
+static uint32_t buffers[2][TRANSFER_COUNT];
+static void *handed[32];
+static uint handed_count;
+
+static void record_buffer(__unused pio_stream_t *stream, void *buffer, uint transfer_count) {
+    hard_assert(transfer_count == TRANSFER_COUNT);
+    if (handed_count < count_of(handed)) handed[handed_count] = buffer;
+    handed_count++;
+}
+
+static uint32_t prompt(__unused uint irq_num) {
+    return PROMPT_LATENCY;
+}
+
+static uint32_t one_late(uint irq_num) {
+    return irq_num == LATE_IRQ ? LATE_LATENCY : PROMPT_LATENCY;
+}
+
+static void init_stream(pio_stream_t *stream, pio_stream_direction_t direction) {
+    pio_stream_config_t config = pio_stream_get_default_config();
+    config.direction = direction;
+    config.buffers[0] = buffers[0];
+    config.buffers[1] = buffers[1];
+    config.transfer_count = TRANSFER_COUNT;
+    config.callback = record_buffer;
+    hard_assert(pio_stream_init(stream, &pio_block, 1, &config));
+    handed_count = 0;
+}
+
+// the buffers handed to the callback from the first, alternate from buffer 0
+static bool handed_alternately(uint first, uint count) {
+    for (uint i = first; i < first + count; i++) {
+        if (handed[i] != buffers[(i - first) & 1]) return false;
+    }
+    return true;
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    pio_stream_t stream;
+    pio_stream_stats_t stats;
+
+    PICOTEST_START_SECTION("TX with prompt interrupts");
+        init_stream(&stream, PIO_STREAM_TX);
+        for (uint i = 0; i < TRANSFER_COUNT; i++) {
+            buffers[0][i] = 0x100 + i;
+            buffers[1][i] = 0x200 + i;
+        }
+        pio_stream_start(&stream);
+        PICOTEST_CHECK(handed_count == 2 && handed_alternately(0, 2), "buffers not primed in order");
+        uint irqs = dma_sg_fake_run(&stream.sg, DESCRIPTORS, prompt);
+        PICOTEST_CHECK(irqs >= 2 * PASSES - 2, "too few interrupts handled");
+        PICOTEST_CHECK(handed_count == 2 + irqs && handed_alternately(2, irqs), "buffers not handed back in order");
+        PICOTEST_CHECK(pio_block.txf[1] == 0x200 + TRANSFER_COUNT - 1, "data not streamed to the TX FIFO");
+        pio_stream_get_stats(&stream, &stats);
+        PICOTEST_CHECK(stats.buffers == irqs && !stats.underruns && !stats.overruns, "wrong stats");
+        pio_stream_deinit(&stream);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("TX with a late interrupt");
+        init_stream(&stream, PIO_STREAM_TX);
+        pio_stream_start(&stream);
+        handed_count = 0;
+        uint irqs = dma_sg_fake_run(&stream.sg, DESCRIPTORS, one_late);
+        // the late interrupt covers the completion of buffer 0 and then buffer 1, by which time buffer 0 has been
+        // restarted unrefilled; buffer 1 is the one that can be refilled
+        PICOTEST_CHECK(handed_alternately(0, LATE_IRQ), "buffers before the late interrupt not handed in order");
+        PICOTEST_CHECK(handed[LATE_IRQ] == buffers[1], "the late interrupt did not hand over buffer 1");
+        PICOTEST_CHECK(handed_alternately(LATE_IRQ + 1, irqs - LATE_IRQ - 1), "buffers after the late interrupt not handed in order");
+        pio_stream_get_stats(&stream, &stats);
+        PICOTEST_CHECK(stats.buffers == irqs && stats.underruns == 1 && !stats.overruns, "underrun not counted once");
+        pio_stream_reset_stats(&stream);
+        pio_stream_get_stats(&stream, &stats);
+        PICOTEST_CHECK(!stats.buffers && !stats.underruns, "stats not reset");
+        pio_stream_deinit(&stream);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("RX with a late interrupt");
+        init_stream(&stream, PIO_STREAM_RX);
+        pio_block.rxf[1] = 0xabcd;
+        pio_stream_start(&stream);
+        PICOTEST_CHECK(!handed_count, "RX buffers handed over before any data");
+        uint irqs = dma_sg_fake_run(&stream.sg, DESCRIPTORS, one_late);
+        PICOTEST_CHECK(handed_alternately(0, LATE_IRQ) && handed[LATE_IRQ] == buffers[1], "wrong buffer handed to the consumer");
+        PICOTEST_CHECK(buffers[0][0] == 0xabcd && buffers[1][TRANSFER_COUNT - 1] == 0xabcd, "data not streamed from the RX FIFO");
+        pio_stream_get_stats(&stream, &stats);
+        PICOTEST_CHECK(stats.buffers == irqs && stats.overruns == 1 && !stats.underruns, "overrun not counted once");
+        pio_stream_deinit(&stream);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("stop");
+        init_stream(&stream, PIO_STREAM_TX);
+        pio_stream_start(&stream);
+        const dma_sg_list_t *list = stream.sg.list;
+        pio_stream_stop(&stream);
+        PICOTEST_CHECK(!stream.sg.callback && !stream.sg.list, "stop did not abort the chain");
+        stream.sg.list = list;
+        handed_count = 0;
+        PICOTEST_CHECK(!dma_sg_fake_run(&stream.sg, DESCRIPTORS, prompt) && !handed_count, "callback ran after stop");
+        pio_stream_deinit(&stream);
+        // both channels are free again
+        PICOTEST_CHECK(dma_claim_unused_channel(true) == 0 && dma_claim_unused_channel(true) == 1, "channels not released");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
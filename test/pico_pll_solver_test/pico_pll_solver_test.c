@@ -0,0 +1,248 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "pico/pll_solver.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("PLL solver", "PLL solver test");
+
+typedef struct {
+    uint32_t input_hz;
+    uint8_t low_vco;
+    uint8_t lock_refdiv;
+    uint32_t freq_hz;
+    // the parameters chosen by vcocalc.py, or all 0 if it found no solution
+    uint8_t refdiv;
+    uint16_t fbdiv;
+    uint8_t postdiv1;
+    uint8_t postdiv2;
+} vcocalc_case_t;
+
+// The output of src/rp2_common/hardware_clocks/scripts/vcocalc.py --cmake-only -i <input MHz> <freq MHz>, with -l for
+// low_vco and --lock-refdiv for lock_refdiv
+static const vcocalc_case_t vcocalc_cases[] = {
+        { 12000000, 0, 0,   10000000,  2, 147, 7, 7},
+        { 12000000, 0, 0,   18000000,  2, 147, 7, 7},
+        { 12000000, 0, 0,   24000000,  1,  98, 7, 7},
+        { 12000000, 0, 0,   48000000,  1, 120, 6, 5},
+        { 12000000, 0, 0,   50000000,  1, 125, 6, 5},
+        { 12000000, 0, 0,   62500000,  1, 125, 6, 4},
+        { 12000000, 0, 0,   96000000,  1, 128, 4, 4},
+        { 12000000, 0, 0,   99900000,  1, 125, 5, 3},
+        { 12000000, 0, 0,  100000000,  1, 125, 5, 3},
+        { 12000000, 0, 0,  120000000,  1, 120, 6, 2},
+        { 12000000, 0, 0,  125000000,  1, 125, 6, 2},
+        { 12000000, 0, 0,  126500000,  2, 253, 6, 2},
+        { 12000000, 0, 0,  133000000,  1, 133, 6, 2},
+        { 12000000, 0, 0,  133330000,  1, 111, 5, 2},
+        { 12000000, 0, 0,  144000000,  1, 120, 5, 2},
+        { 12000000, 0, 0,  150000000,  1, 125, 5, 2},
+        { 12000000, 0, 0,  156250000,  1, 130, 5, 2},
+        { 12000000, 0, 0,  166660000,  2, 139, 5, 1},
+        { 12000000, 0, 0,  175000000,  2, 175, 6, 1},
+        { 12000000, 0, 0,  180500000,  2, 241, 4, 2},
+        { 12000000, 0, 0,  200000000,  1, 100, 6, 1},
+        { 12000000, 0, 0,  210000000,  2, 245, 7, 1},
+        { 12000000, 0, 0,  225000000,  2, 225, 6, 1},
+        { 12000000, 0, 0,  240000000,  1, 120, 6, 1},
+        { 12000000, 0, 0,  250000000,  1, 125, 6, 1},
+        { 12000000, 0, 0,  266000000,  1, 133, 6, 1},
+        { 12000000, 0, 0,  276480000,  1, 115, 5, 1},
+        { 12000000, 0, 0,  300000000,  1, 125, 5, 1},
+        { 12000000, 0, 0,  333300000,  1, 111, 4, 1},
+        { 12000000, 0, 0,  400000000,  1, 100, 3, 1},
+        { 12000000, 0, 0, 1000000000,  2, 167, 1, 1},
+        { 12000000, 0, 0,    5000000,  0,   0, 0, 0},
+        { 12000000, 1, 0,   10000000,  1,  63, 7, 6},
+        { 12000000, 1, 0,   18000000,  1,  63, 7, 6},
+        { 12000000, 1, 0,   24000000,  1,  70, 7, 5},
+        { 12000000, 1, 0,   48000000,  1,  64, 4, 4},
+        { 12000000, 1, 0,   50000000,  2, 125, 5, 3},
+        { 12000000, 1, 0,   62500000,  2, 125, 6, 2},
+        { 12000000, 1, 0,   96000000,  1,  64, 4, 2},
+        { 12000000, 1, 0,   99900000,  1,  75, 3, 3},
+        { 12000000, 1, 0,  100000000,  1,  75, 3, 3},
+        { 12000000, 1, 0,  120000000,  1,  70, 7, 1},
+        { 12000000, 1, 0,  125000000,  2, 125, 6, 1},
+        { 12000000, 1, 0,  126500000,  2, 253, 6, 2},
+        { 12000000, 1, 0,  133000000,  2, 133, 6, 1},
+        { 12000000, 1, 0,  133330000,  1, 111, 5, 2},
+        { 12000000, 1, 0,  144000000,  1,  72, 6, 1},
+        { 12000000, 1, 0,  150000000,  2, 125, 5, 1},
+        { 12000000, 1, 0,  156250000,  1,  65, 5, 1},
+        { 12000000, 1, 0,  166660000,  2, 139, 5, 1},
+        { 12000000, 1, 0,  175000000,  2, 175, 6, 1},
+        { 12000000, 1, 0,  180500000,  2, 241, 4, 2},
+        { 12000000, 1, 0,  200000000,  1, 100, 6, 1},
+        { 12000000, 1, 0,  210000000,  1,  70, 4, 1},
+        { 12000000, 1, 0,  225000000,  1,  75, 4, 1},
+        { 12000000, 1, 0,  240000000,  1,  80, 4, 1},
+        { 12000000, 1, 0,  250000000,  2, 125, 3, 1},
+        { 12000000, 1, 0,  266000000,  2, 133, 3, 1},
+        { 12000000, 1, 0,  276480000,  1,  69, 3, 1},
+        { 12000000, 1, 0,  300000000,  1,  75, 3, 1},
+        { 12000000, 1, 0,  333300000,  1, 111, 4, 1},
+        { 12000000, 1, 0,  400000000,  1, 100, 3, 1},
+        { 12000000, 1, 0, 1000000000,  2, 167, 1, 1},
+        { 12000000, 1, 0,    5000000,  0,   0, 0, 0},
+        { 10000000, 0, 0,   10000000,  1,  98, 7, 7},
+        { 10000000, 0, 0,   48000000,  1, 144, 6, 5},
+        { 10000000, 0, 0,   96000000,  1, 144, 5, 3},
+        { 10000000, 0, 0,  120000000,  1, 144, 6, 2},
+        { 10000000, 0, 0,  133000000,  1, 133, 5, 2},
+        { 10000000, 0, 0,  150000000,  1, 150, 5, 2},
+        { 10000000, 0, 0,  175000000,  2, 315, 3, 3},
+        { 10000000, 0, 0,  210000000,  1, 147, 7, 1},
+        { 10000000, 0, 0,  250000000,  1, 150, 6, 1},
+        { 10000000, 0, 0,  300000000,  1, 150, 5, 1},
+        { 10000000, 0, 0, 1000000000,  1, 100, 1, 1},
+        { 10000000, 1, 0,   10000000,  0,   0, 0, 0},
+        { 10000000, 1, 0,   48000000,  1,  96, 5, 4},
+        { 10000000, 1, 0,   96000000,  1,  96, 5, 2},
+        { 10000000, 1, 0,  120000000,  1,  84, 7, 1},
+        { 10000000, 1, 0,  133000000,  1, 133, 5, 2},
+        { 10000000, 1, 0,  150000000,  1,  75, 5, 1},
+        { 10000000, 1, 0,  175000000,  2, 175, 5, 1},
+        { 10000000, 1, 0,  210000000,  1,  84, 4, 1},
+        { 10000000, 1, 0,  250000000,  1,  75, 3, 1},
+        { 10000000, 1, 0,  300000000,  1,  90, 3, 1},
+        { 10000000, 1, 0, 1000000000,  1, 100, 1, 1},
+        { 40000000, 0, 0,   10000000,  5,  98, 7, 7},
+        { 40000000, 0, 1,   10000000,  1,  21, 7, 6},
+        { 40000000, 0, 0,   48000000,  1,  36, 6, 5},
+        { 40000000, 0, 1,   48000000,  1,  36, 6, 5},
+        { 40000000, 0, 0,   96000000,  5, 192, 4, 4},
+        { 40000000, 0, 1,   96000000,  1,  36, 5, 3},
+        { 40000000, 0, 0,  120000000,  1,  36, 6, 2},
+        { 40000000, 0, 1,  120000000,  1,  36, 6, 2},
+        { 40000000, 0, 0,  133000000,  4, 133, 5, 2},
+        { 40000000, 0, 1,  133000000,  1,  33, 5, 2},
+        { 40000000, 0, 0,  150000000,  2,  75, 5, 2},
+        { 40000000, 0, 1,  150000000,  1,  30, 4, 2},
+        { 40000000, 0, 0,  175000000,  8, 315, 3, 3},
+        { 40000000, 0, 1,  175000000,  1,  35, 4, 2},
+        { 40000000, 0, 0,  210000000,  4, 147, 7, 1},
+        { 40000000, 0, 1,  210000000,  1,  21, 4, 1},
+        { 40000000, 0, 0,  250000000,  2,  75, 6, 1},
+        { 40000000, 0, 1,  250000000,  1,  25, 4, 1},
+        { 40000000, 0, 0,  300000000,  2,  75, 5, 1},
+        { 40000000, 0, 1,  300000000,  1,  30, 4, 1},
+        { 40000000, 0, 0, 1000000000,  1,  25, 1, 1},
+        { 40000000, 0, 1, 1000000000,  1,  25, 1, 1},
+        { 40000000, 1, 0,   10000000,  5,  98, 7, 7},
+        { 40000000, 1, 1,   10000000,  0,   0, 0, 0},
+        { 40000000, 1, 0,   48000000,  5,  96, 4, 4},
+        { 40000000, 1, 1,   48000000,  1,  24, 5, 4},
+        { 40000000, 1, 0,   96000000,  5,  96, 4, 2},
+        { 40000000, 1, 1,   96000000,  1,  24, 5, 2},
+        { 40000000, 1, 0,  120000000,  1,  21, 7, 1},
+        { 40000000, 1, 1,  120000000,  1,  21, 7, 1},
+        { 40000000, 1, 0,  133000000,  5, 133, 4, 2},
+        { 40000000, 1, 1,  133000000,  1,  33, 5, 2},
+        { 40000000, 1, 0,  150000000,  4,  75, 5, 1},
+        { 40000000, 1, 1,  150000000,  1,  30, 4, 2},
+        { 40000000, 1, 0,  175000000,  8, 175, 5, 1},
+        { 40000000, 1, 1,  175000000,  1,  35, 4, 2},
+        { 40000000, 1, 0,  210000000,  1,  21, 4, 1},
+        { 40000000, 1, 1,  210000000,  1,  21, 4, 1},
+        { 40000000, 1, 0,  250000000,  4,  75, 3, 1},
+        { 40000000, 1, 1,  250000000,  1,  25, 4, 1},
+        { 40000000, 1, 0,  300000000,  2,  45, 3, 1},
+        { 40000000, 1, 1,  300000000,  1,  30, 4, 1},
+        { 40000000, 1, 0, 1000000000,  1,  25, 1, 1},
+        { 40000000, 1, 1, 1000000000,  1,  25, 1, 1},
+        { 16000000, 0, 0,   10000000,  1,  49, 7, 7},
+        { 16000000, 0, 0,   48000000,  1,  90, 6, 5},
+        { 16000000, 0, 0,   96000000,  1,  96, 4, 4},
+        { 16000000, 0, 0,  120000000,  1,  90, 6, 2},
+        { 16000000, 0, 0,  133000000,  2, 133, 4, 2},
+        { 16000000, 0, 0,  150000000,  1,  75, 4, 2},
+        { 16000000, 0, 0,  175000000,  2, 175, 4, 2},
+        { 16000000, 0, 0,  210000000,  2, 105, 4, 1},
+        { 16000000, 0, 0,  250000000,  2, 125, 4, 1},
+        { 16000000, 0, 0,  300000000,  1,  75, 4, 1},
+        { 16000000, 0, 0, 1000000000,  2, 125, 1, 1},
+        { 16000000, 1, 0,   10000000,  1,  49, 7, 7},
+        { 16000000, 1, 0,   48000000,  1,  48, 4, 4},
+        { 16000000, 1, 0,   96000000,  1,  48, 4, 2},
+        { 16000000, 1, 0,  120000000,  2, 105, 7, 1},
+        { 16000000, 1, 0,  133000000,  2, 133, 4, 2},
+        { 16000000, 1, 0,  150000000,  1,  75, 4, 2},
+        { 16000000, 1, 0,  175000000,  2, 175, 4, 2},
+        { 16000000, 1, 0,  210000000,  2, 105, 4, 1},
+        { 16000000, 1, 0,  250000000,  2, 125, 4, 1},
+        { 16000000, 1, 0,  300000000,  1,  75, 4, 1},
+        { 16000000, 1, 0, 1000000000,  2, 125, 1, 1},
+};
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    PICOTEST_START_SECTION("matches vcocalc.py");
+        uint mismatches = 0;
+        for (uint i = 0; i < count_of(vcocalc_cases); i++) {
+            const vcocalc_case_t *c = &vcocalc_cases[i];
+            pll_solver_config_t config = pll_solver_get_default_config(c->input_hz);
+            config.low_vco = c->low_vco;
+            config.lock_refdiv = c->lock_refdiv;
+            pll_solution_t solution;
+            bool found = pll_solve(&config, c->freq_hz, &solution);
+            bool match = c->refdiv ? found && solution.refdiv == c->refdiv && solution.fbdiv == c->fbdiv &&
+                                     solution.postdiv1 == c->postdiv1 && solution.postdiv2 == c->postdiv2 : !found;
+            if (!match) {
+                printf("input %u Hz, %u Hz%s: expected %u %u %u %u, got ", (uint)c->input_hz, (uint)c->freq_hz,
+                       c->low_vco ? " (low VCO)" : "", c->refdiv, c->fbdiv, c->postdiv1, c->postdiv2);
+                if (found) {
+                    printf("%u %u %u %u\n", solution.refdiv, solution.fbdiv, solution.postdiv1, solution.postdiv2);
+                } else {
+                    printf("no solution\n");
+                }
+                mismatches++;
+            }
+        }
+        PICOTEST_CHECK(!mismatches, "solutions differ from vcocalc.py");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("solutions are valid");
+        pll_solver_config_t config = pll_solver_get_default_config(12000000);
+        bool ok = true;
+        for (uint32_t freq_khz = 16000; freq_khz <= 400000; freq_khz += 997) {
+            pll_solution_t solution;
+            ok &= pll_solve(&config, freq_khz * 1000, &solution);
+            uint64_t vco_hz = (uint64_t)config.input_hz * solution.fbdiv / solution.refdiv;
+            ok &= vco_hz == solution.vco_hz && vco_hz >= config.vco_min_hz && vco_hz <= config.vco_max_hz;
+            ok &= solution.out_hz == vco_hz / (solution.postdiv1 * solution.postdiv2);
+            ok &= solution.postdiv1 >= 1 && solution.postdiv1 <= PLL_SOLVER_POSTDIV_MAX &&
+                  solution.postdiv2 >= 1 && solution.postdiv2 <= PLL_SOLVER_POSTDIV_MAX;
+            if (!ok) {
+                printf("bad solution for %u kHz\n", (uint)freq_khz);
+                break;
+            }
+        }
+        PICOTEST_CHECK(ok, "invalid solution");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("exact frequencies");
+        pll_solver_config_t config = pll_solver_get_default_config(12000000);
+        pll_solution_t solution;
+        PICOTEST_CHECK(pll_solve(&config, 125000000, &solution) && solution.out_hz == 125000000 &&
+                       solution.vco_hz == 1500000000, "wrong solution for 125MHz");
+        config.low_vco = true;
+        PICOTEST_CHECK(pll_solve(&config, 125000000, &solution) && solution.out_hz == 125000000 &&
+                       solution.vco_hz == 750000000, "wrong low VCO solution for 125MHz");
+        config.low_vco = false;
+        config.vco_max_hz = 1200000000;
+        PICOTEST_CHECK(pll_solve(&config, 125000000, &solution) && solution.out_hz == 125000000 &&
+                       solution.vco_hz <= 1200000000, "VCO maximum ignored");
+        PICOTEST_CHECK(!pll_solve(&config, 5000000, &solution), "found a solution for 5MHz");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_END_TEST();
+}
@@ -0,0 +1,335 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "pico/stdlib.h"
+#include "pico/pool.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("POOL", "pico_pool test");
+
+// The two "cores" are host threads: get_core_num() is per thread, and the host's dummy spin locks are replaced with
+// real ones so that the threads do contend
+
+static __thread uint thread_core_num;
+
+uint get_core_num(void) {
+    return thread_core_num;
+}
+
+struct _spin_lock_t {
+    atomic_bool locked;
+};
+
+static spin_lock_t host_spin_locks[NUM_SPIN_LOCKS];
+
+spin_lock_t *spin_lock_instance(uint lock_num) {
+    hard_assert(lock_num < NUM_SPIN_LOCKS);
+    return &host_spin_locks[lock_num];
+}
+
+void spin_lock_unsafe_blocking(spin_lock_t *lock) {
+    while (atomic_exchange_explicit(&lock->locked, true, memory_order_acquire)) {
+        // the holder may not be running if there are fewer CPUs than threads
+        sched_yield();
+    }
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    spin_lock_unsafe_blocking(lock);
+    return 0;
+}
+
+void spin_unlock_unsafe(spin_lock_t *lock) {
+    atomic_store_explicit(&lock->locked, false, memory_order_release);
+}
+
+void spin_unlock(spin_lock_t *lock, __unused uint32_t saved_irq) {
+    spin_unlock_unsafe(lock);
+}
+
+bool is_spin_locked(const spin_lock_t *lock) {
+    return atomic_load_explicit(&lock->locked, memory_order_relaxed);
+}
+
+#define BLOCK_SIZE 250
+#define BLOCK_COUNT 64
+#define THREAD_BLOCKS 24
+#define THREAD_ITERATIONS 20000
+#define BENCH_ITERATIONS 1000000
+#define BENCH_BATCH 16
+
+static uint8_t __aligned(8) storage[POOL_STORAGE_SIZE(BLOCK_SIZE, BLOCK_COUNT)];
+static pool_t pool;
+
+static uint32_t next_rand(uint32_t *state) {
+    // xorshift32
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Allocate and free blocks at random, keeping up to THREAD_BLOCKS, filling each with a pattern unique to this
+// thread and allocation, and checking it is intact before freeing it, which it won't be if the block was also handed
+// out to another thread
+typedef struct {
+    uint core_num;
+    bool corrupt;
+    uint failed;
+} thread_worker_t;
+
+static void *thread_worker(void *param) {
+    thread_worker_t *worker = (thread_worker_t *)param;
+    thread_core_num = worker->core_num;
+    uint32_t state = 0x1234u + worker->core_num;
+    uint8_t *blocks[THREAD_BLOCKS] = { NULL };
+    for (uint i = 0; i < THREAD_ITERATIONS; i++) {
+        uint slot = next_rand(&state) % THREAD_BLOCKS;
+        if (blocks[slot]) {
+            uint8_t pattern = blocks[slot][0];
+            for (uint j = 1; j < BLOCK_SIZE; j++) {
+                if (blocks[slot][j] != pattern) worker->corrupt = true;
+            }
+            pool_free(&pool, blocks[slot]);
+            blocks[slot] = NULL;
+        } else {
+            blocks[slot] = (uint8_t *)pool_alloc(&pool);
+            if (blocks[slot]) {
+                memset(blocks[slot], (uint8_t)(i * 2 + worker->core_num), BLOCK_SIZE);
+            } else {
+                worker->failed++;
+            }
+        }
+    }
+    for (uint slot = 0; slot < THREAD_BLOCKS; slot++) {
+        pool_free(&pool, blocks[slot]);
+    }
+    pool_flush_magazine(&pool);
+    return NULL;
+}
+
+static bool run_thread_test(void) {
+    pthread_t threads[NUM_CORES];
+    thread_worker_t workers[NUM_CORES];
+    for (uint i = 0; i < NUM_CORES; i++) {
+        workers[i] = (thread_worker_t) { .core_num = i };
+        pthread_create(&threads[i], NULL, thread_worker, &workers[i]);
+    }
+    bool ok = true;
+    for (uint i = 0; i < NUM_CORES; i++) {
+        pthread_join(threads[i], NULL);
+        ok &= !workers[i].corrupt && !workers[i].failed;
+    }
+    return ok;
+}
+
+// Benchmarks; each allocates and frees BENCH_ITERATIONS blocks, either one at a time or in batches
+
+typedef struct {
+    const char *name;
+    void *(*alloc)(void);
+    void (*free)(void *block);
+} allocator_t;
+
+static void *bench_pool_alloc(void) {
+    return pool_alloc(&pool);
+}
+
+static void bench_pool_free(void *block) {
+    pool_free(&pool, block);
+}
+
+static void *bench_malloc(void) {
+    return malloc(BLOCK_SIZE);
+}
+
+static const allocator_t bench_allocators[] = {
+    { "malloc", bench_malloc, free },
+    { "pool", bench_pool_alloc, bench_pool_free },
+};
+
+static uint64_t bench_pairs(const allocator_t *allocator) {
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < BENCH_ITERATIONS; i++) {
+        void *block = allocator->alloc();
+        *(volatile uint8_t *)block = 0;
+        allocator->free(block);
+    }
+    return time_us_64() - start;
+}
+
+static uint64_t bench_batches(const allocator_t *allocator) {
+    void *blocks[BENCH_BATCH];
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < BENCH_ITERATIONS / BENCH_BATCH; i++) {
+        for (uint j = 0; j < BENCH_BATCH; j++) {
+            blocks[j] = allocator->alloc();
+            *(volatile uint8_t *)blocks[j] = 0;
+        }
+        // free in a different order to that allocated, as e.g. packets completing out of order would be
+        for (uint j = 0; j < BENCH_BATCH; j++) {
+            allocator->free(blocks[(j * 5) % BENCH_BATCH]);
+        }
+    }
+    return time_us_64() - start;
+}
+
+typedef struct {
+    const allocator_t *allocator;
+    uint core_num;
+    uint64_t us;
+} bench_worker_t;
+
+static void *bench_thread(void *param) {
+    bench_worker_t *worker = (bench_worker_t *)param;
+    thread_core_num = worker->core_num;
+    worker->us = bench_batches(worker->allocator);
+    pool_flush_magazine(&pool);
+    return NULL;
+}
+
+static uint64_t bench_threads(const allocator_t *allocator) {
+    pthread_t threads[NUM_CORES];
+    bench_worker_t workers[NUM_CORES];
+    uint64_t start = time_us_64();
+    for (uint i = 0; i < NUM_CORES; i++) {
+        workers[i] = (bench_worker_t) { .allocator = allocator, .core_num = i };
+        pthread_create(&threads[i], NULL, bench_thread, &workers[i]);
+    }
+    for (uint i = 0; i < NUM_CORES; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return time_us_64() - start;
+}
+
+static void print_bench(const char *allocator, uint magazine_size, const char *what, uint64_t us, uint ops) {
+    char name[32];
+    snprintf(name, sizeof(name), magazine_size ? "%s (magazine %u)" : "%s", allocator, magazine_size);
+    printf("%-20s %-22s %6.1f ns per alloc and free\n", name, what, (double)us * 1000.0 / ops);
+}
+
+static void run_benchmarks(void) {
+    for (uint a = 0; a < count_of(bench_allocators); a++) {
+        const allocator_t *allocator = &bench_allocators[a];
+        bool is_pool = allocator->alloc == bench_pool_alloc;
+        for (uint magazine_size = 0; magazine_size <= (is_pool ? PICO_POOL_MAGAZINE_SIZE : 0); magazine_size += 8) {
+            if (is_pool) {
+                pool_init_with_storage(&pool, storage, BLOCK_SIZE, BLOCK_COUNT, PICO_SPINLOCK_ID_STRIPED_FIRST);
+                pool_set_magazine_size(&pool, magazine_size);
+            }
+            print_bench(allocator->name, magazine_size, "pairs", bench_pairs(allocator), BENCH_ITERATIONS);
+            print_bench(allocator->name, magazine_size, "batches", bench_batches(allocator), BENCH_ITERATIONS);
+            print_bench(allocator->name, magazine_size, "batches on two cores", bench_threads(allocator),
+                        NUM_CORES * BENCH_ITERATIONS);
+        }
+    }
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    pool_stats_t stats;
+    void *blocks[BLOCK_COUNT];
+
+    PICOTEST_START_SECTION("alloc and free");
+        pool_init_with_storage(&pool, storage, BLOCK_SIZE, BLOCK_COUNT, PICO_SPINLOCK_ID_STRIPED_FIRST);
+        bool ok = true;
+        for (uint i = 0; i < BLOCK_COUNT; i++) {
+            blocks[i] = pool_alloc(&pool);
+            ok &= blocks[i] && pool_owns(&pool, blocks[i]) && !((uintptr_t)blocks[i] & (sizeof(void *) - 1));
+            if (blocks[i]) memset(blocks[i], (int)i, BLOCK_SIZE);
+        }
+        PICOTEST_CHECK(ok, "bad block allocated");
+        for (uint i = 0; i < BLOCK_COUNT; i++) {
+            for (uint j = 0; j < BLOCK_SIZE; j++) ok &= ((uint8_t *)blocks[i])[j] == (uint8_t)i;
+        }
+        PICOTEST_CHECK(ok, "blocks overlap");
+        PICOTEST_CHECK(!pool_alloc(&pool), "allocated more blocks than the pool has");
+        pool_get_stats(&pool, &stats);
+        PICOTEST_CHECK(stats.block_size == POOL_BLOCK_STRIDE(BLOCK_SIZE) && stats.block_count == BLOCK_COUNT,
+                       "wrong pool size");
+        PICOTEST_CHECK(stats.in_use == BLOCK_COUNT && stats.high_water == BLOCK_COUNT && stats.failed == 1,
+                       "wrong statistics when full");
+        for (uint i = 0; i < BLOCK_COUNT; i += 2) pool_free(&pool, blocks[i]);
+        pool_free(&pool, NULL);
+        pool_get_stats(&pool, &stats);
+        PICOTEST_CHECK(stats.in_use == BLOCK_COUNT / 2 && stats.high_water == BLOCK_COUNT,
+                       "wrong statistics after free");
+        // freed blocks are reused, each once (their contents can't be checked, as the free list overwrites them)
+        bool reused[BLOCK_COUNT] = { 0 };
+        for (uint i = 0; i < BLOCK_COUNT; i += 2) {
+            void *block = pool_alloc(&pool);
+            uint j = 0;
+            while (j < BLOCK_COUNT && blocks[j] != block) j++;
+            ok &= j < BLOCK_COUNT && !(j & 1) && !reused[j];
+            if (j < BLOCK_COUNT) reused[j] = true;
+        }
+        PICOTEST_CHECK(ok, "freed block not reused");
+        PICOTEST_CHECK(!pool_owns(&pool, storage + 1) && !pool_owns(&pool, storage + sizeof(storage)),
+                       "pool_owns accepted a pointer which isn't a block");
+        pool_deinit(&pool);
+
+        PICOTEST_CHECK(pool_init(&pool, 1, 3), "pool_init failed");
+        pool_get_stats(&pool, &stats);
+        PICOTEST_CHECK(stats.block_size == sizeof(void *), "block smaller than a pointer");
+        for (uint i = 0; i < 3; i++) blocks[i] = pool_alloc(&pool);
+        PICOTEST_CHECK(blocks[0] && blocks[1] && blocks[2] && !pool_alloc(&pool), "wrong number of blocks");
+        pool_deinit(&pool);
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("magazines");
+        pool_init_with_storage(&pool, storage, BLOCK_SIZE, BLOCK_COUNT, PICO_SPINLOCK_ID_STRIPED_FIRST);
+        pool_set_magazine_size(&pool, PICO_POOL_MAGAZINE_SIZE);
+        blocks[0] = pool_alloc(&pool);
+        pool_get_stats(&pool, &stats);
+        // the first allocation fills half a magazine
+        PICOTEST_CHECK(stats.in_use == 1 && stats.cached == PICO_POOL_MAGAZINE_SIZE / 2 - 1, "magazine not filled");
+        bool ok = true;
+        for (uint i = 1; i < BLOCK_COUNT; i++) {
+            blocks[i] = pool_alloc(&pool);
+            ok &= blocks[i] != NULL;
+        }
+        PICOTEST_CHECK(ok && !pool_alloc(&pool), "wrong number of blocks");
+        for (uint i = 0; i < BLOCK_COUNT; i++) pool_free(&pool, blocks[i]);
+        pool_get_stats(&pool, &stats);
+        PICOTEST_CHECK(stats.in_use == 0 && stats.cached && stats.cached <= PICO_POOL_MAGAZINE_SIZE &&
+                       stats.high_water == BLOCK_COUNT && stats.failed == 1, "wrong statistics after free");
+        // blocks cached by core 0 are not available to core 1 until flushed
+        thread_core_num = 1;
+        for (uint i = 0; i < BLOCK_COUNT; i++) blocks[i] = pool_alloc(&pool);
+        PICOTEST_CHECK(!blocks[BLOCK_COUNT - stats.cached], "core 1 allocated a block cached by core 0");
+        thread_core_num = 0;
+        pool_flush_magazine(&pool);
+        thread_core_num = 1;
+        PICOTEST_CHECK(pool_alloc(&pool), "flushed blocks not available to core 1");
+        thread_core_num = 0;
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("two cores");
+        for (uint magazine_size = 0; magazine_size <= PICO_POOL_MAGAZINE_SIZE;
+             magazine_size += MAX(PICO_POOL_MAGAZINE_SIZE, 1)) {
+            pool_init_with_storage(&pool, storage, BLOCK_SIZE, BLOCK_COUNT, PICO_SPINLOCK_ID_STRIPED_FIRST);
+            pool_set_magazine_size(&pool, magazine_size);
+            PICOTEST_CHECK(run_thread_test(), "block corrupted or allocation failed");
+            pool_get_stats(&pool, &stats);
+            PICOTEST_CHECK(stats.in_use == 0 && stats.cached == 0 && stats.failed == 0 &&
+                           stats.high_water <= NUM_CORES * (THREAD_BLOCKS + magazine_size), "wrong statistics");
+        }
+    PICOTEST_END_SECTION();
+
+    run_benchmarks();
+
+    PICOTEST_END_TEST();
+}
@@ -0,0 +1,354 @@
+/**
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if !PICO_ON_DEVICE
+#include <time.h>
+#endif
+
+#include "pico/stdlib.h"
+#include "pico/tlsf.h"
+#include "pico/test.h"
+
+PICOTEST_MODULE_NAME("TLSF", "TLSF heap test");
+
+#define HEAP_SIZE (64 * 1024)
+#define SECOND_HEAP_SIZE (16 * 1024)
+#define SLOTS 128
+#define MAX_ALLOC 2048
+#define STRESS_ITERATIONS 100000
+#define BENCH_ITERATIONS 200000
+
+static uint8_t __aligned(8) heap_memory[HEAP_SIZE];
+static uint8_t __aligned(8) second_heap_memory[SECOND_HEAP_SIZE];
+static uint8_t __aligned(8) extra_heap_memory[PICO_TLSF_MAX_REGIONS][1024];
+static tlsf_t tlsf;
+
+static uint32_t rand_state;
+
+static uint32_t next_rand(void) {
+    // xorshift32
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+}
+
+// a random size, mostly small, as most allocations are
+static size_t rand_size(void) {
+    uint32_t r = next_rand();
+    return (r & 3) ? (r >> 8) % 128 + 1 : (r >> 8) % MAX_ALLOC + 1;
+}
+
+typedef struct {
+    uint8_t *mem;
+    size_t size;
+    uint8_t pattern;
+} slot_t;
+
+static slot_t slots[SLOTS];
+
+static void fill_slot(slot_t *slot, uint8_t pattern) {
+    slot->pattern = pattern;
+    memset(slot->mem, pattern, slot->size);
+}
+
+static bool slot_intact(const slot_t *slot) {
+    for (size_t i = 0; i < slot->size; i++) {
+        if (slot->mem[i] != slot->pattern) return false;
+    }
+    return true;
+}
+
+static bool owned_by(const void *mem, size_t size, const uint8_t *region, size_t region_size) {
+    const uint8_t *p = (const uint8_t *)mem;
+    return p >= region && p + size <= region + region_size;
+}
+
+static bool in_heap(const void *mem, size_t size) {
+    return owned_by(mem, size, heap_memory, sizeof(heap_memory)) ||
+           owned_by(mem, size, second_heap_memory, sizeof(second_heap_memory));
+}
+
+// Allocate, reallocate and free at random, checking that no block overlaps another and the heap stays consistent
+static bool run_stress(uint iterations) {
+    bool ok = true;
+    for (uint i = 0; i < iterations && ok; i++) {
+        slot_t *slot = &slots[next_rand() % SLOTS];
+        if (slot->mem) {
+            ok &= slot_intact(slot);
+            if (next_rand() & 1) {
+                size_t size = rand_size();
+                uint8_t *mem = (uint8_t *)tlsf_realloc(&tlsf, slot->mem, size);
+                if (mem) {
+                    // the contents up to the smaller size are kept
+                    slot->mem = mem;
+                    if (size < slot->size) slot->size = size;
+                    ok &= slot_intact(slot);
+                    slot->size = size;
+                    fill_slot(slot, (uint8_t)i);
+                }
+            } else {
+                tlsf_free(&tlsf, slot->mem);
+                slot->mem = NULL;
+            }
+        } else {
+            slot->size = rand_size();
+            slot->mem = (uint8_t *)((next_rand() & 7) ? tlsf_malloc(&tlsf, slot->size) :
+                                    tlsf_memalign(&tlsf, 16u << (next_rand() % 6), slot->size));
+            if (slot->mem) {
+                ok &= !((uintptr_t)slot->mem & (TLSF_ALIGN_SIZE - 1)) && in_heap(slot->mem, slot->size) &&
+                      tlsf_block_size(slot->mem) >= slot->size;
+                fill_slot(slot, (uint8_t)i);
+            }
+        }
+        if (!(i % 1000)) ok &= tlsf_check(&tlsf);
+    }
+    return ok && tlsf_check(&tlsf);
+}
+
+static void free_slots(void) {
+    for (uint i = 0; i < SLOTS; i++) {
+        tlsf_free(&tlsf, slots[i].mem);
+        slots[i].mem = NULL;
+    }
+}
+
+// Benchmark: the same random sequence of allocations and frees of mixed sizes, which fragments the heap, with the TLSF
+// heap and the C library's allocator, timing every call to find the worst case as well as the average
+
+typedef struct {
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*free)(void *mem);
+} allocator_t;
+
+static void *bench_tlsf_malloc(size_t size) {
+    return tlsf_malloc(&tlsf, size);
+}
+
+static void bench_tlsf_free(void *mem) {
+    tlsf_free(&tlsf, mem);
+}
+
+static const allocator_t bench_allocators[] = {
+    { "malloc", malloc, free },
+    { "tlsf", bench_tlsf_malloc, bench_tlsf_free },
+};
+
+static uint64_t time_ns(void) {
+#if PICO_ON_DEVICE
+    return time_us_64() * 1000;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+typedef struct {
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint count;
+} latency_t;
+
+static void record(latency_t *latency, uint64_t ns) {
+    latency->total_ns += ns;
+    if (ns > latency->max_ns) latency->max_ns = ns;
+    latency->count++;
+}
+
+static void run_benchmark(const allocator_t *allocator) {
+    latency_t alloc_latency = { 0 }, free_latency = { 0 };
+    uint failed = 0;
+    rand_state = 0x5eed;
+    for (uint i = 0; i < BENCH_ITERATIONS; i++) {
+        slot_t *slot = &slots[next_rand() % SLOTS];
+        uint64_t start = time_ns();
+        if (slot->mem) {
+            allocator->free(slot->mem);
+            record(&free_latency, time_ns() - start);
+            slot->mem = NULL;
+        } else {
+            slot->mem = allocator->alloc(rand_size());
+            record(&alloc_latency, time_ns() - start);
+            if (slot->mem) {
+                *(volatile uint8_t *)slot->mem = 0;
+            } else {
+                failed++;
+            }
+        }
+    }
+    printf("%-8s alloc %5.1f ns average %6u ns worst, free %5.1f ns average %6u ns worst, %u failed\n",
+           allocator->name, (double)alloc_latency.total_ns / alloc_latency.count, (uint)alloc_latency.max_ns,
+           (double)free_latency.total_ns / free_latency.count, (uint)free_latency.max_ns, failed);
+    if (allocator->alloc == bench_tlsf_malloc) {
+        tlsf_stats_t stats;
+        tlsf_get_stats(&tlsf, &stats);
+        printf("         %u of %u bytes free in %u blocks, largest %u (%u%% fragmentation), high water %u bytes\n",
+               (uint)stats.free_size, (uint)stats.total_size, stats.free_blocks, (uint)stats.largest_free_block,
+               stats.fragmentation, (uint)stats.high_water);
+    }
+    for (uint i = 0; i < SLOTS; i++) {
+        allocator->free(slots[i].mem);
+        slots[i].mem = NULL;
+    }
+}
+
+int main() {
+    stdio_init_all();
+
+    PICOTEST_START();
+
+    tlsf_stats_t stats;
+    size_t total;
+
+    PICOTEST_START_SECTION("alloc and free");
+        tlsf_init(&tlsf);
+        PICOTEST_CHECK(!tlsf_malloc(&tlsf, 1), "allocated from an empty heap");
+        PICOTEST_CHECK(tlsf_add_region(&tlsf, heap_memory, sizeof(heap_memory)), "tlsf_add_region failed");
+        PICOTEST_CHECK(tlsf_check(&tlsf), "new heap inconsistent");
+        tlsf_get_stats(&tlsf, &stats);
+        total = stats.total_size;
+        PICOTEST_CHECK(total > HEAP_SIZE - 64 && total < HEAP_SIZE && stats.free_size == total &&
+                       stats.largest_free_block == total && stats.free_blocks == 1 && !stats.used_blocks &&
+                       !stats.fragmentation, "wrong statistics for a new heap");
+
+        bool ok = true;
+        for (uint i = 0; i < 8; i++) {
+            slots[i].size = 100 * i;
+            slots[i].mem = (uint8_t *)tlsf_malloc(&tlsf, slots[i].size);
+            ok &= slots[i].mem && in_heap(slots[i].mem, slots[i].size) &&
+                  !((uintptr_t)slots[i].mem & (TLSF_ALIGN_SIZE - 1));
+            if (slots[i].mem) fill_slot(&slots[i], (uint8_t)(i + 1));
+        }
+        PICOTEST_CHECK(ok, "bad block allocated");
+        for (uint i = 0; i < 8; i++) ok &= slot_intact(&slots[i]);
+        PICOTEST_CHECK(ok && tlsf_check(&tlsf), "blocks overlap");
+        tlsf_get_stats(&tlsf, &stats);
+        PICOTEST_CHECK(stats.used_blocks == 8 && stats.used_size >= 2800 && stats.high_water == stats.used_size,
+                       "wrong statistics after allocation");
+        size_t high_water = stats.high_water;
+
+        PICOTEST_CHECK(!tlsf_malloc(&tlsf, HEAP_SIZE), "allocated more than the heap");
+        PICOTEST_CHECK(!tlsf_malloc(&tlsf, SIZE_MAX - 16), "allocated a huge size");
+        tlsf_get_stats(&tlsf, &stats);
+        // as is the one from the empty heap
+        PICOTEST_CHECK(stats.failed == 3, "failed allocations not counted");
+
+        // freeing every other block leaves holes which can't be merged (except the last, which merges with the rest of
+        // the heap)
+        for (uint i = 1; i < 8; i += 2) {
+            tlsf_free(&tlsf, slots[i].mem);
+            slots[i].mem = NULL;
+        }
+        tlsf_free(&tlsf, NULL);
+        PICOTEST_CHECK(tlsf_check(&tlsf), "heap inconsistent after free");
+        tlsf_get_stats(&tlsf, &stats);
+        PICOTEST_CHECK(stats.used_blocks == 4 && stats.free_blocks == 4 && stats.fragmentation > 0 &&
+                       stats.free_size + stats.used_size + 7 * 8 == total && stats.high_water == high_water,
+                       "wrong statistics with holes");
+        free_slots();
+        tlsf_get_stats(&tlsf, &stats);
+        PICOTEST_CHECK(stats.free_blocks == 1 && stats.free_size == total && !stats.used_size,
+                       "free blocks not merged");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("memalign");
+        bool ok = true;
+        for (uint i = 0; i < 10; i++) {
+            size_t align = 8u << i;
+            slots[i].size = 24 * i + 1;
+            slots[i].mem = (uint8_t *)tlsf_memalign(&tlsf, align, slots[i].size);
+            ok &= slots[i].mem && !((uintptr_t)slots[i].mem & (align - 1)) && in_heap(slots[i].mem, slots[i].size);
+            if (slots[i].mem) fill_slot(&slots[i], (uint8_t)(i + 1));
+        }
+        PICOTEST_CHECK(ok, "misaligned block");
+        for (uint i = 0; i < 10; i++) ok &= slot_intact(&slots[i]);
+        PICOTEST_CHECK(ok && tlsf_check(&tlsf), "aligned blocks overlap");
+        free_slots();
+        tlsf_get_stats(&tlsf, &stats);
+        PICOTEST_CHECK(stats.free_blocks == 1 && !stats.used_blocks, "aligned blocks not freed");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("realloc");
+        slots[0].size = 40;
+        slots[0].mem = (uint8_t *)tlsf_realloc(&tlsf, NULL, slots[0].size);
+        PICOTEST_CHECK(slots[0].mem, "realloc of NULL failed");
+        fill_slot(&slots[0], 0x11);
+        // with nothing after it, the block grows in place
+        uint8_t *mem = (uint8_t *)tlsf_realloc(&tlsf, slots[0].mem, 1000);
+        PICOTEST_CHECK(mem == slots[0].mem && slot_intact(&slots[0]), "block not grown in place");
+        slots[0].size = 1000;
+        fill_slot(&slots[0], 0x22);
+        slots[1].size = 16;
+        slots[1].mem = (uint8_t *)tlsf_malloc(&tlsf, slots[1].size);
+        fill_slot(&slots[1], 0x33);
+        // now it has to move
+        mem = (uint8_t *)tlsf_realloc(&tlsf, slots[0].mem, 4000);
+        PICOTEST_CHECK(mem && mem != slots[0].mem, "block not moved");
+        slots[0].mem = mem;
+        PICOTEST_CHECK(slot_intact(&slots[0]) && slot_intact(&slots[1]), "contents not kept");
+        mem = (uint8_t *)tlsf_realloc(&tlsf, slots[0].mem, 10);
+        PICOTEST_CHECK(mem == slots[0].mem && tlsf_block_size(mem) < 1000, "block not shrunk in place");
+        slots[0].size = 10;
+        PICOTEST_CHECK(slot_intact(&slots[0]) && tlsf_check(&tlsf), "heap inconsistent after realloc");
+        PICOTEST_CHECK(!tlsf_realloc(&tlsf, slots[0].mem, HEAP_SIZE) && slot_intact(&slots[0]),
+                       "failed realloc lost the block");
+        PICOTEST_CHECK(!tlsf_realloc(&tlsf, slots[0].mem, 0), "realloc to 0 didn't free");
+        slots[0].mem = NULL;
+        free_slots();
+        tlsf_get_stats(&tlsf, &stats);
+        PICOTEST_CHECK(stats.free_blocks == 1 && !stats.used_blocks && tlsf_check(&tlsf), "blocks not freed");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("regions");
+        PICOTEST_CHECK(!tlsf_add_region(&tlsf, second_heap_memory, 8), "added a region too small for a block");
+        PICOTEST_CHECK(tlsf_add_region(&tlsf, second_heap_memory, sizeof(second_heap_memory)),
+                       "tlsf_add_region failed");
+        tlsf_get_stats(&tlsf, &stats);
+        PICOTEST_CHECK(stats.free_blocks == 2 && stats.total_size > total + SECOND_HEAP_SIZE - 64 &&
+                       stats.largest_free_block == total, "wrong statistics with two regions");
+        // a block bigger than the second region comes from the first; a smaller one from the second, which fits it better
+        slots[0].mem = (uint8_t *)tlsf_malloc(&tlsf, HEAP_SIZE / 2);
+        slots[1].mem = (uint8_t *)tlsf_malloc(&tlsf, SECOND_HEAP_SIZE / 2);
+        PICOTEST_CHECK(owned_by(slots[0].mem, HEAP_SIZE / 2, heap_memory, sizeof(heap_memory)) &&
+                       owned_by(slots[1].mem, SECOND_HEAP_SIZE / 2, second_heap_memory, sizeof(second_heap_memory)),
+                       "blocks not allocated from the expected regions");
+        // freeing doesn't merge blocks of different regions
+        free_slots();
+        tlsf_get_stats(&tlsf, &stats);
+        PICOTEST_CHECK(stats.free_blocks == 2 && tlsf_check(&tlsf), "regions merged");
+        bool ok = true;
+        for (uint i = 2; i < PICO_TLSF_MAX_REGIONS; i++) {
+            ok &= tlsf_add_region(&tlsf, extra_heap_memory[i], sizeof(extra_heap_memory[i]));
+        }
+        PICOTEST_CHECK(ok && !tlsf_add_region(&tlsf, extra_heap_memory[0], sizeof(extra_heap_memory[0])),
+                       "wrong number of regions");
+    PICOTEST_END_SECTION();
+
+    PICOTEST_START_SECTION("stress");
+        tlsf_init(&tlsf);
+        tlsf_add_region(&tlsf, heap_memory, sizeof(heap_memory));
+        tlsf_add_region(&tlsf, second_heap_memory, sizeof(second_heap_memory));
+        rand_state = 0x1234;
+        PICOTEST_CHECK(run_stress(STRESS_ITERATIONS), "block corrupted or heap inconsistent");
+        free_slots();
+        tlsf_get_stats(&tlsf, &stats);
+        PICOTEST_CHECK(stats.free_blocks == 2 && !stats.used_blocks && !stats.used_size && tlsf_check(&tlsf),
+                       "heap not restored after freeing everything");
+    PICOTEST_END_SECTION();
+
+    tlsf_init(&tlsf);
+    tlsf_add_region(&tlsf, heap_memory, sizeof(heap_memory));
+    for (uint a = 0; a < count_of(bench_allocators); a++) {
+        run_benchmark(&bench_allocators[a]);
+    }
+
+    PICOTEST_END_TEST();
+}
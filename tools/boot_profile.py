@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#
+# Script to turn the output of boot_profile_print() (see pico_boot_profile) into a report of where the time between
+# reset and main() went.
+#
+# The capture may contain other output too (e.g. a whole serial console log); only the lines containing
+# "boot_profile:" are looked at. If the capture contains several boots, the last one is reported.
+#
+# Steps which finished before clk_sys was configured have no known frequency, so are reported in cycles only, unless
+# --boot-hz gives the frequency the core was running at before then.
+#
+# Usage:
+#
+# tools/boot_profile.py [--sort] [--boot-hz HZ] [capture file]
+
+
+import re
+import sys
+import argparse
+
+BEGIN_RE = re.compile(r'boot_profile: begin (\d+) (\d+)\s*$')
+RECORD_RE = re.compile(r'boot_profile: (\d+) 0x([0-9a-fA-F]+) (\d+) (\d+) (.*?)\s*$')
+END_RE = re.compile(r'boot_profile: end\s*$')
+
+
+class Step:
+    def __init__(self, index, func, cycles, sys_hz, label):
+        self.index = index
+        self.func = func
+        self.cycles = cycles
+        self.sys_hz = sys_hz
+        if label == '-':
+            self.priority = '?'
+            self.name = 'initializer at 0x{:08x}'.format(func)
+        elif ' ' in label:
+            self.priority, self.name = label.split(' ', 1)
+        else:
+            self.priority = ''
+            self.name = label
+        self.us = None
+        self.estimated = False
+
+
+def parse_capture(lines):
+    """
+    Returns (steps, dropped) for the last complete capture in lines, or None if there isn't one
+    """
+    capture = None
+    current = None
+    for line in lines:
+        if 'boot_profile:' not in line:
+            continue
+        m = BEGIN_RE.search(line)
+        if m:
+            current = ([], int(m.group(2)))
+            continue
+        if current is None:
+            continue
+        m = RECORD_RE.search(line)
+        if m:
+            current[0].append(Step(int(m.group(1)), int(m.group(2), 16), int(m.group(3)), int(m.group(4)), m.group(5)))
+        elif END_RE.search(line):
+            capture = current
+            current = None
+    return capture
+
+
+parser = argparse.ArgumentParser(description="Report the boot time profile captured from boot_profile_print()")
+parser.add_argument("input", nargs="?", help="Capture file (default: standard input)")
+parser.add_argument("--boot-hz", type=int, help="Core clock frequency before clk_sys was configured, for estimating the time of the earliest steps")
+parser.add_argument("--sort", action="store_true", help="List the steps slowest first, rather than in the order they ran")
+args = parser.parse_args()
+
+if args.input:
+    with open(args.input, encoding="ISO-8859-1") as fh:
+        capture = parse_capture(fh)
+else:
+    capture = parse_capture(sys.stdin)
+
+if capture is None:
+    print("No complete boot_profile capture found", file=sys.stderr)
+    sys.exit(1)
+
+steps, dropped = capture
+for step in steps:
+    if step.sys_hz:
+        step.us = step.cycles * 1000000 / step.sys_hz
+    elif args.boot_hz:
+        step.us = step.cycles * 1000000 / args.boot_hz
+        step.estimated = True
+
+total_cycles = sum(step.cycles for step in steps)
+total_us = sum(step.us for step in steps if step.us is not None)
+unknown = sum(1 for step in steps if step.us is None)
+
+ordered = sorted(steps, key=lambda step: (step.us if step.us is not None else -1, step.cycles), reverse=True) if args.sort else steps
+
+name_width = max([len('step')] + [len(step.name) for step in steps])
+print("{:>3}  {:<11}  {:<{}}  {:>10}  {:>7}  {:>10}  {:>6}  {:>10}".format("#", "priority", "step", name_width, "cycles", "MHz", "us", "%", "total us"))
+running_us = 0
+for step in ordered:
+    mhz = "{:.1f}".format(step.sys_hz / 1e6) if step.sys_hz else "?"
+    if step.us is None:
+        us = "?"
+        percent = ""
+    else:
+        us = "{:.1f}{}".format(step.us, "*" if step.estimated else "")
+        percent = "{:.1f}".format(100 * step.us / total_us) if total_us else ""
+        running_us += step.us
+    cumulative = "{:.1f}".format(running_us) if not args.sort else ""
+    print("{:>3}  {:<11}  {:<{}}  {:>10}  {:>7}  {:>10}  {:>6}  {:>10}".format(step.index, step.priority, step.name, name_width, step.cycles, mhz, us, percent, cumulative).rstrip())
+
+print()
+print("{} steps, {} cycles, {:.1f} us".format(len(steps), total_cycles, total_us))
+if any(step.estimated for step in steps):
+    print("* estimated from --boot-hz={}".format(args.boot_hz))
+if unknown:
+    print("{} steps finished before clk_sys was configured, so are not included in the time; use --boot-hz to estimate them".format(unknown))
+if dropped:
+    print("{} more steps ran but were not recorded; increase PICO_BOOT_PROFILE_MAX_RECORDS to see them".format(dropped))
@@ -1,12 +1,12 @@
 #!/bin/bash
 
-EXIT_CODE=0
+# The headers are independent of each other, so check them in parallel (one per CPU); xargs exits with a non-zero
+# status if any of the checks fail
+JOBS=$(nproc 2>/dev/null || echo 1)
 
-for HEADER in src/boards/include/boards/*.h; do
-    tools/check_board_header.py $HEADER
-    if [[ $? -ne 0 ]]; then
-      EXIT_CODE=1
-    fi
-done
+printf '%s\0' src/boards/include/boards/*.h | xargs -0 -n 1 -P "$JOBS" tools/check_board_header.py
+if [[ $? -ne 0 ]]; then
+  exit 1
+fi
 
-exit $EXIT_CODE
+exit 0
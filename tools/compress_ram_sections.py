@@ -0,0 +1,484 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#
+# Script to LZ4 compress the RAM sections of a linked RP2040/RP2350 ELF file, i.e. those crt0 copies from flash using
+# its data copy table (.data, the scratch sections, and for a copy_to_ram binary, the code). It is run after linking
+# by pico_compress_ram_sections(), which also builds crt0 to decompress them.
+#
+# The source of each copy table entry is compressed (unless that does not make it smaller), and the results are
+# packed together from where the first of them was in flash, followed by the RP2350 end block if there is one. The
+# table entries are pointed at the new sources, with bit 0 set on those which are compressed, and the BINARY_END
+# binary info and the picobin block links are updated for the new end of the binary. In the ELF file:
+#   - the original RAM sections become NOBITS, and their segments no longer have any file contents
+#   - the packed data is added as a new section, .ram_sections_lz4, with its own segment
+#   - the end block's section, segment and symbols are moved; other symbols (e.g. __etext) are left as they were
+#
+# Each compressed section is decompressed again to check it. The ELF file is left unchanged if anything other than
+# the RAM sections and the end block follows them in flash, as this would have to be moved too.
+#
+# The compressor is an exact port of lz4_compress() in src/common/pico_lz4/lz4.c, so any change to one must be made
+# to the other.
+#
+# Usage:
+#
+# tools/compress_ram_sections.py [--quiet] [--verbose] [-o OUTPUT] <ELF file>
+
+
+import os
+import sys
+import struct
+import argparse
+
+LZ4_MIN_MATCH = 4
+LZ4_MAX_OFFSET = 65535
+LZ4_LAST_LITERALS = 5
+LZ4_MATCH_FIND_LIMIT = 12
+LZ4_SKIP_TRIGGER = 6
+LZ4_HASH_BITS = 12  # PICO_LZ4_HASH_BITS
+
+SECTION_NAME = '.ram_sections_lz4'
+END_SECTION_NAME = '.flash_end'
+
+BINARY_INFO_TYPE_ID_AND_INT = 5
+BINARY_INFO_TAG_RASPBERRY_PI = ord('R') | (ord('P') << 8)
+BINARY_INFO_ID_RP_BINARY_END = 0x68f465de
+
+ELF_HEADER = struct.Struct('<16sHHIIIIIHHHHHH')
+PROGRAM_HEADER = struct.Struct('<8I')
+SECTION_HEADER = struct.Struct('<10I')
+SYMBOL = struct.Struct('<IIIBBH')
+
+PT_LOAD = 1
+SHT_PROGBITS = 1
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_ALLOC = 2
+
+
+class CompressError(Exception):
+    pass
+
+
+def read_length(data, pos):
+    length = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        length += b
+        if b != 255:
+            return length, pos
+
+
+def lz4_decompress(data, size):
+    out = bytearray()
+    pos = 0
+    while True:
+        token = data[pos]
+        pos += 1
+        literal_len = token >> 4
+        if literal_len == 15:
+            extra, pos = read_length(data, pos)
+            literal_len += extra
+        out += data[pos:pos + literal_len]
+        pos += literal_len
+        if pos >= len(data):
+            break
+        offset = data[pos] | (data[pos + 1] << 8)
+        pos += 2
+        if not offset or offset > len(out):
+            raise CompressError("bad match offset")
+        match_len = (token & 15) + LZ4_MIN_MATCH
+        if match_len == 15 + LZ4_MIN_MATCH:
+            extra, pos = read_length(data, pos)
+            match_len += extra
+        start = len(out) - offset
+        if offset >= match_len:
+            out += out[start:start + match_len]
+        else:
+            for i in range(match_len):
+                out.append(out[start + i])
+    if len(out) != size:
+        raise CompressError("decompressed to {} bytes rather than {}".format(len(out), size))
+    return bytes(out)
+
+
+def write_length(out, length):
+    length -= 15
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def write_sequence(out, literals, offset, match_len):
+    token = min(len(literals), 15) << 4
+    if match_len:
+        token |= min(match_len - LZ4_MIN_MATCH, 15)
+    out.append(token)
+    if len(literals) >= 15:
+        write_length(out, len(literals))
+    out += literals
+    if match_len:
+        out.append(offset & 0xff)
+        out.append(offset >> 8)
+        if match_len - LZ4_MIN_MATCH >= 15:
+            write_length(out, match_len - LZ4_MIN_MATCH)
+
+
+def lz4_compress(data):
+    def hash_u32(value):
+        return ((value * 2654435761) & 0xffffffff) >> (32 - LZ4_HASH_BITS)
+
+    def read_u32(pos):
+        return data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16) | (data[pos + 3] << 24)
+
+    out = bytearray()
+    anchor = 0
+    if len(data) > LZ4_MATCH_FIND_LIMIT:
+        table = [0] * (1 << LZ4_HASH_BITS)
+        match_limit = len(data) - LZ4_MATCH_FIND_LIMIT
+        extend_limit = len(data) - LZ4_LAST_LITERALS
+        pos = 0
+        misses = 1 << LZ4_SKIP_TRIGGER
+        while pos < match_limit:
+            value = read_u32(pos)
+            h = hash_u32(value)
+            candidate = table[h]
+            table[h] = pos + 1
+            if not candidate or pos - (candidate - 1) > LZ4_MAX_OFFSET or read_u32(candidate - 1) != value:
+                pos += misses >> LZ4_SKIP_TRIGGER
+                misses += 1
+                continue
+            match = candidate - 1
+            while pos > anchor and match > 0 and data[pos - 1] == data[match - 1]:
+                pos -= 1
+                match -= 1
+            length = LZ4_MIN_MATCH
+            while pos + length < extend_limit and data[pos + length] == data[match + length]:
+                length += 1
+            write_sequence(out, data[anchor:pos], pos - match, length)
+            pos += length
+            anchor = pos
+            misses = 1 << LZ4_SKIP_TRIGGER
+            table[hash_u32(read_u32(pos - 2))] = pos - 2 + 1
+    write_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def align(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+
+class Segment:
+    def __init__(self, index, fields):
+        self.index = index
+        self.type, self.offset, self.vaddr, self.paddr, self.filesz, self.memsz, self.flags, self.align = fields
+
+    def pack(self):
+        return PROGRAM_HEADER.pack(self.type, self.offset, self.vaddr, self.paddr, self.filesz, self.memsz,
+                                   self.flags, self.align)
+
+
+class Section:
+    def __init__(self, index, fields):
+        self.index = index
+        self.name_offset, self.type, self.flags, self.addr, self.offset, self.size, self.link, self.info, \
+            self.addralign, self.entsize = fields
+        self.name = ''
+
+    def pack(self):
+        return SECTION_HEADER.pack(self.name_offset, self.type, self.flags, self.addr, self.offset, self.size,
+                                   self.link, self.info, self.addralign, self.entsize)
+
+    def has_contents(self):
+        return self.flags & SHF_ALLOC and self.type != SHT_NOBITS and self.size
+
+
+class ElfFile:
+    def __init__(self, data):
+        self.data = bytearray(data)
+        if len(data) < ELF_HEADER.size or data[:4] != b'\x7fELF':
+            raise CompressError("not an ELF file")
+        if data[4] != 1 or data[5] != 1:
+            raise CompressError("not a 32 bit little endian ELF file")
+        self.header = list(ELF_HEADER.unpack_from(data))
+        phoff, shoff = self.header[5], self.header[6]
+        phentsize, phnum, shentsize, shnum, self.shstrndx = self.header[9:14]
+        self.segments = [Segment(i, PROGRAM_HEADER.unpack_from(data, phoff + i * phentsize)) for i in range(phnum)]
+        self.sections = [Section(i, SECTION_HEADER.unpack_from(data, shoff + i * shentsize)) for i in range(shnum)]
+        strtab = self.sections[self.shstrndx]
+        for section in self.sections:
+            section.name = self.string(strtab, section.name_offset)
+        self.symbols = {}
+        self.symbol_entries = []
+        for symtab in (s for s in self.sections if s.type == SHT_SYMTAB):
+            for offset in range(symtab.offset, symtab.offset + symtab.size, SYMBOL.size):
+                name_offset, value, size, info, other, shndx = SYMBOL.unpack_from(data, offset)
+                name = self.string(self.sections[symtab.link], name_offset)
+                self.symbol_entries.append((value, shndx, offset))
+                if name and name not in self.symbols:
+                    self.symbols[name] = (value, shndx, offset)
+
+    def string(self, strtab, offset):
+        end = self.data.index(b'\0', strtab.offset + offset)
+        return self.data[strtab.offset + offset:end].decode('ISO-8859-1')
+
+    def symbol(self, name):
+        return self.symbols[name][0] if name in self.symbols else None
+
+    def section_named(self, name):
+        return next((s for s in self.sections if s.name == name), None)
+
+    def vma_offset(self, addr, size=4):
+        """The file offset of the contents at a (run time) address"""
+        for section in self.sections:
+            if section.has_contents() and section.addr <= addr and addr + size <= section.addr + section.size:
+                return section.offset + addr - section.addr
+        raise CompressError("no contents at 0x{:08x}".format(addr))
+
+    def read_word(self, addr):
+        return struct.unpack_from('<I', self.data, self.vma_offset(addr))[0]
+
+    def write_word(self, addr, value):
+        struct.pack_into('<I', self.data, self.vma_offset(addr), value)
+
+    def loaded_segments(self):
+        return [s for s in self.segments if s.type == PT_LOAD and s.filesz]
+
+    def read_lma(self, addr, size):
+        """The contents to be loaded at a load address, with any gaps as zeros"""
+        out = bytearray(size)
+        for segment in self.loaded_segments():
+            start = max(addr, segment.paddr)
+            end = min(addr + size, segment.paddr + segment.filesz)
+            if start < end:
+                offset = segment.offset + start - segment.paddr
+                out[start - addr:end - addr] = self.data[offset:offset + end - start]
+        return bytes(out)
+
+
+class CopyEntry:
+    def __init__(self, addr, src, dst, end):
+        self.addr = addr
+        self.src = src
+        self.dst = dst
+        self.end = end
+        self.segment = None
+        self.data = None
+        self.stored = None
+        self.compressed = False
+        self.new_src = src
+
+
+def compress_ram_sections(elf, verbose):
+    if elf.section_named(SECTION_NAME):
+        return "already compressed"
+    table_addr = elf.symbol('data_cpy_table')
+    if table_addr is None:
+        raise CompressError("no data_cpy_table symbol; is this an SDK binary?")
+    if elf.symbol('lz4_decompress_fast') is None:
+        raise CompressError("crt0 does not support compressed RAM sections; use pico_compress_ram_sections()")
+
+    entries = []
+    addr = table_addr
+    while elf.read_word(addr):
+        entries.append(CopyEntry(addr, elf.read_word(addr), elf.read_word(addr + 4), elf.read_word(addr + 8)))
+        addr += 12
+
+    # the entries to compress are those copying a whole segment loaded at a different address (so not e.g. boot2)
+    for entry in entries:
+        for segment in elf.loaded_segments():
+            if segment.vaddr != segment.paddr and segment.paddr <= entry.src < segment.paddr + segment.filesz:
+                if entry.dst != segment.vaddr + entry.src - segment.paddr:
+                    raise CompressError("copy table entry for 0x{:08x} does not match its segment".format(entry.dst))
+                entry.segment = segment
+    candidates = [e for e in entries if e.segment and e.end > e.dst]
+    if not candidates:
+        return "no RAM sections to compress"
+    first = min(e.src for e in candidates)
+    moved = [e for e in entries if e.src >= first]
+    if any(e.end > e.dst and not e.segment for e in moved):
+        raise CompressError("unexpected copy table entry after the RAM sections")
+
+    end_section = elf.section_named(END_SECTION_NAME)
+    if end_section and not end_section.has_contents():
+        end_section = None
+    end_segment = None
+    if end_section:
+        end_segment = next((s for s in elf.loaded_segments() if s.offset <= end_section.offset and
+                            end_section.offset + end_section.size <= s.offset + s.filesz), None)
+        if not end_segment or end_segment.filesz != end_section.size or end_segment.paddr < first:
+            raise CompressError("unexpected layout of the {} section".format(END_SECTION_NAME))
+
+    # everything loaded after the first RAM section must be a RAM section, or the end block
+    ram_segments = set()
+    for segment in elf.loaded_segments():
+        if segment.paddr + segment.filesz <= first or segment is end_segment:
+            continue
+        if not any(e.src <= segment.paddr and segment.paddr + segment.filesz <= e.src + e.end - e.dst
+                   for e in candidates):
+            raise CompressError("segment at 0x{:08x} (load address 0x{:08x}) follows the RAM sections in flash"
+                                .format(segment.vaddr, segment.paddr))
+        ram_segments.add(segment.index)
+
+    # compress, and pack from the first source address
+    pos = first
+    blob = bytearray()
+    report = []
+    for entry in moved:
+        pos = align(pos, 4)
+        blob += bytes(pos - first - len(blob))
+        entry.new_src = pos
+        if entry.end <= entry.dst:
+            continue
+        entry.data = elf.read_lma(entry.src, entry.end - entry.dst)
+        compressed = lz4_compress(entry.data)
+        if lz4_decompress(compressed, len(entry.data)) != entry.data:
+            raise CompressError("compression of 0x{:08x} did not round trip".format(entry.dst))
+        if align(len(compressed), 4) < len(entry.data):
+            entry.stored = compressed
+            entry.compressed = True
+        else:
+            entry.stored = entry.data
+        blob += entry.stored
+        pos += len(entry.stored)
+        report.append((entry, len(entry.data), len(entry.stored)))
+    pos = align(pos, 4)
+    blob += bytes(pos - first - len(blob))
+
+    old_end = max(s.paddr + s.filesz for s in elf.loaded_segments() if s.paddr + s.filesz > first and
+                  (s.index in ram_segments or s is end_segment))
+    new_end = pos
+    end_delta = 0
+    if end_section:
+        new_end_addr = align(pos, max(end_section.addralign, 4))
+        blob += bytes(new_end_addr - first - len(blob))
+        end_delta = new_end_addr - end_section.addr
+        new_end = new_end_addr + end_section.size
+    if new_end > old_end:
+        # can't happen, as sections which don't compress are stored as they are
+        raise CompressError("compressed RAM sections are larger")
+
+    # copy table sources
+    for entry in moved:
+        elf.write_word(entry.addr, entry.new_src | (1 if entry.compressed else 0))
+
+    # picobin block links, and the binary end
+    if end_section and end_delta:
+        block = elf.symbol('embedded_block')
+        block_end = elf.symbol('embedded_block_end')
+        end_block = elf.symbol('embedded_end_block')
+        end_block_end = elf.symbol('embedded_end_block_end')
+        if None not in (block, block_end, end_block, end_block_end):
+            if elf.read_word(block_end - 8) != (end_block - block) & 0xffffffff or \
+                    elf.read_word(end_block_end - 8) != (block - end_block) & 0xffffffff:
+                raise CompressError("unexpected picobin block links")
+            elf.write_word(block_end - 8, (end_block + end_delta - block) & 0xffffffff)
+            elf.write_word(end_block_end - 8, (block - end_block - end_delta) & 0xffffffff)
+    bi_start = elf.symbol('__binary_info_start')
+    bi_end = elf.symbol('__binary_info_end')
+    if bi_start is not None and bi_end is not None:
+        for addr in range(bi_start, bi_end, 4):
+            entry_addr = elf.read_word(addr)
+            try:
+                header = elf.read_word(entry_addr)
+            except CompressError:
+                # e.g. an entry in RAM
+                continue
+            if header == BINARY_INFO_TYPE_ID_AND_INT | (BINARY_INFO_TAG_RASPBERRY_PI << 16) and \
+                    elf.read_word(entry_addr + 4) == BINARY_INFO_ID_RP_BINARY_END:
+                elf.write_word(entry_addr + 8, new_end)
+
+    # the RAM sections no longer have contents in the file
+    for section in elf.sections:
+        if section.has_contents():
+            for segment in (s for s in elf.segments if s.index in ram_segments):
+                if segment.offset <= section.offset < segment.offset + segment.filesz:
+                    section.type = SHT_NOBITS
+    for segment in elf.segments:
+        if segment.index in ram_segments:
+            segment.filesz = 0
+            segment.paddr = segment.vaddr
+
+    # move the end block
+    if end_section:
+        end_section.addr += end_delta
+        end_segment.vaddr += end_delta
+        end_segment.paddr += end_delta
+        # the contents stay where they were in the file, so may no longer be page aligned
+        end_segment.align = min(end_segment.align, max(end_section.addralign, 4))
+        for value, shndx, offset in elf.symbol_entries:
+            if shndx == end_section.index:
+                struct.pack_into('<I', elf.data, offset + 4, value + end_delta)
+
+    # append the packed data, the new section name table, and the new program and section header tables
+    data = elf.data
+    blob_offset = align(len(data), 4)
+    data += bytes(blob_offset - len(data)) + blob
+    strtab = elf.sections[elf.shstrndx]
+    strtab_contents = data[strtab.offset:strtab.offset + strtab.size]
+    strtab.offset = len(data)
+    name_offset = len(strtab_contents)
+    strtab_contents += SECTION_NAME.encode() + b'\0'
+    strtab.size = len(strtab_contents)
+    data += strtab_contents
+    new_section = Section(len(elf.sections), (name_offset, SHT_PROGBITS, SHF_ALLOC, first, blob_offset, len(blob),
+                                              0, 0, 4, 0))
+    new_segment = Segment(None, (PT_LOAD, blob_offset, first, first, len(blob), len(blob), 4, 4))
+    # keep the new segment next to those before it in flash
+    segments = list(elf.segments)
+    index = max((i + 1 for i, s in enumerate(segments) if s.type == PT_LOAD and s.filesz and s.paddr < first),
+                default=0)
+    segments.insert(index, new_segment)
+    phoff = align(len(data), 4)
+    data += bytes(phoff - len(data))
+    for segment in segments:
+        data += segment.pack()
+    shoff = align(len(data), 4)
+    data += bytes(shoff - len(data))
+    for section in elf.sections + [new_section]:
+        data += section.pack()
+    header = elf.header
+    header[5], header[6] = phoff, shoff
+    header[9], header[10] = PROGRAM_HEADER.size, len(elf.segments) + 1
+    header[11], header[12] = SECTION_HEADER.size, len(elf.sections) + 1
+    ELF_HEADER.pack_into(data, 0, *header)
+
+    if verbose:
+        for entry, size, stored in report:
+            print("  0x{:08x}-0x{:08x}: {} bytes {} {} bytes at 0x{:08x}".format(
+                entry.dst, entry.end, size, "compressed to" if entry.compressed else "stored as", stored,
+                entry.new_src))
+    total = sum(size for entry, size, stored in report)
+    total_stored = sum(stored for entry, size, stored in report)
+    return "RAM sections {} bytes, compressed to {} bytes ({:.1f}%); binary is {} bytes smaller".format(
+        total, total_stored, 100 * total_stored / total, old_end - new_end)
+
+
+parser = argparse.ArgumentParser(description="LZ4 compress the RAM sections of an SDK binary built with pico_compress_ram_sections()")
+parser.add_argument("input", help="ELF file")
+parser.add_argument("-o", "--output", help="Output ELF file (default: update the input file)")
+parser.add_argument("-q", "--quiet", action="store_true", help="Don't report the sizes")
+parser.add_argument("-v", "--verbose", action="store_true", help="Report the size of each section")
+args = parser.parse_args()
+
+with open(args.input, 'rb') as fh:
+    elf_data = fh.read()
+try:
+    elf = ElfFile(elf_data)
+    result = compress_ram_sections(elf, args.verbose)
+except (CompressError, IndexError, ValueError, struct.error) as e:
+    print("{}: {}".format(args.input, e), file=sys.stderr)
+    sys.exit(1)
+
+output = args.output or args.input
+tmp_output = output + '.tmp'
+with open(tmp_output, 'wb') as fh:
+    fh.write(elf.data)
+os.replace(tmp_output, output)
+if not args.quiet:
+    print("{}: {}".format(os.path.basename(args.input), result))
@@ -22,6 +22,8 @@ import re
 import csv
 import logging
 
+import source_index
+
 from collections import defaultdict
 
 if sys.version_info < (3, 11):
@@ -133,71 +135,67 @@ errors = []
 
 # Scan all CMakeLists.txt and .cmake files in the specific path, recursively.
 
-for dirpath, dirnames, filenames in os.walk(scandir):
-    for filename in filenames:
-        file_ext = os.path.splitext(filename)[1]
-        if filename == 'CMakeLists.txt' or file_ext == '.cmake':
-            file_path = os.path.join(dirpath, filename)
-            applicable = "all"
-            for chip in (*CHIP_NAMES, "host"):
-                if "/{}/".format(chip) in dirpath:
-                    applicable = chip
-                    break
-
-            with open(file_path, encoding="ISO-8859-1") as fh:
-                linenum = 0
-                for line in fh.readlines():
-                    linenum += 1
-                    line = line.strip()
-                    if BASE_CONFIG_RE.search(line):
-                        errors.append(Exception("Found {} at {}:{} ({}) which isn't expected in {} files".format(BASE_CONFIG_NAME, file_path, linenum, line, filename if filename == 'CMakeLists.txt' else file_ext)))
-                    elif BASE_CMAKE_CONFIG_RE.search(line):
-                        m = CMAKE_CONFIG_RE.match(line)
-                        if not m:
-                            if re.match(r"^\s*#\s*# ", line):
-                                logger.info("Possible misformatted {} at {}:{} ({})".format(BASE_CMAKE_CONFIG_NAME, file_path, linenum, line))
-                            else:
-                                errors.append(Exception("Found misformatted {} at {}:{} ({})".format(BASE_CMAKE_CONFIG_NAME, file_path, linenum, line)))
-                        else:
-                            config_name = m.group(1)
-                            config_description = m.group(2)
-                            _attrs = m.group(3)
-                            # allow commas to appear inside brackets by converting them to and from NULL chars
-                            _attrs = re.sub(r'(\(.+\))', lambda m: m.group(1).replace(',', '\0'), _attrs)
-
-                            if '=' in config_description and not '==' in config_description:
-                                errors.append(Exception("For {} at {}:{} the description was set to '{}' - has the description field been omitted?".format(config_name, file_path, linenum, config_description)))
-                            all_descriptions = chips_all_descriptions[applicable]
-                            if config_description in all_descriptions:
-                                errors.append(Exception("Found description {} at {}:{} but it was already used at {}:{}".format(config_description, file_path, linenum, os.path.join(scandir, all_descriptions[config_description]['filename']), all_descriptions[config_description]['line_number'])))
-                            else:
-                                all_descriptions[config_description] = {'config_name': config_name, 'filename': os.path.relpath(file_path, scandir), 'line_number': linenum}
-
-                            config_attrs = {}
-                            prev = None
-                            # Handle case where attr value contains a comma
-                            for item in _attrs.split(','):
-                                if "=" not in item:
-                                    assert(prev)
-                                    item = prev + "," + item
-                                try:
-                                    k, v = (i.strip() for i in item.split('='))
-                                except ValueError:
-                                    errors.append(Exception('{} at {}:{} has malformed value {}'.format(config_name, file_path, linenum, item)))
-                                config_attrs[k] = v.replace('\0', ',')
-                                all_attrs.add(k)
-                                prev = item
-                            #print(file_path, config_name, config_attrs)
-
-                            if 'group' not in config_attrs:
-                                errors.append(Exception('{} at {}:{} has no group attribute'.format(config_name, file_path, linenum)))
-
-                            #print(file_path, config_name, config_attrs)
-                            all_configs = chips_all_configs[applicable]
-                            if config_name in all_configs:
-                                errors.append(Exception("Found {} at {}:{} but it was already declared at {}:{}".format(config_name, file_path, linenum, os.path.join(scandir, all_configs[config_name]['filename']), all_configs[config_name]['line_number'])))
-                            else:
-                                all_configs[config_name] = {'attrs': config_attrs, 'filename': os.path.relpath(file_path, scandir), 'line_number': linenum, 'description': config_description}
+for source in source_index.scan(scandir, lambda filename: filename == 'CMakeLists.txt' or os.path.splitext(filename)[1] == '.cmake'):
+    file_path = source.path
+    dirpath = source.dirpath
+    filename = os.path.basename(file_path)
+    file_ext = os.path.splitext(filename)[1]
+    applicable = "all"
+    for chip in (*CHIP_NAMES, "host"):
+        if "/{}/".format(chip) in dirpath:
+            applicable = chip
+            break
+
+    for linenum, line in source.markers:
+        if BASE_CONFIG_RE.search(line):
+            errors.append(Exception("Found {} at {}:{} ({}) which isn't expected in {} files".format(BASE_CONFIG_NAME, file_path, linenum, line, filename if filename == 'CMakeLists.txt' else file_ext)))
+        elif BASE_CMAKE_CONFIG_RE.search(line):
+            m = CMAKE_CONFIG_RE.match(line)
+            if not m:
+                if re.match(r"^\s*#\s*# ", line):
+                    logger.info("Possible misformatted {} at {}:{} ({})".format(BASE_CMAKE_CONFIG_NAME, file_path, linenum, line))
+                else:
+                    errors.append(Exception("Found misformatted {} at {}:{} ({})".format(BASE_CMAKE_CONFIG_NAME, file_path, linenum, line)))
+            else:
+                config_name = m.group(1)
+                config_description = m.group(2)
+                _attrs = m.group(3)
+                # allow commas to appear inside brackets by converting them to and from NULL chars
+                _attrs = re.sub(r'(\(.+\))', lambda m: m.group(1).replace(',', '\0'), _attrs)
+
+                if '=' in config_description and not '==' in config_description:
+                    errors.append(Exception("For {} at {}:{} the description was set to '{}' - has the description field been omitted?".format(config_name, file_path, linenum, config_description)))
+                all_descriptions = chips_all_descriptions[applicable]
+                if config_description in all_descriptions:
+                    errors.append(Exception("Found description {} at {}:{} but it was already used at {}:{}".format(config_description, file_path, linenum, os.path.join(scandir, all_descriptions[config_description]['filename']), all_descriptions[config_description]['line_number'])))
+                else:
+                    all_descriptions[config_description] = {'config_name': config_name, 'filename': os.path.relpath(file_path, scandir), 'line_number': linenum}
+
+                config_attrs = {}
+                prev = None
+                # Handle case where attr value contains a comma
+                for item in _attrs.split(','):
+                    if "=" not in item:
+                        assert(prev)
+                        item = prev + "," + item
+                    try:
+                        k, v = (i.strip() for i in item.split('='))
+                    except ValueError:
+                        errors.append(Exception('{} at {}:{} has malformed value {}'.format(config_name, file_path, linenum, item)))
+                    config_attrs[k] = v.replace('\0', ',')
+                    all_attrs.add(k)
+                    prev = item
+                #print(file_path, config_name, config_attrs)
+
+                if 'group' not in config_attrs:
+                    errors.append(Exception('{} at {}:{} has no group attribute'.format(config_name, file_path, linenum)))
+
+                #print(file_path, config_name, config_attrs)
+                all_configs = chips_all_configs[applicable]
+                if config_name in all_configs:
+                    errors.append(Exception("Found {} at {}:{} but it was already declared at {}:{}".format(config_name, file_path, linenum, os.path.join(scandir, all_configs[config_name]['filename']), all_configs[config_name]['line_number'])))
+                else:
+                    all_configs[config_name] = {'attrs': config_attrs, 'filename': os.path.relpath(file_path, scandir), 'line_number': linenum, 'description': config_description}
 
 
 all_config_names = set()
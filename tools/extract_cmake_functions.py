@@ -69,6 +69,7 @@ group_names_descriptions = {
     'pico_btstack': ('Pico BTstack', 'CMake functions to configure the bluetooth stack'),
     'pico_lwip': ('Pico LwIP', 'CMake functions to configure LwIP'),
     'pico_cyw43_driver': ('Pico CYW43 Driver', 'CMake functions to configure the CYW43 driver'),
+    'pico_crt0': ('Pico C Runtime Startup', 'CMake functions to configure the C runtime startup code'),
     'pico_runtime': ('Pico Runtime', 'CMake functions to configure the runtime environment'),
     'pico_standard_link': ('Pico Standard Link', 'CMake functions to configure the linker'),
     'pico_stdio': ('Pico Standard I/O', 'CMake functions to configure the standard I/O library'),
@@ -22,6 +22,8 @@ import re
 import csv
 import logging
 
+import source_index
+
 from collections import defaultdict
 
 if sys.version_info < (3, 11):
@@ -45,7 +47,6 @@ BASE_BUILD_DEFINE_NAME = 'PICO_BUILD_DEFINE'
 BASE_BUILD_DEFINE_RE = re.compile(r'\b{}\b'.format(BASE_BUILD_DEFINE_NAME))
 
 CONFIG_RE = re.compile(r'//\s+{}:\s+(\w+),\s+([^,]+)(?:,\s+(.*))?$'.format(BASE_CONFIG_NAME))
-DEFINE_RE = re.compile(r'#define\s+(\w+)\s+(.+?)(\s*///.*)?$')
 
 PROPERTY_TYPE = 'type'
 PROPERTY_DEFAULT = 'default'
@@ -177,93 +178,76 @@ errors = []
 
 # Scan all .c and .h and .S files in the specific path, recursively.
 
-for dirpath, dirnames, filenames in os.walk(scandir):
-    for filename in filenames:
-        file_ext = os.path.splitext(filename)[1]
-        if file_ext in ('.c', '.h', '.S'):
-            file_path = os.path.join(dirpath, filename)
-            applicable = "all"
-            for chip in (*CHIP_NAMES, "host"):
-                if "/{}/".format(chip) in dirpath:
-                    applicable = chip
-                    break
-
-            with open(file_path, encoding="ISO-8859-1") as fh:
-                linenum = 0
-                for line in fh.readlines():
-                    linenum += 1
-                    line = line.strip()
-                    if BASE_CMAKE_CONFIG_RE.search(line):
-                        errors.append(Exception("Found {} at {}:{} ({}) which isn't expected in {} files".format(BASE_CMAKE_CONFIG_NAME, file_path, linenum, line, file_ext)))
-                    elif BASE_BUILD_DEFINE_RE.search(line):
-                        errors.append(Exception("Found {} at {}:{} ({}) which isn't expected in {} files".format(BASE_BUILD_DEFINE_NAME, file_path, linenum, line, file_ext)))
-                    elif BASE_CONFIG_RE.search(line):
-                        m = CONFIG_RE.match(line)
-                        if not m:
-                            if re.match(r"^\s*//\s*// ", line):
-                                logger.info("Possible misformatted {} at {}:{} ({})".format(BASE_CONFIG_NAME, file_path, linenum, line))
-                            else:
-                                errors.append(Exception("Found misformatted {} at {}:{} ({})".format(BASE_CONFIG_NAME, file_path, linenum, line)))
-                        else:
-                            config_name = m.group(1)
-                            config_description = m.group(2)
-                            _attrs = m.group(3)
-                            # allow commas to appear inside brackets by converting them to and from NULL chars
-                            _attrs = re.sub(r'(\(.+\))', lambda m: m.group(1).replace(',', '\0'), _attrs)
-
-                            if '=' in config_description and not '==' in config_description:
-                                errors.append(Exception("For {} at {}:{} the description was set to '{}' - has the description field been omitted?".format(config_name, file_path, linenum, config_description)))
-                            all_descriptions = chips_all_descriptions[applicable]
-                            if config_description in all_descriptions:
-                                errors.append(Exception("Found description {} at {}:{} but it was already used at {}:{}".format(config_description, file_path, linenum, os.path.join(scandir, all_descriptions[config_description]['filename']), all_descriptions[config_description]['line_number'])))
-                            else:
-                                all_descriptions[config_description] = {'config_name': config_name, 'filename': os.path.relpath(file_path, scandir), 'line_number': linenum}
-
-                            config_attrs = {}
-                            prev = None
-                            # Handle case where attr value contains a comma
-                            for item in _attrs.split(','):
-                                if "=" not in item:
-                                    assert(prev)
-                                    item = prev + "," + item
-                                try:
-                                    k, v = (i.strip() for i in item.split('='))
-                                except ValueError:
-                                    errors.append(Exception('{} at {}:{} has malformed value {}'.format(config_name, file_path, linenum, item)))
-                                config_attrs[k] = v.replace('\0', ',')
-                                all_attrs.add(k)
-                                prev = item
-                            #print(file_path, config_name, config_attrs)
-
-                            if 'group' not in config_attrs:
-                                errors.append(Exception('{} at {}:{} has no group attribute'.format(config_name, file_path, linenum)))
-
-                            #print(file_path, config_name, config_attrs)
-                            all_configs = chips_all_configs[applicable]
-                            if config_name in all_configs:
-                                errors.append(Exception("Found {} at {}:{} but it was already declared at {}:{}".format(config_name, file_path, linenum, os.path.join(scandir, all_configs[config_name]['filename']), all_configs[config_name]['line_number'])))
-                            else:
-                                all_configs[config_name] = {'attrs': config_attrs, 'filename': os.path.relpath(file_path, scandir), 'line_number': linenum, 'description': config_description}
-                    else:
-                        m = DEFINE_RE.match(line)
-                        if m:
-                            name = m.group(1)
-                            value = m.group(2)
-                            # discard any 'u' qualifier
-                            m = re.match(r'^((0x)?\d+)u$', value.lower())
-                            if m:
-                                value = m.group(1)
-                            else:
-                                # discard any '_u(X)' macro
-                                m = re.match(r'^_u\(((0x)?\d+)\)$', value.lower())
-                                if m:
-                                    value = m.group(1)
-                            all_defines = chips_all_defines[applicable]
-                            if name not in all_defines:
-                                all_defines[name] = dict()
-                            if value not in all_defines[name]:
-                                all_defines[name][value] = set()
-                            all_defines[name][value] = (file_path, linenum)
+for source in source_index.scan(scandir, lambda filename: os.path.splitext(filename)[1] in ('.c', '.h', '.S')):
+    file_path = source.path
+    dirpath = source.dirpath
+    file_ext = os.path.splitext(file_path)[1]
+    applicable = "all"
+    for chip in (*CHIP_NAMES, "host"):
+        if "/{}/".format(chip) in dirpath:
+            applicable = chip
+            break
+
+    for linenum, line in source.markers:
+        if BASE_CMAKE_CONFIG_RE.search(line):
+            errors.append(Exception("Found {} at {}:{} ({}) which isn't expected in {} files".format(BASE_CMAKE_CONFIG_NAME, file_path, linenum, line, file_ext)))
+        elif BASE_BUILD_DEFINE_RE.search(line):
+            errors.append(Exception("Found {} at {}:{} ({}) which isn't expected in {} files".format(BASE_BUILD_DEFINE_NAME, file_path, linenum, line, file_ext)))
+        elif BASE_CONFIG_RE.search(line):
+            m = CONFIG_RE.match(line)
+            if not m:
+                if re.match(r"^\s*//\s*// ", line):
+                    logger.info("Possible misformatted {} at {}:{} ({})".format(BASE_CONFIG_NAME, file_path, linenum, line))
+                else:
+                    errors.append(Exception("Found misformatted {} at {}:{} ({})".format(BASE_CONFIG_NAME, file_path, linenum, line)))
+            else:
+                config_name = m.group(1)
+                config_description = m.group(2)
+                _attrs = m.group(3)
+                # allow commas to appear inside brackets by converting them to and from NULL chars
+                _attrs = re.sub(r'(\(.+\))', lambda m: m.group(1).replace(',', '\0'), _attrs)
+
+                if '=' in config_description and not '==' in config_description:
+                    errors.append(Exception("For {} at {}:{} the description was set to '{}' - has the description field been omitted?".format(config_name, file_path, linenum, config_description)))
+                all_descriptions = chips_all_descriptions[applicable]
+                if config_description in all_descriptions:
+                    errors.append(Exception("Found description {} at {}:{} but it was already used at {}:{}".format(config_description, file_path, linenum, os.path.join(scandir, all_descriptions[config_description]['filename']), all_descriptions[config_description]['line_number'])))
+                else:
+                    all_descriptions[config_description] = {'config_name': config_name, 'filename': os.path.relpath(file_path, scandir), 'line_number': linenum}
+
+                config_attrs = {}
+                prev = None
+                # Handle case where attr value contains a comma
+                for item in _attrs.split(','):
+                    if "=" not in item:
+                        assert(prev)
+                        item = prev + "," + item
+                    try:
+                        k, v = (i.strip() for i in item.split('='))
+                    except ValueError:
+                        errors.append(Exception('{} at {}:{} has malformed value {}'.format(config_name, file_path, linenum, item)))
+                    config_attrs[k] = v.replace('\0', ',')
+                    all_attrs.add(k)
+                    prev = item
+                #print(file_path, config_name, config_attrs)
+
+                if 'group' not in config_attrs:
+                    errors.append(Exception('{} at {}:{} has no group attribute'.format(config_name, file_path, linenum)))
+
+                #print(file_path, config_name, config_attrs)
+                all_configs = chips_all_configs[applicable]
+                if config_name in all_configs:
+                    errors.append(Exception("Found {} at {}:{} but it was already declared at {}:{}".format(config_name, file_path, linenum, os.path.join(scandir, all_configs[config_name]['filename']), all_configs[config_name]['line_number'])))
+                else:
+                    all_configs[config_name] = {'attrs': config_attrs, 'filename': os.path.relpath(file_path, scandir), 'line_number': linenum, 'description': config_description}
+
+    for linenum, name, value in source.defines:
+        all_defines = chips_all_defines[applicable]
+        if name not in all_defines:
+            all_defines[name] = dict()
+        if value not in all_defines[name]:
+            all_defines[name][value] = set()
+        all_defines[name][value] = (file_path, linenum)
 
 all_config_names = set()
 for all_configs in chips_all_configs.values():
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#
+# Script to turn program counter samples captured from pc_sampler_print() (see pico_pc_sampler) into a ranking of the
+# functions which cost the most time running from flash, and a linker script fragment for pico_set_ram_functions()
+# which moves the most costly of them into RAM.
+#
+# The captures may contain other output too (e.g. a whole serial console log); only the lines containing "pc_sample:"
+# are looked at, and several captures (e.g. of different runs) may be given. Each sample is attributed to the function
+# in the ELF file's symbol table which contains it, and only samples of code in flash (the XIP address range) count,
+# since those are the ones which may have had to wait for a cache miss; code already in RAM or ROM is not a candidate.
+#
+# Functions are chosen for the fragment greedily by samples per byte, so that the most time is moved into RAM for
+# the budget; a function which does not fit in what is left of the budget is skipped in favour of smaller ones. The
+# budget is approximate, as the linker may need to add veneers for calls between RAM and flash.
+#
+# The fragment names each function's own section (e.g. *(.text.my_function)), so only matches functions compiled
+# with -ffunction-sections, as the SDK does by default; functions which can't be moved (e.g. ones in libraries built
+# without it) can be left out with --exclude.
+#
+# Usage:
+#
+# tools/pc_sample_placement.py [--budget BYTES] [--max-functions N] [--exclude PATTERN] [--top N] [-o FRAGMENT]
+#                              <ELF file> [capture file ...]
+
+
+import re
+import sys
+import struct
+import argparse
+import bisect
+import fnmatch
+
+SAMPLE_RE = re.compile(r'pc_sample:((?: [0-9a-fA-F]{1,8})+)\s*$')
+DROPPED_RE = re.compile(r'pc_sample: dropped (\d+)\s*$')
+
+FLASH_START = 0x10000000
+FLASH_END = 0x20000000
+
+ELF_HEADER = struct.Struct('<16sHHIIIIIHHHHHH')
+SECTION_HEADER = struct.Struct('<10I')
+SYMBOL = struct.Struct('<IIIBBH')
+
+EM_ARM = 40
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+STB_WEAK = 2
+
+
+class PlacementError(Exception):
+    pass
+
+
+class Function:
+    def __init__(self, name, addr, size, binding):
+        self.name = name
+        self.addr = addr
+        self.size = size
+        self.binding = binding
+        self.samples = 0
+        self.moved = False
+
+    def density(self):
+        return self.samples / self.size
+
+
+def read_functions(filename):
+    """
+    Returns the functions in the ELF file's symbol table, sorted by address, with one entry per address
+    """
+    with open(filename, 'rb') as fh:
+        data = fh.read()
+    if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+        raise PlacementError("{} is not a 32-bit little-endian ELF file".format(filename))
+    header = ELF_HEADER.unpack_from(data)
+    machine, shoff, shentsize, shnum = header[2], header[6], header[11], header[12]
+    sections = [SECTION_HEADER.unpack_from(data, shoff + i * shentsize) for i in range(shnum)]
+    by_addr = {}
+    for section in sections:
+        if section[1] != SHT_SYMTAB:
+            continue
+        strtab = sections[section[6]]
+        offset, size, entsize = section[4], section[5], section[9]
+        for pos in range(offset, offset + size, entsize):
+            name_offset, value, sym_size, info, _, shndx = SYMBOL.unpack_from(data, pos)
+            if info & 0xf != STT_FUNC or not sym_size or not shndx:
+                continue
+            name_start = strtab[4] + name_offset
+            name = data[name_start:data.index(b'\0', name_start)].decode('utf-8', 'replace')
+            if machine == EM_ARM:
+                # clear the Thumb bit
+                value &= ~1
+            function = Function(name, value, sym_size, info >> 4)
+            # of several names for the same code, prefer a strong one, then the shortest (e.g. not a __wrap_ alias)
+            existing = by_addr.get(function.addr)
+            if existing is None or (existing.binding == STB_WEAK, len(existing.name)) > \
+                    (function.binding == STB_WEAK, len(function.name)):
+                by_addr[function.addr] = function
+    if not by_addr:
+        raise PlacementError("{} has no function symbols".format(filename))
+    return sorted(by_addr.values(), key=lambda f: f.addr)
+
+
+def read_samples(lines, samples):
+    """
+    Appends the samples in lines to samples, and returns the number of samples dropped
+    """
+    dropped = 0
+    for line in lines:
+        if 'pc_sample:' not in line:
+            continue
+        m = DROPPED_RE.search(line)
+        if m:
+            dropped += int(m.group(1))
+            continue
+        m = SAMPLE_RE.search(line)
+        if m:
+            samples.extend(int(value, 16) for value in m.group(1).split())
+    return dropped
+
+
+def attribute_samples(functions, samples):
+    """
+    Counts each flash sample against its function, and returns (flash samples, samples in no known function)
+    """
+    starts = [f.addr for f in functions]
+    flash = 0
+    unknown = 0
+    for pc in samples:
+        if not FLASH_START <= pc < FLASH_END:
+            continue
+        flash += 1
+        i = bisect.bisect_right(starts, pc) - 1
+        if i >= 0 and pc < functions[i].addr + functions[i].size:
+            functions[i].samples += 1
+        else:
+            unknown += 1
+    return flash, unknown
+
+
+def choose_functions(candidates, budget, max_functions):
+    chosen = []
+    remaining = budget
+    for function in sorted(candidates, key=lambda f: (-f.density(), f.addr)):
+        if max_functions is not None and len(chosen) >= max_functions:
+            break
+        # keep each function 4 byte aligned, as the linker will
+        size = (function.size + 3) & ~3
+        if size <= remaining:
+            function.moved = True
+            chosen.append(function)
+            remaining -= size
+    return chosen
+
+
+def write_fragment(fh, chosen, flash_samples):
+    moved_samples = sum(f.samples for f in chosen)
+    moved_bytes = sum(f.size for f in chosen)
+    fh.write("/* Generated by tools/pc_sample_placement.py: {} functions ({} bytes) which ran for {:.1f}% of the {} "
+             "samples in flash */\n".format(len(chosen), moved_bytes,
+                                           100 * moved_samples / flash_samples if flash_samples else 0,
+                                           flash_samples))
+    for function in chosen:
+        fh.write("*(.text.{})  /* {} bytes, {} samples */\n".format(function.name, function.size, function.samples))
+
+
+parser = argparse.ArgumentParser(description="Rank functions by time spent running from flash, from PC samples "
+                                             "captured from pc_sampler_print(), and choose which to move into RAM")
+parser.add_argument("elf", help="ELF file of the binary which was sampled")
+parser.add_argument("captures", nargs="*", help="Capture files (default: standard input)")
+parser.add_argument("--budget", type=int, default=8192, help="Maximum number of bytes of functions to move into RAM (default: %(default)s)")
+parser.add_argument("--max-functions", type=int, help="Maximum number of functions to move into RAM")
+parser.add_argument("--exclude", action="append", default=[], metavar="PATTERN", help="Don't move functions whose names match this pattern (may be given more than once)")
+parser.add_argument("--top", type=int, default=30, help="Number of functions to list in the report (default: %(default)s)")
+parser.add_argument("-o", "--output", help="File to write the linker script fragment for pico_set_ram_functions() to")
+args = parser.parse_args()
+
+try:
+    functions = read_functions(args.elf)
+except (OSError, PlacementError, struct.error) as e:
+    print("Error reading {}: {}".format(args.elf, e), file=sys.stderr)
+    sys.exit(1)
+
+samples = []
+dropped = 0
+if args.captures:
+    for capture in args.captures:
+        with open(capture, encoding="ISO-8859-1") as fh:
+            dropped += read_samples(fh, samples)
+else:
+    dropped = read_samples(sys.stdin, samples)
+
+if not samples:
+    print("No pc_sample: lines found", file=sys.stderr)
+    sys.exit(1)
+
+flash_samples, unknown = attribute_samples(functions, samples)
+candidates = [f for f in functions if f.samples and not any(fnmatch.fnmatchcase(f.name, p) for p in args.exclude)]
+chosen = choose_functions(candidates, args.budget, args.max_functions)
+
+ranked = sorted((f for f in functions if f.samples), key=lambda f: (-f.samples, f.addr))
+name_width = max([len('function')] + [len(f.name) for f in ranked[:args.top]])
+print("{:>4}  {:>8}  {:>6}  {:>6}  {:>8}  {:<{}}  {}".format("#", "samples", "%", "cum %", "bytes", "function",
+                                                              name_width, "to RAM"))
+cumulative = 0
+for index, function in enumerate(ranked[:args.top]):
+    cumulative += function.samples
+    print("{:>4}  {:>8}  {:>6.1f}  {:>6.1f}  {:>8}  {:<{}}  {}".format(index + 1, function.samples,
+                                                                      100 * function.samples / flash_samples,
+                                                                      100 * cumulative / flash_samples, function.size,
+                                                                      function.name, name_width,
+                                                                      "*" if function.moved else "").rstrip())
+
+print()
+print("{} samples, {} ({:.1f}%) in flash".format(len(samples), flash_samples, 100 * flash_samples / len(samples)))
+if unknown:
+    print("{} flash samples were not in any function in the symbol table; is this the ELF file which was sampled?"
+          .format(unknown))
+if dropped:
+    print("{} more samples were dropped as the buffer was full; call pc_sampler_print() more often, or increase "
+          "PICO_PC_SAMPLER_BUFFER_SIZE".format(dropped))
+moved_samples = sum(f.samples for f in chosen)
+print("{} functions ({} bytes of the {} byte budget) chosen to move to RAM, accounting for {:.1f}% of the flash samples"
+      .format(len(chosen), sum(f.size for f in chosen), args.budget,
+              100 * moved_samples / flash_samples if flash_samples else 0))
+
+if args.output:
+    with open(args.output, "w") as fh:
+        write_fragment(fh, chosen, flash_samples)
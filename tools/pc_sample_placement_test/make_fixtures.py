@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#
+# Script to (re)generate the fixtures pc_sample_placement_test.py runs tools/pc_sample_placement.py on: functions.elf,
+# an ELF file with just a symbol table (no code), and capture.txt, a serial console log with pc_sampler_print() output
+# for it. The fixtures are checked in, so this only needs running if they are to change.
+#
+# usage: make_fixtures.py [<output dir>]
+
+import os
+import random
+import struct
+import sys
+
+EM_ARM = 40
+SHT_SYMTAB = 2
+SHT_STRTAB = 3
+STB_LOCAL = 0
+STB_GLOBAL = 1
+STB_WEAK = 2
+STT_OBJECT = 1
+STT_FUNC = 2
+# the symbols are given a section index; nothing checks there is a section there
+SHN_TEXT = 1
+
+# (name, address, size, binding, type); Thumb function addresses have bit 0 set, as in a real Arm ELF file
+SYMBOLS = [
+    ("hot_small", 0x10000101, 16, STB_GLOBAL, STT_FUNC),
+    # a second name for hot_small; the tool should prefer the shorter one
+    ("__wrap_hot_small", 0x10000101, 16, STB_GLOBAL, STT_FUNC),
+    ("hot_big", 0x10000201, 1024, STB_GLOBAL, STT_FUNC),
+    # a weak name for medium; the tool should prefer the strong one, even though it is longer
+    ("med", 0x10000801, 64, STB_WEAK, STT_FUNC),
+    ("medium", 0x10000801, 64, STB_GLOBAL, STT_FUNC),
+    # not a multiple of 4 bytes, so takes 20 bytes of the budget
+    ("odd", 0x10000881, 18, STB_LOCAL, STT_FUNC),
+    ("cold", 0x10000901, 32, STB_GLOBAL, STT_FUNC),
+    # no size, so can't be attributed samples
+    ("marker", 0x10000941, 0, STB_GLOBAL, STT_FUNC),
+    # data, so samples in it are in no known function
+    ("table", 0x10000a00, 64, STB_GLOBAL, STT_OBJECT),
+    # already in RAM
+    ("ram_func", 0x20000101, 32, STB_GLOBAL, STT_FUNC),
+]
+
+# (address of the first instruction, number of samples)
+SAMPLES = [
+    (0x10000200, 40),  # hot_big
+    (0x10000100, 20),  # hot_small
+    (0x10000800, 12),  # medium
+    (0x10000880, 6),  # odd
+    (0x10000900, 1),  # cold
+    (0x10000a00, 2),  # table
+    (0x20000100, 10),  # ram_func
+    (0x00001234, 5),  # ROM
+]
+DROPPED = 3
+SAMPLES_PER_LINE = 8
+
+
+def make_elf():
+    strtab = b"\0"
+    symtab = bytes(16)
+    for name, addr, size, binding, sym_type in SYMBOLS:
+        symtab += struct.pack("<IIIBBH", len(strtab), addr, size, (binding << 4) | sym_type, 0, SHN_TEXT)
+        strtab += name.encode() + b"\0"
+    ehsize, shentsize = 52, 40
+    strtab_offset = ehsize
+    symtab_offset = (strtab_offset + len(strtab) + 3) & ~3
+    shoff = symtab_offset + len(symtab)
+    ident = b"\x7fELF" + bytes([1, 1, 1]) + bytes(9)
+    header = ident + struct.pack("<HHIIIIIHHHHHH", 2, EM_ARM, 1, 0, 0, shoff, 0x05000200, ehsize, 0, 0, shentsize,
+                                 3, 1)
+    sections = bytes(shentsize)
+    sections += struct.pack("<10I", 0, SHT_STRTAB, 0, 0, strtab_offset, len(strtab), 0, 0, 1, 0)
+    # the last local symbol is odd, so the first global one is the one after it
+    first_global = 1 + next(i for i, s in enumerate(SYMBOLS) if s[0] == "odd") + 1
+    sections += struct.pack("<10I", 0, SHT_SYMTAB, 0, 0, symtab_offset, len(symtab), 1, first_global, 4, 16)
+    return header + strtab.ljust(symtab_offset - strtab_offset, b"\0") + symtab + sections
+
+
+def make_capture():
+    samples = [pc + 2 * (i % 4) for pc, count in SAMPLES for i in range(count)]
+    random.Random(2350).shuffle(samples)
+    lines = ["boot: core 0 up", "starting workload"]
+    for i in range(0, len(samples), SAMPLES_PER_LINE):
+        if i == 48:
+            lines.append("pc_sample: dropped {}".format(DROPPED))
+            lines.append("workload pass 2")
+        lines.append("pc_sample:" + "".join(" {:08x}".format(pc) for pc in samples[i:i + SAMPLES_PER_LINE]))
+    lines.append("done")
+    return "".join(line + "\r\n" for line in lines)
+
+
+def main():
+    out_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    with open(os.path.join(out_dir, "functions.elf"), "wb") as f:
+        f.write(make_elf())
+    with open(os.path.join(out_dir, "capture.txt"), "w", newline="") as f:
+        f.write(make_capture())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#
+# Tests tools/pc_sample_placement.py on the recorded capture.txt and the symbol table in functions.elf (see
+# make_fixtures.py): the ranking it prints, and the linker script fragment it writes for a given byte budget.
+#
+# usage: pc_sample_placement_test.py [-v]
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import unittest
+
+TEST_DIR = os.path.dirname(os.path.abspath(__file__))
+TOOL = os.path.join(TEST_DIR, os.pardir, "pc_sample_placement.py")
+ELF = os.path.join(TEST_DIR, "functions.elf")
+CAPTURE = os.path.join(TEST_DIR, "capture.txt")
+
+# in functions.elf: name -> (size, samples in capture.txt)
+FUNCTIONS = {
+    "hot_big": (1024, 40),
+    "hot_small": (16, 20),
+    "medium": (64, 12),
+    "odd": (18, 6),
+    "cold": (32, 1),
+}
+FLASH_SAMPLES = 81
+
+RANKING_RE = re.compile(r'^\s*(\d+)\s+(\d+)\s+[\d.]+\s+[\d.]+\s+(\d+)\s+(\S+)\s*(\*?)$')
+FRAGMENT_RE = re.compile(r'^\*\(\.text\.(\S+)\)  /\* (\d+) bytes, (\d+) samples \*/$')
+
+
+def run_tool(*args, stdin=None):
+    with tempfile.TemporaryDirectory() as tmp:
+        fragment_file = os.path.join(tmp, "fragment.ld")
+        result = subprocess.run([sys.executable, TOOL, "-o", fragment_file] + list(args), input=stdin,
+                                stdout=subprocess.PIPE, stderr=subprocess.PIPE, universal_newlines=True)
+        fragment = None
+        if os.path.exists(fragment_file):
+            with open(fragment_file) as fh:
+                fragment = fh.read()
+    return result, fragment
+
+
+def ranking(report):
+    """
+    Returns the ranking in the report as a list of (name, samples, bytes, moved)
+    """
+    rows = []
+    for line in report.splitlines():
+        m = RANKING_RE.match(line)
+        if m:
+            rows.append((m.group(4), int(m.group(2)), int(m.group(3)), m.group(5) == "*"))
+    return rows
+
+
+def fragment_functions(fragment):
+    """
+    Returns the names of the functions in the fragment, in order, checking each rule's comment as it goes
+    """
+    names = []
+    lines = fragment.splitlines()
+    for line in lines[1:]:
+        m = FRAGMENT_RE.match(line)
+        if not m:
+            raise AssertionError("unexpected line in fragment: {}".format(line))
+        name = m.group(1)
+        if (int(m.group(2)), int(m.group(3))) != FUNCTIONS[name]:
+            raise AssertionError("wrong size or samples for {}: {}".format(name, line))
+        names.append(name)
+    return names
+
+
+def budget_used(names):
+    return sum((FUNCTIONS[name][0] + 3) & ~3 for name in names)
+
+
+class PcSamplePlacementTest(unittest.TestCase):
+    def check_fragment(self, args, budget, expected):
+        result, fragment = run_tool("--budget", str(budget), *args, ELF, CAPTURE)
+        self.assertEqual(result.returncode, 0, result.stderr)
+        names = fragment_functions(fragment)
+        self.assertEqual(names, expected)
+        self.assertLessEqual(budget_used(names), budget)
+        moved_bytes = sum(FUNCTIONS[name][0] for name in names)
+        self.assertIn("{} functions ({} bytes) ".format(len(names), moved_bytes), fragment.splitlines()[0])
+        self.assertIn("of the {} samples in flash".format(FLASH_SAMPLES), fragment.splitlines()[0])
+        # the ranking marks the same functions as moved
+        self.assertEqual(sorted(name for name, _, _, moved in ranking(result.stdout) if moved), sorted(names))
+        return result
+
+    def test_ranking(self):
+        result, _ = run_tool(ELF, CAPTURE)
+        self.assertEqual(result.returncode, 0, result.stderr)
+        # by samples; aliases, data, functions in RAM and samples outside flash don't appear
+        self.assertEqual([row[:3] for row in ranking(result.stdout)],
+                         [(name, samples, size) for name, (size, samples) in FUNCTIONS.items()])
+        self.assertIn("96 samples, 81 (84.4%) in flash", result.stdout)
+        self.assertIn("2 flash samples were not in any function", result.stdout)
+        self.assertIn("3 more samples were dropped", result.stdout)
+
+    def test_top(self):
+        result, _ = run_tool("--top", "2", ELF, CAPTURE)
+        self.assertEqual([row[0] for row in ranking(result.stdout)], ["hot_big", "hot_small"])
+
+    def test_budget(self):
+        # by samples per byte; hot_big doesn't fit in what is left after medium, but cold does
+        result = self.check_fragment([], 160, ["hot_small", "odd", "medium", "cold"])
+        self.assertIn("4 functions (130 bytes of the 160 byte budget)", result.stdout)
+
+    def test_budget_skips_what_does_not_fit(self):
+        # odd takes 20 bytes once aligned, leaving 28 after medium, which is too little for cold
+        self.check_fragment([], 128, ["hot_small", "odd", "medium"])
+
+    def test_budget_exact(self):
+        # just enough for everything but hot_big
+        self.check_fragment([], 132, ["hot_small", "odd", "medium", "cold"])
+        self.check_fragment([], 131, ["hot_small", "odd", "medium"])
+
+    def test_budget_everything(self):
+        self.check_fragment([], 8192, ["hot_small", "odd", "medium", "hot_big", "cold"])
+
+    def test_budget_nothing(self):
+        self.check_fragment([], 15, [])
+
+    def test_exclude(self):
+        self.check_fragment(["--exclude", "od*", "--exclude", "hot_small"], 160, ["medium", "cold"])
+
+    def test_max_functions(self):
+        self.check_fragment(["--max-functions", "2"], 8192, ["hot_small", "odd"])
+
+    def test_stdin(self):
+        with open(CAPTURE, encoding="ISO-8859-1") as fh:
+            capture = fh.read()
+        result, fragment = run_tool("--budget", "160", ELF, stdin=capture)
+        self.assertEqual(result.returncode, 0, result.stderr)
+        self.assertEqual(fragment_functions(fragment), ["hot_small", "odd", "medium", "cold"])
+
+    def test_several_captures(self):
+        # samples from each capture are added together
+        result, _ = run_tool(ELF, CAPTURE, CAPTURE)
+        self.assertEqual(ranking(result.stdout)[0][:2], ("hot_big", 80))
+        self.assertIn("6 more samples were dropped", result.stdout)
+
+    def test_no_samples(self):
+        result, fragment = run_tool(ELF, os.devnull)
+        self.assertEqual(result.returncode, 1)
+        self.assertIn("No pc_sample: lines found", result.stderr)
+        self.assertIsNone(fragment)
+
+    def test_not_elf(self):
+        result, fragment = run_tool(CAPTURE, CAPTURE)
+        self.assertEqual(result.returncode, 1)
+        self.assertIn("is not a 32-bit little-endian ELF file", result.stderr)
+        self.assertIsNone(fragment)
+
+
+if __name__ == "__main__":
+    unittest.main()
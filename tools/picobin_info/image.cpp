@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include <fstream>
+#include "image.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define ELF_MAGIC 0x464c457fu
+#define ELF_CLASS_32 1
+#define ELF_DATA_LSB 1
+#define ELF_PT_LOAD 1
+
+#define UF2_MAGIC_START0 0x0A324655u
+#define UF2_MAGIC_START1 0x9E5D5157u
+#define UF2_MAGIC_END    0x0AB16F30u
+#define UF2_FLAG_NOT_MAIN_FLASH 0x00000001u
+#define UF2_BLOCK_SIZE 512u
+#define UF2_DATA_OFFSET 32u
+#define UF2_MAX_PAYLOAD 476u
+
+static uint32_t get_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+mapped_file::~mapped_file() {
+#ifndef _WIN32
+    if (mapped) munmap(const_cast<uint8_t *>(data_), size_);
+#endif
+}
+
+bool mapped_file::open(const std::string &path, std::string &error) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open file";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        error = "not a regular file";
+        return false;
+    }
+    size_ = (size_t)st.st_size;
+    if (size_) {
+        void *p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            data_ = static_cast<const uint8_t *>(p);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+    if (mapped || !size_) return true;
+#endif
+    // no mmap; read the whole file instead
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open file";
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = buffer.data();
+    size_ = buffer.size();
+    return true;
+}
+
+const char *image_format_name(image_format format) {
+    switch (format) {
+        case image_format::elf: return "elf";
+        case image_format::uf2: return "uf2";
+        default: return "bin";
+    }
+}
+
+void image::add_range(uint32_t addr, uint32_t size, const uint8_t *data) {
+    if (!size) return;
+    if (!ranges_.empty()) {
+        // merge with the previous range if it continues it in both the address space and the file
+        image_range &last = ranges_.back();
+        if (last.addr + last.size == addr && last.data + last.size == data) {
+            last.size += size;
+            return;
+        }
+    }
+    ranges_.push_back({addr, size, data});
+}
+
+void image::sort_ranges() {
+    std::stable_sort(ranges_.begin(), ranges_.end(), [](const image_range &a, const image_range &b) {
+        return a.addr < b.addr;
+    });
+}
+
+size_t image::find(uint32_t addr) const {
+    // index of the last range starting at or before addr
+    auto it = std::upper_bound(ranges_.begin(), ranges_.end(), addr, [](uint32_t a, const image_range &r) {
+        return a < r.addr;
+    });
+    return it == ranges_.begin() ? ranges_.size() : (size_t)(it - ranges_.begin() - 1);
+}
+
+const uint8_t *image::contiguous(uint32_t addr, uint32_t size) const {
+    size_t i = find(addr);
+    if (i >= ranges_.size()) return nullptr;
+    const image_range &r = ranges_[i];
+    uint32_t offset = addr - r.addr;
+    if (offset >= r.size || size > r.size - offset) return nullptr;
+    return r.data + offset;
+}
+
+uint32_t image::contiguous_size(uint32_t addr) const {
+    size_t i = find(addr);
+    if (i >= ranges_.size() || addr - ranges_[i].addr >= ranges_[i].size) return 0;
+    return ranges_[i].size - (addr - ranges_[i].addr);
+}
+
+bool image::read(uint32_t addr, void *dest, uint32_t size) const {
+    auto *out = static_cast<uint8_t *>(dest);
+    return for_each_piece(addr, size, [&out](const uint8_t *data, uint32_t len) {
+        memcpy(out, data, len);
+        out += len;
+    });
+}
+
+bool image::load_elf(std::string &error) {
+    const uint8_t *p = file.data();
+    size_t size = file.size();
+    if (size < 52 || p[4] != ELF_CLASS_32 || p[5] != ELF_DATA_LSB) {
+        error = "only 32 bit little endian ELF files are supported";
+        return false;
+    }
+    uint32_t phoff = get_u32(p + 28);
+    uint16_t phentsize = get_u16(p + 42);
+    uint16_t phnum = get_u16(p + 44);
+    if (phentsize < 32 || phoff > size || (size_t)phnum * phentsize > size - phoff) {
+        error = "bad ELF program headers";
+        return false;
+    }
+    for (unsigned i = 0; i < phnum; i++) {
+        const uint8_t *ph = p + phoff + i * phentsize;
+        if (get_u32(ph) != ELF_PT_LOAD) continue;
+        uint32_t offset = get_u32(ph + 4);
+        uint32_t paddr = get_u32(ph + 12);
+        uint32_t filesz = get_u32(ph + 16);
+        if (offset > size || filesz > size - offset) {
+            error = "ELF segment outside the file";
+            return false;
+        }
+        // segments are placed at their load (physical) address, which is where they are stored in flash
+        add_range(paddr, filesz, p + offset);
+    }
+    return true;
+}
+
+bool image::load_uf2(std::string &error) {
+    const uint8_t *p = file.data();
+    for (size_t pos = 0; pos + UF2_BLOCK_SIZE <= file.size(); pos += UF2_BLOCK_SIZE) {
+        const uint8_t *block = p + pos;
+        if (get_u32(block) != UF2_MAGIC_START0 || get_u32(block + 4) != UF2_MAGIC_START1 ||
+            get_u32(block + UF2_BLOCK_SIZE - 4) != UF2_MAGIC_END) {
+            error = "bad UF2 block";
+            return false;
+        }
+        if (get_u32(block + 8) & UF2_FLAG_NOT_MAIN_FLASH) continue;
+        uint32_t payload_size = get_u32(block + 16);
+        if (payload_size > UF2_MAX_PAYLOAD) {
+            error = "bad UF2 payload size";
+            return false;
+        }
+        add_range(get_u32(block + 12), payload_size, block + UF2_DATA_OFFSET);
+    }
+    return true;
+}
+
+bool image::load(const std::string &path, uint32_t base, std::string &error) {
+    ranges_.clear();
+    if (!file.open(path, error)) return false;
+    bool ok = true;
+    if (file.size() >= 4 && get_u32(file.data()) == ELF_MAGIC) {
+        format_ = image_format::elf;
+        ok = load_elf(error);
+    } else if (file.size() >= UF2_BLOCK_SIZE && get_u32(file.data()) == UF2_MAGIC_START0 &&
+               get_u32(file.data() + 4) == UF2_MAGIC_START1) {
+        format_ = image_format::uf2;
+        ok = load_uf2(error);
+    } else {
+        format_ = image_format::bin;
+        add_range(base, (uint32_t)std::min(file.size(), (size_t)UINT32_MAX - base), file.data());
+    }
+    if (ok) sort_ranges();
+    return ok;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICOBIN_INFO_IMAGE_H
+#define _PICOBIN_INFO_IMAGE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// A read-only view of a whole file; memory mapped where the platform allows, so nothing is copied until it is
+// looked at
+class mapped_file {
+public:
+    mapped_file() = default;
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+    ~mapped_file();
+
+    bool open(const std::string &path, std::string &error);
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped = false;
+    std::vector<uint8_t> buffer;
+};
+
+enum class image_format {
+    bin,
+    elf,
+    uf2,
+};
+
+const char *image_format_name(image_format format);
+
+// A contiguous run of the image's (storage) address space, pointing into the file
+struct image_range {
+    uint32_t addr;
+    uint32_t size;
+    const uint8_t *data;
+};
+
+// The storage address space of an ELF (from the physical addresses of its loadable segments), BIN or UF2 file
+class image {
+public:
+    // base is the address that the start of a BIN file is loaded at
+    bool load(const std::string &path, uint32_t base, std::string &error);
+
+    image_format format() const { return format_; }
+    const std::vector<image_range> &ranges() const { return ranges_; }
+    // lowest address in the image
+    uint32_t base() const { return ranges_.empty() ? 0 : ranges_.front().addr; }
+
+    // Returns a pointer to size bytes at addr if they are contiguous in the file, or nullptr
+    const uint8_t *contiguous(uint32_t addr, uint32_t size) const;
+    // Returns the number of bytes from addr to the end of the range containing it, or 0 if addr is not in the image
+    uint32_t contiguous_size(uint32_t addr) const;
+    // Copies size bytes at addr, which may span ranges; returns false if any of them are not in the image
+    bool read(uint32_t addr, void *dest, uint32_t size) const;
+    bool read_u32(uint32_t addr, uint32_t &value) const { return read(addr, &value, 4); }
+
+    // Calls f(data, size) for each contiguous piece of size bytes at addr, without copying; returns false if any of
+    // the bytes are not in the image
+    template<typename F> bool for_each_piece(uint32_t addr, uint32_t size, F f) const {
+        size_t i = find(addr);
+        while (size) {
+            if (i >= ranges_.size() || addr < ranges_[i].addr || addr - ranges_[i].addr >= ranges_[i].size) return false;
+            uint32_t offset = addr - ranges_[i].addr;
+            uint32_t len = std::min(size, ranges_[i].size - offset);
+            f(ranges_[i].data + offset, len);
+            addr += len;
+            size -= len;
+            i++;
+        }
+        return true;
+    }
+
+private:
+    bool load_elf(std::string &error);
+    bool load_uf2(std::string &error);
+    void add_range(uint32_t addr, uint32_t size, const uint8_t *data);
+    void sort_ranges();
+    size_t find(uint32_t addr) const;
+
+    mapped_file file;
+    image_format format_ = image_format::bin;
+    std::vector<image_range> ranges_;
+};
+
+#endif
@@ -0,0 +1,549 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include "image.h"
+#include "picobin_parser.h"
+#include "version.h"
+
+#define NO_PICO_PLATFORM 1
+#include "boot/picobin.h"
+#include "pico/binary_info/structure.h"
+#include "pico/binary_info_compact.h"
+
+#define DEFAULT_BIN_BASE 0x10000000u
+
+struct options {
+    uint32_t bin_base = DEFAULT_BIN_BASE;
+    bool check_hashes = true;
+    bool pretty = false;
+    std::string compact_path;
+};
+
+// Minimal JSON output: tracks whether a separator is needed before the next value
+class json_writer {
+public:
+    explicit json_writer(bool pretty) : pretty(pretty) {}
+
+    void begin_object() { open('{'); }
+    void end_object() { close('}'); }
+    void begin_array() { open('['); }
+    void end_array() { close(']'); }
+
+    json_writer &key(const char *name) {
+        separator();
+        string(name, strlen(name));
+        out += pretty ? ": " : ":";
+        after_key = true;
+        return *this;
+    }
+
+    void value(const char *s) { value(s, strlen(s)); }
+    void value(const char *s, size_t len) { separator(); string(s, len); }
+    void value(const image_text &text) {
+        if (text.valid) value(text.data(), text.size()); else null();
+    }
+    void value(bool b) { separator(); out += b ? "true" : "false"; }
+    void value(int64_t n) { separator(); out += std::to_string(n); }
+    void null() { separator(); out += "null"; }
+    void hex(uint64_t n) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "0x%08llx", (unsigned long long)n);
+        value(buf);
+    }
+
+    std::string take() { std::string s; s.swap(out); return s; }
+
+private:
+    void separator() {
+        if (after_key) {
+            after_key = false;
+            return;
+        }
+        if (!first.empty()) {
+            if (!first.back()) out += ',';
+            first.back() = false;
+            indent();
+        }
+    }
+
+    void indent() {
+        if (!pretty) return;
+        out += '\n';
+        out.append(first.size() * 2, ' ');
+    }
+
+    void open(char c) {
+        separator();
+        out += c;
+        first.push_back(true);
+    }
+
+    void close(char c) {
+        bool empty = first.back();
+        first.pop_back();
+        if (!empty) indent();
+        out += c;
+    }
+
+    void string(const char *s, size_t len) {
+        out += '"';
+        for (size_t i = 0; i < len; i++) {
+            auto c = (unsigned char)s[i];
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += (char)c;
+            } else if (c < 0x20 || c >= 0x7f) {
+                // binary_info strings are meant to be ASCII; escape anything else byte by byte
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += (char)c;
+            }
+        }
+        out += '"';
+    }
+
+    std::string out;
+    std::vector<bool> first;
+    bool after_key = false;
+    bool pretty;
+};
+
+static const char *item_name(unsigned type) {
+    switch (type) {
+        case PICOBIN_BLOCK_ITEM_1BS_NEXT_BLOCK_OFFSET: return "next_block_offset";
+        case PICOBIN_BLOCK_ITEM_1BS_IMAGE_TYPE: return "image_type";
+        case PICOBIN_BLOCK_ITEM_1BS_VECTOR_TABLE: return "vector_table";
+        case PICOBIN_BLOCK_ITEM_1BS_ENTRY_POINT: return "entry_point";
+        case PICOBIN_BLOCK_ITEM_1BS_ROLLING_WINDOW_DELTA: return "rolling_window_delta";
+        case PICOBIN_BLOCK_ITEM_LOAD_MAP: return "load_map";
+        case PICOBIN_BLOCK_ITEM_1BS_HASH_DEF: return "hash_def";
+        case PICOBIN_BLOCK_ITEM_1BS_VERSION: return "version";
+        case PICOBIN_BLOCK_ITEM_SIGNATURE: return "signature";
+        case PICOBIN_BLOCK_ITEM_PARTITION_TABLE: return "partition_table";
+        case PICOBIN_BLOCK_ITEM_HASH_VALUE: return "hash_value";
+        case PICOBIN_BLOCK_ITEM_SALT: return "salt";
+        case PICOBIN_BLOCK_ITEM_2BS_IGNORED: return "ignored";
+        default: return "unknown";
+    }
+}
+
+static const char *binary_info_type_name(unsigned type) {
+    switch (type) {
+        case BINARY_INFO_TYPE_RAW_DATA: return "raw_data";
+        case BINARY_INFO_TYPE_SIZED_DATA: return "sized_data";
+        case BINARY_INFO_TYPE_BINARY_INFO_LIST_ZERO_TERMINATED: return "list_zero_terminated";
+        case BINARY_INFO_TYPE_BSON: return "bson";
+        case BINARY_INFO_TYPE_ID_AND_INT: return "id_and_int";
+        case BINARY_INFO_TYPE_ID_AND_STRING: return "id_and_string";
+        case BINARY_INFO_TYPE_BLOCK_DEVICE: return "block_device";
+        case BINARY_INFO_TYPE_PINS_WITH_FUNC: return "pins_with_func";
+        case BINARY_INFO_TYPE_PINS_WITH_NAME: return "pins_with_name";
+        case BINARY_INFO_TYPE_NAMED_GROUP: return "named_group";
+        case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME: return "ptr_int32_with_name";
+        case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME: return "ptr_string_with_name";
+        case BINARY_INFO_TYPE_PINS64_WITH_FUNC: return "pins64_with_func";
+        case BINARY_INFO_TYPE_PINS64_WITH_NAME: return "pins64_with_name";
+        default: return "unknown";
+    }
+}
+
+static const char *raspberry_pi_id_name(uint32_t id) {
+    switch (id) {
+        case BINARY_INFO_ID_RP_PROGRAM_NAME: return "program_name";
+        case BINARY_INFO_ID_RP_PROGRAM_VERSION_STRING: return "program_version";
+        case BINARY_INFO_ID_RP_PROGRAM_BUILD_DATE_STRING: return "program_build_date";
+        case BINARY_INFO_ID_RP_BINARY_END: return "binary_end";
+        case BINARY_INFO_ID_RP_PROGRAM_URL: return "program_url";
+        case BINARY_INFO_ID_RP_PROGRAM_DESCRIPTION: return "program_description";
+        case BINARY_INFO_ID_RP_PROGRAM_FEATURE: return "program_feature";
+        case BINARY_INFO_ID_RP_PROGRAM_BUILD_ATTRIBUTE: return "program_build_attribute";
+        case BINARY_INFO_ID_RP_SDK_VERSION: return "sdk_version";
+        case BINARY_INFO_ID_RP_PICO_BOARD: return "pico_board";
+        case BINARY_INFO_ID_RP_BOOT2_NAME: return "boot2_name";
+        default: return nullptr;
+    }
+}
+
+static void write_tag(json_writer &json, uint16_t tag) {
+    char c1 = (char)(tag & 0xff), c2 = (char)(tag >> 8);
+    if (c1 >= 0x20 && c1 < 0x7f && c2 >= 0x20 && c2 < 0x7f) {
+        char s[2] = {c1, c2};
+        json.value(s, 2);
+    } else {
+        json.hex(tag);
+    }
+}
+
+// Decodes the pin list of a PINS_WITH_FUNC (5 bit pins, 4 bit function) or PINS64_WITH_FUNC (8 bit pins, 5 bit function)
+static void write_pins_with_func(json_writer &json, uint64_t encoding, bool pins64) {
+    unsigned func_bits = pins64 ? 5 : 4, pin_bits = pins64 ? 8 : 5, max_pins = pins64 ? 7 : 5;
+    unsigned pin_mask = (1u << pin_bits) - 1;
+    unsigned shift = 3 + func_bits;
+    json.key("function").value((int64_t)((encoding >> 3) & ((1u << func_bits) - 1)));
+    json.key("pins").begin_array();
+    if ((encoding & 7) == BI_PINS_ENCODING_RANGE) {
+        unsigned lo = (unsigned)(encoding >> shift) & pin_mask;
+        unsigned hi = (unsigned)(encoding >> (shift + pin_bits)) & pin_mask;
+        for (unsigned pin = lo; pin <= hi; pin++) json.value((int64_t)pin);
+    } else if ((encoding & 7) == BI_PINS_ENCODING_MULTI) {
+        // fewer pins than the maximum are padded by repeating the last one
+        unsigned last = ~0u;
+        for (unsigned i = 0; i < max_pins; i++) {
+            unsigned pin = (unsigned)(encoding >> (shift + i * pin_bits)) & pin_mask;
+            if (pin == last) break;
+            json.value((int64_t)pin);
+            last = pin;
+        }
+    }
+    json.end_array();
+}
+
+static void write_pin_mask(json_writer &json, uint64_t mask) {
+    json.key("pins").begin_array();
+    for (unsigned pin = 0; pin < 64; pin++) {
+        if (mask & (1ull << pin)) json.value((int64_t)pin);
+    }
+    json.end_array();
+}
+
+static void write_image_type(json_writer &json, uint32_t flags) {
+    static const char *const types[] = {"invalid", "exe", "data"};
+    static const char *const security[] = {"unspecified", "ns", "s"};
+    static const char *const cpus[] = {"arm", "riscv", "varmulet"};
+    static const char *const chips[] = {"rp2040", "rp2350"};
+    unsigned type = (flags & PICOBIN_IMAGE_TYPE_IMAGE_TYPE_BITS) >> PICOBIN_IMAGE_TYPE_IMAGE_TYPE_LSB;
+    json.key("image_type").begin_object();
+    json.key("type").value(type < 3 ? types[type] : "unknown");
+    if (type == PICOBIN_IMAGE_TYPE_IMAGE_TYPE_EXE) {
+        unsigned sec = (flags & PICOBIN_IMAGE_TYPE_EXE_SECURITY_BITS) >> PICOBIN_IMAGE_TYPE_EXE_SECURITY_LSB;
+        unsigned cpu = (flags & PICOBIN_IMAGE_TYPE_EXE_CPU_BITS) >> PICOBIN_IMAGE_TYPE_EXE_CPU_LSB;
+        unsigned chip = (flags & PICOBIN_IMAGE_TYPE_EXE_CHIP_BITS) >> PICOBIN_IMAGE_TYPE_EXE_CHIP_LSB;
+        json.key("security").value(sec < 3 ? security[sec] : "unknown");
+        json.key("cpu").value(cpu < 3 ? cpus[cpu] : "unknown");
+        json.key("chip").value(chip < 2 ? chips[chip] : "unknown");
+        json.key("tbyb").value((flags & PICOBIN_IMAGE_TYPE_EXE_TBYB_BITS) != 0);
+    }
+    json.end_object();
+}
+
+static void write_block(json_writer &json, const picobin_block &block) {
+    json.begin_object();
+    json.key("address").hex(block.addr);
+    json.key("kind").value(block.is_image_def() ? "image_def" : block.is_partition_table() ? "partition_table" : "other");
+    json.key("link").value((int64_t)block.link);
+    json.key("items").begin_array();
+    for (const auto &item : block.items()) {
+        json.begin_object();
+        json.key("type").value(item_name(item.type));
+        json.key("words").value((int64_t)item.words);
+        json.end_object();
+    }
+    json.end_array();
+    if (const uint32_t *image_type = block.find_item(PICOBIN_BLOCK_ITEM_1BS_IMAGE_TYPE)) {
+        write_image_type(json, image_type[0] >> 16);
+    }
+    if (const uint32_t *version = block.find_item(PICOBIN_BLOCK_ITEM_1BS_VERSION)) {
+        if (((version[0] >> 8) & 0xff) >= 2) {
+            json.key("version").begin_object();
+            json.key("major").value((int64_t)(version[1] >> 16));
+            json.key("minor").value((int64_t)(version[1] & 0xffff));
+            json.end_object();
+        }
+    }
+    if (const uint32_t *load_map = block.find_item(PICOBIN_BLOCK_ITEM_LOAD_MAP)) {
+        unsigned count = (load_map[0] << 1) >> 25;
+        unsigned words = (load_map[0] >> 8) & 0xff;
+        json.key("load_map").begin_object();
+        json.key("absolute").value((int32_t)load_map[0] < 0);
+        json.key("entries").begin_array();
+        for (unsigned i = 0; i < count && 3 + i * 3 < words; i++) {
+            json.begin_object();
+            json.key("storage").hex(load_map[1 + i * 3]);
+            json.key("runtime").hex(load_map[2 + i * 3]);
+            json.key("size").value((int64_t)load_map[3 + i * 3]);
+            json.end_object();
+        }
+        json.end_array();
+        json.end_object();
+    }
+    json.key("hash").value(picobin_hash_status_name(block.hash));
+    if (!block.hash_error.empty()) json.key("hash_error").value(block.hash_error.c_str());
+    json.key("signature").value(block.find_item(PICOBIN_BLOCK_ITEM_SIGNATURE) != nullptr);
+    json.end_object();
+}
+
+static void write_binary_info(json_writer &json, const binary_info_entry &e) {
+    json.begin_object();
+    json.key("address").hex(e.addr);
+    json.key("type").value(binary_info_type_name(e.type));
+    json.key("tag");
+    write_tag(json, e.tag);
+    switch (e.type) {
+        case BINARY_INFO_TYPE_ID_AND_INT:
+        case BINARY_INFO_TYPE_ID_AND_STRING: {
+            json.key("id").hex(e.id);
+            const char *name = e.tag == BINARY_INFO_TAG_RASPBERRY_PI ? raspberry_pi_id_name(e.id) : nullptr;
+            if (name) json.key("name").value(name);
+            if (e.type == BINARY_INFO_TYPE_ID_AND_INT) json.key("value").value((int64_t)e.int_value);
+            else json.key("value").value(e.string_value);
+            break;
+        }
+        case BINARY_INFO_TYPE_BLOCK_DEVICE:
+            json.key("name").value(e.label);
+            json.key("block_address").hex(e.address);
+            json.key("size").value((int64_t)e.size);
+            json.key("flags").hex(e.flags);
+            break;
+        case BINARY_INFO_TYPE_PINS_WITH_FUNC:
+        case BINARY_INFO_TYPE_PINS64_WITH_FUNC:
+            write_pins_with_func(json, e.pins, e.type == BINARY_INFO_TYPE_PINS64_WITH_FUNC);
+            break;
+        case BINARY_INFO_TYPE_PINS_WITH_NAME:
+        case BINARY_INFO_TYPE_PINS64_WITH_NAME:
+            write_pin_mask(json, e.pins);
+            json.key("label").value(e.label);
+            break;
+        case BINARY_INFO_TYPE_NAMED_GROUP:
+            json.key("parent_id").hex(e.id);
+            json.key("flags").hex(e.flags);
+            json.key("group_tag");
+            write_tag(json, e.group_tag);
+            json.key("group_id").hex(e.group_id);
+            json.key("label").value(e.label);
+            break;
+        case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME:
+            json.key("id").hex(e.id);
+            json.key("label").value(e.label);
+            json.key("value").value((int64_t)e.int_value);
+            break;
+        case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME:
+            json.key("id").hex(e.id);
+            json.key("label").value(e.label);
+            json.key("value").value(e.string_value);
+            break;
+        default:
+            break;
+    }
+    json.end_object();
+}
+
+// Encodes the entries which have a compact form; returns the size of the encoding or a PICO_ERROR_
+static int encode_compact(const std::vector<binary_info_entry> &entries, std::vector<uint8_t> &out) {
+    // the strings in the image are not necessarily NUL terminated (or in one piece)
+    std::vector<std::string> strings;
+    strings.reserve(entries.size() * 2);
+    auto c_str = [&strings](const image_text &text) -> const char * {
+        if (!text.valid) return nullptr;
+        strings.emplace_back(text.data(), text.size());
+        return strings.back().c_str();
+    };
+    std::vector<bi_compact_entry_t> compact;
+    for (const auto &e : entries) {
+        bi_compact_entry_t c = {};
+        c.type = e.type;
+        c.tag = e.tag;
+        switch (e.type) {
+            case BINARY_INFO_TYPE_ID_AND_INT:
+            case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME:
+                c.id = e.id;
+                c.int_value = e.int_value;
+                c.label = c_str(e.label);
+                break;
+            case BINARY_INFO_TYPE_ID_AND_STRING:
+            case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME:
+                c.id = e.id;
+                c.string = c_str(e.string_value);
+                c.label = c_str(e.label);
+                break;
+            case BINARY_INFO_TYPE_BLOCK_DEVICE:
+                c.label = c_str(e.label);
+                c.address = e.address;
+                c.size = e.size;
+                c.flags = e.flags;
+                break;
+            case BINARY_INFO_TYPE_PINS_WITH_FUNC:
+            case BINARY_INFO_TYPE_PINS64_WITH_FUNC:
+                c.pins = e.pins;
+                break;
+            case BINARY_INFO_TYPE_PINS_WITH_NAME:
+            case BINARY_INFO_TYPE_PINS64_WITH_NAME:
+                c.pins = e.pins;
+                c.label = c_str(e.label);
+                break;
+            case BINARY_INFO_TYPE_NAMED_GROUP:
+                c.id = e.id;
+                c.flags = e.flags;
+                c.group_tag = e.group_tag;
+                c.group_id = e.group_id;
+                c.label = c_str(e.label);
+                break;
+            default:
+                continue;
+        }
+        compact.push_back(c);
+    }
+    out.resize(BI_COMPACT_MAX_SIZE);
+    int rc = bi_compact_encode_entries(compact.data(), (unsigned)compact.size(), out.data(), out.size());
+    out.resize(rc > 0 ? rc : 0);
+    return rc;
+}
+
+// Returns true if the file was read and nothing in it failed to validate
+static bool inspect(const std::string &path, const options &opts, std::string &out) {
+    json_writer json(opts.pretty);
+    std::vector<std::string> errors;
+    json.begin_object();
+    json.key("file").value(path.c_str());
+    image img;
+    std::string error;
+    if (img.load(path, opts.bin_base, error)) {
+        uint64_t size = 0;
+        for (const auto &r : img.ranges()) size += r.size;
+        json.key("format").value(image_format_name(img.format()));
+        json.key("base").hex(img.base());
+        json.key("size").value((int64_t)size);
+
+        std::vector<picobin_block> blocks;
+        if (!picobin_find_blocks(img, opts.check_hashes, blocks, error)) errors.push_back(error);
+        json.key("blocks").begin_array();
+        for (const auto &block : blocks) {
+            write_block(json, block);
+            if (block.hash == picobin_hash_status::mismatch || block.hash == picobin_hash_status::error) {
+                char buf[64];
+                snprintf(buf, sizeof(buf), "hash check failed for block at 0x%08x", (unsigned)block.addr);
+                errors.push_back(buf);
+            }
+        }
+        json.end_array();
+
+        std::vector<binary_info_entry> entries;
+        if (!binary_info_find_entries(img, entries, error)) errors.push_back(error);
+        json.key("binary_info").begin_array();
+        for (const auto &e : entries) write_binary_info(json, e);
+        json.end_array();
+
+        if (!opts.compact_path.empty()) {
+            std::vector<uint8_t> compact;
+            int rc = encode_compact(entries, compact);
+            std::ofstream file(opts.compact_path, std::ios::binary);
+            if (rc < 0) {
+                errors.push_back("binary_info too large for the compact encoding");
+            } else if (!file.write(reinterpret_cast<const char *>(compact.data()), (std::streamsize)compact.size())) {
+                errors.push_back("cannot write " + opts.compact_path);
+            } else {
+                json.key("compact_size").value((int64_t)rc);
+            }
+        }
+    } else {
+        errors.push_back(error);
+    }
+    json.key("errors").begin_array();
+    for (const auto &e : errors) json.value(e.c_str());
+    json.end_array();
+    json.end_object();
+    out = json.take();
+    out += '\n';
+    return errors.empty();
+}
+
+void usage() {
+    std::cerr << "usage: picobin_info <options> <file>...\n\n";
+    std::cerr << "Print the picobin blocks and binary_info of ELF, BIN or UF2 files as JSON, one object per file per line.\n";
+    std::cerr << "The hash of each IMAGE_DEF block which has one is checked against the image.\n\n";
+    std::cerr << "options:\n";
+    std::cerr << "  --base <address>     the address BIN files are loaded at (default 0x10000000)\n";
+    std::cerr << "  --no-hash            don't check hashes\n";
+    std::cerr << "  --pretty             indent the output\n";
+    std::cerr << "  --compact <file>     write the binary_info of the (single) input file to <file> in the compact encoding\n";
+    std::cerr << "                       of pico_binary_info_compact\n";
+    std::cerr << "  -j <jobs>            number of files to inspect at once (default: number of CPUs)\n";
+    std::cerr << "  --version            print picobin_info version information\n";
+    std::cerr << "  -?, --help           print this help and exit\n\n";
+    std::cerr << "exit status is 0 if every file was read and passed its checks, 2 if not, or 1 for bad arguments\n";
+}
+
+int main(int argc, char *argv[]) {
+    options opts;
+    unsigned jobs = std::thread::hardware_concurrency();
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+        if (arg == "--compact") {
+            if (++i == argc) {
+                std::cerr << "error: " << arg << " requires a value" << std::endl;
+                return 1;
+            }
+            opts.compact_path = argv[i];
+        } else if (arg == "--base" || arg == "-j") {
+            if (++i == argc) {
+                std::cerr << "error: " << arg << " requires a value" << std::endl;
+                return 1;
+            }
+            char *end;
+            unsigned long value = strtoul(argv[i], &end, 0);
+            if (*end || !*argv[i]) {
+                std::cerr << "error: bad value for " << arg << std::endl;
+                return 1;
+            }
+            if (arg == "--base") opts.bin_base = (uint32_t)value;
+            else jobs = (unsigned)value;
+        } else if (arg == "--no-hash") {
+            opts.check_hashes = false;
+        } else if (arg == "--pretty") {
+            opts.pretty = true;
+        } else if (arg == "--version") {
+            std::cout << "picobin_info " << PICOBIN_INFO_VERSION_STRING << std::endl;
+            return 0;
+        } else if (arg == "-?" || arg == "--help") {
+            usage();
+            return 0;
+        } else if (arg[0] == '-' && arg.size() > 1) {
+            std::cerr << "error: unknown option " << arg << std::endl;
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        usage();
+        return 1;
+    }
+    if (!opts.compact_path.empty() && files.size() != 1) {
+        std::cerr << "error: --compact requires a single input file" << std::endl;
+        return 1;
+    }
+    jobs = std::max(1u, std::min(jobs, (unsigned)files.size()));
+
+    // files are handed out to the workers in order, and the output is written in the same order
+    std::vector<std::string> outputs(files.size());
+    std::vector<char> ok(files.size());
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i; (i = next++) < files.size(); ) {
+            ok[i] = inspect(files[i], opts, outputs[i]);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < jobs; i++) threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads) t.join();
+
+    int rc = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        fwrite(outputs[i].data(), 1, outputs[i].size(), stdout);
+        if (!ok[i]) rc = 2;
+    }
+    return rc;
+}
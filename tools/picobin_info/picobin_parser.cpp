@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "picobin_parser.h"
+#include "sha256.h"
+
+#define NO_PICO_PLATFORM 1
+#include "boot/picobin.h"
+#include "pico/binary_info/defs.h"
+#include "pico/binary_info/structure.h"
+
+// The boot ROM only looks for the first block in the first 4 kB of an image
+#define PICOBIN_SEARCH_SIZE 4096u
+// Limit on the number of blocks followed round a loop
+#define PICOBIN_MAX_BLOCKS 64u
+// The binary_info header is in the first 256 bytes of the image proper, which on RP2040 follows the 256 byte boot2
+#define BINARY_INFO_SEARCH_SIZE 512u
+#define BINARY_INFO_MAX_MAPPINGS 16u
+#define BINARY_INFO_MAX_ENTRIES 4096u
+#define BINARY_INFO_MAX_STRING 1024u
+
+static unsigned item_type(uint32_t word) {
+    return word & 0xffu;
+}
+
+static unsigned item_words(uint32_t word) {
+    // items with bit 7 of the type set have a two byte size
+    return (word & 0x80u) ? (word >> 8) & 0xffffu : (word >> 8) & 0xffu;
+}
+
+const char *picobin_hash_status_name(picobin_hash_status status) {
+    switch (status) {
+        case picobin_hash_status::ok: return "ok";
+        case picobin_hash_status::mismatch: return "mismatch";
+        case picobin_hash_status::error: return "error";
+        case picobin_hash_status::unchecked: return "unchecked";
+        default: return "none";
+    }
+}
+
+std::vector<picobin_item> picobin_block::items() const {
+    std::vector<picobin_item> result;
+    // the LAST item is three words from the end, followed by the link and end marker
+    size_t last = words.size() - 3;
+    for (size_t i = 1; i < last; i += item_words(words[i])) {
+        result.push_back({(uint8_t)item_type(words[i]), (uint16_t)item_words(words[i]), &words[i]});
+    }
+    return result;
+}
+
+const uint32_t *picobin_block::find_item(uint8_t type) const {
+    for (const auto &item : items()) {
+        if (item.type == type) return item.data;
+    }
+    return nullptr;
+}
+
+bool picobin_block::is_image_def() const {
+    return find_item(PICOBIN_BLOCK_ITEM_1BS_IMAGE_TYPE) != nullptr;
+}
+
+bool picobin_block::is_partition_table() const {
+    return find_item(PICOBIN_BLOCK_ITEM_PARTITION_TABLE) != nullptr;
+}
+
+// Reads the block at addr, returning false if there is not a valid one there
+static bool read_block(const image &img, uint32_t addr, picobin_block &block) {
+    uint32_t word;
+    if (!img.read_u32(addr, word) || word != PICOBIN_BLOCK_MARKER_START) return false;
+    block.addr = addr;
+    block.words.assign(1, word);
+    for (uint32_t i = 1; i < PICOBIN_MAX_BLOCK_SIZE / 4; ) {
+        if (!img.read_u32(addr + i * 4, word)) return false;
+        block.words.push_back(word);
+        unsigned size = item_words(word);
+        if (item_type(word) == PICOBIN_BLOCK_ITEM_2BS_LAST) {
+            // the last item's size is the total size of the items before it
+            uint32_t link, end;
+            if (size != i - 1 || !img.read_u32(addr + i * 4 + 4, link) || !img.read_u32(addr + i * 4 + 8, end) ||
+                end != PICOBIN_BLOCK_MARKER_END) {
+                return false;
+            }
+            block.words.push_back(link);
+            block.words.push_back(end);
+            block.link = (int32_t)link;
+            return true;
+        }
+        if (!size) return false;
+        for (unsigned j = 1; j < size; j++) {
+            if (!img.read_u32(addr + (i + j) * 4, word)) return false;
+            block.words.push_back(word);
+        }
+        i += size;
+    }
+    return false;
+}
+
+// The hash covers the storage ranges of the block's LOAD_MAP (or without one, the image before the block), followed
+// by the number of block words given by the HASH_DEF item, counted from the start marker. This is the same rule as
+// pico_ota_verify_picobin() in the SDK
+static void check_hash(const image &img, picobin_block &block) {
+    const uint32_t *hash_def = block.find_item(PICOBIN_BLOCK_ITEM_1BS_HASH_DEF);
+    const uint32_t *hash_value = block.find_item(PICOBIN_BLOCK_ITEM_HASH_VALUE);
+    if (!hash_def && !hash_value) return;
+    block.hash = picobin_hash_status::error;
+    if (!hash_def || !hash_value || item_words(hash_def[0]) < 2) {
+        block.hash_error = "HASH_DEF and HASH_VALUE must both be present";
+        return;
+    }
+    unsigned hash_type = hash_def[0] >> 24;
+    unsigned block_words_hashed = hash_def[1] & 0xffffu;
+    unsigned value_words = item_words(hash_value[0]) - 1;
+    if (hash_type != PICOBIN_HASH_SHA256) {
+        block.hash_error = "unsupported hash type";
+        return;
+    }
+    if (block_words_hashed > block.words.size() || !value_words || value_words > sha256::result_bytes / 4) {
+        block.hash_error = "bad HASH_DEF or HASH_VALUE size";
+        return;
+    }
+    sha256 hash;
+    auto update = [&hash](const uint8_t *data, uint32_t size) { hash.update(data, size); };
+    const uint32_t *load_map = block.find_item(PICOBIN_BLOCK_ITEM_LOAD_MAP);
+    if (load_map) {
+        uint32_t header = load_map[0];
+        unsigned count = (header << 1) >> 25;
+        bool relative = (int32_t)header >= 0;
+        if (1 + count * 3 > item_words(header)) {
+            block.hash_error = "bad LOAD_MAP size";
+            return;
+        }
+        for (unsigned i = 0; i < count; i++) {
+            uint32_t storage = load_map[1 + i * 3];
+            uint32_t size = load_map[3 + i * 3];
+            if (relative) {
+                storage += block.addr;
+            } else if (!img.contiguous_size(storage)) {
+                // not loaded from the image (e.g. a region to be cleared), so there is nothing to hash
+                continue;
+            }
+            if (!img.for_each_piece(storage, size, update)) {
+                block.hash_error = "LOAD_MAP entry outside the image";
+                return;
+            }
+        }
+    } else if (!img.for_each_piece(img.base(), block.addr - img.base(), update)) {
+        block.hash_error = "image before the block is not contiguous";
+        return;
+    }
+    hash.update(reinterpret_cast<const uint8_t *>(block.words.data()), block_words_hashed * 4);
+    uint8_t result[sha256::result_bytes];
+    hash.finish(result);
+    block.hash = memcmp(result, &hash_value[1], value_words * 4) ? picobin_hash_status::mismatch : picobin_hash_status::ok;
+}
+
+bool picobin_find_blocks(const image &img, bool check_hashes, std::vector<picobin_block> &blocks, std::string &error) {
+    blocks.clear();
+    picobin_block block;
+    uint32_t first = 0;
+    bool found = false;
+    for (uint32_t offset = 0; offset < PICOBIN_SEARCH_SIZE && !found; offset += 4) {
+        found = read_block(img, img.base() + offset, block);
+        first = img.base() + offset;
+    }
+    if (!found) return true;
+    for (unsigned n = 0; ; n++) {
+        if (block.is_image_def()) {
+            if (check_hashes) {
+                check_hash(img, block);
+            } else if (block.find_item(PICOBIN_BLOCK_ITEM_HASH_VALUE)) {
+                block.hash = picobin_hash_status::unchecked;
+            }
+        }
+        uint32_t next = block.addr + (uint32_t)block.link;
+        blocks.push_back(std::move(block));
+        if (next == first) return true;
+        if (n == PICOBIN_MAX_BLOCKS) {
+            error = "block loop does not return to the first block";
+            return false;
+        }
+        block = picobin_block();
+        if (!read_block(img, next, block)) {
+            error = "block link does not lead to a valid block";
+            return false;
+        }
+    }
+}
+
+static image_text read_text(const image &img, uint32_t addr) {
+    image_text text;
+    uint32_t available = std::min(img.contiguous_size(addr), BINARY_INFO_MAX_STRING);
+    if (!available) return text;
+    text.valid = true;
+    const auto *p = reinterpret_cast<const char *>(img.contiguous(addr, available));
+    const char *end = static_cast<const char *>(memchr(p, 0, available));
+    if (end) {
+        text.ptr = p;
+        text.len = (size_t)(end - p);
+        return text;
+    }
+    // not terminated within the range it starts in; piece it together
+    for (uint32_t i = 0; i < BINARY_INFO_MAX_STRING; i++) {
+        char c;
+        if (!img.read(addr + i, &c, 1) || !c) break;
+        text.copy.push_back(c);
+    }
+    return text;
+}
+
+namespace {
+struct address_mapping {
+    uint32_t source;
+    uint32_t dest_start;
+    uint32_t dest_end;
+};
+}
+
+// Converts a runtime address (which may be in RAM) to where the data is stored in the image
+static uint32_t map_address(const std::vector<address_mapping> &mappings, uint32_t addr) {
+    for (const auto &m : mappings) {
+        if (addr >= m.dest_start && addr < m.dest_end) return m.source + (addr - m.dest_start);
+    }
+    return addr;
+}
+
+template<typename T> static bool read_struct(const image &img, uint32_t addr, T &value) {
+    return img.read(addr, &value, sizeof(value));
+}
+
+bool binary_info_find_entries(const image &img, std::vector<binary_info_entry> &entries, std::string &error) {
+    entries.clear();
+    uint32_t header[5];
+    uint32_t header_addr = 0;
+    bool found = false;
+    for (uint32_t offset = 0; offset < BINARY_INFO_SEARCH_SIZE && !found; offset += 4) {
+        header_addr = img.base() + offset;
+        found = img.read(header_addr, header, sizeof(header)) && header[0] == BINARY_INFO_MARKER_START &&
+                header[4] == BINARY_INFO_MARKER_END;
+    }
+    if (!found) return true;
+    uint32_t start = header[1], end = header[2];
+    if (end < start || (end - start) % 4 || (end - start) / 4 > BINARY_INFO_MAX_ENTRIES) {
+        error = "bad binary_info header";
+        return false;
+    }
+    std::vector<address_mapping> mappings;
+    for (uint32_t addr = header[3]; addr && mappings.size() < BINARY_INFO_MAX_MAPPINGS; addr += 12) {
+        address_mapping m;
+        if (!read_struct(img, addr, m) || !m.source) break;
+        mappings.push_back(m);
+    }
+    for (uint32_t addr = start; addr < end; addr += 4) {
+        uint32_t ptr;
+        binary_info_core_t core;
+        if (!img.read_u32(addr, ptr) || !read_struct(img, ptr = map_address(mappings, ptr), core)) {
+            error = "binary_info entry outside the image";
+            return false;
+        }
+        binary_info_entry e;
+        e.addr = ptr;
+        e.type = core.type;
+        e.tag = core.tag;
+        bool ok = true;
+        switch (core.type) {
+            case BINARY_INFO_TYPE_ID_AND_INT: {
+                binary_info_id_and_int_t bi;
+                if ((ok = read_struct(img, ptr, bi))) {
+                    e.id = bi.id;
+                    e.int_value = bi.value;
+                }
+                break;
+            }
+            case BINARY_INFO_TYPE_ID_AND_STRING: {
+                binary_info_id_and_string_t bi;
+                if ((ok = read_struct(img, ptr, bi))) {
+                    e.id = bi.id;
+                    e.string_value = read_text(img, map_address(mappings, bi.value));
+                }
+                break;
+            }
+            case BINARY_INFO_TYPE_BLOCK_DEVICE: {
+                binary_info_block_device_t bi;
+                if ((ok = read_struct(img, ptr, bi))) {
+                    e.label = read_text(img, map_address(mappings, bi.name));
+                    e.address = bi.address;
+                    e.size = bi.size;
+                    e.flags = bi.flags;
+                }
+                break;
+            }
+            case BINARY_INFO_TYPE_PINS_WITH_FUNC: {
+                binary_info_pins_with_func_t bi;
+                if ((ok = read_struct(img, ptr, bi))) e.pins = bi.pin_encoding;
+                break;
+            }
+            case BINARY_INFO_TYPE_PINS64_WITH_FUNC: {
+                binary_info_pins64_with_func_t bi;
+                if ((ok = read_struct(img, ptr, bi))) e.pins = bi.pin_encoding;
+                break;
+            }
+            case BINARY_INFO_TYPE_PINS_WITH_NAME: {
+                binary_info_pins_with_name_t bi;
+                if ((ok = read_struct(img, ptr, bi))) {
+                    e.pins = bi.pin_mask;
+                    e.label = read_text(img, map_address(mappings, bi.label));
+                }
+                break;
+            }
+            case BINARY_INFO_TYPE_PINS64_WITH_NAME: {
+                binary_info_pins64_with_name_t bi;
+                if ((ok = read_struct(img, ptr, bi))) {
+                    e.pins = bi.pin_mask;
+                    e.label = read_text(img, map_address(mappings, bi.label));
+                }
+                break;
+            }
+            case BINARY_INFO_TYPE_NAMED_GROUP: {
+                binary_info_named_group_t bi;
+                if ((ok = read_struct(img, ptr, bi))) {
+                    e.id = bi.parent_id;
+                    e.flags = bi.flags;
+                    e.group_tag = bi.group_tag;
+                    e.group_id = bi.group_id;
+                    e.label = read_text(img, map_address(mappings, bi.label));
+                }
+                break;
+            }
+            case BINARY_INFO_TYPE_PTR_INT32_WITH_NAME: {
+                binary_info_ptr_int32_with_name_t bi;
+                if ((ok = read_struct(img, ptr, bi))) {
+                    e.id = (uint32_t)bi.id;
+                    e.label = read_text(img, map_address(mappings, bi.label));
+                    // the value may only exist at runtime (e.g. in .bss), in which case it is left as 0
+                    uint32_t value;
+                    if (img.read_u32(map_address(mappings, bi.value), value)) e.int_value = (int32_t)value;
+                }
+                break;
+            }
+            case BINARY_INFO_TYPE_PTR_STRING_WITH_NAME: {
+                binary_info_ptr_string_with_name_t bi;
+                if ((ok = read_struct(img, ptr, bi))) {
+                    e.id = (uint32_t)bi.id;
+                    e.label = read_text(img, map_address(mappings, bi.label));
+                    e.string_value = read_text(img, map_address(mappings, bi.value));
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        if (!ok) {
+            error = "binary_info entry outside the image";
+            return false;
+        }
+        entries.push_back(std::move(e));
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICOBIN_INFO_PICOBIN_PARSER_H
+#define _PICOBIN_INFO_PICOBIN_PARSER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "image.h"
+
+// One item of a block
+struct picobin_item {
+    uint8_t type;
+    uint16_t words;        // including the item's header word
+    const uint32_t *data;  // the item's words, starting with the header
+};
+
+enum class picobin_hash_status {
+    none,       // the block has no hash
+    ok,         // the image matches the block's HASH_VALUE
+    mismatch,   // it doesn't
+    error,      // the hash could not be checked (see hash_error)
+    unchecked,  // the block has a hash, but hashes were not checked
+};
+
+const char *picobin_hash_status_name(picobin_hash_status status);
+
+struct picobin_block {
+    uint32_t addr = 0;
+    std::vector<uint32_t> words;  // the whole block, from the start marker to the end marker
+    int32_t link = 0;             // offset from this block to the next one in the loop
+    picobin_hash_status hash = picobin_hash_status::none;
+    std::string hash_error;
+
+    std::vector<picobin_item> items() const;
+    // the first item of the given type, or nullptr
+    const uint32_t *find_item(uint8_t type) const;
+    bool is_image_def() const;
+    bool is_partition_table() const;
+};
+
+// Finds the loop of blocks which starts in the first 4 kB of the image (as the boot ROM does), and optionally checks
+// the hash of each IMAGE_DEF in it. Returns false (with error set) if the loop is broken; blocks then holds those found
+// before the problem. Returns true with no blocks if the image has none
+bool picobin_find_blocks(const image &img, bool check_hashes, std::vector<picobin_block> &blocks, std::string &error);
+
+// A string from the image; it points straight into the file unless it had to be pieced together from separate ranges
+struct image_text {
+    bool valid = false;
+    const char *ptr = nullptr;
+    size_t len = 0;
+    std::string copy;
+
+    const char *data() const { return copy.empty() ? ptr : copy.data(); }
+    size_t size() const { return copy.empty() ? len : copy.size(); }
+};
+
+// A decoded binary_info entry; which fields are meaningful depends on type (one of BINARY_INFO_TYPE_...)
+struct binary_info_entry {
+    uint32_t addr = 0;
+    uint16_t type = 0;
+    uint16_t tag = 0;
+    uint32_t id = 0;
+    int32_t int_value = 0;
+    uint64_t pins = 0;         // pin encoding or mask
+    uint32_t address = 0;      // block device
+    uint32_t size = 0;         // block device
+    uint16_t flags = 0;        // block device or named group
+    uint16_t group_tag = 0;    // named group
+    uint32_t group_id = 0;     // named group
+    image_text label;          // name, label or string value
+    image_text string_value;   // the value of a pointer to a string
+};
+
+// Walks the binary_info entries of the image. Returns false (with error set) if there is a binary_info header but
+// it is malformed; returns true with no entries if there is no header
+bool binary_info_find_entries(const image &img, std::vector<binary_info_entry> &entries, std::string &error);
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "sha256.h"
+
+static const uint32_t k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t ror32(uint32_t x, unsigned n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+sha256::sha256() : h{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19} {
+}
+
+void sha256::block(const uint8_t *p) {
+    uint32_t w[64];
+    for (unsigned i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)p[4 * i] << 24) | ((uint32_t)p[4 * i + 1] << 16) | ((uint32_t)p[4 * i + 2] << 8) | p[4 * i + 3];
+    }
+    for (unsigned i = 16; i < 64; i++) {
+        uint32_t s0 = ror32(w[i - 15], 7) ^ ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ror32(w[i - 2], 17) ^ ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+    for (unsigned i = 0; i < 64; i++) {
+        uint32_t t1 = hh + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+        uint32_t t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        hh = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+}
+
+void sha256::update(const uint8_t *data, size_t size) {
+    total += size;
+    if (buffered) {
+        size_t len = std::min(size, sizeof(buffer) - buffered);
+        memcpy(buffer + buffered, data, len);
+        buffered += len;
+        data += len;
+        size -= len;
+        if (buffered < sizeof(buffer)) return;
+        block(buffer);
+        buffered = 0;
+    }
+    // whole blocks straight from the caller's data
+    for (; size >= sizeof(buffer); data += sizeof(buffer), size -= sizeof(buffer)) {
+        block(data);
+    }
+    memcpy(buffer, data, size);
+    buffered = size;
+}
+
+void sha256::finish(uint8_t result[result_bytes]) {
+    uint64_t bits = total * 8;
+    buffer[buffered++] = 0x80;
+    if (buffered > sizeof(buffer) - 8) {
+        memset(buffer + buffered, 0, sizeof(buffer) - buffered);
+        block(buffer);
+        buffered = 0;
+    }
+    memset(buffer + buffered, 0, sizeof(buffer) - 8 - buffered);
+    for (unsigned i = 0; i < 8; i++) {
+        buffer[56 + i] = (uint8_t)(bits >> (56 - 8 * i));
+    }
+    block(buffer);
+    for (unsigned i = 0; i < 8; i++) {
+        result[4 * i] = (uint8_t)(h[i] >> 24);
+        result[4 * i + 1] = (uint8_t)(h[i] >> 16);
+        result[4 * i + 2] = (uint8_t)(h[i] >> 8);
+        result[4 * i + 3] = (uint8_t)h[i];
+    }
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _PICOBIN_INFO_SHA256_H
+#define _PICOBIN_INFO_SHA256_H
+
+#include <cstdint>
+#include <cstddef>
+
+class sha256 {
+public:
+    static const size_t result_bytes = 32;
+
+    sha256();
+    void update(const uint8_t *data, size_t size);
+    void finish(uint8_t result[result_bytes]);
+
+private:
+    void block(const uint8_t *p);
+
+    uint32_t h[8];
+    uint8_t buffer[64];
+    size_t buffered = 0;
+    uint64_t total = 0;
+};
+
+#endif
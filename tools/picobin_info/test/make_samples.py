@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#
+# Script to (re)generate the sample images the picobin_info tests are run on: a small RP2350 image with binary_info
+# and an IMAGE_DEF block with a SHA-256 hash, as a BIN, an ELF and a UF2 file, plus a copy of each with a corrupted
+# hash. The samples are checked in, so this only needs running if they are to change; the expected output of
+# picobin_info for each is in <sample>.json next to it.
+#
+# usage: make_samples.py [<output dir>]
+
+import hashlib
+import os
+import struct
+import sys
+
+BASE = 0x10000000
+
+PICOBIN_BLOCK_MARKER_START = 0xffffded3
+PICOBIN_BLOCK_MARKER_END = 0xab123579
+PICOBIN_BLOCK_ITEM_1BS_IMAGE_TYPE = 0x42
+PICOBIN_BLOCK_ITEM_1BS_HASH_DEF = 0x47
+PICOBIN_BLOCK_ITEM_HASH_VALUE = 0x4b
+PICOBIN_BLOCK_ITEM_2BS_LAST = 0xff
+PICOBIN_HASH_SHA256 = 0x01
+# EXE, secure, ARM, RP2350
+IMAGE_TYPE_FLAGS = 0x1 | (2 << 4) | (0 << 8) | (1 << 12)
+
+BINARY_INFO_MARKER_START = 0x7188ebf2
+BINARY_INFO_MARKER_END = 0xe71aa390
+BINARY_INFO_TYPE_ID_AND_INT = 5
+BINARY_INFO_TYPE_ID_AND_STRING = 6
+BINARY_INFO_TAG_RASPBERRY_PI = ord('R') | (ord('P') << 8)
+BINARY_INFO_ID_RP_PROGRAM_NAME = 0x02031c86
+BINARY_INFO_ID_RP_BINARY_END = 0x68f465de
+
+UF2_MAGIC_START0 = 0x0A324655
+UF2_MAGIC_START1 = 0x9E5D5157
+UF2_MAGIC_END = 0x0AB16F30
+UF2_FLAG_FAMILY_ID_PRESENT = 0x00002000
+RP2350_ARM_S_FAMILY_ID = 0xe48bff59
+UF2_PAYLOAD_SIZE = 256
+
+# layout of the image
+BI_HEADER = 0x20
+BI_MAPPINGS = 0x34
+BI_ENTRIES = 0x40
+BI_PROGRAM_NAME = 0x50
+BI_BINARY_END = 0x5c
+PROGRAM_NAME = 0x80
+BLOCK = 0x100
+# the corrupted copy has a byte of this changed
+CORRUPT_OFFSET = 0x10
+
+
+def words(*values):
+    return struct.pack("<%dI" % len(values), *values)
+
+
+def put(image, offset, data):
+    image[offset:offset + len(data)] = data
+
+
+def make_image():
+    block_words = 16
+    size = BLOCK + block_words * 4
+    image = bytearray(size)
+    # stand-in for code
+    put(image, 0, bytes(range(0x20)))
+
+    put(image, BI_HEADER, words(BINARY_INFO_MARKER_START, BASE + BI_ENTRIES, BASE + BI_ENTRIES + 8,
+                                BASE + BI_MAPPINGS, BINARY_INFO_MARKER_END))
+    # an empty address mapping table
+    put(image, BI_MAPPINGS, words(0, 0, 0))
+    put(image, BI_ENTRIES, words(BASE + BI_PROGRAM_NAME, BASE + BI_BINARY_END))
+    put(image, BI_PROGRAM_NAME, struct.pack("<HHII", BINARY_INFO_TYPE_ID_AND_STRING, BINARY_INFO_TAG_RASPBERRY_PI,
+                                            BINARY_INFO_ID_RP_PROGRAM_NAME, BASE + PROGRAM_NAME))
+    put(image, BI_BINARY_END, struct.pack("<HHIi", BINARY_INFO_TYPE_ID_AND_INT, BINARY_INFO_TAG_RASPBERRY_PI,
+                                          BINARY_INFO_ID_RP_BINARY_END, BASE + size))
+    put(image, PROGRAM_NAME, b"picobin_info_sample\0")
+
+    # the hash covers the image before the block, then the block up to (not including) HASH_VALUE
+    head = [PICOBIN_BLOCK_MARKER_START,
+            PICOBIN_BLOCK_ITEM_1BS_IMAGE_TYPE | (1 << 8) | (IMAGE_TYPE_FLAGS << 16),
+            PICOBIN_BLOCK_ITEM_1BS_HASH_DEF | (2 << 8) | (PICOBIN_HASH_SHA256 << 24), 4]
+    digest = hashlib.sha256(bytes(image[:BLOCK]) + words(*head)).digest()
+    items = head[1:] + [PICOBIN_BLOCK_ITEM_HASH_VALUE | (9 << 8)] + list(struct.unpack("<8I", digest))
+    block = [PICOBIN_BLOCK_MARKER_START] + items + [PICOBIN_BLOCK_ITEM_2BS_LAST | (len(items) << 8), 0,
+                                                    PICOBIN_BLOCK_MARKER_END]
+    assert len(block) == block_words
+    put(image, BLOCK, words(*block))
+    return bytes(image)
+
+
+def make_elf(image):
+    ehsize, phentsize = 52, 32
+    offset = ehsize + phentsize
+    ident = b"\x7fELF" + bytes([1, 1, 1]) + bytes(9)
+    # ET_EXEC for EM_ARM, entry just past the binary_info header
+    header = ident + struct.pack("<HHIIIIIHHHHHH", 2, 40, 1, BASE + BI_MAPPINGS + 1, ehsize, 0, 0x05000200,
+                                 ehsize, phentsize, 1, 0, 0, 0)
+    # PT_LOAD, read and execute
+    program_header = struct.pack("<IIIIIIII", 1, offset, BASE, BASE, len(image), len(image), 5, 4)
+    return header + program_header + image
+
+
+def make_uf2(image):
+    count = (len(image) + UF2_PAYLOAD_SIZE - 1) // UF2_PAYLOAD_SIZE
+    out = b""
+    for i in range(count):
+        payload = image[i * UF2_PAYLOAD_SIZE:(i + 1) * UF2_PAYLOAD_SIZE]
+        block = words(UF2_MAGIC_START0, UF2_MAGIC_START1, UF2_FLAG_FAMILY_ID_PRESENT, BASE + i * UF2_PAYLOAD_SIZE,
+                      len(payload), i, count, RP2350_ARM_S_FAMILY_ID)
+        block += payload.ljust(476, b"\0") + words(UF2_MAGIC_END)
+        out += block
+    return out
+
+
+def main():
+    out_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    image = make_image()
+    corrupt = bytearray(image)
+    corrupt[CORRUPT_OFFSET] ^= 0xff
+    for name, data in (("sample", image), ("bad_hash", bytes(corrupt))):
+        for ext, contents in (("bin", data), ("elf", make_elf(data)), ("uf2", make_uf2(data))):
+            with open(os.path.join(out_dir, "%s.%s" % (name, ext)), "wb") as f:
+                f.write(contents)
+
+
+if __name__ == "__main__":
+    main()
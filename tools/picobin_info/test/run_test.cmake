@@ -0,0 +1,20 @@
+# Runs picobin_info on one of the sample images and checks its output and exit status
+#
+# cmake -DPICOBIN_INFO=<picobin_info> -DSAMPLE=<sample> -DEXPECTED_RESULT=<exit status> -P run_test.cmake
+#
+# The sample is given relative to this directory (which is where picobin_info is run) so that the file name in the
+# output is the same wherever the tree is; the expected output is in <sample>.json
+
+execute_process(
+        COMMAND ${PICOBIN_INFO} ${SAMPLE}
+        WORKING_DIRECTORY ${CMAKE_CURRENT_LIST_DIR}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+)
+file(READ ${CMAKE_CURRENT_LIST_DIR}/${SAMPLE}.json expected)
+if (NOT result STREQUAL EXPECTED_RESULT)
+    message(FATAL_ERROR "picobin_info ${SAMPLE} exited with ${result}, expected ${EXPECTED_RESULT}")
+endif()
+if (NOT output STREQUAL expected)
+    message(FATAL_ERROR "picobin_info ${SAMPLE} output does not match ${SAMPLE}.json:\n${output}")
+endif()
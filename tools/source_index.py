@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Raspberry Pi (Trading) Ltd.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#
+# Shared source scanner for the config/define extraction scripts
+#
+# Each file is read once, keeping only what any of the scripts care about:
+#   - the (stripped) lines mentioning PICO_CONFIG, PICO_CMAKE_CONFIG or PICO_BUILD_DEFINE
+#   - the name and value of every other #define, with any 'u' suffix or _u() wrapper removed from integer values
+# each with its line number. The result is cached on disk keyed by the SHA-1 of the file's contents, so later runs
+# (of any of the scripts) only read the files which have changed since. Files which do need reading are processed in
+# parallel.
+#
+# The cache lives in .pico_source_index in the scanned directory, unless the PICO_SOURCE_INDEX_CACHE environment
+# variable gives another directory; setting it to an empty string disables the cache. C and CMake sources are cached
+# in separate files, so that the scripts which only look at CMake files don't have to load all the #defines.
+#
+# Usage (from another script):
+#
+# import source_index
+# for source in source_index.scan(scandir, lambda filename: filename.endswith('.h')):
+#     for linenum, line in source.markers:
+#         ...
+#     for linenum, name, value in source.defines:
+#         ...
+#
+# or stand-alone, to (re)build the cache ahead of running the scripts:
+#
+# tools/source_index.py <root of repo>
+
+
+import os
+import re
+import sys
+import json
+import hashlib
+import multiprocessing
+
+from collections import namedtuple
+from concurrent.futures import ProcessPoolExecutor
+
+CACHE_VERSION = 2
+CACHE_DIRNAME = '.pico_source_index'
+CACHE_ENV = 'PICO_SOURCE_INDEX_CACHE'
+
+MARKER_RE = re.compile(r'\b(?:PICO_CONFIG|PICO_CMAKE_CONFIG|PICO_BUILD_DEFINE)\b')
+DEFINE_RE = re.compile(r'#define\s+(\w+)\s+(.+?)(\s*///.*)?$')
+INTEGER_VALUE_RE = re.compile(r'^((0x)?\d+)u$')
+INTEGER_MACRO_VALUE_RE = re.compile(r'^_u\(((0x)?\d+)\)$')
+
+SourceFile = namedtuple('SourceFile', ['path', 'dirpath', 'markers', 'defines'])
+
+# Below this many files to read, starting worker processes costs more than it saves
+PARALLEL_THRESHOLD = 64
+
+
+def is_cmake(filename):
+    return filename == 'CMakeLists.txt' or os.path.splitext(filename)[1] == '.cmake'
+
+
+def is_indexed(filename):
+    return is_cmake(filename) or os.path.splitext(filename)[1] in ('.c', '.h', '.S')
+
+
+def normalise_define_value(value):
+    m = INTEGER_VALUE_RE.match(value.lower()) or INTEGER_MACRO_VALUE_RE.match(value.lower())
+    return m.group(1) if m else value
+
+
+def index_file(file_path):
+    with open(file_path, 'rb') as fh:
+        data = fh.read()
+    markers = []
+    defines = []
+    # the same line splitting and decoding as reading the file in text mode
+    text = data.decode('ISO-8859-1').replace('\r\n', '\n').replace('\r', '\n')
+    for linenum, line in enumerate(text.split('\n'), 1):
+        if 'PICO_' not in line and '#define' not in line:
+            continue
+        line = line.strip()
+        if MARKER_RE.search(line):
+            markers.append((linenum, line))
+        else:
+            m = DEFINE_RE.match(line)
+            if m:
+                defines.append((linenum, m.group(1), normalise_define_value(m.group(2))))
+    return hashlib.sha1(data).hexdigest(), markers, defines
+
+
+def _index_file_worker(file_path):
+    return index_file(file_path)
+
+
+def _cache_path(scandir, shard):
+    cache_dir = os.environ.get(CACHE_ENV, os.path.join(scandir, CACHE_DIRNAME))
+    if not cache_dir:
+        return None
+    return os.path.join(cache_dir, shard + '.json')
+
+
+def _load_cache(path):
+    if not path:
+        return {}
+    try:
+        with open(path) as fh:
+            cache = json.load(fh)
+        if cache.get('version') == CACHE_VERSION:
+            return cache['files']
+    except (OSError, ValueError, KeyError):
+        pass
+    return {}
+
+
+def _save_cache(path, files):
+    if not path:
+        return
+    # another script may have updated the cache since it was loaded, so merge rather than overwrite
+    merged = _load_cache(path)
+    merged.update(files)
+    tmp_path = '{}.{}.tmp'.format(path, os.getpid())
+    try:
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        with open(tmp_path, 'w') as fh:
+            json.dump({'version': CACHE_VERSION, 'files': merged}, fh, separators=(',', ':'))
+        os.replace(tmp_path, path)
+    except OSError:
+        # the cache is only an optimisation
+        if os.path.exists(tmp_path):
+            os.remove(tmp_path)
+
+
+def _read_files(file_paths):
+    if len(file_paths) >= PARALLEL_THRESHOLD and (os.cpu_count() or 1) > 1:
+        # 'fork' so that the workers don't re-run the calling script, which has no __main__ guard
+        if 'fork' in multiprocessing.get_all_start_methods():
+            with ProcessPoolExecutor(mp_context=multiprocessing.get_context('fork')) as executor:
+                return list(executor.map(_index_file_worker, file_paths, chunksize=32))
+    return [index_file(file_path) for file_path in file_paths]
+
+
+def scan(scandir, include=is_indexed):
+    """
+    Returns a SourceFile for each file under scandir whose name include() accepts, in os.walk() order. Its markers
+    are a list of (line number, stripped line), and its defines a list of (line number, name, value)
+    """
+    # shard name -> cache contents, loaded when first needed
+    caches = {}
+    found = []
+    stale = []
+    for dirpath, dirnames, filenames in os.walk(scandir):
+        rel_dirpath = os.path.relpath(dirpath, scandir)
+        for filename in filenames:
+            if is_indexed(filename) and include(filename):
+                file_path = os.path.join(dirpath, filename)
+                key = os.path.join(rel_dirpath, filename)
+                shard = 'cmake' if is_cmake(filename) else 'c'
+                if shard not in caches:
+                    caches[shard] = _load_cache(_cache_path(scandir, shard))
+                cache = caches[shard]
+                st = os.stat(file_path)
+                entry = cache.get(key)
+                # the size and modification time say whether the hash needs checking
+                if not entry or entry['size'] != st.st_size or entry['mtime'] != st.st_mtime_ns:
+                    stale.append((shard, key, file_path, st))
+                found.append((file_path, dirpath, shard, key))
+
+    if stale:
+        results = _read_files([file_path for shard, key, file_path, st in stale])
+        updated = {}
+        for (shard, key, file_path, st), (sha1, markers, defines) in zip(stale, results):
+            cache = caches[shard]
+            entry = cache.get(key)
+            if entry and entry['sha1'] == sha1:
+                # touched but unchanged
+                markers, defines = entry['markers'], entry['defines']
+            cache[key] = {'size': st.st_size, 'mtime': st.st_mtime_ns, 'sha1': sha1,
+                          'markers': markers, 'defines': defines}
+            updated.setdefault(shard, {})[key] = cache[key]
+        for shard, files in updated.items():
+            _save_cache(_cache_path(scandir, shard), files)
+
+    return [SourceFile(file_path, dirpath, caches[shard][key]['markers'], caches[shard][key]['defines'])
+            for file_path, dirpath, shard, key in found]
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print('usage: {} <root of repo>'.format(sys.argv[0]))
+        sys.exit(1)
+    files = scan(sys.argv[1])
+    print('{} files indexed'.format(len(files)))